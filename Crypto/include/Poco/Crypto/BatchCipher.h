@@ -0,0 +1,190 @@
+//
+// BatchCipher.h
+//
+// $Id: //poco/1.4/Crypto/include/Poco/Crypto/BatchCipher.h#1 $
+//
+// Library: Crypto
+// Package: Cipher
+// Module:  BatchCipher
+//
+// Definition of the BatchCipher class.
+//
+// Copyright (c) 2013, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+// 
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+
+#ifndef Crypto_BatchCipher_INCLUDED
+#define Crypto_BatchCipher_INCLUDED
+
+
+#include "Poco/Crypto/Crypto.h"
+#include "Poco/Crypto/CipherKey.h"
+#include "Poco/ThreadPool.h"
+#include <vector>
+
+
+namespace Poco {
+namespace Crypto {
+
+
+class Crypto_API BatchCipher
+	/// BatchCipher encrypts and decrypts caller-owned buffers in place.
+	/// Unlike CryptoInputStream and CryptoOutputStream, it does not copy
+	/// the data into intermediate buffers, and it hands large blocks of
+	/// data to OpenSSL at once, so that OpenSSL's hardware-accelerated
+	/// implementations (e.g., AES-NI) can run at full speed.
+	///
+	/// Since the data is transformed in place, the encrypted data always
+	/// has the same length as the plain text. Padding is therefore not
+	/// supported, and for ECB and CBC mode ciphers the length of the data
+	/// must be a multiple of the cipher's block size.
+	///
+	/// Every call to encrypt() or decrypt() starts over with the key's
+	/// initialization vector, and therefore processes a separate message.
+	/// Never encrypt two messages with the same key and IV in CTR mode.
+	/// In GCM mode, every message is given a message number that becomes
+	/// part of the nonce, and two messages encrypted with the same key
+	/// must never have the same message number.
+	///
+	/// The data is divided into segments. For CTR and ECB mode ciphers,
+	/// the segments are independent of each other. When a thread pool is
+	/// given, the segments are processed in parallel, and the result is
+	/// the same as if the whole buffer had been processed at once. So data
+	/// encrypted with a BatchCipher can be decrypted with a
+	/// CryptoInputStream, and vice versa. Other modes, except GCM, chain
+	/// the blocks and are always processed by the calling thread.
+	///
+	/// For GCM mode ciphers (e.g., "aes-256-gcm"), every segment is
+	/// encrypted as a separate GCM message with its own authentication
+	/// tag, so the segments can be processed in parallel as well. The
+	/// nonce of a segment is the key's IV, which must be at least 12
+	/// bytes long, with the message number, a 64-bit big-endian value,
+	/// XORed into its first eight bytes, and the segment number, a 32-bit
+	/// big-endian value, XORed into its last four bytes.
+	/// The total length of the data is passed to every segment as
+	/// additional authenticated data, so reordered, missing or truncated
+	/// segments are detected. The format depends on the segment size, so
+	/// data must be decrypted with the same segment size it was encrypted
+	/// with.
+{
+public:
+	typedef std::vector<unsigned char> ByteVec;
+
+	enum
+	{
+		DEFAULT_SEGMENT_SIZE = 1024*1024,
+		TAG_SIZE = 16 /// Size of a GCM authentication tag.
+	};
+
+	explicit BatchCipher(const CipherKey& key, std::size_t segmentSize = DEFAULT_SEGMENT_SIZE);
+		/// Creates a BatchCipher that processes all segments in the
+		/// calling thread.
+		///
+		/// The segment size must be a non-zero multiple of 16.
+
+	BatchCipher(const CipherKey& key, Poco::ThreadPool& threadPool, std::size_t segmentSize = DEFAULT_SEGMENT_SIZE);
+		/// Creates a BatchCipher that uses threads from the given thread
+		/// pool, in addition to the calling thread, to process segments
+		/// of CTR, ECB and GCM mode ciphers in parallel.
+		///
+		/// The segment size must be a non-zero multiple of 16.
+
+	~BatchCipher();
+		/// Destroys the BatchCipher.
+
+	void encrypt(unsigned char* data, std::size_t length);
+		/// Encrypts the given buffer in place.
+		///
+		/// Throws a Poco::InvalidAccessException for GCM mode ciphers,
+		/// which require the variant returning the authentication tags.
+
+	void decrypt(unsigned char* data, std::size_t length);
+		/// Decrypts the given buffer in place.
+		///
+		/// Throws a Poco::InvalidAccessException for GCM mode ciphers.
+
+	void encrypt(unsigned char* data, std::size_t length, Poco::UInt64 message, ByteVec& tags);
+		/// Encrypts the given buffer in place, using a GCM mode cipher.
+		/// Stores the authentication tags of all segments, TAG_SIZE bytes
+		/// each, in tags.
+		///
+		/// The message number must be unique for every message
+		/// encrypted with the key, e.g. a counter incremented for
+		/// every call.
+
+	void decrypt(unsigned char* data, std::size_t length, Poco::UInt64 message, const ByteVec& tags);
+		/// Decrypts the given buffer in place, using a GCM mode cipher,
+		/// and verifies the authentication tags. The message number
+		/// must be the one the data has been encrypted with.
+		///
+		/// Throws a Poco::DataException if the data or the tags have been
+		/// tampered with. In this case, the contents of the buffer are
+		/// undefined and must not be used.
+
+	std::size_t segmentSize() const;
+		/// Returns the segment size.
+
+	bool parallel() const;
+		/// Returns true if segments are processed in parallel.
+		/// This requires both a thread pool and a CTR, ECB or GCM
+		/// mode cipher.
+
+	CipherKey& key();
+		/// Returns the key.
+
+private:
+	BatchCipher();
+	BatchCipher(const BatchCipher&);
+	BatchCipher& operator = (const BatchCipher&);
+
+	void process(unsigned char* data, std::size_t length, bool encrypt, Poco::UInt64 message, unsigned char* tags);
+	std::size_t segmentCount(std::size_t length) const;
+
+	CipherKey _key;
+	std::size_t _segmentSize;
+	Poco::ThreadPool* _pThreadPool;
+};
+
+
+//
+// inlines
+//
+inline std::size_t BatchCipher::segmentSize() const
+{
+	return _segmentSize;
+}
+
+
+inline CipherKey& BatchCipher::key()
+{
+	return _key;
+}
+
+
+} } // namespace Poco::Crypto
+
+
+#endif // Crypto_BatchCipher_INCLUDED
@@ -0,0 +1,165 @@
+//
+// ChunkedDigest.h
+//
+// $Id: //poco/1.4/Crypto/include/Poco/Crypto/ChunkedDigest.h#1 $
+//
+// Library: Crypto
+// Package: Digest
+// Module:  ChunkedDigest
+//
+// Definition of the ChunkedDigest class.
+//
+// Copyright (c) 2013, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+// 
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+
+#ifndef Crypto_ChunkedDigest_INCLUDED
+#define Crypto_ChunkedDigest_INCLUDED
+
+
+#include "Poco/Crypto/Crypto.h"
+#include "Poco/Crypto/OpenSSLInitializer.h"
+#include "Poco/DigestEngine.h"
+#include "Poco/ThreadPool.h"
+#include <vector>
+
+
+namespace Poco {
+namespace Crypto {
+
+
+class Crypto_API ChunkedDigest
+	/// ChunkedDigest uses multiple threads to compute a two-level
+	/// tree hash of a file or a block of memory.
+	///
+	/// The data is split into chunks of a fixed size (the last chunk
+	/// may be shorter). Threads from a Poco::ThreadPool compute the
+	/// digest of every chunk independently. The resulting digest is
+	/// the digest of all chunk digests, concatenated in chunk order.
+	/// The result therefore depends on both the algorithm and the
+	/// chunk size, and it is different from the plain digest of the
+	/// data. Producer and consumer must agree on the chunk size.
+	/// Empty data has no chunks, so its digest is the digest of
+	/// an empty string.
+	///
+	/// Files are memory-mapped instead of read, so the threads
+	/// can hash different parts of a file at the same time without
+	/// copying any data.
+	///
+	/// If the thread pool has no threads available, the remaining
+	/// work is done by the calling thread.
+{
+public:
+	typedef Poco::DigestEngine::Digest Digest;
+	typedef std::vector<Digest> DigestVec;
+
+	enum
+	{
+		DEFAULT_CHUNK_SIZE = 4*1024*1024
+	};
+
+	ChunkedDigest(const std::string& name, std::size_t chunkSize = DEFAULT_CHUNK_SIZE);
+		/// Creates a ChunkedDigest using the digest algorithm with the
+		/// given name (e.g., "SHA256") and the given chunk size.
+		/// The threads are taken from the default thread pool.
+		///
+		/// Throws a Poco::NotFoundException if no algorithm with the given name exists.
+
+	ChunkedDigest(const std::string& name, std::size_t chunkSize, Poco::ThreadPool& threadPool);
+		/// Creates a ChunkedDigest using the digest algorithm with the
+		/// given name, the given chunk size and the given thread pool.
+		///
+		/// Throws a Poco::NotFoundException if no algorithm with the given name exists.
+
+	~ChunkedDigest();
+		/// Destroys the ChunkedDigest.
+
+	const Digest& digestFile(const std::string& path);
+		/// Maps the file with the given path into memory and returns
+		/// its chunked digest.
+
+	const Digest& digest(const void* data, std::size_t length);
+		/// Returns the chunked digest of the given block of memory.
+
+	const Digest& digest() const;
+		/// Returns the result of the last call to digest() or digestFile().
+
+	const DigestVec& chunkDigests() const;
+		/// Returns the digests of the individual chunks computed by
+		/// the last call to digest() or digestFile(). These can be
+		/// used to find out which parts of the data differ.
+
+	const std::string& algorithm() const;
+		/// Returns the name of the digest algorithm.
+
+	std::size_t chunkSize() const;
+		/// Returns the chunk size.
+
+private:
+	ChunkedDigest();
+	ChunkedDigest(const ChunkedDigest&);
+	ChunkedDigest& operator = (const ChunkedDigest&);
+
+	std::string _name;
+	std::size_t _chunkSize;
+	Poco::ThreadPool& _threadPool;
+	DigestVec _chunkDigests;
+	Digest _digest;
+	OpenSSLInitializer _openSSLInitializer;
+};
+
+
+//
+// inlines
+//
+inline const ChunkedDigest::Digest& ChunkedDigest::digest() const
+{
+	return _digest;
+}
+
+
+inline const ChunkedDigest::DigestVec& ChunkedDigest::chunkDigests() const
+{
+	return _chunkDigests;
+}
+
+
+inline const std::string& ChunkedDigest::algorithm() const
+{
+	return _name;
+}
+
+
+inline std::size_t ChunkedDigest::chunkSize() const
+{
+	return _chunkSize;
+}
+
+
+} } // namespace Poco::Crypto
+
+
+#endif // Crypto_ChunkedDigest_INCLUDED
@@ -0,0 +1,175 @@
+//
+// CryptoCache.h
+//
+// $Id: //poco/1.4/Crypto/include/Poco/Crypto/CryptoCache.h#1 $
+//
+// Library: Crypto
+// Package: Certificate
+// Module:  CryptoCache
+//
+// Definition of the CryptoCache class.
+//
+// Copyright (c) 2013, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+// 
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+
+#ifndef Crypto_CryptoCache_INCLUDED
+#define Crypto_CryptoCache_INCLUDED
+
+
+#include "Poco/Crypto/Crypto.h"
+#include "Poco/Crypto/X509Certificate.h"
+#include "Poco/Crypto/RSAKey.h"
+#include "Poco/Crypto/OpenSSLInitializer.h"
+#include "Poco/LRUCache.h"
+#include "Poco/SharedPtr.h"
+#include "Poco/AtomicCounter.h"
+#include <openssl/x509.h>
+
+
+namespace Poco {
+namespace Crypto {
+
+
+class Crypto_API CryptoCache
+	/// A thread-safe cache of parsed X509Certificate and RSAKey
+	/// objects, indexed by a SHA-256 digest of their encoding.
+	///
+	/// Applications that repeatedly construct the same certificates
+	/// or keys from PEM data (for example, when inspecting client
+	/// certificates or verifying signatures on every request) can use
+	/// a CryptoCache to parse every distinct certificate or key only once.
+	/// Subsequent lookups only compute the digest of the data and
+	/// return the already parsed object.
+	///
+	/// Cached objects are shared between all callers and must therefore
+	/// not be modified. Both X509Certificate and RSAKey can safely be
+	/// used from multiple threads concurrently.
+	///
+	/// The number of entries held is limited; when the limit is
+	/// reached, the least recently used entries are discarded.
+{
+public:
+	typedef Poco::SharedPtr<X509Certificate> CertificatePtr;
+
+	enum
+	{
+		DEFAULT_CAPACITY = 256
+	};
+
+	explicit CryptoCache(long capacity = DEFAULT_CAPACITY);
+		/// Creates the CryptoCache, holding up to the given
+		/// number of certificates and up to the given number
+		/// of keys.
+
+	~CryptoCache();
+		/// Destroys the CryptoCache.
+
+	CertificatePtr certificate(const std::string& pem);
+		/// Returns the certificate for the given PEM data. 
+		/// The certificate is only parsed if it is not already
+		/// in the cache.
+		///
+		/// Throws an IOException if the data does not contain 
+		/// a valid certificate.
+
+	CertificatePtr certificate(X509* pCert);
+		/// Returns the cached certificate having the same 
+		/// DER encoding as the given OpenSSL certificate
+		/// (for example, the peer certificate of a SSL
+		/// connection). If there is no such certificate in 
+		/// the cache, a new X509Certificate sharing pCert is 
+		/// added to the cache. Ownership of pCert is not taken.
+
+	RSAKey publicKey(const std::string& pem);
+		/// Returns the RSA public key for the given PEM data.
+		/// The key is only parsed if it is not already
+		/// in the cache.
+
+	RSAKey privateKey(const std::string& pem, const std::string& passphrase = "");
+		/// Returns the RSA key pair for the given PEM data containing 
+		/// an (optionally encrypted) private key. The key is only parsed 
+		/// if the same data has not already been loaded using the 
+		/// same passphrase.
+
+	void clear();
+		/// Removes all certificates and keys from the cache.
+
+	std::size_t size();
+		/// Returns the number of certificates and keys in the cache.
+
+	int hits() const;
+		/// Returns the number of lookups that were satisfied
+		/// from the cache.
+
+	int misses() const;
+		/// Returns the number of lookups that required parsing.
+
+	static CryptoCache& defaultCache();
+		/// Returns the default CryptoCache.
+
+private:
+	enum Type
+	{
+		TYPE_CERTIFICATE = 'C',
+		TYPE_DER_CERTIFICATE = 'D',
+		TYPE_PUBLIC_KEY  = 'P',
+		TYPE_PRIVATE_KEY = 'K'
+	};
+
+	static std::string digest(Type type, const std::string& data, const std::string& passphrase = "");
+	static std::string digest(X509* pCert);
+
+	CryptoCache(const CryptoCache&);
+	CryptoCache& operator = (const CryptoCache&);
+
+	Poco::LRUCache<std::string, X509Certificate> _certificates;
+	Poco::LRUCache<std::string, RSAKey> _keys;
+	Poco::AtomicCounter _hits;
+	Poco::AtomicCounter _misses;
+	OpenSSLInitializer _openSSLInitializer;
+};
+
+
+//
+// inlines
+//
+inline int CryptoCache::hits() const
+{
+	return _hits.value();
+}
+
+
+inline int CryptoCache::misses() const
+{
+	return _misses.value();
+}
+
+
+} } // namespace Poco::Crypto
+
+
+#endif // Crypto_CryptoCache_INCLUDED
@@ -77,6 +77,7 @@ protected:
 	
 private:
 	std::string _name;
+	const EVP_MD* _md;
 	EVP_MD_CTX* _ctx;
 	Poco::DigestEngine::Digest _digest;
 };
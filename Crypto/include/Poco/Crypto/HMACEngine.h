@@ -0,0 +1,127 @@
+//
+// HMACEngine.h
+//
+// $Id: //poco/1.4/Crypto/include/Poco/Crypto/HMACEngine.h#1 $
+//
+// Library: Crypto
+// Package: Digest
+// Module:  HMACEngine
+//
+// Definition of the HMACEngine class.
+//
+// Copyright (c) 2013, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+// 
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+
+#ifndef Crypto_HMACEngine_INCLUDED
+#define Crypto_HMACEngine_INCLUDED
+
+
+#include "Poco/Crypto/Crypto.h"
+#include "Poco/Crypto/OpenSSLInitializer.h"
+#include "Poco/DigestEngine.h"
+#include <openssl/hmac.h>
+
+
+namespace Poco {
+namespace Crypto {
+
+
+class Crypto_API HMACEngine: public Poco::DigestEngine
+	/// This class implements a HMAC (Keyed-Hashing for Message
+	/// Authentication, RFC 2104) Poco::DigestEngine for all digest
+	/// algorithms supported by OpenSSL, e.g. "SHA256" or "SHA512".
+	///
+	/// The key is processed only once, when the engine is created.
+	/// reset() and digest() return the engine to its keyed initial
+	/// state by copying the saved inner hash state, so authenticating
+	/// many messages with the same key costs little more than hashing
+	/// them.
+	///
+	/// An HMACEngine must not be used by multiple threads at once.
+	/// Use clone() to give every thread its own copy of a keyed engine.
+{
+public:
+	HMACEngine(const std::string& name, const std::string& key);
+		/// Creates a HMACEngine using the digest with the given name
+		/// (e.g., "SHA1", "SHA256", "SHA512", etc.) and the given key.
+		///
+		/// Throws a Poco::NotFoundException if no algorithm with the given name exists.
+
+	HMACEngine(const std::string& name, const void* key, std::size_t length);
+		/// Creates a HMACEngine using the digest with the given name
+		/// and the given binary key.
+		///
+		/// Throws a Poco::NotFoundException if no algorithm with the given name exists.
+
+	~HMACEngine();
+		/// Destroys the HMACEngine.
+
+	HMACEngine* clone() const;
+		/// Returns a new HMACEngine with the same algorithm, key and
+		/// state as this one. Data already passed to update() is
+		/// included in the digest of both engines.
+		///
+		/// The caller takes ownership of the returned engine.
+
+	const std::string& algorithm() const;
+		/// Returns the name of the digest algorithm.
+
+	// DigestEngine
+	std::size_t digestLength() const;
+	void reset();
+	const Poco::DigestEngine::Digest& digest();
+
+protected:
+	void updateImpl(const void* data, std::size_t length);
+
+private:
+	HMACEngine(const HMACEngine& engine);
+	HMACEngine& operator = (const HMACEngine&);
+
+	void init(const void* key, std::size_t length);
+
+	std::string _name;
+	const EVP_MD* _md;
+	HMAC_CTX* _pContext;
+	Poco::DigestEngine::Digest _digest;
+	OpenSSLInitializer _openSSLInitializer;
+};
+
+
+//
+// inlines
+//
+inline const std::string& HMACEngine::algorithm() const
+{
+	return _name;
+}
+
+
+} } // namespace Poco::Crypto
+
+
+#endif // Crypto_HMACEngine_INCLUDED
@@ -42,7 +42,9 @@
 
 #include "Poco/Crypto/Crypto.h"
 #include "Poco/Mutex.h"
+#include "Poco/RWLock.h"
 #include <openssl/opensslconf.h>
+#include <openssl/crypto.h>
 #ifdef OPENSSL_FIPS
 #include <openssl/fips.h>
 #endif
@@ -52,7 +54,7 @@ extern "C"
 {
 	struct CRYPTO_dynlock_value
 	{
-		Poco::FastMutex _mutex;
+		Poco::RWLock _lock;
 	};
 }
 
@@ -66,6 +68,21 @@ class Crypto_API OpenSSLInitializer
 	///
 	/// The class ensures the earliest initialization and the
 	/// latest shutdown of the OpenSSL library.
+	///
+	/// For OpenSSL versions before 1.1.0, the class also installs
+	/// the locking callbacks OpenSSL needs for multithreaded use.
+	/// Both the static and the dynamic locks are read/write locks,
+	/// so that read-mostly structures like the error string and
+	/// error state tables or the X509 store can be accessed from
+	/// many threads at once. The static locks are padded to a cache
+	/// line each to avoid false sharing between unrelated locks.
+	///
+	/// This does not reduce contention on the random number generator.
+	/// OpenSSL 1.0.x takes CRYPTO_LOCK_RAND for writing on every call
+	/// to RAND_bytes(), so RNG access remains serialized across all
+	/// threads, as before.
+	/// OpenSSL 1.1.0 and later does its own locking, so no callbacks
+	/// are installed there.
 {
 public:
 	OpenSSLInitializer();
@@ -92,15 +109,30 @@ protected:
 		SEEDSIZE = 256
 	};
 	
+	enum
+	{
+		CACHE_LINE_SIZE = 64
+	};
+
+	struct Lock
+		/// A static OpenSSL lock, padded to a full cache line.
+	{
+		Poco::RWLock rwl;
+		char pad[CACHE_LINE_SIZE - sizeof(Poco::RWLock) % CACHE_LINE_SIZE];
+	};
+
 	// OpenSSL multithreading support
 	static void lock(int mode, int n, const char* file, int line);
 	static unsigned long id();
+#if OPENSSL_VERSION_NUMBER >= 0x10000000L && OPENSSL_VERSION_NUMBER < 0x10100000L
+	static void threadId(CRYPTO_THREADID* id);
+#endif
 	static struct CRYPTO_dynlock_value* dynlockCreate(const char* file, int line);
 	static void dynlock(int mode, struct CRYPTO_dynlock_value* lock, const char* file, int line);
 	static void dynlockDestroy(struct CRYPTO_dynlock_value* lock, const char* file, int line);
 
 private:
-	static Poco::FastMutex* _mutexes;
+	static Lock* _locks;
 	static Poco::FastMutex _mutex;
 	static int _rc;
 };
@@ -0,0 +1,107 @@
+//
+// ParallelFor.h
+//
+// $Id: //poco/1.4/Crypto/include/Poco/Crypto/ParallelFor.h#1 $
+//
+// Library: Crypto
+// Package: CryptoCore
+// Module:  ParallelFor
+//
+// Definition of the ParallelFor class.
+//
+// Copyright (c) 2013, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+// 
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+
+#ifndef Crypto_ParallelFor_INCLUDED
+#define Crypto_ParallelFor_INCLUDED
+
+
+#include "Poco/Crypto/Crypto.h"
+#include "Poco/ThreadPool.h"
+
+
+namespace Poco {
+namespace Crypto {
+
+
+class Crypto_API ParallelFor
+	/// ParallelFor processes a range of independent items, using
+	/// the calling thread and the idle threads of a Poco::ThreadPool.
+	///
+	/// Every participating thread gets its own Worker from
+	/// createWorker(). The workers take the index of the next
+	/// item to process from a counter shared by all threads,
+	/// until all items are done.
+	///
+	/// This class is used internally by the Crypto library.
+{
+public:
+	class Crypto_API Worker
+		/// Processes the items handed out to one thread.
+	{
+	public:
+		virtual ~Worker();
+			/// Destroys the Worker.
+
+		virtual void process(int index) = 0;
+			/// Processes the item with the given index.
+	};
+
+	ParallelFor();
+		/// Creates the ParallelFor.
+
+	virtual ~ParallelFor();
+		/// Destroys the ParallelFor.
+
+	void run(int count, Poco::ThreadPool* pPool);
+		/// Processes the items with indexes 0 to count - 1.
+		///
+		/// If pPool is not null, up to count - 1 idle threads from
+		/// the pool help the calling thread. Returns when all threads
+		/// are done.
+		///
+		/// A worker that throws an exception stops, and its remaining
+		/// items are processed by the other threads. The first exception 
+		/// is rethrown once all threads are done.
+
+protected:
+	virtual Worker* createWorker(bool pooled) = 0;
+		/// Creates the Worker for a participating thread. All workers
+		/// are created by the calling thread. pooled is false for the
+		/// worker of the calling thread, and true for the workers
+		/// of pool threads.
+
+private:
+	ParallelFor(const ParallelFor&);
+	ParallelFor& operator = (const ParallelFor&);
+};
+
+
+} } // namespace Poco::Crypto
+
+
+#endif // Crypto_ParallelFor_INCLUDED
@@ -77,6 +77,14 @@ public:
 	CryptoTransform* createDecryptor();
 		/// Creates a decrytor object.
 
+	std::string encryptString(const std::string& str, Encoding encoding = ENC_NONE);
+		/// Encrypts a string. Unencoded data is encrypted directly
+		/// with the RSA key, without creating an encryptor.
+
+	std::string decryptString(const std::string& str, Encoding encoding = ENC_NONE);
+		/// Decrypts a string. Unencoded data is decrypted directly
+		/// with the RSA key, without creating a decryptor.
+
 private:
 	RSAKey _key;
 	RSAPaddingMode _paddingMode;
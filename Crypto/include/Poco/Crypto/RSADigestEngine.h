@@ -45,9 +45,11 @@
 #include "Poco/DigestEngine.h"
 #include "Poco/MD5Engine.h"
 #include "Poco/SHA1Engine.h"
+#include "Poco/ThreadPool.h"
 #include <openssl/rsa.h>
 #include <istream>
 #include <ostream>
+#include <vector>
 
 
 namespace Poco {
@@ -67,8 +69,15 @@ class Crypto_API RSADigestEngine: public Poco::DigestEngine
 	/// member function. It will decrypt the signature
 	/// using the RSA public key and compare the resulting
 	/// hash with the actual hash of the data.
+	///
+	/// For signing or verifying many digests with the same
+	/// key, the signDigests() and verifyDigests() member
+	/// functions can be used, optionally distributing the
+	/// work across the threads of a thread pool.
 {
 public:
+	typedef std::vector<Poco::DigestEngine::Digest> DigestVec;
+
 	enum DigestType
 	{
 		DIGEST_MD5,
@@ -108,10 +117,42 @@ public:
 		///
 		/// Returns true if the signature can be verified, false otherwise.
 
+	void signDigests(const DigestVec& digests, DigestVec& signatures);
+		/// Signs every digest in digests, which must have been computed
+		/// with the engine's hash algorithm, using the RSA private key.
+		/// The signatures are stored in signatures, in the same order.
+		///
+		/// Does not affect the data passed to update().
+		///
+		/// Throws an IOException if a digest cannot be signed.
+
+	void signDigests(const DigestVec& digests, DigestVec& signatures, Poco::ThreadPool& pool);
+		/// Signs every digest in digests, using the available threads
+		/// of the given pool in addition to the calling thread.
+		///
+		/// Every thread works with its own copy of the RSA key,
+		/// so that the threads do not contend for the key's
+		/// blinding and Montgomery contexts.
+
+	bool verifyDigests(const DigestVec& digests, const DigestVec& signatures, std::vector<bool>& results);
+		/// Verifies every digest in digests against the signature
+		/// at the same position in signatures, using the RSA
+		/// public key. The outcome for each digest is stored
+		/// in results.
+		///
+		/// Returns true if all signatures could be verified,
+		/// false otherwise.
+
+	bool verifyDigests(const DigestVec& digests, const DigestVec& signatures, std::vector<bool>& results, Poco::ThreadPool& pool);
+		/// Verifies every digest in digests, using the available
+		/// threads of the given pool in addition to the calling thread.
+
 protected:
 	void updateImpl(const void* data, std::size_t length);
 
 private:
+	void processDigests(bool sign, const DigestVec& digests, DigestVec& signatures, std::vector<char>& results, Poco::ThreadPool* pPool);
+
 	RSAKey _key;
 	Poco::DigestEngine& _engine;
 	int _type;
@@ -44,6 +44,7 @@
 #include "Poco/Crypto/OpenSSLInitializer.h"
 #include "Poco/DateTime.h"
 #include "Poco/SharedPtr.h"
+#include "Poco/Mutex.h"
 #include <set>
 #include <istream>
 #include <openssl/ssl.h>
@@ -90,6 +91,9 @@ public:
 
 	X509Certificate(const X509Certificate& cert);
 		/// Creates the certificate by copying another one.
+		///
+		/// The underlying OpenSSL certificate is not duplicated;
+		/// both objects share it by means of its reference count.
 
 	X509Certificate& operator = (const X509Certificate& cert);
 		/// Assigns a certificate.
@@ -102,6 +106,9 @@ public:
 
 	const std::string& issuerName() const;
 		/// Returns the certificate issuer's distinguished name. 
+		///
+		/// Issuer and subject name are extracted from the certificate
+		/// on first access to either of them.
 		
 	std::string issuerName(NID nid) const;
 		/// Extracts the information specified by the given
@@ -162,8 +169,9 @@ protected:
 		/// Loads the certificate from the given file. The
 		/// certificate must be in PEM format.
 
-	void init();
-		/// Extracts issuer and subject name from the certificate.
+	void init() const;
+		/// Extracts issuer and subject name from the certificate,
+		/// unless this has already been done.
 	
 private:
 	enum
@@ -171,8 +179,10 @@ private:
 		NAME_BUFFER_SIZE = 256
 	};
 	
-	std::string _issuerName;
-	std::string _subjectName;
+	mutable std::string _issuerName;
+	mutable std::string _subjectName;
+	mutable bool        _namesExtracted;
+	mutable Poco::FastMutex _mutex;
 	X509*       _pCert;
 	OpenSSLInitializer _openSSLInitializer;
 };
@@ -181,18 +191,6 @@ private:
 //
 // inlines
 //
-inline const std::string& X509Certificate::issuerName() const
-{
-	return _issuerName;
-}
-
-
-inline const std::string& X509Certificate::subjectName() const
-{
-	return _subjectName;
-}
-
-
 inline const X509* X509Certificate::certificate() const
 {
 	return _pCert;
@@ -0,0 +1,152 @@
+//
+// cipherbench.cpp
+//
+// $Id: //poco/1.4/Crypto/samples/cipherbench/src/cipherbench.cpp#1 $
+//
+// This sample compares the throughput of CryptoOutputStream with
+// in-place encryption using BatchCipher.
+//
+// Copyright (c) 2013, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+// 
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+
+
+
+#include "Poco/Crypto/Crypto.h"
+#include "Poco/Crypto/CipherFactory.h"
+#include "Poco/Crypto/Cipher.h"
+#include "Poco/Crypto/CipherKey.h"
+#include "Poco/Crypto/CryptoStream.h"
+#include "Poco/Crypto/BatchCipher.h"
+#include "Poco/NullStream.h"
+#include "Poco/ThreadPool.h"
+#include "Poco/Stopwatch.h"
+#include "Poco/NumberParser.h"
+#include "Poco/Exception.h"
+#include <vector>
+#include <iostream>
+#include <iomanip>
+
+
+using Poco::Crypto::CipherFactory;
+using Poco::Crypto::Cipher;
+using Poco::Crypto::CipherKey;
+using Poco::Crypto::CryptoOutputStream;
+using Poco::Crypto::BatchCipher;
+using Poco::NullOutputStream;
+using Poco::ThreadPool;
+using Poco::Stopwatch;
+using Poco::NumberParser;
+using Poco::Exception;
+
+
+double throughput(std::size_t bytes, const Stopwatch& sw)
+{
+	return double(bytes)/(1024*1024)/(double(sw.elapsed())/Stopwatch::resolution());
+}
+
+
+double measureStream(const CipherKey& key, std::vector<unsigned char>& data)
+	/// Encrypts the data with a CryptoOutputStream, writing
+	/// the result to a NullOutputStream.
+{
+	Cipher::Ptr pCipher = CipherFactory::defaultFactory().createCipher(key);
+	NullOutputStream sink;
+	Stopwatch sw;
+	sw.start();
+	Poco::Crypto::EncryptingOutputStream encryptor(sink, *pCipher);
+	encryptor.write(reinterpret_cast<const char*>(&data[0]), static_cast<std::streamsize>(data.size()));
+	encryptor.close();
+	sw.stop();
+	return throughput(data.size(), sw);
+}
+
+
+double measureBatch(BatchCipher& cipher, std::vector<unsigned char>& data)
+	/// Encrypts the data in place.
+{
+	static Poco::UInt64 message = 0;
+	std::vector<unsigned char> tags;
+	Stopwatch sw;
+	sw.start();
+	if (cipher.key().mode() == Poco::Crypto::CipherKeyImpl::MODE_GCM)
+		cipher.encrypt(&data[0], data.size(), ++message, tags);
+	else
+		cipher.encrypt(&data[0], data.size());
+	sw.stop();
+	return throughput(data.size(), sw);
+}
+
+
+int main(int argc, char** argv)
+{
+	int megabytes = 256;
+	int threads = 4;
+	if ((argc > 1 && (!NumberParser::tryParse(argv[1], megabytes) || megabytes < 1)) ||
+	    (argc > 2 && (!NumberParser::tryParse(argv[2], threads) || threads < 1)))
+	{
+		std::cout << "usage: cipherbench [<megabytes> [<threads>]]" << std::endl;
+		return 1;
+	}
+
+	Poco::Crypto::initializeCrypto();
+	try
+	{
+		std::vector<unsigned char> data(static_cast<std::size_t>(megabytes)*1024*1024, 'x');
+		ThreadPool pool(threads, threads);
+
+		std::cout << "Encryption throughput in MB/s, " << megabytes << " MB, "
+		          << threads << " threads" << std::endl << std::endl
+		          << std::setw(14) << "cipher"
+		          << std::setw(12) << "stream"
+		          << std::setw(12) << "in place"
+		          << std::setw(12) << "parallel" << std::endl;
+
+		const char* ciphers[] = {"aes-128-cbc", "aes-256-cbc", "aes-128-ctr", "aes-256-ctr", "aes-128-gcm", "aes-256-gcm"};
+		for (std::size_t i = 0; i < sizeof(ciphers)/sizeof(ciphers[0]); ++i)
+		{
+			CipherKey key(ciphers[i]);
+			BatchCipher serial(key);
+			BatchCipher parallel(key, pool);
+			std::cout << std::setw(14) << ciphers[i] << std::fixed << std::setprecision(1)
+			          << std::setw(12) << measureStream(key, data)
+			          << std::setw(12) << measureBatch(serial, data);
+			if (parallel.parallel())
+				std::cout << std::setw(12) << measureBatch(parallel, data);
+			else
+				std::cout << std::setw(12) << "-";
+			std::cout << std::endl;
+		}
+	}
+	catch (Exception& exc)
+	{
+		std::cerr << exc.displayText() << std::endl;
+		Poco::Crypto::uninitializeCrypto();
+		return 1;
+	}
+	Poco::Crypto::uninitializeCrypto();
+	return 0;
+}
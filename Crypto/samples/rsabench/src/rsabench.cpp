@@ -0,0 +1,187 @@
+//
+// rsabench.cpp
+//
+// $Id: //poco/1.4/Crypto/samples/rsabench/src/rsabench.cpp#1 $
+//
+// This sample measures RSA signatures and verifications per second,
+// signing one message at a time and using the batch interface
+// of RSADigestEngine.
+//
+// Copyright (c) 2013, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+// 
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+
+
+#include "Poco/Crypto/Crypto.h"
+#include "Poco/Crypto/RSAKey.h"
+#include "Poco/Crypto/RSADigestEngine.h"
+#include "Poco/SHA1Engine.h"
+#include "Poco/ThreadPool.h"
+#include "Poco/Stopwatch.h"
+#include "Poco/NumberParser.h"
+#include "Poco/NumberFormatter.h"
+#include "Poco/Exception.h"
+#include <vector>
+#include <iostream>
+#include <iomanip>
+
+
+using Poco::Crypto::RSAKey;
+using Poco::Crypto::RSADigestEngine;
+using Poco::SHA1Engine;
+using Poco::ThreadPool;
+using Poco::Stopwatch;
+using Poco::NumberParser;
+using Poco::NumberFormatter;
+using Poco::Exception;
+
+
+double rate(std::size_t count, const Stopwatch& sw)
+{
+	return double(count)/(double(sw.elapsed())/Stopwatch::resolution());
+}
+
+
+double measureSingle(const RSAKey& key, const std::vector<std::string>& tokens)
+	/// Signs every token with a new RSADigestEngine.
+{
+	Stopwatch sw;
+	sw.start();
+	for (std::vector<std::string>::const_iterator it = tokens.begin(); it != tokens.end(); ++it)
+	{
+		RSADigestEngine engine(key);
+		engine.update(*it);
+		engine.signature();
+	}
+	sw.stop();
+	return rate(tokens.size(), sw);
+}
+
+
+double measureVerifySingle(const RSAKey& key, const std::vector<std::string>& tokens, const RSADigestEngine::DigestVec& signatures)
+	/// Verifies every token with a new RSADigestEngine.
+{
+	Stopwatch sw;
+	sw.start();
+	for (std::size_t i = 0; i < tokens.size(); ++i)
+	{
+		RSADigestEngine engine(key);
+		engine.update(tokens[i]);
+		if (!engine.verify(signatures[i])) throw Poco::DataException("verification failed");
+	}
+	sw.stop();
+	return rate(tokens.size(), sw);
+}
+
+
+double measureBatch(const RSAKey& key, const RSADigestEngine::DigestVec& digests, RSADigestEngine::DigestVec& signatures, ThreadPool* pPool)
+	/// Signs all digests with a single call to signDigests().
+{
+	RSADigestEngine engine(key);
+	Stopwatch sw;
+	sw.start();
+	if (pPool)
+		engine.signDigests(digests, signatures, *pPool);
+	else
+		engine.signDigests(digests, signatures);
+	sw.stop();
+	return rate(digests.size(), sw);
+}
+
+
+double measureVerifyBatch(const RSAKey& key, const RSADigestEngine::DigestVec& digests, const RSADigestEngine::DigestVec& signatures, ThreadPool* pPool)
+	/// Verifies all digests with a single call to verifyDigests().
+{
+	RSADigestEngine engine(key);
+	std::vector<bool> results;
+	Stopwatch sw;
+	sw.start();
+	bool ok = pPool ? engine.verifyDigests(digests, signatures, results, *pPool) : engine.verifyDigests(digests, signatures, results);
+	sw.stop();
+	if (!ok) throw Poco::DataException("verification failed");
+	return rate(digests.size(), sw);
+}
+
+
+int main(int argc, char** argv)
+{
+	int count = 1000;
+	int threads = 4;
+	if ((argc > 1 && (!NumberParser::tryParse(argv[1], count) || count < 1)) ||
+	    (argc > 2 && (!NumberParser::tryParse(argv[2], threads) || threads < 1)))
+	{
+		std::cout << "usage: rsabench [<signatures> [<threads>]]" << std::endl;
+		return 1;
+	}
+
+	Poco::Crypto::initializeCrypto();
+	try
+	{
+		std::vector<std::string> tokens;
+		RSADigestEngine::DigestVec digests;
+		for (int i = 0; i < count; ++i)
+		{
+			std::string token("token-");
+			token += NumberFormatter::format(i);
+			tokens.push_back(token);
+			SHA1Engine sha1;
+			sha1.update(token);
+			digests.push_back(sha1.digest());
+		}
+		ThreadPool pool(threads, threads);
+
+		std::cout << "Operations per second, " << count << " tokens, "
+		          << threads << " threads" << std::endl << std::endl
+		          << std::setw(10) << "key"
+		          << std::setw(10) << "op"
+		          << std::setw(12) << "single"
+		          << std::setw(12) << "batch"
+		          << std::setw(12) << "parallel" << std::endl;
+
+		RSAKey::KeyLength keyLengths[] = {RSAKey::KL_1024, RSAKey::KL_2048, RSAKey::KL_4096};
+		for (std::size_t i = 0; i < sizeof(keyLengths)/sizeof(keyLengths[0]); ++i)
+		{
+			RSAKey key(keyLengths[i], RSAKey::EXP_LARGE);
+			RSADigestEngine::DigestVec signatures;
+			std::cout << std::setw(10) << key.size()*8 << std::setw(10) << "sign" << std::fixed << std::setprecision(0)
+			          << std::setw(12) << measureSingle(key, tokens)
+			          << std::setw(12) << measureBatch(key, digests, signatures, 0)
+			          << std::setw(12) << measureBatch(key, digests, signatures, &pool) << std::endl;
+			std::cout << std::setw(10) << key.size()*8 << std::setw(10) << "verify"
+			          << std::setw(12) << measureVerifySingle(key, tokens, signatures)
+			          << std::setw(12) << measureVerifyBatch(key, digests, signatures, 0)
+			          << std::setw(12) << measureVerifyBatch(key, digests, signatures, &pool) << std::endl;
+		}
+	}
+	catch (Exception& exc)
+	{
+		std::cerr << exc.displayText() << std::endl;
+		Poco::Crypto::uninitializeCrypto();
+		return 1;
+	}
+	Poco::Crypto::uninitializeCrypto();
+	return 0;
+}
@@ -0,0 +1,373 @@
+//
+// BatchCipher.cpp
+//
+// $Id: //poco/1.4/Crypto/src/BatchCipher.cpp#1 $
+//
+// Library: Crypto
+// Package: Cipher
+// Module:  BatchCipher
+//
+// Copyright (c) 2013, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+// 
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+
+#include "Poco/Crypto/BatchCipher.h"
+#include "Poco/Crypto/CipherKeyImpl.h"
+#include "Poco/Crypto/ParallelFor.h"
+#include "Poco/AtomicCounter.h"
+#include "Poco/Exception.h"
+#include <openssl/evp.h>
+#include <openssl/err.h>
+#include <algorithm>
+#include <cstring>
+
+
+namespace Poco {
+namespace Crypto {
+
+
+namespace
+{
+	void throwError()
+	{
+		unsigned long err;
+		std::string msg;
+		
+		while ((err = ERR_get_error()))
+		{
+			if (!msg.empty())
+				msg.append("; ");
+			msg.append(ERR_error_string(err, 0));
+		}
+
+		throw Poco::IOException(msg);
+	}
+
+
+	class CipherContext
+		/// Manages the lifetime of an EVP_CIPHER_CTX.
+	{
+	public:
+		CipherContext()
+		{
+			EVP_CIPHER_CTX_init(&_ctx);
+		}
+
+		~CipherContext()
+		{
+			EVP_CIPHER_CTX_cleanup(&_ctx);
+		}
+
+		EVP_CIPHER_CTX* get()
+		{
+			return &_ctx;
+		}
+
+	private:
+		EVP_CIPHER_CTX _ctx;
+	};
+
+
+	struct Job
+		/// Everything the segment workers need to know.
+	{
+		const EVP_CIPHER* pCipher;
+		CipherKeyImpl::Mode mode;
+		const unsigned char* key;
+		const unsigned char* iv;
+		int ivLength;
+		bool encrypt;
+		unsigned char* data;
+		std::size_t length;
+		std::size_t segmentSize;
+		int nSegments;
+		Poco::UInt64 message;
+		unsigned char* tags;
+		Poco::AtomicCounter authFailures;
+	};
+
+
+	void update(EVP_CIPHER_CTX* pCtx, unsigned char* data, std::size_t length)
+		/// Transforms length bytes in place. EVP_CipherUpdate() only
+		/// takes an int length, so very large segments are split.
+	{
+		const std::size_t MAX_UPDATE_SIZE = 0x40000000;
+		while (length > 0)
+		{
+			int n = static_cast<int>(std::min(length, MAX_UPDATE_SIZE));
+			int outLength = 0;
+			if (!EVP_CipherUpdate(pCtx, data, &outLength, data, n))
+				throwError();
+			data += n;
+			length -= n;
+		}
+	}
+
+
+	void processSegment(Job& job, int segment)
+	{
+		std::size_t offset = static_cast<std::size_t>(segment)*job.segmentSize;
+		std::size_t length = std::min(job.segmentSize, job.length - offset);
+		unsigned char iv[EVP_MAX_IV_LENGTH];
+		if (job.iv) std::memcpy(iv, job.iv, job.ivLength);
+
+		CipherContext ctx;
+		if (job.mode == CipherKeyImpl::MODE_GCM)
+		{
+			Poco::UInt64 message = job.message;
+			for (int i = 7; i >= 0; --i, message >>= 8)
+			{
+				iv[i] ^= static_cast<unsigned char>(message & 0xFF);
+			}
+			Poco::UInt32 n = segment;
+			for (int i = 0; i < 4; ++i, n >>= 8)
+			{
+				iv[job.ivLength - 1 - i] ^= static_cast<unsigned char>(n & 0xFF);
+			}
+			if (!EVP_CipherInit_ex(ctx.get(), job.pCipher, NULL, NULL, NULL, job.encrypt ? 1 : 0))
+				throwError();
+			if (!EVP_CIPHER_CTX_ctrl(ctx.get(), EVP_CTRL_GCM_SET_IVLEN, job.ivLength, NULL))
+				throwError();
+			if (!EVP_CipherInit_ex(ctx.get(), NULL, NULL, job.key, iv, -1))
+				throwError();
+
+			unsigned char aad[8];
+			Poco::UInt64 total = job.length;
+			for (int i = 7; i >= 0; --i, total >>= 8)
+			{
+				aad[i] = static_cast<unsigned char>(total & 0xFF);
+			}
+			int outLength = 0;
+			if (!EVP_CipherUpdate(ctx.get(), NULL, &outLength, aad, sizeof(aad)))
+				throwError();
+			update(ctx.get(), job.data + offset, length);
+
+			unsigned char* tag = job.tags + segment*BatchCipher::TAG_SIZE;
+			unsigned char final[EVP_MAX_BLOCK_LENGTH];
+			if (job.encrypt)
+			{
+				if (!EVP_CipherFinal_ex(ctx.get(), final, &outLength))
+					throwError();
+				if (!EVP_CIPHER_CTX_ctrl(ctx.get(), EVP_CTRL_GCM_GET_TAG, BatchCipher::TAG_SIZE, tag))
+					throwError();
+			}
+			else
+			{
+				if (!EVP_CIPHER_CTX_ctrl(ctx.get(), EVP_CTRL_GCM_SET_TAG, BatchCipher::TAG_SIZE, tag))
+					throwError();
+				if (EVP_CipherFinal_ex(ctx.get(), final, &outLength) <= 0)
+				{
+					ERR_clear_error();
+					++job.authFailures;
+				}
+			}
+		}
+		else
+		{
+			if (job.mode == CipherKeyImpl::MODE_CTR)
+			{
+				// The counter block is a 128-bit big-endian number
+				// that is incremented for every cipher block.
+				Poco::UInt64 blocks = offset/16;
+				unsigned carry = 0;
+				for (int i = job.ivLength - 1; i >= 0 && (blocks || carry); --i, blocks >>= 8)
+				{
+					carry += iv[i] + static_cast<unsigned>(blocks & 0xFF);
+					iv[i] = static_cast<unsigned char>(carry & 0xFF);
+					carry >>= 8;
+				}
+			}
+			if (!EVP_CipherInit_ex(ctx.get(), job.pCipher, NULL, job.key, job.iv ? iv : NULL, job.encrypt ? 1 : 0))
+				throwError();
+			EVP_CIPHER_CTX_set_padding(ctx.get(), 0);
+			update(ctx.get(), job.data + offset, length);
+		}
+	}
+
+
+	class SegmentWorker: public ParallelFor::Worker
+		/// Processes segments of a job.
+	{
+	public:
+		SegmentWorker(Job& job):
+			_job(job)
+		{
+		}
+
+		void process(int segment)
+		{
+			processSegment(_job, segment);
+		}
+
+	private:
+		Job& _job;
+	};
+
+
+	class SegmentProcessor: public ParallelFor
+		/// Processes all segments of a job.
+	{
+	public:
+		SegmentProcessor(Job& job):
+			_job(job)
+		{
+		}
+
+	protected:
+		Worker* createWorker(bool)
+		{
+			return new SegmentWorker(_job);
+		}
+
+	private:
+		Job& _job;
+	};
+}
+
+
+BatchCipher::BatchCipher(const CipherKey& key, std::size_t segmentSize):
+	_key(key),
+	_segmentSize(segmentSize),
+	_pThreadPool(0)
+{
+	if (segmentSize == 0 || segmentSize % 16 != 0)
+		throw Poco::InvalidArgumentException("segment size must be a non-zero multiple of 16");
+}
+
+
+BatchCipher::BatchCipher(const CipherKey& key, Poco::ThreadPool& threadPool, std::size_t segmentSize):
+	_key(key),
+	_segmentSize(segmentSize),
+	_pThreadPool(&threadPool)
+{
+	if (segmentSize == 0 || segmentSize % 16 != 0)
+		throw Poco::InvalidArgumentException("segment size must be a non-zero multiple of 16");
+}
+
+
+BatchCipher::~BatchCipher()
+{
+}
+
+
+void BatchCipher::encrypt(unsigned char* data, std::size_t length)
+{
+	if (_key.mode() == CipherKeyImpl::MODE_GCM)
+		throw Poco::InvalidAccessException("GCM encryption requires authentication tags");
+
+	process(data, length, true, 0, 0);
+}
+
+
+void BatchCipher::decrypt(unsigned char* data, std::size_t length)
+{
+	if (_key.mode() == CipherKeyImpl::MODE_GCM)
+		throw Poco::InvalidAccessException("GCM decryption requires authentication tags");
+
+	process(data, length, false, 0, 0);
+}
+
+
+void BatchCipher::encrypt(unsigned char* data, std::size_t length, Poco::UInt64 message, ByteVec& tags)
+{
+	if (_key.mode() != CipherKeyImpl::MODE_GCM)
+		throw Poco::InvalidAccessException("authentication tags require a GCM mode cipher");
+
+	tags.resize(segmentCount(length)*TAG_SIZE);
+	process(data, length, true, message, &tags[0]);
+}
+
+
+void BatchCipher::decrypt(unsigned char* data, std::size_t length, Poco::UInt64 message, const ByteVec& tags)
+{
+	if (_key.mode() != CipherKeyImpl::MODE_GCM)
+		throw Poco::InvalidAccessException("authentication tags require a GCM mode cipher");
+	if (tags.size() != segmentCount(length)*TAG_SIZE)
+		throw Poco::DataException("wrong number of authentication tags");
+
+	process(data, length, false, message, const_cast<unsigned char*>(&tags[0]));
+}
+
+
+bool BatchCipher::parallel() const
+{
+	if (!_pThreadPool) return false;
+
+	CipherKeyImpl::Mode mode = _key.mode();
+	return mode == CipherKeyImpl::MODE_CTR || mode == CipherKeyImpl::MODE_ECB || mode == CipherKeyImpl::MODE_GCM;
+}
+
+
+std::size_t BatchCipher::segmentCount(std::size_t length) const
+{
+	switch (_key.mode())
+	{
+	case CipherKeyImpl::MODE_GCM:
+		// even empty data gets a tag
+		return length == 0 ? 1 : (length - 1)/_segmentSize + 1;
+	case CipherKeyImpl::MODE_CTR:
+	case CipherKeyImpl::MODE_ECB:
+		return length == 0 ? 0 : (length - 1)/_segmentSize + 1;
+	default:
+		return length == 0 ? 0 : 1;
+	}
+}
+
+
+void BatchCipher::process(unsigned char* data, std::size_t length, bool encrypt, Poco::UInt64 message, unsigned char* tags)
+{
+	CipherKeyImpl::Ptr pImpl = _key.impl();
+	CipherKeyImpl::Mode mode = pImpl->mode();
+	if ((mode == CipherKeyImpl::MODE_ECB || mode == CipherKeyImpl::MODE_CBC) && length % pImpl->blockSize() != 0)
+		throw Poco::InvalidArgumentException("data length must be a multiple of the cipher block size");
+	if (mode == CipherKeyImpl::MODE_GCM && pImpl->getIV().size() < 12)
+		throw Poco::InvalidArgumentException("GCM requires an IV of at least 12 bytes");
+
+	std::size_t nSegments = segmentCount(length);
+	if (nSegments > static_cast<std::size_t>(0x7FFFFFFF))
+		throw Poco::InvalidArgumentException("too many segments; use a larger segment size");
+
+	Job job;
+	job.pCipher      = pImpl->cipher();
+	job.mode         = mode;
+	job.key          = &pImpl->getKey()[0];
+	job.iv           = pImpl->getIV().empty() ? 0 : &pImpl->getIV()[0];
+	job.ivLength     = static_cast<int>(pImpl->getIV().size());
+	job.encrypt      = encrypt;
+	job.data         = data;
+	job.length       = length;
+	job.segmentSize  = nSegments > 1 ? _segmentSize : std::max<std::size_t>(length, 1);
+	job.nSegments    = static_cast<int>(nSegments);
+	job.message      = message;
+	job.tags         = tags;
+
+	SegmentProcessor processor(job);
+	processor.run(job.nSegments, parallel() ? _pThreadPool : 0);
+	if (job.authFailures.value() > 0) throw Poco::DataException("authentication failed");
+}
+
+
+} } // namespace Poco::Crypto
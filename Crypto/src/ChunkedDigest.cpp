@@ -0,0 +1,167 @@
+//
+// ChunkedDigest.cpp
+//
+// $Id: //poco/1.4/Crypto/src/ChunkedDigest.cpp#1 $
+//
+// Library: Crypto
+// Package: Digest
+// Module:  ChunkedDigest
+//
+// Copyright (c) 2013, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+// 
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+
+#include "Poco/Crypto/ChunkedDigest.h"
+#include "Poco/Crypto/DigestEngine.h"
+#include "Poco/Crypto/ParallelFor.h"
+#include "Poco/SharedMemory.h"
+#include "Poco/File.h"
+#include "Poco/Exception.h"
+#include <algorithm>
+
+
+namespace Poco {
+namespace Crypto {
+
+
+namespace
+{
+	class ChunkWorker: public ParallelFor::Worker
+		/// Computes the digests of chunks.
+	{
+	public:
+		ChunkWorker(const std::string& name, const char* data, std::size_t length, std::size_t chunkSize, ChunkedDigest::DigestVec& digests):
+			_engine(name),
+			_data(data),
+			_length(length),
+			_chunkSize(chunkSize),
+			_digests(digests)
+		{
+		}
+
+		void process(int chunk)
+		{
+			std::size_t offset = chunk*_chunkSize;
+			_engine.update(_data + offset, std::min(_chunkSize, _length - offset));
+			_digests[chunk] = _engine.digest();
+		}
+
+	private:
+		DigestEngine _engine;
+		const char* _data;
+		std::size_t _length;
+		std::size_t _chunkSize;
+		ChunkedDigest::DigestVec& _digests;
+	};
+
+
+	class ChunkDigester: public ParallelFor
+		/// Computes the digests of all chunks.
+	{
+	public:
+		ChunkDigester(const std::string& name, const char* data, std::size_t length, std::size_t chunkSize, ChunkedDigest::DigestVec& digests):
+			_name(name),
+			_data(data),
+			_length(length),
+			_chunkSize(chunkSize),
+			_digests(digests)
+		{
+		}
+
+	protected:
+		Worker* createWorker(bool)
+		{
+			return new ChunkWorker(_name, _data, _length, _chunkSize, _digests);
+		}
+
+	private:
+		std::string _name;
+		const char* _data;
+		std::size_t _length;
+		std::size_t _chunkSize;
+		ChunkedDigest::DigestVec& _digests;
+	};
+}
+
+
+ChunkedDigest::ChunkedDigest(const std::string& name, std::size_t chunkSize):
+	_name(name),
+	_chunkSize(chunkSize),
+	_threadPool(Poco::ThreadPool::defaultPool())
+{
+	if (chunkSize == 0) throw Poco::InvalidArgumentException("chunk size must not be zero");
+	DigestEngine engine(_name);
+}
+
+
+ChunkedDigest::ChunkedDigest(const std::string& name, std::size_t chunkSize, Poco::ThreadPool& threadPool):
+	_name(name),
+	_chunkSize(chunkSize),
+	_threadPool(threadPool)
+{
+	if (chunkSize == 0) throw Poco::InvalidArgumentException("chunk size must not be zero");
+	DigestEngine engine(_name);
+}
+
+
+ChunkedDigest::~ChunkedDigest()
+{
+}
+
+
+const ChunkedDigest::Digest& ChunkedDigest::digestFile(const std::string& path)
+{
+	Poco::File file(path);
+	if (file.getSize() == 0) return digest(0, 0);
+
+	Poco::SharedMemory mem(file, Poco::SharedMemory::AM_READ);
+	return digest(mem.begin(), mem.end() - mem.begin());
+}
+
+
+const ChunkedDigest::Digest& ChunkedDigest::digest(const void* data, std::size_t length)
+{
+	std::size_t nChunks = length/_chunkSize + (length % _chunkSize ? 1 : 0);
+	if (nChunks > static_cast<std::size_t>(0x7FFFFFFF))
+		throw Poco::InvalidArgumentException("too many chunks; use a larger chunk size");
+
+	_chunkDigests.clear();
+	_chunkDigests.resize(nChunks);
+
+	ChunkDigester digester(_name, static_cast<const char*>(data), length, _chunkSize, _chunkDigests);
+	digester.run(static_cast<int>(nChunks), &_threadPool);
+
+	DigestEngine engine(_name);
+	for (DigestVec::const_iterator it = _chunkDigests.begin(); it != _chunkDigests.end(); ++it)
+	{
+		engine.update(&(*it)[0], it->size());
+	}
+	_digest = engine.digest();
+	return _digest;
+}
+
+
+} } // namespace Poco::Crypto
@@ -126,6 +126,16 @@ CipherKeyImpl::Mode CipherKeyImpl::mode() const
 
 	case EVP_CIPH_OFB_MODE:
 		return MODE_OFB;
+
+#if defined(EVP_CIPH_CTR_MODE)
+	case EVP_CIPH_CTR_MODE:
+		return MODE_CTR;
+#endif
+
+#if defined(EVP_CIPH_GCM_MODE)
+	case EVP_CIPH_GCM_MODE:
+		return MODE_GCM;
+#endif
 	}
 	throw Poco::IllegalStateException("Unexpected value of EVP_CIPHER_mode()");
 }
@@ -0,0 +1,197 @@
+//
+// CryptoCache.cpp
+//
+// $Id: //poco/1.4/Crypto/src/CryptoCache.cpp#1 $
+//
+// Library: Crypto
+// Package: Certificate
+// Module:  CryptoCache
+//
+// Copyright (c) 2013, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+// 
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+
+#include "Poco/Crypto/CryptoCache.h"
+#include "Poco/SingletonHolder.h"
+#include "Poco/Exception.h"
+#include <sstream>
+#include <openssl/evp.h>
+
+
+namespace Poco {
+namespace Crypto {
+
+
+CryptoCache::CryptoCache(long capacity):
+	_certificates(capacity),
+	_keys(capacity)
+{
+}
+
+
+CryptoCache::~CryptoCache()
+{
+}
+
+
+namespace
+{
+	static Poco::SingletonHolder<CryptoCache> holder;
+}
+
+
+CryptoCache& CryptoCache::defaultCache()
+{
+	return *holder.get();
+}
+
+
+CryptoCache::CertificatePtr CryptoCache::certificate(const std::string& pem)
+{
+	std::string key = digest(TYPE_CERTIFICATE, pem);
+	CertificatePtr pCert = _certificates.get(key);
+	if (pCert)
+	{
+		++_hits;
+	}
+	else
+	{
+		++_misses;
+		std::istringstream istr(pem);
+		pCert = new X509Certificate(istr);
+		_certificates.add(key, pCert);
+	}
+	return pCert;
+}
+
+
+CryptoCache::CertificatePtr CryptoCache::certificate(X509* pCert)
+{
+	poco_check_ptr (pCert);
+
+	std::string key = digest(pCert);
+	CertificatePtr pCachedCert = _certificates.get(key);
+	if (pCachedCert)
+	{
+		++_hits;
+	}
+	else
+	{
+		++_misses;
+		pCachedCert = new X509Certificate(pCert, true);
+		_certificates.add(key, pCachedCert);
+	}
+	return pCachedCert;
+}
+
+
+RSAKey CryptoCache::publicKey(const std::string& pem)
+{
+	std::string key = digest(TYPE_PUBLIC_KEY, pem);
+	Poco::SharedPtr<RSAKey> pKey = _keys.get(key);
+	if (pKey)
+	{
+		++_hits;
+	}
+	else
+	{
+		++_misses;
+		std::istringstream istr(pem);
+		pKey = new RSAKey(&istr);
+		_keys.add(key, pKey);
+	}
+	return *pKey;
+}
+
+
+RSAKey CryptoCache::privateKey(const std::string& pem, const std::string& passphrase)
+{
+	std::string key = digest(TYPE_PRIVATE_KEY, pem, passphrase);
+	Poco::SharedPtr<RSAKey> pKey = _keys.get(key);
+	if (pKey)
+	{
+		++_hits;
+	}
+	else
+	{
+		++_misses;
+		std::istringstream istr(pem);
+		pKey = new RSAKey(0, &istr, passphrase);
+		_keys.add(key, pKey);
+	}
+	return *pKey;
+}
+
+
+void CryptoCache::clear()
+{
+	_certificates.clear();
+	_keys.clear();
+}
+
+
+std::size_t CryptoCache::size()
+{
+	return _certificates.size() + _keys.size();
+}
+
+
+std::string CryptoCache::digest(Type type, const std::string& data, const std::string& passphrase)
+{
+	// The passphrase is part of the digest, so that a private key
+	// loaded once cannot be obtained using a different passphrase.
+	unsigned char md[EVP_MAX_MD_SIZE + 1];
+	unsigned int mdLength = 0;
+	EVP_MD_CTX ctx;
+	EVP_MD_CTX_init(&ctx);
+	EVP_DigestInit_ex(&ctx, EVP_sha256(), NULL);
+	EVP_DigestUpdate(&ctx, data.data(), data.size());
+	if (type == TYPE_PRIVATE_KEY)
+	{
+		EVP_DigestUpdate(&ctx, "", 1);
+		EVP_DigestUpdate(&ctx, passphrase.data(), passphrase.size());
+	}
+	EVP_DigestFinal_ex(&ctx, md + 1, &mdLength);
+	EVP_MD_CTX_cleanup(&ctx);
+	md[0] = static_cast<unsigned char>(type);
+	return std::string(reinterpret_cast<char*>(md), mdLength + 1);
+}
+
+
+std::string CryptoCache::digest(X509* pCert)
+{
+	// X509_digest() re-uses the encoding OpenSSL retains for the signed
+	// part of a parsed certificate, so this is much cheaper than parsing.
+	unsigned char md[EVP_MAX_MD_SIZE + 1];
+	unsigned int mdLength = 0;
+	if (!X509_digest(pCert, EVP_sha256(), md + 1, &mdLength))
+		throw Poco::IOException("Cannot compute certificate digest");
+	md[0] = static_cast<unsigned char>(TYPE_DER_CERTIFICATE);
+	return std::string(reinterpret_cast<char*>(md), mdLength + 1);
+}
+
+
+} } // namespace Poco::Crypto
@@ -43,12 +43,12 @@ namespace Crypto {
 
 
 DigestEngine::DigestEngine(const std::string& name):
-	_name(name)
+	_name(name),
+	_md(EVP_get_digestbyname(name.c_str()))
 {
-	const EVP_MD* md = EVP_get_digestbyname(_name.c_str());
-	if (!md) throw Poco::NotFoundException(_name);
+	if (!_md) throw Poco::NotFoundException(_name);
 	_ctx = EVP_MD_CTX_create();
-	EVP_DigestInit_ex(_ctx, md, NULL);	
+	EVP_DigestInit_ex(_ctx, _md, NULL);	
 }
 
 	
@@ -66,10 +66,8 @@ std::size_t DigestEngine::digestLength() const
 
 void DigestEngine::reset()
 {
-	EVP_MD_CTX_cleanup(_ctx);
-	const EVP_MD* md = EVP_get_digestbyname(_name.c_str());
-	if (!md) throw Poco::NotFoundException(_name);
-	EVP_DigestInit_ex(_ctx, md, NULL);
+	// Re-initializing with the same digest reuses the context's buffers.
+	EVP_DigestInit_ex(_ctx, _md, NULL);
 }
 
 
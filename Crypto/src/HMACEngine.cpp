@@ -0,0 +1,136 @@
+//
+// HMACEngine.cpp
+//
+// $Id: //poco/1.4/Crypto/src/HMACEngine.cpp#1 $
+//
+// Library: Crypto
+// Package: Digest
+// Module:  HMACEngine
+//
+// Copyright (c) 2013, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+// 
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+
+#include "Poco/Crypto/HMACEngine.h"
+#include "Poco/Exception.h"
+
+
+namespace Poco {
+namespace Crypto {
+
+
+HMACEngine::HMACEngine(const std::string& name, const std::string& key):
+	_name(name),
+	_md(0),
+	_pContext(0)
+{
+	init(key.data(), key.size());
+}
+
+
+HMACEngine::HMACEngine(const std::string& name, const void* key, std::size_t length):
+	_name(name),
+	_md(0),
+	_pContext(0)
+{
+	init(key, length);
+}
+
+
+HMACEngine::HMACEngine(const HMACEngine& engine):
+	_name(engine._name),
+	_md(engine._md),
+	_pContext(new HMAC_CTX)
+{
+	HMAC_CTX_init(_pContext);
+	if (!HMAC_CTX_copy(_pContext, engine._pContext))
+	{
+		HMAC_CTX_cleanup(_pContext);
+		delete _pContext;
+		throw Poco::IOException("Cannot copy HMAC context");
+	}
+}
+
+
+HMACEngine::~HMACEngine()
+{
+	HMAC_CTX_cleanup(_pContext);
+	delete _pContext;
+}
+
+
+void HMACEngine::init(const void* key, std::size_t length)
+{
+	_md = EVP_get_digestbyname(_name.c_str());
+	if (!_md) throw Poco::NotFoundException(_name);
+	_pContext = new HMAC_CTX;
+	HMAC_CTX_init(_pContext);
+	if (!HMAC_Init_ex(_pContext, key, static_cast<int>(length), _md, NULL))
+	{
+		HMAC_CTX_cleanup(_pContext);
+		delete _pContext;
+		throw Poco::IOException("Cannot initialize HMAC context", _name);
+	}
+}
+
+
+HMACEngine* HMACEngine::clone() const
+{
+	return new HMACEngine(*this);
+}
+
+
+std::size_t HMACEngine::digestLength() const
+{
+	return EVP_MD_size(_md);
+}
+
+
+void HMACEngine::reset()
+{
+	// Without a key and digest, HMAC_Init_ex() just restores the
+	// inner hash state computed from the key by the constructor.
+	HMAC_Init_ex(_pContext, NULL, 0, NULL, NULL);
+}
+
+
+const Poco::DigestEngine::Digest& HMACEngine::digest()
+{
+	unsigned len = EVP_MD_size(_md);
+	_digest.resize(len);
+	HMAC_Final(_pContext, &_digest[0], &len);
+	reset();
+	return _digest;
+}
+
+
+void HMACEngine::updateImpl(const void* data, std::size_t length)
+{
+	HMAC_Update(_pContext, static_cast<const unsigned char*>(data), length);
+}
+
+
+} } // namespace Poco::Crypto
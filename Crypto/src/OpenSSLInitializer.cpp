@@ -54,7 +54,7 @@ namespace Poco {
 namespace Crypto {
 
 
-Poco::FastMutex* OpenSSLInitializer::_mutexes(0);
+OpenSSLInitializer::Lock* OpenSSLInitializer::_locks(0);
 Poco::FastMutex OpenSSLInitializer::_mutex;
 int OpenSSLInitializer::_rc(0);
 
@@ -89,15 +89,21 @@ void OpenSSLInitializer::initialize()
 		rnd.read(seed, sizeof(seed));
 		RAND_seed(seed, SEEDSIZE);
 		
-		int nMutexes = CRYPTO_num_locks();
-		_mutexes = new Poco::FastMutex[nMutexes];
+#if OPENSSL_VERSION_NUMBER < 0x10100000L
+		int nLocks = CRYPTO_num_locks();
+		_locks = new Lock[nLocks];
 		CRYPTO_set_locking_callback(&OpenSSLInitializer::lock);
 #ifndef POCO_OS_FAMILY_WINDOWS // SF# 1828231: random unhandled exceptions when linking with ssl
+#if OPENSSL_VERSION_NUMBER >= 0x10000000L
+		CRYPTO_THREADID_set_callback(&OpenSSLInitializer::threadId);
+#else
 		CRYPTO_set_id_callback(&OpenSSLInitializer::id);
+#endif
 #endif
 		CRYPTO_set_dynlock_create_callback(&OpenSSLInitializer::dynlockCreate);
 		CRYPTO_set_dynlock_lock_callback(&OpenSSLInitializer::dynlock);
 		CRYPTO_set_dynlock_destroy_callback(&OpenSSLInitializer::dynlockDestroy);
+#endif
 	}
 }
 
@@ -110,8 +116,11 @@ void OpenSSLInitializer::uninitialize()
 	{
 		EVP_cleanup();
 		ERR_free_strings();
+#if OPENSSL_VERSION_NUMBER < 0x10100000L
 		CRYPTO_set_locking_callback(0);
-		delete [] _mutexes;
+		delete [] _locks;
+		_locks = 0;
+#endif
 	}
 }
 
@@ -119,9 +128,13 @@ void OpenSSLInitializer::uninitialize()
 void OpenSSLInitializer::lock(int mode, int n, const char* file, int line)
 {
 	if (mode & CRYPTO_LOCK)
-		_mutexes[n].lock();
-	else
-		_mutexes[n].unlock();
+	{
+		if (mode & CRYPTO_READ)
+			_locks[n].rwl.readLock();
+		else
+			_locks[n].rwl.writeLock();
+	}
+	else _locks[n].rwl.unlock();
 }
 
 
@@ -134,6 +147,18 @@ unsigned long OpenSSLInitializer::id()
 }
 
 
+#if OPENSSL_VERSION_NUMBER >= 0x10000000L && OPENSSL_VERSION_NUMBER < 0x10100000L
+
+
+void OpenSSLInitializer::threadId(CRYPTO_THREADID* id)
+{
+	CRYPTO_THREADID_set_numeric(id, OpenSSLInitializer::id());
+}
+
+
+#endif
+
+
 struct CRYPTO_dynlock_value* OpenSSLInitializer::dynlockCreate(const char* file, int line)
 {
 	return new CRYPTO_dynlock_value;
@@ -145,9 +170,13 @@ void OpenSSLInitializer::dynlock(int mode, struct CRYPTO_dynlock_value* lock, co
 	poco_check_ptr (lock);
 
 	if (mode & CRYPTO_LOCK)
-		lock->_mutex.lock();
-	else
-		lock->_mutex.unlock();
+	{
+		if (mode & CRYPTO_READ)
+			lock->_lock.readLock();
+		else
+			lock->_lock.writeLock();
+	}
+	else lock->_lock.unlock();
 }
 
 
@@ -0,0 +1,177 @@
+//
+// ParallelFor.cpp
+//
+// $Id: //poco/1.4/Crypto/src/ParallelFor.cpp#1 $
+//
+// Library: Crypto
+// Package: CryptoCore
+// Module:  ParallelFor
+//
+// Copyright (c) 2013, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+// 
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+
+#include "Poco/Crypto/ParallelFor.h"
+#include "Poco/Runnable.h"
+#include "Poco/AtomicCounter.h"
+#include "Poco/Event.h"
+#include "Poco/Exception.h"
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+
+namespace Poco {
+namespace Crypto {
+
+
+namespace
+{
+	class Runner: public Poco::Runnable
+		/// Runs a worker until all items are done.
+	{
+	public:
+		Runner(ParallelFor::Worker* pWorker, int count, Poco::AtomicCounter& next):
+			_pWorker(pWorker),
+			_count(count),
+			_next(next),
+			_pException(0)
+		{
+		}
+
+		~Runner()
+		{
+			delete _pException;
+		}
+
+		void run()
+		{
+			try
+			{
+				int index;
+				while ((index = _next++) < _count)
+				{
+					_pWorker->process(index);
+				}
+			}
+			catch (Poco::Exception& exc)
+			{
+				_pException = exc.clone();
+			}
+			catch (std::exception& exc)
+			{
+				_pException = new Poco::SystemException(exc.what());
+			}
+			catch (...)
+			{
+				_pException = new Poco::SystemException("unknown exception");
+			}
+			_done.set();
+		}
+
+		void wait()
+		{
+			_done.wait();
+		}
+
+		const Poco::Exception* exception() const
+		{
+			return _pException;
+		}
+
+	private:
+		std::auto_ptr<ParallelFor::Worker> _pWorker;
+		int _count;
+		Poco::AtomicCounter& _next;
+		Poco::Exception* _pException;
+		Poco::Event _done;
+	};
+}
+
+
+ParallelFor::Worker::~Worker()
+{
+}
+
+
+ParallelFor::ParallelFor()
+{
+}
+
+
+ParallelFor::~ParallelFor()
+{
+}
+
+
+void ParallelFor::run(int count, Poco::ThreadPool* pPool)
+{
+	if (count <= 0) return;
+
+	Poco::AtomicCounter next;
+	std::vector<Runner*> runners;
+	std::auto_ptr<Poco::Exception> pException;
+	try
+	{
+		int nThreads = pPool ? std::min(count - 1, pPool->available()) : 0;
+		for (int i = 0; i < nThreads; ++i)
+		{
+			std::auto_ptr<Runner> pRunner(new Runner(createWorker(true), count, next));
+			try
+			{
+				pPool->start(*pRunner);
+			}
+			catch (Poco::NoThreadAvailableException&)
+			{
+				break;
+			}
+			runners.push_back(pRunner.release());
+		}
+		Runner runner(createWorker(false), count, next);
+		runner.run();
+		if (runner.exception()) pException.reset(runner.exception()->clone());
+	}
+	catch (Poco::Exception& exc)
+	{
+		// threads that have already been started must
+		// finish before the shared counter goes away
+		pException.reset(exc.clone());
+	}
+	catch (std::exception& exc)
+	{
+		pException.reset(new Poco::SystemException(exc.what()));
+	}
+	for (std::vector<Runner*>::iterator it = runners.begin(); it != runners.end(); ++it)
+	{
+		(*it)->wait();
+		if (!pException.get() && (*it)->exception()) pException.reset((*it)->exception()->clone());
+		delete *it;
+	}
+	if (pException.get()) pException->rethrow();
+}
+
+
+} } // namespace Poco::Crypto
@@ -40,6 +40,7 @@
 #include <openssl/err.h>
 #include <openssl/rsa.h>
 #include <cstring>
+#include <algorithm>
 
 
 namespace Poco {
@@ -83,6 +84,25 @@ namespace
 	}
 
 
+	std::size_t maxDataSize(const RSA* pRSA, RSAPaddingMode paddingMode)
+	{
+		std::size_t size = RSA_size(pRSA);
+		switch (paddingMode)
+		{
+		case RSA_PADDING_PKCS1:
+		case RSA_PADDING_SSLV23:
+			size -= 11;
+			break;
+		case RSA_PADDING_PKCS1_OAEP:
+			size -= 41;
+			break;
+		default:
+			break;
+		}
+		return size;
+	}
+
+
 	class RSAEncryptImpl: public CryptoTransform
 	{
 	public:
@@ -132,20 +152,7 @@ namespace
 
 	std::size_t RSAEncryptImpl::maxDataSize() const
 	{
-		std::size_t size = blockSize();
-		switch (_paddingMode)
-		{
-		case RSA_PADDING_PKCS1:
-		case RSA_PADDING_SSLV23:
-			size -= 11;
-			break;
-		case RSA_PADDING_PKCS1_OAEP:
-			size -= 41;
-			break;
-		default:
-			break;
-		}
-		return size;
+		return Poco::Crypto::maxDataSize(_pRSA, _paddingMode);
 	}
 
 
@@ -337,4 +344,56 @@ CryptoTransform* RSACipherImpl::createDecryptor()
 }
 
 
+std::string RSACipherImpl::encryptString(const std::string& str, Encoding encoding)
+{
+	if (encoding != ENC_NONE) return Cipher::encryptString(str, encoding);
+
+	// Encrypt directly into the result, block by block, instead of
+	// going through a newly created transform and a stream.
+	RSA* pRSA = _key.impl()->getRSA();
+	std::size_t rsaSize = RSA_size(pRSA);
+	std::size_t maxSize = maxDataSize(pRSA, _paddingMode);
+	std::size_t nBlocks = (str.size() + maxSize - 1)/maxSize;
+	std::string result(nBlocks*rsaSize, '\0');
+	std::size_t outLength = 0;
+	for (std::size_t pos = 0; pos < str.size(); pos += maxSize)
+	{
+		int n = RSA_public_encrypt(
+			static_cast<int>(std::min(maxSize, str.size() - pos)),
+			reinterpret_cast<const unsigned char*>(str.data() + pos),
+			reinterpret_cast<unsigned char*>(&result[outLength]),
+			pRSA,
+			mapPaddingMode(_paddingMode));
+		if (n == -1) throwError();
+		outLength += n;
+	}
+	result.resize(outLength);
+	return result;
+}
+
+
+std::string RSACipherImpl::decryptString(const std::string& str, Encoding encoding)
+{
+	if (encoding != ENC_NONE) return Cipher::decryptString(str, encoding);
+
+	RSA* pRSA = _key.impl()->getRSA();
+	std::size_t rsaSize = RSA_size(pRSA);
+	std::string result(((str.size() + rsaSize - 1)/rsaSize)*rsaSize, '\0');
+	std::size_t outLength = 0;
+	for (std::size_t pos = 0; pos < str.size(); pos += rsaSize)
+	{
+		int n = RSA_private_decrypt(
+			static_cast<int>(std::min(rsaSize, str.size() - pos)),
+			reinterpret_cast<const unsigned char*>(str.data() + pos),
+			reinterpret_cast<unsigned char*>(&result[outLength]),
+			pRSA,
+			mapPaddingMode(_paddingMode));
+		if (n == -1) throwError();
+		outLength += n;
+	}
+	result.resize(outLength);
+	return result;
+}
+
+
 } } // namespace Poco::Crypto
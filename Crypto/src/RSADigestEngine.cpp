@@ -35,13 +35,130 @@
 
 
 #include "Poco/Crypto/RSADigestEngine.h"
+#include "Poco/Crypto/ParallelFor.h"
+#include "Poco/Exception.h"
 #include <openssl/pem.h>
+#include <openssl/err.h>
+#include <algorithm>
 
 
 namespace Poco {
 namespace Crypto {
 
 
+namespace
+{
+	void throwError()
+	{
+		unsigned long err;
+		std::string msg;
+		
+		while ((err = ERR_get_error()))
+		{
+			if (!msg.empty())
+				msg.append("; ");
+			msg.append(ERR_error_string(err, 0));
+		}
+
+		throw Poco::IOException(msg);
+	}
+
+
+	class DigestWorker: public ParallelFor::Worker
+		/// Signs or verifies digests.
+	{
+	public:
+		DigestWorker(RSA* pRSA, bool ownRSA, bool sign, int type, const RSADigestEngine::DigestVec& digests, RSADigestEngine::DigestVec& signatures, std::vector<char>& results):
+			_pRSA(pRSA),
+			_ownRSA(ownRSA),
+			_sign(sign),
+			_type(type),
+			_digests(digests),
+			_signatures(signatures),
+			_results(results)
+		{
+		}
+
+		~DigestWorker()
+		{
+			if (_ownRSA) RSA_free(_pRSA);
+		}
+
+		void process(int i)
+		{
+			if (_sign)
+				sign(_digests[i], _signatures[i]);
+			else
+				_results[i] = verify(_digests[i], _signatures[i]);
+		}
+
+	private:
+		void sign(const Poco::DigestEngine::Digest& digest, Poco::DigestEngine::Digest& signature)
+		{
+			if (digest.empty()) throw Poco::InvalidArgumentException("empty digest");
+
+			signature.resize(RSA_size(_pRSA));
+			unsigned sigLen = static_cast<unsigned>(signature.size());
+			if (!RSA_sign(_type, &digest[0], static_cast<unsigned>(digest.size()), &signature[0], &sigLen, _pRSA))
+				throwError();
+			signature.resize(sigLen);
+		}
+
+		bool verify(const Poco::DigestEngine::Digest& digest, const Poco::DigestEngine::Digest& signature)
+		{
+			if (digest.empty() || signature.empty()) return false;
+
+			return RSA_verify(_type, &digest[0], static_cast<unsigned>(digest.size()), &signature[0], static_cast<unsigned>(signature.size()), _pRSA) == 1;
+		}
+
+		RSA* _pRSA;
+		bool _ownRSA;
+		bool _sign;
+		int _type;
+		const RSADigestEngine::DigestVec& _digests;
+		RSADigestEngine::DigestVec& _signatures;
+		std::vector<char>& _results;
+	};
+
+
+	class DigestProcessor: public ParallelFor
+		/// Signs or verifies all digests.
+	{
+	public:
+		DigestProcessor(RSA* pRSA, bool sign, int type, const RSADigestEngine::DigestVec& digests, RSADigestEngine::DigestVec& signatures, std::vector<char>& results):
+			_pRSA(pRSA),
+			_sign(sign),
+			_type(type),
+			_digests(digests),
+			_signatures(signatures),
+			_results(results)
+		{
+		}
+
+	protected:
+		Worker* createWorker(bool pooled)
+		{
+			if (!pooled) return new DigestWorker(_pRSA, false, _sign, _type, _digests, _signatures, _results);
+
+			// The RSA structure caches its blinding and Montgomery contexts.
+			// Sharing them between threads requires locking, so every
+			// pool thread gets a copy of the key.
+			RSA* pCopy = _sign ? RSAPrivateKey_dup(_pRSA) : RSAPublicKey_dup(_pRSA);
+			if (!pCopy) throwError();
+			return new DigestWorker(pCopy, true, _sign, _type, _digests, _signatures, _results);
+		}
+
+	private:
+		RSA* _pRSA;
+		bool _sign;
+		int _type;
+		const RSADigestEngine::DigestVec& _digests;
+		RSADigestEngine::DigestVec& _signatures;
+		std::vector<char>& _results;
+	};
+}
+
+
 RSADigestEngine::RSADigestEngine(const RSAKey& key, DigestType digestType):
 	_key(key),
 	_engine(digestType == DIGEST_MD5 ? static_cast<Poco::DigestEngine&>(_md5Engine) : static_cast<Poco::DigestEngine&>(_sha1Engine)),
@@ -104,6 +221,61 @@ bool RSADigestEngine::verify(const DigestEngine::Digest& sig)
 }
 
 
+void RSADigestEngine::signDigests(const DigestVec& digests, DigestVec& signatures)
+{
+	std::vector<char> results;
+	processDigests(true, digests, signatures, results, 0);
+}
+
+
+void RSADigestEngine::signDigests(const DigestVec& digests, DigestVec& signatures, Poco::ThreadPool& pool)
+{
+	std::vector<char> results;
+	processDigests(true, digests, signatures, results, &pool);
+}
+
+
+bool RSADigestEngine::verifyDigests(const DigestVec& digests, const DigestVec& signatures, std::vector<bool>& results)
+{
+	std::vector<char> verified;
+	processDigests(false, digests, const_cast<DigestVec&>(signatures), verified, 0);
+	results.assign(verified.begin(), verified.end());
+	return std::find(verified.begin(), verified.end(), 0) == verified.end();
+}
+
+
+bool RSADigestEngine::verifyDigests(const DigestVec& digests, const DigestVec& signatures, std::vector<bool>& results, Poco::ThreadPool& pool)
+{
+	std::vector<char> verified;
+	processDigests(false, digests, const_cast<DigestVec&>(signatures), verified, &pool);
+	results.assign(verified.begin(), verified.end());
+	return std::find(verified.begin(), verified.end(), 0) == verified.end();
+}
+
+
+void RSADigestEngine::processDigests(bool sign, const DigestVec& digests, DigestVec& signatures, std::vector<char>& results, Poco::ThreadPool* pPool)
+{
+	// Signatures are only written when signing. When verifying, 
+	// results are written into a std::vector<char>, as the elements
+	// of a std::vector<bool> cannot be safely written by different threads.
+	if (sign)
+	{
+		signatures.clear();
+		signatures.resize(digests.size());
+	}
+	else
+	{
+		if (signatures.size() != digests.size())
+			throw Poco::InvalidArgumentException("number of signatures does not match number of digests");
+		results.assign(digests.size(), 0);
+	}
+	if (digests.empty()) return;
+
+	DigestProcessor processor(_key.impl()->getRSA(), sign, _type, digests, signatures, results);
+	processor.run(static_cast<int>(digests.size()), pPool);
+}
+
+
 void RSADigestEngine::updateImpl(const void* data, std::size_t length)
 {
 	_engine.update(data, length);
@@ -50,6 +50,7 @@ namespace Crypto {
 
 
 X509Certificate::X509Certificate(std::istream& istr):
+	_namesExtracted(false),
 	_pCert(0)
 {	
 	load(istr);
@@ -57,6 +58,7 @@ X509Certificate::X509Certificate(std::istream& istr):
 
 
 X509Certificate::X509Certificate(const std::string& path):
+	_namesExtracted(false),
 	_pCert(0)
 {
 	load(path);
@@ -64,34 +66,39 @@ X509Certificate::X509Certificate(const std::string& path):
 
 
 X509Certificate::X509Certificate(X509* pCert):
+	_namesExtracted(false),
 	_pCert(pCert)
 {
 	poco_check_ptr(_pCert);
-
-	init();
 }
 
 
 X509Certificate::X509Certificate(X509* pCert, bool shared):
+	_namesExtracted(false),
 	_pCert(pCert)
 {
 	poco_check_ptr(_pCert);
 	
 	if (shared)
 	{
-		_pCert->references++;
+		CRYPTO_add(&_pCert->references, 1, CRYPTO_LOCK_X509);
 	}
-
-	init();
 }
 
 
 X509Certificate::X509Certificate(const X509Certificate& cert):
-	_issuerName(cert._issuerName),
-	_subjectName(cert._subjectName),
+	_namesExtracted(false),
 	_pCert(cert._pCert)
 {
-	_pCert = X509_dup(_pCert);
+	CRYPTO_add(&_pCert->references, 1, CRYPTO_LOCK_X509);
+
+	Poco::FastMutex::ScopedLock lock(cert._mutex);
+	if (cert._namesExtracted)
+	{
+		_issuerName     = cert._issuerName;
+		_subjectName    = cert._subjectName;
+		_namesExtracted = true;
+	}
 }
 
 
@@ -108,6 +115,7 @@ void X509Certificate::swap(X509Certificate& cert)
 	using std::swap;
 	swap(cert._issuerName, _issuerName);
 	swap(cert._subjectName, _subjectName);
+	swap(cert._namesExtracted, _namesExtracted);
 	swap(cert._pCert, _pCert);
 }
 
@@ -132,8 +140,6 @@ void X509Certificate::load(std::istream& istr)
 	BIO_free(pBIO);
 	
 	if (!_pCert) throw Poco::IOException("Faild to load certificate from stream");
-
-	init();
 }
 
 
@@ -153,8 +159,6 @@ void X509Certificate::load(const std::string& path)
 	BIO_free(pBIO);
 	
 	if (!_pCert) throw Poco::ReadFileException("Faild to load certificate from", path);
-
-	init();
 }
 
 
@@ -204,13 +208,33 @@ void X509Certificate::save(const std::string& path) const
 }
 
 
-void X509Certificate::init()
+void X509Certificate::init() const
 {
-	char buffer[NAME_BUFFER_SIZE];
-	X509_NAME_oneline(X509_get_issuer_name(_pCert), buffer, sizeof(buffer));
-	_issuerName = buffer;
-	X509_NAME_oneline(X509_get_subject_name(_pCert), buffer, sizeof(buffer));
-	_subjectName = buffer;
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	if (!_namesExtracted)
+	{
+		char buffer[NAME_BUFFER_SIZE];
+		X509_NAME_oneline(X509_get_issuer_name(_pCert), buffer, sizeof(buffer));
+		_issuerName = buffer;
+		X509_NAME_oneline(X509_get_subject_name(_pCert), buffer, sizeof(buffer));
+		_subjectName = buffer;
+		_namesExtracted = true;
+	}
+}
+
+
+const std::string& X509Certificate::issuerName() const
+{
+	init();
+	return _issuerName;
+}
+
+
+const std::string& X509Certificate::subjectName() const
+{
+	init();
+	return _subjectName;
 }
 
 
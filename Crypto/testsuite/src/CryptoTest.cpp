@@ -38,8 +38,14 @@
 #include "Poco/Crypto/CipherKey.h"
 #include "Poco/Crypto/X509Certificate.h"
 #include "Poco/Crypto/CryptoStream.h"
+#include "Poco/Crypto/CryptoTransform.h"
+#include "Poco/Crypto/BatchCipher.h"
 #include "Poco/StreamCopier.h"
+#include "Poco/Runnable.h"
+#include "Poco/Thread.h"
+#include "Poco/ThreadPool.h"
 #include <sstream>
+#include <cstring>
 
 
 using namespace Poco::Crypto;
@@ -74,6 +80,48 @@ static const std::string APPINF_PEM(
 );
 
 
+namespace
+{
+	class CipherRunnable: public Poco::Runnable
+	{
+	public:
+		CipherRunnable(): _ok(true)
+		{
+		}
+		
+		void run()
+		{
+			try
+			{
+				for (int i = 0; i < 50; ++i)
+				{
+					Cipher::Ptr pCipher = CipherFactory::defaultFactory().createCipher(CipherKey("aes256"));
+					std::string in(1000 + i, 'x');
+					std::string out = pCipher->encryptString(in, Cipher::ENC_BASE64);
+					if (pCipher->decryptString(out, Cipher::ENC_BASE64) != in) _ok = false;
+					
+					std::istringstream certStream(APPINF_PEM);
+					X509Certificate cert(certStream);
+					if (cert.commonName() != "appinf.com") _ok = false;
+				}
+			}
+			catch (...)
+			{
+				_ok = false;
+			}
+		}
+		
+		bool ok() const
+		{
+			return _ok;
+		}
+		
+	private:
+		bool _ok;
+	};
+}
+
+
 CryptoTest::CryptoTest(const std::string& name): CppUnit::TestCase(name)
 {
 }
@@ -232,6 +280,201 @@ void CryptoTest::testCertificate()
 }
 
 
+void CryptoTest::testConcurrency()
+{
+	const int N_THREADS = 8;
+	CipherRunnable runnables[N_THREADS];
+	Poco::Thread threads[N_THREADS];
+	for (int i = 0; i < N_THREADS; ++i)
+	{
+		threads[i].start(runnables[i]);
+	}
+	for (int i = 0; i < N_THREADS; ++i)
+	{
+		threads[i].join();
+		assert (runnables[i].ok());
+	}
+}
+
+
+void CryptoTest::testBatchCipherCTR()
+{
+	CipherKey key("aes-256-ctr");
+	std::string plain;
+	for (int i = 0; i < 100000; ++i)
+	{
+		plain += static_cast<char>(i % 256);
+	}
+	Cipher::Ptr pCipher = CipherFactory::defaultFactory().createCipher(key);
+	std::string expected = pCipher->encryptString(plain, Cipher::ENC_NONE);
+	assert (expected.size() == plain.size());
+
+	BatchCipher serial(key, 4096);
+	assert (!serial.parallel());
+	std::vector<unsigned char> data(plain.begin(), plain.end());
+	serial.encrypt(&data[0], data.size());
+	assert (std::string(data.begin(), data.end()) == expected);
+	serial.decrypt(&data[0], data.size());
+	assert (std::string(data.begin(), data.end()) == plain);
+
+	// the segments run through the counter, so the result must
+	// not depend on the segment size or the number of threads
+	Poco::ThreadPool pool(2, 4);
+	BatchCipher parallel(key, pool, 1024);
+	assert (parallel.parallel());
+	parallel.encrypt(&data[0], data.size());
+	assert (std::string(data.begin(), data.end()) == expected);
+	parallel.decrypt(&data[0], data.size());
+	assert (std::string(data.begin(), data.end()) == plain);
+
+	// counter carries into the upper bytes of the IV
+	std::vector<unsigned char> iv(16, 0xFF);
+	CipherKey carryKey("aes-128-ctr", std::vector<unsigned char>(16, 0x42), iv);
+	Cipher::Ptr pCarryCipher = CipherFactory::defaultFactory().createCipher(carryKey);
+	expected = pCarryCipher->encryptString(plain, Cipher::ENC_NONE);
+	BatchCipher carry(carryKey, pool, 1024);
+	carry.encrypt(&data[0], data.size());
+	assert (std::string(data.begin(), data.end()) == expected);
+
+	try
+	{
+		std::vector<unsigned char> tags;
+		serial.encrypt(&data[0], data.size(), 1, tags);
+		fail("CTR has no authentication tags - must throw");
+	}
+	catch (Poco::InvalidAccessException&)
+	{
+	}
+
+	try
+	{
+		BatchCipher invalid(key, 1000);
+		fail("segment size not a multiple of 16 - must throw");
+	}
+	catch (Poco::InvalidArgumentException&)
+	{
+	}
+}
+
+
+void CryptoTest::testBatchCipherGCM()
+{
+	CipherKey key("aes-256-gcm");
+	assert (key.mode() == CipherKeyImpl::MODE_GCM);
+	std::string plain(50000, 'x');
+	std::vector<unsigned char> data(plain.begin(), plain.end());
+
+	Poco::ThreadPool pool(2, 4);
+	BatchCipher parallel(key, pool, 8192);
+	std::vector<unsigned char> tags;
+	parallel.encrypt(&data[0], data.size(), 1, tags);
+	assert (tags.size() == 7*BatchCipher::TAG_SIZE);
+	assert (std::string(data.begin(), data.end()) != plain);
+	std::vector<unsigned char> encrypted(data);
+
+	BatchCipher serial(key, 8192);
+	std::vector<unsigned char> serialTags;
+	std::vector<unsigned char> serialData(plain.begin(), plain.end());
+	serial.encrypt(&serialData[0], serialData.size(), 1, serialTags);
+	assert (serialData == encrypted);
+	assert (serialTags == tags);
+
+	serial.decrypt(&data[0], data.size(), 1, tags);
+	assert (std::string(data.begin(), data.end()) == plain);
+
+	// every message number yields different nonces for all segments
+	serialData.assign(plain.begin(), plain.end());
+	serial.encrypt(&serialData[0], serialData.size(), 2, serialTags);
+	for (std::size_t i = 0; i < serialData.size(); i += 8192)
+	{
+		assert (std::memcmp(&serialData[i], &encrypted[i], 16) != 0);
+	}
+	data = encrypted;
+	try
+	{
+		serial.decrypt(&data[0], data.size(), 2, tags);
+		fail("wrong message number - must throw");
+	}
+	catch (Poco::DataException&)
+	{
+	}
+
+	data = encrypted;
+	data[20000] ^= 1;
+	try
+	{
+		parallel.decrypt(&data[0], data.size(), 1, tags);
+		fail("tampered data - must throw");
+	}
+	catch (Poco::DataException&)
+	{
+	}
+
+	// truncating the data changes the length bound into every segment
+	data = encrypted;
+	tags.resize(6*BatchCipher::TAG_SIZE);
+	try
+	{
+		parallel.decrypt(&data[0], 6*8192, 1, tags);
+		fail("truncated data - must throw");
+	}
+	catch (Poco::DataException&)
+	{
+	}
+
+	std::vector<unsigned char> emptyTags;
+	unsigned char dummy = 0;
+	parallel.encrypt(&dummy, 0, 3, emptyTags);
+	assert (emptyTags.size() == BatchCipher::TAG_SIZE);
+	parallel.decrypt(&dummy, 0, 3, emptyTags);
+
+	try
+	{
+		parallel.encrypt(&data[0], data.size());
+		fail("GCM requires tags - must throw");
+	}
+	catch (Poco::InvalidAccessException&)
+	{
+	}
+}
+
+
+void CryptoTest::testBatchCipherCBC()
+{
+	CipherKey key("aes256");
+	std::string plain(4096, 'y');
+	std::vector<unsigned char> data(plain.begin(), plain.end());
+
+	Poco::ThreadPool pool(2, 4);
+	BatchCipher cipher(key, pool, 1024);
+	assert (!cipher.parallel());
+	cipher.encrypt(&data[0], data.size());
+
+	// without padding, the stream path produces the same cipher text
+	Cipher::Ptr pCipher = CipherFactory::defaultFactory().createCipher(key);
+	CryptoTransform* pEncryptor = pCipher->createEncryptor();
+	pEncryptor->setPadding(0);
+	std::vector<unsigned char> expected(plain.size() + 32);
+	std::streamsize n = pEncryptor->transform(reinterpret_cast<const unsigned char*>(plain.data()), plain.size(), &expected[0], expected.size());
+	n += pEncryptor->finalize(&expected[n], expected.size() - n);
+	delete pEncryptor;
+	expected.resize(n);
+	assert (data == expected);
+
+	cipher.decrypt(&data[0], data.size());
+	assert (std::string(data.begin(), data.end()) == plain);
+
+	try
+	{
+		cipher.encrypt(&data[0], 100);
+		fail("not a multiple of the block size - must throw");
+	}
+	catch (Poco::InvalidArgumentException&)
+	{
+	}
+}
+
+
 void CryptoTest::setUp()
 {
 }
@@ -251,6 +494,10 @@ CppUnit::Test* CryptoTest::suite()
 	CppUnit_addTest(pSuite, CryptoTest, testEncryptDecryptDESECB);
 	CppUnit_addTest(pSuite, CryptoTest, testStreams);
 	CppUnit_addTest(pSuite, CryptoTest, testCertificate);
+	CppUnit_addTest(pSuite, CryptoTest, testConcurrency);
+	CppUnit_addTest(pSuite, CryptoTest, testBatchCipherCTR);
+	CppUnit_addTest(pSuite, CryptoTest, testBatchCipherGCM);
+	CppUnit_addTest(pSuite, CryptoTest, testBatchCipherCBC);
 
 	return pSuite;
 }
@@ -56,6 +56,10 @@ public:
 	void testEncryptDecryptDESECB();
 	void testStreams();
 	void testCertificate();
+	void testConcurrency();
+	void testBatchCipherCTR();
+	void testBatchCipherGCM();
+	void testBatchCipherCBC();
 	
 	void setUp();
 	void tearDown();
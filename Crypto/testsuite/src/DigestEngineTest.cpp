@@ -34,9 +34,17 @@
 #include "CppUnit/TestCaller.h"
 #include "CppUnit/TestSuite.h"
 #include "Poco/Crypto/DigestEngine.h"
+#include "Poco/Crypto/HMACEngine.h"
+#include "Poco/Crypto/ChunkedDigest.h"
+#include "Poco/TemporaryFile.h"
+#include "Poco/FileStream.h"
+#include "Poco/ThreadPool.h"
+#include <memory>
 
 
 using Poco::Crypto::DigestEngine;
+using Poco::Crypto::HMACEngine;
+using Poco::Crypto::ChunkedDigest;
 
 
 DigestEngineTest::DigestEngineTest(const std::string& name): CppUnit::TestCase(name)
@@ -79,6 +87,133 @@ void DigestEngineTest::testMD5()
 }
 
 
+void DigestEngineTest::testHMAC()
+{
+	// test vectors from RFC 4231
+
+	HMACEngine engine256("SHA256", std::string(20, '\x0b'));
+	assert (engine256.digestLength() == 32);
+	engine256.update("Hi There");
+	assert (DigestEngine::digestToHex(engine256.digest()) == "b0344c61d8db38535ca8afceaf0bf12b881dc200c9833da726e9376c2e32cff7");
+	engine256.update("Hi ");
+	engine256.update("There");
+	assert (DigestEngine::digestToHex(engine256.digest()) == "b0344c61d8db38535ca8afceaf0bf12b881dc200c9833da726e9376c2e32cff7");
+
+	HMACEngine engine512("SHA512", "Jefe");
+	assert (engine512.digestLength() == 64);
+	engine512.update("what do ya want for nothing?");
+	assert (DigestEngine::digestToHex(engine512.digest()) == "164b7a7bfcf819e2e395fbe73b56e0a387bd64222e831fd610270cd7ea2505549758bf75c05a994a6d034f65f8f0e6fdcaeab1a34d4a6b4b636e070a38bce737");
+
+	engine512.update("garbage");
+	engine512.reset();
+	engine512.update("what do ya want for nothing?");
+	assert (DigestEngine::digestToHex(engine512.digest()) == "164b7a7bfcf819e2e395fbe73b56e0a387bd64222e831fd610270cd7ea2505549758bf75c05a994a6d034f65f8f0e6fdcaeab1a34d4a6b4b636e070a38bce737");
+
+	try
+	{
+		HMACEngine engine("NO-SUCH-DIGEST", "key");
+		fail("unknown digest - must throw");
+	}
+	catch (Poco::NotFoundException&)
+	{
+	}
+}
+
+
+void DigestEngineTest::testHMACClone()
+{
+	HMACEngine engine("SHA256", "Jefe");
+	engine.update("what do ya ");
+	std::auto_ptr<HMACEngine> pClone(engine.clone());
+	assert (pClone->algorithm() == "SHA256");
+	engine.update("want for nothing?");
+	pClone->update("want for nothing?");
+	assert (DigestEngine::digestToHex(engine.digest()) == "5bdcc146bf60754e6a042426089575c75a003f089d2739839dec58b964ec3843");
+	assert (DigestEngine::digestToHex(pClone->digest()) == "5bdcc146bf60754e6a042426089575c75a003f089d2739839dec58b964ec3843");
+
+	// a clone of a freshly keyed engine keeps the key after reset
+	std::auto_ptr<HMACEngine> pKeyed(engine.clone());
+	pKeyed->update("what do ya want for nothing?");
+	assert (DigestEngine::digestToHex(pKeyed->digest()) == "5bdcc146bf60754e6a042426089575c75a003f089d2739839dec58b964ec3843");
+	pKeyed->update("what do ya want for nothing?");
+	assert (DigestEngine::digestToHex(pKeyed->digest()) == "5bdcc146bf60754e6a042426089575c75a003f089d2739839dec58b964ec3843");
+}
+
+
+void DigestEngineTest::testChunkedDigest()
+{
+	std::string data;
+	for (int i = 0; i < 10123; ++i)
+	{
+		data += static_cast<char>(i % 251);
+	}
+
+	Poco::ThreadPool pool(2, 4);
+	ChunkedDigest chunked("SHA256", 1000, pool);
+	assert (chunked.algorithm() == "SHA256");
+	assert (chunked.chunkSize() == 1000);
+	const ChunkedDigest::Digest& result = chunked.digest(data.data(), data.size());
+	assert (chunked.chunkDigests().size() == 11);
+
+	DigestEngine engine("SHA256");
+	DigestEngine combined("SHA256");
+	for (std::size_t offset = 0; offset < data.size(); offset += 1000)
+	{
+		engine.update(data.substr(offset, 1000));
+		DigestEngine::Digest d = engine.digest();
+		assert (d == chunked.chunkDigests()[offset/1000]);
+		combined.update(&d[0], d.size());
+	}
+	assert (result == combined.digest());
+	
+	ChunkedDigest single("SHA256", data.size());
+	single.digest(data.data(), data.size());
+	engine.update(data);
+	assert (single.chunkDigests().size() == 1);
+	assert (single.chunkDigests()[0] == engine.digest());
+
+	ChunkedDigest empty("SHA256");
+	engine.update("");
+	DigestEngine::Digest emptyDigest = engine.digest();
+	assert (empty.digest(0, 0) == emptyDigest);
+	assert (empty.chunkDigests().empty());
+
+	try
+	{
+		ChunkedDigest chunked("NO-SUCH-DIGEST");
+		fail("unknown digest - must throw");
+	}
+	catch (Poco::NotFoundException&)
+	{
+	}
+}
+
+
+void DigestEngineTest::testChunkedDigestFile()
+{
+	std::string data;
+	for (int i = 0; i < 100000; ++i)
+	{
+		data += static_cast<char>(i % 253);
+	}
+	Poco::TemporaryFile file;
+	{
+		Poco::FileOutputStream ostr(file.path());
+		ostr << data;
+	}
+
+	ChunkedDigest fromFile("SHA512", 4096);
+	ChunkedDigest fromMemory("SHA512", 4096);
+	assert (fromFile.digestFile(file.path()) == fromMemory.digest(data.data(), data.size()));
+	assert (fromFile.chunkDigests() == fromMemory.chunkDigests());
+	assert (fromFile.chunkDigests().size() == 25);
+
+	Poco::TemporaryFile emptyFile;
+	emptyFile.createFile();
+	assert (fromFile.digestFile(emptyFile.path()) == fromMemory.digest(0, 0));
+}
+
+
 void DigestEngineTest::setUp()
 {
 }
@@ -94,6 +229,10 @@ CppUnit::Test* DigestEngineTest::suite()
 	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("DigestEngineTest");
 
 	CppUnit_addTest(pSuite, DigestEngineTest, testMD5);
+	CppUnit_addTest(pSuite, DigestEngineTest, testHMAC);
+	CppUnit_addTest(pSuite, DigestEngineTest, testHMACClone);
+	CppUnit_addTest(pSuite, DigestEngineTest, testChunkedDigest);
+	CppUnit_addTest(pSuite, DigestEngineTest, testChunkedDigestFile);
 
 	return pSuite;
 }
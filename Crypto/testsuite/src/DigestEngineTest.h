@@ -47,6 +47,10 @@ public:
 	~DigestEngineTest();
 
 	void testMD5();
+	void testHMAC();
+	void testHMACClone();
+	void testChunkedDigest();
+	void testChunkedDigestFile();
 
 	void setUp();
 	void tearDown();
@@ -37,7 +37,14 @@
 #include "Poco/Crypto/CipherFactory.h"
 #include "Poco/Crypto/Cipher.h"
 #include "Poco/Crypto/X509Certificate.h"
+#include "Poco/Crypto/CryptoCache.h"
+#include "Poco/Crypto/CryptoStream.h"
+#include "Poco/SHA1Engine.h"
+#include "Poco/ThreadPool.h"
+#include "Poco/StreamCopier.h"
+#include "Poco/Exception.h"
 #include <sstream>
+#include <algorithm>
 
 
 using namespace Poco::Crypto;
@@ -171,6 +178,55 @@ void RSATest::testSignManipulated()
 }
 
 
+void RSATest::testSignDigests()
+{
+	RSAKey key(RSAKey::KL_1024, RSAKey::EXP_SMALL);
+	RSADigestEngine::DigestVec digests;
+	for (int i = 0; i < 20; ++i)
+	{
+		Poco::SHA1Engine sha1;
+		sha1.update(std::string(i, 'x'));
+		digests.push_back(sha1.digest());
+	}
+
+	RSADigestEngine eng(key);
+	RSADigestEngine::DigestVec signatures;
+	eng.signDigests(digests, signatures);
+	assert (signatures.size() == digests.size());
+
+	RSADigestEngine eng2(key);
+	eng2.update(std::string(7, 'x'));
+	assert (eng2.signature() == signatures[7]);
+
+	Poco::ThreadPool pool(4, 4);
+	RSADigestEngine::DigestVec parallelSignatures;
+	eng.signDigests(digests, parallelSignatures, pool);
+	assert (parallelSignatures == signatures);
+
+	std::vector<bool> results;
+	assert (eng.verifyDigests(digests, signatures, results));
+	assert (results.size() == digests.size());
+	assert (std::find(results.begin(), results.end(), false) == results.end());
+
+	signatures[3][0] ^= 0x01;
+	assert (!eng.verifyDigests(digests, signatures, results, pool));
+	for (std::size_t i = 0; i < results.size(); ++i)
+	{
+		assert (results[i] == (i != 3));
+	}
+
+	signatures.pop_back();
+	try
+	{
+		eng.verifyDigests(digests, signatures, results);
+		fail("size mismatch - must throw");
+	}
+	catch (Poco::InvalidArgumentException&)
+	{
+	}
+}
+
+
 void RSATest::testRSACipher()
 {
 	Cipher::Ptr pCipher = CipherFactory::defaultFactory().createCipher(RSAKey(RSAKey::KL_1024, RSAKey::EXP_SMALL));
@@ -211,6 +267,30 @@ void RSATest::testRSACipherLarge()
 }
 
 
+void RSATest::testRSACipherStream()
+{
+	Cipher::Ptr pCipher = CipherFactory::defaultFactory().createCipher(RSAKey(RSAKey::KL_1024, RSAKey::EXP_SMALL));
+	std::size_t sizes[] = {0, 1, 116, 117, 118, 234, 500};
+	for (std::size_t i = 0; i < sizeof(sizes)/sizeof(sizes[0]); ++i)
+	{
+		std::string val(sizes[i], 'x');
+		std::string enc = pCipher->encryptString(val);
+
+		std::istringstream istr(enc);
+		DecryptingInputStream decryptor(istr, *pCipher);
+		std::string dec;
+		Poco::StreamCopier::copyToString(decryptor, dec);
+		assert (dec == val);
+
+		std::ostringstream ostr;
+		EncryptingOutputStream encryptor(ostr, *pCipher);
+		encryptor << val;
+		encryptor.close();
+		assert (pCipher->decryptString(ostr.str()) == val);
+	}
+}
+
+
 void RSATest::testCertificate()
 {
 	std::istringstream str(anyPem);
@@ -228,6 +308,58 @@ void RSATest::testCertificate()
 }
 
 
+void RSATest::testCache()
+{
+	CryptoCache cache(4);
+	
+	CryptoCache::CertificatePtr pCert = cache.certificate(anyPem);
+	assert (cache.misses() == 1);
+	CryptoCache::CertificatePtr pCert2 = cache.certificate(anyPem);
+	assert (cache.hits() == 1);
+	assert (pCert.get() == pCert2.get());
+	assert (pCert->commonName() == "*");
+	assert (pCert->issuerName() == "/C=AT/ST=Carinthia/L=St. Jakob/O=AppInf/CN=AppInf/emailAddress=app@inf.com");
+	
+	X509Certificate copy(*pCert);
+	assert (copy.certificate() == pCert->certificate());
+	assert (copy.subjectName() == pCert->subjectName());
+	CryptoCache::CertificatePtr pCert3 = cache.certificate(const_cast<X509*>(copy.certificate()));
+	assert (cache.misses() == 2);
+	CryptoCache::CertificatePtr pCert4 = cache.certificate(const_cast<X509*>(pCert->certificate()));
+	assert (cache.hits() == 2);
+	assert (pCert3.get() == pCert4.get());
+	
+	RSAKey privateKey = cache.privateKey(anyPem, "test");
+	RSAKey privateKey2 = cache.privateKey(anyPem, "test");
+	assert (cache.misses() == 3);
+	assert (cache.hits() == 3);
+	assert (privateKey.impl() == privateKey2.impl());
+	try
+	{
+		cache.privateKey(anyPem, "wrong");
+		fail("wrong passphrase - must throw");
+	}
+	catch (Poco::Exception&)
+	{
+	}
+	
+	std::ostringstream strPub;
+	privateKey.save(&strPub);
+	RSAKey publicKey = cache.publicKey(strPub.str());
+	assert (cache.publicKey(strPub.str()).impl() == publicKey.impl());
+	
+	Cipher::Ptr pCipher = CipherFactory::defaultFactory().createCipher(publicKey);
+	Cipher::Ptr pCipher2 = CipherFactory::defaultFactory().createCipher(privateKey);
+	std::string val("lets do some encryption");
+	assert (pCipher2->decryptString(pCipher->encryptString(val)) == val);
+
+	assert (cache.size() == 4);
+	cache.clear();
+	assert (cache.size() == 0);
+	assert (cache.certificate(anyPem).get() != pCert.get());
+}
+
+
 void RSATest::setUp()
 {
 }
@@ -245,9 +377,12 @@ CppUnit::Test* RSATest::suite()
 	CppUnit_addTest(pSuite, RSATest, testNewKeys);
 	CppUnit_addTest(pSuite, RSATest, testSign);
 	CppUnit_addTest(pSuite, RSATest, testSignManipulated);
+	CppUnit_addTest(pSuite, RSATest, testSignDigests);
 	CppUnit_addTest(pSuite, RSATest, testRSACipher);
 	CppUnit_addTest(pSuite, RSATest, testRSACipherLarge);
+	CppUnit_addTest(pSuite, RSATest, testRSACipherStream);
 	CppUnit_addTest(pSuite, RSATest, testCertificate);
+	CppUnit_addTest(pSuite, RSATest, testCache);
 
 	return pSuite;
 }
@@ -49,9 +49,12 @@ public:
 	void testNewKeys();
 	void testSign();
 	void testSignManipulated();
+	void testSignDigests();
 	void testRSACipher();
 	void testRSACipherLarge();
+	void testRSACipherStream();
 	void testCertificate();
+	void testCache();
 
 	void setUp();
 	void tearDown();
@@ -0,0 +1,194 @@
+//
+// Arena.h
+//
+// $Id: //poco/1.4/Foundation/include/Poco/Arena.h#1 $
+//
+// Library: Foundation
+// Package: Core
+// Module:  Arena
+//
+// Definition of the Arena class.
+//
+// Copyright (c) 2013, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+// 
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+
+#ifndef Foundation_Arena_INCLUDED
+#define Foundation_Arena_INCLUDED
+
+
+#include "Poco/Foundation.h"
+#include <cstddef>
+
+
+namespace Poco {
+
+
+class Foundation_API Arena
+	/// A monotonic memory arena for objects that all
+	/// have the same, limited lifetime, such as the
+	/// objects created while handling a single request.
+	///
+	/// Memory is allocated by advancing a pointer within
+	/// the current block. If the current block is exhausted, 
+	/// a new block is chained to it. Individual allocations
+	/// cannot be released; instead, reset() makes all memory
+	/// held by the arena available again at once.
+	///
+	/// The Arena never calls destructors. Objects created in 
+	/// arena memory must either not require destruction, or
+	/// must be destroyed explicitly before calling reset().
+	///
+	/// An Arena is not thread-safe.
+	///
+	/// Use ArenaAllocator to store the elements of standard 
+	/// library containers in an Arena.
+{
+public:
+	enum
+	{
+		DEFAULT_BLOCK_SIZE = 4096,
+		ALIGNMENT          = 2*sizeof(void*)
+	};
+
+	explicit Arena(std::size_t blockSize = DEFAULT_BLOCK_SIZE);
+		/// Creates the Arena. Memory is obtained from the heap
+		/// in blocks of the given size, when needed.
+
+	~Arena();
+		/// Destroys the Arena and releases all its memory.
+
+	void* allocate(std::size_t size);
+		/// Returns memory for size bytes, aligned to ALIGNMENT.
+		///
+		/// Requests larger than half the block size that do not
+		/// fit into the current block are served from a separate
+		/// block of exactly the requested size.
+
+	void* allocate(std::size_t size, std::size_t alignment);
+		/// Returns memory for size bytes, aligned to the
+		/// given alignment, which must be a power of two.
+
+	void reset();
+		/// Makes all memory allocated from the Arena available
+		/// again. Blocks of the standard block size are retained
+		/// for reuse; blocks allocated for large requests are
+		/// released.
+
+	std::size_t blockSize() const;
+		/// Returns the standard block size.
+
+	std::size_t allocated() const;
+		/// Returns the number of bytes allocated since the
+		/// Arena was created, or last reset, including
+		/// alignment padding.
+
+	std::size_t capacity() const;
+		/// Returns the number of bytes held in blocks,
+		/// whether currently in use or retained for reuse.
+
+	int heapAllocations() const;
+		/// Returns the number of blocks the Arena has obtained
+		/// from the heap since it was created.
+
+private:
+	struct Block
+		/// Precedes the memory of every block.
+	{
+		Block*      pNext;
+		std::size_t size;
+	};
+
+	void* allocateSlow(std::size_t size, std::size_t alignment);
+	Block* newBlock(std::size_t size);
+
+	Arena(const Arena&);
+	Arena& operator = (const Arena&);
+
+	std::size_t _blockSize;
+	Block*      _pUsed;
+	Block*      _pFree;
+	char*       _pPos;
+	char*       _pEnd;
+	std::size_t _allocated;
+	std::size_t _capacity;
+	int         _heapAllocations;
+};
+
+
+//
+// inlines
+//
+inline void* Arena::allocate(std::size_t size)
+{
+	return allocate(size, ALIGNMENT);
+}
+
+
+inline void* Arena::allocate(std::size_t size, std::size_t alignment)
+{
+	poco_assert_dbg (alignment > 0 && (alignment & (alignment - 1)) == 0);
+
+	std::size_t padding = (alignment - (reinterpret_cast<std::size_t>(_pPos) & (alignment - 1))) & (alignment - 1);
+	if (_pPos && size + padding <= static_cast<std::size_t>(_pEnd - _pPos))
+	{
+		char* p = _pPos + padding;
+		_pPos = p + size;
+		_allocated += size + padding;
+		return p;
+	}
+	else return allocateSlow(size, alignment);
+}
+
+
+inline std::size_t Arena::blockSize() const
+{
+	return _blockSize;
+}
+
+
+inline std::size_t Arena::allocated() const
+{
+	return _allocated;
+}
+
+
+inline std::size_t Arena::capacity() const
+{
+	return _capacity;
+}
+
+
+inline int Arena::heapAllocations() const
+{
+	return _heapAllocations;
+}
+
+
+} // namespace Poco
+
+
+#endif // Foundation_Arena_INCLUDED
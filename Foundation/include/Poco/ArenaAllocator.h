@@ -0,0 +1,174 @@
+//
+// ArenaAllocator.h
+//
+// $Id: //poco/1.4/Foundation/include/Poco/ArenaAllocator.h#1 $
+//
+// Library: Foundation
+// Package: Core
+// Module:  ArenaAllocator
+//
+// Definition of the ArenaAllocator class.
+//
+// Copyright (c) 2013, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+// 
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+
+#ifndef Foundation_ArenaAllocator_INCLUDED
+#define Foundation_ArenaAllocator_INCLUDED
+
+
+#include "Poco/Foundation.h"
+#include "Poco/Arena.h"
+#include <cstddef>
+#include <new>
+
+
+namespace Poco {
+
+
+template <class T>
+class ArenaAllocator
+	/// An allocator for standard library containers that
+	/// obtains its memory from an Arena.
+	///
+	/// Deallocation does nothing; the memory is reclaimed
+	/// when the Arena is reset. Containers using an ArenaAllocator
+	/// must be destroyed before the Arena is reset.
+	///
+	/// Example:
+	///     Poco::Arena arena;
+	///     typedef std::vector<int, Poco::ArenaAllocator<int> > IntVec;
+	///     Poco::ArenaAllocator<int> alloc(arena);
+	///     IntVec vec(alloc);
+{
+public:
+	typedef T                 value_type;
+	typedef T*                pointer;
+	typedef const T*          const_pointer;
+	typedef T&                reference;
+	typedef const T&          const_reference;
+	typedef std::size_t       size_type;
+	typedef std::ptrdiff_t    difference_type;
+
+	template <class U> 
+	struct rebind 
+	{
+		typedef ArenaAllocator<U> other;
+	};
+
+	explicit ArenaAllocator(Arena& arena):
+		_pArena(&arena)
+		/// Creates an ArenaAllocator using the given Arena.
+	{
+	}
+
+	ArenaAllocator(const ArenaAllocator& alloc):
+		_pArena(alloc._pArena)
+	{
+	}
+
+	template <class U>
+	ArenaAllocator(const ArenaAllocator<U>& alloc):
+		_pArena(&alloc.arena())
+	{
+	}
+
+	~ArenaAllocator()
+	{
+	}
+
+	ArenaAllocator& operator = (const ArenaAllocator& alloc)
+	{
+		_pArena = alloc._pArena;
+		return *this;
+	}
+
+	pointer address(reference value) const
+	{
+		return &value;
+	}
+
+	const_pointer address(const_reference value) const
+	{
+		return &value;
+	}
+
+	pointer allocate(size_type n, const void* = 0)
+	{
+		if (n > max_size()) throw std::bad_alloc();
+		return static_cast<pointer>(_pArena->allocate(n*sizeof(T)));
+	}
+
+	void deallocate(pointer, size_type)
+	{
+	}
+
+	size_type max_size() const
+	{
+		return static_cast<size_type>(-1)/sizeof(T);
+	}
+
+	void construct(pointer p, const T& value)
+	{
+		new (static_cast<void*>(p)) T(value);
+	}
+
+	void destroy(pointer p)
+	{
+		p->~T();
+	}
+
+	Arena& arena() const
+		/// Returns the Arena used by the allocator.
+	{
+		return *_pArena;
+	}
+
+private:
+	ArenaAllocator();
+
+	Arena* _pArena;
+};
+
+
+template <class T, class U>
+inline bool operator == (const ArenaAllocator<T>& a1, const ArenaAllocator<U>& a2)
+{
+	return &a1.arena() == &a2.arena();
+}
+
+
+template <class T, class U>
+inline bool operator != (const ArenaAllocator<T>& a1, const ArenaAllocator<U>& a2)
+{
+	return &a1.arena() != &a2.arena();
+}
+
+
+} // namespace Poco
+
+
+#endif // Foundation_ArenaAllocator_INCLUDED
@@ -53,6 +53,11 @@ class Foundation_API Base64EncoderBuf: public UnbufferedStreamBuf
 	/// to it and forwards it to a connected
 	/// ostream.
 	///
+	/// Blocks of data written with std::ostream::write()
+	/// are encoded in one pass into an internal buffer, which
+	/// is then passed on to the target stream buffer in a
+	/// single call.
+	///
 	/// Note: The characters are directly written
 	/// to the ostream's streambuf, thus bypassing
 	/// the ostream. The ostream's state is therefore
@@ -76,8 +81,17 @@ public:
 	int getLineLength() const;
 		/// Returns the currently set line length.
 	
+protected:
+	std::streamsize xsputn(const char* s, std::streamsize n);
+
 private:
+	enum
+	{
+		BUFFER_SIZE = 4096
+	};
+
 	int writeToDevice(char c);
+	char* encodeGroup(const unsigned char* group, char* pOut);
 
 	unsigned char   _group[3];
 	int             _groupLength;
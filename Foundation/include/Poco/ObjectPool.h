@@ -240,9 +240,8 @@ public:
 		else if (_size < _peakCapacity)
 		{
 			P pObject = _factory.createObject();
-			activateObject(pObject);
 			_size++;
-			return pObject;
+			return activateObject(pObject);
 		}
 		else return 0;
 	}
@@ -268,6 +267,7 @@ public:
 		else
 		{
 			_factory.destroyObject(pObject);
+			_size--;
 		}
 	}
 
@@ -305,6 +305,7 @@ protected:
 		catch (...)
 		{
 			_factory.destroyObject(pObject);
+			_size--;
 			throw;
 		}
 		return pObject;
@@ -0,0 +1,173 @@
+//
+// PoolAllocator.h
+//
+// $Id: //poco/1.4/Foundation/include/Poco/PoolAllocator.h#1 $
+//
+// Library: Foundation
+// Package: Core
+// Module:  PoolAllocator
+//
+// Definition of the PoolAllocator class.
+//
+// Copyright (c) 2013, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+// 
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+
+#ifndef Foundation_PoolAllocator_INCLUDED
+#define Foundation_PoolAllocator_INCLUDED
+
+
+#include "Poco/Foundation.h"
+#include "Poco/SizeClassPool.h"
+#include <cstddef>
+#include <new>
+
+
+namespace Poco {
+
+
+template <class T>
+class PoolAllocator
+	/// An allocator for standard library containers that
+	/// obtains its memory from a SizeClassPool.
+	///
+	/// Example:
+	///     typedef std::list<int, Poco::PoolAllocator<int> > IntList;
+	///     IntList list;
+{
+public:
+	typedef T                 value_type;
+	typedef T*                pointer;
+	typedef const T*          const_pointer;
+	typedef T&                reference;
+	typedef const T&          const_reference;
+	typedef std::size_t       size_type;
+	typedef std::ptrdiff_t    difference_type;
+
+	template <class U> 
+	struct rebind 
+	{
+		typedef PoolAllocator<U> other;
+	};
+
+	PoolAllocator():
+		_pPool(&SizeClassPool::defaultPool())
+		/// Creates a PoolAllocator using the default SizeClassPool.
+	{
+	}
+
+	explicit PoolAllocator(SizeClassPool& pool):
+		_pPool(&pool)
+		/// Creates a PoolAllocator using the given SizeClassPool.
+	{
+	}
+
+	PoolAllocator(const PoolAllocator& alloc):
+		_pPool(alloc._pPool)
+	{
+	}
+
+	template <class U>
+	PoolAllocator(const PoolAllocator<U>& alloc):
+		_pPool(&alloc.pool())
+	{
+	}
+
+	~PoolAllocator()
+	{
+	}
+
+	PoolAllocator& operator = (const PoolAllocator& alloc)
+	{
+		_pPool = alloc._pPool;
+		return *this;
+	}
+
+	pointer address(reference value) const
+	{
+		return &value;
+	}
+
+	const_pointer address(const_reference value) const
+	{
+		return &value;
+	}
+
+	pointer allocate(size_type n, const void* = 0)
+	{
+		if (n > max_size()) throw std::bad_alloc();
+		return static_cast<pointer>(_pPool->allocate(n*sizeof(T)));
+	}
+
+	void deallocate(pointer p, size_type)
+	{
+		_pPool->release(p);
+	}
+
+	size_type max_size() const
+	{
+		return static_cast<size_type>(-1)/sizeof(T);
+	}
+
+	void construct(pointer p, const T& value)
+	{
+		new (static_cast<void*>(p)) T(value);
+	}
+
+	void destroy(pointer p)
+	{
+		p->~T();
+	}
+
+	SizeClassPool& pool() const
+		/// Returns the SizeClassPool used by the allocator.
+	{
+		return *_pPool;
+	}
+
+private:
+	SizeClassPool* _pPool;
+};
+
+
+template <class T, class U>
+inline bool operator == (const PoolAllocator<T>& a1, const PoolAllocator<U>& a2)
+{
+	return &a1.pool() == &a2.pool();
+}
+
+
+template <class T, class U>
+inline bool operator != (const PoolAllocator<T>& a1, const PoolAllocator<U>& a2)
+{
+	return &a1.pool() != &a2.pool();
+}
+
+
+} // namespace Poco
+
+
+#endif // Foundation_PoolAllocator_INCLUDED
@@ -0,0 +1,183 @@
+//
+// SizeClassPool.h
+//
+// $Id: //poco/1.4/Foundation/include/Poco/SizeClassPool.h#1 $
+//
+// Library: Foundation
+// Package: Core
+// Module:  SizeClassPool
+//
+// Definition of the SizeClassPool class.
+//
+// Copyright (c) 2013, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+// 
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+
+#ifndef Foundation_SizeClassPool_INCLUDED
+#define Foundation_SizeClassPool_INCLUDED
+
+
+#include "Poco/Foundation.h"
+#include "Poco/ThreadLocal.h"
+#include "Poco/AutoPtr.h"
+#include <cstddef>
+
+
+namespace Poco {
+
+
+class Foundation_API SizeClassPool
+	/// A memory pool for blocks of arbitrary size, with
+	/// per-thread caches.
+	///
+	/// Requested sizes are rounded up to the next power of two
+	/// (the size class), starting at 16 bytes. Requests larger
+	/// than the maximum block size are passed on to operator new.
+	///
+	/// Every thread created with Poco::Thread (including the threads
+	/// of a ThreadPool) has its own cache of free blocks for every
+	/// size class. Allocating and releasing blocks via the thread cache
+	/// does not require any locking, regardless of which thread has
+	/// originally allocated a block. A block allocated in one thread
+	/// and released in another one simply becomes part of the releasing
+	/// thread's cache.
+	///
+	/// When a thread cache runs empty, it is refilled with a batch of
+	/// blocks from a central free list for the size class. When it 
+	/// grows too large, a batch of blocks is moved back to the central 
+	/// free list. Only these batch transfers lock a mutex (one per 
+	/// size class). Threads not created with Poco::Thread (such as the 
+	/// main thread) use the central free lists directly.
+	///
+	/// A thread cache is flushed to the central free lists when
+	/// the thread's ThreadLocal storage is cleared; for threads
+	/// in a ThreadPool, this happens after every task.
+	///
+	/// If the amount of memory held by the central free list for a 
+	/// size class exceeds the high watermark, blocks are released to the
+	/// operating system until it falls below the low watermark.
+	///
+	/// The pool must be used through allocate() and release() only;
+	/// blocks obtained from the pool must never be passed to delete 
+	/// or free() and vice versa.
+{
+public:
+	struct Statistics
+		/// Statistics about a SizeClassPool.
+	{
+		Statistics();
+
+		int osAllocations;     /// Number of blocks allocated from the operating system.
+		int osReleases;        /// Number of blocks released to the operating system.
+		int largeAllocations;  /// Number of allocations exceeding the maximum block size.
+		int transfers;         /// Number of batch transfers between thread caches and central free lists.
+		std::size_t centralBytes; /// Number of bytes held by the central free lists.
+	};
+
+	enum
+	{
+		MIN_BLOCK_SIZE        = 16,
+		DEFAULT_MAX_BLOCK_SIZE = 64*1024,
+		DEFAULT_HIGH_WATERMARK = 1024*1024,
+		DEFAULT_LOW_WATERMARK  = 256*1024
+	};
+
+	SizeClassPool(std::size_t maxBlockSize = DEFAULT_MAX_BLOCK_SIZE, std::size_t highWatermark = DEFAULT_HIGH_WATERMARK, std::size_t lowWatermark = DEFAULT_LOW_WATERMARK);
+		/// Creates the SizeClassPool. 
+		///
+		/// The maximum block size is rounded up to the next
+		/// power of two. The watermarks specify, in bytes, how much
+		/// memory the central free list for each size class may hold.
+
+	~SizeClassPool();
+		/// Destroys the SizeClassPool and releases all cached
+		/// blocks to the operating system.
+		///
+		/// All blocks must have been returned to the pool before
+		/// it is destroyed. Blocks held by the caches of threads
+		/// that are still running are released when the threads
+		/// terminate.
+
+	void* allocate(std::size_t size);
+		/// Returns a block of at least the given size.
+		///
+		/// The returned memory is suitably aligned for
+		/// any fundamental type.
+
+	void release(void* ptr);
+		/// Returns a block obtained from allocate() to the pool.
+		/// Does nothing if ptr is null.
+
+	void trim();
+		/// Moves all blocks from the calling thread's cache 
+		/// to the central free lists, then releases all blocks
+		/// in the central free lists to the operating system.
+
+	std::size_t maxBlockSize() const;
+		/// Returns the maximum block size.
+
+	Statistics statistics() const;
+		/// Returns the current statistics of the pool.
+
+	std::size_t blockSize(std::size_t size) const;
+		/// Returns the size of the block that will be 
+		/// returned when requesting the given size.
+		///
+		/// For requests exceeding the maximum block size,
+		/// the given size is returned.
+
+	static SizeClassPool& defaultPool();
+		/// Returns a reference to the default SizeClassPool.
+
+private:
+	class Central;
+	class ThreadCache;
+	class ThreadCacheHolder;
+
+	ThreadCache* threadCache();
+
+	SizeClassPool(const SizeClassPool&);
+	SizeClassPool& operator = (const SizeClassPool&);
+
+	std::size_t _maxBlockSize;
+	AutoPtr<Central> _pCentral;
+	ThreadLocal<ThreadCacheHolder> _cache;
+};
+
+
+//
+// inlines
+//
+inline std::size_t SizeClassPool::maxBlockSize() const
+{
+	return _maxBlockSize;
+}
+
+
+} // namespace Poco
+
+
+#endif // Foundation_SizeClassPool_INCLUDED
@@ -0,0 +1,177 @@
+//
+// ArenaBenchmark.cpp
+//
+// $Id: //poco/1.4/Foundation/samples/ArenaBenchmark/src/ArenaBenchmark.cpp#1 $
+//
+// This sample compares the cost of building typical per-request data
+// structures (a header map and a response string) with the default
+// allocator and with an Arena that is reset after every request.
+//
+// Copyright (c) 2013, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+// 
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+
+
+#include "Poco/Arena.h"
+#include "Poco/ArenaAllocator.h"
+#include "Poco/Stopwatch.h"
+#include "Poco/NumberParser.h"
+#include <map>
+#include <string>
+#include <memory>
+#include <iostream>
+#include <iomanip>
+
+
+using Poco::Arena;
+using Poco::ArenaAllocator;
+using Poco::Stopwatch;
+using Poco::NumberParser;
+
+
+static Poco::UInt64 heapAllocations = 0;
+
+
+template <class T>
+class CountingAllocator: public std::allocator<T>
+	/// A std::allocator that counts the number of allocations.
+{
+public:
+	template <class U>
+	struct rebind
+	{
+		typedef CountingAllocator<U> other;
+	};
+
+	CountingAllocator()
+	{
+	}
+
+	template <class U>
+	CountingAllocator(const CountingAllocator<U>&)
+	{
+	}
+
+	T* allocate(std::size_t n, const void* = 0)
+	{
+		++heapAllocations;
+		return std::allocator<T>::allocate(n);
+	}
+};
+
+
+static const char* requestHeaders[][2] =
+{
+	{"Host", "www.appinf.com"},
+	{"User-Agent", "Mozilla/5.0 (X11; Linux x86_64; rv:24.0) Gecko/20100101 Firefox/24.0"},
+	{"Accept", "text/html,application/xhtml+xml,application/xml;q=0.9,*/*;q=0.8"},
+	{"Accept-Language", "en-US,en;q=0.5"},
+	{"Accept-Encoding", "gzip, deflate"},
+	{"Referer", "http://www.appinf.com/en/products/index.html"},
+	{"Cookie", "session=4f9a1c2b8e7d6a5f4e3d2c1b0a9f8e7d; theme=default; lang=en"},
+	{"Connection", "keep-alive"},
+	{"Cache-Control", "max-age=0"},
+	{"If-Modified-Since", "Mon, 07 Oct 2013 08:15:30 GMT"}
+};
+
+
+template <class Alloc>
+std::size_t handleRequest(const Alloc& alloc)
+	/// Simulates the work of a request handler: the request
+	/// headers are copied into a map, and a response is built
+	/// from them. All memory is obtained from the given allocator.
+{
+	typedef typename Alloc::template rebind<char>::other CharAlloc;
+	typedef std::basic_string<char, std::char_traits<char>, CharAlloc> String;
+	typedef std::pair<const String, String> Header;
+	typedef std::map<String, String, std::less<String>, typename Alloc::template rebind<Header>::other> HeaderMap;
+
+	CharAlloc charAlloc(alloc);
+	std::less<String> less;
+	typename HeaderMap::allocator_type headerAlloc(alloc);
+	HeaderMap headers(less, headerAlloc);
+	for (std::size_t i = 0; i < sizeof(requestHeaders)/sizeof(requestHeaders[0]); ++i)
+	{
+		headers.insert(Header(String(requestHeaders[i][0], charAlloc), String(requestHeaders[i][1], charAlloc)));
+	}
+	String response("HTTP/1.1 200 OK\r\n", charAlloc);
+	for (typename HeaderMap::const_iterator it = headers.begin(); it != headers.end(); ++it)
+	{
+		response += "X-Echo-";
+		response += it->first;
+		response += ": ";
+		response += it->second;
+		response += "\r\n";
+	}
+	response += "\r\n";
+	return response.size();
+}
+
+
+int main(int argc, char** argv)
+{
+	int requests = 100000;
+	if (argc > 1 && !NumberParser::tryParse(argv[1], requests))
+	{
+		std::cout << "usage: ArenaBenchmark [<requests>]" << std::endl;
+		return 1;
+	}
+
+	std::size_t total = 0;
+	Stopwatch sw;
+	sw.start();
+	for (int i = 0; i < requests; ++i)
+	{
+		total += handleRequest(CountingAllocator<char>());
+	}
+	sw.stop();
+	double heapTime = double(sw.elapsed())/requests;
+	double heapAllocs = double(heapAllocations)/requests;
+
+	Arena arena;
+	sw.restart();
+	for (int i = 0; i < requests; ++i)
+	{
+		total -= handleRequest(ArenaAllocator<char>(arena));
+		arena.reset();
+	}
+	sw.stop();
+	double arenaTime = double(sw.elapsed())/requests;
+	double arenaAllocs = double(arena.heapAllocations())/requests;
+
+	if (total != 0)
+	{
+		std::cerr << "response size mismatch" << std::endl;
+		return 1;
+	}
+
+	std::cout << requests << " requests" << std::endl << std::endl;
+	std::cout << std::setw(12) << "" << std::setw(14) << "us/request" << std::setw(22) << "allocations/request" << std::endl;
+	std::cout << std::fixed << std::setprecision(3);
+	std::cout << std::setw(12) << "allocator" << std::setw(14) << heapTime << std::setw(22) << heapAllocs << std::endl;
+	std::cout << std::setw(12) << "Arena" << std::setw(14) << arenaTime << std::setw(22) << arenaAllocs << std::endl;
+	return 0;
+}
@@ -0,0 +1,140 @@
+//
+// Arena.cpp
+//
+// $Id: //poco/1.4/Foundation/src/Arena.cpp#1 $
+//
+// Library: Foundation
+// Package: Core
+// Module:  Arena
+//
+// Copyright (c) 2013, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+// 
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+
+#include "Poco/Arena.h"
+
+
+namespace Poco {
+
+
+Arena::Arena(std::size_t blockSize):
+	_blockSize(blockSize),
+	_pUsed(0),
+	_pFree(0),
+	_pPos(0),
+	_pEnd(0),
+	_allocated(0),
+	_capacity(0),
+	_heapAllocations(0)
+{
+	poco_assert (blockSize > 0);
+}
+
+
+Arena::~Arena()
+{
+	reset();
+	while (_pFree)
+	{
+		Block* pBlock = _pFree;
+		_pFree = pBlock->pNext;
+		delete [] reinterpret_cast<char*>(pBlock);
+	}
+}
+
+
+void Arena::reset()
+{
+	while (_pUsed)
+	{
+		Block* pBlock = _pUsed;
+		_pUsed = pBlock->pNext;
+		if (pBlock->size == _blockSize)
+		{
+			pBlock->pNext = _pFree;
+			_pFree = pBlock;
+		}
+		else
+		{
+			_capacity -= pBlock->size;
+			delete [] reinterpret_cast<char*>(pBlock);
+		}
+	}
+	_pPos = _pEnd = 0;
+	_allocated = 0;
+}
+
+
+void* Arena::allocateSlow(std::size_t size, std::size_t alignment)
+{
+	// The memory of a block starts at ALIGNMENT, so alignment
+	// padding is only needed for larger alignments.
+	std::size_t padding = alignment > ALIGNMENT ? alignment - ALIGNMENT : 0;
+	if (size + padding > _blockSize/2)
+	{
+		// Large requests get a block of their own, which is linked 
+		// behind the current block, so that the remaining space in
+		// the current block can still be used.
+		Block* pBlock = newBlock(size + padding);
+		if (_pUsed)
+		{
+			pBlock->pNext = _pUsed->pNext;
+			_pUsed->pNext = pBlock;
+		}
+		else
+		{
+			pBlock->pNext = 0;
+			_pUsed = pBlock;
+		}
+		_allocated += size + padding;
+		char* p = reinterpret_cast<char*>(pBlock + 1);
+		return p + ((alignment - (reinterpret_cast<std::size_t>(p) & (alignment - 1))) & (alignment - 1));
+	}
+
+	Block* pBlock = _pFree;
+	if (pBlock)
+		_pFree = pBlock->pNext;
+	else
+		pBlock = newBlock(_blockSize);
+	pBlock->pNext = _pUsed;
+	_pUsed = pBlock;
+	_pPos = reinterpret_cast<char*>(pBlock + 1);
+	_pEnd = _pPos + _blockSize;
+	return allocate(size, alignment);
+}
+
+
+Arena::Block* Arena::newBlock(std::size_t size)
+{
+	Block* pBlock = reinterpret_cast<Block*>(new char[sizeof(Block) + size]);
+	pBlock->size = size;
+	_capacity += size;
+	++_heapAllocations;
+	return pBlock;
+}
+
+
+} // namespace Poco
@@ -93,28 +93,71 @@ int Base64EncoderBuf::writeToDevice(char c)
 	_group[_groupLength++] = (unsigned char) c;
 	if (_groupLength == 3)
 	{
-		unsigned char idx;
-		idx = _group[0] >> 2;
-		if (_buf.sputc(OUT_ENCODING[idx]) == eof) return eof;
-		idx = ((_group[0] & 0x03) << 4) | (_group[1] >> 4);
-		if (_buf.sputc(OUT_ENCODING[idx]) == eof) return eof;
-		idx = ((_group[1] & 0x0F) << 2) | (_group[2] >> 6);
-		if (_buf.sputc(OUT_ENCODING[idx]) == eof) return eof;
-		idx = _group[2] & 0x3F;
-		if (_buf.sputc(OUT_ENCODING[idx]) == eof) return eof;
-		_pos += 4;
-		if (_lineLength > 0 && _pos >= _lineLength) 
-		{
-			if (_buf.sputc('\r') == eof) return eof;
-			if (_buf.sputc('\n') == eof) return eof;
-			_pos = 0;
-		}
+		char buffer[6];
+		char* pOut = encodeGroup(_group, buffer);
 		_groupLength = 0;
+		if (_buf.sputn(buffer, pOut - buffer) != pOut - buffer) return eof;
 	}
 	return charToInt(c);
 }
 
 
+char* Base64EncoderBuf::encodeGroup(const unsigned char* group, char* pOut)
+{
+	*pOut++ = OUT_ENCODING[group[0] >> 2];
+	*pOut++ = OUT_ENCODING[((group[0] & 0x03) << 4) | (group[1] >> 4)];
+	*pOut++ = OUT_ENCODING[((group[1] & 0x0F) << 2) | (group[2] >> 6)];
+	*pOut++ = OUT_ENCODING[group[2] & 0x3F];
+	_pos += 4;
+	if (_lineLength > 0 && _pos >= _lineLength) 
+	{
+		*pOut++ = '\r';
+		*pOut++ = '\n';
+		_pos = 0;
+	}
+	return pOut;
+}
+
+
+std::streamsize Base64EncoderBuf::xsputn(const char* s, std::streamsize n)
+{
+	char buffer[BUFFER_SIZE];
+	char* const pLimit = buffer + BUFFER_SIZE - 6; // room for one group plus CR-LF
+	char* pOut = buffer;
+	const unsigned char* pIn  = reinterpret_cast<const unsigned char*>(s);
+	const unsigned char* pEnd = pIn + n;
+
+	while (_groupLength > 0 && _groupLength < 3 && pIn < pEnd)
+	{
+		_group[_groupLength++] = *pIn++;
+	}
+	if (_groupLength == 3)
+	{
+		pOut = encodeGroup(_group, pOut);
+		_groupLength = 0;
+	}
+	while (pEnd - pIn >= 3)
+	{
+		pOut = encodeGroup(pIn, pOut);
+		pIn += 3;
+		if (pOut >= pLimit)
+		{
+			if (_buf.sputn(buffer, pOut - buffer) != pOut - buffer) return 0;
+			pOut = buffer;
+		}
+	}
+	if (pOut > buffer)
+	{
+		if (_buf.sputn(buffer, pOut - buffer) != pOut - buffer) return 0;
+	}
+	while (pIn < pEnd)
+	{
+		_group[_groupLength++] = *pIn++;
+	}
+	return n;
+}
+
+
 int Base64EncoderBuf::close()
 {
 	static const int eof = std::char_traits<char>::eof();
@@ -0,0 +1,517 @@
+//
+// SizeClassPool.cpp
+//
+// $Id: //poco/1.4/Foundation/src/SizeClassPool.cpp#1 $
+//
+// Library: Foundation
+// Package: Core
+// Module:  SizeClassPool
+//
+// Copyright (c) 2013, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+// 
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+
+#include "Poco/SizeClassPool.h"
+#include "Poco/RefCountedObject.h"
+#include "Poco/AtomicCounter.h"
+#include "Poco/Mutex.h"
+#include "Poco/Thread.h"
+#include "Poco/SingletonHolder.h"
+#include <vector>
+
+
+namespace Poco {
+
+
+namespace
+{
+	struct BlockHeader
+		/// Precedes the memory returned by SizeClassPool::allocate().
+		/// The second member keeps the returned memory aligned
+		/// to twice the size of a pointer.
+	{
+		std::size_t sizeClass;
+		std::size_t reserved;
+	};
+
+	const std::size_t LARGE_BLOCK = ~std::size_t(0);
+
+	struct FreeList
+		/// A singly linked list of free blocks. The link to the
+		/// next block is stored in the free block itself.
+	{
+		FreeList():
+			pHead(0),
+			count(0)
+		{
+		}
+
+		void push(BlockHeader* pBlock)
+		{
+			*reinterpret_cast<BlockHeader**>(pBlock + 1) = pHead;
+			pHead = pBlock;
+			++count;
+		}
+
+		BlockHeader* pop()
+		{
+			BlockHeader* pBlock = pHead;
+			pHead = *reinterpret_cast<BlockHeader**>(pBlock + 1);
+			--count;
+			return pBlock;
+		}
+
+		BlockHeader* pHead;
+		std::size_t  count;
+	};
+
+	inline std::size_t classSize(std::size_t sizeClass)
+	{
+		return std::size_t(SizeClassPool::MIN_BLOCK_SIZE) << sizeClass;
+	}
+
+	inline std::size_t sizeClassFor(std::size_t size)
+	{
+		std::size_t sizeClass = 0;
+		while (classSize(sizeClass) < size) ++sizeClass;
+		return sizeClass;
+	}
+	
+	enum
+	{
+		THREAD_CACHE_BYTES = 128*1024,
+		THREAD_CACHE_MIN   = 4,
+		THREAD_CACHE_MAX   = 256
+	};
+
+	inline std::size_t threadCacheLimit(std::size_t sizeClass)
+		/// Returns the number of blocks a thread may cache for a
+		/// size class. Half of that is transferred at once 
+		/// from or to the central free list.
+	{
+		std::size_t limit = THREAD_CACHE_BYTES/classSize(sizeClass);
+		if (limit < THREAD_CACHE_MIN) limit = THREAD_CACHE_MIN;
+		if (limit > THREAD_CACHE_MAX) limit = THREAD_CACHE_MAX;
+		return limit;
+	}
+}
+
+
+//
+// SizeClassPool::Central
+//
+
+
+class SizeClassPool::Central: public RefCountedObject
+	/// The central free lists, shared by all threads.
+	///
+	/// The Central is reference counted, as thread caches
+	/// may outlive the SizeClassPool.
+{
+public:
+	Central(std::size_t classes, std::size_t highWatermark, std::size_t lowWatermark):
+		_classes(classes),
+		_highWatermark(highWatermark),
+		_lowWatermark(lowWatermark),
+		_pLists(new ClassList[classes])
+	{
+	}
+
+	~Central()
+	{
+		trim();
+		delete [] _pLists;
+	}
+
+	std::size_t classes() const
+	{
+		return _classes;
+	}
+
+	BlockHeader* newBlock(std::size_t sizeClass)
+	{
+		BlockHeader* pBlock = reinterpret_cast<BlockHeader*>(new char[sizeof(BlockHeader) + classSize(sizeClass)]);
+		pBlock->sizeClass = sizeClass;
+		++_osAllocations;
+		return pBlock;
+	}
+
+	void deleteBlock(BlockHeader* pBlock)
+	{
+		delete [] reinterpret_cast<char*>(pBlock);
+		++_osReleases;
+	}
+
+	BlockHeader* newLargeBlock(std::size_t size)
+	{
+		BlockHeader* pBlock = reinterpret_cast<BlockHeader*>(new char[sizeof(BlockHeader) + size]);
+		pBlock->sizeClass = LARGE_BLOCK;
+		++_largeAllocations;
+		return pBlock;
+	}
+
+	void deleteLargeBlock(BlockHeader* pBlock)
+	{
+		delete [] reinterpret_cast<char*>(pBlock);
+	}
+
+	BlockHeader* allocateBlock(std::size_t sizeClass)
+	{
+		{
+			ClassList& list = _pLists[sizeClass];
+			FastMutex::ScopedLock lock(list.mutex);
+			if (list.free.pHead) return list.free.pop();
+		}
+		return newBlock(sizeClass);
+	}
+
+	void releaseBlock(BlockHeader* pBlock)
+	{
+		FreeList surplus;
+		{
+			ClassList& list = _pLists[pBlock->sizeClass];
+			FastMutex::ScopedLock lock(list.mutex);
+			list.free.push(pBlock);
+			takeSurplus(pBlock->sizeClass, list, surplus);
+		}
+		deleteBlocks(surplus);
+	}
+
+	void refill(std::size_t sizeClass, FreeList& cache, std::size_t count)
+		/// Moves up to count blocks to the given thread cache.
+	{
+		ClassList& list = _pLists[sizeClass];
+		FastMutex::ScopedLock lock(list.mutex);
+		if (list.free.pHead)
+		{
+			while (count-- > 0 && list.free.pHead)
+			{
+				cache.push(list.free.pop());
+			}
+			++_transfers;
+		}
+	}
+
+	void flush(std::size_t sizeClass, FreeList& cache, std::size_t count)
+		/// Moves count blocks from the given thread cache
+		/// to the central free list.
+	{
+		FreeList surplus;
+		{
+			ClassList& list = _pLists[sizeClass];
+			FastMutex::ScopedLock lock(list.mutex);
+			while (count-- > 0 && cache.pHead)
+			{
+				list.free.push(cache.pop());
+			}
+			++_transfers;
+			takeSurplus(sizeClass, list, surplus);
+		}
+		deleteBlocks(surplus);
+	}
+
+	void trim()
+	{
+		for (std::size_t sizeClass = 0; sizeClass < _classes; ++sizeClass)
+		{
+			FreeList blocks;
+			{
+				ClassList& list = _pLists[sizeClass];
+				FastMutex::ScopedLock lock(list.mutex);
+				std::swap(blocks, list.free);
+			}
+			deleteBlocks(blocks);
+		}
+	}
+
+	void statistics(SizeClassPool::Statistics& stats) const
+	{
+		stats.osAllocations    = _osAllocations.value();
+		stats.osReleases       = _osReleases.value();
+		stats.largeAllocations = _largeAllocations.value();
+		stats.transfers        = _transfers.value();
+		stats.centralBytes     = 0;
+		for (std::size_t sizeClass = 0; sizeClass < _classes; ++sizeClass)
+		{
+			ClassList& list = _pLists[sizeClass];
+			FastMutex::ScopedLock lock(list.mutex);
+			stats.centralBytes += list.free.count*classSize(sizeClass);
+		}
+	}
+
+private:
+	struct ClassList
+	{
+		FastMutex mutex;
+		FreeList  free;
+	};
+
+	void takeSurplus(std::size_t sizeClass, ClassList& list, FreeList& surplus)
+		/// If the list exceeds the high watermark, removes blocks
+		/// until it falls below the low watermark. The blocks are
+		/// deleted by the caller, after releasing the lock.
+	{
+		std::size_t size = classSize(sizeClass);
+		if (list.free.count*size > _highWatermark)
+		{
+			while (list.free.pHead && list.free.count*size > _lowWatermark)
+			{
+				surplus.push(list.free.pop());
+			}
+		}
+	}
+
+	void deleteBlocks(FreeList& blocks)
+	{
+		while (blocks.pHead)
+		{
+			deleteBlock(blocks.pop());
+		}
+	}
+
+	std::size_t   _classes;
+	std::size_t   _highWatermark;
+	std::size_t   _lowWatermark;
+	ClassList*    _pLists;
+	AtomicCounter _osAllocations;
+	AtomicCounter _osReleases;
+	AtomicCounter _largeAllocations;
+	AtomicCounter _transfers;
+};
+
+
+//
+// SizeClassPool::ThreadCache
+//
+
+
+class SizeClassPool::ThreadCache
+	/// The free lists of a single thread.
+{
+public:
+	ThreadCache(Central* pCentral):
+		_pCentral(pCentral, true),
+		_lists(pCentral->classes())
+	{
+	}
+
+	~ThreadCache()
+	{
+		flush();
+	}
+
+	Central* central()
+	{
+		return _pCentral;
+	}
+
+	BlockHeader* allocate(std::size_t sizeClass)
+	{
+		FreeList& list = _lists[sizeClass];
+		if (!list.pHead)
+		{
+			_pCentral->refill(sizeClass, list, threadCacheLimit(sizeClass)/2);
+			if (!list.pHead) return _pCentral->newBlock(sizeClass);
+		}
+		return list.pop();
+	}
+
+	void release(BlockHeader* pBlock)
+	{
+		FreeList& list = _lists[pBlock->sizeClass];
+		list.push(pBlock);
+		std::size_t limit = threadCacheLimit(pBlock->sizeClass);
+		if (list.count > limit)
+		{
+			_pCentral->flush(pBlock->sizeClass, list, list.count - limit/2);
+		}
+	}
+
+	void flush()
+	{
+		for (std::size_t sizeClass = 0; sizeClass < _lists.size(); ++sizeClass)
+		{
+			if (_lists[sizeClass].pHead)
+			{
+				_pCentral->flush(sizeClass, _lists[sizeClass], _lists[sizeClass].count);
+			}
+		}
+	}
+
+private:
+	AutoPtr<Central>      _pCentral;
+	std::vector<FreeList> _lists;
+};
+
+
+class SizeClassPool::ThreadCacheHolder
+	/// Deletes the ThreadCache when the thread terminates.
+{
+public:
+	ThreadCacheHolder():
+		pCache(0)
+	{
+	}
+
+	~ThreadCacheHolder()
+	{
+		delete pCache;
+	}
+
+	ThreadCache* pCache;
+};
+
+
+//
+// SizeClassPool
+//
+
+
+SizeClassPool::Statistics::Statistics():
+	osAllocations(0),
+	osReleases(0),
+	largeAllocations(0),
+	transfers(0),
+	centralBytes(0)
+{
+}
+
+
+SizeClassPool::SizeClassPool(std::size_t maxBlockSize, std::size_t highWatermark, std::size_t lowWatermark)
+{
+	poco_assert (lowWatermark <= highWatermark);
+
+	std::size_t classes = sizeClassFor(maxBlockSize) + 1;
+	_maxBlockSize = classSize(classes - 1);
+	_pCentral = new Central(classes, highWatermark, lowWatermark);
+}
+
+
+SizeClassPool::~SizeClassPool()
+{
+	_pCentral->trim();
+}
+
+
+void* SizeClassPool::allocate(std::size_t size)
+{
+	BlockHeader* pBlock;
+	if (size > _maxBlockSize)
+	{
+		pBlock = _pCentral->newLargeBlock(size);
+	}
+	else
+	{
+		std::size_t sizeClass = sizeClassFor(size);
+		ThreadCache* pCache = threadCache();
+		if (pCache)
+			pBlock = pCache->allocate(sizeClass);
+		else
+			pBlock = _pCentral->allocateBlock(sizeClass);
+	}
+	return pBlock + 1;
+}
+
+
+void SizeClassPool::release(void* ptr)
+{
+	if (!ptr) return;
+
+	BlockHeader* pBlock = static_cast<BlockHeader*>(ptr) - 1;
+	if (pBlock->sizeClass == LARGE_BLOCK)
+	{
+		_pCentral->deleteLargeBlock(pBlock);
+	}
+	else
+	{
+		poco_assert_dbg (pBlock->sizeClass < _pCentral->classes());
+
+		ThreadCache* pCache = threadCache();
+		if (pCache)
+			pCache->release(pBlock);
+		else
+			_pCentral->releaseBlock(pBlock);
+	}
+}
+
+
+void SizeClassPool::trim()
+{
+	ThreadCache* pCache = threadCache();
+	if (pCache) pCache->flush();
+	_pCentral->trim();
+}
+
+
+SizeClassPool::Statistics SizeClassPool::statistics() const
+{
+	Statistics stats;
+	_pCentral->statistics(stats);
+	return stats;
+}
+
+
+std::size_t SizeClassPool::blockSize(std::size_t size) const
+{
+	if (size > _maxBlockSize)
+		return size;
+	else
+		return classSize(sizeClassFor(size));
+}
+
+
+SizeClassPool::ThreadCache* SizeClassPool::threadCache()
+{
+	// ThreadLocal storage is shared by all threads not created
+	// with Poco::Thread, so these cannot have a cache.
+	if (!Thread::current()) return 0;
+
+	ThreadCacheHolder& holder = _cache.get();
+	if (!holder.pCache || holder.pCache->central() != _pCentral.get())
+	{
+		// A cache for a different Central may be left over from a 
+		// destroyed pool that resided at the same address.
+		delete holder.pCache;
+		holder.pCache = 0;
+		holder.pCache = new ThreadCache(_pCentral.get());
+	}
+	return holder.pCache;
+}
+
+
+namespace
+{
+	static SingletonHolder<SizeClassPool> sh;
+}
+
+
+SizeClassPool& SizeClassPool::defaultPool()
+{
+	return *sh.get();
+}
+
+
+} // namespace Poco
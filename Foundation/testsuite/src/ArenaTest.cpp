@@ -0,0 +1,184 @@
+//
+// ArenaTest.cpp
+//
+// $Id: //poco/1.4/Foundation/testsuite/src/ArenaTest.cpp#1 $
+//
+// Copyright (c) 2013, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+// 
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+
+#include "ArenaTest.h"
+#include "CppUnit/TestCaller.h"
+#include "CppUnit/TestSuite.h"
+#include "Poco/Arena.h"
+#include "Poco/ArenaAllocator.h"
+#include <vector>
+#include <map>
+#include <string>
+#include <cstring>
+
+
+using Poco::Arena;
+using Poco::ArenaAllocator;
+
+
+ArenaTest::ArenaTest(const std::string& name): CppUnit::TestCase(name)
+{
+}
+
+
+ArenaTest::~ArenaTest()
+{
+}
+
+
+void ArenaTest::testAllocate()
+{
+	Arena arena(1024);
+	assert (arena.blockSize() == 1024);
+	assert (arena.capacity() == 0);
+	assert (arena.heapAllocations() == 0);
+
+	char* p1 = static_cast<char*>(arena.allocate(10));
+	char* p2 = static_cast<char*>(arena.allocate(10));
+	assert (reinterpret_cast<std::size_t>(p1) % Arena::ALIGNMENT == 0);
+	assert (reinterpret_cast<std::size_t>(p2) % Arena::ALIGNMENT == 0);
+	assert (p2 == p1 + Arena::ALIGNMENT);
+	assert (arena.allocated() == 10 + Arena::ALIGNMENT);
+	assert (arena.heapAllocations() == 1);
+	assert (arena.capacity() == 1024);
+
+	char* p3 = static_cast<char*>(arena.allocate(1, 1));
+	assert (p3 == p2 + 10);
+	char* p4 = static_cast<char*>(arena.allocate(8, 64));
+	assert (reinterpret_cast<std::size_t>(p4) % 64 == 0);
+
+	for (int i = 0; i < 100; ++i)
+	{
+		std::memset(arena.allocate(100), 'x', 100);
+	}
+	assert (arena.heapAllocations() > 1);
+	assert (arena.capacity() == arena.heapAllocations()*1024u);
+}
+
+
+void ArenaTest::testLargeAllocations()
+{
+	Arena arena(1024);
+	char* p1 = static_cast<char*>(arena.allocate(16));
+	char* p2 = static_cast<char*>(arena.allocate(2000));
+	std::memset(p2, 'x', 2000);
+	assert (arena.heapAllocations() == 2);
+	assert (arena.capacity() == 1024 + 2000);
+
+	// the current block is still used after a large allocation
+	char* p3 = static_cast<char*>(arena.allocate(16));
+	assert (p3 == p1 + 16);
+
+	char* p4 = static_cast<char*>(arena.allocate(600, 256));
+	assert (reinterpret_cast<std::size_t>(p4) % 256 == 0);
+	assert (arena.heapAllocations() == 2);
+	char* p5 = static_cast<char*>(arena.allocate(600, 256));
+	assert (reinterpret_cast<std::size_t>(p5) % 256 == 0);
+	assert (arena.heapAllocations() == 3);
+
+	arena.reset();
+	assert (arena.capacity() == 1024);
+}
+
+
+void ArenaTest::testReset()
+{
+	Arena arena(256);
+	for (int i = 0; i < 10; ++i)
+	{
+		arena.allocate(100);
+	}
+	int heapAllocations = arena.heapAllocations();
+	std::size_t capacity = arena.capacity();
+	assert (heapAllocations == 5);
+
+	for (int round = 0; round < 10; ++round)
+	{
+		arena.reset();
+		assert (arena.allocated() == 0);
+		for (int i = 0; i < 10; ++i)
+		{
+			arena.allocate(100);
+		}
+		assert (arena.heapAllocations() == heapAllocations);
+		assert (arena.capacity() == capacity);
+	}
+}
+
+
+void ArenaTest::testAllocator()
+{
+	Arena arena;
+	{
+		ArenaAllocator<int> alloc(arena);
+		std::vector<int, ArenaAllocator<int> > vec(alloc);
+		for (int i = 0; i < 1000; ++i) vec.push_back(i);
+		assert (vec[999] == 999);
+
+		typedef std::basic_string<char, std::char_traits<char>, ArenaAllocator<char> > String;
+		typedef std::map<String, String, std::less<String>, ArenaAllocator<std::pair<const String, String> > > Map;
+		ArenaAllocator<char> charAlloc(arena);
+		Map::allocator_type mapAlloc(arena);
+		Map map(std::less<String>(), mapAlloc);
+		map.insert(Map::value_type(String("Host", charAlloc), String("www.appinf.com", charAlloc)));
+		map.insert(Map::value_type(String("Accept", charAlloc), String("*/*", charAlloc)));
+		assert (map.size() == 2);
+		assert (map.find(String("Host", charAlloc))->second == "www.appinf.com");
+		assert (map.get_allocator() == alloc);
+	}
+	assert (arena.allocated() > 1000*sizeof(int));
+	Arena other;
+	assert (ArenaAllocator<int>(arena) != ArenaAllocator<char>(other));
+}
+
+
+void ArenaTest::setUp()
+{
+}
+
+
+void ArenaTest::tearDown()
+{
+}
+
+
+CppUnit::Test* ArenaTest::suite()
+{
+	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("ArenaTest");
+
+	CppUnit_addTest(pSuite, ArenaTest, testAllocate);
+	CppUnit_addTest(pSuite, ArenaTest, testLargeAllocations);
+	CppUnit_addTest(pSuite, ArenaTest, testReset);
+	CppUnit_addTest(pSuite, ArenaTest, testAllocator);
+
+	return pSuite;
+}
@@ -177,6 +177,47 @@ void Base64Test::testEncodeDecode()
 }
 
 
+void Base64Test::testEncodeBlocks()
+{
+	std::string data;
+	for (int i = 0; i < 100000; ++i)
+	{
+		data += (char) (i*7 + i/256);
+	}
+	std::ostringstream str1;
+	Base64Encoder encoder1(str1);
+	for (std::string::const_iterator it = data.begin(); it != data.end(); ++it)
+	{
+		encoder1.put(*it);
+	}
+	encoder1.close();
+	
+	// write in blocks of varying size, to leave
+	// incomplete groups between write() calls
+	std::ostringstream str2;
+	Base64Encoder encoder2(str2);
+	std::string::size_type pos = 0;
+	std::string::size_type n = 1;
+	while (pos < data.size())
+	{
+		if (n > data.size() - pos) n = data.size() - pos;
+		encoder2.write(data.data() + pos, n);
+		pos += n;
+		n = (n*5 + 3) % 10007;
+	}
+	encoder2.close();
+	assert (str1.str() == str2.str());
+	assert (str2.str().size() == 137038); // 133336 characters plus CR-LF every 72 characters
+
+	std::istringstream istr(str2.str());
+	Base64Decoder decoder(istr);
+	std::string decoded;
+	int c = decoder.get();
+	while (c != -1) { decoded += char(c); c = decoder.get(); }
+	assert (decoded == data);
+}
+
+
 void Base64Test::setUp()
 {
 }
@@ -194,6 +235,7 @@ CppUnit::Test* Base64Test::suite()
 	CppUnit_addTest(pSuite, Base64Test, testEncoder);
 	CppUnit_addTest(pSuite, Base64Test, testDecoder);
 	CppUnit_addTest(pSuite, Base64Test, testEncodeDecode);
+	CppUnit_addTest(pSuite, Base64Test, testEncodeBlocks);
 
 	return pSuite;
 }
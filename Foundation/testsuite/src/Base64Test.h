@@ -49,6 +49,7 @@ public:
 	void testEncoder();
 	void testDecoder();
 	void testEncodeDecode();
+	void testEncodeBlocks();
 
 	void setUp();
 	void tearDown();
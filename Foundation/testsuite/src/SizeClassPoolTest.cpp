@@ -0,0 +1,300 @@
+//
+// SizeClassPoolTest.cpp
+//
+// $Id: //poco/1.4/Foundation/testsuite/src/SizeClassPoolTest.cpp#1 $
+//
+// Copyright (c) 2013, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+// 
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+
+#include "SizeClassPoolTest.h"
+#include "CppUnit/TestCaller.h"
+#include "CppUnit/TestSuite.h"
+#include "Poco/SizeClassPool.h"
+#include "Poco/PoolAllocator.h"
+#include "Poco/Thread.h"
+#include "Poco/Runnable.h"
+#include "Poco/Mutex.h"
+#include <vector>
+#include <list>
+#include <map>
+#include <cstring>
+
+
+using Poco::SizeClassPool;
+using Poco::PoolAllocator;
+
+
+namespace
+{
+	class PoolRunnable: public Poco::Runnable
+		/// Allocates blocks, and releases the blocks
+		/// allocated by another PoolRunnable.
+	{
+	public:
+		PoolRunnable(SizeClassPool& pool):
+			_pool(pool),
+			_pPeer(0),
+			_ok(true)
+		{
+		}
+
+		void setPeer(PoolRunnable* pPeer)
+		{
+			_pPeer = pPeer;
+		}
+
+		void run()
+		{
+			for (int round = 0; round < 10; ++round)
+			{
+				std::vector<void*> blocks;
+				for (int i = 0; i < 500; ++i)
+				{
+					std::size_t size = 1 + (i*37 + round) % 2000;
+					char* p = static_cast<char*>(_pool.allocate(size));
+					std::memset(p, i & 0xFF, size);
+					blocks.push_back(p);
+				}
+				for (int i = 0; i < 500; ++i)
+				{
+					std::size_t size = 1 + (i*37 + round) % 2000;
+					const char* p = static_cast<const char*>(blocks[i]);
+					if (p[0] != char(i & 0xFF) || p[size - 1] != char(i & 0xFF)) _ok = false;
+				}
+				_pPeer->give(blocks);
+				releaseGiven();
+			}
+			releaseGiven();
+		}
+
+		void give(std::vector<void*>& blocks)
+		{
+			Poco::FastMutex::ScopedLock lock(_mutex);
+			_given.insert(_given.end(), blocks.begin(), blocks.end());
+		}
+
+		void releaseGiven()
+		{
+			std::vector<void*> blocks;
+			{
+				Poco::FastMutex::ScopedLock lock(_mutex);
+				blocks.swap(_given);
+			}
+			for (std::vector<void*>::iterator it = blocks.begin(); it != blocks.end(); ++it)
+			{
+				_pool.release(*it);
+			}
+		}
+
+		bool ok() const
+		{
+			return _ok;
+		}
+
+	private:
+		SizeClassPool& _pool;
+		PoolRunnable* _pPeer;
+		std::vector<void*> _given;
+		Poco::FastMutex _mutex;
+		bool _ok;
+	};
+}
+
+
+SizeClassPoolTest::SizeClassPoolTest(const std::string& name): CppUnit::TestCase(name)
+{
+}
+
+
+SizeClassPoolTest::~SizeClassPoolTest()
+{
+}
+
+
+void SizeClassPoolTest::testAllocate()
+{
+	SizeClassPool pool(1000);
+	assert (pool.maxBlockSize() == 1024);
+	assert (pool.blockSize(0) == 16);
+	assert (pool.blockSize(16) == 16);
+	assert (pool.blockSize(17) == 32);
+	assert (pool.blockSize(1000) == 1024);
+	assert (pool.blockSize(1025) == 1025);
+
+	void* p1 = pool.allocate(100);
+	assert (reinterpret_cast<std::size_t>(p1) % (2*sizeof(void*)) == 0);
+	std::memset(p1, 'x', 128);
+	pool.release(p1);
+	void* p2 = pool.allocate(128);
+	assert (p2 == p1);
+	
+	void* p3 = pool.allocate(5000);
+	std::memset(p3, 'x', 5000);
+	pool.release(p3);
+	pool.release(p2);
+	pool.release(0);
+
+	SizeClassPool::Statistics stats = pool.statistics();
+	assert (stats.osAllocations == 1);
+	assert (stats.largeAllocations == 1);
+	assert (stats.centralBytes == 128);
+
+	pool.trim();
+	stats = pool.statistics();
+	assert (stats.osReleases == 1);
+	assert (stats.centralBytes == 0);
+}
+
+
+void SizeClassPoolTest::testWatermarks()
+{
+	SizeClassPool pool(1024, 8*1024, 2*1024);
+	std::vector<void*> blocks;
+	for (int i = 0; i < 16; ++i)
+	{
+		blocks.push_back(pool.allocate(1024));
+	}
+	for (int i = 0; i < 8; ++i)
+	{
+		pool.release(blocks[i]);
+	}
+	SizeClassPool::Statistics stats = pool.statistics();
+	assert (stats.centralBytes == 8*1024);
+	assert (stats.osReleases == 0);
+
+	pool.release(blocks[8]);
+	stats = pool.statistics();
+	assert (stats.centralBytes == 2*1024);
+	assert (stats.osReleases == 7);
+
+	for (int i = 9; i < 16; ++i)
+	{
+		pool.release(blocks[i]);
+	}
+	pool.trim();
+	stats = pool.statistics();
+	assert (stats.osAllocations == 16);
+	assert (stats.osReleases == 16);
+}
+
+
+void SizeClassPoolTest::testThreads()
+{
+	SizeClassPool pool(4096);
+	const int N_THREADS = 4;
+	std::vector<PoolRunnable*> runnables;
+	for (int i = 0; i < N_THREADS; ++i)
+	{
+		runnables.push_back(new PoolRunnable(pool));
+	}
+	for (int i = 0; i < N_THREADS; ++i)
+	{
+		runnables[i]->setPeer(runnables[(i + 1) % N_THREADS]);
+	}
+	{
+		Poco::Thread threads[N_THREADS];
+		for (int i = 0; i < N_THREADS; ++i)
+		{
+			threads[i].start(*runnables[i]);
+		}
+		for (int i = 0; i < N_THREADS; ++i)
+		{
+			threads[i].join();
+		}
+	}
+	for (int i = 0; i < N_THREADS; ++i)
+	{
+		runnables[i]->releaseGiven();
+		assert (runnables[i]->ok());
+		delete runnables[i];
+	}
+
+	// the thread caches have been flushed when the threads were destroyed
+	SizeClassPool::Statistics stats = pool.statistics();
+	assert (stats.transfers > 0);
+	pool.trim();
+	stats = pool.statistics();
+	assert (stats.osAllocations > 0);
+	assert (stats.osAllocations == stats.osReleases);
+}
+
+
+void SizeClassPoolTest::testAllocator()
+{
+	SizeClassPool pool;
+	{
+		PoolAllocator<int> alloc(pool);
+		std::list<int, PoolAllocator<int> > list(alloc);
+		for (int i = 0; i < 1000; ++i) list.push_back(i);
+		int sum = 0;
+		for (std::list<int, PoolAllocator<int> >::const_iterator it = list.begin(); it != list.end(); ++it) sum += *it;
+		assert (sum == 999*1000/2);
+
+		typedef std::map<int, std::string, std::less<int>, PoolAllocator<std::pair<const int, std::string> > > Map;
+		Map::allocator_type mapAlloc(pool);
+		Map map(std::less<int>(), mapAlloc);
+		map[1] = "one";
+		map[2] = "two";
+		assert (map[1] == "one");
+		assert (map.size() == 2);
+		assert (map.get_allocator() == PoolAllocator<int>(pool));
+		assert (map.get_allocator() != PoolAllocator<int>());
+
+		std::vector<double, PoolAllocator<double> > vec(100, 1.5, PoolAllocator<double>(pool));
+		vec.resize(10000, 2.5);
+		assert (vec[99] == 1.5 && vec[9999] == 2.5);
+	}
+	SizeClassPool::Statistics stats = pool.statistics();
+	assert (stats.osAllocations > 0);
+	assert (stats.largeAllocations == 1);
+	pool.trim();
+	stats = pool.statistics();
+	assert (stats.osAllocations == stats.osReleases);
+}
+
+
+void SizeClassPoolTest::setUp()
+{
+}
+
+
+void SizeClassPoolTest::tearDown()
+{
+}
+
+
+CppUnit::Test* SizeClassPoolTest::suite()
+{
+	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("SizeClassPoolTest");
+
+	CppUnit_addTest(pSuite, SizeClassPoolTest, testAllocate);
+	CppUnit_addTest(pSuite, SizeClassPoolTest, testWatermarks);
+	CppUnit_addTest(pSuite, SizeClassPoolTest, testThreads);
+	CppUnit_addTest(pSuite, SizeClassPoolTest, testAllocator);
+
+	return pSuite;
+}
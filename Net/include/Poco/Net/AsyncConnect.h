@@ -0,0 +1,228 @@
+//
+// AsyncConnect.h
+//
+// $Id: //poco/1.4/Net/include/Poco/Net/AsyncConnect.h#1 $
+//
+// Library: Net
+// Package: Reactor
+// Module:  AsyncConnect
+//
+// Definition of the AsyncConnect class.
+//
+// Copyright (c) 2013, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+// 
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+
+#ifndef Net_AsyncConnect_INCLUDED
+#define Net_AsyncConnect_INCLUDED
+
+
+#include "Poco/Net/Net.h"
+#include "Poco/Net/SocketReactor.h"
+#include "Poco/Net/SocketNotification.h"
+#include "Poco/Net/SocketAddress.h"
+#include "Poco/Net/StreamSocket.h"
+#include "Poco/Net/HostEntry.h"
+#include "Poco/RefCountedObject.h"
+#include "Poco/AbstractObserver.h"
+#include "Poco/AutoPtr.h"
+#include "Poco/Mutex.h"
+#include "Poco/Timespan.h"
+#include <vector>
+
+
+namespace Poco {
+namespace Net {
+
+
+class Net_API AsyncConnect: public Poco::RefCountedObject
+	/// AsyncConnect establishes a TCP connection without blocking
+	/// the calling thread. The connect operation is driven by a 
+	/// SocketReactor, so a single thread can have thousands of
+	/// connect operations in flight.
+	///
+	/// An AsyncConnect can be given multiple addresses for a host,
+	/// typically obtained from a HostEntry. The addresses are tried
+	/// in the "Happy Eyeballs" manner (RFC 8305): address families
+	/// are interleaved, starting with IPv6, and if an attempt has not
+	/// succeeded within the attempt delay (default 250 milliseconds),
+	/// the next attempt is started in parallel. If an attempt fails,
+	/// the next one is started immediately. The first attempt to
+	/// succeed wins, and all other attempts are abandoned.
+	///
+	/// Each attempt can be limited by an attempt timeout, and the
+	/// whole operation by the timeout (deadline) given in the
+	/// constructor.
+	///
+	/// On completion, a ConnectNotification is dispatched to the
+	/// observer given in the constructor. This happens exactly
+	/// once, normally in the reactor thread, but in the thread 
+	/// calling start() if all addresses fail immediately, and in
+	/// the thread calling cancel() if the operation is cancelled.
+	/// If the connection has been established, the socket in the
+	/// notification is connected and in blocking mode.
+	///
+	/// The AsyncConnect keeps itself alive until it has completed,
+	/// so the caller does not need to keep a reference to it unless
+	/// it wants to cancel() the operation.
+	///
+	/// Usage:
+	///     Poco::Observer<MyHandler, ConnectNotification> obs(*this, &MyHandler::onConnect);
+	///     AsyncConnect::Ptr pConnect = new AsyncConnect(reactor, DNS::resolve("example.com"), 80, Poco::Timespan(5, 0), obs);
+	///     pConnect->start();
+{
+public:
+	typedef Poco::AutoPtr<AsyncConnect> Ptr;
+	typedef std::vector<SocketAddress> Addresses;
+	
+	enum
+	{
+		DEFAULT_ATTEMPT_DELAY = 250000 /// microseconds
+	};
+
+	AsyncConnect(SocketReactor& reactor, const SocketAddress& address, const Poco::Timespan& timeout, const Poco::AbstractObserver& observer);
+		/// Creates an AsyncConnect for the given address.
+		///
+		/// The observer must accept ConnectNotification.
+		/// A timeout of zero means no deadline.
+		
+	AsyncConnect(SocketReactor& reactor, const HostEntry& host, Poco::UInt16 port, const Poco::Timespan& timeout, const Poco::AbstractObserver& observer);
+		/// Creates an AsyncConnect for all addresses of the
+		/// given host.
+		
+	AsyncConnect(SocketReactor& reactor, const Addresses& addresses, const Poco::Timespan& timeout, const Poco::AbstractObserver& observer);
+		/// Creates an AsyncConnect for the given addresses.
+		
+	void setAttemptDelay(const Poco::Timespan& delay);
+		/// Sets the delay after which the next address is tried
+		/// while previous attempts are still in progress.
+		///
+		/// Must be called before start().
+		
+	const Poco::Timespan& getAttemptDelay() const;
+		/// Returns the attempt delay.
+		
+	void setAttemptTimeout(const Poco::Timespan& timeout);
+		/// Sets the timeout for a single connection attempt.
+		/// An attempt that has not succeeded within the timeout
+		/// fails with POCO_ETIMEDOUT. Zero (the default) means
+		/// attempts are only limited by the overall timeout.
+		///
+		/// Must be called before start().
+		
+	const Poco::Timespan& getAttemptTimeout() const;
+		/// Returns the attempt timeout.
+		
+	const Addresses& addresses() const;
+		/// Returns the addresses in the order in which
+		/// they will be tried.
+		
+	void start();
+		/// Starts the connect operation.
+		
+	void cancel();
+		/// Cancels the connect operation. If the operation
+		/// has not yet completed, a ConnectNotification with
+		/// result CONNECT_CANCELLED is dispatched.
+		
+	bool done() const;
+		/// Returns true if the operation has completed.
+		
+protected:
+	~AsyncConnect();
+		/// Destroys the AsyncConnect.
+	
+	void onWritable(WritableNotification* pNf);
+	void onError(ErrorNotification* pNf);
+	void onAttemptTimeout(TimerNotification* pNf);
+	void onAttemptDelay(TimerNotification* pNf);
+	void onDeadline(TimerNotification* pNf);
+	
+private:
+	AsyncConnect();
+	AsyncConnect(const AsyncConnect&);
+	AsyncConnect& operator = (const AsyncConnect&);
+	
+	struct Attempt
+	{
+		StreamSocket           socket;
+		SocketAddress          address;
+		TimerWheel::Timer::Ptr pTimer;
+	};
+	typedef std::vector<Attempt> Attempts;
+	
+	void init(const Addresses& addresses);
+	void startAttempts();
+	Attempts::iterator findAttempt(const Socket& socket);
+	void failAttempt(const Socket& socket, int error);
+	void removeAttempt(Attempts::iterator it);
+	void complete(ConnectNotification::Result result, const Socket& socket, int error);
+	void notify();
+	
+	SocketReactor&          _reactor;
+	Poco::AbstractObserver* _pObserver;
+	Addresses               _addresses;
+	std::size_t             _next;
+	Attempts                _attempts;
+	Poco::Timespan          _timeout;
+	Poco::Timespan          _attemptDelay;
+	Poco::Timespan          _attemptTimeout;
+	TimerWheel::Timer::Ptr  _pDelayTimer;
+	TimerWheel::Timer::Ptr  _pDeadlineTimer;
+	bool                    _started;
+	bool                    _done;
+	Poco::AutoPtr<ConnectNotification> _pResult;
+	SocketAddress           _lastAddress;
+	int                     _lastError;
+	mutable Poco::Mutex     _mutex;
+};
+
+
+//
+// inlines
+//
+inline const Poco::Timespan& AsyncConnect::getAttemptDelay() const
+{
+	return _attemptDelay;
+}
+
+
+inline const Poco::Timespan& AsyncConnect::getAttemptTimeout() const
+{
+	return _attemptTimeout;
+}
+
+
+inline const AsyncConnect::Addresses& AsyncConnect::addresses() const
+{
+	return _addresses;
+}
+
+
+} } // namespace Poco::Net
+
+
+#endif // Net_AsyncConnect_INCLUDED
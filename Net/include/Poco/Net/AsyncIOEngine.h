@@ -0,0 +1,509 @@
+//
+// AsyncIOEngine.h
+//
+// $Id: //poco/1.4/Net/include/Poco/Net/AsyncIOEngine.h#1 $
+//
+// Library: Net
+// Package: Reactor
+// Module:  AsyncIOEngine
+//
+// Definition of the AsyncIOEngine class.
+//
+// Copyright (c) 2013, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+// 
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+
+
+
+#ifndef Net_AsyncIOEngine_INCLUDED
+#define Net_AsyncIOEngine_INCLUDED
+
+
+#include "Poco/Net/Net.h"
+#include "Poco/Net/StreamSocket.h"
+#include "Poco/Net/ServerSocket.h"
+#include "Poco/RefCountedObject.h"
+#include "Poco/AbstractObserver.h"
+#include "Poco/Notification.h"
+#include "Poco/Runnable.h"
+#include "Poco/Thread.h"
+#include "Poco/Event.h"
+#include "Poco/Mutex.h"
+#include "Poco/AutoPtr.h"
+#include "Poco/Timespan.h"
+#include "Poco/Timestamp.h"
+#include <vector>
+#include <set>
+
+
+namespace Poco {
+namespace Net {
+
+
+class AsyncIOEngine;
+
+
+class Net_API AsyncIOBufferPool: public Poco::RefCountedObject
+	/// A pool of equally sized receive buffers, allocated
+	/// as one contiguous block of memory.
+	///
+	/// An AsyncIOEngine may register the pool's memory with
+	/// the kernel, so that receive operations do not have to
+	/// map the buffers for every operation.
+{
+public:
+	typedef Poco::AutoPtr<AsyncIOBufferPool> Ptr;
+
+	AsyncIOBufferPool(int bufferCount, int bufferSize);
+		/// Creates the AsyncIOBufferPool.
+
+	int bufferCount() const;
+		/// Returns the number of buffers in the pool.
+
+	int bufferSize() const;
+		/// Returns the size of a single buffer.
+
+	char* buffer(int index) const;
+		/// Returns a pointer to the buffer with the given index.
+
+	int acquireBuffer();
+		/// Takes a buffer out of the pool and returns its index,
+		/// or -1 if all buffers are in use.
+
+	void releaseBuffer(int index);
+		/// Returns the buffer with the given index to the pool.
+
+	int availableBuffers() const;
+		/// Returns the number of buffers that are not in use.
+
+protected:
+	~AsyncIOBufferPool();
+
+private:
+	AsyncIOBufferPool();
+	AsyncIOBufferPool(const AsyncIOBufferPool&);
+	AsyncIOBufferPool& operator = (const AsyncIOBufferPool&);
+
+	int               _bufferCount;
+	int               _bufferSize;
+	char*             _pMemory;
+	std::vector<int>  _free;
+	mutable Poco::FastMutex _mutex;
+};
+
+
+class Net_API AsyncIOOperation: public Poco::RefCountedObject
+	/// An asynchronous socket operation started by an AsyncIOEngine.
+	///
+	/// An AsyncIOOperation serves as the future for the operation:
+	/// the caller can wait for its completion and then query
+	/// the result. If an observer has been given when the operation 
+	/// was started, the observer is notified with an AsyncIONotification 
+	/// in the engine's thread when the operation completes, before 
+	/// waiting threads are woken up.
+{
+public:
+	typedef Poco::AutoPtr<AsyncIOOperation> Ptr;
+
+	enum Type
+	{
+		OP_ACCEPT,  /// Accept a connection from a ServerSocket.
+		OP_RECEIVE, /// Receive data into a buffer owned by the operation.
+		OP_SEND,    /// Send all data from a caller-supplied buffer.
+		OP_POLL,    /// Wait until the socket becomes readable.
+		OP_CLOSE    /// Close the socket.
+	};
+
+	Type type() const;
+		/// Returns the type of the operation.
+
+	const Socket& socket() const;
+		/// Returns the socket the operation has been started for.
+
+	bool done() const;
+		/// Returns true if the operation has completed.
+
+	void wait();
+		/// Waits until the operation has completed.
+
+	bool tryWait(long milliseconds);
+		/// Waits up to the given interval for the operation to complete.
+		/// Returns true if the operation has completed.
+
+	int result() const;
+		/// Returns the result of the operation, which depends
+		/// on the type of the operation:
+		///   - OP_ACCEPT:  1
+		///   - OP_RECEIVE: number of bytes received (0 at end of stream)
+		///   - OP_SEND:    number of bytes sent
+		///   - OP_POLL:    1 if the socket is readable, 0 on timeout
+		///   - OP_CLOSE:   0
+		///
+		/// If the operation failed or has been canceled, 
+		/// the result is -1.
+
+	int error() const;
+		/// Returns the native error code if the
+		/// operation failed, or zero otherwise.
+
+	bool canceled() const;
+		/// Returns true if the operation has been canceled.
+
+	void throwOnError() const;
+		/// Throws an appropriate NetException if the 
+		/// operation failed or has been canceled.
+
+	StreamSocket acceptedSocket() const;
+		/// Returns the accepted socket (OP_ACCEPT only).
+
+	const char* data() const;
+		/// Returns the received data (OP_RECEIVE only).
+		///
+		/// The buffer is owned by the operation and stays 
+		/// valid as long as the operation object exists.
+
+protected:
+	AsyncIOOperation(Type type, const Socket& socket, const Poco::AbstractObserver* pObserver);
+	~AsyncIOOperation();
+
+	void complete(int result, int error);
+		/// Stores the result, notifies the observer and
+		/// signals waiting threads.
+
+	void cancel();
+		/// Completes the operation as canceled.
+
+private:
+	AsyncIOOperation();
+	AsyncIOOperation(const AsyncIOOperation&);
+	AsyncIOOperation& operator = (const AsyncIOOperation&);
+
+	Type                    _type;
+	Socket                  _socket;
+	Poco::AbstractObserver* _pObserver;
+	int                     _result;
+	int                     _error;
+	bool                    _canceled;
+	Poco::Event             _event;
+	bool                    _cancelPending;
+
+	// operation-specific state, managed by the engine
+	StreamSocket            _accepted;
+	AsyncIOBufferPool::Ptr  _pPool;
+	int                     _bufferIndex;
+	char*                   _pBuffer;
+	int                     _length;
+	const char*             _pSendBuffer;
+	int                     _sent;
+	Poco::Timespan          _timeout;
+	Poco::Timestamp         _deadline;
+	void*                   _pEngineData;
+
+	friend class AsyncIOEngine;
+	friend class IOUringEngine;
+	friend class EPollEngine;
+};
+
+
+class Net_API AsyncIONotification: public Poco::Notification
+	/// The notification sent to the observer of an
+	/// AsyncIOOperation when the operation completes.
+{
+public:
+	AsyncIONotification(AsyncIOOperation* pOperation);
+		/// Creates the AsyncIONotification.
+
+	AsyncIOOperation* operation() const;
+		/// Returns the completed operation.
+
+protected:
+	~AsyncIONotification();
+
+private:
+	AsyncIOOperation* _pOperation;
+};
+
+
+class Net_API AsyncIOEngine: public Poco::RefCountedObject, protected Poco::Runnable
+	/// AsyncIOEngine is a completion-based I/O engine for stream sockets.
+	///
+	/// Operations (accept, receive, send, poll and close) are 
+	/// started from any thread and complete asynchronously. 
+	/// A single engine thread drives all operations, so an 
+	/// application can serve a large number of connections with 
+	/// one engine per CPU core, instead of one thread per connection.
+	///
+	/// Every operation returns an AsyncIOOperation, which can be
+	/// used to wait for completion and query the result. In addition,
+	/// an observer can be given that is notified in the engine thread
+	/// when the operation completes. Observers should not block, as
+	/// they hold up all other operations of the engine.
+	///
+	/// Two implementations are available on Linux: IOUringEngine, 
+	/// which submits the operations to the kernel via io_uring, and 
+	/// EPollEngine, which performs them with non-blocking system calls 
+	/// when epoll reports the socket as ready. Use create() to obtain 
+	/// the best engine supported by the running kernel.
+	///
+	/// Receive operations use buffers from an AsyncIOBufferPool 
+	/// owned by the engine. If all buffers are in use, a buffer
+	/// is allocated for the operation.
+	///
+	/// While an operation is pending, the socket must not be used 
+	/// for other operations of the same kind outside the engine.
+{
+public:
+	typedef Poco::AutoPtr<AsyncIOEngine> Ptr;
+
+	enum
+	{
+		DEFAULT_BUFFER_COUNT = 256,
+		DEFAULT_BUFFER_SIZE  = 16384
+	};
+
+	static Ptr create(int bufferCount = DEFAULT_BUFFER_COUNT, int bufferSize = DEFAULT_BUFFER_SIZE);
+		/// Creates and returns an IOUringEngine if the running kernel
+		/// supports io_uring and all required operations. Otherwise 
+		/// creates and returns an EPollEngine.
+		///
+		/// The engine must be started with start() before any
+		/// operation can complete.
+		///
+		/// Throws a NotImplementedException on platforms other than Linux.
+
+	virtual std::string name() const = 0;
+		/// Returns the name of the engine implementation.
+
+	void start();
+		/// Starts the engine thread. Operations can only
+		/// be started while the engine thread is running.
+
+	void stop();
+		/// Cancels all pending operations and stops the engine thread.
+
+	bool running() const;
+		/// Returns true if the engine thread is running.
+
+	AsyncIOOperation::Ptr accept(const ServerSocket& socket, const Poco::AbstractObserver* pObserver = 0);
+		/// Accepts a connection on the given listening socket.
+
+	AsyncIOOperation::Ptr receive(const StreamSocket& socket, const Poco::AbstractObserver* pObserver = 0);
+		/// Receives up to bufferSize() bytes from the socket into
+		/// a buffer owned by the operation.
+
+	AsyncIOOperation::Ptr send(const StreamSocket& socket, const void* buffer, int length, const Poco::AbstractObserver* pObserver = 0);
+		/// Sends the given data. The operation completes when all 
+		/// data has been sent, or an error occurs.
+		///
+		/// The buffer is not copied and must stay valid until
+		/// the operation has completed.
+
+	AsyncIOOperation::Ptr poll(const StreamSocket& socket, const Poco::Timespan& timeout, const Poco::AbstractObserver* pObserver = 0);
+		/// Waits up to the given timeout for the socket
+		/// to become readable. A zero timeout waits indefinitely.
+
+	AsyncIOOperation::Ptr close(const StreamSocket& socket, const Poco::AbstractObserver* pObserver = 0);
+		/// Closes the socket. The socket (and all copies of it) 
+		/// become invalid immediately; the native socket is 
+		/// closed asynchronously.
+
+	void cancel(AsyncIOOperation::Ptr pOperation);
+		/// Cancels the given operation if it is still pending.
+		/// The operation completes as canceled, unless it has
+		/// already completed.
+
+	int pending() const;
+		/// Returns the number of pending operations.
+
+	int bufferSize() const;
+		/// Returns the size of the receive buffers.
+
+	int availableBuffers() const;
+		/// Returns the number of receive buffers that
+		/// are not in use by a pending operation.
+
+protected:
+	AsyncIOEngine(int bufferCount, int bufferSize);
+		/// Creates the AsyncIOEngine.
+
+	~AsyncIOEngine();
+		/// Destroys the AsyncIOEngine. 
+
+	virtual void submit(AsyncIOOperation* pOperation) = 0;
+		/// Starts the given operation. Called with the engine's
+		/// lock held, after the operation has been added to the 
+		/// set of pending operations.
+
+	virtual void cancelOperation(AsyncIOOperation* pOperation) = 0;
+		/// Cancels the given pending operation. Called with
+		/// the engine's lock held.
+
+	virtual void wakeUp() = 0;
+		/// Wakes up the engine thread.
+
+	virtual void run() = 0;
+		/// Runs the engine thread until stopping() returns true 
+		/// and no operation is pending.
+
+	bool stopping() const;
+		/// Returns true if stop() has been called.
+
+	void completed(AsyncIOOperation* pOperation, int result, int error);
+		/// Removes the operation from the set of pending
+		/// operations and completes it. Must be called by
+		/// the engine thread without holding the engine's lock.
+
+	void canceled(AsyncIOOperation* pOperation);
+		/// Removes the operation from the set of pending
+		/// operations and completes it as canceled. Must be 
+		/// called by the engine thread without holding the 
+		/// engine's lock.
+
+	AsyncIOBufferPool& bufferPool();
+		/// Returns the pool of receive buffers.
+
+	static poco_socket_t detach(const Socket& socket);
+		/// Takes the native socket out of the socket's SocketImpl,
+		/// leaving the SocketImpl in a closed state.
+
+	mutable Poco::FastMutex _mutex;
+
+private:
+	AsyncIOEngine();
+	AsyncIOEngine(const AsyncIOEngine&);
+	AsyncIOEngine& operator = (const AsyncIOEngine&);
+
+	AsyncIOOperation::Ptr startOperation(AsyncIOOperation* pOperation);
+	bool remove(AsyncIOOperation* pOperation);
+
+	typedef std::set<AsyncIOOperation*> OperationSet;
+
+	AsyncIOBufferPool::Ptr _pPool;
+	OperationSet           _pending;
+	Poco::Thread           _thread;
+	bool                   _stopping;
+};
+
+
+//
+// inlines
+//
+inline int AsyncIOBufferPool::bufferCount() const
+{
+	return _bufferCount;
+}
+
+
+inline int AsyncIOBufferPool::bufferSize() const
+{
+	return _bufferSize;
+}
+
+
+inline char* AsyncIOBufferPool::buffer(int index) const
+{
+	poco_assert_dbg (index >= 0 && index < _bufferCount);
+
+	return _pMemory + static_cast<std::size_t>(index)*_bufferSize;
+}
+
+
+inline AsyncIOOperation::Type AsyncIOOperation::type() const
+{
+	return _type;
+}
+
+
+inline const Socket& AsyncIOOperation::socket() const
+{
+	return _socket;
+}
+
+
+inline int AsyncIOOperation::result() const
+{
+	return _result;
+}
+
+
+inline int AsyncIOOperation::error() const
+{
+	return _error;
+}
+
+
+inline bool AsyncIOOperation::canceled() const
+{
+	return _canceled;
+}
+
+
+inline StreamSocket AsyncIOOperation::acceptedSocket() const
+{
+	return _accepted;
+}
+
+
+inline const char* AsyncIOOperation::data() const
+{
+	return _pBuffer;
+}
+
+
+inline AsyncIOOperation* AsyncIONotification::operation() const
+{
+	return _pOperation;
+}
+
+
+inline bool AsyncIOEngine::stopping() const
+{
+	return _stopping;
+}
+
+
+inline AsyncIOBufferPool& AsyncIOEngine::bufferPool()
+{
+	return *_pPool;
+}
+
+
+inline int AsyncIOEngine::bufferSize() const
+{
+	return _pPool->bufferSize();
+}
+
+
+inline int AsyncIOEngine::availableBuffers() const
+{
+	return _pPool->availableBuffers();
+}
+
+
+} } // namespace Poco::Net
+
+
+#endif // Net_AsyncIOEngine_INCLUDED
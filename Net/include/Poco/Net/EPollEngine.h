@@ -0,0 +1,126 @@
+//
+// EPollEngine.h
+//
+// $Id: //poco/1.4/Net/include/Poco/Net/EPollEngine.h#1 $
+//
+// Library: Net
+// Package: Reactor
+// Module:  EPollEngine
+//
+// Definition of the EPollEngine class.
+//
+// Copyright (c) 2013, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+// 
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+
+
+
+#ifndef Net_EPollEngine_INCLUDED
+#define Net_EPollEngine_INCLUDED
+
+
+#include "Poco/Net/Net.h"
+#include "Poco/Net/AsyncIOEngine.h"
+#include <deque>
+#include <map>
+
+
+namespace Poco {
+namespace Net {
+
+
+class Net_API EPollEngine: public AsyncIOEngine
+	/// An AsyncIOEngine that waits for sockets to become
+	/// ready with epoll, and then performs the operations
+	/// with non-blocking system calls.
+	///
+	/// This is the fallback for kernels without io_uring 
+	/// support (see AsyncIOEngine::create()).
+{
+public:
+	EPollEngine(int bufferCount = DEFAULT_BUFFER_COUNT, int bufferSize = DEFAULT_BUFFER_SIZE);
+		/// Creates the EPollEngine.
+		///
+		/// Throws a NotImplementedException on platforms other than Linux.
+
+	std::string name() const;
+		/// Returns "epoll".
+
+protected:
+	~EPollEngine();
+
+	void submit(AsyncIOOperation* pOperation);
+	void cancelOperation(AsyncIOOperation* pOperation);
+	void wakeUp();
+	void run();
+
+private:
+	typedef std::deque<AsyncIOOperation*> Queue;
+
+	struct Watch
+	{
+		Watch(): events(0)
+		{
+		}
+
+		Queue    readers;
+		Queue    writers;
+		unsigned events;
+	};
+
+	struct Result
+	{
+		AsyncIOOperation* pOperation;
+		int               result;
+		int               error;
+		bool              canceled;
+	};
+
+	typedef std::vector<Watch> Watches;
+	typedef std::vector<Result> Results;
+	typedef std::multimap<Poco::Timestamp, AsyncIOOperation*> Deadlines;
+
+	static int fd(AsyncIOOperation* pOperation);
+	void update(int fd);
+	void done(AsyncIOOperation* pOperation, int result, int error, bool canceled = false);
+	void dequeue(AsyncIOOperation* pOperation);
+	void processReaders(int fd);
+	void processWriters(int fd);
+	void expire(const Poco::Timestamp& now);
+	int nextTimeout(const Poco::Timestamp& now) const;
+
+	int       _epollfd;
+	int       _eventfd;
+	Watches   _watches;
+	Deadlines _deadlines;
+	Results   _results;
+};
+
+
+} } // namespace Poco::Net
+
+
+#endif // Net_EPollEngine_INCLUDED
@@ -222,9 +222,43 @@ public:
 		/// The InputLineEndingConverter class from the Foundation
 		/// library can be used for that purpose.
 		
+	std::istream& beginDownload(const std::string& path, Poco::UInt64 offset);
+		/// Starts downloading the file with the given name,
+		/// beginning at the given byte offset.
+		///
+		/// Sends a REST command with the offset as argument
+		/// immediately before the RETR command. Otherwise,
+		/// works like beginDownload(const std::string&).
+		///
+		/// Only binary (TYPE_BINARY) transfers should be
+		/// restarted, as the offset refers to the file's
+		/// representation on the server.
+		
 	void endDownload();
 		/// Must be called to complete a download initiated with
 		/// beginDownload().
+
+	void cancelTransfer();
+		/// Closes the data connection of the download or directory
+		/// listing currently in progress, and waits for the server's
+		/// reply to the closed connection.
+		///
+		/// Unlike abort(), no ABOR command is sent. The server's reply
+		/// is accepted regardless of its status code, as it depends on
+		/// whether the server has finished sending the data before noticing 
+		/// the closed connection. This is used to stop a download 
+		/// after a part of a file has been received.
+
+	Poco::UInt64 fileSize(const std::string& path);
+		/// Returns the size of the file with the given name,
+		/// in bytes, as transferred with the current file type.
+		///
+		/// Sends a SIZE command (RFC 3659) with path as argument
+		/// to the server.
+		///
+		/// Throws a FTPException in case of a FTP-specific error, 
+		/// e.g. if the server does not support the SIZE command, or a
+		/// NetException in case of a general network communication failure.
 		
 	std::ostream& beginUpload(const std::string& path);
 		/// Starts uploading the file with the given name.
@@ -320,9 +354,10 @@ protected:
 	static bool isTransientNegative(int status);
 	static bool isPermanentNegative(int status);
 	std::string extractPath(const std::string& response);
-	StreamSocket establishDataConnection(const std::string& command, const std::string& arg);
-	StreamSocket activeDataConnection(const std::string& command, const std::string& arg);
-	StreamSocket passiveDataConnection(const std::string& command, const std::string& arg);
+	StreamSocket establishDataConnection(const std::string& command, const std::string& arg, Poco::UInt64 restartOffset = 0);
+	StreamSocket activeDataConnection(const std::string& command, const std::string& arg, Poco::UInt64 restartOffset = 0);
+	StreamSocket passiveDataConnection(const std::string& command, const std::string& arg, Poco::UInt64 restartOffset = 0);
+	void sendREST(Poco::UInt64 offset);
 	void sendPortCommand(const SocketAddress& addr);
 	SocketAddress sendPassiveCommand();
 	bool sendEPRT(const SocketAddress& addr);
@@ -0,0 +1,177 @@
+//
+// FTPTransferManager.h
+//
+// $Id: //poco/1.4/Net/include/Poco/Net/FTPTransferManager.h#1 $
+//
+// Library: Net
+// Package: FTP
+// Module:  FTPTransferManager
+//
+// Definition of the FTPTransferManager class.
+//
+// Copyright (c) 2013, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+// 
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+
+
+
+#ifndef Net_FTPTransferManager_INCLUDED
+#define Net_FTPTransferManager_INCLUDED
+
+
+#include "Poco/Net/Net.h"
+#include "Poco/Net/FTPClientSession.h"
+#include "Poco/Timespan.h"
+
+
+namespace Poco {
+namespace Net {
+
+
+class Net_API FTPTransferManager
+	/// FTPTransferManager downloads large files from a FTP server
+	/// over multiple connections in parallel.
+	///
+	/// The file is split into segments, one per connection, and
+	/// every segment is downloaded over its own control and data
+	/// connection, using a REST command to start the transfer 
+	/// at the segment's offset. Each connection writes its segment 
+	/// directly to its position in the local file, so no reassembly 
+	/// step is required.
+	///
+	/// The progress of every segment is recorded in a state file
+	/// next to the local file (see stateFileName()). If a download 
+	/// fails or is interrupted, the data received so far is kept, 
+	/// and a subsequent call to download() with the same arguments 
+	/// resumes the download where it has been interrupted. The state 
+	/// file is removed once the download is complete.
+	///
+	/// If the local file already exists and no state file is present, 
+	/// the local file is assumed to contain the beginning of the remote
+	/// file, and only the remaining part is downloaded.
+	///
+	/// The server must support the SIZE (RFC 3659) and REST commands,
+	/// and passive mode. Files are always transferred in binary mode.
+{
+public:
+	FTPTransferManager(const std::string& host, Poco::UInt16 port = FTPClientSession::FTP_PORT);
+		/// Creates a FTPTransferManager for the given server.
+
+	~FTPTransferManager();
+		/// Destroys the FTPTransferManager.
+
+	void setCredentials(const std::string& username, const std::string& password);
+		/// Sets the user name and password used to log in.
+		/// The default is an anonymous login.
+
+	void setConnections(int connections);
+		/// Sets the maximum number of parallel connections
+		/// used for a download. The default is 4.
+
+	int getConnections() const;
+		/// Returns the maximum number of parallel connections.
+
+	void setMinimumSegmentSize(Poco::UInt64 size);
+		/// Sets the minimum size of a segment. Files smaller than 
+		/// twice this size are downloaded over a single connection.
+		/// The default is 1 MB.
+
+	Poco::UInt64 getMinimumSegmentSize() const;
+		/// Returns the minimum size of a segment.
+
+	void setTimeout(const Poco::Timespan& timeout);
+		/// Sets the timeout for socket operations.
+
+	Poco::Timespan getTimeout() const;
+		/// Returns the timeout for socket operations.
+
+	Poco::UInt64 download(const std::string& remotePath, const std::string& localPath);
+		/// Downloads the file given by remotePath to localPath,
+		/// or resumes an interrupted download of that file.
+		///
+		/// Returns the number of bytes received by this call,
+		/// which is less than the file size if a download has
+		/// been resumed.
+		///
+		/// Throws a FTPException in case of a FTP-specific error, or a
+		/// NetException in case of a general network communication failure.
+		/// If at least one connection succeeds, segments of failed 
+		/// connections are taken over by the remaining connections.
+		/// If the download cannot be completed, the state file is kept,
+		/// and the exception of the first failed connection is rethrown.
+
+	static std::string stateFileName(const std::string& localPath);
+		/// Returns the name of the state file for the given local
+		/// file, which is the local file name with ".ftpstate" appended.
+
+protected:
+	FTPClientSession* createSession();
+		/// Creates a session, logs in, and switches 
+		/// to binary mode.
+
+private:
+	struct Transfer;
+	class Worker;
+
+	FTPTransferManager();
+	FTPTransferManager(const FTPTransferManager&);
+	FTPTransferManager& operator = (const FTPTransferManager&);
+
+	std::string    _host;
+	Poco::UInt16   _port;
+	std::string    _username;
+	std::string    _password;
+	int            _connections;
+	Poco::UInt64   _minSegmentSize;
+	Poco::Timespan _timeout;
+};
+
+
+//
+// inlines
+//
+inline int FTPTransferManager::getConnections() const
+{
+	return _connections;
+}
+
+
+inline Poco::UInt64 FTPTransferManager::getMinimumSegmentSize() const
+{
+	return _minSegmentSize;
+}
+
+
+inline Poco::Timespan FTPTransferManager::getTimeout() const
+{
+	return _timeout;
+}
+
+
+} } // namespace Poco::Net
+
+
+#endif // Net_FTPTransferManager_INCLUDED
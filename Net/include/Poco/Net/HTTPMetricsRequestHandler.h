@@ -0,0 +1,96 @@
+//
+// HTTPMetricsRequestHandler.h
+//
+// $Id: //poco/1.4/Net/include/Poco/Net/HTTPMetricsRequestHandler.h#1 $
+//
+// Library: Net
+// Package: HTTPServer
+// Module:  HTTPMetricsRequestHandler
+//
+// Definition of the HTTPMetricsRequestHandler class.
+//
+// Copyright (c) 2013, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+// 
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+
+#ifndef Net_HTTPMetricsRequestHandler_INCLUDED
+#define Net_HTTPMetricsRequestHandler_INCLUDED
+
+
+#include "Poco/Net/Net.h"
+#include "Poco/Net/HTTPRequestHandler.h"
+#include "Poco/Net/HTTPServerMetrics.h"
+#include <ostream>
+
+
+namespace Poco {
+namespace Net {
+
+
+class Net_API HTTPMetricsRequestHandler: public HTTPRequestHandler
+	/// A HTTPRequestHandler that renders a snapshot of
+	/// a HTTPServerMetrics object in a simple text format
+	/// suitable for scraping by monitoring systems.
+	///
+	/// Every line of the output has the form
+	///     <name>[{<label>="<value>"}] <value>
+	/// with lines starting with '#' being comments. 
+	/// Histograms are written as summaries, consisting
+	/// of the 50th, 90th, 99th and 99.9th percentiles, 
+	/// as well as count, sum and maximum. 
+	/// Times are given in microseconds.
+	///
+	/// Example:
+	///     http_server_requests_in_flight 2
+	///     http_server_responses_total{status="200"} 1024
+	///     http_server_handler_time_us{quantile="0.99"} 1503
+	///     http_server_handler_time_us_count 1024
+{
+public:
+	HTTPMetricsRequestHandler(HTTPServerMetrics::Ptr pMetrics);
+		/// Creates the HTTPMetricsRequestHandler for the given metrics.
+
+	~HTTPMetricsRequestHandler();
+		/// Destroys the HTTPMetricsRequestHandler.
+
+	void handleRequest(HTTPServerRequest& request, HTTPServerResponse& response);
+		/// Sends the current metrics as a text/plain response.
+		
+	static void write(const HTTPServerMetrics::Snapshot& snapshot, std::ostream& ostr);
+		/// Writes the given snapshot in the text format to ostr.
+
+protected:
+	static void writeHistogram(const std::string& name, const HTTPServerMetrics::Histogram& histogram, std::ostream& ostr);
+
+private:
+	HTTPServerMetrics::Ptr _pMetrics;
+};
+
+
+} } // namespace Poco::Net
+
+
+#endif // Net_HTTPMetricsRequestHandler_INCLUDED
@@ -44,12 +44,18 @@
 #include "Poco/Net/TCPServer.h"
 #include "Poco/Net/HTTPRequestHandlerFactory.h"
 #include "Poco/Net/HTTPServerParams.h"
+#include "Poco/Net/AsyncIOEngine.h"
+#include "Poco/Mutex.h"
+#include <set>
 
 
 namespace Poco {
 namespace Net {
 
 
+class HTTPServerSession;
+
+
 class Net_API HTTPServer: public TCPServer
 	/// A subclass of TCPServer that implements a
 	/// full-featured multithreaded HTTP server.
@@ -67,7 +73,9 @@ class Net_API HTTPServer: public TCPServer
 	///     using chunked transfer encoding.
 	///
 	/// Please see the TCPServer class for information about
-	/// connection and thread handling.
+	/// connection and thread handling. If an AsyncIOEngine has been
+	/// set in the HTTPServerParams, idle persistent connections do
+	/// not occupy a thread while they wait for the next request.
 	///
 	/// See RFC 2616 <http://www.faqs.org/rfcs/rfc2616.html> for more
 	/// information about the HTTP protocol.
@@ -106,8 +114,30 @@ public:
 		/// all client connections are shut down, causing all requests
 		/// to abort.
 
+protected:
+	bool parkConnection(HTTPServerSession& session);
+		/// Hands an idle persistent connection over to the AsyncIOEngine, 
+		/// which waits for the next request. Returns false if there
+		/// is no running engine.
+		///
+		/// Called by HTTPServerConnection.
+
+	void unparkConnections();
+		/// Closes all connections waiting in the AsyncIOEngine.
+
+	void onConnectionReadable(AsyncIONotification* pNf);
+
 private:
+	typedef std::set<AsyncIOOperation::Ptr> Operations;
+
 	HTTPRequestHandlerFactory::Ptr _pFactory;
+	AsyncIOEngine::Ptr _pEngine;
+	Poco::Timespan     _keepAliveTimeout;
+	Operations         _parked;
+	bool               _parking;
+	Poco::FastMutex    _parkMutex;
+
+	friend class HTTPServerConnection;
 };
 
 
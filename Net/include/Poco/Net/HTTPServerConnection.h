@@ -53,6 +53,7 @@ namespace Net {
 
 
 class HTTPServerSession;
+class HTTPServer;
 
 
 class Net_API HTTPServerConnection: public TCPServerConnection
@@ -60,8 +61,12 @@ class Net_API HTTPServerConnection: public TCPServerConnection
 	/// connections.
 {
 public:
-	HTTPServerConnection(const StreamSocket& socket, HTTPServerParams::Ptr pParams, HTTPRequestHandlerFactory::Ptr pFactory);
+	HTTPServerConnection(const StreamSocket& socket, HTTPServerParams::Ptr pParams, HTTPRequestHandlerFactory::Ptr pFactory, HTTPServer* pServer = 0);
 		/// Creates the HTTPServerConnection.
+		///
+		/// If a server is given, the connection is handed over
+		/// to the server when it becomes idle (see 
+		/// HTTPServerParams::setIOEngine()).
 
 	virtual ~HTTPServerConnection();
 		/// Destroys the HTTPServerConnection.
@@ -76,6 +81,7 @@ protected:
 private:
 	HTTPServerParams::Ptr          _pParams;
 	HTTPRequestHandlerFactory::Ptr _pFactory;
+	HTTPServer* _pServer;
 	bool _stopped;
 	Poco::FastMutex _mutex;
 };
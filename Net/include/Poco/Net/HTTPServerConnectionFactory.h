@@ -50,13 +50,20 @@ namespace Poco {
 namespace Net {
 
 
+class HTTPServer;
+
+
 class Net_API HTTPServerConnectionFactory: public TCPServerConnectionFactory
 	/// This implementation of a TCPServerConnectionFactory
 	/// is used by HTTPServer to create HTTPServerConnection objects.
 {
 public:
-	HTTPServerConnectionFactory(HTTPServerParams::Ptr pParams, HTTPRequestHandlerFactory::Ptr pFactory);
+	HTTPServerConnectionFactory(HTTPServerParams::Ptr pParams, HTTPRequestHandlerFactory::Ptr pFactory, HTTPServer* pServer = 0);
 		/// Creates the HTTPServerConnectionFactory.
+		///
+		/// If a server is given, connections can hand over
+		/// idle persistent connections to the server (see
+		/// HTTPServerParams::setIOEngine()).
 
 	~HTTPServerConnectionFactory();
 		/// Destroys the HTTPServerConnectionFactory.
@@ -68,6 +75,7 @@ public:
 private:
 	HTTPServerParams::Ptr          _pParams;
 	HTTPRequestHandlerFactory::Ptr _pFactory;
+	HTTPServer*                    _pServer;
 };
 
 
@@ -0,0 +1,294 @@
+//
+// HTTPServerMetrics.h
+//
+// $Id: //poco/1.4/Net/include/Poco/Net/HTTPServerMetrics.h#1 $
+//
+// Library: Net
+// Package: HTTPServer
+// Module:  HTTPServerMetrics
+//
+// Definition of the HTTPServerMetrics class.
+//
+// Copyright (c) 2013, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+// 
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+
+#ifndef Net_HTTPServerMetrics_INCLUDED
+#define Net_HTTPServerMetrics_INCLUDED
+
+
+#include "Poco/Net/Net.h"
+#include "Poco/RefCountedObject.h"
+#include "Poco/AutoPtr.h"
+#include "Poco/AtomicCounter.h"
+#include "Poco/Timestamp.h"
+#include "Poco/Mutex.h"
+#include <map>
+
+
+namespace Poco {
+namespace Net {
+
+
+class Net_API HTTPServerMetrics: public Poco::RefCountedObject
+	/// HTTPServerMetrics collects per-request statistics for
+	/// a HTTPServer.
+	///
+	/// For every request handled, the following values are
+	/// recorded:
+	///   - the time needed to receive and parse the request header,
+	///   - the time spent in the request handler,
+	///   - the number of bytes received and sent, and
+	///   - the HTTP status code of the response.
+	///
+	/// Times and sizes are recorded in log-linear (HDR-style)
+	/// histograms, so that percentiles can be computed with a
+	/// bounded relative error. The number of requests currently
+	/// being handled is available as well.
+	///
+	/// To keep the overhead low, every worker thread records
+	/// into its own stripe of histograms. A stripe is only
+	/// touched by the worker threads mapped to it, so its mutex
+	/// is practically never contended. The stripes are merged
+	/// only when a snapshot is taken.
+	///
+	/// To enable metrics, create a HTTPServerMetrics object
+	/// and pass it to HTTPServerParams::setMetrics() before
+	/// the HTTPServer is created. A HTTPMetricsRequestHandler
+	/// can be used to expose the collected data.
+{
+public:
+	typedef Poco::AutoPtr<HTTPServerMetrics> Ptr;
+
+	class Net_API Histogram
+		/// A log-linear histogram of non-negative integer values.
+		///
+		/// Values smaller than SUB_BUCKETS are counted exactly.
+		/// Above that, every power-of-two range is divided into
+		/// SUB_BUCKETS buckets of equal width, giving a relative
+		/// error of at most 1/SUB_BUCKETS for any percentile.
+		/// Values larger than or equal to 2^MAX_VALUE_BITS are 
+		/// counted in the last bucket.
+		///
+		/// Histogram is not thread safe.
+	{
+	public:
+		enum
+		{
+			SUB_BUCKET_BITS = 4,
+			SUB_BUCKETS     = 1 << SUB_BUCKET_BITS,
+			MAX_VALUE_BITS  = 40,
+			BUCKET_COUNT    = (MAX_VALUE_BITS - SUB_BUCKET_BITS + 1)*SUB_BUCKETS
+		};
+		
+		Histogram();
+			/// Creates an empty Histogram.
+
+		void record(Poco::UInt64 value);
+			/// Records the given value.
+
+		void merge(const Histogram& histogram);
+			/// Adds all values recorded in the given histogram
+			/// to this histogram.
+
+		void reset();
+			/// Removes all recorded values.
+
+		Poco::UInt64 count() const;
+			/// Returns the number of recorded values.
+			
+		Poco::UInt64 sum() const;
+			/// Returns the sum of all recorded values.
+
+		Poco::UInt64 min() const;
+			/// Returns the smallest recorded value, or 0
+			/// if the histogram is empty.
+
+		Poco::UInt64 max() const;
+			/// Returns the largest recorded value, or 0
+			/// if the histogram is empty.
+
+		double mean() const;
+			/// Returns the arithmetic mean of all recorded values,
+			/// or 0 if the histogram is empty.
+
+		Poco::UInt64 percentile(double percent) const;
+			/// Returns the value below or at which the given 
+			/// percentage (0 - 100) of all recorded values lies.
+			///
+			/// The returned value is the upper bound of the bucket
+			/// containing the percentile, but never larger than max().
+
+		Poco::UInt64 bucket(int index) const;
+			/// Returns the number of values recorded in the bucket
+			/// with the given index.
+
+		static int bucketIndex(Poco::UInt64 value);
+			/// Returns the index of the bucket the given value is
+			/// counted in.
+
+		static Poco::UInt64 lowerBound(int index);
+			/// Returns the smallest value counted in the bucket
+			/// with the given index.
+
+		static Poco::UInt64 upperBound(int index);
+			/// Returns the largest value counted in the bucket
+			/// with the given index.
+
+	private:
+		Poco::UInt64 _buckets[BUCKET_COUNT];
+		Poco::UInt64 _count;
+		Poco::UInt64 _sum;
+		Poco::UInt64 _min;
+		Poco::UInt64 _max;
+	};
+
+	typedef std::map<int, Poco::UInt64> StatusCounts;
+
+	struct Snapshot
+		/// A consistent copy of the metrics at a given point in time.
+	{
+		Poco::Timestamp timestamp;   /// Time the snapshot was taken.
+		Poco::Timestamp startTime;   /// Time the metrics were created or last reset.
+		int             inFlight;    /// Number of requests currently being handled.
+		Poco::UInt64    requests;    /// Number of completed requests.
+		Histogram       parseTime;   /// Request header receive/parse times in microseconds.
+		Histogram       handlerTime; /// Request handler times in microseconds.
+		Histogram       bytesIn;     /// Number of bytes received per request.
+		Histogram       bytesOut;    /// Number of bytes sent per request.
+		StatusCounts    statusCounts;/// Number of responses per HTTP status code.
+	};
+
+	HTTPServerMetrics();
+		/// Creates the HTTPServerMetrics.
+
+	void requestStarted();
+		/// Must be called when a request header has been received
+		/// and the request is dispatched to a handler.
+
+	void requestCompleted(Poco::Timestamp::TimeDiff parseTime, Poco::Timestamp::TimeDiff handlerTime, Poco::UInt64 bytesIn, Poco::UInt64 bytesOut, int status);
+		/// Must be called when a request started with requestStarted()
+		/// has been handled. Times are given in microseconds.
+		
+	void requestRejected(int status);
+		/// Counts a response with the given status that has been
+		/// sent without a request handler being involved (e.g.,
+		/// for a malformed request).
+
+	int inFlight() const;
+		/// Returns the number of requests currently being handled.
+
+	void snapshot(Snapshot& snapshot) const;
+		/// Stores a merged copy of the current metrics in snapshot.
+
+	void reset();
+		/// Discards all recorded values, except the number
+		/// of requests in flight.
+
+protected:
+	~HTTPServerMetrics();
+		/// Destroys the HTTPServerMetrics.
+
+	enum
+	{
+		STRIPES     = 16,
+		MIN_STATUS  = 100,
+		MAX_STATUS  = 599
+	};
+
+	struct Stripe
+	{
+		Stripe();
+
+		Poco::FastMutex mutex;
+		Histogram       parseTime;
+		Histogram       handlerTime;
+		Histogram       bytesIn;
+		Histogram       bytesOut;
+		Poco::UInt64    statusCounts[MAX_STATUS - MIN_STATUS + 2];
+	};
+
+	Stripe& stripe() const;
+		/// Returns the stripe for the calling thread.
+
+	static int statusIndex(int status);
+
+private:
+	HTTPServerMetrics(const HTTPServerMetrics&);
+	HTTPServerMetrics& operator = (const HTTPServerMetrics&);
+
+	mutable Stripe      _stripes[STRIPES];
+	Poco::AtomicCounter _inFlight;
+	Poco::Timestamp     _startTime;
+	mutable Poco::FastMutex _mutex;
+};
+
+
+//
+// inlines
+//
+inline Poco::UInt64 HTTPServerMetrics::Histogram::count() const
+{
+	return _count;
+}
+
+
+inline Poco::UInt64 HTTPServerMetrics::Histogram::sum() const
+{
+	return _sum;
+}
+
+
+inline Poco::UInt64 HTTPServerMetrics::Histogram::min() const
+{
+	return _count > 0 ? _min : 0;
+}
+
+
+inline Poco::UInt64 HTTPServerMetrics::Histogram::max() const
+{
+	return _max;
+}
+
+
+inline Poco::UInt64 HTTPServerMetrics::Histogram::bucket(int index) const
+{
+	poco_assert (index >= 0 && index < BUCKET_COUNT);
+
+	return _buckets[index];
+}
+
+
+inline int HTTPServerMetrics::inFlight() const
+{
+	return _inFlight.value();
+}
+
+
+} } // namespace Poco::Net
+
+
+#endif // Net_HTTPServerMetrics_INCLUDED
@@ -42,6 +42,8 @@
 
 #include "Poco/Net/Net.h"
 #include "Poco/Net/TCPServerParams.h"
+#include "Poco/Net/HTTPServerMetrics.h"
+#include "Poco/Net/AsyncIOEngine.h"
 
 
 namespace Poco {
@@ -117,6 +119,49 @@ public:
 		/// during a persistent connection, or 0 if
 		/// unlimited connections are allowed.
 
+	void setMetrics(HTTPServerMetrics::Ptr pMetrics);
+		/// Sets the HTTPServerMetrics object that collects
+		/// statistics about every request handled by the server.
+		///
+		/// Metrics are disabled by default, and collecting them
+		/// is only possible if a HTTPServerMetrics object has been
+		/// set before the server is started.
+
+	HTTPServerMetrics::Ptr getMetrics() const;
+		/// Returns the HTTPServerMetrics object, or a null pointer
+		/// if no metrics are collected.
+
+	void setIOEngine(AsyncIOEngine::Ptr pEngine);
+		/// Sets the AsyncIOEngine that waits for further requests
+		/// on idle persistent connections.
+		///
+		/// By default, a persistent connection occupies a server thread
+		/// while it waits for the next request. If an engine is set, 
+		/// the connection is handed over to the engine after a response
+		/// has been sent, and is only given back to a server thread when
+		/// the next request arrives. This allows a server to keep a large
+		/// number of idle connections open with a small number of threads.
+		///
+		/// Connections are only handed over if the number of requests
+		/// per connection is unlimited (see setMaxKeepAliveRequests()).
+		/// The engine must be running while the server is running.
+
+	AsyncIOEngine::Ptr getIOEngine() const;
+		/// Returns the AsyncIOEngine for idle persistent connections,
+		/// or a null pointer if none has been set.
+
+	void setArenaBlockSize(std::size_t blockSize);
+		/// Sets the block size of the Poco::Arena that every
+		/// connection provides to request handlers (see
+		/// HTTPServerRequest::arena()), or 0 to provide none.
+		///
+		/// The default is Poco::Arena::DEFAULT_BLOCK_SIZE. Memory
+		/// is only allocated if a handler makes use of the arena.
+
+	std::size_t getArenaBlockSize() const;
+		/// Returns the block size of the request arena,
+		/// or 0 if handlers are not given an arena.
+
 protected:
 	virtual ~HTTPServerParams();
 		/// Destroys the HTTPServerParams.
@@ -128,6 +173,9 @@ private:
 	bool           _keepAlive;
 	int            _maxKeepAliveRequests;
 	Poco::Timespan _keepAliveTimeout;
+	HTTPServerMetrics::Ptr _pMetrics;
+	AsyncIOEngine::Ptr _pEngine;
+	std::size_t    _arenaBlockSize;
 };
 
 
@@ -170,6 +218,24 @@ inline const Poco::Timespan& HTTPServerParams::getKeepAliveTimeout() const
 }
 
 
+inline HTTPServerMetrics::Ptr HTTPServerParams::getMetrics() const
+{
+	return _pMetrics;
+}
+
+
+inline std::size_t HTTPServerParams::getArenaBlockSize() const
+{
+	return _arenaBlockSize;
+}
+
+
+inline AsyncIOEngine::Ptr HTTPServerParams::getIOEngine() const
+{
+	return _pEngine;
+}
+
+
 } } // namespace Poco::Net
 
 
@@ -47,6 +47,11 @@
 
 
 namespace Poco {
+
+
+class Arena;
+
+
 namespace Net {
 
 
@@ -91,6 +96,18 @@ public:
 
 	virtual HTTPServerResponse& response() const = 0;
 		/// Returns a reference to the associated response.
+
+	virtual Poco::Arena* arena() const;
+		/// Returns an Arena that the request handler can use
+		/// for memory that is only needed while handling the
+		/// request, or a null pointer if none is available.
+		///
+		/// The Arena is reset as soon as the request has been handled,
+		/// before the connection waits for the next request, so the
+		/// handler must destroy all objects created in arena memory
+		/// before it returns.
+		///
+		/// The default implementation returns a null pointer.
 };
 
 
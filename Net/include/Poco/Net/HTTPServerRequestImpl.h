@@ -65,9 +65,10 @@ class Net_API HTTPServerRequestImpl: public HTTPServerRequest
 	/// handleRequest() method of HTTPRequestHandler.
 {
 public:
-	HTTPServerRequestImpl(HTTPServerResponseImpl& response, HTTPServerSession& session, HTTPServerParams* pParams);
+	HTTPServerRequestImpl(HTTPServerResponseImpl& response, HTTPServerSession& session, HTTPServerParams* pParams, Poco::Arena* pArena = 0);
 		/// Creates the HTTPServerRequestImpl, using the
-		/// given HTTPServerSession.
+		/// given HTTPServerSession and, if given, the
+		/// Arena provided to request handlers.
 
 	~HTTPServerRequestImpl();
 		/// Destroys the HTTPServerRequestImpl.
@@ -94,6 +95,10 @@ public:
 
 	HTTPServerResponse& response() const;
 		/// Returns a reference to the associated response.
+
+	Poco::Arena* arena() const;
+		/// Returns the Arena for request-scoped allocations,
+		/// or a null pointer if none is available.
 		
 	StreamSocket& socket();
 		/// Returns a reference to the underlying socket.
@@ -112,6 +117,7 @@ private:
 	Poco::AutoPtr<HTTPServerParams> _pParams;
 	SocketAddress                   _clientAddress;
 	SocketAddress                   _serverAddress;
+	Poco::Arena*                    _pArena;
 };
 
 
@@ -138,6 +144,12 @@ inline const SocketAddress& HTTPServerRequestImpl::serverAddress() const
 }
 
 
+inline Poco::Arena* HTTPServerRequestImpl::arena() const
+{
+	return _pArena;
+}
+
+
 inline const HTTPServerParams& HTTPServerRequestImpl::serverParams() const
 {
 	return *_pParams;
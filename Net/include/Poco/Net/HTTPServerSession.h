@@ -69,6 +69,11 @@ public:
 	
 	bool canKeepAlive() const;
 		/// Returns true if the session can be kept alive.
+
+	bool idle() const;
+		/// Returns true if the session is kept alive without a
+		/// limit on the number of requests, and no data of the 
+		/// next request has been received yet.
 	
 	SocketAddress clientAddress();
 		/// Returns the client's address.
@@ -92,6 +97,12 @@ inline bool HTTPServerSession::canKeepAlive() const
 }
 
 
+inline bool HTTPServerSession::idle() const
+{
+	return !_firstRequest && getKeepAlive() && _maxKeepAliveRequests < 0 && buffered() == 0;
+}
+
+
 } } // namespace Poco::Net
 
 
@@ -121,6 +121,14 @@ public:
 	StreamSocket& socket();
 		/// Returns a reference to the underlying socket.
 
+	Poco::UInt64 bytesSent() const;
+		/// Returns the total number of bytes sent over
+		/// the underlying socket by this session.
+
+	Poco::UInt64 bytesReceived() const;
+		/// Returns the total number of bytes received
+		/// from the underlying socket by this session.
+
 protected:
 	HTTPSession();
 		/// Creates a HTTP session using an
@@ -162,6 +170,13 @@ protected:
 	virtual int write(const char* buffer, std::streamsize length);
 		/// Writes data to the socket.
 
+	Poco::Int64 sendFile(const std::string& path, Poco::UInt64 offset, Poco::UInt64 count);
+		/// Sends a part of a file over the socket, without copying
+		/// the data to user space, if supported.
+		///
+		/// Returns the number of bytes sent, or -1 if not supported
+		/// (see StreamSocket::sendFile()).
+
 	int receive(char* buffer, int length);
 		/// Reads up to length bytes.
 		
@@ -202,11 +217,14 @@ private:
 	Poco::Timespan   _timeout;
 	Poco::Exception* _pException;
 	Poco::Any        _data;
+	Poco::UInt64     _bytesSent;
+	Poco::UInt64     _bytesReceived;
 	
 	friend class HTTPStreamBuf;
 	friend class HTTPHeaderStreamBuf;
 	friend class HTTPFixedLengthStreamBuf;
 	friend class HTTPChunkedStreamBuf;
+	friend class HTTPServerResponseImpl;
 };
 
 
@@ -231,6 +249,18 @@ inline StreamSocket& HTTPSession::socket()
 }
 
 
+inline Poco::UInt64 HTTPSession::bytesSent() const
+{
+	return _bytesSent;
+}
+
+
+inline Poco::UInt64 HTTPSession::bytesReceived() const
+{
+	return _bytesReceived;
+}
+
+
 inline const Poco::Exception* HTTPSession::networkException() const
 {
 	return _pException;
@@ -125,6 +125,7 @@ private:
 	std::vector<std::string> _errors;
 
 	friend class ICMPClient;
+	friend class ICMPPinger;
 };
 
 
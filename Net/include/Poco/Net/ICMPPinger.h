@@ -0,0 +1,245 @@
+//
+// ICMPPinger.h
+//
+// $Id: //poco/1.4/Net/include/Poco/Net/ICMPPinger.h#1 $
+//
+// Library: Net
+// Package: ICMP
+// Module:  ICMPPinger
+//
+// Definition of the ICMPPinger class.
+//
+// Copyright (c) 2013, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+// 
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+
+
+
+#ifndef Net_ICMPPinger_INCLUDED
+#define Net_ICMPPinger_INCLUDED
+
+
+#include "Poco/Net/Net.h"
+#include "Poco/Net/ICMPSocket.h"
+#include "Poco/Net/ICMPPacket.h"
+#include "Poco/Net/ICMPEventArgs.h"
+#include "Poco/Net/SocketAddress.h"
+#include "Poco/Net/IPAddress.h"
+#include "Poco/BasicEvent.h"
+#include "Poco/Timespan.h"
+#include "Poco/Timestamp.h"
+#include <vector>
+#include <deque>
+#include <map>
+
+
+namespace Poco {
+namespace Net {
+
+
+class Net_API ICMPPinger
+	/// ICMPPinger pings many hosts concurrently over a
+	/// single ICMPSocket.
+	///
+	/// Where ICMPClient sends one echo request and waits for
+	/// its reply before sending the next one, ICMPPinger keeps
+	/// up to maxInFlight() echo requests outstanding at the same
+	/// time. Replies are matched to their requests by the ICMP
+	/// identifier and sequence number, so sweeping a large
+	/// address range takes about as long as the slowest host
+	/// (or the timeout), rather than the sum of all round trips.
+	///
+	/// ICMP error messages (destination unreachable, time exceeded,
+	/// etc.) are matched to the request that caused them using the
+	/// original datagram embedded in the error message.
+	///
+	/// Each request has its own deadline (the timeout), and each
+	/// host gets its own ICMPEventArgs, so the events and RTT
+	/// statistics are the same as those reported by ICMPClient.
+	/// All events are fired from the thread calling ping().
+	///
+	/// Only IPv4 is supported.
+{
+public:
+	mutable Poco::BasicEvent<ICMPEventArgs> pingBegin;
+	mutable Poco::BasicEvent<ICMPEventArgs> pingReply;
+	mutable Poco::BasicEvent<ICMPEventArgs> pingError;
+	mutable Poco::BasicEvent<ICMPEventArgs> pingEnd;
+
+	enum
+	{
+		DEFAULT_MAX_IN_FLIGHT = 4096,
+		MAX_IN_FLIGHT         = 32768
+	};
+
+	explicit ICMPPinger(IPAddress::Family family = IPAddress::IPv4, int dataSize = 48, int ttl = 128);
+		/// Creates an ICMPPinger.
+		///
+		/// Throws a NotImplementedException if the given
+		/// address family is not supported.
+
+	~ICMPPinger();
+		/// Destroys the ICMPPinger.
+
+	void setTimeout(const Poco::Timespan& timeout);
+		/// Sets the time to wait for the reply to an echo request.
+		/// The default is one second.
+
+	const Poco::Timespan& getTimeout() const;
+		/// Returns the time to wait for the reply to an echo request.
+
+	void setInterval(const Poco::Timespan& interval);
+		/// Sets the time to wait between the completion of one
+		/// echo request and sending the next one to the same host.
+		/// The default is zero.
+
+	const Poco::Timespan& getInterval() const;
+		/// Returns the time to wait between two echo requests
+		/// to the same host.
+
+	void setMaxInFlight(int maxInFlight);
+		/// Sets the maximum number of outstanding echo requests.
+		/// The value must be between 1 and MAX_IN_FLIGHT.
+
+	int getMaxInFlight() const;
+		/// Returns the maximum number of outstanding echo requests.
+
+	int ping(const std::vector<SocketAddress>& addresses, int repeat = 1);
+		/// Pings all given addresses [repeat] times, concurrently.
+		/// Notifications are posted for events, separately for every
+		/// address.
+		///
+		/// Returns the total number of valid replies.
+		///
+		/// The same ICMPPinger must not be used by more than
+		/// one thread at a time.
+
+	int ping(const SocketAddress& address, int repeat = 1);
+		/// Pings the specified address [repeat] times.
+		///
+		/// Returns the number of valid replies.
+
+	Poco::UInt16 identifier() const;
+		/// Returns the ICMP identifier used by the echo requests
+		/// of this ICMPPinger.
+
+private:
+	struct Host
+	{
+		Host(const SocketAddress& address, int repeat, int dataSize, int ttl);
+
+		IPAddress     address;
+		ICMPEventArgs args;
+	};
+
+	struct Request
+	{
+		std::size_t      host;
+		int              index;
+		Poco::Timestamp  sent;
+		Poco::Timestamp  deadline;
+	};
+
+	typedef std::map<Poco::UInt16, Request> RequestMap;
+	typedef std::deque<std::pair<Poco::Timestamp, Poco::UInt16> > DeadlineQueue;
+	typedef std::deque<std::pair<Poco::Timestamp, std::size_t> > ReadyQueue;
+
+	void send(std::size_t host);
+		/// Sends the next echo request to the given host.
+
+	void receive();
+		/// Reads and dispatches all datagrams available on the socket.
+
+	void dispatch(Poco::UInt8* buffer, int length, const SocketAddress& sender);
+		/// Matches a reply or error message to its request.
+
+	void expire(const Poco::Timestamp& now);
+		/// Fails all requests whose deadline has passed.
+
+	void fail(std::size_t host, int index, const std::string& error);
+		/// Records the error for the given request and fires pingError.
+
+	void done(std::size_t host);
+		/// Schedules the next echo request to the given host,
+		/// or fires pingEnd if all requests have been sent.
+
+	Poco::UInt16 nextSequence();
+		/// Returns the next sequence number not currently in use.
+	
+	ICMPPinger(const ICMPPinger&);
+	ICMPPinger& operator = (const ICMPPinger&);
+
+	IPAddress::Family  _family;
+	int                _dataSize;
+	int                _ttl;
+	ICMPSocket         _socket;
+	ICMPPacket         _packet;
+	Poco::Timespan     _timeout;
+	Poco::Timespan     _interval;
+	int                _maxInFlight;
+	Poco::UInt16       _id;
+	Poco::UInt16       _seq;
+	std::vector<char>  _sendBuffer;
+	std::vector<char>  _receiveBuffer;
+	std::vector<Host>  _hosts;
+	RequestMap         _requests;
+	DeadlineQueue      _deadlines;
+	ReadyQueue         _ready;
+	int                _received;
+};
+
+
+//
+// inlines
+//
+inline const Poco::Timespan& ICMPPinger::getTimeout() const
+{
+	return _timeout;
+}
+
+
+inline const Poco::Timespan& ICMPPinger::getInterval() const
+{
+	return _interval;
+}
+
+
+inline int ICMPPinger::getMaxInFlight() const
+{
+	return _maxInFlight;
+}
+
+
+inline Poco::UInt16 ICMPPinger::identifier() const
+{
+	return _id;
+}
+
+
+} } // namespace Poco::Net
+
+
+#endif // Net_ICMPPinger_INCLUDED
@@ -88,6 +88,25 @@ public:
 		/// Returns the time elapsed since the originating 
 		/// request was sent.
 
+	int sendTo(const void* buffer, int length, const SocketAddress& address, int flags = 0);
+		/// Sends a complete ICMP packet, assembled by the caller,
+		/// to the given address.
+		///
+		/// Unlike sendTo(const SocketAddress&, int), the socket's
+		/// own echo request packet is not used.
+		///
+		/// Returns the number of bytes sent.
+
+	int receiveFrom(void* buffer, int length, SocketAddress& address, int flags = 0);
+		/// Receives a single datagram from the socket, including
+		/// the IP header, and stores the address of the sender in address.
+		///
+		/// Unlike receiveFrom(SocketAddress&, int), the datagram is
+		/// neither validated nor matched against the socket's own
+		/// echo request, so all ICMP traffic seen by the socket is returned.
+		///
+		/// Returns the number of bytes received.
+
 	int dataSize() const;
 		/// Returns the data size in bytes.
 
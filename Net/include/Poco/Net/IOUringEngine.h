@@ -0,0 +1,121 @@
+//
+// IOUringEngine.h
+//
+// $Id: //poco/1.4/Net/include/Poco/Net/IOUringEngine.h#1 $
+//
+// Library: Net
+// Package: Reactor
+// Module:  IOUringEngine
+//
+// Definition of the IOUringEngine class.
+//
+// Copyright (c) 2013, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+// 
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+
+
+
+#ifndef Net_IOUringEngine_INCLUDED
+#define Net_IOUringEngine_INCLUDED
+
+
+#include "Poco/Net/Net.h"
+#include "Poco/Net/AsyncIOEngine.h"
+
+
+namespace Poco {
+namespace Net {
+
+
+class Net_API IOUringEngine: public AsyncIOEngine
+	/// An AsyncIOEngine that uses the Linux io_uring interface.
+	///
+	/// All operations are submitted to the kernel and complete 
+	/// without further system calls, except for sends that the 
+	/// kernel completes only partially, which are resubmitted
+	/// for the remaining data. Operations started from observers
+	/// (that is, in the engine thread) are submitted together 
+	/// with the next wait for completions.
+	///
+	/// The receive buffers are registered with the kernel, if
+	/// the locked memory limit of the process allows it. 
+	///
+	/// Requires Linux 5.6 or later.
+{
+public:
+	enum
+	{
+		DEFAULT_ENTRIES = 1024
+	};
+
+	IOUringEngine(int bufferCount = DEFAULT_BUFFER_COUNT, int bufferSize = DEFAULT_BUFFER_SIZE, int entries = DEFAULT_ENTRIES);
+		/// Creates the IOUringEngine, using a submission queue
+		/// with the given number of entries.
+		///
+		/// Throws a NotImplementedException if the kernel does not 
+		/// support io_uring or one of the required operations.
+
+	std::string name() const;
+		/// Returns "io_uring".
+
+	bool fixedBuffers() const;
+		/// Returns true if the receive buffers have been
+		/// registered with the kernel.
+
+protected:
+	~IOUringEngine();
+
+	void submit(AsyncIOOperation* pOperation);
+	void cancelOperation(AsyncIOOperation* pOperation);
+	void wakeUp();
+	void run();
+
+private:
+	struct Ring;
+
+	void prepare(AsyncIOOperation* pOperation);
+	void flush();
+	void process(AsyncIOOperation* pOperation, int res);
+
+	Ring*         _pRing;
+	bool          _fixedBuffers;
+	Poco::Thread* _pEngineThread;
+};
+
+
+//
+// inlines
+//
+inline bool IOUringEngine::fixedBuffers() const
+{
+	return _fixedBuffers;
+}
+
+
+} } // namespace Poco::Net
+
+
+#endif // Net_IOUringEngine_INCLUDED
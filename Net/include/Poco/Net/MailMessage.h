@@ -212,6 +212,11 @@ public:
 
 	void write(std::ostream& ostr) const;
 		/// Writes the mail message to the given output stream.
+		///
+		/// Content and attachments are read from their sources 
+		/// and encoded in large blocks, and written directly to
+		/// the given stream without building the encoded message
+		/// in memory.
 		
 	static std::string encodeWord(const std::string& text, const std::string& charset = "UTF-8");
 		/// If the given string contains non-ASCII characters, 
@@ -265,6 +270,11 @@ protected:
 	static const std::string CTE_BASE64;
 
 private:
+	enum
+	{
+		ENCODING_BUFFER_SIZE = 65536
+	};
+
 	MailMessage(const MailMessage&);
 	MailMessage& operator = (const MailMessage&);
 
@@ -60,6 +60,10 @@ class Net_API MailStreamBuf: public Poco::UnbufferedStreamBuf
 	///
 	/// See RFC 2181 (Simple Mail Transfer Protocol) and RFC 1939
 	/// (Post Office Protocol - Version 3) for more information.
+	///
+	/// For output streams, data written in blocks is scanned and
+	/// passed on to the connected stream in runs, so that only
+	/// the inserted periods cause additional writes.
 {
 public:
 	MailStreamBuf(std::istream& istr);
@@ -80,6 +84,7 @@ public:
 protected:
 	int readFromDevice();
 	int writeToDevice(char c);
+	std::streamsize xsputn(const char* s, std::streamsize n);
 	int readOne();
 
 private:
@@ -63,7 +63,9 @@ class Net_API NetworkInterface
 	/// 
 	/// The class also provides static member functions for
 	/// enumerating or searching network interfaces and their
-	/// respective configuration values.
+	/// respective configuration values. These functions enumerate
+	/// the interfaces with every call; use NetworkInterfaceCache
+	/// for frequent lookups.
 {
 public:
 	typedef std::vector<NetworkInterface>                List;
@@ -0,0 +1,204 @@
+//
+// NetworkInterfaceCache.h
+//
+// $Id: //poco/1.4/Net/include/Poco/Net/NetworkInterfaceCache.h#1 $
+//
+// Library: Net
+// Package: NetCore
+// Module:  NetworkInterfaceCache
+//
+// Definition of the NetworkInterfaceCache class.
+//
+// Copyright (c) 2013, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+// 
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+
+
+
+#ifndef Net_NetworkInterfaceCache_INCLUDED
+#define Net_NetworkInterfaceCache_INCLUDED
+
+
+#include "Poco/Net/Net.h"
+#include "Poco/Net/NetworkInterface.h"
+#include "Poco/BasicEvent.h"
+#include "Poco/Runnable.h"
+#include "Poco/Thread.h"
+#include "Poco/Event.h"
+#include "Poco/Mutex.h"
+#include "Poco/SharedPtr.h"
+#include "Poco/Timespan.h"
+
+
+namespace Poco {
+namespace Net {
+
+
+class Net_API NetworkInterfaceCache: public Poco::Runnable
+	/// NetworkInterfaceCache keeps a snapshot of the system's
+	/// network interfaces (as returned by NetworkInterface::map(false, false))
+	/// and provides constant-time lookups by interface index,
+	/// IP address and name, without enumerating the interfaces
+	/// for every lookup.
+	///
+	/// Once started, a background thread keeps the snapshot up
+	/// to date. On Linux, the thread listens for link and address
+	/// change notifications on a rtnetlink socket, and refreshes
+	/// the snapshot whenever a change has been reported. On other
+	/// platforms, or if the rtnetlink socket cannot be opened,
+	/// the snapshot is refreshed periodically.
+	///
+	/// After every refresh, the old and the new snapshot are compared
+	/// and the interfaceAdded, interfaceRemoved and interfaceChanged 
+	/// events are fired accordingly. The events are fired from the 
+	/// thread that performed the refresh.
+	///
+	/// All member functions are thread safe. Lookups only hold a
+	/// lock for the time needed to obtain a reference to the current 
+	/// snapshot.
+{
+public:
+	Poco::BasicEvent<const NetworkInterface> interfaceAdded;
+		/// Fired when a new interface has appeared.
+
+	Poco::BasicEvent<const NetworkInterface> interfaceRemoved;
+		/// Fired when an interface has disappeared.
+
+	Poco::BasicEvent<const NetworkInterface> interfaceChanged;
+		/// Fired when the name, addresses, flags or MTU
+		/// of an existing interface have changed.
+
+	NetworkInterfaceCache();
+		/// Creates the NetworkInterfaceCache and takes an
+		/// initial snapshot of the system's network interfaces.
+		///
+		/// The background thread is not started. Call start()
+		/// to keep the snapshot up to date automatically.
+
+	~NetworkInterfaceCache();
+		/// Stops the background thread and destroys the 
+		/// NetworkInterfaceCache.
+
+	void start();
+		/// Starts the background thread.
+
+	void stop();
+		/// Stops the background thread.
+
+	bool isRunning() const;
+		/// Returns true if the background thread is running.
+
+	bool usesNetlink() const;
+		/// Returns true if the background thread receives change
+		/// notifications from the kernel. Otherwise, the snapshot 
+		/// is only refreshed periodically.
+
+	void setRefreshInterval(const Poco::Timespan& interval);
+		/// Sets the interval for periodic refreshes. A refresh
+		/// is done after the interval has elapsed, regardless of whether
+		/// a change notification has been received. 
+		/// 
+		/// Specify 0 to disable periodic refreshes. This should only be 
+		/// done if usesNetlink() returns true. The default is 30 seconds.
+
+	Poco::Timespan getRefreshInterval() const;
+		/// Returns the interval for periodic refreshes.
+
+	void refresh();
+		/// Enumerates the system's network interfaces, replaces
+		/// the snapshot and fires the change events.
+
+	NetworkInterface::Map map() const;
+		/// Returns a copy of the current snapshot, keyed by interface 
+		/// index. Down interfaces and interfaces without an IP address 
+		/// are included.
+
+	bool find(unsigned index, NetworkInterface& interfc) const;
+		/// Looks up the interface with the given index.
+		/// Returns true and assigns the interface to interfc
+		/// if found, otherwise returns false.
+
+	bool find(const IPAddress& address, NetworkInterface& interfc) const;
+		/// Looks up the interface the given IP address is bound to.
+		/// Returns true and assigns the interface to interfc
+		/// if found, otherwise returns false.
+
+	bool find(const std::string& name, NetworkInterface& interfc) const;
+		/// Looks up the interface with the given name.
+		/// Returns true and assigns the interface to interfc
+		/// if found, otherwise returns false.
+
+	NetworkInterface forIndex(unsigned index) const;
+		/// Returns the interface with the given index.
+		///
+		/// Throws an InterfaceNotFoundException if an interface
+		/// with the given index does not exist.
+
+	NetworkInterface forAddress(const IPAddress& address) const;
+		/// Returns the interface the given IP address is bound to.
+		///
+		/// Throws an InterfaceNotFoundException if an interface
+		/// with the given address does not exist.
+
+	NetworkInterface forName(const std::string& name) const;
+		/// Returns the interface with the given name.
+		///
+		/// Throws an InterfaceNotFoundException if an interface
+		/// with the given name does not exist.
+
+	static NetworkInterfaceCache& defaultCache();
+		/// Returns the default NetworkInterfaceCache. The background
+		/// thread of the default cache is started on first use.
+
+protected:
+	void run();
+	void notifyChanges(const NetworkInterface::Map& oldMap, const NetworkInterface::Map& newMap);
+	static bool sameConfiguration(const NetworkInterface& interfc1, const NetworkInterface& interfc2);
+
+private:
+	struct Snapshot;
+	typedef Poco::SharedPtr<Snapshot> SnapshotPtr;
+
+	NetworkInterfaceCache(const NetworkInterfaceCache&);
+	NetworkInterfaceCache& operator = (const NetworkInterfaceCache&);
+
+	SnapshotPtr snapshot() const;
+
+	SnapshotPtr      _pSnapshot;
+	Poco::Timespan   _refreshInterval;
+	Poco::Thread     _thread;
+	Poco::Event      _wakeUp;
+	volatile bool    _stop;
+	volatile bool    _netlink;
+	mutable Poco::FastMutex _mutex;
+	Poco::FastMutex  _refreshMutex;
+};
+
+
+} } // namespace Poco::Net
+
+
+#endif // Net_NetworkInterfaceCache_INCLUDED
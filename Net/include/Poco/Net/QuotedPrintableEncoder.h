@@ -53,20 +53,37 @@ class Net_API QuotedPrintableEncoderBuf: public Poco::UnbufferedStreamBuf
 	/// This streambuf encodes all data written
 	/// to it in quoted-printable encoding (see RFC 2045)
 	/// and forwards it to a connected ostream.
+	///
+	/// Encoded characters are collected in an internal 
+	/// buffer, which is passed on to the connected ostream
+	/// once per write() call.
 {
 public:
 	QuotedPrintableEncoderBuf(std::ostream& ostr);
 	~QuotedPrintableEncoderBuf();
 	int close();
+
+protected:
+	std::streamsize xsputn(const char* s, std::streamsize n);
 	
 private:
+	enum
+	{
+		BUFFER_SIZE = 4096
+	};
+	
 	int writeToDevice(char c);
+	void encode(char c);
 	void writeEncoded(char c);
 	void writeRaw(char c);
+	void put(char c);
+	void flushBuffer();
 
 	int           _pending;
 	int           _lineLength;
 	std::ostream& _ostr;
+	char          _buffer[BUFFER_SIZE];
+	int           _bufferLength;
 };
 
 
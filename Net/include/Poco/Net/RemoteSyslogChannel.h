@@ -43,21 +43,39 @@
 #include "Poco/Net/Net.h"
 #include "Poco/Channel.h"
 #include "Poco/Mutex.h"
+#include "Poco/Runnable.h"
+#include "Poco/Thread.h"
+#include "Poco/Event.h"
 #include "Poco/Net/DatagramSocket.h"
+#include "Poco/Net/StreamSocket.h"
 #include "Poco/Net/SocketAddress.h"
+#include <vector>
 
 
 namespace Poco {
 namespace Net {
 
 
-class Net_API RemoteSyslogChannel: public Poco::Channel
+class Net_API RemoteSyslogChannel: public Poco::Channel, public Poco::Runnable
 	/// This Channel implements remote syslog logging over UDP according
 	/// to RFC 5424 "The Syslog Protocol" 
 	/// and RFC 5426 "Transmission of syslog messages over UDP".
 	///
 	/// In addition, RemoteSyslogListener also supports the "old" BSD syslog
 	/// protocol, as described in RFC 3164.
+	///
+	/// Optionally, messages can be sent over TCP, using the octet-counting
+	/// framing ("MSG-LEN SP SYSLOG-MSG") described in RFC 5425 and RFC 6587.
+	///
+	/// By default, log() formats and sends every message synchronously.
+	/// If the async property is set to true, log() only formats the message
+	/// into a preallocated ring buffer, from which a background thread sends
+	/// messages in batches (using sendmmsg() on Linux for UDP, or a single
+	/// write per batch for TCP). If the ring buffer is full, because the
+	/// remote host or the network cannot keep up, log() does not block,
+	/// but discards the message and increments the dropped() counter.
+	/// In asynchronous mode, messages longer than MAX_MESSAGE_SIZE bytes
+	/// are truncated.
 {
 public:
 	static const std::string BSD_TIMEFORMAT;
@@ -105,7 +123,9 @@ public:
 	
 	enum
 	{
-		SYSLOG_PORT = 514
+		SYSLOG_PORT = 514,
+		MAX_MESSAGE_SIZE = 2048,  /// Maximum size of a message in asynchronous mode.
+		DEFAULT_QUEUE_SIZE = 1024 /// Default number of messages buffered in asynchronous mode.
 	};
 	
 	RemoteSyslogChannel();
@@ -136,10 +156,25 @@ public:
 		///                  by a colon) can also be specified.
 		///     * host:      (optional) Host name included in syslog messages. If not specified, the host's real domain name or
 		///                  IP address will be used.
+		///     * transport: "udp" (default) or "tcp". With TCP, messages are framed using octet counting.
+		///     * async:     "true" to send messages from a background thread, "false" (default) to send
+		///                  messages synchronously in log().
+		///     * queueSize: The maximum number of messages buffered in asynchronous mode (default 1024).
+		///
+		/// The transport, async and queueSize properties must be set before the
+		/// channel is opened.
 		
 	std::string getProperty(const std::string& name) const;
 		/// Returns the value of the property with the given name.
 
+	Poco::UInt64 sent() const;
+		/// Returns the number of messages sent in asynchronous mode.
+
+	Poco::UInt64 dropped() const;
+		/// Returns the number of messages that have been discarded
+		/// in asynchronous mode, either because the ring buffer was
+		/// full, or because sending them failed.
+
 	static void registerChannel();
 		/// Registers the channel with the global LoggingFactory.
 
@@ -148,20 +183,52 @@ public:
 	static const std::string PROP_FORMAT;
 	static const std::string PROP_LOGHOST;
 	static const std::string PROP_HOST;
+	static const std::string PROP_TRANSPORT;
+	static const std::string PROP_ASYNC;
+	static const std::string PROP_QUEUE_SIZE;
 
 protected:
 	~RemoteSyslogChannel();
 	static int getPrio(const Message& msg);
+	void format(const Message& msg, std::string& text) const;
+	void sendMessage(const char* text, int length);
+	void sendBatch(int first, int count, int& sent);
+	void sendFrames(const char* data, int length);
+	void connect();
+	void disconnect();
+	void run();
 
 private:
+	enum
+	{
+		SEND_BATCH = 64
+	};
+	
+
 	std::string _logHost;
 	std::string _name;
 	std::string _host;
 	int  _facility;
 	bool _bsdFormat;
 	DatagramSocket _socket;
+	StreamSocket _streamSocket;
 	SocketAddress _socketAddress;
 	bool _open;
+	bool _tcp;
+	bool _connected;
+	bool _async;
+	int  _queueSize;
+	std::vector<char> _ring;
+	std::vector<int>  _lengths;
+	int  _head;
+	int  _count;
+	std::string _buffer;
+	std::string _frames;
+	Poco::UInt64 _sent;
+	Poco::UInt64 _dropped;
+	Poco::Thread _thread;
+	Poco::Event  _messageReady;
+	bool _stop;
 	mutable Poco::FastMutex _mutex;
 };
 
@@ -42,15 +42,30 @@
 
 #include "Poco/Net/Net.h"
 #include "Poco/Channel.h"
+#include "Poco/Message.h"
+#include "Poco/Mutex.h"
+#include "Poco/Timer.h"
 #include "Poco/String.h"
+#include <vector>
 
 
 namespace Poco {
 namespace Net {
 
 
+class MailMessage;
+
+
 class Net_API SMTPChannel: public Poco::Channel
 	/// This Channel implements SMTP (email) logging.
+	///
+	/// By default, every log message is sent as a separate e-mail
+	/// over a new SMTP connection. If the batchSize property is set
+	/// to a value greater than one, log messages are collected and
+	/// sent together over a single SMTP connection, either when
+	/// batchSize messages have been collected, or at the latest
+	/// flushInterval seconds after a message has been logged.
+	/// Pending messages are also sent when the channel is closed.
 {
 public:
 	SMTPChannel();
@@ -66,13 +81,19 @@ public:
 		/// Closes the SMTPChannel.
 		
 	void log(const Message& msg);
-		/// Sends the message's text to the recipient.
+		/// Sends the message's text to the recipient, or adds
+		/// the message to the current batch if batching is enabled.
+
+	void flush();
+		/// Sends all pending messages over a single SMTP connection.
+		/// Does nothing if no messages are pending.
 		
 	void setProperty(const std::string& name, const std::string& value);
 		/// Sets the property with the given value.
 		///
 		/// The following properties are supported:
-		///     * mailhost:   The SMTP server. Default is "localhost".
+		///     * mailhost:   The SMTP server, optionally followed by a colon
+		///                   and a port number. Default is "localhost".
 		///     * sender:     The sender address.
 		///     * recipient:  The recipient address.
 		///     * local:      If true, local time is used. Default is true.
@@ -82,6 +103,12 @@ public:
 		///                   the attachment file after sending.
 		///     * throw:      Boolean value indicating whether to throw 
 		///                   exception upon failure.
+		///     * batchSize:  The maximum number of log messages sent over
+		///                   one SMTP connection. Default is 1 (no batching).
+		///     * flushInterval: The maximum time in seconds a log message
+		///                   is held back when batching. Default is 10.
+		///                   If 0, messages are only sent when the batch
+		///                   is full or the channel is closed.
 		
 	std::string getProperty(const std::string& name) const;
 		/// Returns the value of the property with the given name.
@@ -97,12 +124,19 @@ public:
 	static const std::string PROP_TYPE;
 	static const std::string PROP_DELETE;
 	static const std::string PROP_THROW;
+	static const std::string PROP_BATCHSIZE;
+	static const std::string PROP_FLUSHINTERVAL;
 
 protected:
 	~SMTPChannel();
 
 private:
+	typedef std::vector<Message> MessageVec;
+
 	bool isTrue(const std::string& value) const;
+	void buildMessage(const Message& msg, MailMessage& message);
+	void sendMessages(const MessageVec& messages);
+	void onTimer(Poco::Timer& timer);
 
 	std::string _mailHost;
 	std::string _sender;
@@ -112,6 +146,11 @@ private:
 	std::string _type;
 	bool        _delete;
 	bool        _throw;
+	int         _batchSize;
+	int         _flushInterval;
+	MessageVec  _pending;
+	Poco::Timer* _pTimer;
+	Poco::FastMutex _mutex;
 };
 
 
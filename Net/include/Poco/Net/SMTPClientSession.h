@@ -44,6 +44,7 @@
 #include "Poco/Net/DialogSocket.h"
 #include "Poco/DigestEngine.h"
 #include "Poco/Timespan.h"
+#include <set>
 
 
 namespace Poco {
@@ -57,6 +58,16 @@ class Net_API SMTPClientSession
 	/// This class implements an Simple Mail
 	/// Transfer Procotol (SMTP, RFC 2821)
 	/// client for sending e-mail messages.
+	///
+	/// If the server announces the PIPELINING extension (RFC 2920)
+	/// in its EHLO response, the MAIL FROM, RCPT TO and DATA commands
+	/// for a message are sent in a single batch, and the responses are
+	/// read afterwards. This saves a network round trip per recipient.
+	///
+	/// A session can be used to send any number of messages. If sending
+	/// a message fails, the mail transaction is reset with RSET before
+	/// the next message is sent. See SMTPSessionFactory for pooling
+	/// sessions.
 {
 public:
 	typedef std::vector<std::string> Recipients;
@@ -148,6 +159,35 @@ public:
 		/// Throws a SMTPException in case of a SMTP-specific error, or a
 		/// NetException in case of a general network communication failure.
 
+	void reset();
+		/// Sends a RSET command to abort the current mail transaction.
+		///
+		/// Throws a SMTPException in case of a SMTP-specific error, or a
+		/// NetException in case of a general network communication failure.
+
+	bool isOpen() const;
+		/// Returns true if the session has been opened and not
+		/// been closed, either explicitly or because of a failure
+		/// that left the connection in an undefined state.
+
+	bool inTransaction() const;
+		/// Returns true if a mail transaction has been started
+		/// but not completed, e.g. because the server rejected a
+		/// recipient. The transaction is reset before sending the
+		/// next message.
+
+	bool hasExtension(const std::string& extension) const;
+		/// Returns true if the server has announced the given 
+		/// ESMTP extension keyword (e.g., "PIPELINING" or "8BITMIME")
+		/// in its response to EHLO. The comparison is case insensitive.
+
+	void setPipelining(bool pipelining);
+		/// Enables or disables command pipelining. If enabled (the default),
+		/// pipelining is used if the server supports it.
+
+	bool getPipelining() const;
+		/// Returns true if command pipelining is enabled.
+
 	int sendCommand(const std::string& command, std::string& response);
 		/// Sends the given command verbatim to the server
 		/// and waits for a response.
@@ -190,10 +230,15 @@ protected:
 
 private:
 	void sendCommands(const MailMessage& message, const Recipients* pRecipients = 0);
+	void sendPipelinedCommands(const std::string& sender, const Recipients& recipients);
 	void transportMessage(const MailMessage& message);
+	void parseExtensions(const std::string& response);
 
-	DialogSocket _socket;
-	bool         _isOpen;
+	DialogSocket          _socket;
+	bool                  _isOpen;
+	bool                  _pipelining;
+	bool                  _inTransaction;
+	std::set<std::string> _extensions;
 };
 
 
@@ -224,6 +269,24 @@ inline bool SMTPClientSession::isPermanentNegative(int status)
 }
 
 
+inline bool SMTPClientSession::isOpen() const
+{
+	return _isOpen;
+}
+
+
+inline bool SMTPClientSession::inTransaction() const
+{
+	return _inTransaction;
+}
+
+
+inline bool SMTPClientSession::getPipelining() const
+{
+	return _pipelining;
+}
+
+
 inline DialogSocket& SMTPClientSession::socket()
 {
 	return _socket;
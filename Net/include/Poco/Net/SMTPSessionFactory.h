@@ -0,0 +1,170 @@
+//
+// SMTPSessionFactory.h
+//
+// $Id: //poco/1.4/Net/include/Poco/Net/SMTPSessionFactory.h#1 $
+//
+// Library: Net
+// Package: Mail
+// Module:  SMTPSessionFactory
+//
+// Definition of the SMTPSessionFactory class.
+//
+// Copyright (c) 2013, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+// 
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+
+
+
+#ifndef Net_SMTPSessionFactory_INCLUDED
+#define Net_SMTPSessionFactory_INCLUDED
+
+
+#include "Poco/Net/Net.h"
+#include "Poco/Net/SMTPClientSession.h"
+#include "Poco/ObjectPool.h"
+#include "Poco/Timespan.h"
+
+
+namespace Poco {
+namespace Net {
+
+
+class Net_API SMTPSessionFactory
+	/// A PoolableObjectFactory for SMTPClientSession objects,
+	/// for use with Poco::ObjectPool.
+	///
+	/// Sessions created by the factory are connected to the
+	/// configured server and logged in. When a session is returned
+	/// to the pool, an unfinished mail transaction is aborted with
+	/// RSET, so that the next user gets a clean session. Sessions
+	/// that have been closed, or that cannot be reset, are discarded.
+	///
+	/// Usage example:
+	///     SMTPSessionFactory factory("mail.example.com");
+	///     SMTPSessionPool pool(factory, 4, 16);
+	///     SMTPClientSession* pSession = pool.borrowObject();
+	///     try
+	///     {
+	///         pSession->sendMessage(message);
+	///     }
+	///     catch (...)
+	///     {
+	///         pool.returnObject(pSession);
+	///         throw;
+	///     }
+	///     pool.returnObject(pSession);
+{
+public:
+	SMTPSessionFactory(const std::string& host, Poco::UInt16 port = SMTPClientSession::SMTP_PORT);
+		/// Creates the SMTPSessionFactory for the given server.
+
+	~SMTPSessionFactory();
+		/// Destroys the SMTPSessionFactory.
+
+	void setHostName(const std::string& hostName);
+		/// Sets the host name sent to the server in the EHLO command.
+		/// If empty (the default), the session's default is used.
+
+	const std::string& getHostName() const;
+		/// Returns the host name sent in the EHLO command.
+
+	void setLogin(SMTPClientSession::LoginMethod loginMethod, const std::string& username, const std::string& password);
+		/// Sets the login method and credentials used when
+		/// logging in new sessions.
+
+	void setTimeout(const Poco::Timespan& timeout);
+		/// Sets the timeout for new sessions.
+
+	Poco::Timespan getTimeout() const;
+		/// Returns the timeout for new sessions.
+
+	void setPipelining(bool pipelining);
+		/// Enables or disables command pipelining
+		/// for new sessions. Default is enabled.
+
+	bool getPipelining() const;
+		/// Returns true if command pipelining is enabled.
+
+	SMTPClientSession* createObject();
+		/// Creates a new session, connects it to the
+		/// server and logs in.
+
+	bool validateObject(SMTPClientSession* pSession);
+		/// Returns true if the session is still open. If
+		/// a mail transaction is pending, tries to reset
+		/// it with RSET.
+
+	void activateObject(SMTPClientSession* pSession);
+		/// Does nothing.
+
+	void deactivateObject(SMTPClientSession* pSession);
+		/// Does nothing.
+
+	void destroyObject(SMTPClientSession* pSession);
+		/// Closes and deletes the session.
+
+private:
+	SMTPSessionFactory();
+
+	std::string _host;
+	Poco::UInt16 _port;
+	std::string _hostName;
+	SMTPClientSession::LoginMethod _loginMethod;
+	std::string _username;
+	std::string _password;
+	Poco::Timespan _timeout;
+	bool _pipelining;
+};
+
+
+typedef Poco::ObjectPool<SMTPClientSession, SMTPClientSession*, SMTPSessionFactory> SMTPSessionPool;
+
+
+//
+// inlines
+//
+inline const std::string& SMTPSessionFactory::getHostName() const
+{
+	return _hostName;
+}
+
+
+inline Poco::Timespan SMTPSessionFactory::getTimeout() const
+{
+	return _timeout;
+}
+
+
+inline bool SMTPSessionFactory::getPipelining() const
+{
+	return _pipelining;
+}
+
+
+} } // namespace Poco::Net
+
+
+#endif // Net_SMTPSessionFactory_INCLUDED
@@ -44,7 +44,9 @@
 #include "Poco/Net/SocketNotification.h"
 #include "Poco/Net/SocketAddress.h"
 #include "Poco/Net/StreamSocket.h"
+#include "Poco/Net/SocketReactor.h"
 #include "Poco/Observer.h"
+#include "Poco/Timespan.h"
 
 
 namespace Poco {
@@ -82,6 +84,14 @@ class SocketConnector
 	/// and calls the onError() method, which can be overridden by subclasses
 	/// to perform custom error handling.
 	///
+	/// If a timeout is given, the SocketConnector schedules a reactor timer
+	/// and, if the connection has not been established when it expires,
+	/// unregisters itself and calls onError() with POCO_ETIMEDOUT.
+	///
+	/// To connect to a host with multiple addresses, or to have many
+	/// connects in flight without creating a ServiceHandler class for
+	/// each, see AsyncConnect.
+	///
 	/// The ServiceHandler class must provide a constructor that
 	/// takes a StreamSocket and a SocketReactor as arguments,
 	/// e.g.:
@@ -109,6 +119,17 @@ public:
 		registerConnector(reactor);
 	}
 
+	SocketConnector(SocketAddress& address, SocketReactor& reactor, const Poco::Timespan& timeout):
+		_pReactor(0),
+		_timeout(timeout)
+		/// Creates a SocketConnector that gives up if the connection
+		/// cannot be established within the given timeout.
+		/// The SocketConnector registers itself with the given SocketReactor.
+	{
+		_socket.connectNB(address);
+		registerConnector(reactor);
+	}
+
 	virtual ~SocketConnector()
 		/// Destroys the SocketConnector.
 	{
@@ -127,6 +148,8 @@ public:
 		_pReactor->addEventHandler(_socket, Poco::Observer<SocketConnector, ReadableNotification>(*this, &SocketConnector::onReadable));
 		_pReactor->addEventHandler(_socket, Poco::Observer<SocketConnector, WritableNotification>(*this, &SocketConnector::onWritable));
 		_pReactor->addEventHandler(_socket, Poco::Observer<SocketConnector, ErrorNotification>(*this, &SocketConnector::onError));
+		if (_timeout.totalMicroseconds() > 0)
+			_pTimer = _pReactor->scheduleTimer(_socket, _timeout, Poco::Observer<SocketConnector, TimerNotification>(*this, &SocketConnector::onTimer));
 	}
 	
 	virtual void unregisterConnector()
@@ -142,6 +165,11 @@ public:
 			_pReactor->removeEventHandler(_socket, Poco::Observer<SocketConnector, ReadableNotification>(*this, &SocketConnector::onReadable));
 			_pReactor->removeEventHandler(_socket, Poco::Observer<SocketConnector, WritableNotification>(*this, &SocketConnector::onWritable));
 			_pReactor->removeEventHandler(_socket, Poco::Observer<SocketConnector, ErrorNotification>(*this, &SocketConnector::onError));
+			if (_pTimer)
+			{
+				_pReactor->cancelTimer(_pTimer);
+				_pTimer = 0;
+			}
 		}
 	}
 	
@@ -180,6 +208,13 @@ public:
 		unregisterConnector();
 	}
 	
+	void onTimer(TimerNotification* pNotification)
+	{
+		pNotification->release();
+		onError(POCO_ETIMEDOUT);
+		unregisterConnector();
+	}
+	
 protected:
 	virtual ServiceHandler* createServiceHandler()
 		/// Create and initialize a new ServiceHandler instance.
@@ -216,8 +251,10 @@ private:
 	SocketConnector(const SocketConnector&);
 	SocketConnector& operator = (const SocketConnector&);
 	
-	StreamSocket   _socket;
-	SocketReactor* _pReactor;
+	StreamSocket           _socket;
+	SocketReactor*         _pReactor;
+	Poco::Timespan         _timeout;
+	TimerWheel::Timer::Ptr _pTimer;
 };
 
 
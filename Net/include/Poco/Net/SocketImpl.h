@@ -155,6 +155,20 @@ public:
 		///
 		/// Certain socket implementations may also return a negative
 		/// value denoting a certain condition.
+
+	virtual Poco::Int64 sendFile(const std::string& path, Poco::UInt64 offset, Poco::UInt64 count);
+		/// Sends count bytes of the file with the given path,
+		/// starting at offset, through the socket, without copying
+		/// the file contents to user space (using sendfile() on Linux).
+		///
+		/// Returns the number of bytes sent, which is less than
+		/// count if the file is shorter, or if the socket is
+		/// non-blocking and no more data can be sent at the moment.
+		///
+		/// Returns -1 if zero-copy transmission is not supported
+		/// by the platform or the socket implementation. In this case,
+		/// nothing has been sent and the caller must send the file
+		/// with sendBytes().
 	
 	virtual int receiveBytes(void* buffer, int length, int flags = 0);
 		/// Receives data from the socket and stores it
@@ -449,6 +463,7 @@ private:
 	
 	friend class Socket;
 	friend class SecureSocketImpl;
+	friend class AsyncIOEngine;
 };
 
 
@@ -42,6 +42,8 @@
 
 #include "Poco/Net/Net.h"
 #include "Poco/Net/Socket.h"
+#include "Poco/Net/SocketAddress.h"
+#include "Poco/Net/TimerWheel.h"
 #include "Poco/Notification.h"
 
 
@@ -76,6 +78,8 @@ private:
 	Socket         _socket;
 	
 	friend class SocketNotifier;
+	friend class SocketReactor;
+	friend class ConnectNotification;
 };
 
 
@@ -128,6 +132,77 @@ public:
 };
 
 
+class Net_API TimerNotification: public SocketNotification
+	/// This notification is sent when a timer scheduled with
+	/// SocketReactor::scheduleTimer() expires.
+	///
+	/// If the timer has been scheduled for a socket, socket()
+	/// returns that socket.
+{
+public:
+	TimerNotification(SocketReactor* pReactor, TimerWheel::Timer* pTimer);
+		/// Creates the TimerNotification for the given SocketReactor and timer.
+
+	~TimerNotification();
+		/// Destroys the TimerNotification.
+		
+	TimerWheel::Timer::Ptr timer() const;
+		/// Returns the timer that has expired.
+		///
+		/// The timer can be passed to SocketReactor::rescheduleTimer()
+		/// to implement a periodic timer.
+
+private:
+	TimerWheel::Timer::Ptr _pTimer;
+};
+
+
+class Net_API ConnectNotification: public SocketNotification
+	/// This notification is sent when a connect operation
+	/// started with AsyncConnect has completed, either 
+	/// successfully or not.
+	///
+	/// If the connection has been established, socket() returns
+	/// the connected socket, which can be used to construct
+	/// a StreamSocket.
+{
+public:
+	enum Result
+	{
+		CONNECT_OK,        /// The connection has been established.
+		CONNECT_FAILED,    /// All connection attempts have failed.
+		CONNECT_TIMEOUT,   /// The deadline has expired.
+		CONNECT_CANCELLED  /// The connect operation has been cancelled.
+	};
+	
+	ConnectNotification(SocketReactor* pReactor, Result result, const Socket& socket, const SocketAddress& address, int error);
+		/// Creates the ConnectNotification for the given SocketReactor.
+
+	~ConnectNotification();
+		/// Destroys the ConnectNotification.
+		
+	Result result() const;
+		/// Returns the result of the connect operation.
+		
+	bool connected() const;
+		/// Returns true if the connection has been established.
+		
+	const SocketAddress& address() const;
+		/// Returns the address the socket has been connected to,
+		/// or, if the connect operation failed, the address
+		/// of the last failed attempt.
+		
+	int error() const;
+		/// Returns the error code of the last failed attempt, 
+		/// or 0 if the connection has been established.
+
+private:
+	Result        _result;
+	SocketAddress _address;
+	int           _error;
+};
+
+
 class Net_API IdleNotification: public SocketNotification
 	/// This notification is sent when the SocketReactor does
 	/// not have any sockets to react to.
@@ -169,6 +244,30 @@ inline Socket& SocketNotification::socket()
 }
 
 
+inline ConnectNotification::Result ConnectNotification::result() const
+{
+	return _result;
+}
+
+
+inline bool ConnectNotification::connected() const
+{
+	return _result == CONNECT_OK;
+}
+
+
+inline const SocketAddress& ConnectNotification::address() const
+{
+	return _address;
+}
+
+
+inline int ConnectNotification::error() const
+{
+	return _error;
+}
+
+
 } } // namespace Poco::Net
 
 
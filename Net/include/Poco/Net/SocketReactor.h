@@ -42,6 +42,7 @@
 
 #include "Poco/Net/Net.h"
 #include "Poco/Net/Socket.h"
+#include "Poco/Net/TimerWheel.h"
 #include "Poco/Runnable.h"
 #include "Poco/Timespan.h"
 #include "Poco/Observer.h"
@@ -112,6 +113,17 @@ class Net_API SocketReactor: public Poco::Runnable
 	/// called repeatedly in a loop, it is recommended to do a
 	/// short sleep or yield in the event handler.
 	///
+	/// In addition to socket events, the SocketReactor manages
+	/// one-shot timers, which can be scheduled with scheduleTimer().
+	/// When a timer expires, a TimerNotification is dispatched
+	/// to the observer given when scheduling the timer. Timers
+	/// are kept in a TimerWheel, so scheduling, rescheduling and 
+	/// cancelling a timer are O(1) operations, and the time the 
+	/// reactor waits for socket events is limited by the next timer 
+	/// deadline. This makes it cheap to attach idle or read timeouts 
+	/// to large numbers of connections. Timer resolution is one 
+	/// millisecond. Timers only expire while the reactor is running.
+	///
 	/// Finally, when the SocketReactor is about to shut down (as a result 
 	/// of stop() being called), it dispatches a ShutdownNotification
 	/// to all event handlers. This is done in the onShutdown() method
@@ -179,6 +191,41 @@ public:
 		///     Poco::Observer<MyEventHandler, SocketNotification> obs(*this, &MyEventHandler::handleMyEvent);
 		///     reactor.removeEventHandler(obs);
 
+	TimerWheel::Timer::Ptr scheduleTimer(const Poco::Timespan& delay, const Poco::AbstractObserver& observer);
+		/// Schedules a one-shot timer that expires after the given delay.
+		///
+		/// When the timer expires, a TimerNotification is dispatched to the 
+		/// given observer, which must accept TimerNotification.
+		/// The returned timer can be passed to rescheduleTimer() or
+		/// cancelTimer().
+		///
+		/// Usage:
+		///     Poco::Observer<MyEventHandler, TimerNotification> obs(*this, &MyEventHandler::onTimer);
+		///     _pTimer = reactor.scheduleTimer(Poco::Timespan(5, 0), obs);
+
+	TimerWheel::Timer::Ptr scheduleTimer(const Socket& socket, const Poco::Timespan& delay, const Poco::AbstractObserver& observer);
+		/// Schedules a one-shot timer for the given socket that expires 
+		/// after the given delay. 
+		///
+		/// Same as above, except that the socket() of the 
+		/// TimerNotification will be the given socket.
+
+	void rescheduleTimer(TimerWheel::Timer::Ptr pTimer, const Poco::Timespan& delay);
+		/// Reschedules a timer obtained from scheduleTimer() to expire
+		/// after the given delay from now, regardless of whether
+		/// it has already expired or has been cancelled.
+		///
+		/// A typical use is restarting an idle timeout whenever
+		/// data is received on a connection.
+
+	void cancelTimer(TimerWheel::Timer::Ptr pTimer);
+		/// Cancels a timer obtained from scheduleTimer().
+		///
+		/// Once this method returns, no TimerNotification will be 
+		/// dispatched for the timer, unless it is rescheduled, or
+		/// the notification is already being dispatched by the
+		/// reactor thread at the same time.
+
 protected:
 	virtual void onTimeout();
 		/// Called if the timeout expires and no other events are available.
@@ -215,6 +262,9 @@ protected:
 	void dispatch(SocketNotification* pNotification);
 		/// Dispatches the given notification to all observers.
 		
+	void dispatchTimers();
+		/// Dispatches TimerNotifications for all expired timers.
+		
 private:
 	typedef Poco::AutoPtr<SocketNotifier>     NotifierPtr;
 	typedef Poco::AutoPtr<SocketNotification> NotificationPtr;
@@ -237,6 +287,8 @@ private:
 	NotificationPtr _pIdleNotification;
 	NotificationPtr _pShutdownNotification;
 	Poco::FastMutex _mutex;
+	TimerWheel      _timers;
+	Poco::FastMutex _timerMutex;
 	
 	friend class SocketNotifier;
 };
@@ -56,10 +56,22 @@ class StreamSocketImpl;
 
 class Net_API SocketStreamBuf: public Poco::BufferedBidirectionalStreamBuf
 	/// This is the streambuf class used for reading from and writing to a socket.
+	///
+	/// Reads and writes smaller than the buffer size are buffered.
+	/// Larger reads and writes (e.g., via std::istream::read() or
+	/// std::ostream::write()) bypass the buffer and are passed 
+	/// directly to the socket, after flushing any buffered output
+	/// or consuming any buffered input, respectively.
 {
 public:
-	SocketStreamBuf(const Socket& socket);
-		/// Creates a SocketStreamBuf with the given socket.
+	enum
+	{
+		DEFAULT_BUFFER_SIZE = 8192
+	};
+
+	SocketStreamBuf(const Socket& socket, std::streamsize bufferSize = DEFAULT_BUFFER_SIZE);
+		/// Creates a SocketStreamBuf with the given socket,
+		/// using buffers of the given size for reading and writing.
 		///
 		/// The socket's SocketImpl must be a StreamSocketImpl,
 		/// otherwise an InvalidArgumentException is thrown.
@@ -70,17 +82,18 @@ public:
 	StreamSocketImpl* socketImpl() const;
 		/// Returns the internal SocketImpl.
 	
+	std::streamsize bufferSize() const;
+		/// Returns the size of the read and write buffers.
+
 protected:
+	std::streamsize xsgetn(char* buffer, std::streamsize length);
+	std::streamsize xsputn(const char* buffer, std::streamsize length);
 	int readFromDevice(char* buffer, std::streamsize length);
 	int writeToDevice(const char* buffer, std::streamsize length);
 
 private:
-	enum 
-	{
-		STREAM_BUFFER_SIZE = 1024
-	};
-
 	StreamSocketImpl* _pImpl;
+	std::streamsize   _bufferSize;
 };
 
 
@@ -92,8 +105,8 @@ class Net_API SocketIOS: public virtual std::ios
 	/// order of the stream buffer and base classes.
 {
 public:
-	SocketIOS(const Socket& socket);
-		/// Creates the SocketIOS with the given socket.
+	SocketIOS(const Socket& socket, std::streamsize bufferSize = SocketStreamBuf::DEFAULT_BUFFER_SIZE);
+		/// Creates the SocketIOS with the given socket and buffer size.
 		///
 		/// The socket's SocketImpl must be a StreamSocketImpl,
 		/// otherwise an InvalidArgumentException is thrown.
@@ -121,9 +134,12 @@ class Net_API SocketOutputStream: public SocketIOS, public std::ostream
 	/// An output stream for writing to a socket.
 {
 public:
-	explicit SocketOutputStream(const Socket& socket);
+	explicit SocketOutputStream(const Socket& socket, std::streamsize bufferSize = SocketStreamBuf::DEFAULT_BUFFER_SIZE);
 		/// Creates the SocketOutputStream with the given socket.
 		///
+		/// The stream buffers reads and writes smaller than
+		/// bufferSize bytes; see SocketStreamBuf for details.
+		///
 		/// The socket's SocketImpl must be a StreamSocketImpl,
 		/// otherwise an InvalidArgumentException is thrown.
 
@@ -147,9 +163,12 @@ class Net_API SocketInputStream: public SocketIOS, public std::istream
 	/// istream with formatted reads.
 {
 public:
-	explicit SocketInputStream(const Socket& socket);
+	explicit SocketInputStream(const Socket& socket, std::streamsize bufferSize = SocketStreamBuf::DEFAULT_BUFFER_SIZE);
 		/// Creates the SocketInputStream with the given socket.
 		///
+		/// The stream buffers reads and writes smaller than
+		/// bufferSize bytes; see SocketStreamBuf for details.
+		///
 		/// The socket's SocketImpl must be a StreamSocketImpl,
 		/// otherwise an InvalidArgumentException is thrown.
 
@@ -171,9 +190,12 @@ class Net_API SocketStream: public SocketIOS, public std::iostream
 	/// istream with formatted reads.
 {
 public:
-	explicit SocketStream(const Socket& socket);
+	explicit SocketStream(const Socket& socket, std::streamsize bufferSize = SocketStreamBuf::DEFAULT_BUFFER_SIZE);
 		/// Creates the SocketStream with the given socket.
 		///
+		/// The stream buffers reads and writes smaller than
+		/// bufferSize bytes; see SocketStreamBuf for details.
+		///
 		/// The socket's SocketImpl must be a StreamSocketImpl,
 		/// otherwise an InvalidArgumentException is thrown.
 
@@ -193,6 +215,12 @@ inline StreamSocketImpl* SocketStreamBuf::socketImpl() const
 }
 
 
+inline std::streamsize SocketStreamBuf::bufferSize() const
+{
+	return _bufferSize;
+}
+
+
 } } // namespace Poco::Net
 
 
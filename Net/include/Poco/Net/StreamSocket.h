@@ -142,6 +142,16 @@ public:
 		/// Certain socket implementations may also return a negative
 		/// value denoting a certain condition.
 
+	Poco::Int64 sendFile(const std::string& path, Poco::UInt64 offset, Poco::UInt64 count);
+		/// Sends count bytes of the file with the given path,
+		/// starting at offset, through the socket, without copying
+		/// the file contents to user space, if supported by the platform
+		/// and the socket (see SocketImpl::sendFile()).
+		///
+		/// Returns the number of bytes sent, or -1 if zero-copy
+		/// transmission is not supported, in which case nothing
+		/// has been sent.
+
 	int receiveBytes(void* buffer, int length, int flags = 0);
 		/// Receives data from the socket and stores it
 		/// in buffer. Up to length bytes are received.
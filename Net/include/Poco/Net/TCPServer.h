@@ -176,6 +176,10 @@ protected:
 	static std::string threadName(const ServerSocket& socket);
 		/// Returns a thread name for the server thread.
 
+	void enqueue(const StreamSocket& socket);
+		/// Hands the given connection over to the dispatcher,
+		/// as if it had just been accepted.
+
 private:
 	TCPServer();
 	TCPServer(const TCPServer&);
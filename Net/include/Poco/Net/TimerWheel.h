@@ -0,0 +1,276 @@
+//
+// TimerWheel.h
+//
+// $Id: //poco/1.4/Net/include/Poco/Net/TimerWheel.h#1 $
+//
+// Library: Net
+// Package: Reactor
+// Module:  TimerWheel
+//
+// Definition of the TimerWheel class.
+//
+// Copyright (c) 2013, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+// 
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+
+#ifndef Net_TimerWheel_INCLUDED
+#define Net_TimerWheel_INCLUDED
+
+
+#include "Poco/Net/Net.h"
+#include "Poco/RefCountedObject.h"
+#include "Poco/AutoPtr.h"
+#include "Poco/Timestamp.h"
+#include "Poco/Timespan.h"
+#include <vector>
+
+
+namespace Poco {
+namespace Net {
+
+
+class Net_API TimerWheel
+	/// This class implements a hierarchical hashed timing wheel, 
+	/// as described by G. Varghese and T. Lauck in "Hashed and 
+	/// Hierarchical Timing Wheels" (1987).
+	///
+	/// Time is divided into ticks of a fixed resolution.
+	/// The wheel consists of LEVELS levels of SLOTS slots each.
+	/// Timers due within the next SLOTS ticks are kept in the
+	/// slots of the lowest level. Timers further away are kept
+	/// in higher levels, each slot of which covers SLOTS times
+	/// the range of a slot in the level below, and are moved
+	/// ("cascaded") to the lower levels as time advances.
+	///
+	/// Scheduling, rescheduling and cancelling a timer are O(1)
+	/// operations, independent of the number of timers, which
+	/// makes the TimerWheel suitable for managing idle and I/O
+	/// timeouts for very large numbers of connections.
+	///
+	/// Timers never expire before their deadline, but may expire
+	/// up to one tick (the resolution) after it.
+	///
+	/// The TimerWheel does not invoke any callbacks. Instead,
+	/// advance() returns the timers that have expired, leaving
+	/// it to the caller to act on them (typically, outside of
+	/// any lock protecting the TimerWheel). See SocketReactor
+	/// for an example.
+	///
+	/// The TimerWheel is not thread safe.
+{
+public:
+	struct Link
+		/// Intrusive list link used internally by TimerWheel.
+	{
+		Link* pPrev;
+		Link* pNext;
+	};
+
+	class Net_API Timer: public Poco::RefCountedObject, public Link
+		/// A timer managed by a TimerWheel.
+		///
+		/// Subclasses can add whatever data is needed to act on 
+		/// the expiration of the timer.
+		///
+		/// While a timer is scheduled, the TimerWheel holds
+		/// a reference to it.
+	{
+	public:
+		typedef Poco::AutoPtr<Timer> Ptr;
+
+		Timer();
+			/// Creates the Timer.
+
+		bool isScheduled() const;
+			/// Returns true iff the timer is currently scheduled.
+
+		const Poco::Timestamp& expires() const;
+			/// Returns the time at which the timer expires
+			/// or has expired.
+
+	protected:
+		virtual ~Timer();
+			/// Destroys the Timer.
+
+	private:
+		Timer(const Timer&);
+		Timer& operator = (const Timer&);
+
+		enum State
+		{
+			TIMER_IDLE,
+			TIMER_SCHEDULED,
+			TIMER_EXPIRED
+		};
+
+		State           _state;
+		Poco::UInt64    _tick;
+		int             _level;
+		int             _slot;
+		Poco::Timestamp _expires;
+
+		friend class TimerWheel;
+	};
+
+	typedef std::vector<Timer::Ptr> TimerVec;
+
+	enum
+	{
+		SLOT_BITS = 6,
+		SLOTS     = 1 << SLOT_BITS,
+		SLOT_MASK = SLOTS - 1,
+		LEVELS    = 5,
+		DEFAULT_RESOLUTION = 1000 /// 1 millisecond
+	};
+
+	TimerWheel();
+		/// Creates a TimerWheel with a resolution of 
+		/// one millisecond.
+		///
+		/// With LEVELS levels of SLOTS slots each, timers
+		/// up to about 12 days in the future are handled
+		/// without any extra cost. Timers with later
+		/// deadlines are supported, but cascaded
+		/// more often.
+		
+	explicit TimerWheel(const Poco::Timespan& resolution);
+		/// Creates a TimerWheel with the given resolution.
+
+	~TimerWheel();
+		/// Destroys the TimerWheel and cancels all timers.
+
+	void schedule(Timer* pTimer, const Poco::Timestamp& expires);
+		/// Schedules the given timer to expire at the given time.
+		///
+		/// If the timer is already scheduled, it is rescheduled.
+		/// A timer can only be scheduled with one TimerWheel
+		/// at a time.
+
+	void schedule(Timer* pTimer, const Poco::Timespan& delay);
+		/// Schedules the given timer to expire after the given
+		/// delay from now.
+
+	void cancel(Timer* pTimer);
+		/// Cancels the given timer. 
+		///
+		/// Does nothing if the timer is not scheduled.
+		/// If the timer has already been returned by advance()
+		/// but not yet claimed, claim() will return false
+		/// for it.
+
+	std::size_t advance(const Poco::Timestamp& now, TimerVec& expired);
+		/// Advances the wheel to the given time and appends all
+		/// timers that have expired to expired. 
+		///
+		/// Returns the number of expired timers.
+		
+	bool claim(Timer* pTimer);
+		/// Must be called for every timer returned by advance(),
+		/// immediately before acting on its expiration.
+		///
+		/// Returns false if the timer has been cancelled or rescheduled 
+		/// since it was returned by advance(), in which case its
+		/// expiration must be ignored. Otherwise returns true.
+	
+	bool nextTimeout(const Poco::Timestamp& now, Poco::Timespan& timeout) const;
+		/// If there are scheduled timers, stores the time until
+		/// advance() must be called next in timeout and returns
+		/// true. Otherwise, returns false.
+		///
+		/// The returned timeout is never longer than the time until
+		/// the first timer expires, but may be shorter if timers
+		/// must be cascaded before that.
+
+	std::size_t size() const;
+		/// Returns the number of scheduled timers.
+
+	bool empty() const;
+		/// Returns true iff no timers are scheduled.
+
+	const Poco::Timespan& resolution() const;
+		/// Returns the resolution (tick length) of the wheel.
+
+protected:
+	void add(Timer* pTimer);
+	void remove(Timer* pTimer);
+	void cascade(int level, int slot);
+	Poco::UInt64 ticks(const Poco::Timestamp& time) const;
+	static void unlink(Link* pLink);
+	static void append(Link* pList, Link* pLink);
+	static void moveAll(Link* pFrom, Link* pTo);
+	static int lowestBit(Poco::UInt64 bits);
+	static Poco::UInt64 rotate(Poco::UInt64 bits, int n);
+
+private:
+	TimerWheel(const TimerWheel&);
+	TimerWheel& operator = (const TimerWheel&);
+
+	Link            _slots[LEVELS][SLOTS];
+	Poco::UInt64    _occupied[LEVELS];
+	Poco::UInt64    _base;
+	Poco::Timestamp _origin;
+	Poco::Timespan  _resolution;
+	std::size_t     _count;
+};
+
+
+//
+// inlines
+//
+inline bool TimerWheel::Timer::isScheduled() const
+{
+	return _state == TIMER_SCHEDULED;
+}
+
+
+inline const Poco::Timestamp& TimerWheel::Timer::expires() const
+{
+	return _expires;
+}
+
+
+inline std::size_t TimerWheel::size() const
+{
+	return _count;
+}
+
+
+inline bool TimerWheel::empty() const
+{
+	return _count == 0;
+}
+
+
+inline const Poco::Timespan& TimerWheel::resolution() const
+{
+	return _resolution;
+}
+
+
+} } // namespace Poco::Net
+
+
+#endif // Net_TimerWheel_INCLUDED
@@ -60,6 +60,11 @@ public:
 	virtual int sendBytes(const void* buffer, int length, int flags);
 		/// Sends a WebSocket protocol frame.
 		
+	virtual Poco::Int64 sendFile(const std::string& path, Poco::UInt64 offset, Poco::UInt64 count);
+		/// Not supported, as data must be sent in WebSocket frames.
+		///
+		/// Returns -1.
+
 	virtual int receiveBytes(void* buffer, int length, int flags);
 		/// Receives a WebSocket protocol frame.
 		
@@ -3,7 +3,8 @@
 //
 // $Id: //poco/1.4/Net/samples/HTTPLoadTest/src/HTTPLoadTest.cpp#1 $
 //
-// This sample demonstrates the HTTPClientSession class.
+// A load generator and benchmark harness for HTTP, WebSocket
+// and TCP echo servers.
 //
 // Copyright (c) 2005-2006, Applied Informatics Software Engineering GmbH.
 // and Contributors.
@@ -32,21 +33,14 @@
 //
 
 
-#include "Poco/Net/HTTPClientSession.h"
-#include "Poco/Net/HTTPRequest.h"
-#include "Poco/Net/HTTPResponse.h"
-#include "Poco/Net/HTTPCookie.h"
-#include "Poco/Net/NameValueCollection.h"
-#include "Poco/Path.h"
+#include "LoadClient.h"
+#include "LoopbackServers.h"
+#include "Poco/Net/SocketAddress.h"
 #include "Poco/URI.h"
 #include "Poco/AutoPtr.h"
 #include "Poco/Thread.h"
-#include "Poco/Mutex.h"
-#include "Poco/Runnable.h"
-#include "Poco/Stopwatch.h"
 #include "Poco/NumberParser.h"
-#include "Poco/StreamCopier.h"
-#include "Poco/NullStream.h"
+#include "Poco/NumberFormatter.h"
 #include "Poco/Exception.h"
 #include "Poco/Util/Application.h"
 #include "Poco/Util/Option.h"
@@ -54,14 +48,11 @@
 #include "Poco/Util/HelpFormatter.h"
 #include "Poco/Util/AbstractConfiguration.h"
 #include <iostream>
+#include <iomanip>
+#include <vector>
 
 
-using Poco::Net::HTTPClientSession;
-using Poco::Net::HTTPRequest;
-using Poco::Net::HTTPResponse;
-using Poco::Net::HTTPMessage;
-using Poco::Net::HTTPCookie;
-using Poco::Net::NameValueCollection;
+using Poco::Net::SocketAddress;
 using Poco::Util::Application;
 using Poco::Util::Option;
 using Poco::Util::OptionSet;
@@ -69,155 +60,26 @@ using Poco::Util::HelpFormatter;
 using Poco::Util::AbstractConfiguration;
 using Poco::AutoPtr;
 using Poco::Thread;
-using Poco::FastMutex;
-using Poco::Runnable;
-using Poco::Stopwatch;
 using Poco::NumberParser;
-using Poco::Path;
+using Poco::NumberFormatter;
 using Poco::URI;
 using Poco::Exception;
-using Poco::StreamCopier;
-using Poco::NullOutputStream;
 
 
-class HTTPClient : public Runnable
-{
-public:
-	HTTPClient(const URI& uri, int repetitions, bool cookies=false, bool verbose=false):
-	  _uri(uri), 
-	  _verbose(verbose), 
-	  _cookies(cookies), 
-	  _repetitions(repetitions), 
-	  _usec(0), 
-	  _success(0)
-	{
-		_gRepetitions += _repetitions;
-	}
-
-	~HTTPClient()
-	{
-	}
-
-	void run()
-	{
-		Stopwatch sw;
-		std::vector<HTTPCookie> cookies;
-
-		for (int i = 0; i < _repetitions; ++i)
-		{
-			try
-			{
-				int usec = 0;
-				std::string path(_uri.getPathAndQuery());
-				if (path.empty()) path = "/";
-
-				HTTPClientSession session(_uri.getHost(), _uri.getPort());
-				HTTPRequest req(HTTPRequest::HTTP_GET, path, HTTPMessage::HTTP_1_1);
-				
-				if (_cookies)
-				{
-					NameValueCollection nvc;
-					std::vector<HTTPCookie>::iterator it = cookies.begin();
-					for(; it != cookies.end(); ++it)
-						nvc.add((*it).getName(), (*it).getValue());
-
-					req.setCookies(nvc);
-				}
-
-				HTTPResponse res;
-				sw.restart();
-				session.sendRequest(req);
-				std::istream& rs = session.receiveResponse(res);
-				NullOutputStream nos;
-				StreamCopier::copyStream(rs, nos);
-				sw.stop();
-				_success += HTTPResponse::HTTP_OK == res.getStatus() ? 1 : 0;
-				if (_cookies) res.getCookies(cookies);
-				usec = int(sw.elapsed());
-
-				if (_verbose)
-				{
-					FastMutex::ScopedLock lock(_mutex);
-					std::cout 
-					<< _uri.toString() << ' ' << res.getStatus() << ' ' << res.getReason() 
-					<< ' ' << usec/1000.0 << "ms" << std::endl;
-				}
-
-				_usec += usec;
-			}
-			catch (Exception& exc)
-			{
-				FastMutex::ScopedLock lock(_mutex);
-				std::cerr << exc.displayText() << std::endl;
-			}
-		}
-		
-		{
-			FastMutex::ScopedLock lock(_mutex);
-			_gSuccess += _success;
-			_gUsec += _usec;
-		}
-		if (_verbose)
-			printStats(_uri.toString(), _repetitions, _success, _usec);
-	}
-
-	static void printStats(std::string uri, int repetitions, int success, Poco::UInt64 usec);
-	static int totalAttempts();
-	static Poco::UInt64 totalMicroseconds();
-	static int totalSuccessCount();
-
-private:
-	HTTPClient();
-
-	URI _uri;
-	bool _verbose;
-	bool _cookies;
-	int _repetitions;
-	Poco::UInt64 _usec;
-	int _success;
-	static int _gRepetitions;
-	static Poco::UInt64 _gUsec;
-	static int _gSuccess;
-	static FastMutex _mutex;
-};
-
-FastMutex HTTPClient::_mutex;
-int HTTPClient::_gRepetitions;
-Poco::UInt64 HTTPClient::_gUsec;
-int HTTPClient::_gSuccess;
-
-int HTTPClient::totalAttempts()
-{
-	return _gRepetitions;
-}
-
-Poco::UInt64 HTTPClient::totalMicroseconds()
-{
-	return _gUsec;
-}
-
-int HTTPClient::totalSuccessCount()
-{
-	return _gSuccess;
-}
-
-void HTTPClient::printStats(std::string uri, int repetitions, int success, Poco::UInt64 usec)
-{
-	FastMutex::ScopedLock lock(_mutex);
-
-	std::cout << std::endl << "--------------" << std::endl 
-		<< "Statistics for " << uri << std::endl << "--------------" 
-		<< std::endl
-		<< repetitions << " attempts, " << success << " succesful (" 
-		<<  ((float) success / (float) repetitions) * 100.0 << "%)" << std::endl
-		<< "Avg response time: " << ((float) usec / (float) repetitions) / 1000.0 << "ms, " << std::endl
-		<< "Avg requests/second handled: " << ((float) success  /((float) usec / 1000000.0)) << std::endl
-		<< "Total time: " << (float) usec / 1000000.0 << std::endl;
-}
-
 class HTTPLoadTest: public Application
-	/// This sample demonstrates some of the features of the Poco::Util::Application class,
-	/// such as configuration file handling and command line arguments processing.
+	/// A load generator for HTTP servers.
+	///
+	/// Each connection is driven by its own thread. In addition to the
+	/// classic closed-loop mode (send the next request as soon as the previous 
+	/// response arrived), an open-loop mode with a fixed total request
+	/// rate is supported (--rate), which measures latencies from the
+	/// scheduled send time and is thus not subject to coordinated omission.
+	/// Requests can be pipelined (--pipeline) over persistent connections.
+	///
+	/// With --suite, in-process HTTP, WebSocket and SocketReactor echo servers
+	/// are started on the loopback interface and benchmarked one after the
+	/// other, using the same load parameters. This is intended to make 
+	/// performance regressions in the Net library visible.
 	///
 	/// Try HTTPLoadTest --help (on Unix platforms) or HTTPLoadTest /help (elsewhere) for
 	/// more information.
@@ -227,8 +89,8 @@ public:
 		_helpRequested(false), 
 		_verbose(false), 
 		_cookies(false),
-		_repetitions(1), 
-		_threads(1)
+		_suite(false),
+		_failed(false)
 	{
 	}
 
@@ -237,19 +99,16 @@ protected:
 	{
 		loadConfiguration(); // load default configuration files, if present
 		Application::initialize(self);
-		// add your own initialization code here
 	}
 	
 	void uninitialize()
 	{
-		// add your own uninitialization code here
 		Application::uninitialize();
 	}
 	
 	void reinitialize(Application& self)
 	{
 		Application::reinitialize(self);
-		// add your own reinitialization code here
 	}
 	
 	void defineOptions(OptionSet& options)
@@ -262,7 +121,7 @@ protected:
 				.repeatable(false));
 
 		options.addOption(
-			Option("verbose", "v", "display messages on stdout")
+			Option("verbose", "v", "display per-connection statistics")
 				.required(false)
 				.repeatable(false));
 
@@ -273,21 +132,55 @@ protected:
 
 		options.addOption(
 			Option("uri", "u", "HTTP URI")
-				.required(true)
+				.required(false)
 				.repeatable(false)
 				.argument("uri"));
 				
 		options.addOption(
-			Option("repetitions", "r", "fetch repetitions")
+			Option("repetitions", "r", "requests per connection (0 = limited by duration only, default 1)")
 				.required(false)
 				.repeatable(false)
 				.argument("repetitions"));
 
 		options.addOption(
-			Option("threads", "t", "thread count")
+			Option("threads", "t", "number of concurrent connections (default 1)")
 				.required(false)
 				.repeatable(false)
 				.argument("threads"));
+
+		options.addOption(
+			Option("duration", "d", "maximum duration of a run in seconds")
+				.required(false)
+				.repeatable(false)
+				.argument("seconds"));
+
+		options.addOption(
+			Option("rate", "R", "total request rate in requests/second (open loop)")
+				.required(false)
+				.repeatable(false)
+				.argument("rate"));
+
+		options.addOption(
+			Option("pipeline", "p", "maximum number of outstanding requests per connection (default 1)")
+				.required(false)
+				.repeatable(false)
+				.argument("depth"));
+
+		options.addOption(
+			Option("close", "C", "use a new connection for every request")
+				.required(false)
+				.repeatable(false));
+
+		options.addOption(
+			Option("size", "z", "payload size in bytes for the suite (default 64)")
+				.required(false)
+				.repeatable(false)
+				.argument("bytes"));
+
+		options.addOption(
+			Option("suite", "s", "benchmark the in-process HTTP, WebSocket and SocketReactor echo servers")
+				.required(false)
+				.repeatable(false));
 	}
 	
 	void handleOption(const std::string& name, const std::string& value)
@@ -303,9 +196,21 @@ protected:
 		else if (name == "uri")
 			_uri = value;
 		else if (name == "repetitions")
-			_repetitions = NumberParser::parse(value);
+			_spec.requests = NumberParser::parse(value);
 		else if (name == "threads")
-			_threads = NumberParser::parse(value);
+			_spec.connections = NumberParser::parse(value);
+		else if (name == "duration")
+			_spec.duration = Poco::Timespan(static_cast<Poco::Timestamp::TimeDiff>(NumberParser::parseFloat(value)*Poco::Timespan::SECONDS));
+		else if (name == "rate")
+			_spec.rate = NumberParser::parseFloat(value);
+		else if (name == "pipeline")
+			_spec.pipeline = NumberParser::parse(value);
+		else if (name == "close")
+			_spec.keepAlive = false;
+		else if (name == "size")
+			_spec.size = NumberParser::parse(value);
+		else if (name == "suite")
+			_suite = true;
 	}
 	
 	void displayHelp()
@@ -313,22 +218,110 @@ protected:
 		HelpFormatter helpFormatter(options());
 		helpFormatter.setCommand(commandName());
 		helpFormatter.setUsage("OPTIONS");
-		helpFormatter.setHeader("A sample application that demonstrates some of the features of the Poco::Util::Application class.");
+		helpFormatter.setHeader("A load generator and benchmark harness for HTTP, WebSocket and TCP echo servers.");
 		helpFormatter.format(std::cout);
 	}
-	
-	void defineProperty(const std::string& def)
+
+	template <class C>
+	void runLoad(const std::string& title, std::vector<C*>& clients)
+		/// Runs the given clients, one thread each, and 
+		/// prints the combined statistics. Takes ownership
+		/// of the clients.
+	{
+		std::vector<Thread*> threads;
+		for (typename std::vector<C*>::iterator it = clients.begin(); it != clients.end(); ++it)
+		{
+			threads.push_back(new Thread);
+			threads.back()->start(**it);
+		}
+		for (std::vector<Thread*>::iterator it = threads.begin(); it != threads.end(); ++it)
+		{
+			(*it)->join();
+			delete *it;
+		}
+
+		LoadClient::Histogram latency;
+		Poco::UInt64 successes = 0;
+		Poco::UInt64 failures = 0;
+		Poco::Timespan elapsed;
+		std::string lastError;
+		for (typename std::vector<C*>::iterator it = clients.begin(); it != clients.end(); ++it)
+		{
+			if (_verbose) printStats(title + " [connection]", (*it)->latency(), (*it)->successes(), (*it)->failures(), (*it)->elapsed());
+			latency.merge((*it)->latency());
+			successes += (*it)->successes();
+			failures  += (*it)->failures();
+			if ((*it)->elapsed() > elapsed) elapsed = (*it)->elapsed();
+			if (!(*it)->lastError().empty()) lastError = (*it)->lastError();
+			delete *it;
+		}
+		clients.clear();
+		printStats(title, latency, successes, failures, elapsed);
+		if (!lastError.empty()) std::cout << "  last error:  " << lastError << std::endl;
+		if (failures > 0) _failed = true;
+	}
+
+	void printStats(const std::string& title, const LoadClient::Histogram& latency, Poco::UInt64 successes, Poco::UInt64 failures, const Poco::Timespan& elapsed)
 	{
-		std::string name;
-		std::string value;
-		std::string::size_type pos = def.find('=');
-		if (pos != std::string::npos)
+		double seconds = elapsed.totalMicroseconds()/1000000.0;
+		std::cout << std::endl << title << std::endl;
+		std::cout << "  " << _spec.connections << " connection(s), pipeline " << (_spec.keepAlive ? _spec.pipeline : 1)
+			<< (_spec.keepAlive ? ", keep-alive" : ", no keep-alive");
+		if (_spec.rate > 0)
+			std::cout << ", open loop at " << NumberFormatter::format(_spec.rate, 1) << " req/s";
+		else
+			std::cout << ", closed loop";
+		std::cout << std::endl;
+		std::cout << "  requests:    " << successes << " ok, " << failures << " failed in " 
+			<< std::fixed << std::setprecision(3) << seconds << " s (" 
+			<< std::setprecision(1) << (seconds > 0 ? successes/seconds : 0.0) << " req/s)" << std::endl;
+		if (latency.count() > 0)
 		{
-			name.assign(def, 0, pos);
-			value.assign(def, pos + 1, def.length() - pos);
+			std::cout << "  latency ms:  min " << ms(latency.min()) 
+				<< "  mean " << ms(static_cast<Poco::UInt64>(latency.mean()))
+				<< "  p50 " << ms(latency.percentile(50))
+				<< "  p90 " << ms(latency.percentile(90))
+				<< "  p99 " << ms(latency.percentile(99))
+				<< "  p99.9 " << ms(latency.percentile(99.9))
+				<< "  max " << ms(latency.max()) << std::endl;
+		}
+	}
+
+	static std::string ms(Poco::UInt64 usec)
+	{
+		return NumberFormatter::format(usec/1000.0, 3);
+	}
+
+	void runURI(const URI& uri)
+	{
+		std::vector<HTTPLoadClient*> clients;
+		for (int i = 0; i < _spec.connections; ++i)
+			clients.push_back(new HTTPLoadClient(_spec, uri, _cookies));
+		runLoad("HTTP GET " + uri.toString(), clients);
+	}
+
+	void runSuite()
+	{
+		{
+			LoopbackHTTPServer server(_spec.connections, _spec.size);
+			URI uri("http://127.0.0.1/");
+			uri.setPort(server.port());
+			runURI(uri);
+
+			uri.setPath("/ws");
+			std::vector<WebSocketLoadClient*> clients;
+			for (int i = 0; i < _spec.connections; ++i)
+				clients.push_back(new WebSocketLoadClient(_spec, uri));
+			runLoad("WebSocket echo " + uri.toString(), clients);
+		}
+		{
+			LoopbackEchoServer server;
+			SocketAddress address("127.0.0.1", server.port());
+			std::vector<EchoLoadClient*> clients;
+			for (int i = 0; i < _spec.connections; ++i)
+				clients.push_back(new EchoLoadClient(_spec, address));
+			runLoad("SocketReactor echo " + address.toString(), clients);
 		}
-		else name = def;
-		config().setString(name, value);
 	}
 
 	int main(const std::vector<std::string>& args)
@@ -336,45 +329,33 @@ protected:
 		if (_helpRequested)
 		{
 			displayHelp();
+			return Application::EXIT_OK;
+		}
+		if (_spec.connections < 1 || _spec.size < 1 || (_spec.requests <= 0 && _spec.duration.totalMicroseconds() <= 0))
+		{
+			std::cerr << "invalid arguments: threads and size must be positive, and either repetitions or duration must be given" << std::endl;
+			return Application::EXIT_USAGE;
 		}
+		if (_suite)
+			runSuite();
+		else if (!_uri.empty())
+			runURI(URI(_uri));
 		else
 		{
-			URI uri(_uri);
-			std::vector<Thread*> threads;
-
-			Stopwatch sw;
-			sw.start();
-			for (int i = 0; i < _threads; ++i)
-			{
-				Thread* pt = new Thread(_uri);
-				poco_check_ptr(pt);
-				threads.push_back(pt);
-				HTTPClient* pHTTPClient = new HTTPClient(uri, _repetitions, _cookies, _verbose);
-				poco_check_ptr(pHTTPClient);
-				threads.back()->start(*pHTTPClient);
-			}
-
-			std::vector<Thread*>::iterator it = threads.begin();
-			for(; it != threads.end(); ++it)
-			{
-				(*it)->join();
-				delete *it;
-			}
-			sw.stop();
-
-			HTTPClient::printStats(_uri, HTTPClient::totalAttempts(), HTTPClient::totalSuccessCount(), sw.elapsed());
+			displayHelp();
+			return Application::EXIT_USAGE;
 		}
-		
-		return Application::EXIT_OK;
+		return _failed ? Application::EXIT_SOFTWARE : Application::EXIT_OK;
 	}
 	
 private:
-	bool _helpRequested;
-	bool _verbose;
-	bool _cookies;
+	bool        _helpRequested;
+	bool        _verbose;
+	bool        _cookies;
+	bool        _suite;
+	bool        _failed;
 	std::string _uri;
-	int _repetitions;
-	int _threads;
+	LoadSpec    _spec;
 };
 
 
@@ -392,4 +373,3 @@ int main(int argc, char** argv)
 	}
 	return pApp->run();
 }
-
@@ -0,0 +1,467 @@
+//
+// LoadClient.cpp
+//
+// $Id: //poco/1.4/Net/samples/HTTPLoadTest/src/LoadClient.cpp#1 $
+//
+// Implementation of the LoadClient classes.
+//
+// Copyright (c) 2013, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+// 
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+
+#include "LoadClient.h"
+#include "Poco/Net/HTTPRequest.h"
+#include "Poco/Net/HTTPResponse.h"
+#include "Poco/Net/NameValueCollection.h"
+#include "Poco/Net/NetException.h"
+#include "Poco/NumberParser.h"
+#include "Poco/Thread.h"
+#include "Poco/Exception.h"
+#include <limits>
+#include <cstring>
+
+
+using Poco::Net::StreamSocket;
+using Poco::Net::SocketStream;
+using Poco::Net::SocketAddress;
+using Poco::Net::WebSocket;
+using Poco::Net::HTTPClientSession;
+using Poco::Net::HTTPRequest;
+using Poco::Net::HTTPResponse;
+using Poco::Net::HTTPMessage;
+using Poco::Net::HTTPCookie;
+using Poco::Net::NameValueCollection;
+using Poco::Timestamp;
+using Poco::Timespan;
+using Poco::Thread;
+using Poco::URI;
+
+
+//
+// LoadSpec
+//
+
+
+LoadSpec::LoadSpec():
+	connections(1),
+	requests(1),
+	duration(0),
+	rate(0),
+	pipeline(1),
+	keepAlive(true),
+	size(64)
+{
+}
+
+
+//
+// LoadClient
+//
+
+
+LoadClient::LoadClient(const LoadSpec& spec):
+	_spec(spec),
+	_connected(false),
+	_closed(false),
+	_successes(0),
+	_failures(0)
+{
+	if (_spec.pipeline < 1 || !_spec.keepAlive) _spec.pipeline = 1;
+}
+
+
+LoadClient::~LoadClient()
+{
+}
+
+
+void LoadClient::run()
+{
+	Timestamp::TimeDiff interval = 0;
+	if (_spec.rate > 0) 
+		interval = static_cast<Timestamp::TimeDiff>(_spec.connections*1000000.0/_spec.rate);
+	
+	Timestamp start;
+	Timestamp next(start);
+	int issued = 0;
+	for (;;)
+	{
+		Timestamp now;
+		bool done = (_spec.requests > 0 && issued >= _spec.requests)
+		         || (_spec.duration.totalMicroseconds() > 0 && now - start >= _spec.duration.totalMicroseconds());
+		if (done && _outstanding.empty()) break;
+
+		// set while a request is being connected or sent, 
+		// but has not been added to _outstanding yet
+		bool unsent = true;
+		try
+		{
+			if (!_connected && _outstanding.empty())
+			{
+				connect();
+				_connected = true;
+				_closed    = false;
+			}
+			bool sent = false;
+			while (!done && !_closed && static_cast<int>(_outstanding.size()) < _spec.pipeline && (interval == 0 || next <= now))
+			{
+				unsent = true;
+				sendRequest();
+				_outstanding.push_back(interval == 0 ? now : next);
+				unsent = false;
+				next += interval;
+				sent = true;
+				done = _spec.requests > 0 && ++issued >= _spec.requests;
+			}
+			unsent = false;
+			if (sent) flush();
+		}
+		catch (Poco::Exception& exc)
+		{
+			// the requests already issued, and the one that failed to be sent, if any
+			fail(exc.displayText());
+			_failures += _outstanding.size();
+			_outstanding.clear();
+			if (unsent)
+			{
+				++_failures;
+				++issued;
+				next += interval;
+			}
+			continue;
+		}
+
+		if (_outstanding.empty())
+		{
+			// open loop: wait for the next scheduled send time
+			Timestamp::TimeDiff wait = next - Timestamp();
+			if (wait >= 1000)
+				Thread::sleep(static_cast<long>(wait/1000));
+			else if (wait > 0)
+				Thread::yield();
+			continue;
+		}
+
+		try
+		{
+			bool ok = receiveResponse();
+			Timestamp received;
+			_latency.record(received - _outstanding.front());
+			_outstanding.pop_front();
+			if (ok) ++_successes; else ++_failures;
+			if (!_spec.keepAlive || (_closed && _outstanding.empty()))
+			{
+				disconnect();
+				_connected = false;
+			}
+		}
+		catch (Poco::Exception& exc)
+		{
+			fail(exc.displayText());
+			_failures += _outstanding.size();
+			_outstanding.clear();
+		}
+	}
+	_elapsed = Timestamp() - start;
+}
+
+
+void LoadClient::fail(const std::string& message)
+{
+	_lastError = message;
+	if (_connected)
+	{
+		try
+		{
+			disconnect();
+		}
+		catch (Poco::Exception&)
+		{
+		}
+		_connected = false;
+	}
+	// avoid spinning if the server refuses connections
+	Thread::sleep(10);
+}
+
+
+//
+// HTTPLoadClient
+//
+
+
+HTTPLoadClient::HTTPLoadClient(const LoadSpec& spec, const URI& uri, bool cookies):
+	LoadClient(spec),
+	_uri(uri),
+	_path(uri.getPathAndQuery()),
+	_cookies(cookies),
+	_pStream(0)
+{
+	if (_path.empty()) _path = "/";
+}
+
+
+HTTPLoadClient::~HTTPLoadClient()
+{
+	delete _pStream;
+}
+
+
+void HTTPLoadClient::connect()
+{
+	_socket = StreamSocket(SocketAddress(_uri.getHost(), _uri.getPort()));
+	_socket.setNoDelay(true);
+	delete _pStream;
+	_pStream = new SocketStream(_socket);
+}
+
+
+void HTTPLoadClient::disconnect()
+{
+	delete _pStream;
+	_pStream = 0;
+	_socket.close();
+}
+
+
+void HTTPLoadClient::sendRequest()
+{
+	HTTPRequest request(HTTPRequest::HTTP_GET, _path, HTTPMessage::HTTP_1_1);
+	request.setHost(_uri.getHost(), _uri.getPort());
+	request.setKeepAlive(spec().keepAlive);
+	if (_cookies && !_cookieJar.empty())
+	{
+		NameValueCollection nvc;
+		for (std::vector<HTTPCookie>::const_iterator it = _cookieJar.begin(); it != _cookieJar.end(); ++it)
+			nvc.add(it->getName(), it->getValue());
+		request.setCookies(nvc);
+	}
+	request.write(*_pStream);
+}
+
+
+void HTTPLoadClient::flush()
+{
+	_pStream->flush();
+}
+
+
+bool HTTPLoadClient::receiveResponse()
+{
+	HTTPResponse response;
+	response.read(*_pStream);
+	if (response.getChunkedTransferEncoding())
+	{
+		skipChunkedBody();
+	}
+	else if (response.hasContentLength())
+	{
+		skip(response.getContentLength());
+	}
+	else
+	{
+		_pStream->ignore(std::numeric_limits<std::streamsize>::max());
+		closed();
+	}
+	if (!*_pStream) throw Poco::Net::MessageException("Incomplete response body");
+	if (!response.getKeepAlive()) closed();
+	if (_cookies) response.getCookies(_cookieJar);
+	return response.getStatus() >= 200 && response.getStatus() < 300;
+}
+
+
+void HTTPLoadClient::skip(std::streamsize n)
+{
+	// std::istream::ignore() peeks past the last character, 
+	// which would block until the next response arrives
+	char buffer[8192];
+	while (n > 0 && *_pStream)
+	{
+		std::streamsize chunk = n < static_cast<std::streamsize>(sizeof(buffer)) ? n : static_cast<std::streamsize>(sizeof(buffer));
+		_pStream->read(buffer, chunk);
+		n -= chunk;
+	}
+}
+
+
+void HTTPLoadClient::skipChunkedBody()
+{
+	std::string line;
+	for (;;)
+	{
+		std::getline(*_pStream, line);
+		if (!*_pStream) return;
+		unsigned n = Poco::NumberParser::parseHex(line.substr(0, line.find_first_of(";\r")));
+		if (n == 0) break;
+		skip(n + 2); // chunk data and CRLF
+	}
+	// skip trailer
+	do
+	{
+		std::getline(*_pStream, line);
+	}
+	while (*_pStream && line != "\r" && !line.empty());
+}
+
+
+//
+// WebSocketLoadClient
+//
+
+
+WebSocketLoadClient::WebSocketLoadClient(const LoadSpec& spec, const URI& uri):
+	LoadClient(spec),
+	_uri(uri),
+	_payload(spec.size, 'x'),
+	_buffer(spec.size + 1),
+	_pSession(0),
+	_pWebSocket(0)
+{
+}
+
+
+WebSocketLoadClient::~WebSocketLoadClient()
+{
+	delete _pWebSocket;
+	delete _pSession;
+}
+
+
+void WebSocketLoadClient::connect()
+{
+	disconnect();
+	std::string path(_uri.getPathAndQuery());
+	if (path.empty()) path = "/";
+	HTTPRequest request(HTTPRequest::HTTP_GET, path, HTTPMessage::HTTP_1_1);
+	HTTPResponse response;
+	_pSession   = new HTTPClientSession(_uri.getHost(), _uri.getPort());
+	_pWebSocket = new WebSocket(*_pSession, request, response);
+	_pWebSocket->setNoDelay(true);
+}
+
+
+void WebSocketLoadClient::disconnect()
+{
+	if (_pWebSocket)
+	{
+		try
+		{
+			_pWebSocket->shutdown();
+		}
+		catch (Poco::Exception&)
+		{
+		}
+		delete _pWebSocket;
+		_pWebSocket = 0;
+	}
+	delete _pSession;
+	_pSession = 0;
+}
+
+
+void WebSocketLoadClient::sendRequest()
+{
+	_pWebSocket->sendFrame(&_payload[0], static_cast<int>(_payload.size()), WebSocket::FRAME_BINARY);
+}
+
+
+void WebSocketLoadClient::flush()
+{
+}
+
+
+bool WebSocketLoadClient::receiveResponse()
+{
+	int flags;
+	int n = _pWebSocket->receiveFrame(&_buffer[0], static_cast<int>(_buffer.size()), flags);
+	if (n == 0 || (flags & WebSocket::FRAME_OP_BITMASK) == WebSocket::FRAME_OP_CLOSE)
+		throw Poco::Net::ConnectionResetException("WebSocket closed by peer");
+	return n == static_cast<int>(_payload.size());
+}
+
+
+//
+// EchoLoadClient
+//
+
+
+EchoLoadClient::EchoLoadClient(const LoadSpec& spec, const SocketAddress& address):
+	LoadClient(spec),
+	_address(address),
+	_payload(spec.size, 'x'),
+	_buffer(spec.size)
+{
+}
+
+
+EchoLoadClient::~EchoLoadClient()
+{
+}
+
+
+void EchoLoadClient::connect()
+{
+	_socket = StreamSocket(_address);
+	_socket.setNoDelay(true);
+}
+
+
+void EchoLoadClient::disconnect()
+{
+	_socket.close();
+}
+
+
+void EchoLoadClient::sendRequest()
+{
+	const char* p = &_payload[0];
+	int remaining = static_cast<int>(_payload.size());
+	while (remaining > 0)
+	{
+		int n = _socket.sendBytes(p, remaining);
+		p += n;
+		remaining -= n;
+	}
+}
+
+
+void EchoLoadClient::flush()
+{
+}
+
+
+bool EchoLoadClient::receiveResponse()
+{
+	int received = 0;
+	int size = static_cast<int>(_buffer.size());
+	while (received < size)
+	{
+		int n = _socket.receiveBytes(&_buffer[received], size - received);
+		if (n == 0) throw Poco::Net::ConnectionResetException("Connection closed by peer");
+		received += n;
+	}
+	return std::memcmp(&_buffer[0], &_payload[0], size) == 0;
+}
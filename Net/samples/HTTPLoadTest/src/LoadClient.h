@@ -0,0 +1,289 @@
+//
+// LoadClient.h
+//
+// $Id: //poco/1.4/Net/samples/HTTPLoadTest/src/LoadClient.h#1 $
+//
+// Definition of the LoadClient class and its HTTP, WebSocket and echo variants.
+//
+// Copyright (c) 2013, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+// 
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+
+#ifndef LoadClient_INCLUDED
+#define LoadClient_INCLUDED
+
+
+#include "Poco/Net/StreamSocket.h"
+#include "Poco/Net/SocketStream.h"
+#include "Poco/Net/WebSocket.h"
+#include "Poco/Net/HTTPClientSession.h"
+#include "Poco/Net/HTTPCookie.h"
+#include "Poco/Net/HTTPServerMetrics.h"
+#include "Poco/Runnable.h"
+#include "Poco/Timestamp.h"
+#include "Poco/Timespan.h"
+#include "Poco/URI.h"
+#include <vector>
+#include <deque>
+
+
+struct LoadSpec
+	/// The parameters of a load run, shared by all
+	/// LoadClient instances taking part in it.
+{
+	LoadSpec();
+
+	int            connections; /// number of concurrent connections (one thread each)
+	int            requests;    /// requests per connection, 0 means limited by duration only
+	Poco::Timespan duration;    /// maximum duration of the run, 0 means limited by requests only
+	double         rate;        /// total requests per second (open loop), 0 means closed loop
+	int            pipeline;    /// maximum number of outstanding requests per connection
+	bool           keepAlive;   /// reuse connections for subsequent requests
+	int            size;        /// payload size for WebSocket and echo clients
+};
+
+
+class LoadClient: public Poco::Runnable
+	/// LoadClient drives requests over a single connection
+	/// and records their latencies.
+	///
+	/// In closed-loop mode (rate == 0), a new request is sent
+	/// as soon as a pipeline slot becomes free. In open-loop mode,
+	/// requests are scheduled at fixed intervals, independent
+	/// of the server's response times, and latencies are measured
+	/// from the scheduled send time rather than the actual send
+	/// time. A server stall therefore shows up in the latency
+	/// distribution of every request that should have been sent
+	/// during the stall, instead of silently reducing the load
+	/// ("coordinated omission").
+	///
+	/// Up to LoadSpec::pipeline requests may be outstanding on a
+	/// connection. Without keep-alive, a new connection is used
+	/// for every request and pipelining is disabled.
+	///
+	/// Subclasses implement the protocol by overriding connect(),
+	/// disconnect(), sendRequest(), flush() and receiveResponse().
+{
+public:
+	typedef Poco::Net::HTTPServerMetrics::Histogram Histogram;
+
+	LoadClient(const LoadSpec& spec);
+		/// Creates the LoadClient.
+
+	virtual ~LoadClient();
+		/// Destroys the LoadClient.
+
+	void run();
+		/// Runs the load loop until the request count or
+		/// the duration given in the LoadSpec is exhausted.
+
+	const Histogram& latency() const;
+		/// Returns the latency histogram, in microseconds.
+
+	Poco::UInt64 successes() const;
+		/// Returns the number of successful requests.
+
+	Poco::UInt64 failures() const;
+		/// Returns the number of failed requests, including
+		/// requests lost due to connection errors.
+
+	Poco::Timespan elapsed() const;
+		/// Returns the wall clock time of the run.
+
+	const std::string& lastError() const;
+		/// Returns the text of the last error, or an empty string.
+
+protected:
+	virtual void connect() = 0;
+		/// Establishes the connection.
+
+	virtual void disconnect() = 0;
+		/// Closes the connection.
+
+	virtual void sendRequest() = 0;
+		/// Sends (or buffers) a single request.
+
+	virtual void flush() = 0;
+		/// Sends any buffered requests.
+
+	virtual bool receiveResponse() = 0;
+		/// Receives the response to the oldest outstanding
+		/// request. Returns true if the response indicates
+		/// success. May call closed() if the peer will close
+		/// the connection after this response.
+
+	void closed();
+		/// Marks the connection as closed by the peer. The
+		/// connection will be reestablished once all outstanding
+		/// responses have been received.
+
+	const LoadSpec& spec() const;
+
+private:
+	LoadClient();
+	LoadClient(const LoadClient&);
+	LoadClient& operator = (const LoadClient&);
+
+	void fail(const std::string& message);
+
+	LoadSpec                    _spec;
+	bool                        _connected;
+	bool                        _closed;
+	std::deque<Poco::Timestamp> _outstanding;
+	Histogram                   _latency;
+	Poco::UInt64                _successes;
+	Poco::UInt64                _failures;
+	Poco::Timespan              _elapsed;
+	std::string                 _lastError;
+};
+
+
+class HTTPLoadClient: public LoadClient
+	/// A LoadClient sending GET requests for a single URI.
+	///
+	/// Requests are written to a raw socket stream, so
+	/// they can be pipelined; responses may either have a
+	/// Content-Length or use chunked transfer encoding.
+{
+public:
+	HTTPLoadClient(const LoadSpec& spec, const Poco::URI& uri, bool cookies = false);
+	~HTTPLoadClient();
+
+protected:
+	void connect();
+	void disconnect();
+	void sendRequest();
+	void flush();
+	bool receiveResponse();
+
+	void skip(std::streamsize n);
+	void skipChunkedBody();
+
+private:
+	Poco::URI                         _uri;
+	std::string                       _path;
+	bool                              _cookies;
+	std::vector<Poco::Net::HTTPCookie> _cookieJar;
+	Poco::Net::StreamSocket           _socket;
+	Poco::Net::SocketStream*          _pStream;
+};
+
+
+class WebSocketLoadClient: public LoadClient
+	/// A LoadClient sending binary frames of LoadSpec::size
+	/// bytes to a WebSocket echo server and waiting for them
+	/// to be echoed back.
+{
+public:
+	WebSocketLoadClient(const LoadSpec& spec, const Poco::URI& uri);
+	~WebSocketLoadClient();
+
+protected:
+	void connect();
+	void disconnect();
+	void sendRequest();
+	void flush();
+	bool receiveResponse();
+
+private:
+	Poco::URI                     _uri;
+	std::vector<char>             _payload;
+	std::vector<char>             _buffer;
+	Poco::Net::HTTPClientSession* _pSession; // owns the WebSocket's socket
+	Poco::Net::WebSocket*         _pWebSocket;
+};
+
+
+class EchoLoadClient: public LoadClient
+	/// A LoadClient sending blocks of LoadSpec::size bytes
+	/// to a TCP echo server and waiting for them to be
+	/// echoed back.
+{
+public:
+	EchoLoadClient(const LoadSpec& spec, const Poco::Net::SocketAddress& address);
+	~EchoLoadClient();
+
+protected:
+	void connect();
+	void disconnect();
+	void sendRequest();
+	void flush();
+	bool receiveResponse();
+
+private:
+	Poco::Net::SocketAddress _address;
+	std::vector<char>        _payload;
+	std::vector<char>        _buffer;
+	Poco::Net::StreamSocket  _socket;
+};
+
+
+//
+// inlines
+//
+inline const LoadClient::Histogram& LoadClient::latency() const
+{
+	return _latency;
+}
+
+
+inline Poco::UInt64 LoadClient::successes() const
+{
+	return _successes;
+}
+
+
+inline Poco::UInt64 LoadClient::failures() const
+{
+	return _failures;
+}
+
+
+inline Poco::Timespan LoadClient::elapsed() const
+{
+	return _elapsed;
+}
+
+
+inline const std::string& LoadClient::lastError() const
+{
+	return _lastError;
+}
+
+
+inline const LoadSpec& LoadClient::spec() const
+{
+	return _spec;
+}
+
+
+inline void LoadClient::closed()
+{
+	_closed = true;
+}
+
+
+#endif // LoadClient_INCLUDED
@@ -0,0 +1,252 @@
+//
+// LoopbackServers.cpp
+//
+// $Id: //poco/1.4/Net/samples/HTTPLoadTest/src/LoopbackServers.cpp#1 $
+//
+// Implementation of the in-process servers used by the benchmark suite.
+//
+// Copyright (c) 2013, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+// 
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+
+#include "LoopbackServers.h"
+#include "Poco/Net/HTTPRequestHandler.h"
+#include "Poco/Net/HTTPRequestHandlerFactory.h"
+#include "Poco/Net/HTTPServerParams.h"
+#include "Poco/Net/HTTPServerRequest.h"
+#include "Poco/Net/HTTPServerResponse.h"
+#include "Poco/Net/WebSocket.h"
+#include "Poco/Net/SocketNotification.h"
+#include "Poco/Net/SocketAddress.h"
+#include "Poco/Net/StreamSocket.h"
+#include "Poco/NObserver.h"
+#include "Poco/Exception.h"
+#include <vector>
+
+
+using Poco::Net::ServerSocket;
+using Poco::Net::StreamSocket;
+using Poco::Net::SocketAddress;
+using Poco::Net::SocketReactor;
+using Poco::Net::SocketAcceptor;
+using Poco::Net::ReadableNotification;
+using Poco::Net::ShutdownNotification;
+using Poco::Net::HTTPServer;
+using Poco::Net::HTTPServerParams;
+using Poco::Net::HTTPRequestHandler;
+using Poco::Net::HTTPRequestHandlerFactory;
+using Poco::Net::HTTPServerRequest;
+using Poco::Net::HTTPServerResponse;
+using Poco::Net::HTTPResponse;
+using Poco::Net::WebSocket;
+using Poco::NObserver;
+using Poco::AutoPtr;
+
+
+class PayloadRequestHandler: public HTTPRequestHandler
+	/// Answers every request with a fixed payload.
+{
+public:
+	PayloadRequestHandler(const std::string& payload):
+		_payload(payload)
+	{
+	}
+
+	void handleRequest(HTTPServerRequest& request, HTTPServerResponse& response)
+	{
+		response.setContentType("application/octet-stream");
+		response.setContentLength(static_cast<int>(_payload.size()));
+		response.send().write(_payload.data(), static_cast<std::streamsize>(_payload.size()));
+	}
+
+private:
+	const std::string& _payload;
+};
+
+
+class WebSocketEchoRequestHandler: public HTTPRequestHandler
+	/// Echoes every WebSocket frame back to the client.
+{
+public:
+	void handleRequest(HTTPServerRequest& request, HTTPServerResponse& response)
+	{
+		try
+		{
+			WebSocket ws(request, response);
+			ws.setNoDelay(true);
+			std::vector<char> buffer(65536);
+			int flags;
+			int n;
+			do
+			{
+				n = ws.receiveFrame(&buffer[0], static_cast<int>(buffer.size()), flags);
+				if (n > 0 && (flags & WebSocket::FRAME_OP_BITMASK) != WebSocket::FRAME_OP_CLOSE)
+					ws.sendFrame(&buffer[0], n, flags);
+			}
+			while (n > 0 && (flags & WebSocket::FRAME_OP_BITMASK) != WebSocket::FRAME_OP_CLOSE);
+		}
+		catch (Poco::Exception&)
+		{
+		}
+	}
+};
+
+
+class LoopbackRequestHandlerFactory: public HTTPRequestHandlerFactory
+{
+public:
+	LoopbackRequestHandlerFactory(int payloadSize):
+		_payload(payloadSize, 'x')
+	{
+	}
+
+	HTTPRequestHandler* createRequestHandler(const HTTPServerRequest& request)
+	{
+		if (request.getURI() == "/ws")
+			return new WebSocketEchoRequestHandler;
+		else
+			return new PayloadRequestHandler(_payload);
+	}
+
+private:
+	std::string _payload;
+};
+
+
+class EchoServiceHandler
+	/// Echoes everything received on the socket. 
+{
+public:
+	EchoServiceHandler(StreamSocket& socket, SocketReactor& reactor):
+		_socket(socket),
+		_reactor(reactor),
+		_buffer(BUFFER_SIZE)
+	{
+		_socket.setNoDelay(true);
+		_reactor.addEventHandler(_socket, NObserver<EchoServiceHandler, ReadableNotification>(*this, &EchoServiceHandler::onReadable));
+		_reactor.addEventHandler(_socket, NObserver<EchoServiceHandler, ShutdownNotification>(*this, &EchoServiceHandler::onShutdown));
+	}
+
+	~EchoServiceHandler()
+	{
+		_reactor.removeEventHandler(_socket, NObserver<EchoServiceHandler, ReadableNotification>(*this, &EchoServiceHandler::onReadable));
+		_reactor.removeEventHandler(_socket, NObserver<EchoServiceHandler, ShutdownNotification>(*this, &EchoServiceHandler::onShutdown));
+	}
+
+	void onReadable(const AutoPtr<ReadableNotification>& pNf)
+	{
+		try
+		{
+			int n = _socket.receiveBytes(&_buffer[0], BUFFER_SIZE);
+			if (n > 0)
+			{
+				int sent = 0;
+				while (sent < n) sent += _socket.sendBytes(&_buffer[sent], n - sent);
+				return;
+			}
+		}
+		catch (Poco::Exception&)
+		{
+		}
+		delete this;
+	}
+
+	void onShutdown(const AutoPtr<ShutdownNotification>& pNf)
+	{
+		delete this;
+	}
+
+private:
+	enum
+	{
+		BUFFER_SIZE = 65536
+	};
+
+	StreamSocket      _socket;
+	SocketReactor&    _reactor;
+	std::vector<char> _buffer;
+};
+
+
+//
+// LoopbackHTTPServer
+//
+
+
+LoopbackHTTPServer::LoopbackHTTPServer(int threads, int payloadSize):
+	_threadPool(2, threads + 2),
+	_socket(SocketAddress("127.0.0.1", 0)),
+	_pServer(0)
+{
+	HTTPServerParams::Ptr pParams = new HTTPServerParams;
+	pParams->setKeepAlive(true);
+	pParams->setMaxKeepAliveRequests(0);
+	pParams->setMaxThreads(threads);
+	pParams->setMaxQueued(threads*4);
+	_pServer = new HTTPServer(new LoopbackRequestHandlerFactory(payloadSize), _threadPool, _socket, pParams);
+	_pServer->start();
+}
+
+
+LoopbackHTTPServer::~LoopbackHTTPServer()
+{
+	_pServer->stopAll(true);
+	delete _pServer;
+}
+
+
+Poco::UInt16 LoopbackHTTPServer::port() const
+{
+	return _socket.address().port();
+}
+
+
+//
+// LoopbackEchoServer
+//
+
+
+LoopbackEchoServer::LoopbackEchoServer():
+	_socket(SocketAddress("127.0.0.1", 0)),
+	_pAcceptor(0)
+{
+	_pAcceptor = new SocketAcceptor<EchoServiceHandler>(_socket, _reactor);
+	_thread.start(_reactor);
+}
+
+
+LoopbackEchoServer::~LoopbackEchoServer()
+{
+	_reactor.stop();
+	_thread.join();
+	delete _pAcceptor;
+}
+
+
+Poco::UInt16 LoopbackEchoServer::port() const
+{
+	return _socket.address().port();
+}
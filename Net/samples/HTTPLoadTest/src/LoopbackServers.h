@@ -0,0 +1,97 @@
+//
+// LoopbackServers.h
+//
+// $Id: //poco/1.4/Net/samples/HTTPLoadTest/src/LoopbackServers.h#1 $
+//
+// Definition of the in-process servers used by the benchmark suite.
+//
+// Copyright (c) 2013, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+// 
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+
+#ifndef LoopbackServers_INCLUDED
+#define LoopbackServers_INCLUDED
+
+
+#include "Poco/Net/HTTPServer.h"
+#include "Poco/Net/ServerSocket.h"
+#include "Poco/Net/SocketReactor.h"
+#include "Poco/Net/SocketAcceptor.h"
+#include "Poco/ThreadPool.h"
+#include "Poco/Thread.h"
+
+
+class EchoServiceHandler;
+
+
+class LoopbackHTTPServer
+	/// An HTTPServer listening on the loopback interface.
+	///
+	/// Requests for /ws are upgraded to a WebSocket connection,
+	/// and every frame received is echoed back. All other requests
+	/// are answered with a payload of the configured size.
+{
+public:
+	LoopbackHTTPServer(int threads, int payloadSize);
+		/// Creates and starts the server on an ephemeral port, 
+		/// using a thread pool with the given number of threads.
+
+	~LoopbackHTTPServer();
+		/// Stops and destroys the server.
+
+	Poco::UInt16 port() const;
+		/// Returns the port the server is listening on.
+
+private:
+	Poco::ThreadPool       _threadPool;
+	Poco::Net::ServerSocket _socket;
+	Poco::Net::HTTPServer* _pServer;
+};
+
+
+class LoopbackEchoServer
+	/// A TCP echo server listening on the loopback interface,
+	/// driven by a SocketReactor.
+{
+public:
+	LoopbackEchoServer();
+		/// Creates and starts the server on an ephemeral port.
+
+	~LoopbackEchoServer();
+		/// Stops and destroys the server.
+
+	Poco::UInt16 port() const;
+		/// Returns the port the server is listening on.
+
+private:
+	Poco::Net::ServerSocket                          _socket;
+	Poco::Net::SocketReactor                         _reactor;
+	Poco::Net::SocketAcceptor<EchoServiceHandler>*  _pAcceptor;
+	Poco::Thread                                     _thread;
+};
+
+
+#endif // LoopbackServers_INCLUDED
@@ -0,0 +1,199 @@
+//
+// SocketStreamBenchmark.cpp
+//
+// $Id: //poco/1.4/Net/samples/SocketStreamBenchmark/src/SocketStreamBenchmark.cpp#1 $
+//
+// This sample measures the throughput of SocketStream over a loopback
+// connection for different stream buffer sizes and read/write sizes.
+//
+// Copyright (c) 2013, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+// 
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+
+
+
+#include "Poco/Net/SocketStream.h"
+#include "Poco/Net/StreamSocket.h"
+#include "Poco/Net/ServerSocket.h"
+#include "Poco/Net/SocketAddress.h"
+#include "Poco/Runnable.h"
+#include "Poco/Thread.h"
+#include "Poco/Stopwatch.h"
+#include "Poco/Buffer.h"
+#include "Poco/NumberParser.h"
+#include "Poco/Exception.h"
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <cstring>
+
+
+using Poco::Net::SocketStream;
+using Poco::Net::StreamSocket;
+using Poco::Net::ServerSocket;
+using Poco::Net::SocketAddress;
+using Poco::Runnable;
+using Poco::Thread;
+using Poco::Stopwatch;
+using Poco::Buffer;
+using Poco::NumberParser;
+using Poco::Exception;
+
+
+class Sink: public Runnable
+	/// Accepts a connection and discards everything received.
+{
+public:
+	Sink(ServerSocket& socket):
+		_socket(socket)
+	{
+	}
+	
+	void run()
+	{
+		StreamSocket ss = _socket.acceptConnection();
+		Buffer<char> buffer(65536);
+		while (ss.receiveBytes(buffer.begin(), static_cast<int>(buffer.size())) > 0);
+	}
+
+private:
+	ServerSocket& _socket;
+};
+
+
+class Source: public Runnable
+	/// Accepts a connection and sends the given number of bytes.
+{
+public:
+	Source(ServerSocket& socket, Poco::UInt64 total):
+		_socket(socket),
+		_total(total)
+	{
+	}
+	
+	void run()
+	{
+		StreamSocket ss = _socket.acceptConnection();
+		Buffer<char> buffer(65536);
+		std::memset(buffer.begin(), 'x', buffer.size());
+		Poco::UInt64 sent = 0;
+		while (sent < _total)
+		{
+			int n = static_cast<int>(std::min<Poco::UInt64>(buffer.size(), _total - sent));
+			sent += ss.sendBytes(buffer.begin(), n);
+		}
+		ss.shutdownSend();
+	}
+
+private:
+	ServerSocket& _socket;
+	Poco::UInt64  _total;
+};
+
+
+double measureWrite(std::streamsize bufferSize, std::streamsize chunkSize, Poco::UInt64 total)
+{
+	ServerSocket server(SocketAddress("127.0.0.1", 0));
+	Sink sink(server);
+	Thread thread;
+	thread.start(sink);
+
+	StreamSocket ss(server.address());
+	Buffer<char> chunk(static_cast<std::size_t>(chunkSize));
+	std::memset(chunk.begin(), 'x', chunk.size());
+	Stopwatch sw;
+	sw.start();
+	{
+		SocketStream str(ss, bufferSize);
+		for (Poco::UInt64 written = 0; written < total; written += chunkSize)
+		{
+			str.write(chunk.begin(), chunkSize);
+		}
+		str.flush();
+	}
+	ss.shutdownSend();
+	thread.join();
+	sw.stop();
+	return double(total)/(1024*1024)/(double(sw.elapsed())/Stopwatch::resolution());
+}
+
+
+double measureRead(std::streamsize bufferSize, std::streamsize chunkSize, Poco::UInt64 total)
+{
+	ServerSocket server(SocketAddress("127.0.0.1", 0));
+	Source source(server, total);
+	Thread thread;
+	thread.start(source);
+
+	StreamSocket ss(server.address());
+	Buffer<char> chunk(static_cast<std::size_t>(chunkSize));
+	Stopwatch sw;
+	sw.start();
+	{
+		SocketStream str(ss, bufferSize);
+		while (str.read(chunk.begin(), chunkSize) || str.gcount() > 0);
+	}
+	thread.join();
+	sw.stop();
+	return double(total)/(1024*1024)/(double(sw.elapsed())/Stopwatch::resolution());
+}
+
+
+int main(int argc, char** argv)
+{
+	Poco::UInt64 total = 256;
+	if (argc > 1 && !NumberParser::tryParseUnsigned64(argv[1], total))
+	{
+		std::cout << "usage: SocketStreamBenchmark [<megabytes>]" << std::endl;
+		return 1;
+	}
+	total *= 1024*1024;
+
+	const std::streamsize bufferSizes[] = {1024, 8192, 65536};
+	const std::streamsize chunkSizes[] = {64, 1024, 16384, 262144};
+	
+	try
+	{
+		std::cout << "Throughput in MB/s over " << (total >> 20) << " MB" << std::endl << std::endl;
+		std::cout << std::setw(12) << "buffer" << std::setw(12) << "chunk" << std::setw(12) << "write" << std::setw(12) << "read" << std::endl;
+		for (std::size_t b = 0; b < sizeof(bufferSizes)/sizeof(bufferSizes[0]); ++b)
+		{
+			for (std::size_t c = 0; c < sizeof(chunkSizes)/sizeof(chunkSizes[0]); ++c)
+			{
+				double w = measureWrite(bufferSizes[b], chunkSizes[c], total);
+				double r = measureRead(bufferSizes[b], chunkSizes[c], total);
+				std::cout << std::setw(12) << bufferSizes[b] << std::setw(12) << chunkSizes[c] 
+				          << std::fixed << std::setprecision(1) << std::setw(12) << w << std::setw(12) << r << std::endl;
+			}
+		}
+	}
+	catch (Exception& exc)
+	{
+		std::cerr << exc.displayText() << std::endl;
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,372 @@
+//
+// AsyncConnect.cpp
+//
+// $Id: //poco/1.4/Net/src/AsyncConnect.cpp#1 $
+//
+// Library: Net
+// Package: Reactor
+// Module:  AsyncConnect
+//
+// Copyright (c) 2013, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+// 
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+
+#include "Poco/Net/AsyncConnect.h"
+#include "Poco/Net/NetException.h"
+#include "Poco/Observer.h"
+#include "Poco/Exception.h"
+
+
+namespace Poco {
+namespace Net {
+
+
+AsyncConnect::AsyncConnect(SocketReactor& reactor, const SocketAddress& address, const Poco::Timespan& timeout, const Poco::AbstractObserver& observer):
+	_reactor(reactor),
+	_pObserver(observer.clone()),
+	_next(0),
+	_timeout(timeout),
+	_attemptDelay(DEFAULT_ATTEMPT_DELAY),
+	_attemptTimeout(0),
+	_started(false),
+	_done(false),
+	_lastError(0)
+{
+	init(Addresses(1, address));
+}
+
+
+AsyncConnect::AsyncConnect(SocketReactor& reactor, const HostEntry& host, Poco::UInt16 port, const Poco::Timespan& timeout, const Poco::AbstractObserver& observer):
+	_reactor(reactor),
+	_pObserver(observer.clone()),
+	_next(0),
+	_timeout(timeout),
+	_attemptDelay(DEFAULT_ATTEMPT_DELAY),
+	_attemptTimeout(0),
+	_started(false),
+	_done(false),
+	_lastError(0)
+{
+	Addresses addresses;
+	for (HostEntry::AddressList::const_iterator it = host.addresses().begin(); it != host.addresses().end(); ++it)
+	{
+		addresses.push_back(SocketAddress(*it, port));
+	}
+	init(addresses);
+}
+
+
+AsyncConnect::AsyncConnect(SocketReactor& reactor, const Addresses& addresses, const Poco::Timespan& timeout, const Poco::AbstractObserver& observer):
+	_reactor(reactor),
+	_pObserver(observer.clone()),
+	_next(0),
+	_timeout(timeout),
+	_attemptDelay(DEFAULT_ATTEMPT_DELAY),
+	_attemptTimeout(0),
+	_started(false),
+	_done(false),
+	_lastError(0)
+{
+	init(addresses);
+}
+
+
+AsyncConnect::~AsyncConnect()
+{
+	try
+	{
+		complete(ConnectNotification::CONNECT_CANCELLED, Socket(), 0);
+	}
+	catch (...)
+	{
+	}
+	delete _pObserver;
+}
+
+
+void AsyncConnect::init(const Addresses& addresses)
+{
+	if (addresses.empty()) throw Poco::InvalidArgumentException("AsyncConnect requires at least one address");
+
+	// interleave address families, starting with IPv6
+	Addresses primary;
+	Addresses secondary;
+	for (Addresses::const_iterator it = addresses.begin(); it != addresses.end(); ++it)
+	{
+#if defined(POCO_HAVE_IPv6)
+		if (it->family() == IPAddress::IPv6)
+			primary.push_back(*it);
+		else
+#endif
+			secondary.push_back(*it);
+	}
+	Addresses::const_iterator itp = primary.begin();
+	Addresses::const_iterator its = secondary.begin();
+	while (itp != primary.end() || its != secondary.end())
+	{
+		if (itp != primary.end()) _addresses.push_back(*itp++);
+		if (its != secondary.end()) _addresses.push_back(*its++);
+	}
+	_lastAddress = _addresses.front();
+}
+
+
+void AsyncConnect::setAttemptDelay(const Poco::Timespan& delay)
+{
+	_attemptDelay = delay;
+}
+
+
+void AsyncConnect::setAttemptTimeout(const Poco::Timespan& timeout)
+{
+	_attemptTimeout = timeout;
+}
+
+
+void AsyncConnect::start()
+{
+	{
+		Poco::Mutex::ScopedLock lock(_mutex);
+
+		if (_started || _done) throw Poco::IllegalStateException("AsyncConnect already started");
+		_started = true;
+		duplicate(); // released in notify()
+		if (_timeout.totalMicroseconds() > 0)
+			_pDeadlineTimer = _reactor.scheduleTimer(_timeout, Poco::Observer<AsyncConnect, TimerNotification>(*this, &AsyncConnect::onDeadline));
+		startAttempts();
+	}
+	notify();
+}
+
+
+void AsyncConnect::cancel()
+{
+	{
+		Poco::Mutex::ScopedLock lock(_mutex);
+
+		complete(ConnectNotification::CONNECT_CANCELLED, Socket(), 0);
+	}
+	notify();
+}
+
+
+bool AsyncConnect::done() const
+{
+	Poco::Mutex::ScopedLock lock(_mutex);
+
+	return _done;
+}
+
+
+void AsyncConnect::onWritable(WritableNotification* pNf)
+{
+	pNf->release();
+	{
+		Poco::Mutex::ScopedLock lock(_mutex);
+
+		int err = pNf->socket().impl()->socketError();
+		if (err)
+			failAttempt(pNf->socket(), err);
+		else if (findAttempt(pNf->socket()) != _attempts.end())
+			complete(ConnectNotification::CONNECT_OK, pNf->socket(), 0);
+	}
+	notify();
+}
+
+
+void AsyncConnect::onError(ErrorNotification* pNf)
+{
+	pNf->release();
+	{
+		Poco::Mutex::ScopedLock lock(_mutex);
+
+		int err = pNf->socket().impl()->socketError();
+		failAttempt(pNf->socket(), err ? err : POCO_ECONNREFUSED);
+	}
+	notify();
+}
+
+
+void AsyncConnect::onAttemptTimeout(TimerNotification* pNf)
+{
+	pNf->release();
+	{
+		Poco::Mutex::ScopedLock lock(_mutex);
+
+		failAttempt(pNf->socket(), POCO_ETIMEDOUT);
+	}
+	notify();
+}
+
+
+void AsyncConnect::onAttemptDelay(TimerNotification* pNf)
+{
+	pNf->release();
+	{
+		Poco::Mutex::ScopedLock lock(_mutex);
+
+		if (!_done) startAttempts();
+	}
+	notify();
+}
+
+
+void AsyncConnect::onDeadline(TimerNotification* pNf)
+{
+	pNf->release();
+	{
+		Poco::Mutex::ScopedLock lock(_mutex);
+
+		complete(ConnectNotification::CONNECT_TIMEOUT, Socket(), POCO_ETIMEDOUT);
+	}
+	notify();
+}
+
+
+void AsyncConnect::startAttempts()
+{
+	// Starts the next attempt. Attempts that fail immediately are
+	// skipped. If there are further addresses, the attempt delay timer
+	// is (re)started so that the next attempt runs in parallel.
+	while (_next < _addresses.size())
+	{
+		Attempt attempt;
+		attempt.address = _addresses[_next++];
+		_lastAddress = attempt.address;
+		try
+		{
+			attempt.socket.connectNB(attempt.address);
+		}
+		catch (Poco::Exception& exc)
+		{
+			_lastError = exc.code();
+			continue;
+		}
+		_reactor.addEventHandler(attempt.socket, Poco::Observer<AsyncConnect, WritableNotification>(*this, &AsyncConnect::onWritable));
+		_reactor.addEventHandler(attempt.socket, Poco::Observer<AsyncConnect, ErrorNotification>(*this, &AsyncConnect::onError));
+		if (_attemptTimeout.totalMicroseconds() > 0)
+			attempt.pTimer = _reactor.scheduleTimer(attempt.socket, _attemptTimeout, Poco::Observer<AsyncConnect, TimerNotification>(*this, &AsyncConnect::onAttemptTimeout));
+		_attempts.push_back(attempt);
+
+		if (_next < _addresses.size())
+		{
+			if (_pDelayTimer)
+				_reactor.rescheduleTimer(_pDelayTimer, _attemptDelay);
+			else
+				_pDelayTimer = _reactor.scheduleTimer(_attemptDelay, Poco::Observer<AsyncConnect, TimerNotification>(*this, &AsyncConnect::onAttemptDelay));
+		}
+		return;
+	}
+	if (_attempts.empty())
+	{
+		complete(ConnectNotification::CONNECT_FAILED, Socket(), _lastError);
+	}
+}
+
+
+AsyncConnect::Attempts::iterator AsyncConnect::findAttempt(const Socket& socket)
+{
+	Attempts::iterator it = _attempts.begin();
+	while (it != _attempts.end() && !(it->socket == socket)) ++it;
+	return it;
+}
+
+
+void AsyncConnect::failAttempt(const Socket& socket, int error)
+{
+	if (_done) return;
+	
+	Attempts::iterator it = findAttempt(socket);
+	if (it != _attempts.end())
+	{
+		_lastAddress = it->address;
+		_lastError   = error;
+		removeAttempt(it);
+		it->socket.close();
+		_attempts.erase(it);
+		startAttempts();
+	}
+}
+
+
+void AsyncConnect::removeAttempt(Attempts::iterator it)
+{
+	_reactor.removeEventHandler(it->socket, Poco::Observer<AsyncConnect, WritableNotification>(*this, &AsyncConnect::onWritable));
+	_reactor.removeEventHandler(it->socket, Poco::Observer<AsyncConnect, ErrorNotification>(*this, &AsyncConnect::onError));
+	if (it->pTimer) _reactor.cancelTimer(it->pTimer);
+}
+
+
+void AsyncConnect::complete(ConnectNotification::Result result, const Socket& socket, int error)
+{
+	if (_done) return;
+	_done = true;
+	
+	SocketAddress address(_lastAddress);
+	for (Attempts::iterator it = _attempts.begin(); it != _attempts.end(); ++it)
+	{
+		removeAttempt(it);
+		if (it->socket == socket)
+		{
+			address = it->address;
+			it->socket.setBlocking(true);
+		}
+		else it->socket.close();
+	}
+	_attempts.clear();
+	if (_pDelayTimer) _reactor.cancelTimer(_pDelayTimer);
+	if (_pDeadlineTimer) _reactor.cancelTimer(_pDeadlineTimer);
+	
+	if (_started) _pResult = new ConnectNotification(&_reactor, result, socket, address, error);
+}
+
+
+void AsyncConnect::notify()
+{
+	Poco::AutoPtr<ConnectNotification> pResult;
+	{
+		Poco::Mutex::ScopedLock lock(_mutex);
+		
+		pResult = _pResult;
+		_pResult = 0;
+	}
+	if (pResult)
+	{
+		try
+		{
+			_pObserver->notify(pResult);
+		}
+		catch (...)
+		{
+			release();
+			throw;
+		}
+		release(); // may delete this
+	}
+}
+
+
+} } // namespace Poco::Net
@@ -0,0 +1,414 @@
+//
+// AsyncIOEngine.cpp
+//
+// $Id: //poco/1.4/Net/src/AsyncIOEngine.cpp#1 $
+//
+// Library: Net
+// Package: Reactor
+// Module:  AsyncIOEngine
+//
+// Copyright (c) 2013, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+// 
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+
+
+
+#include "Poco/Net/AsyncIOEngine.h"
+#include "Poco/Net/IOUringEngine.h"
+#include "Poco/Net/EPollEngine.h"
+#include "Poco/Net/NetException.h"
+#include "Poco/ErrorHandler.h"
+#include "Poco/Exception.h"
+
+
+namespace Poco {
+namespace Net {
+
+
+//
+// AsyncIOBufferPool
+//
+
+
+AsyncIOBufferPool::AsyncIOBufferPool(int bufferCount, int bufferSize):
+	_bufferCount(bufferCount),
+	_bufferSize(bufferSize),
+	_pMemory(new char[static_cast<std::size_t>(bufferCount)*bufferSize])
+{
+	poco_assert (bufferCount > 0 && bufferSize > 0);
+
+	_free.reserve(bufferCount);
+	for (int i = bufferCount - 1; i >= 0; --i)
+	{
+		_free.push_back(i);
+	}
+}
+
+
+AsyncIOBufferPool::~AsyncIOBufferPool()
+{
+	delete [] _pMemory;
+}
+
+
+int AsyncIOBufferPool::acquireBuffer()
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	if (_free.empty()) return -1;
+	int index = _free.back();
+	_free.pop_back();
+	return index;
+}
+
+
+void AsyncIOBufferPool::releaseBuffer(int index)
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	poco_assert_dbg (index >= 0 && index < _bufferCount);
+
+	_free.push_back(index);
+}
+
+
+int AsyncIOBufferPool::availableBuffers() const
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	return static_cast<int>(_free.size());
+}
+
+
+//
+// AsyncIOOperation
+//
+
+
+AsyncIOOperation::AsyncIOOperation(Type type, const Socket& socket, const Poco::AbstractObserver* pObserver):
+	_type(type),
+	_socket(socket),
+	_pObserver(pObserver ? pObserver->clone() : 0),
+	_result(-1),
+	_error(0),
+	_canceled(false),
+	_event(false),
+	_cancelPending(false),
+	_bufferIndex(-1),
+	_pBuffer(0),
+	_length(0),
+	_pSendBuffer(0),
+	_sent(0),
+	_pEngineData(0)
+{
+}
+
+
+AsyncIOOperation::~AsyncIOOperation()
+{
+	if (_bufferIndex >= 0)
+		_pPool->releaseBuffer(_bufferIndex);
+	else if (_type == OP_RECEIVE)
+		delete [] _pBuffer;
+	delete _pObserver;
+}
+
+
+bool AsyncIOOperation::done() const
+{
+	return const_cast<Poco::Event&>(_event).tryWait(0);
+}
+
+
+void AsyncIOOperation::wait()
+{
+	_event.wait();
+}
+
+
+bool AsyncIOOperation::tryWait(long milliseconds)
+{
+	return _event.tryWait(milliseconds);
+}
+
+
+void AsyncIOOperation::throwOnError() const
+{
+	if (_canceled)
+		throw NetException("Asynchronous operation canceled");
+	else if (_error != 0)
+		throw NetException("Asynchronous operation failed", _error);
+}
+
+
+void AsyncIOOperation::complete(int result, int error)
+{
+	_result = error == 0 ? result : -1;
+	_error  = error;
+	if (_pObserver)
+	{
+		try
+		{
+			Poco::AutoPtr<AsyncIONotification> pNf = new AsyncIONotification(this);
+			_pObserver->notify(pNf);
+		}
+		catch (Poco::Exception& exc)
+		{
+			Poco::ErrorHandler::handle(exc);
+		}
+		catch (std::exception& exc)
+		{
+			Poco::ErrorHandler::handle(exc);
+		}
+		catch (...)
+		{
+			Poco::ErrorHandler::handle();
+		}
+	}
+	_event.set();
+}
+
+
+void AsyncIOOperation::cancel()
+{
+	_canceled = true;
+	complete(-1, 0);
+}
+
+
+//
+// AsyncIONotification
+//
+
+
+AsyncIONotification::AsyncIONotification(AsyncIOOperation* pOperation):
+	_pOperation(pOperation)
+{
+	_pOperation->duplicate();
+}
+
+
+AsyncIONotification::~AsyncIONotification()
+{
+	_pOperation->release();
+}
+
+
+//
+// AsyncIOEngine
+//
+
+
+AsyncIOEngine::AsyncIOEngine(int bufferCount, int bufferSize):
+	_pPool(new AsyncIOBufferPool(bufferCount, bufferSize)),
+	_thread("AsyncIOEngine"),
+	_stopping(false)
+{
+}
+
+
+AsyncIOEngine::~AsyncIOEngine()
+{
+	poco_assert_dbg (!_thread.isRunning());
+}
+
+
+AsyncIOEngine::Ptr AsyncIOEngine::create(int bufferCount, int bufferSize)
+{
+#if POCO_OS == POCO_OS_LINUX
+	try
+	{
+		return new IOUringEngine(bufferCount, bufferSize);
+	}
+	catch (Poco::Exception&)
+	{
+	}
+	return new EPollEngine(bufferCount, bufferSize);
+#else
+	throw Poco::NotImplementedException("AsyncIOEngine is not available on this platform");
+#endif
+}
+
+
+void AsyncIOEngine::start()
+{
+	poco_assert (!_thread.isRunning());
+
+	_stopping = false;
+	_thread.start(*this);
+}
+
+
+void AsyncIOEngine::stop()
+{
+	if (_thread.isRunning())
+	{
+		{
+			Poco::FastMutex::ScopedLock lock(_mutex);
+
+			_stopping = true;
+			for (OperationSet::iterator it = _pending.begin(); it != _pending.end(); ++it)
+			{
+				cancelOperation(*it);
+			}
+		}
+		wakeUp();
+		_thread.join();
+	}
+}
+
+
+bool AsyncIOEngine::running() const
+{
+	return _thread.isRunning() && !_stopping;
+}
+
+
+AsyncIOOperation::Ptr AsyncIOEngine::accept(const ServerSocket& socket, const Poco::AbstractObserver* pObserver)
+{
+	return startOperation(new AsyncIOOperation(AsyncIOOperation::OP_ACCEPT, socket, pObserver));
+}
+
+
+AsyncIOOperation::Ptr AsyncIOEngine::receive(const StreamSocket& socket, const Poco::AbstractObserver* pObserver)
+{
+	AsyncIOOperation* pOperation = new AsyncIOOperation(AsyncIOOperation::OP_RECEIVE, socket, pObserver);
+	pOperation->_pPool = _pPool;
+	pOperation->_bufferIndex = _pPool->acquireBuffer();
+	if (pOperation->_bufferIndex >= 0)
+		pOperation->_pBuffer = _pPool->buffer(pOperation->_bufferIndex);
+	else
+		pOperation->_pBuffer = new char[_pPool->bufferSize()];
+	pOperation->_length = _pPool->bufferSize();
+	return startOperation(pOperation);
+}
+
+
+AsyncIOOperation::Ptr AsyncIOEngine::send(const StreamSocket& socket, const void* buffer, int length, const Poco::AbstractObserver* pObserver)
+{
+	AsyncIOOperation* pOperation = new AsyncIOOperation(AsyncIOOperation::OP_SEND, socket, pObserver);
+	pOperation->_pSendBuffer = reinterpret_cast<const char*>(buffer);
+	pOperation->_length = length;
+	return startOperation(pOperation);
+}
+
+
+AsyncIOOperation::Ptr AsyncIOEngine::poll(const StreamSocket& socket, const Poco::Timespan& timeout, const Poco::AbstractObserver* pObserver)
+{
+	AsyncIOOperation* pOperation = new AsyncIOOperation(AsyncIOOperation::OP_POLL, socket, pObserver);
+	pOperation->_timeout = timeout;
+	pOperation->_deadline += timeout.totalMicroseconds();
+	return startOperation(pOperation);
+}
+
+
+AsyncIOOperation::Ptr AsyncIOEngine::close(const StreamSocket& socket, const Poco::AbstractObserver* pObserver)
+{
+	return startOperation(new AsyncIOOperation(AsyncIOOperation::OP_CLOSE, socket, pObserver));
+}
+
+
+void AsyncIOEngine::cancel(AsyncIOOperation::Ptr pOperation)
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	if (_pending.find(pOperation) != _pending.end())
+	{
+		cancelOperation(pOperation);
+	}
+}
+
+
+int AsyncIOEngine::pending() const
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	return static_cast<int>(_pending.size());
+}
+
+
+AsyncIOOperation::Ptr AsyncIOEngine::startOperation(AsyncIOOperation* pOperation)
+{
+	AsyncIOOperation::Ptr pResult(pOperation);
+	if (!pOperation->_socket.impl()->initialized()) throw InvalidSocketException();
+
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	if (!running()) throw Poco::IllegalStateException("AsyncIOEngine is not running");
+	_pending.insert(pOperation);
+	pOperation->duplicate();
+	try
+	{
+		submit(pOperation);
+	}
+	catch (...)
+	{
+		_pending.erase(pOperation);
+		pOperation->release();
+		throw;
+	}
+	return pResult;
+}
+
+
+bool AsyncIOEngine::remove(AsyncIOOperation* pOperation)
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	return _pending.erase(pOperation) > 0;
+}
+
+
+void AsyncIOEngine::completed(AsyncIOOperation* pOperation, int result, int error)
+{
+	if (remove(pOperation))
+	{
+		pOperation->complete(result, error);
+		pOperation->release();
+	}
+}
+
+
+void AsyncIOEngine::canceled(AsyncIOOperation* pOperation)
+{
+	if (remove(pOperation))
+	{
+		pOperation->cancel();
+		pOperation->release();
+	}
+}
+
+
+poco_socket_t AsyncIOEngine::detach(const Socket& socket)
+{
+	SocketImpl* pImpl = socket.impl();
+	poco_socket_t fd = pImpl->sockfd();
+	pImpl->reset();
+	return fd;
+}
+
+
+} } // namespace Poco::Net
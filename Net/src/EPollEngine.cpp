@@ -0,0 +1,430 @@
+//
+// EPollEngine.cpp
+//
+// $Id: //poco/1.4/Net/src/EPollEngine.cpp#1 $
+//
+// Library: Net
+// Package: Reactor
+// Module:  EPollEngine
+//
+// Copyright (c) 2013, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+// 
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+
+
+
+#include "Poco/Net/EPollEngine.h"
+#include "Poco/Net/StreamSocketImpl.h"
+#include "Poco/Net/NetException.h"
+#include "Poco/Exception.h"
+#if POCO_OS == POCO_OS_LINUX
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <poll.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+
+namespace Poco {
+namespace Net {
+
+
+#if POCO_OS == POCO_OS_LINUX
+
+
+EPollEngine::EPollEngine(int bufferCount, int bufferSize):
+	AsyncIOEngine(bufferCount, bufferSize),
+	_epollfd(epoll_create1(EPOLL_CLOEXEC)),
+	_eventfd(-1)
+{
+	if (_epollfd < 0) throw NetException("Cannot create epoll instance", errno);
+	_eventfd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	if (_eventfd < 0)
+	{
+		::close(_epollfd);
+		throw NetException("Cannot create eventfd", errno);
+	}
+	struct epoll_event ev;
+	ev.events = EPOLLIN;
+	ev.data.fd = _eventfd;
+	epoll_ctl(_epollfd, EPOLL_CTL_ADD, _eventfd, &ev);
+}
+
+
+EPollEngine::~EPollEngine()
+{
+	try
+	{
+		stop();
+	}
+	catch (...)
+	{
+	}
+	::close(_eventfd);
+	::close(_epollfd);
+}
+
+
+std::string EPollEngine::name() const
+{
+	return "epoll";
+}
+
+
+int EPollEngine::fd(AsyncIOOperation* pOperation)
+{
+	return static_cast<int>(reinterpret_cast<long>(pOperation->_pEngineData));
+}
+
+
+void EPollEngine::submit(AsyncIOOperation* pOperation)
+{
+	int sockfd = pOperation->socket().impl()->sockfd();
+	pOperation->_pEngineData = reinterpret_cast<void*>(static_cast<long>(sockfd));
+	if (pOperation->type() == AsyncIOOperation::OP_CLOSE)
+	{
+		detach(pOperation->socket());
+		if (sockfd < static_cast<int>(_watches.size()))
+		{
+			// operations still pending on the socket fail
+			Watch& watch = _watches[sockfd];
+			Queue ops(watch.readers);
+			ops.insert(ops.end(), watch.writers.begin(), watch.writers.end());
+			for (Queue::iterator it = ops.begin(); it != ops.end(); ++it)
+			{
+				dequeue(*it);
+				done(*it, -1, EBADF);
+			}
+			if (watch.events) epoll_ctl(_epollfd, EPOLL_CTL_DEL, sockfd, 0);
+			watch.events = 0;
+		}
+		int rc = ::close(sockfd);
+		done(pOperation, rc == 0 ? 0 : -1, rc == 0 ? 0 : errno);
+		return;
+	}
+
+	if (sockfd >= static_cast<int>(_watches.size())) _watches.resize(sockfd + 1);
+	Watch& watch = _watches[sockfd];
+	if (pOperation->type() == AsyncIOOperation::OP_SEND)
+		watch.writers.push_back(pOperation);
+	else
+		watch.readers.push_back(pOperation);
+	if (pOperation->type() == AsyncIOOperation::OP_POLL && pOperation->_timeout.totalMicroseconds() > 0)
+	{
+		_deadlines.insert(Deadlines::value_type(pOperation->_deadline, pOperation));
+		// the engine thread may have to wait for a shorter time now
+		wakeUp();
+	}
+	update(sockfd);
+}
+
+
+void EPollEngine::cancelOperation(AsyncIOOperation* pOperation)
+{
+	if (pOperation->_cancelPending) return;
+
+	pOperation->_cancelPending = true;
+	dequeue(pOperation);
+	update(fd(pOperation));
+	done(pOperation, -1, 0, true);
+}
+
+
+void EPollEngine::wakeUp()
+{
+	eventfd_write(_eventfd, 1);
+}
+
+
+void EPollEngine::run()
+{
+	const int MAX_EVENTS = 256;
+	struct epoll_event events[MAX_EVENTS];
+	Results results;
+	while (!stopping() || pending() > 0)
+	{
+		int timeout;
+		{
+			Poco::FastMutex::ScopedLock lock(_mutex);
+			timeout = _results.empty() ? nextTimeout(Poco::Timestamp()) : 0;
+		}
+		int n = epoll_wait(_epollfd, events, MAX_EVENTS, timeout);
+		if (n < 0 && errno != EINTR) throw NetException("epoll_wait failed", errno);
+		{
+			Poco::FastMutex::ScopedLock lock(_mutex);
+
+			for (int i = 0; i < n; ++i)
+			{
+				int sockfd = events[i].data.fd;
+				if (sockfd == _eventfd)
+				{
+					eventfd_t value;
+					eventfd_read(_eventfd, &value);
+					continue;
+				}
+				if (sockfd >= static_cast<int>(_watches.size())) continue;
+				if (events[i].events & (EPOLLIN | EPOLLERR | EPOLLHUP))
+					processReaders(sockfd);
+				if (events[i].events & (EPOLLOUT | EPOLLERR | EPOLLHUP))
+					processWriters(sockfd);
+				update(sockfd);
+			}
+			expire(Poco::Timestamp());
+			results.swap(_results);
+		}
+		for (Results::iterator it = results.begin(); it != results.end(); ++it)
+		{
+			if (it->canceled)
+				canceled(it->pOperation);
+			else
+				completed(it->pOperation, it->result, it->error);
+		}
+		results.clear();
+	}
+}
+
+
+void EPollEngine::update(int sockfd)
+{
+	if (sockfd < 0 || sockfd >= static_cast<int>(_watches.size())) return;
+
+	Watch& watch = _watches[sockfd];
+	unsigned events = (watch.readers.empty() ? 0u : static_cast<unsigned>(EPOLLIN)) | (watch.writers.empty() ? 0u : static_cast<unsigned>(EPOLLOUT));
+	if (events == watch.events) return;
+
+	struct epoll_event ev;
+	ev.events = events;
+	ev.data.fd = sockfd;
+	int rc;
+	if (events == 0)
+		rc = epoll_ctl(_epollfd, EPOLL_CTL_DEL, sockfd, &ev);
+	else if (watch.events == 0)
+		rc = epoll_ctl(_epollfd, EPOLL_CTL_ADD, sockfd, &ev);
+	else
+		rc = epoll_ctl(_epollfd, EPOLL_CTL_MOD, sockfd, &ev);
+	if (rc < 0 && events != 0)
+	{
+		// the socket cannot be watched, so fail its operations
+		int error = errno;
+		Queue ops(watch.readers);
+		ops.insert(ops.end(), watch.writers.begin(), watch.writers.end());
+		for (Queue::iterator it = ops.begin(); it != ops.end(); ++it)
+		{
+			dequeue(*it);
+			done(*it, -1, error);
+		}
+		events = 0;
+	}
+	watch.events = events;
+}
+
+
+void EPollEngine::done(AsyncIOOperation* pOperation, int result, int error, bool canceled)
+{
+	Result r;
+	r.pOperation = pOperation;
+	r.result     = result;
+	r.error      = error;
+	r.canceled   = canceled;
+	_results.push_back(r);
+	wakeUp();
+}
+
+
+void EPollEngine::dequeue(AsyncIOOperation* pOperation)
+{
+	int sockfd = fd(pOperation);
+	if (sockfd >= 0 && sockfd < static_cast<int>(_watches.size()))
+	{
+		Watch& watch = _watches[sockfd];
+		Queue& queue = pOperation->type() == AsyncIOOperation::OP_SEND ? watch.writers : watch.readers;
+		for (Queue::iterator it = queue.begin(); it != queue.end(); ++it)
+		{
+			if (*it == pOperation)
+			{
+				queue.erase(it);
+				break;
+			}
+		}
+	}
+	if (pOperation->type() == AsyncIOOperation::OP_POLL && pOperation->_timeout.totalMicroseconds() > 0)
+	{
+		std::pair<Deadlines::iterator, Deadlines::iterator> range = _deadlines.equal_range(pOperation->_deadline);
+		for (Deadlines::iterator it = range.first; it != range.second; ++it)
+		{
+			if (it->second == pOperation)
+			{
+				_deadlines.erase(it);
+				break;
+			}
+		}
+	}
+}
+
+
+void EPollEngine::processReaders(int sockfd)
+{
+	Queue& readers = _watches[sockfd].readers;
+	while (!readers.empty())
+	{
+		AsyncIOOperation* pOperation = readers.front();
+		int rc = 0;
+		switch (pOperation->type())
+		{
+		case AsyncIOOperation::OP_ACCEPT:
+			{
+				// the listening socket may be blocking, and another
+				// process may have taken the connection already
+				struct pollfd pfd;
+				pfd.fd = sockfd;
+				pfd.events = POLLIN;
+				if (::poll(&pfd, 1, 0) <= 0) return;
+				rc = ::accept(sockfd, 0, 0);
+				if (rc >= 0) pOperation->_accepted = StreamSocket(new StreamSocketImpl(rc));
+			}
+			break;
+		case AsyncIOOperation::OP_RECEIVE:
+			rc = ::recv(sockfd, pOperation->_pBuffer, pOperation->_length, MSG_DONTWAIT);
+			break;
+		default:
+			break;
+		}
+		if (rc < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) return;
+
+		int error = rc < 0 ? errno : 0;
+		readers.pop_front();
+		dequeue(pOperation);
+		switch (pOperation->type())
+		{
+		case AsyncIOOperation::OP_ACCEPT:
+			done(pOperation, error ? -1 : 1, error);
+			break;
+		case AsyncIOOperation::OP_RECEIVE:
+			done(pOperation, rc, error);
+			break;
+		default:
+			done(pOperation, 1, 0);
+			break;
+		}
+	}
+}
+
+
+void EPollEngine::processWriters(int sockfd)
+{
+	Queue& writers = _watches[sockfd].writers;
+	while (!writers.empty())
+	{
+		AsyncIOOperation* pOperation = writers.front();
+		int rc = ::send(sockfd, pOperation->_pSendBuffer + pOperation->_sent, pOperation->_length - pOperation->_sent, MSG_DONTWAIT | MSG_NOSIGNAL);
+		if (rc < 0)
+		{
+			if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) return;
+			writers.pop_front();
+			done(pOperation, -1, errno);
+		}
+		else
+		{
+			pOperation->_sent += rc;
+			if (pOperation->_sent < pOperation->_length) return;
+			writers.pop_front();
+			done(pOperation, pOperation->_sent, 0);
+		}
+	}
+}
+
+
+void EPollEngine::expire(const Poco::Timestamp& now)
+{
+	while (!_deadlines.empty() && _deadlines.begin()->first <= now)
+	{
+		AsyncIOOperation* pOperation = _deadlines.begin()->second;
+		dequeue(pOperation);
+		update(fd(pOperation));
+		done(pOperation, 0, 0);
+	}
+}
+
+
+int EPollEngine::nextTimeout(const Poco::Timestamp& now) const
+{
+	if (_deadlines.empty()) return -1;
+
+	Poco::Timestamp::TimeDiff diff = _deadlines.begin()->first - now;
+	if (diff <= 0) return 0;
+	return static_cast<int>((diff + 999)/1000);
+}
+
+
+#else
+
+
+EPollEngine::EPollEngine(int bufferCount, int bufferSize):
+	AsyncIOEngine(bufferCount, bufferSize),
+	_epollfd(-1),
+	_eventfd(-1)
+{
+	throw Poco::NotImplementedException("EPollEngine is only available on Linux");
+}
+
+
+EPollEngine::~EPollEngine()
+{
+}
+
+
+std::string EPollEngine::name() const
+{
+	return "epoll";
+}
+
+
+void EPollEngine::submit(AsyncIOOperation* pOperation)
+{
+}
+
+
+void EPollEngine::cancelOperation(AsyncIOOperation* pOperation)
+{
+}
+
+
+void EPollEngine::wakeUp()
+{
+}
+
+
+void EPollEngine::run()
+{
+}
+
+
+#endif // POCO_OS == POCO_OS_LINUX
+
+
+} } // namespace Poco::Net
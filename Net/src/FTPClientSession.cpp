@@ -40,6 +40,7 @@
 #include "Poco/Net/ServerSocket.h"
 #include "Poco/Net/NetException.h"
 #include "Poco/NumberFormatter.h"
+#include "Poco/NumberParser.h"
 #include "Poco/Ascii.h"
 
 
@@ -242,11 +243,44 @@ std::istream& FTPClientSession::beginDownload(const std::string& path)
 }
 
 	
+std::istream& FTPClientSession::beginDownload(const std::string& path, Poco::UInt64 offset)
+{
+	delete _pDataStream;
+	_pDataStream = 0;
+	_pDataStream = new SocketStream(establishDataConnection("RETR", path, offset));
+	return *_pDataStream;
+}
+
+
 void FTPClientSession::endDownload()
 {
 	endTransfer();
 }
 
+
+void FTPClientSession::cancelTransfer()
+{
+	if (_pDataStream)
+	{
+		delete _pDataStream;
+		_pDataStream = 0;
+		std::string response;
+		_controlSocket.receiveStatusMessage(response);
+	}
+}
+
+
+Poco::UInt64 FTPClientSession::fileSize(const std::string& path)
+{
+	std::string response;
+	int status = sendCommand("SIZE", path, response);
+	if (!isPositiveCompletion(status)) throw FTPException("Cannot get file size", response, status);
+	Poco::UInt64 size;
+	if (response.size() < 5 || !NumberParser::tryParseUnsigned64(response.substr(4), size))
+		throw FTPException("Invalid response to SIZE command", response, status);
+	return size;
+}
+
 	
 std::ostream& FTPClientSession::beginUpload(const std::string& path)
 {
@@ -327,22 +361,23 @@ std::string FTPClientSession::extractPath(const std::string& response)
 }
 
 
-StreamSocket FTPClientSession::establishDataConnection(const std::string& command, const std::string& arg)
+StreamSocket FTPClientSession::establishDataConnection(const std::string& command, const std::string& arg, Poco::UInt64 restartOffset)
 {
 	StreamSocket ss;
 	if (_passiveMode)
-		ss = passiveDataConnection(command, arg);
+		ss = passiveDataConnection(command, arg, restartOffset);
 	else
-		ss = activeDataConnection(command, arg);
+		ss = activeDataConnection(command, arg, restartOffset);
 	ss.setReceiveTimeout(_timeout);
 	return ss;
 }
 
 
-StreamSocket FTPClientSession::activeDataConnection(const std::string& command, const std::string& arg)
+StreamSocket FTPClientSession::activeDataConnection(const std::string& command, const std::string& arg, Poco::UInt64 restartOffset)
 {
 	ServerSocket server(SocketAddress(_controlSocket.address().host(), 0));
 	sendPortCommand(server.address());
+	if (restartOffset > 0) sendREST(restartOffset);
 	std::string response;
 	int status = sendCommand(command, arg, response);
 	if (!isPositivePreliminary(status)) throw FTPException(command + " command failed", response, status);
@@ -353,10 +388,11 @@ StreamSocket FTPClientSession::activeDataConnection(const std::string& command,
 }
 
 
-StreamSocket FTPClientSession::passiveDataConnection(const std::string& command, const std::string& arg)
+StreamSocket FTPClientSession::passiveDataConnection(const std::string& command, const std::string& arg, Poco::UInt64 restartOffset)
 {
 	SocketAddress sa(sendPassiveCommand());
 	StreamSocket sock(sa);
+	if (restartOffset > 0) sendREST(restartOffset);
 	std::string response;
 	int status = sendCommand(command, arg, response);
 	if (!isPositivePreliminary(status)) throw FTPException(command + " command failed", response, status);
@@ -364,6 +400,14 @@ StreamSocket FTPClientSession::passiveDataConnection(const std::string& command,
 }
 
 
+void FTPClientSession::sendREST(Poco::UInt64 offset)
+{
+	std::string response;
+	int status = sendCommand("REST", NumberFormatter::format(offset), response);
+	if (!isPositiveIntermediate(status)) throw FTPException("REST command failed", response, status);
+}
+
+
 void FTPClientSession::sendPortCommand(const SocketAddress& addr)
 {
 	if (_supports1738)
@@ -0,0 +1,484 @@
+//
+// FTPTransferManager.cpp
+//
+// $Id: //poco/1.4/Net/src/FTPTransferManager.cpp#1 $
+//
+// Library: Net
+// Package: FTP
+// Module:  FTPTransferManager
+//
+// Copyright (c) 2013, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+// 
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+
+
+
+#include "Poco/Net/FTPTransferManager.h"
+#include "Poco/Net/NetException.h"
+#include "Poco/FileStream.h"
+#include "Poco/File.h"
+#include "Poco/Buffer.h"
+#include "Poco/Mutex.h"
+#include "Poco/Thread.h"
+#include "Poco/Runnable.h"
+#include "Poco/SharedPtr.h"
+#include "Poco/Exception.h"
+#include <vector>
+#include <algorithm>
+
+
+using Poco::FastMutex;
+using Poco::File;
+using Poco::FileStream;
+using Poco::FileInputStream;
+using Poco::FileOutputStream;
+
+
+namespace Poco {
+namespace Net {
+
+
+//
+// FTPTransferManager::Transfer
+//
+
+
+struct FTPTransferManager::Transfer
+	/// The state of a download, shared by all workers.
+{
+	struct Segment
+	{
+		Poco::UInt64 begin;
+		Poco::UInt64 next;
+		Poco::UInt64 end;
+		bool         active;
+	};
+	typedef std::vector<Segment> Segments;
+
+	Transfer(const std::string& remote, const std::string& local, Poco::UInt64 fileSize):
+		remotePath(remote),
+		localPath(local),
+		statePath(FTPTransferManager::stateFileName(local)),
+		size(fileSize),
+		received(0),
+		pException(0)
+	{
+	}
+
+	~Transfer()
+	{
+		delete pException;
+	}
+
+	void split(Poco::UInt64 start, int connections, Poco::UInt64 minSegmentSize)
+		/// Splits the range from start to the end of
+		/// the file into at most connections segments.
+	{
+		Poco::UInt64 remaining = size - start;
+		Poco::UInt64 count = minSegmentSize > 0 ? remaining/minSegmentSize : remaining;
+		if (count > static_cast<Poco::UInt64>(connections)) count = connections;
+		if (count == 0 && remaining > 0) count = 1;
+		for (Poco::UInt64 i = 0; i < count; ++i)
+		{
+			Segment segment;
+			segment.begin  = start + i*(remaining/count);
+			segment.next   = segment.begin;
+			segment.end    = i + 1 < count ? segment.begin + remaining/count : size;
+			segment.active = false;
+			segments.push_back(segment);
+		}
+	}
+
+	bool load()
+		/// Loads the segments from the state file. Returns false
+		/// if there is no state file, or if it belongs to a file
+		/// with a different size.
+	{
+		File stateFile(statePath);
+		if (!stateFile.exists()) return false;
+
+		FileInputStream istr(statePath);
+		Poco::UInt64 stateSize;
+		istr >> stateSize;
+		if (!istr || stateSize != size) return false;
+		Segments loaded;
+		Segment segment;
+		segment.active = false;
+		while (istr >> segment.begin >> segment.next >> segment.end)
+		{
+			if (segment.begin > segment.next || segment.next > segment.end || segment.end > size) return false;
+			loaded.push_back(segment);
+		}
+		segments.swap(loaded);
+		return true;
+	}
+
+	void save()
+		/// Writes the segments to the state file. The file is
+		/// replaced atomically, so that it is always consistent.
+	{
+		FastMutex::ScopedLock lock(mutex);
+
+		std::string tempPath(statePath + ".tmp");
+		{
+			FileOutputStream ostr(tempPath);
+			ostr << size << '\n';
+			for (Segments::const_iterator it = segments.begin(); it != segments.end(); ++it)
+			{
+				ostr << it->begin << ' ' << it->next << ' ' << it->end << '\n';
+			}
+			ostr.close();
+		}
+		File(tempPath).renameTo(statePath);
+	}
+
+	bool acquire(std::size_t& index)
+		/// Finds a segment that is neither complete nor
+		/// being downloaded, and marks it as active.
+	{
+		FastMutex::ScopedLock lock(mutex);
+
+		for (std::size_t i = 0; i < segments.size(); ++i)
+		{
+			if (!segments[i].active && segments[i].next < segments[i].end)
+			{
+				segments[i].active = true;
+				index = i;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	Segment segment(std::size_t index)
+	{
+		FastMutex::ScopedLock lock(mutex);
+
+		return segments[index];
+	}
+
+	void update(std::size_t index, Poco::UInt64 next)
+	{
+		FastMutex::ScopedLock lock(mutex);
+
+		received += next - segments[index].next;
+		segments[index].next = next;
+	}
+
+	void release(std::size_t index)
+	{
+		{
+			FastMutex::ScopedLock lock(mutex);
+
+			segments[index].active = false;
+		}
+		save();
+	}
+
+	void fail(const Poco::Exception& exc)
+	{
+		FastMutex::ScopedLock lock(mutex);
+
+		if (!pException) pException = exc.clone();
+	}
+
+	std::size_t pending()
+	{
+		FastMutex::ScopedLock lock(mutex);
+
+		std::size_t n = 0;
+		for (Segments::const_iterator it = segments.begin(); it != segments.end(); ++it)
+		{
+			if (it->next < it->end) ++n;
+		}
+		return n;
+	}
+
+	std::string      remotePath;
+	std::string      localPath;
+	std::string      statePath;
+	Poco::UInt64     size;
+	Poco::UInt64     received;
+	Segments         segments;
+	Poco::Exception* pException;
+	FastMutex        mutex;
+};
+
+
+//
+// FTPTransferManager::Worker
+//
+
+
+class FTPTransferManager::Worker: public Poco::Runnable
+	/// Downloads segments over one FTPClientSession
+	/// until no segments are left.
+{
+public:
+	enum
+	{
+		BUFFER_SIZE     = 65536,
+		CHECKPOINT_SIZE = 4*1024*1024
+	};
+
+	Worker(FTPTransferManager& manager, Transfer& transfer, FTPClientSession* pSession):
+		_manager(manager),
+		_transfer(transfer),
+		_pSession(pSession)
+	{
+	}
+
+	~Worker()
+	{
+		delete _pSession;
+	}
+
+	void run()
+	{
+		try
+		{
+			if (!_pSession) _pSession = _manager.createSession();
+			FileStream file(_transfer.localPath, std::ios::in | std::ios::out | std::ios::binary);
+			std::size_t index;
+			while (_transfer.acquire(index))
+			{
+				try
+				{
+					downloadSegment(file, index);
+				}
+				catch (...)
+				{
+					// keep what has been received so far
+					file.flush();
+					_transfer.release(index);
+					throw;
+				}
+				_transfer.release(index);
+			}
+			_pSession->close();
+		}
+		catch (Poco::Exception& exc)
+		{
+			_transfer.fail(exc);
+		}
+		catch (std::exception& exc)
+		{
+			_transfer.fail(Poco::Exception(exc.what()));
+		}
+	}
+
+private:
+	void downloadSegment(FileStream& file, std::size_t index)
+	{
+		Transfer::Segment segment = _transfer.segment(index);
+		std::istream& istr = _pSession->beginDownload(_transfer.remotePath, segment.next);
+		file.seekp(static_cast<std::streamoff>(segment.next));
+		Poco::Buffer<char> buffer(BUFFER_SIZE);
+		Poco::UInt64 next = segment.next;
+		Poco::UInt64 checkpoint = next + CHECKPOINT_SIZE;
+		while (next < segment.end)
+		{
+			std::streamsize n = static_cast<std::streamsize>(std::min<Poco::UInt64>(BUFFER_SIZE, segment.end - next));
+			istr.read(buffer.begin(), n);
+			n = istr.gcount();
+			if (n <= 0) break;
+			file.write(buffer.begin(), n);
+			if (!file.good()) throw WriteFileException(_transfer.localPath);
+			next += n;
+			_transfer.update(index, next);
+			if (next >= checkpoint)
+			{
+				file.flush();
+				_transfer.save();
+				checkpoint = next + CHECKPOINT_SIZE;
+			}
+		}
+		file.flush();
+		if (next < segment.end)
+		{
+			_pSession->endDownload();
+			throw FTPException("Premature end of data", _transfer.remotePath);
+		}
+		else if (segment.end == _transfer.size)
+		{
+			_pSession->endDownload();
+		}
+		else
+		{
+			_pSession->cancelTransfer();
+		}
+	}
+
+	FTPTransferManager& _manager;
+	Transfer&           _transfer;
+	FTPClientSession*   _pSession;
+};
+
+
+//
+// FTPTransferManager
+//
+
+
+FTPTransferManager::FTPTransferManager(const std::string& host, Poco::UInt16 port):
+	_host(host),
+	_port(port),
+	_username("anonymous"),
+	_password("poco@localhost"),
+	_connections(4),
+	_minSegmentSize(1024*1024),
+	_timeout(30, 0)
+{
+}
+
+
+FTPTransferManager::~FTPTransferManager()
+{
+}
+
+
+void FTPTransferManager::setCredentials(const std::string& username, const std::string& password)
+{
+	_username = username;
+	_password = password;
+}
+
+
+void FTPTransferManager::setConnections(int connections)
+{
+	poco_assert (connections > 0);
+
+	_connections = connections;
+}
+
+
+void FTPTransferManager::setMinimumSegmentSize(Poco::UInt64 size)
+{
+	_minSegmentSize = size;
+}
+
+
+void FTPTransferManager::setTimeout(const Poco::Timespan& timeout)
+{
+	_timeout = timeout;
+}
+
+
+Poco::UInt64 FTPTransferManager::download(const std::string& remotePath, const std::string& localPath)
+{
+	FTPClientSession* pSession = createSession();
+	Poco::UInt64 size;
+	try
+	{
+		size = pSession->fileSize(remotePath);
+	}
+	catch (...)
+	{
+		delete pSession;
+		throw;
+	}
+
+	Transfer transfer(remotePath, localPath, size);
+	File file(localPath);
+	if (!transfer.load())
+	{
+		Poco::UInt64 start = 0;
+		if (file.exists())
+		{
+			start = file.getSize();
+			if (start > size) start = 0;
+		}
+		transfer.split(start, _connections, _minSegmentSize);
+	}
+	if (!file.exists()) file.createFile();
+	if (file.getSize() != size) file.setSize(size);
+	transfer.save();
+
+	std::size_t nWorkers = std::min<std::size_t>(_connections, transfer.pending());
+	std::vector<Poco::SharedPtr<Worker> > workers;
+	std::vector<Poco::SharedPtr<Poco::Thread> > threads;
+	for (std::size_t i = 0; i < nWorkers; ++i)
+	{
+		workers.push_back(new Worker(*this, transfer, i == 0 ? pSession : 0));
+	}
+	if (nWorkers == 0) delete pSession;
+	try
+	{
+		for (std::size_t i = 0; i < nWorkers; ++i)
+		{
+			Poco::SharedPtr<Poco::Thread> pThread = new Poco::Thread("FTPTransferManager");
+			pThread->start(*workers[i]);
+			threads.push_back(pThread);
+		}
+	}
+	catch (Poco::Exception& exc)
+	{
+		// run with the threads that could be started
+		if (threads.empty()) throw;
+		transfer.fail(exc);
+	}
+	for (std::vector<Poco::SharedPtr<Poco::Thread> >::iterator it = threads.begin(); it != threads.end(); ++it)
+	{
+		(*it)->join();
+	}
+
+	if (transfer.pending() > 0)
+	{
+		if (transfer.pException)
+			transfer.pException->rethrow();
+		else
+			throw FTPException("Download incomplete", remotePath);
+	}
+	File(transfer.statePath).remove();
+	return transfer.received;
+}
+
+
+std::string FTPTransferManager::stateFileName(const std::string& localPath)
+{
+	return localPath + ".ftpstate";
+}
+
+
+FTPClientSession* FTPTransferManager::createSession()
+{
+	FTPClientSession* pSession = new FTPClientSession(_host, _port);
+	try
+	{
+		pSession->setTimeout(_timeout);
+		pSession->login(_username, _password);
+		pSession->setFileType(FTPClientSession::TYPE_BINARY);
+	}
+	catch (...)
+	{
+		delete pSession;
+		throw;
+	}
+	return pSession;
+}
+
+
+} } // namespace Poco::Net
@@ -0,0 +1,111 @@
+//
+// HTTPMetricsRequestHandler.cpp
+//
+// $Id: //poco/1.4/Net/src/HTTPMetricsRequestHandler.cpp#1 $
+//
+// Library: Net
+// Package: HTTPServer
+// Module:  HTTPMetricsRequestHandler
+//
+// Copyright (c) 2013, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+// 
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+
+#include "Poco/Net/HTTPMetricsRequestHandler.h"
+#include "Poco/Net/HTTPServerRequest.h"
+#include "Poco/Net/HTTPServerResponse.h"
+
+
+namespace Poco {
+namespace Net {
+
+
+HTTPMetricsRequestHandler::HTTPMetricsRequestHandler(HTTPServerMetrics::Ptr pMetrics):
+	_pMetrics(pMetrics)
+{
+	poco_check_ptr (pMetrics);
+}
+
+
+HTTPMetricsRequestHandler::~HTTPMetricsRequestHandler()
+{
+}
+
+
+void HTTPMetricsRequestHandler::handleRequest(HTTPServerRequest& request, HTTPServerResponse& response)
+{
+	HTTPServerMetrics::Snapshot snapshot;
+	_pMetrics->snapshot(snapshot);
+
+	response.setContentType("text/plain; charset=utf-8");
+	response.setChunkedTransferEncoding(true);
+	response.set("Cache-Control", "no-cache");
+	std::ostream& ostr = response.send();
+	write(snapshot, ostr);
+}
+
+
+void HTTPMetricsRequestHandler::write(const HTTPServerMetrics::Snapshot& snapshot, std::ostream& ostr)
+{
+	ostr << "# HELP http_server_uptime_seconds Time since the metrics were created or reset.\n"
+	     << "# TYPE http_server_uptime_seconds gauge\n"
+	     << "http_server_uptime_seconds " << (snapshot.timestamp - snapshot.startTime)/Poco::Timestamp::resolution() << "\n";
+	ostr << "# HELP http_server_requests_in_flight Number of requests currently being handled.\n"
+	     << "# TYPE http_server_requests_in_flight gauge\n"
+	     << "http_server_requests_in_flight " << snapshot.inFlight << "\n";
+	ostr << "# HELP http_server_requests_total Number of requests handled.\n"
+	     << "# TYPE http_server_requests_total counter\n"
+	     << "http_server_requests_total " << snapshot.requests << "\n";
+	ostr << "# HELP http_server_responses_total Number of responses sent, by status code.\n"
+	     << "# TYPE http_server_responses_total counter\n";
+	for (HTTPServerMetrics::StatusCounts::const_iterator it = snapshot.statusCounts.begin(); it != snapshot.statusCounts.end(); ++it)
+	{
+		ostr << "http_server_responses_total{status=\"" << it->first << "\"} " << it->second << "\n";
+	}
+	writeHistogram("http_server_parse_time_us", snapshot.parseTime, ostr);
+	writeHistogram("http_server_handler_time_us", snapshot.handlerTime, ostr);
+	writeHistogram("http_server_request_bytes", snapshot.bytesIn, ostr);
+	writeHistogram("http_server_response_bytes", snapshot.bytesOut, ostr);
+}
+
+
+void HTTPMetricsRequestHandler::writeHistogram(const std::string& name, const HTTPServerMetrics::Histogram& histogram, std::ostream& ostr)
+{
+	static const double QUANTILES[] = {50.0, 90.0, 99.0, 99.9};
+	static const char* QUANTILE_NAMES[] = {"0.5", "0.9", "0.99", "0.999"};
+	
+	ostr << "# TYPE " << name << " summary\n";
+	for (std::size_t i = 0; i < sizeof(QUANTILES)/sizeof(QUANTILES[0]); ++i)
+	{
+		ostr << name << "{quantile=\"" << QUANTILE_NAMES[i] << "\"} " << histogram.percentile(QUANTILES[i]) << "\n";
+	}
+	ostr << name << "_sum " << histogram.sum() << "\n"
+	     << name << "_count " << histogram.count() << "\n"
+	     << name << "_max " << histogram.max() << "\n";
+}
+
+
+} } // namespace Poco::Net
@@ -36,6 +36,9 @@
 
 #include "Poco/Net/HTTPServer.h"
 #include "Poco/Net/HTTPServerConnectionFactory.h"
+#include "Poco/Net/HTTPServerSession.h"
+#include "Poco/Observer.h"
+#include <vector>
 
 
 namespace Poco {
@@ -43,29 +46,96 @@ namespace Net {
 
 
 HTTPServer::HTTPServer(HTTPRequestHandlerFactory::Ptr pFactory, const ServerSocket& socket, HTTPServerParams::Ptr pParams):
-	TCPServer(new HTTPServerConnectionFactory(pParams, pFactory), socket, pParams),
-	_pFactory(pFactory)
+	TCPServer(new HTTPServerConnectionFactory(pParams, pFactory, this), socket, pParams),
+	_pFactory(pFactory),
+	_pEngine(pParams->getIOEngine()),
+	_keepAliveTimeout(pParams->getKeepAliveTimeout()),
+	_parking(true)
 {
 }
 
 
 HTTPServer::HTTPServer(HTTPRequestHandlerFactory::Ptr pFactory, Poco::ThreadPool& threadPool, const ServerSocket& socket, HTTPServerParams::Ptr pParams):
-	TCPServer(new HTTPServerConnectionFactory(pParams, pFactory), threadPool, socket, pParams),
-	_pFactory(pFactory)
+	TCPServer(new HTTPServerConnectionFactory(pParams, pFactory, this), threadPool, socket, pParams),
+	_pFactory(pFactory),
+	_pEngine(pParams->getIOEngine()),
+	_keepAliveTimeout(pParams->getKeepAliveTimeout()),
+	_parking(true)
 {
 }
 
 
 HTTPServer::~HTTPServer()
 {
+	try
+	{
+		unparkConnections();
+		stop();
+	}
+	catch (...)
+	{
+	}
 }
 
 
 void HTTPServer::stopAll(bool abortCurrent)
 {
+	unparkConnections();
 	_pFactory->serverStopped(this, abortCurrent);
 	stop();
 }
 
 
+bool HTTPServer::parkConnection(HTTPServerSession& session)
+{
+	if (!_pEngine) return false;
+
+	Poco::FastMutex::ScopedLock lock(_parkMutex);
+
+	if (!_parking || !_pEngine->running()) return false;
+	Poco::Observer<HTTPServer, AsyncIONotification> observer(*this, &HTTPServer::onConnectionReadable);
+	AsyncIOOperation::Ptr pOperation = _pEngine->poll(session.socket(), _keepAliveTimeout, &observer);
+	_parked.insert(pOperation);
+	// the socket now belongs to the engine, and must not
+	// be closed when the session is destroyed
+	session.detachSocket();
+	return true;
+}
+
+
+void HTTPServer::unparkConnections()
+{
+	std::vector<AsyncIOOperation::Ptr> parked;
+	{
+		Poco::FastMutex::ScopedLock lock(_parkMutex);
+
+		_parking = false;
+		parked.assign(_parked.begin(), _parked.end());
+		_parked.clear();
+	}
+	for (std::vector<AsyncIOOperation::Ptr>::iterator it = parked.begin(); it != parked.end(); ++it)
+	{
+		_pEngine->cancel(*it);
+		(*it)->wait();
+	}
+}
+
+
+void HTTPServer::onConnectionReadable(AsyncIONotification* pNf)
+{
+	Poco::AutoPtr<AsyncIONotification> pNotification(pNf);
+	AsyncIOOperation::Ptr pOperation(pNf->operation(), true);
+
+	Poco::FastMutex::ScopedLock lock(_parkMutex);
+
+	if (_parked.erase(pOperation) && pOperation->result() > 0)
+	{
+		// the next request has arrived
+		enqueue(StreamSocket(pOperation->socket()));
+	}
+	// otherwise the keep-alive timeout has expired or the server is
+	// stopping, and the socket is closed with the operation
+}
+
+
 } } // namespace Poco::Net
@@ -35,14 +35,17 @@
 
 
 #include "Poco/Net/HTTPServerConnection.h"
+#include "Poco/Net/HTTPServer.h"
 #include "Poco/Net/HTTPServerSession.h"
 #include "Poco/Net/HTTPServerRequestImpl.h"
 #include "Poco/Net/HTTPServerResponseImpl.h"
 #include "Poco/Net/HTTPRequestHandler.h"
 #include "Poco/Net/HTTPRequestHandlerFactory.h"
+#include "Poco/Net/HTTPServerMetrics.h"
 #include "Poco/Net/NetException.h"
 #include "Poco/NumberFormatter.h"
 #include "Poco/Timestamp.h"
+#include "Poco/Arena.h"
 #include "Poco/Delegate.h"
 #include <memory>
 
@@ -51,10 +54,67 @@ namespace Poco {
 namespace Net {
 
 
-HTTPServerConnection::HTTPServerConnection(const StreamSocket& socket, HTTPServerParams::Ptr pParams, HTTPRequestHandlerFactory::Ptr pFactory):
+class HTTPRequestMetrics
+	/// Measures a single request/response exchange and
+	/// records it in the server's HTTPServerMetrics, if
+	/// metrics are enabled.
+	///
+	/// If the request handler throws, the request is
+	/// recorded with status 500 (Internal Server Error).
+{
+public:
+	HTTPRequestMetrics(HTTPServerMetrics* pMetrics, const HTTPSession& session):
+		_pMetrics(pMetrics),
+		_session(session),
+		_started(false),
+		_parseTime(0),
+		_bytesIn(session.bytesReceived()),
+		_bytesOut(session.bytesSent()),
+		_status(HTTPResponse::HTTP_INTERNAL_SERVER_ERROR)
+	{
+	}
+	
+	~HTTPRequestMetrics()
+	{
+		if (_started)
+		{
+			_pMetrics->requestCompleted(_parseTime, _handlerStart.elapsed(), _session.bytesReceived() - _bytesIn, _session.bytesSent() - _bytesOut, _status);
+		}
+	}
+	
+	void started(Poco::Timestamp::TimeDiff parseTime)
+	{
+		if (_pMetrics)
+		{
+			_pMetrics->requestStarted();
+			_parseTime = parseTime;
+			_handlerStart.update();
+			_started = true;
+		}
+	}
+	
+	void setStatus(int status)
+	{
+		_status = status;
+	}
+
+private:
+	HTTPServerMetrics*       _pMetrics;
+	const HTTPSession&       _session;
+	bool                     _started;
+	Poco::Timestamp::TimeDiff _parseTime;
+	Poco::Timestamp          _handlerStart;
+	Poco::UInt64             _bytesIn;
+	Poco::UInt64             _bytesOut;
+	int                      _status;
+};
+
+
+HTTPServerConnection::HTTPServerConnection(const StreamSocket& socket, HTTPServerParams::Ptr pParams, HTTPRequestHandlerFactory::Ptr pFactory, HTTPServer* pServer):
 	TCPServerConnection(socket),
 	_pParams(pParams),
 	_pFactory(pFactory),
+	_pServer(pServer),
 	_stopped(false)
 {
 	poco_check_ptr (pFactory);
@@ -72,6 +132,9 @@ HTTPServerConnection::~HTTPServerConnection()
 void HTTPServerConnection::run()
 {
 	std::string server = _pParams->getSoftwareVersion();
+	HTTPServerMetrics::Ptr pMetrics = _pParams->getMetrics();
+	std::size_t arenaBlockSize = _pParams->getArenaBlockSize();
+	Poco::Arena arena(arenaBlockSize > 0 ? arenaBlockSize : Poco::Arena::DEFAULT_BLOCK_SIZE);
 	HTTPServerSession session(socket(), _pParams);
 	while (!_stopped && session.hasMoreRequests())
 	{
@@ -80,10 +143,13 @@ void HTTPServerConnection::run()
 			Poco::FastMutex::ScopedLock lock(_mutex);
 			if (!_stopped)
 			{
+				Poco::Timestamp start;
+				HTTPRequestMetrics metrics(pMetrics, session);
 				HTTPServerResponseImpl response(session);
-				HTTPServerRequestImpl request(response, session, _pParams);
+				HTTPServerRequestImpl request(response, session, _pParams, arenaBlockSize > 0 ? &arena : 0);
 			
 				Poco::Timestamp now;
+				metrics.started(now - start);
 				response.setDate(now);
 				response.setVersion(request.getVersion());
 				response.setKeepAlive(_pParams->getKeepAlive() && request.getKeepAlive() && session.canKeepAlive());
@@ -99,8 +165,13 @@ void HTTPServerConnection::run()
 					
 						pHandler->handleRequest(request, response);
 						session.setKeepAlive(_pParams->getKeepAlive() && response.getKeepAlive() && session.canKeepAlive());
+						metrics.setStatus(response.getStatus());
+					}
+					else 
+					{
+						sendErrorResponse(session, HTTPResponse::HTTP_NOT_IMPLEMENTED);
+						metrics.setStatus(HTTPResponse::HTTP_NOT_IMPLEMENTED);
 					}
-					else sendErrorResponse(session, HTTPResponse::HTTP_NOT_IMPLEMENTED);
 				}
 				catch (Poco::Exception&)
 				{
@@ -125,7 +196,12 @@ void HTTPServerConnection::run()
 		catch (MessageException&)
 		{
 			sendErrorResponse(session, HTTPResponse::HTTP_BAD_REQUEST);
+			if (pMetrics) pMetrics->requestRejected(HTTPResponse::HTTP_BAD_REQUEST);
 		}
+		// release the request's memory before waiting for the next one
+		arena.reset();
+		if (_pServer && !_stopped && session.idle() && _pServer->parkConnection(session))
+			break;
 	}
 }
 
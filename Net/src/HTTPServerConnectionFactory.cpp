@@ -43,9 +43,10 @@ namespace Poco {
 namespace Net {
 
 
-HTTPServerConnectionFactory::HTTPServerConnectionFactory(HTTPServerParams::Ptr pParams, HTTPRequestHandlerFactory::Ptr pFactory):
+HTTPServerConnectionFactory::HTTPServerConnectionFactory(HTTPServerParams::Ptr pParams, HTTPRequestHandlerFactory::Ptr pFactory, HTTPServer* pServer):
 	_pParams(pParams),
-	_pFactory(pFactory)
+	_pFactory(pFactory),
+	_pServer(pServer)
 {
 	poco_check_ptr (pFactory);
 }
@@ -58,7 +59,7 @@ HTTPServerConnectionFactory::~HTTPServerConnectionFactory()
 
 TCPServerConnection* HTTPServerConnectionFactory::createConnection(const StreamSocket& socket)
 {
-	return new HTTPServerConnection(socket, _pParams, _pFactory);
+	return new HTTPServerConnection(socket, _pParams, _pFactory, _pServer);
 }
 
 
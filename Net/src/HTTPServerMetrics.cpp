@@ -0,0 +1,290 @@
+//
+// HTTPServerMetrics.cpp
+//
+// $Id: //poco/1.4/Net/src/HTTPServerMetrics.cpp#1 $
+//
+// Library: Net
+// Package: HTTPServer
+// Module:  HTTPServerMetrics
+//
+// Copyright (c) 2013, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+// 
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+
+#include "Poco/Net/HTTPServerMetrics.h"
+#include "Poco/Thread.h"
+#include <cstring>
+
+
+namespace Poco {
+namespace Net {
+
+
+//
+// HTTPServerMetrics::Histogram
+//
+
+
+HTTPServerMetrics::Histogram::Histogram()
+{
+	reset();
+}
+
+
+void HTTPServerMetrics::Histogram::record(Poco::UInt64 value)
+{
+	++_buckets[bucketIndex(value)];
+	if (_count == 0 || value < _min) _min = value;
+	if (value > _max) _max = value;
+	++_count;
+	_sum += value;
+}
+
+
+void HTTPServerMetrics::Histogram::merge(const Histogram& histogram)
+{
+	if (histogram._count == 0) return;
+
+	for (int i = 0; i < BUCKET_COUNT; ++i)
+	{
+		_buckets[i] += histogram._buckets[i];
+	}
+	if (_count == 0 || histogram._min < _min) _min = histogram._min;
+	if (histogram._max > _max) _max = histogram._max;
+	_count += histogram._count;
+	_sum   += histogram._sum;
+}
+
+
+void HTTPServerMetrics::Histogram::reset()
+{
+	std::memset(_buckets, 0, sizeof(_buckets));
+	_count = 0;
+	_sum   = 0;
+	_min   = 0;
+	_max   = 0;
+}
+
+
+double HTTPServerMetrics::Histogram::mean() const
+{
+	return _count > 0 ? double(_sum)/double(_count) : 0.0;
+}
+
+
+Poco::UInt64 HTTPServerMetrics::Histogram::percentile(double percent) const
+{
+	if (_count == 0) return 0;
+	
+	if (percent < 0) percent = 0;
+	else if (percent > 100) percent = 100;
+	Poco::UInt64 rank = static_cast<Poco::UInt64>(percent*_count/100.0 + 0.5);
+	if (rank == 0) rank = 1;
+	Poco::UInt64 n = 0;
+	for (int i = 0; i < BUCKET_COUNT; ++i)
+	{
+		n += _buckets[i];
+		if (n >= rank)
+		{
+			Poco::UInt64 value = upperBound(i);
+			return value < _max ? value : _max;
+		}
+	}
+	return _max;
+}
+
+
+int HTTPServerMetrics::Histogram::bucketIndex(Poco::UInt64 value)
+{
+	if (value < SUB_BUCKETS) return static_cast<int>(value);
+
+	int msb = 0;
+	Poco::UInt64 v = value;
+	if (v >> 32) { v >>= 32; msb += 32; }
+	if (v >> 16) { v >>= 16; msb += 16; }
+	if (v >> 8)  { v >>= 8;  msb += 8;  }
+	if (v >> 4)  { v >>= 4;  msb += 4;  }
+	if (v >> 2)  { v >>= 2;  msb += 2;  }
+	if (v >> 1)  { msb += 1; }
+	if (msb >= MAX_VALUE_BITS) return BUCKET_COUNT - 1;
+
+	int shift = msb - SUB_BUCKET_BITS;
+	return shift*SUB_BUCKETS + static_cast<int>(value >> shift);
+}
+
+
+Poco::UInt64 HTTPServerMetrics::Histogram::lowerBound(int index)
+{
+	poco_assert (index >= 0 && index < BUCKET_COUNT);
+
+	if (index < SUB_BUCKETS) return index;
+	int shift = index/SUB_BUCKETS - 1;
+	Poco::UInt64 mantissa = index - shift*SUB_BUCKETS;
+	return mantissa << shift;
+}
+
+
+Poco::UInt64 HTTPServerMetrics::Histogram::upperBound(int index)
+{
+	poco_assert (index >= 0 && index < BUCKET_COUNT);
+
+	if (index < SUB_BUCKETS) return index;
+	int shift = index/SUB_BUCKETS - 1;
+	Poco::UInt64 mantissa = index - shift*SUB_BUCKETS;
+	return ((mantissa + 1) << shift) - 1;
+}
+
+
+//
+// HTTPServerMetrics::Stripe
+//
+
+
+HTTPServerMetrics::Stripe::Stripe()
+{
+	std::memset(statusCounts, 0, sizeof(statusCounts));
+}
+
+
+//
+// HTTPServerMetrics
+//
+
+
+HTTPServerMetrics::HTTPServerMetrics()
+{
+}
+
+
+HTTPServerMetrics::~HTTPServerMetrics()
+{
+}
+
+
+void HTTPServerMetrics::requestStarted()
+{
+	++_inFlight;
+}
+
+
+void HTTPServerMetrics::requestCompleted(Poco::Timestamp::TimeDiff parseTime, Poco::Timestamp::TimeDiff handlerTime, Poco::UInt64 bytesIn, Poco::UInt64 bytesOut, int status)
+{
+	--_inFlight;
+
+	Stripe& s = stripe();
+	Poco::FastMutex::ScopedLock lock(s.mutex);
+	s.parseTime.record(parseTime > 0 ? parseTime : 0);
+	s.handlerTime.record(handlerTime > 0 ? handlerTime : 0);
+	s.bytesIn.record(bytesIn);
+	s.bytesOut.record(bytesOut);
+	++s.statusCounts[statusIndex(status)];
+}
+
+
+void HTTPServerMetrics::requestRejected(int status)
+{
+	Stripe& s = stripe();
+	Poco::FastMutex::ScopedLock lock(s.mutex);
+	++s.statusCounts[statusIndex(status)];
+}
+
+
+void HTTPServerMetrics::snapshot(Snapshot& snapshot) const
+{
+	snapshot.parseTime.reset();
+	snapshot.handlerTime.reset();
+	snapshot.bytesIn.reset();
+	snapshot.bytesOut.reset();
+	snapshot.statusCounts.clear();
+
+	Poco::UInt64 statusCounts[MAX_STATUS - MIN_STATUS + 2];
+	std::memset(statusCounts, 0, sizeof(statusCounts));
+	for (int i = 0; i < STRIPES; ++i)
+	{
+		Stripe& s = _stripes[i];
+		Poco::FastMutex::ScopedLock lock(s.mutex);
+		snapshot.parseTime.merge(s.parseTime);
+		snapshot.handlerTime.merge(s.handlerTime);
+		snapshot.bytesIn.merge(s.bytesIn);
+		snapshot.bytesOut.merge(s.bytesOut);
+		for (int k = 0; k < MAX_STATUS - MIN_STATUS + 2; ++k)
+		{
+			statusCounts[k] += s.statusCounts[k];
+		}
+	}
+	for (int k = 0; k < MAX_STATUS - MIN_STATUS + 2; ++k)
+	{
+		if (statusCounts[k] > 0)
+		{
+			int status = k < MAX_STATUS - MIN_STATUS + 1 ? k + MIN_STATUS : 0;
+			snapshot.statusCounts[status] = statusCounts[k];
+		}
+	}
+	snapshot.requests  = snapshot.handlerTime.count();
+	snapshot.inFlight  = _inFlight.value();
+	snapshot.timestamp.update();
+
+	Poco::FastMutex::ScopedLock lock(_mutex);
+	snapshot.startTime = _startTime;
+}
+
+
+void HTTPServerMetrics::reset()
+{
+	for (int i = 0; i < STRIPES; ++i)
+	{
+		Stripe& s = _stripes[i];
+		Poco::FastMutex::ScopedLock lock(s.mutex);
+		s.parseTime.reset();
+		s.handlerTime.reset();
+		s.bytesIn.reset();
+		s.bytesOut.reset();
+		std::memset(s.statusCounts, 0, sizeof(s.statusCounts));
+	}
+
+	Poco::FastMutex::ScopedLock lock(_mutex);
+	_startTime.update();
+}
+
+
+HTTPServerMetrics::Stripe& HTTPServerMetrics::stripe() const
+{
+	Poco::Thread* pThread = Poco::Thread::current();
+	int index = pThread ? pThread->id() % STRIPES : 0;
+	return _stripes[index];
+}
+
+
+int HTTPServerMetrics::statusIndex(int status)
+{
+	if (status >= MIN_STATUS && status <= MAX_STATUS)
+		return status - MIN_STATUS;
+	else
+		return MAX_STATUS - MIN_STATUS + 1;
+}
+
+
+} } // namespace Poco::Net
@@ -35,6 +35,7 @@
 
 
 #include "Poco/Net/HTTPServerParams.h"
+#include "Poco/Arena.h"
 
 
 namespace Poco {
@@ -45,7 +46,8 @@ HTTPServerParams::HTTPServerParams():
 	_timeout(60000000),
 	_keepAlive(true),
 	_maxKeepAliveRequests(0),
-	_keepAliveTimeout(15000000)
+	_keepAliveTimeout(15000000),
+	_arenaBlockSize(Poco::Arena::DEFAULT_BLOCK_SIZE)
 {
 }
 
@@ -90,6 +92,24 @@ void HTTPServerParams::setMaxKeepAliveRequests(int maxKeepAliveRequests)
 	poco_assert (maxKeepAliveRequests >= 0);
 	_maxKeepAliveRequests = maxKeepAliveRequests;
 }
+
+
+void HTTPServerParams::setMetrics(HTTPServerMetrics::Ptr pMetrics)
+{
+	_pMetrics = pMetrics;
+}
+
+
+void HTTPServerParams::setIOEngine(AsyncIOEngine::Ptr pEngine)
+{
+	_pEngine = pEngine;
+}
+
+
+void HTTPServerParams::setArenaBlockSize(std::size_t blockSize)
+{
+	_arenaBlockSize = blockSize;
+}
 	
 
 } } // namespace Poco::Net
@@ -51,4 +51,10 @@ HTTPServerRequest::~HTTPServerRequest()
 }
 
 
+Poco::Arena* HTTPServerRequest::arena() const
+{
+	return 0;
+}
+
+
 } } // namespace Poco::Net
@@ -55,11 +55,12 @@ namespace Net {
 const std::string HTTPServerRequestImpl::EXPECT("Expect");
 
 
-HTTPServerRequestImpl::HTTPServerRequestImpl(HTTPServerResponseImpl& response, HTTPServerSession& session, HTTPServerParams* pParams):
+HTTPServerRequestImpl::HTTPServerRequestImpl(HTTPServerResponseImpl& response, HTTPServerSession& session, HTTPServerParams* pParams, Poco::Arena* pArena):
 	_response(response),
 	_session(session),
 	_pStream(0),
-	_pParams(pParams, true)
+	_pParams(pParams, true),
+	_pArena(pArena)
 {
 	response.attachRequest(this);
 
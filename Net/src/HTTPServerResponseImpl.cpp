@@ -57,6 +57,7 @@ using Poco::Timestamp;
 using Poco::NumberFormatter;
 using Poco::StreamCopier;
 using Poco::OpenFileException;
+using Poco::WriteFileException;
 using Poco::DateTimeFormatter;
 using Poco::DateTimeFormat;
 
@@ -150,7 +151,17 @@ void HTTPServerResponseImpl::sendFile(const std::string& path, const std::string
 		write(*_pStream);
 		if (_pRequest && _pRequest->getMethod() != HTTPRequest::HTTP_HEAD)
 		{
-			StreamCopier::copyStream(istr, *_pStream);
+			// use zero-copy transmission if the socket supports it
+			_pStream->flush();
+			Poco::Int64 sent = _pStream->good() ? _session.sendFile(path, 0, length) : -1;
+			if (sent < 0)
+			{
+				StreamCopier::copyStream(istr, *_pStream);
+			}
+			else if (static_cast<File::FileSize>(sent) < length)
+			{
+				throw WriteFileException("File truncated while sending", path);
+			}
 		}
 	}
 	else throw OpenFileException(path);
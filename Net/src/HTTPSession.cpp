@@ -53,7 +53,9 @@ HTTPSession::HTTPSession():
 	_pEnd(0),
 	_keepAlive(false),
 	_timeout(HTTP_DEFAULT_TIMEOUT),
-	_pException(0)
+	_pException(0),
+	_bytesSent(0),
+	_bytesReceived(0)
 {
 }
 
@@ -65,7 +67,9 @@ HTTPSession::HTTPSession(const StreamSocket& socket):
 	_pEnd(0),
 	_keepAlive(false),
 	_timeout(HTTP_DEFAULT_TIMEOUT),
-	_pException(0)
+	_pException(0),
+	_bytesSent(0),
+	_bytesReceived(0)
 {
 }
 
@@ -77,7 +81,9 @@ HTTPSession::HTTPSession(const StreamSocket& socket, bool keepAlive):
 	_pEnd(0),
 	_keepAlive(keepAlive),
 	_timeout(HTTP_DEFAULT_TIMEOUT),
-	_pException(0)
+	_pException(0),
+	_bytesSent(0),
+	_bytesReceived(0)
 {
 }
 
@@ -150,7 +156,25 @@ int HTTPSession::write(const char* buffer, std::streamsize length)
 {
 	try
 	{
-		return _socket.sendBytes(buffer, (int) length);
+		int n = _socket.sendBytes(buffer, (int) length);
+		if (n > 0) _bytesSent += n;
+		return n;
+	}
+	catch (Poco::Exception& exc)
+	{
+		setException(exc);
+		throw;
+	}
+}
+
+
+Poco::Int64 HTTPSession::sendFile(const std::string& path, Poco::UInt64 offset, Poco::UInt64 count)
+{
+	try
+	{
+		Poco::Int64 n = _socket.sendFile(path, offset, count);
+		if (n > 0) _bytesSent += n;
+		return n;
 	}
 	catch (Poco::Exception& exc)
 	{
@@ -164,7 +188,9 @@ int HTTPSession::receive(char* buffer, int length)
 {
 	try
 	{
-		return _socket.receiveBytes(buffer, length);
+		int n = _socket.receiveBytes(buffer, length);
+		if (n > 0) _bytesReceived += n;
+		return n;
 	}
 	catch (Poco::Exception& exc)
 	{
@@ -0,0 +1,383 @@
+//
+// ICMPPinger.cpp
+//
+// $Id: //poco/1.4/Net/src/ICMPPinger.cpp#1 $
+//
+// Library: Net
+// Package: ICMP
+// Module:  ICMPPinger
+//
+// Copyright (c) 2013, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+// 
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+
+
+
+#include "Poco/Net/ICMPPinger.h"
+#include "Poco/Net/ICMPv4PacketImpl.h"
+#include "Poco/Net/NetException.h"
+#include "Poco/ByteOrder.h"
+#include "Poco/AtomicCounter.h"
+#include "Poco/Exception.h"
+#if !defined(POCO_VXWORKS)
+#include "Poco/Process.h"
+#endif
+#include <cstring>
+
+
+using Poco::Timestamp;
+using Poco::Timespan;
+using Poco::ByteOrder;
+using Poco::UInt8;
+using Poco::UInt16;
+using Poco::UInt32;
+
+
+namespace Poco {
+namespace Net {
+
+
+namespace
+{
+	UInt16 checksum(const UInt8* data, int length)
+	{
+		UInt32 sum = 0;
+		for (; length > 1; data += 2, length -= 2)
+		{
+			sum += (static_cast<UInt32>(data[0]) << 8) | data[1];
+		}
+		if (length == 1) sum += static_cast<UInt32>(data[0]) << 8;
+		sum = (sum >> 16) + (sum & 0xFFFF);
+		sum += (sum >> 16);
+		return static_cast<UInt16>(~sum);
+	}
+
+	UInt16 nextIdentifier()
+	{
+		static Poco::AtomicCounter instances;
+#if defined(POCO_VXWORKS)
+		UInt16 base = 0;
+#else
+		UInt16 base = static_cast<UInt16>(Poco::Process::id());
+#endif
+		// several pingers in the same process see each other's replies,
+		// so give each of them its own identifier
+		return static_cast<UInt16>(base + 0x3C6F*(++instances - 1));
+	}
+}
+
+
+ICMPPinger::Host::Host(const SocketAddress& addr, int repeat, int dataSize, int ttl):
+	address(addr.host()),
+	args(addr, repeat, dataSize, ttl)
+{
+}
+
+
+ICMPPinger::ICMPPinger(IPAddress::Family family, int dataSize, int ttl):
+	_family(family),
+	_dataSize(dataSize),
+	_ttl(ttl),
+	_socket(family, dataSize, ttl),
+	_packet(family, dataSize),
+	_timeout(1, 0),
+	_interval(0),
+	_maxInFlight(DEFAULT_MAX_IN_FLIGHT),
+	_id(nextIdentifier()),
+	_seq(0),
+	_sendBuffer(sizeof(ICMPv4PacketImpl::Header) + dataSize),
+	_receiveBuffer(_packet.maxPacketSize()),
+	_received(0)
+{
+	try
+	{
+		// with thousands of requests in flight, replies arrive in bursts
+		_socket.setReceiveBufferSize(1024*1024);
+	}
+	catch (Poco::Exception&)
+	{
+	}
+	for (int i = 0; i < dataSize; ++i)
+	{
+		_sendBuffer[sizeof(ICMPv4PacketImpl::Header) + i] = static_cast<char>(i);
+	}
+}
+
+
+ICMPPinger::~ICMPPinger()
+{
+}
+
+
+void ICMPPinger::setTimeout(const Poco::Timespan& timeout)
+{
+	_timeout = timeout;
+}
+
+
+void ICMPPinger::setInterval(const Poco::Timespan& interval)
+{
+	_interval = interval;
+}
+
+
+void ICMPPinger::setMaxInFlight(int maxInFlight)
+{
+	if (maxInFlight < 1 || maxInFlight > MAX_IN_FLIGHT)
+		throw InvalidArgumentException("maxInFlight out of range");
+
+	_maxInFlight = maxInFlight;
+}
+
+
+int ICMPPinger::ping(const SocketAddress& address, int repeat)
+{
+	return ping(std::vector<SocketAddress>(1, address), repeat);
+}
+
+
+int ICMPPinger::ping(const std::vector<SocketAddress>& addresses, int repeat)
+{
+	if (repeat <= 0 || addresses.empty()) return 0;
+
+	for (std::vector<SocketAddress>::const_iterator it = addresses.begin(); it != addresses.end(); ++it)
+	{
+		if (it->family() != _family)
+			throw InvalidArgumentException("Address family mismatch", it->toString());
+	}
+	// a raw socket receives all ICMP traffic of the host, so discard
+	// what arrived since the last call before the receive buffer fills
+	// up and the kernel starts dropping our replies
+	receive();
+	_received = 0;
+	_hosts.reserve(addresses.size());
+	for (std::vector<SocketAddress>::const_iterator it = addresses.begin(); it != addresses.end(); ++it)
+	{
+		_hosts.push_back(Host(*it, repeat, _dataSize, _ttl));
+	}
+	try
+	{
+		Timestamp start;
+		for (std::size_t i = 0; i < _hosts.size(); ++i)
+		{
+			pingBegin.notify(this, _hosts[i].args);
+			_ready.push_back(std::make_pair(start, i));
+		}
+		while (!_ready.empty() || !_requests.empty())
+		{
+			Timestamp now;
+			while (!_ready.empty() && _ready.front().first <= now && static_cast<int>(_requests.size()) < _maxInFlight)
+			{
+				std::size_t host = _ready.front().second;
+				_ready.pop_front();
+				send(host);
+			}
+			expire(now);
+
+			bool wait = false;
+			Timestamp next;
+			if (!_deadlines.empty())
+			{
+				next = _deadlines.front().first;
+				wait = true;
+			}
+			if (!_ready.empty() && static_cast<int>(_requests.size()) < _maxInFlight && (!wait || _ready.front().first < next))
+			{
+				next = _ready.front().first;
+				wait = true;
+			}
+			if (wait)
+			{
+				Timestamp::TimeDiff remaining = next - Timestamp();
+				if (remaining < 0) remaining = 0;
+				if (_socket.poll(Timespan(remaining), Socket::SELECT_READ))
+					receive();
+			}
+		}
+	}
+	catch (...)
+	{
+		_hosts.clear();
+		_requests.clear();
+		_deadlines.clear();
+		_ready.clear();
+		throw;
+	}
+	_hosts.clear();
+	_deadlines.clear();
+	return _received;
+}
+
+
+void ICMPPinger::send(std::size_t host)
+{
+	Host& h = _hosts[host];
+	int index = h.args.sent();
+	++h.args;
+
+	UInt16 seq = nextSequence();
+	ICMPv4PacketImpl::Header* pHeader = reinterpret_cast<ICMPv4PacketImpl::Header*>(&_sendBuffer[0]);
+	pHeader->type     = ICMPv4PacketImpl::ECHO_REQUEST;
+	pHeader->code     = 0;
+	pHeader->checksum = 0;
+	pHeader->id       = ByteOrder::toNetwork(_id);
+	pHeader->seq      = ByteOrder::toNetwork(seq);
+	pHeader->checksum = ByteOrder::toNetwork(checksum(reinterpret_cast<const UInt8*>(&_sendBuffer[0]), static_cast<int>(_sendBuffer.size())));
+
+	Request request;
+	request.host     = host;
+	request.index    = index;
+	request.deadline = request.sent + _timeout.totalMicroseconds();
+	try
+	{
+		_socket.sendTo(&_sendBuffer[0], static_cast<int>(_sendBuffer.size()), SocketAddress(h.address, 0));
+	}
+	catch (Poco::Exception& exc)
+	{
+		fail(host, index, exc.displayText());
+		done(host);
+		return;
+	}
+	_requests[seq] = request;
+	_deadlines.push_back(std::make_pair(request.deadline, seq));
+}
+
+
+void ICMPPinger::receive()
+{
+	SocketAddress sender;
+	while (_socket.available() > 0)
+	{
+		int n = _socket.receiveFrom(&_receiveBuffer[0], static_cast<int>(_receiveBuffer.size()), sender);
+		if (n > 0) dispatch(reinterpret_cast<UInt8*>(&_receiveBuffer[0]), n, sender);
+	}
+}
+
+
+void ICMPPinger::dispatch(Poco::UInt8* buffer, int length, const SocketAddress& sender)
+{
+	const int headerSize = static_cast<int>(sizeof(ICMPv4PacketImpl::Header));
+	if (length < 20) return;
+	int ipHeaderSize = (buffer[0] & 0x0F)*4;
+	if (length < ipHeaderSize + headerSize) return;
+
+	const ICMPv4PacketImpl::Header* pHeader = reinterpret_cast<const ICMPv4PacketImpl::Header*>(buffer + ipHeaderSize);
+	if (pHeader->type == ICMPv4PacketImpl::ECHO_REPLY)
+	{
+		if (ByteOrder::fromNetwork(pHeader->id) != _id) return;
+
+		RequestMap::iterator it = _requests.find(ByteOrder::fromNetwork(pHeader->seq));
+		if (it == _requests.end()) return;
+		Host& h = _hosts[it->second.host];
+		if (sender.host() != h.address) return;
+
+		Timestamp::TimeDiff rtt = Timestamp() - it->second.sent;
+		h.args.setReplyTime(it->second.index, static_cast<int>(rtt/1000));
+		++_received;
+		std::size_t host = it->second.host;
+		_requests.erase(it);
+		pingReply.notify(this, h.args);
+		done(host);
+	}
+	else if (pHeader->type == ICMPv4PacketImpl::DESTINATION_UNREACHABLE ||
+	         pHeader->type == ICMPv4PacketImpl::SOURCE_QUENCH ||
+	         pHeader->type == ICMPv4PacketImpl::REDIRECT ||
+	         pHeader->type == ICMPv4PacketImpl::TIME_EXCEEDED ||
+	         pHeader->type == ICMPv4PacketImpl::PARAMETER_PROBLEM)
+	{
+		// the error message carries the IP header and the first
+		// 8 bytes of the datagram that caused it
+		const UInt8* pOriginal = buffer + ipHeaderSize + headerSize;
+		int originalLength = length - ipHeaderSize - headerSize;
+		if (originalLength < 20) return;
+		int originalHeaderSize = (pOriginal[0] & 0x0F)*4;
+		if (originalLength < originalHeaderSize + headerSize) return;
+
+		const ICMPv4PacketImpl::Header* pRequest = reinterpret_cast<const ICMPv4PacketImpl::Header*>(pOriginal + originalHeaderSize);
+		if (pRequest->type != ICMPv4PacketImpl::ECHO_REQUEST || ByteOrder::fromNetwork(pRequest->id) != _id) return;
+
+		RequestMap::iterator it = _requests.find(ByteOrder::fromNetwork(pRequest->seq));
+		if (it == _requests.end()) return;
+		Host& h = _hosts[it->second.host];
+		if (std::memcmp(pOriginal + 16, h.address.addr(), 4) != 0) return;
+
+		std::size_t host = it->second.host;
+		int index = it->second.index;
+		_requests.erase(it);
+		fail(host, index, h.address.toString() + ": " + _packet.errorDescription(buffer, length));
+		done(host);
+	}
+}
+
+
+void ICMPPinger::expire(const Poco::Timestamp& now)
+{
+	while (!_deadlines.empty() && _deadlines.front().first <= now)
+	{
+		RequestMap::iterator it = _requests.find(_deadlines.front().second);
+		if (it != _requests.end() && it->second.deadline == _deadlines.front().first)
+		{
+			std::size_t host = it->second.host;
+			int index = it->second.index;
+			_requests.erase(it);
+			fail(host, index, _hosts[host].address.toString() + ": Request timed out.");
+			done(host);
+		}
+		_deadlines.pop_front();
+	}
+}
+
+
+void ICMPPinger::fail(std::size_t host, int index, const std::string& error)
+{
+	Host& h = _hosts[host];
+	h.args.setError(index, error);
+	pingError.notify(this, h.args);
+}
+
+
+void ICMPPinger::done(std::size_t host)
+{
+	Host& h = _hosts[host];
+	if (h.args.sent() < h.args.repetitions())
+		_ready.push_back(std::make_pair(Timestamp() + _interval.totalMicroseconds(), host));
+	else
+		pingEnd.notify(this, h.args);
+}
+
+
+Poco::UInt16 ICMPPinger::nextSequence()
+{
+	do
+	{
+		++_seq;
+	}
+	while (_requests.find(_seq) != _requests.end());
+	return _seq;
+}
+
+
+} } // namespace Poco::Net
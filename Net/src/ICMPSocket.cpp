@@ -98,4 +98,16 @@ int ICMPSocket::receiveFrom(SocketAddress& address, int flags)
 }
 
 
+int ICMPSocket::sendTo(const void* buffer, int length, const SocketAddress& address, int flags)
+{
+	return impl()->SocketImpl::sendTo(buffer, length, address, flags);
+}
+
+
+int ICMPSocket::receiveFrom(void* buffer, int length, SocketAddress& address, int flags)
+{
+	return impl()->SocketImpl::receiveFrom(buffer, length, address, flags);
+}
+
+
 } } // namespace Poco::Net
@@ -0,0 +1,521 @@
+//
+// IOUringEngine.cpp
+//
+// $Id: //poco/1.4/Net/src/IOUringEngine.cpp#1 $
+//
+// Library: Net
+// Package: Reactor
+// Module:  IOUringEngine
+//
+// Copyright (c) 2013, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+// 
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+
+
+
+#include "Poco/Net/IOUringEngine.h"
+#include "Poco/Net/StreamSocketImpl.h"
+#include "Poco/Net/NetException.h"
+#include "Poco/Exception.h"
+#if POCO_OS == POCO_OS_LINUX
+#include <linux/io_uring.h>
+#include <linux/time_types.h>
+#include <sys/syscall.h>
+#include <sys/mman.h>
+#include <sys/uio.h>
+#include <poll.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <vector>
+#endif
+
+
+namespace Poco {
+namespace Net {
+
+
+#if POCO_OS == POCO_OS_LINUX
+
+
+namespace
+{
+	enum
+	{
+		WAKEUP_DATA  = 0, /// user_data of wake-up NOPs
+		IGNORED_DATA = 1  /// user_data of link timeouts and cancel requests
+	};
+
+	int sysSetup(unsigned entries, struct io_uring_params* pParams)
+	{
+		return static_cast<int>(syscall(__NR_io_uring_setup, entries, pParams));
+	}
+
+	int sysEnter(int fd, unsigned toSubmit, unsigned minComplete, unsigned flags)
+	{
+		return static_cast<int>(syscall(__NR_io_uring_enter, fd, toSubmit, minComplete, flags, 0, 0));
+	}
+
+	int sysRegister(int fd, unsigned opcode, void* arg, unsigned nrArgs)
+	{
+		return static_cast<int>(syscall(__NR_io_uring_register, fd, opcode, arg, nrArgs));
+	}
+}
+
+
+struct IOUringEngine::Ring
+{
+	Ring(unsigned entries):
+		fd(-1),
+		pSQ(MAP_FAILED),
+		sqSize(0),
+		pCQ(MAP_FAILED),
+		cqSize(0),
+		pSQEs(reinterpret_cast<struct io_uring_sqe*>(MAP_FAILED)),
+		sqesSize(0),
+		toSubmit(0)
+	{
+		struct io_uring_params params;
+		std::memset(&params, 0, sizeof(params));
+		fd = sysSetup(entries, &params);
+		if (fd < 0) throw Poco::NotImplementedException("io_uring is not available");
+		
+		try
+		{
+			sqSize = params.sq_off.array + params.sq_entries*sizeof(unsigned);
+			cqSize = params.cq_off.cqes + params.cq_entries*sizeof(struct io_uring_cqe);
+			if (params.features & IORING_FEAT_SINGLE_MMAP)
+			{
+				if (cqSize > sqSize) sqSize = cqSize;
+				cqSize = sqSize;
+			}
+			pSQ = mmap(0, sqSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+			if (pSQ == MAP_FAILED) throw NetException("Cannot map io_uring submission queue");
+			if (params.features & IORING_FEAT_SINGLE_MMAP)
+			{
+				pCQ = pSQ;
+			}
+			else
+			{
+				pCQ = mmap(0, cqSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+				if (pCQ == MAP_FAILED) throw NetException("Cannot map io_uring completion queue");
+			}
+			sqesSize = params.sq_entries*sizeof(struct io_uring_sqe);
+			pSQEs = reinterpret_cast<struct io_uring_sqe*>(mmap(0, sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES));
+			if (pSQEs == MAP_FAILED) throw NetException("Cannot map io_uring submission queue entries");
+		}
+		catch (...)
+		{
+			unmap();
+			throw;
+		}
+
+		char* sq = reinterpret_cast<char*>(pSQ);
+		sqHead    = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+		sqTail    = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+		sqMask    = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+		sqEntries = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_entries);
+		sqArray   = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+		char* cq = reinterpret_cast<char*>(pCQ);
+		cqHead    = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+		cqTail    = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+		cqMask    = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+		pCQEs     = reinterpret_cast<struct io_uring_cqe*>(cq + params.cq_off.cqes);
+	}
+
+	~Ring()
+	{
+		unmap();
+	}
+
+	void unmap()
+	{
+		if (pSQEs != MAP_FAILED) munmap(pSQEs, sqesSize);
+		if (pCQ != MAP_FAILED && pCQ != pSQ) munmap(pCQ, cqSize);
+		if (pSQ != MAP_FAILED) munmap(pSQ, sqSize);
+		if (fd >= 0) ::close(fd);
+	}
+
+	bool supports(const unsigned char* ops, std::size_t count)
+	{
+		std::size_t size = sizeof(struct io_uring_probe) + 256*sizeof(struct io_uring_probe_op);
+		std::vector<char> buffer(size);
+		struct io_uring_probe* pProbe = reinterpret_cast<struct io_uring_probe*>(&buffer[0]);
+		if (sysRegister(fd, IORING_REGISTER_PROBE, pProbe, 256) < 0) return false;
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			if (ops[i] > pProbe->last_op || !(pProbe->ops[ops[i]].flags & IO_URING_OP_SUPPORTED))
+				return false;
+		}
+		return true;
+	}
+
+	struct io_uring_sqe* getSQE()
+	{
+		unsigned tail = *sqTail;
+		if (tail - __atomic_load_n(sqHead, __ATOMIC_ACQUIRE) >= sqEntries)
+		{
+			enter(0, 0);
+			if (tail - __atomic_load_n(sqHead, __ATOMIC_ACQUIRE) >= sqEntries)
+				throw NetException("io_uring submission queue overflow");
+		}
+		unsigned index = tail & sqMask;
+		struct io_uring_sqe* pSQE = &pSQEs[index];
+		std::memset(pSQE, 0, sizeof(*pSQE));
+		sqArray[index] = index;
+		__atomic_store_n(sqTail, tail + 1, __ATOMIC_RELEASE);
+		++toSubmit;
+		return pSQE;
+	}
+
+	int enter(unsigned minComplete, unsigned flags)
+	{
+		unsigned n = toSubmit;
+		toSubmit = 0;
+		int rc;
+		do
+		{
+			rc = sysEnter(fd, n, minComplete, flags);
+		}
+		while (rc < 0 && errno == EINTR && minComplete == 0);
+		return rc;
+	}
+
+	int                  fd;
+	void*                pSQ;
+	std::size_t          sqSize;
+	void*                pCQ;
+	std::size_t          cqSize;
+	struct io_uring_sqe* pSQEs;
+	std::size_t          sqesSize;
+	unsigned*            sqHead;
+	unsigned*            sqTail;
+	unsigned             sqMask;
+	unsigned             sqEntries;
+	unsigned*            sqArray;
+	unsigned*            cqHead;
+	unsigned*            cqTail;
+	unsigned             cqMask;
+	struct io_uring_cqe* pCQEs;
+	unsigned             toSubmit;
+};
+
+
+IOUringEngine::IOUringEngine(int bufferCount, int bufferSize, int entries):
+	AsyncIOEngine(bufferCount, bufferSize),
+	_pRing(new Ring(entries)),
+	_fixedBuffers(false),
+	_pEngineThread(0)
+{
+	static const unsigned char REQUIRED_OPS[] = 
+	{
+		IORING_OP_NOP, IORING_OP_ACCEPT, IORING_OP_RECV, IORING_OP_SEND, IORING_OP_READ_FIXED,
+		IORING_OP_POLL_ADD, IORING_OP_LINK_TIMEOUT, IORING_OP_ASYNC_CANCEL, IORING_OP_CLOSE
+	};
+	if (!_pRing->supports(REQUIRED_OPS, sizeof(REQUIRED_OPS)))
+	{
+		delete _pRing;
+		throw Poco::NotImplementedException("io_uring does not support all required operations");
+	}
+
+	struct iovec iov;
+	iov.iov_base = bufferPool().buffer(0);
+	iov.iov_len  = static_cast<std::size_t>(bufferPool().bufferCount())*bufferPool().bufferSize();
+	// fails if the locked memory limit is too low; plain receives are used then
+	_fixedBuffers = sysRegister(_pRing->fd, IORING_REGISTER_BUFFERS, &iov, 1) == 0;
+}
+
+
+IOUringEngine::~IOUringEngine()
+{
+	try
+	{
+		stop();
+	}
+	catch (...)
+	{
+	}
+	delete _pRing;
+}
+
+
+std::string IOUringEngine::name() const
+{
+	return "io_uring";
+}
+
+
+void IOUringEngine::submit(AsyncIOOperation* pOperation)
+{
+	if (pOperation->type() == AsyncIOOperation::OP_CLOSE)
+	{
+		// the native socket belongs to the operation from now on
+		pOperation->_pEngineData = reinterpret_cast<void*>(static_cast<long>(detach(pOperation->socket())));
+	}
+	prepare(pOperation);
+	flush();
+}
+
+
+void IOUringEngine::prepare(AsyncIOOperation* pOperation)
+{
+	struct io_uring_sqe* pSQE = _pRing->getSQE();
+	pSQE->fd = pOperation->socket().impl()->sockfd();
+	pSQE->user_data = reinterpret_cast<__u64>(pOperation);
+	switch (pOperation->type())
+	{
+	case AsyncIOOperation::OP_ACCEPT:
+		pSQE->opcode = IORING_OP_ACCEPT;
+		break;
+	case AsyncIOOperation::OP_RECEIVE:
+		if (_fixedBuffers && pOperation->_bufferIndex >= 0)
+		{
+			pSQE->opcode = IORING_OP_READ_FIXED;
+			pSQE->off = static_cast<__u64>(-1);
+			pSQE->buf_index = 0;
+		}
+		else pSQE->opcode = IORING_OP_RECV;
+		pSQE->addr = reinterpret_cast<__u64>(pOperation->_pBuffer);
+		pSQE->len  = pOperation->_length;
+		break;
+	case AsyncIOOperation::OP_SEND:
+		pSQE->opcode = IORING_OP_SEND;
+		pSQE->addr = reinterpret_cast<__u64>(pOperation->_pSendBuffer + pOperation->_sent);
+		pSQE->len  = pOperation->_length - pOperation->_sent;
+		pSQE->msg_flags = MSG_NOSIGNAL;
+		break;
+	case AsyncIOOperation::OP_POLL:
+		pSQE->opcode = IORING_OP_POLL_ADD;
+		pSQE->poll32_events = POLLIN;
+		if (pOperation->_timeout.totalMicroseconds() > 0)
+		{
+			struct __kernel_timespec* pTS = new struct __kernel_timespec;
+			pTS->tv_sec  = pOperation->_timeout.totalSeconds();
+			pTS->tv_nsec = pOperation->_timeout.useconds()*1000;
+			pOperation->_pEngineData = pTS;
+			pSQE->flags |= IOSQE_IO_LINK;
+			struct io_uring_sqe* pTimeoutSQE = _pRing->getSQE();
+			pTimeoutSQE->opcode = IORING_OP_LINK_TIMEOUT;
+			pTimeoutSQE->fd = -1;
+			pTimeoutSQE->addr = reinterpret_cast<__u64>(pTS);
+			pTimeoutSQE->len = 1;
+			pTimeoutSQE->user_data = IGNORED_DATA;
+		}
+		break;
+	case AsyncIOOperation::OP_CLOSE:
+		pSQE->opcode = IORING_OP_CLOSE;
+		pSQE->fd = static_cast<int>(reinterpret_cast<long>(pOperation->_pEngineData));
+		break;
+	}
+}
+
+
+void IOUringEngine::flush()
+{
+	// operations started in the engine thread are submitted
+	// together with the next wait for completions
+	if (_pEngineThread && Poco::Thread::current() == _pEngineThread) return;
+
+	if (_pRing->enter(0, 0) < 0)
+		throw NetException("Cannot submit io_uring operations", errno);
+}
+
+
+void IOUringEngine::cancelOperation(AsyncIOOperation* pOperation)
+{
+	if (pOperation->_cancelPending) return;
+
+	pOperation->_cancelPending = true;
+	struct io_uring_sqe* pSQE = _pRing->getSQE();
+	pSQE->opcode = IORING_OP_ASYNC_CANCEL;
+	pSQE->fd = -1;
+	pSQE->addr = reinterpret_cast<__u64>(pOperation);
+	pSQE->user_data = IGNORED_DATA;
+	flush();
+}
+
+
+void IOUringEngine::wakeUp()
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	struct io_uring_sqe* pSQE = _pRing->getSQE();
+	pSQE->opcode = IORING_OP_NOP;
+	pSQE->user_data = WAKEUP_DATA;
+	flush();
+}
+
+
+void IOUringEngine::run()
+{
+	_pEngineThread = Poco::Thread::current();
+	while (!stopping() || pending() > 0)
+	{
+		int rc = 0;
+		{
+			// Entries are only ever submitted with the lock held, 
+			// so that no half-prepared entry is submitted. The wait
+			// below must not hold the lock, so operations started 
+			// by observers are submitted separately.
+			Poco::FastMutex::ScopedLock lock(_mutex);
+			if (_pRing->toSubmit > 0) rc = _pRing->enter(0, 0);
+		}
+		if (rc >= 0) rc = sysEnter(_pRing->fd, 0, 1, IORING_ENTER_GETEVENTS);
+		if (rc < 0 && errno != EINTR && errno != EAGAIN && errno != EBUSY)
+		{
+			throw NetException("io_uring wait failed", errno);
+		}
+
+		unsigned head = *_pRing->cqHead;
+		unsigned tail = __atomic_load_n(_pRing->cqTail, __ATOMIC_ACQUIRE);
+		while (head != tail)
+		{
+			struct io_uring_cqe* pCQE = &_pRing->pCQEs[head & _pRing->cqMask];
+			__u64 data = pCQE->user_data;
+			int res = pCQE->res;
+			++head;
+			__atomic_store_n(_pRing->cqHead, head, __ATOMIC_RELEASE);
+			if (data != WAKEUP_DATA && data != IGNORED_DATA)
+			{
+				process(reinterpret_cast<AsyncIOOperation*>(data), res);
+			}
+			tail = __atomic_load_n(_pRing->cqTail, __ATOMIC_ACQUIRE);
+		}
+	}
+	_pEngineThread = 0;
+}
+
+
+void IOUringEngine::process(AsyncIOOperation* pOperation, int res)
+{
+	if (pOperation->type() == AsyncIOOperation::OP_POLL)
+	{
+		delete reinterpret_cast<struct __kernel_timespec*>(pOperation->_pEngineData);
+		pOperation->_pEngineData = 0;
+	}
+	if (res == -ECANCELED && pOperation->_cancelPending)
+	{
+		canceled(pOperation);
+		return;
+	}
+	switch (pOperation->type())
+	{
+	case AsyncIOOperation::OP_ACCEPT:
+		if (res >= 0)
+		{
+			pOperation->_accepted = StreamSocket(new StreamSocketImpl(res));
+			completed(pOperation, 1, 0);
+		}
+		else completed(pOperation, -1, -res);
+		break;
+	case AsyncIOOperation::OP_RECEIVE:
+		completed(pOperation, res, res < 0 ? -res : 0);
+		break;
+	case AsyncIOOperation::OP_SEND:
+		if (res > 0)
+		{
+			pOperation->_sent += res;
+			if (pOperation->_sent < pOperation->_length)
+			{
+				Poco::FastMutex::ScopedLock lock(_mutex);
+				if (!pOperation->_cancelPending)
+				{
+					prepare(pOperation);
+					return;
+				}
+			}
+			completed(pOperation, pOperation->_sent, 0);
+		}
+		else completed(pOperation, -1, res < 0 ? -res : EPIPE);
+		break;
+	case AsyncIOOperation::OP_POLL:
+		if (res >= 0)
+			completed(pOperation, 1, 0);
+		else if (res == -ECANCELED)
+			completed(pOperation, 0, 0); // link timeout expired
+		else
+			completed(pOperation, -1, -res);
+		break;
+	case AsyncIOOperation::OP_CLOSE:
+		completed(pOperation, 0, res < 0 ? -res : 0);
+		break;
+	}
+}
+
+
+#else
+
+
+struct IOUringEngine::Ring
+{
+};
+
+
+IOUringEngine::IOUringEngine(int bufferCount, int bufferSize, int entries):
+	AsyncIOEngine(bufferCount, bufferSize),
+	_pRing(0),
+	_fixedBuffers(false),
+	_pEngineThread(0)
+{
+	throw Poco::NotImplementedException("IOUringEngine is only available on Linux");
+}
+
+
+IOUringEngine::~IOUringEngine()
+{
+}
+
+
+std::string IOUringEngine::name() const
+{
+	return "io_uring";
+}
+
+
+void IOUringEngine::submit(AsyncIOOperation* pOperation)
+{
+}
+
+
+void IOUringEngine::cancelOperation(AsyncIOOperation* pOperation)
+{
+}
+
+
+void IOUringEngine::wakeUp()
+{
+}
+
+
+void IOUringEngine::run()
+{
+}
+
+
+#endif // POCO_OS == POCO_OS_LINUX
+
+
+} } // namespace Poco::Net
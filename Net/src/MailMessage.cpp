@@ -45,6 +45,7 @@
 #include "Poco/Base64Encoder.h"
 #include "Poco/Base64Decoder.h"
 #include "Poco/StreamCopier.h"
+#include "Poco/MemoryStream.h"
 #include "Poco/DateTimeFormat.h"
 #include "Poco/DateTimeFormatter.h"
 #include "Poco/DateTimeParser.h"
@@ -279,7 +280,7 @@ void MailMessage::write(std::ostream& ostr) const
 	else
 	{
 		writeHeader(header, ostr);
-		std::istringstream istr(_content);
+		Poco::MemoryInputStream istr(_content.data(), _content.size());
 		writeEncoded(istr, ostr, _encoding);
 	}
 }
@@ -352,19 +353,19 @@ void MailMessage::writeEncoded(std::istream& istr, std::ostream& ostr, ContentTr
 	{
 	case ENCODING_7BIT:
 	case ENCODING_8BIT:
-		StreamCopier::copyStream(istr, ostr);
+		StreamCopier::copyStream(istr, ostr, ENCODING_BUFFER_SIZE);
 		break;
 	case ENCODING_QUOTED_PRINTABLE:
 		{
 			QuotedPrintableEncoder encoder(ostr);
-			StreamCopier::copyStream(istr, encoder);
+			StreamCopier::copyStream(istr, encoder, ENCODING_BUFFER_SIZE);
 			encoder.close();
 		}
 		break;
 	case ENCODING_BASE64:
 		{
 			Base64Encoder encoder(ostr);
-			StreamCopier::copyStream(istr, encoder);
+			StreamCopier::copyStream(istr, encoder, ENCODING_BUFFER_SIZE);
 			encoder.close();
 		}
 		break;
@@ -145,43 +145,48 @@ int MailStreamBuf::readOne()
 
 int MailStreamBuf::writeToDevice(char c)
 {
-	switch (c)
+	if (xsputn(&c, 1) != 1) return std::char_traits<char>::eof();
+	return charToInt(c);
+}
+
+
+std::streamsize MailStreamBuf::xsputn(const char* s, std::streamsize n)
+{
+	if (!_pOstr) return 0;
+
+	const char* runStart = s;
+	const char* end = s + n;
+	for (const char* it = s; it != end; ++it)
 	{
-	case '\r':
-		_state = ST_CR;
-		break;
-	case '\n':
-		if (_state == ST_CR)
-			_state = ST_CR_LF;
-		else
+		switch (*it)
+		{
+		case '\r':
+			_state = ST_CR;
+			break;
+		case '\n':
+			if (_state == ST_CR)
+				_state = ST_CR_LF;
+			else
+				_state = ST_DATA;
+			break;
+		case '.':
+			if (_state == ST_CR_LF)
+			{
+				// write everything up to and including the
+				// period, and let the next run start with
+				// the same period, doubling it.
+				_pOstr->write(runStart, (std::streamsize) (it - runStart + 1));
+				runStart = it;
+			}
 			_state = ST_DATA;
-		break;
-	case '.':
-		if (_state == ST_CR_LF)
-			_state = ST_CR_LF_DOT;
-		else
+			break;
+		default:
 			_state = ST_DATA;
-		break;
-	default:
-		_state = ST_DATA;
-	}
-	if (_state == ST_DATA)
-	{
-		if (!_buffer.empty())
-		{
-			_pOstr->write(_buffer.data(), (std::streamsize) _buffer.length());
-			_buffer.clear();
 		}
-		_pOstr->put(c);
 	}
-	else if (_state == ST_CR_LF_DOT)
-	{
-		_pOstr->write("\r\n..", 4);
-		_state = ST_DATA;
-		_buffer.clear();
-	}
-	else _buffer += c;
-	return charToInt(c);
+	if (runStart != end)
+		_pOstr->write(runStart, (std::streamsize) (end - runStart));
+	return *_pOstr ? n : 0;
 }
 
 
@@ -0,0 +1,407 @@
+//
+// NetworkInterfaceCache.cpp
+//
+// $Id: //poco/1.4/Net/src/NetworkInterfaceCache.cpp#1 $
+//
+// Library: Net
+// Package: NetCore
+// Module:  NetworkInterfaceCache
+//
+// Copyright (c) 2013, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+// 
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+
+
+
+#include "Poco/Net/NetworkInterfaceCache.h"
+#include "Poco/Net/NetException.h"
+#include "Poco/HashMap.h"
+#include "Poco/SingletonHolder.h"
+#include "Poco/NumberFormatter.h"
+#include "Poco/Timestamp.h"
+#include "Poco/Exception.h"
+#if POCO_OS == POCO_OS_LINUX
+#include <sys/socket.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <poll.h>
+#include <unistd.h>
+#include <cstring>
+#endif
+
+
+using Poco::FastMutex;
+using Poco::NumberFormatter;
+
+
+namespace Poco {
+namespace Net {
+
+
+struct NetworkInterfaceCache::Snapshot
+{
+	typedef Poco::HashMap<unsigned, NetworkInterface> IndexMap;
+	typedef Poco::HashMap<std::string, NetworkInterface> StringMap;
+
+	Snapshot(const NetworkInterface::Map& m):
+		interfaces(m)
+	{
+		for (NetworkInterface::Map::const_iterator it = interfaces.begin(); it != interfaces.end(); ++it)
+		{
+			byIndex[it->first] = it->second;
+			byName.insert(StringMap::ValueType(it->second.name(), it->second));
+			const NetworkInterface::AddressList& addresses = it->second.addressList();
+			for (NetworkInterface::AddressList::const_iterator itAddr = addresses.begin(); itAddr != addresses.end(); ++itAddr)
+			{
+				byAddress.insert(StringMap::ValueType(addressKey(itAddr->get<NetworkInterface::IP_ADDRESS>()), it->second));
+			}
+		}
+	}
+
+	static std::string addressKey(const IPAddress& address)
+		/// Returns the raw address bytes, which are
+		/// cheaper to hash than the address string.
+	{
+		return std::string(reinterpret_cast<const char*>(address.addr()), address.length());
+	}
+
+	NetworkInterface::Map interfaces;
+	IndexMap              byIndex;
+	StringMap             byAddress;
+	StringMap             byName;
+};
+
+
+NetworkInterfaceCache::NetworkInterfaceCache():
+	_refreshInterval(30, 0),
+	_thread("NetworkInterfaceCache"),
+	_stop(false),
+	_netlink(false)
+{
+	_pSnapshot = new Snapshot(NetworkInterface::map(false, false));
+}
+
+
+NetworkInterfaceCache::~NetworkInterfaceCache()
+{
+	try
+	{
+		stop();
+	}
+	catch (...)
+	{
+	}
+}
+
+
+void NetworkInterfaceCache::start()
+{
+	FastMutex::ScopedLock lock(_mutex);
+
+	// while a stop() is in progress, the thread must not be 
+	// restarted, or stop() would join the new thread
+	if (!_thread.isRunning() && !_stop)
+	{
+		_thread.start(*this);
+	}
+}
+
+
+void NetworkInterfaceCache::stop()
+{
+	{
+		FastMutex::ScopedLock lock(_mutex);
+
+		if (!_thread.isRunning() || _stop) return;
+		_stop = true;
+	}
+	// the thread takes _mutex in refresh(), so it
+	// must not be held while joining the thread
+	_wakeUp.set();
+	_thread.join();
+
+	FastMutex::ScopedLock lock(_mutex);
+	_stop = false;
+}
+
+
+bool NetworkInterfaceCache::isRunning() const
+{
+	return _thread.isRunning();
+}
+
+
+bool NetworkInterfaceCache::usesNetlink() const
+{
+	return _netlink;
+}
+
+
+void NetworkInterfaceCache::setRefreshInterval(const Poco::Timespan& interval)
+{
+	FastMutex::ScopedLock lock(_mutex);
+
+	_refreshInterval = interval;
+}
+
+
+Poco::Timespan NetworkInterfaceCache::getRefreshInterval() const
+{
+	FastMutex::ScopedLock lock(_mutex);
+
+	return _refreshInterval;
+}
+
+
+void NetworkInterfaceCache::refresh()
+{
+	FastMutex::ScopedLock refreshLock(_refreshMutex);
+
+	SnapshotPtr pNew = new Snapshot(NetworkInterface::map(false, false));
+	SnapshotPtr pOld;
+	{
+		FastMutex::ScopedLock lock(_mutex);
+		pOld = _pSnapshot;
+		_pSnapshot = pNew;
+	}
+	notifyChanges(pOld->interfaces, pNew->interfaces);
+}
+
+
+NetworkInterface::Map NetworkInterfaceCache::map() const
+{
+	return snapshot()->interfaces;
+}
+
+
+bool NetworkInterfaceCache::find(unsigned index, NetworkInterface& interfc) const
+{
+	SnapshotPtr pSnapshot = snapshot();
+	Snapshot::IndexMap::ConstIterator it = pSnapshot->byIndex.find(index);
+	if (it != pSnapshot->byIndex.end())
+	{
+		interfc = it->second;
+		return true;
+	}
+	return false;
+}
+
+
+bool NetworkInterfaceCache::find(const IPAddress& address, NetworkInterface& interfc) const
+{
+	SnapshotPtr pSnapshot = snapshot();
+	Snapshot::StringMap::ConstIterator it = pSnapshot->byAddress.find(Snapshot::addressKey(address));
+	if (it != pSnapshot->byAddress.end())
+	{
+		interfc = it->second;
+		return true;
+	}
+	return false;
+}
+
+
+bool NetworkInterfaceCache::find(const std::string& name, NetworkInterface& interfc) const
+{
+	SnapshotPtr pSnapshot = snapshot();
+	Snapshot::StringMap::ConstIterator it = pSnapshot->byName.find(name);
+	if (it != pSnapshot->byName.end())
+	{
+		interfc = it->second;
+		return true;
+	}
+	return false;
+}
+
+
+NetworkInterface NetworkInterfaceCache::forIndex(unsigned index) const
+{
+	NetworkInterface interfc;
+	if (!find(index, interfc)) throw InterfaceNotFoundException("#" + NumberFormatter::format(index));
+	return interfc;
+}
+
+
+NetworkInterface NetworkInterfaceCache::forAddress(const IPAddress& address) const
+{
+	NetworkInterface interfc;
+	if (!find(address, interfc)) throw InterfaceNotFoundException(address.toString());
+	return interfc;
+}
+
+
+NetworkInterface NetworkInterfaceCache::forName(const std::string& name) const
+{
+	NetworkInterface interfc;
+	if (!find(name, interfc)) throw InterfaceNotFoundException(name);
+	return interfc;
+}
+
+
+NetworkInterfaceCache::SnapshotPtr NetworkInterfaceCache::snapshot() const
+{
+	FastMutex::ScopedLock lock(_mutex);
+
+	return _pSnapshot;
+}
+
+
+void NetworkInterfaceCache::notifyChanges(const NetworkInterface::Map& oldMap, const NetworkInterface::Map& newMap)
+{
+	NetworkInterface::Map::const_iterator itOld = oldMap.begin();
+	NetworkInterface::Map::const_iterator itNew = newMap.begin();
+	while (itOld != oldMap.end() || itNew != newMap.end())
+	{
+		if (itNew == newMap.end() || (itOld != oldMap.end() && itOld->first < itNew->first))
+		{
+			interfaceRemoved.notify(this, itOld->second);
+			++itOld;
+		}
+		else if (itOld == oldMap.end() || itNew->first < itOld->first)
+		{
+			interfaceAdded.notify(this, itNew->second);
+			++itNew;
+		}
+		else
+		{
+			if (!sameConfiguration(itOld->second, itNew->second))
+				interfaceChanged.notify(this, itNew->second);
+			++itOld;
+			++itNew;
+		}
+	}
+}
+
+
+bool NetworkInterfaceCache::sameConfiguration(const NetworkInterface& interfc1, const NetworkInterface& interfc2)
+{
+	if (interfc1.name() != interfc2.name() ||
+		interfc1.mtu() != interfc2.mtu() ||
+		interfc1.isUp() != interfc2.isUp() ||
+		interfc1.isRunning() != interfc2.isRunning() ||
+		interfc1.macAddress() != interfc2.macAddress())
+		return false;
+
+	const NetworkInterface::AddressList& addresses1 = interfc1.addressList();
+	const NetworkInterface::AddressList& addresses2 = interfc2.addressList();
+	if (addresses1.size() != addresses2.size()) return false;
+	NetworkInterface::AddressList::const_iterator it1 = addresses1.begin();
+	NetworkInterface::AddressList::const_iterator it2 = addresses2.begin();
+	for (; it1 != addresses1.end(); ++it1, ++it2)
+	{
+		if (it1->get<NetworkInterface::IP_ADDRESS>() != it2->get<NetworkInterface::IP_ADDRESS>() ||
+			it1->get<NetworkInterface::SUBNET_MASK>() != it2->get<NetworkInterface::SUBNET_MASK>() ||
+			it1->get<NetworkInterface::BROADCAST_ADDRESS>() != it2->get<NetworkInterface::BROADCAST_ADDRESS>())
+			return false;
+	}
+	return true;
+}
+
+
+void NetworkInterfaceCache::run()
+{
+	const long POLL_INTERVAL = 250;
+	int fd = -1;
+#if POCO_OS == POCO_OS_LINUX
+	fd = ::socket(AF_NETLINK, SOCK_RAW, NETLINK_ROUTE);
+	if (fd >= 0)
+	{
+		struct sockaddr_nl addr;
+		std::memset(&addr, 0, sizeof(addr));
+		addr.nl_family = AF_NETLINK;
+		addr.nl_groups = RTMGRP_LINK | RTMGRP_IPV4_IFADDR | RTMGRP_IPV6_IFADDR;
+		if (::bind(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) != 0)
+		{
+			::close(fd);
+			fd = -1;
+		}
+	}
+#endif
+	_netlink = fd >= 0;
+
+	Poco::Timestamp lastRefresh;
+	while (!_stop)
+	{
+		bool changed = false;
+#if POCO_OS == POCO_OS_LINUX
+		if (fd >= 0)
+		{
+			struct pollfd pfd;
+			pfd.fd      = fd;
+			pfd.events  = POLLIN;
+			pfd.revents = 0;
+			if (::poll(&pfd, 1, POLL_INTERVAL) > 0)
+			{
+				// A single configuration change usually results in
+				// a burst of messages. The message contents are not
+				// needed, as the snapshot is rebuilt anyway.
+				char buffer[8192];
+				do
+				{
+					while (::recv(fd, buffer, sizeof(buffer), MSG_DONTWAIT) > 0)
+						changed = true;
+				}
+				while (!_wakeUp.tryWait(20) && ::poll(&pfd, 1, 0) > 0);
+			}
+		}
+		else
+#endif
+		_wakeUp.tryWait(POLL_INTERVAL);
+
+		Poco::Timespan interval = getRefreshInterval();
+		if (!_stop && (changed || (interval > 0 && lastRefresh.isElapsed(interval.totalMicroseconds()))))
+		{
+			try
+			{
+				refresh();
+			}
+			catch (Poco::Exception&)
+			{
+			}
+			lastRefresh.update();
+		}
+	}
+#if POCO_OS == POCO_OS_LINUX
+	if (fd >= 0) ::close(fd);
+#endif
+	_netlink = false;
+}
+
+
+namespace
+{
+	static SingletonHolder<NetworkInterfaceCache> sh;
+}
+
+
+NetworkInterfaceCache& NetworkInterfaceCache::defaultCache()
+{
+	NetworkInterfaceCache& cache = *sh.get();
+	cache.start();
+	return cache;
+}
+
+
+} } // namespace Poco::Net
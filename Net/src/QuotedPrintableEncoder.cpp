@@ -35,11 +35,9 @@
 
 
 #include "Poco/Net/QuotedPrintableEncoder.h"
-#include "Poco/NumberFormatter.h"
 
 
 using Poco::UnbufferedStreamBuf;
-using Poco::NumberFormatter;
 
 
 namespace Poco {
@@ -49,7 +47,8 @@ namespace Net {
 QuotedPrintableEncoderBuf::QuotedPrintableEncoderBuf(std::ostream& ostr): 
 	_pending(-1),
 	_lineLength(0),
-	_ostr(ostr)
+	_ostr(ostr),
+	_bufferLength(0)
 {
 }
 
@@ -67,6 +66,26 @@ QuotedPrintableEncoderBuf::~QuotedPrintableEncoderBuf()
 
 
 int QuotedPrintableEncoderBuf::writeToDevice(char c)
+{
+	encode(c);
+	flushBuffer();
+	return charToInt(c);
+}
+
+
+std::streamsize QuotedPrintableEncoderBuf::xsputn(const char* s, std::streamsize n)
+{
+	const char* end = s + n;
+	for (const char* it = s; it != end; ++it)
+	{
+		encode(*it);
+	}
+	flushBuffer();
+	return _ostr ? n : 0;
+}
+
+
+void QuotedPrintableEncoderBuf::encode(char c)
 {
 	if (_pending != -1)
 	{
@@ -81,7 +100,6 @@ int QuotedPrintableEncoderBuf::writeToDevice(char c)
 	if (c == '\t' || c == ' ')
 	{
 		_pending = charToInt(c);
-		return _pending;
 	}
 	else if (c == '\r' || c == '\n' || (c > 32 && c < 127 && c != '='))
 	{
@@ -91,19 +109,25 @@ int QuotedPrintableEncoderBuf::writeToDevice(char c)
 	{
 		writeEncoded(c);
 	}
-	return charToInt(c);
 }
 
 
 void QuotedPrintableEncoderBuf::writeEncoded(char c)
 {
+	static const char HEX[] = "0123456789ABCDEF";
+
 	if (_lineLength >= 73)
 	{
-		_ostr << "=\r\n";
+		put('=');
+		put('\r');
+		put('\n');
 		_lineLength = 3;
 	}
 	else _lineLength += 3;
-	_ostr << '=' << NumberFormatter::formatHex((unsigned) charToInt(c), 2);
+	unsigned char uc = static_cast<unsigned char>(c);
+	put('=');
+	put(HEX[uc >> 4]);
+	put(HEX[uc & 0x0F]);
 }
 
 
@@ -111,22 +135,42 @@ void QuotedPrintableEncoderBuf::writeRaw(char c)
 {
 	if (c == '\r' || c == '\n')
 	{
-		_ostr.put(c);
+		put(c);
 		_lineLength = 0;
 	}
 	else if (_lineLength < 75)
 	{
-		_ostr.put(c);
+		put(c);
 		++_lineLength;
 	}
 	else
 	{
-		_ostr << "=\r\n" << c;
+		put('=');
+		put('\r');
+		put('\n');
+		put(c);
 		_lineLength = 1;
 	}
 }
 
 
+void QuotedPrintableEncoderBuf::put(char c)
+{
+	if (_bufferLength == BUFFER_SIZE) flushBuffer();
+	_buffer[_bufferLength++] = c;
+}
+
+
+void QuotedPrintableEncoderBuf::flushBuffer()
+{
+	if (_bufferLength > 0)
+	{
+		_ostr.write(_buffer, _bufferLength);
+		_bufferLength = 0;
+	}
+}
+
+
 int QuotedPrintableEncoderBuf::close()
 {
 	sync();
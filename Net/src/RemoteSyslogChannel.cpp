@@ -43,6 +43,13 @@
 #include "Poco/LoggingFactory.h"
 #include "Poco/Instantiator.h"
 #include "Poco/String.h"
+#include "Poco/NumberParser.h"
+#include <cstring>
+#if POCO_OS == POCO_OS_LINUX && defined(_GNU_SOURCE) && !defined(POCO_NO_SENDMMSG)
+#define POCO_HAVE_SENDMMSG
+#include <sys/socket.h>
+#include <errno.h>
+#endif
 
 
 namespace Poco {
@@ -56,6 +63,9 @@ const std::string RemoteSyslogChannel::PROP_FACILITY("facility");
 const std::string RemoteSyslogChannel::PROP_FORMAT("format");
 const std::string RemoteSyslogChannel::PROP_LOGHOST("loghost");
 const std::string RemoteSyslogChannel::PROP_HOST("host");
+const std::string RemoteSyslogChannel::PROP_TRANSPORT("transport");
+const std::string RemoteSyslogChannel::PROP_ASYNC("async");
+const std::string RemoteSyslogChannel::PROP_QUEUE_SIZE("queueSize");
 
 
 RemoteSyslogChannel::RemoteSyslogChannel():
@@ -63,7 +73,16 @@ RemoteSyslogChannel::RemoteSyslogChannel():
 	_name("-"),
 	_facility(SYSLOG_USER),
 	_bsdFormat(false),
-	_open(false)
+	_open(false),
+	_tcp(false),
+	_connected(false),
+	_async(false),
+	_queueSize(DEFAULT_QUEUE_SIZE),
+	_head(0),
+	_count(0),
+	_sent(0),
+	_dropped(0),
+	_stop(false)
 {
 }
 
@@ -73,7 +92,16 @@ RemoteSyslogChannel::RemoteSyslogChannel(const std::string& address, const std::
 	_name(name),
 	_facility(facility),
 	_bsdFormat(bsdFormat),
-	_open(false)
+	_open(false),
+	_tcp(false),
+	_connected(false),
+	_async(false),
+	_queueSize(DEFAULT_QUEUE_SIZE),
+	_head(0),
+	_count(0),
+	_sent(0),
+	_dropped(0),
+	_stop(false)
 {
 	if (_name.empty()) _name = "-";
 }
@@ -94,6 +122,8 @@ void RemoteSyslogChannel::open()
 	else
 		_socketAddress = SocketAddress(_logHost, SYSLOG_PORT);
 
+	if (!_tcp) _socket = DatagramSocket(_socketAddress.family());
+
 	if (_host.empty())
 	{
 		try
@@ -105,6 +135,17 @@ void RemoteSyslogChannel::open()
 			_host = _socket.address().host().toString();
 		}
 	}
+	
+	if (_async)
+	{
+		_ring.resize(static_cast<std::size_t>(_queueSize)*MAX_MESSAGE_SIZE);
+		_lengths.resize(_queueSize);
+		_head  = 0;
+		_count = 0;
+		_stop  = false;
+		_thread.start(*this);
+	}
+	_open = true;
 }
 
 	
@@ -112,7 +153,19 @@ void RemoteSyslogChannel::close()
 {
 	if (_open)
 	{
-		_socket.close();
+		if (_async)
+		{
+			{
+				Poco::FastMutex::ScopedLock lock(_mutex);
+				_stop = true;
+			}
+			_messageReady.set();
+			_thread.join();
+		}
+		if (_tcp)
+			disconnect();
+		else
+			_socket.close();
 		_open = false;
 	}
 }
@@ -124,8 +177,33 @@ void RemoteSyslogChannel::log(const Message& msg)
 
 	if (!_open) open();
 
-	std::string m;
-	m.reserve(1024);
+	if (_async)
+	{
+		if (_count == _queueSize) 
+		{
+			++_dropped;
+			return;
+		}
+		_buffer.clear();
+		format(msg, _buffer);
+		int slot = (_head + _count) % _queueSize;
+		int length = _buffer.size() < MAX_MESSAGE_SIZE ? static_cast<int>(_buffer.size()) : MAX_MESSAGE_SIZE;
+		std::memcpy(&_ring[static_cast<std::size_t>(slot)*MAX_MESSAGE_SIZE], _buffer.data(), length);
+		_lengths[slot] = length;
+		if (_count++ == 0) _messageReady.set();
+	}
+	else
+	{
+		std::string m;
+		m.reserve(1024);
+		format(msg, m);
+		sendMessage(m.data(), static_cast<int>(m.size()));
+	}
+}
+
+
+void RemoteSyslogChannel::format(const Message& msg, std::string& m) const
+{
 	m += '<';
 	Poco::NumberFormatter::append(m, getPrio(msg) + _facility);
 	m += '>';
@@ -150,8 +228,180 @@ void RemoteSyslogChannel::log(const Message& msg)
 	}
 	m += ' ';
 	m += msg.getText();
+}
+
+
+void RemoteSyslogChannel::sendMessage(const char* text, int length)
+{
+	if (_tcp)
+	{
+		_frames.clear();
+		Poco::NumberFormatter::append(_frames, length);
+		_frames += ' ';
+		_frames.append(text, length);
+		sendFrames(_frames.data(), static_cast<int>(_frames.size()));
+	}
+	else
+	{
+		_socket.sendTo(text, length, _socketAddress);
+	}
+}
+
 
-	_socket.sendTo(m.data(), static_cast<int>(m.size()), _socketAddress);
+void RemoteSyslogChannel::sendBatch(int first, int count, int& sent)
+{
+	sent = 0;
+	if (_tcp)
+	{
+		_frames.clear();
+		for (int i = first; i < first + count; ++i)
+		{
+			Poco::NumberFormatter::append(_frames, _lengths[i]);
+			_frames += ' ';
+			_frames.append(&_ring[static_cast<std::size_t>(i)*MAX_MESSAGE_SIZE], _lengths[i]);
+		}
+		sendFrames(_frames.data(), static_cast<int>(_frames.size()));
+		sent = count;
+	}
+	else
+	{
+#if defined(POCO_HAVE_SENDMMSG)
+		struct mmsghdr msgs[SEND_BATCH];
+		struct iovec   iov[SEND_BATCH];
+		poco_assert (count <= SEND_BATCH);
+		std::memset(msgs, 0, sizeof(msgs));
+		for (int i = 0; i < count; ++i)
+		{
+			iov[i].iov_base = &_ring[static_cast<std::size_t>(first + i)*MAX_MESSAGE_SIZE];
+			iov[i].iov_len  = _lengths[first + i];
+			msgs[i].msg_hdr.msg_name    = const_cast<struct sockaddr*>(_socketAddress.addr());
+			msgs[i].msg_hdr.msg_namelen = _socketAddress.length();
+			msgs[i].msg_hdr.msg_iov     = &iov[i];
+			msgs[i].msg_hdr.msg_iovlen  = 1;
+		}
+		poco_socket_t sockfd = _socket.impl()->sockfd();
+		while (sent < count)
+		{
+			int rc = ::sendmmsg(sockfd, msgs + sent, count - sent, 0);
+			if (rc < 0)
+			{
+				if (errno == EINTR) continue;
+				break;
+			}
+			sent += rc;
+		}
+#else
+		for (int i = first; i < first + count; ++i)
+		{
+			try
+			{
+				_socket.sendTo(&_ring[static_cast<std::size_t>(i)*MAX_MESSAGE_SIZE], _lengths[i], _socketAddress);
+				++sent;
+			}
+			catch (Poco::Exception&)
+			{
+			}
+		}
+#endif
+	}
+}
+
+
+void RemoteSyslogChannel::sendFrames(const char* data, int length)
+{
+	if (!_connected) connect();
+	try
+	{
+		while (length > 0)
+		{
+			int n = _streamSocket.sendBytes(data, length);
+			data   += n;
+			length -= n;
+		}
+	}
+	catch (Poco::Exception&)
+	{
+		disconnect();
+		throw;
+	}
+}
+
+
+void RemoteSyslogChannel::connect()
+{
+	_streamSocket = StreamSocket(_socketAddress.family());
+	_streamSocket.connect(_socketAddress);
+	_streamSocket.setNoDelay(true);
+	_connected = true;
+}
+
+
+void RemoteSyslogChannel::disconnect()
+{
+	if (_connected)
+	{
+		_connected = false;
+		try
+		{
+			_streamSocket.close();
+		}
+		catch (Poco::Exception&)
+		{
+		}
+	}
+}
+
+
+void RemoteSyslogChannel::run()
+{
+	for (;;)
+	{
+		_messageReady.tryWait(1000);
+		for (;;)
+		{
+			int first;
+			int count;
+			{
+				Poco::FastMutex::ScopedLock lock(_mutex);
+				if (_count == 0) break;
+				first = _head;
+				count = _count < SEND_BATCH ? _count : SEND_BATCH;
+				if (first + count > _queueSize) count = _queueSize - first;
+			}
+			// the slots [first, first + count) are not touched by log() until released below
+			int sent = 0;
+			try
+			{
+				sendBatch(first, count, sent);
+			}
+			catch (Poco::Exception&)
+			{
+			}
+			{
+				Poco::FastMutex::ScopedLock lock(_mutex);
+				_head     = (_head + count) % _queueSize;
+				_count   -= count;
+				_sent    += sent;
+				_dropped += count - sent;
+			}
+		}
+		Poco::FastMutex::ScopedLock lock(_mutex);
+		if (_stop && _count == 0) break;
+	}
+}
+
+
+Poco::UInt64 RemoteSyslogChannel::sent() const
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+	return _sent;
+}
+
+
+Poco::UInt64 RemoteSyslogChannel::dropped() const
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+	return _dropped;
 }
 
 	
@@ -233,6 +483,20 @@ void RemoteSyslogChannel::setProperty(const std::string& name, const std::string
 	{
 		_bsdFormat = (value == "bsd" || value == "rfc3164");
 	}
+	else if (name == PROP_TRANSPORT)
+	{
+		_tcp = (Poco::icompare(value, "tcp") == 0);
+	}
+	else if (name == PROP_ASYNC)
+	{
+		_async = (Poco::icompare(value, "true") == 0);
+	}
+	else if (name == PROP_QUEUE_SIZE)
+	{
+		int queueSize = Poco::NumberParser::parse(value);
+		if (queueSize < 1) throw Poco::InvalidArgumentException("queueSize", value);
+		_queueSize = queueSize;
+	}
 	else
 	{
 		Channel::setProperty(name, value);
@@ -314,6 +578,18 @@ std::string RemoteSyslogChannel::getProperty(const std::string& name) const
 	{
 		return _bsdFormat ? "rfc3164" : "rfc5424";
 	}
+	else if (name == PROP_TRANSPORT)
+	{
+		return _tcp ? "tcp" : "udp";
+	}
+	else if (name == PROP_ASYNC)
+	{
+		return _async ? "true" : "false";
+	}
+	else if (name == PROP_QUEUE_SIZE)
+	{
+		return Poco::NumberFormatter::format(_queueSize);
+	}
 	else
 	{
 		return Channel::getProperty(name);
@@ -38,7 +38,10 @@
 #include "Poco/Net/MailMessage.h"
 #include "Poco/Net/MailRecipient.h"
 #include "Poco/Net/SMTPClientSession.h"
+#include "Poco/Net/NetException.h"
 #include "Poco/Net/StringPartSource.h"
+#include "Poco/Net/StreamSocket.h"
+#include "Poco/Net/SocketAddress.h"
 #include "Poco/Message.h"
 #include "Poco/DateTimeFormatter.h"
 #include "Poco/DateTimeFormat.h"
@@ -46,9 +49,11 @@
 #include "Poco/LoggingFactory.h"
 #include "Poco/Instantiator.h"
 #include "Poco/NumberFormatter.h"
+#include "Poco/NumberParser.h"
 #include "Poco/FileStream.h"
 #include "Poco/File.h"
 #include "Poco/Environment.h"
+#include <memory>
 
 
 namespace Poco {
@@ -63,6 +68,8 @@ const std::string SMTPChannel::PROP_ATTACHMENT("attachment");
 const std::string SMTPChannel::PROP_TYPE("type");
 const std::string SMTPChannel::PROP_DELETE("delete");
 const std::string SMTPChannel::PROP_THROW("throw");
+const std::string SMTPChannel::PROP_BATCHSIZE("batchSize");
+const std::string SMTPChannel::PROP_FLUSHINTERVAL("flushInterval");
 
 
 SMTPChannel::SMTPChannel():
@@ -70,7 +77,10 @@ SMTPChannel::SMTPChannel():
 	_local(true),
 	_type("text/plain"),
 	_delete(false),
-	_throw(false)
+	_throw(false),
+	_batchSize(1),
+	_flushInterval(10),
+	_pTimer(0)
 {
 }
 
@@ -82,14 +92,23 @@ SMTPChannel::SMTPChannel(const std::string& mailhost, const std::string& sender,
 	_local(true),
 	_type("text/plain"),
 	_delete(false),
-	_throw(false)
+	_throw(false),
+	_batchSize(1),
+	_flushInterval(10),
+	_pTimer(0)
 {
 }
 
 
 SMTPChannel::~SMTPChannel()
 {
-	close();
+	try
+	{
+		close();
+	}
+	catch (...)
+	{
+	}
 }
 
 
@@ -100,6 +119,25 @@ void SMTPChannel::open()
 	
 void SMTPChannel::close()
 {
+	Poco::Timer* pTimer;
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+		pTimer = _pTimer;
+		_pTimer = 0;
+	}
+	if (pTimer)
+	{
+		pTimer->stop();
+		delete pTimer;
+	}
+	try
+	{
+		flush();
+	}
+	catch (Exception&)
+	{
+		if (_throw) throw;
+	}
 }
 
 	
@@ -107,60 +145,25 @@ void SMTPChannel::log(const Message& msg)
 {
 	try
 	{
-		MailMessage message;
-		message.setSender(_sender);
-		message.addRecipient(MailRecipient(MailRecipient::PRIMARY_RECIPIENT, _recipient));
-		message.setSubject("Log Message from " + _sender);
-		std::stringstream content;
-		content << "Log Message\r\n"
-			<< "===========\r\n\r\n"
-			<< "Host: " << Environment::nodeName() << "\r\n"
-			<< "Logger: " << msg.getSource() << "\r\n";
-
-		if (_local)
-		{
-			DateTime dt(msg.getTime());
-			content	<< "Timestamp: " << DateTimeFormatter::format(LocalDateTime(dt), DateTimeFormat::RFC822_FORMAT) << "\r\n";
-		}
-		else
-			content	<< "Timestamp: " << DateTimeFormatter::format(msg.getTime(), DateTimeFormat::RFC822_FORMAT) << "\r\n";
-
-		content	<< "Priority: " << NumberFormatter::format(msg.getPriority()) << "\r\n"
-			<< "Process ID: " << NumberFormatter::format(msg.getPid()) << "\r\n"
-			<< "Thread: " << msg.getThread() << " (ID: " << msg.getTid() << ")\r\n"
-			<< "Message text: " << msg.getText() << "\r\n\r\n";
-
-		message.addContent(new StringPartSource(content.str()));
-	
-		if (!_attachment.empty())
+		if (_batchSize > 1)
 		{
+			bool full;
 			{
-				Poco::FileInputStream fis(_attachment, std::ios::in | std::ios::binary | std::ios::ate);
-				if (fis.good())
+				Poco::FastMutex::ScopedLock lock(_mutex);
+				_pending.push_back(msg);
+				full = static_cast<int>(_pending.size()) >= _batchSize;
+				if (!_pTimer && _flushInterval > 0)
 				{
-					typedef std::allocator<std::string::value_type>::size_type SST;
-
-					std::streamoff size = fis.tellg();
-					poco_assert (std::numeric_limits<unsigned int>::max() >= size);
-					poco_assert (std::numeric_limits<SST>::max() >= size);
-					char* pMem = new char [static_cast<unsigned int>(size)];
-					fis.seekg(std::ios::beg);
-					fis.read(pMem, size);
-					message.addAttachment(_attachment,
-						new StringPartSource(std::string(pMem, static_cast<SST>(size)), 
-							_type,
-							_attachment));
-
-					delete [] pMem;
+					_pTimer = new Poco::Timer(_flushInterval*1000, _flushInterval*1000);
+					_pTimer->start(Poco::TimerCallback<SMTPChannel>(*this, &SMTPChannel::onTimer));
 				}
 			}
-			if (_delete) File(_attachment).remove();
+			if (full) flush();
+		}
+		else
+		{
+			sendMessages(MessageVec(1, msg));
 		}
-
-		SMTPClientSession session(_mailHost);
-		session.login();
-		session.sendMessage(message);
-		session.close();
 	} 
 	catch (Exception&) 
 	{ 
@@ -168,6 +171,112 @@ void SMTPChannel::log(const Message& msg)
 	}
 }
 
+
+void SMTPChannel::flush()
+{
+	MessageVec messages;
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+		messages.swap(_pending);
+	}
+	if (!messages.empty()) sendMessages(messages);
+}
+
+
+void SMTPChannel::onTimer(Poco::Timer& timer)
+{
+	try
+	{
+		flush();
+	}
+	catch (...)
+	{
+	}
+}
+
+
+void SMTPChannel::sendMessages(const MessageVec& messages)
+{
+	std::auto_ptr<SMTPClientSession> pSession;
+	if (_mailHost.find(':') != std::string::npos)
+		pSession.reset(new SMTPClientSession(StreamSocket(SocketAddress(_mailHost))));
+	else
+		pSession.reset(new SMTPClientSession(_mailHost));
+	SMTPClientSession& session = *pSession;
+	session.login();
+	std::auto_ptr<Exception> pExc;
+	for (MessageVec::const_iterator it = messages.begin(); it != messages.end(); ++it)
+	{
+		MailMessage message;
+		buildMessage(*it, message);
+		try
+		{
+			session.sendMessage(message);
+		}
+		catch (SMTPException& exc)
+		{
+			// a rejected message must not prevent the
+			// remaining messages in the batch from being sent
+			if (!pExc.get()) pExc.reset(exc.clone());
+		}
+	}
+	session.close();
+	if (pExc.get()) pExc->rethrow();
+}
+
+
+void SMTPChannel::buildMessage(const Message& msg, MailMessage& message)
+{
+	message.setSender(_sender);
+	message.addRecipient(MailRecipient(MailRecipient::PRIMARY_RECIPIENT, _recipient));
+	message.setSubject("Log Message from " + _sender);
+	std::stringstream content;
+	content << "Log Message\r\n"
+		<< "===========\r\n\r\n"
+		<< "Host: " << Environment::nodeName() << "\r\n"
+		<< "Logger: " << msg.getSource() << "\r\n";
+
+	if (_local)
+	{
+		DateTime dt(msg.getTime());
+		content	<< "Timestamp: " << DateTimeFormatter::format(LocalDateTime(dt), DateTimeFormat::RFC822_FORMAT) << "\r\n";
+	}
+	else
+		content	<< "Timestamp: " << DateTimeFormatter::format(msg.getTime(), DateTimeFormat::RFC822_FORMAT) << "\r\n";
+
+	content	<< "Priority: " << NumberFormatter::format(msg.getPriority()) << "\r\n"
+		<< "Process ID: " << NumberFormatter::format(msg.getPid()) << "\r\n"
+		<< "Thread: " << msg.getThread() << " (ID: " << msg.getTid() << ")\r\n"
+		<< "Message text: " << msg.getText() << "\r\n\r\n";
+
+	message.addContent(new StringPartSource(content.str()));
+
+	if (!_attachment.empty())
+	{
+		{
+			Poco::FileInputStream fis(_attachment, std::ios::in | std::ios::binary | std::ios::ate);
+			if (fis.good())
+			{
+				typedef std::allocator<std::string::value_type>::size_type SST;
+
+				std::streamoff size = fis.tellg();
+				poco_assert (std::numeric_limits<unsigned int>::max() >= size);
+				poco_assert (std::numeric_limits<SST>::max() >= size);
+				char* pMem = new char [static_cast<unsigned int>(size)];
+				fis.seekg(std::ios::beg);
+				fis.read(pMem, size);
+				message.addAttachment(_attachment,
+					new StringPartSource(std::string(pMem, static_cast<SST>(size)), 
+						_type,
+						_attachment));
+
+				delete [] pMem;
+			}
+		}
+		if (_delete) File(_attachment).remove();
+	}
+}
+
 	
 void SMTPChannel::setProperty(const std::string& name, const std::string& value)
 {
@@ -187,6 +296,10 @@ void SMTPChannel::setProperty(const std::string& name, const std::string& value)
 		_delete = isTrue(value);
 	else if (name == PROP_THROW) 
 		_throw = isTrue(value);
+	else if (name == PROP_BATCHSIZE) 
+		_batchSize = NumberParser::parse(value);
+	else if (name == PROP_FLUSHINTERVAL) 
+		_flushInterval = NumberParser::parse(value);
 	else 
 		Channel::setProperty(name, value);
 }
@@ -210,6 +323,10 @@ std::string SMTPChannel::getProperty(const std::string& name) const
 		return _delete ? "true" : "false";
 	else if (name == PROP_THROW) 
 		return _throw ? "true" : "false";
+	else if (name == PROP_BATCHSIZE) 
+		return NumberFormatter::format(_batchSize);
+	else if (name == PROP_FLUSHINTERVAL) 
+		return NumberFormatter::format(_flushInterval);
 	else
 		return Channel::getProperty(name);
 }
@@ -73,14 +73,18 @@ namespace Net {
 
 SMTPClientSession::SMTPClientSession(const StreamSocket& socket):
 	_socket(socket),
-	_isOpen(false)
+	_isOpen(false),
+	_pipelining(true),
+	_inTransaction(false)
 {
 }
 
 
 SMTPClientSession::SMTPClientSession(const std::string& host, Poco::UInt16 port):
 	_socket(SocketAddress(host, port)),
-	_isOpen(false)
+	_isOpen(false),
+	_pipelining(true),
+	_inTransaction(false)
 {
 }
 
@@ -112,13 +116,47 @@ Poco::Timespan SMTPClientSession::getTimeout() const
 void SMTPClientSession::login(const std::string& hostname, std::string& response)
 {
 	open();
+	_extensions.clear();
 	int status = sendCommand("EHLO", hostname, response);
-	if (isPermanentNegative(status))
+	if (isPositiveCompletion(status))
+		parseExtensions(response);
+	else if (isPermanentNegative(status))
 		status = sendCommand("HELO", hostname, response);
 	if (!isPositiveCompletion(status)) throw SMTPException("Login failed", response, status);
 }
 
 
+void SMTPClientSession::parseExtensions(const std::string& response)
+{
+	// The first line of the EHLO response contains the server's
+	// domain name, each following line starts with an extension keyword.
+	std::string::size_type pos = response.find('\n');
+	while (pos != std::string::npos)
+	{
+		std::string::size_type start = pos + 5; // skip "\n250-" or "\n250 "
+		pos = response.find('\n', start);
+		if (start < response.size())
+		{
+			std::string::size_type end = response.find_first_of(" \r\n", start);
+			if (end == std::string::npos) end = response.size();
+			_extensions.insert(Poco::toUpper(response.substr(start, end - start)));
+		}
+	}
+}
+
+
+bool SMTPClientSession::hasExtension(const std::string& extension) const
+{
+	return _extensions.find(Poco::toUpper(extension)) != _extensions.end();
+}
+
+
+void SMTPClientSession::setPipelining(bool pipelining)
+{
+	_pipelining = pipelining;
+}
+
+
 void SMTPClientSession::login(const std::string& hostname)
 {
 	std::string response;
@@ -310,61 +348,144 @@ void SMTPClientSession::close()
 {
 	if (_isOpen)
 	{
+		_isOpen = false;
 		std::string response;
 		sendCommand("QUIT", response);
 		_socket.close();
-		_isOpen = false;
 	}
 }
 
 
-void SMTPClientSession::sendCommands(const MailMessage& message, const Recipients* pRecipients)
+void SMTPClientSession::reset()
 {
 	std::string response;
-	int status = 0;
+	int status = sendCommand("RSET", response);
+	if (!isPositiveCompletion(status)) throw SMTPException("Cannot reset mail transaction", response, status);
+	_inTransaction = false;
+}
+
+
+void SMTPClientSession::sendCommands(const MailMessage& message, const Recipients* pRecipients)
+{
+	if (_inTransaction) reset();
+	
+	std::string sender;
 	const std::string& fromField = message.getSender();
 	std::string::size_type emailPos = fromField.find('<');
 	if (emailPos == std::string::npos)
 	{
-		std::string sender("<");
+		sender += '<';
 		sender.append(fromField);
-		sender.append(">");
-		status = sendCommand("MAIL FROM:", sender, response);
+		sender += '>';
 	}
 	else
 	{
-		status = sendCommand("MAIL FROM:", fromField.substr(emailPos, fromField.size() - emailPos), response);
+		sender.assign(fromField, emailPos, fromField.size() - emailPos);
 	}
 
-	if (!isPositiveCompletion(status)) throw SMTPException("Cannot send message", response, status);
-	
-	std::ostringstream recipient;
+	Recipients recipients;
 	if (pRecipients)
 	{
 		for (Recipients::const_iterator it = pRecipients->begin(); it != pRecipients->end(); ++it)
 		{
-			recipient << '<' << *it << '>';
-			int status = sendCommand("RCPT TO:", recipient.str(), response);
-			if (!isPositiveCompletion(status)) throw SMTPException(std::string("Recipient rejected: ") + recipient.str(), response, status);
-			recipient.str("");
+			recipients.push_back('<' + *it + '>');
 		}
 	}
 	else
 	{
 		for (MailMessage::Recipients::const_iterator it = message.recipients().begin(); it != message.recipients().end(); ++it)
 		{
-			recipient << '<' << it->getAddress() << '>';
-			int status = sendCommand("RCPT TO:", recipient.str(), response);
-			if (!isPositiveCompletion(status)) throw SMTPException(std::string("Recipient rejected: ") + recipient.str(), response, status);
-			recipient.str("");
+			recipients.push_back('<' + it->getAddress() + '>');
 		}
 	}
 
+	_inTransaction = true;
+	if (_pipelining && hasExtension("PIPELINING"))
+	{
+		sendPipelinedCommands(sender, recipients);
+		return;
+	}
+
+	std::string response;
+	int status = sendCommand("MAIL FROM:", sender, response);
+	if (!isPositiveCompletion(status)) throw SMTPException("Cannot send message", response, status);
+	
+	for (Recipients::const_iterator it = recipients.begin(); it != recipients.end(); ++it)
+	{
+		status = sendCommand("RCPT TO:", *it, response);
+		if (!isPositiveCompletion(status)) throw SMTPException(std::string("Recipient rejected: ") + *it, response, status);
+	}
+
 	status = sendCommand("DATA", response);
 	if (!isPositiveIntermediate(status)) throw SMTPException("Cannot send message data", response, status);
 }
 
 
+void SMTPClientSession::sendPipelinedCommands(const std::string& sender, const Recipients& recipients)
+{
+	std::string commands("MAIL FROM: ");
+	commands += sender;
+	commands += "\r\n";
+	for (Recipients::const_iterator it = recipients.begin(); it != recipients.end(); ++it)
+	{
+		commands += "RCPT TO: ";
+		commands += *it;
+		commands += "\r\n";
+	}
+	commands += "DATA\r\n";
+	_socket.sendString(commands);
+	
+	// All responses must be read, even if an earlier command failed,
+	// to keep the session in sync with the server.
+	std::string response;
+	std::string errorResponse;
+	std::string errorMessage;
+	int errorStatus = 0;
+	int status = _socket.receiveStatusMessage(response);
+	if (!isPositiveCompletion(status))
+	{
+		errorMessage  = "Cannot send message";
+		errorResponse = response;
+		errorStatus   = status;
+	}
+	for (Recipients::const_iterator it = recipients.begin(); it != recipients.end(); ++it)
+	{
+		status = _socket.receiveStatusMessage(response);
+		if (!isPositiveCompletion(status) && errorStatus == 0)
+		{
+			errorMessage  = std::string("Recipient rejected: ") + *it;
+			errorResponse = response;
+			errorStatus   = status;
+		}
+	}
+	status = _socket.receiveStatusMessage(response);
+	if (isPositiveIntermediate(status))
+	{
+		if (errorStatus != 0)
+		{
+			// The server has accepted DATA although a recipient has been
+			// rejected. The only way to abort the transaction without
+			// sending a message to the remaining recipients is to drop
+			// the connection.
+			_isOpen = false;
+			_inTransaction = false;
+			_socket.close();
+			throw SMTPException(errorMessage, errorResponse, errorStatus);
+		}
+	}
+	else 
+	{
+		if (errorStatus == 0)
+		{
+			errorMessage  = "Cannot send message data";
+			errorResponse = response;
+			errorStatus   = status;
+		}
+		throw SMTPException(errorMessage, errorResponse, errorStatus);
+	}
+}
+
+
 void SMTPClientSession::sendMessage(const MailMessage& message)
 {
 	sendCommands(message);
@@ -390,6 +511,7 @@ void SMTPClientSession::transportMessage(const MailMessage& message)
 	mailStream.close();
 	socketStream.flush();
 	status = _socket.receiveStatusMessage(response);
+	_inTransaction = false;
 	if (!isPositiveCompletion(status)) throw SMTPException("The server rejected the message", response, status);
 }
 
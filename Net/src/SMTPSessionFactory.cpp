@@ -0,0 +1,150 @@
+//
+// SMTPSessionFactory.cpp
+//
+// $Id: //poco/1.4/Net/src/SMTPSessionFactory.cpp#1 $
+//
+// Library: Net
+// Package: Mail
+// Module:  SMTPSessionFactory
+//
+// Copyright (c) 2013, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+// 
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+
+
+
+#include "Poco/Net/SMTPSessionFactory.h"
+#include "Poco/Exception.h"
+
+
+namespace Poco {
+namespace Net {
+
+
+SMTPSessionFactory::SMTPSessionFactory(const std::string& host, Poco::UInt16 port):
+	_host(host),
+	_port(port),
+	_loginMethod(SMTPClientSession::AUTH_NONE),
+	_timeout(30, 0),
+	_pipelining(true)
+{
+}
+
+
+SMTPSessionFactory::~SMTPSessionFactory()
+{
+}
+
+
+void SMTPSessionFactory::setHostName(const std::string& hostName)
+{
+	_hostName = hostName;
+}
+
+
+void SMTPSessionFactory::setLogin(SMTPClientSession::LoginMethod loginMethod, const std::string& username, const std::string& password)
+{
+	_loginMethod = loginMethod;
+	_username    = username;
+	_password    = password;
+}
+
+
+void SMTPSessionFactory::setTimeout(const Poco::Timespan& timeout)
+{
+	_timeout = timeout;
+}
+
+
+void SMTPSessionFactory::setPipelining(bool pipelining)
+{
+	_pipelining = pipelining;
+}
+
+
+SMTPClientSession* SMTPSessionFactory::createObject()
+{
+	SMTPClientSession* pSession = new SMTPClientSession(_host, _port);
+	try
+	{
+		pSession->setTimeout(_timeout);
+		pSession->setPipelining(_pipelining);
+		if (_hostName.empty())
+			pSession->login(_loginMethod, _username, _password);
+		else
+			pSession->login(_hostName, _loginMethod, _username, _password);
+	}
+	catch (...)
+	{
+		delete pSession;
+		throw;
+	}
+	return pSession;
+}
+
+
+bool SMTPSessionFactory::validateObject(SMTPClientSession* pSession)
+{
+	if (!pSession->isOpen()) return false;
+	if (pSession->inTransaction())
+	{
+		try
+		{
+			pSession->reset();
+		}
+		catch (Poco::Exception&)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+
+void SMTPSessionFactory::activateObject(SMTPClientSession* pSession)
+{
+}
+
+
+void SMTPSessionFactory::deactivateObject(SMTPClientSession* pSession)
+{
+}
+
+
+void SMTPSessionFactory::destroyObject(SMTPClientSession* pSession)
+{
+	try
+	{
+		pSession->close();
+	}
+	catch (...)
+	{
+	}
+	delete pSession;
+}
+
+
+} } // namespace Poco::Net
@@ -52,6 +52,13 @@
 #include <stropts.h>
 #endif
 
+
+#if POCO_OS == POCO_OS_LINUX
+#include <sys/sendfile.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 using Poco::IOException;
 using Poco::TimeoutException;
 using Poco::InvalidArgumentException;
@@ -310,6 +317,45 @@ int SocketImpl::sendBytes(const void* buffer, int length, int flags)
 }
 
 
+Poco::Int64 SocketImpl::sendFile(const std::string& path, Poco::UInt64 offset, Poco::UInt64 count)
+{
+#if POCO_OS == POCO_OS_LINUX
+	if (_sockfd == POCO_INVALID_SOCKET) throw InvalidSocketException();
+
+	int fd = ::open(path.c_str(), O_RDONLY);
+	if (fd < 0) throw Poco::OpenFileException(path);
+
+	// sendfile() transfers at most 0x7ffff000 bytes per call
+	const Poco::UInt64 maxChunk = 0x7ffff000;
+	off_t pos = static_cast<off_t>(offset);
+	Poco::Int64 sent = 0;
+	while (static_cast<Poco::UInt64>(sent) < count)
+	{
+		Poco::UInt64 remaining = count - sent;
+		ssize_t n = ::sendfile(_sockfd, fd, &pos, static_cast<std::size_t>(remaining < maxChunk ? remaining : maxChunk));
+		if (n < 0)
+		{
+			int err = lastError();
+			if (err == POCO_EINTR && _blocking) continue;
+			::close(fd);
+			if (err == POCO_EAGAIN && !_blocking)
+				return sent;
+			else if (err == POCO_EAGAIN || err == POCO_ETIMEDOUT)
+				throw TimeoutException();
+			else
+				error(err);
+		}
+		if (n == 0) break;
+		sent += n;
+	}
+	::close(fd);
+	return sent;
+#else
+	return -1;
+#endif
+}
+
+
 int SocketImpl::receiveBytes(void* buffer, int length, int flags)
 {
 #if defined(POCO_BROKEN_TIMEOUTS)
@@ -102,6 +102,39 @@ TimeoutNotification::~TimeoutNotification()
 }
 
 
+TimerNotification::TimerNotification(SocketReactor* pReactor, TimerWheel::Timer* pTimer): 
+	SocketNotification(pReactor),
+	_pTimer(pTimer, true)
+{
+}
+
+
+TimerNotification::~TimerNotification()
+{
+}
+
+
+TimerWheel::Timer::Ptr TimerNotification::timer() const
+{
+	return _pTimer;
+}
+
+
+ConnectNotification::ConnectNotification(SocketReactor* pReactor, Result result, const Socket& socket, const SocketAddress& address, int error): 
+	SocketNotification(pReactor),
+	_result(result),
+	_address(address),
+	_error(error)
+{
+	setSocket(socket);
+}
+
+
+ConnectNotification::~ConnectNotification()
+{
+}
+
+
 IdleNotification::IdleNotification(SocketReactor* pReactor): 
 	SocketNotification(pReactor)
 {
@@ -40,6 +40,7 @@
 #include "Poco/ErrorHandler.h"
 #include "Poco/Thread.h"
 #include "Poco/Exception.h"
+#include "Poco/Timestamp.h"
 
 
 using Poco::FastMutex;
@@ -51,6 +52,38 @@ namespace Poco {
 namespace Net {
 
 
+class SocketReactorTimer: public TimerWheel::Timer
+	/// A timer scheduled with SocketReactor::scheduleTimer().
+{
+public:
+	SocketReactorTimer(const Socket& socket, const Poco::AbstractObserver& observer):
+		_socket(socket),
+		_pObserver(observer.clone())
+	{
+	}
+
+	const Socket& socket() const
+	{
+		return _socket;
+	}
+
+	const Poco::AbstractObserver& observer() const
+	{
+		return *_pObserver;
+	}
+	
+protected:
+	~SocketReactorTimer()
+	{
+		delete _pObserver;
+	}
+
+private:
+	Socket                  _socket;
+	Poco::AbstractObserver* _pObserver;
+};
+
+
 SocketReactor::SocketReactor():
 	_stop(false),
 	_timeout(DEFAULT_TIMEOUT),
@@ -87,6 +120,7 @@ void SocketReactor::run()
 	Socket::SocketList readable;
 	Socket::SocketList writable;
 	Socket::SocketList except;
+	Poco::Timestamp lastEvent;
 	
 	while (!_stop)
 	{
@@ -117,12 +151,22 @@ void SocketReactor::run()
 					}
 				}
 			}
+			Poco::Timestamp now;
+			Poco::Timespan timeout(_timeout.totalMicroseconds() - (now - lastEvent));
+			if (timeout < 0) timeout = 0;
+			{
+				FastMutex::ScopedLock lock(_timerMutex);
+				Poco::Timespan timerTimeout;
+				if (_timers.nextTimeout(now, timerTimeout) && timerTimeout < timeout)
+					timeout = timerTimeout;
+			}
 			if (nSockets == 0)
 			{
 				onIdle();
 			}
-			else if (Socket::select(readable, writable, except, _timeout))
+			else if (Socket::select(readable, writable, except, timeout))
 			{
+				lastEvent.update();
 				onBusy();
 
 				for (Socket::SocketList::iterator it = readable.begin(); it != readable.end(); ++it)
@@ -132,7 +176,12 @@ void SocketReactor::run()
 				for (Socket::SocketList::iterator it = except.begin(); it != except.end(); ++it)
 					dispatch(*it, _pErrorNotification);
 			}
-			else onTimeout();
+			else if (lastEvent.isElapsed(_timeout.totalMicroseconds()))
+			{
+				lastEvent.update();
+				onTimeout();
+			}
+			dispatchTimers();
 		}
 		catch (Exception& exc)
 		{
@@ -230,6 +279,39 @@ void SocketReactor::removeEventHandler(const Socket& socket, const Poco::Abstrac
 }
 
 
+TimerWheel::Timer::Ptr SocketReactor::scheduleTimer(const Poco::Timespan& delay, const Poco::AbstractObserver& observer)
+{
+	return scheduleTimer(Socket(), delay, observer);
+}
+
+
+TimerWheel::Timer::Ptr SocketReactor::scheduleTimer(const Socket& socket, const Poco::Timespan& delay, const Poco::AbstractObserver& observer)
+{
+	TimerWheel::Timer::Ptr pTimer = new SocketReactorTimer(socket, observer);
+	FastMutex::ScopedLock lock(_timerMutex);
+	_timers.schedule(pTimer, delay);
+	return pTimer;
+}
+
+
+void SocketReactor::rescheduleTimer(TimerWheel::Timer::Ptr pTimer, const Poco::Timespan& delay)
+{
+	poco_check_ptr (pTimer);
+
+	FastMutex::ScopedLock lock(_timerMutex);
+	_timers.schedule(pTimer, delay);
+}
+
+
+void SocketReactor::cancelTimer(TimerWheel::Timer::Ptr pTimer)
+{
+	poco_check_ptr (pTimer);
+
+	FastMutex::ScopedLock lock(_timerMutex);
+	_timers.cancel(pTimer);
+}
+
+
 void SocketReactor::onTimeout()
 {
 	dispatch(_pTimeoutNotification);
@@ -284,6 +366,43 @@ void SocketReactor::dispatch(SocketNotification* pNotification)
 }
 
 
+void SocketReactor::dispatchTimers()
+{
+	TimerWheel::TimerVec expired;
+	{
+		FastMutex::ScopedLock lock(_timerMutex);
+		if (_timers.empty()) return;
+		_timers.advance(Poco::Timestamp(), expired);
+	}
+	for (TimerWheel::TimerVec::iterator it = expired.begin(); it != expired.end(); ++it)
+	{
+		{
+			FastMutex::ScopedLock lock(_timerMutex);
+			if (!_timers.claim(*it)) continue;
+		}
+		SocketReactorTimer* pTimer = static_cast<SocketReactorTimer*>(it->get());
+		NotificationPtr pNotification = new TimerNotification(this, pTimer);
+		pNotification->setSocket(pTimer->socket());
+		try
+		{
+			pTimer->observer().notify(pNotification);
+		}
+		catch (Exception& exc)
+		{
+			ErrorHandler::handle(exc);
+		}
+		catch (std::exception& exc)
+		{
+			ErrorHandler::handle(exc);
+		}
+		catch (...)
+		{
+			ErrorHandler::handle();
+		}
+	}
+}
+
+
 void SocketReactor::dispatch(NotifierPtr& pNotifier, SocketNotification* pNotification)
 {
 	try
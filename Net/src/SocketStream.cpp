@@ -37,6 +37,9 @@
 #include "Poco/Net/SocketStream.h"
 #include "Poco/Net/StreamSocketImpl.h"
 #include "Poco/Exception.h"
+#include <algorithm>
+#include <cstring>
+#include <limits>
 
 
 using Poco::BufferedBidirectionalStreamBuf;
@@ -52,9 +55,10 @@ namespace Net {
 //
 
 
-SocketStreamBuf::SocketStreamBuf(const Socket& socket): 
-	BufferedBidirectionalStreamBuf(STREAM_BUFFER_SIZE, std::ios::in | std::ios::out),
-	_pImpl(dynamic_cast<StreamSocketImpl*>(socket.impl()))
+SocketStreamBuf::SocketStreamBuf(const Socket& socket, std::streamsize bufferSize): 
+	BufferedBidirectionalStreamBuf(bufferSize, std::ios::in | std::ios::out),
+	_pImpl(dynamic_cast<StreamSocketImpl*>(socket.impl())),
+	_bufferSize(bufferSize)
 {
 	if (_pImpl)
 		_pImpl->duplicate(); 
@@ -69,6 +73,46 @@ SocketStreamBuf::~SocketStreamBuf()
 }
 
 
+std::streamsize SocketStreamBuf::xsgetn(char* buffer, std::streamsize length)
+{
+	std::streamsize n = egptr() - gptr();
+	if (length - n < _bufferSize)
+		return BufferedBidirectionalStreamBuf::xsgetn(buffer, length);
+
+	if (n > 0)
+	{
+		std::memcpy(buffer, gptr(), static_cast<std::size_t>(n));
+	}
+	// the data read below does not go through the buffer,
+	// so there is nothing left that could be put back
+	setg(egptr(), egptr(), egptr());
+	while (n < length)
+	{
+		int rc = readFromDevice(buffer + n, std::min<std::streamsize>(length - n, std::numeric_limits<int>::max()));
+		if (rc <= 0) break;
+		n += rc;
+	}
+	return n;
+}
+
+
+std::streamsize SocketStreamBuf::xsputn(const char* buffer, std::streamsize length)
+{
+	if (length < _bufferSize)
+		return BufferedBidirectionalStreamBuf::xsputn(buffer, length);
+
+	if (sync() == -1) return 0;
+	std::streamsize n = 0;
+	while (n < length)
+	{
+		int rc = writeToDevice(buffer + n, std::min<std::streamsize>(length - n, std::numeric_limits<int>::max()));
+		if (rc <= 0) break;
+		n += rc;
+	}
+	return n;
+}
+
+
 int SocketStreamBuf::readFromDevice(char* buffer, std::streamsize length)
 {
 	return _pImpl->receiveBytes(buffer, (int) length);
@@ -86,8 +130,8 @@ int SocketStreamBuf::writeToDevice(const char* buffer, std::streamsize length)
 //
 
 
-SocketIOS::SocketIOS(const Socket& socket):
-	_buf(socket)
+SocketIOS::SocketIOS(const Socket& socket, std::streamsize bufferSize):
+	_buf(socket, bufferSize)
 {
 	poco_ios_init(&_buf);
 }
@@ -129,8 +173,8 @@ StreamSocket SocketIOS::socket() const
 //
 
 
-SocketOutputStream::SocketOutputStream(const Socket& socket):
-	SocketIOS(socket),
+SocketOutputStream::SocketOutputStream(const Socket& socket, std::streamsize bufferSize):
+	SocketIOS(socket, bufferSize),
 	std::ostream(&_buf)
 {
 }
@@ -146,8 +190,8 @@ SocketOutputStream::~SocketOutputStream()
 //
 
 
-SocketInputStream::SocketInputStream(const Socket& socket):
-	SocketIOS(socket),
+SocketInputStream::SocketInputStream(const Socket& socket, std::streamsize bufferSize):
+	SocketIOS(socket, bufferSize),
 	std::istream(&_buf)
 {
 }
@@ -163,8 +207,8 @@ SocketInputStream::~SocketInputStream()
 //
 
 
-SocketStream::SocketStream(const Socket& socket):
-	SocketIOS(socket),
+SocketStream::SocketStream(const Socket& socket, std::streamsize bufferSize):
+	SocketIOS(socket, bufferSize),
 	std::iostream(&_buf)
 {
 }
@@ -148,6 +148,12 @@ int StreamSocket::receiveBytes(void* buffer, int length, int flags)
 }
 
 
+Poco::Int64 StreamSocket::sendFile(const std::string& path, Poco::UInt64 offset, Poco::UInt64 count)
+{
+	return impl()->sendFile(path, offset, count);
+}
+
+
 int StreamSocket::receiveBytes(FIFOBuffer& fifoBuf)
 {
 	int ret = impl()->receiveBytes(fifoBuf.next(), fifoBuf.available());
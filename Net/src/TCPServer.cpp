@@ -168,6 +168,12 @@ int TCPServer::refusedConnections() const
 }
 
 
+void TCPServer::enqueue(const StreamSocket& socket)
+{
+	_pDispatcher->enqueue(socket);
+}
+
+
 std::string TCPServer::threadName(const ServerSocket& socket)
 {
 	std::string name("TCPServer: ");
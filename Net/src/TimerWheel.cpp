@@ -0,0 +1,403 @@
+//
+// TimerWheel.cpp
+//
+// $Id: //poco/1.4/Net/src/TimerWheel.cpp#1 $
+//
+// Library: Net
+// Package: Reactor
+// Module:  TimerWheel
+//
+// Copyright (c) 2013, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+// 
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+
+#include "Poco/Net/TimerWheel.h"
+#include "Poco/Bugcheck.h"
+
+
+namespace Poco {
+namespace Net {
+
+
+//
+// TimerWheel::Timer
+//
+
+
+TimerWheel::Timer::Timer():
+	_state(TIMER_IDLE),
+	_tick(0),
+	_level(0),
+	_slot(0)
+{
+	pPrev = 0;
+	pNext = 0;
+}
+
+
+TimerWheel::Timer::~Timer()
+{
+}
+
+
+//
+// TimerWheel
+//
+
+
+TimerWheel::TimerWheel():
+	_base(0),
+	_resolution(DEFAULT_RESOLUTION),
+	_count(0)
+{
+	for (int level = 0; level < LEVELS; ++level)
+	{
+		_occupied[level] = 0;
+		for (int slot = 0; slot < SLOTS; ++slot)
+		{
+			_slots[level][slot].pPrev = _slots[level][slot].pNext = &_slots[level][slot];
+		}
+	}
+}
+
+
+TimerWheel::TimerWheel(const Poco::Timespan& resolution):
+	_base(0),
+	_resolution(resolution),
+	_count(0)
+{
+	poco_assert (resolution.totalMicroseconds() > 0);
+
+	for (int level = 0; level < LEVELS; ++level)
+	{
+		_occupied[level] = 0;
+		for (int slot = 0; slot < SLOTS; ++slot)
+		{
+			_slots[level][slot].pPrev = _slots[level][slot].pNext = &_slots[level][slot];
+		}
+	}
+}
+
+
+TimerWheel::~TimerWheel()
+{
+	for (int level = 0; level < LEVELS; ++level)
+	{
+		for (int slot = 0; slot < SLOTS; ++slot)
+		{
+			Link* pList = &_slots[level][slot];
+			while (pList->pNext != pList)
+			{
+				Timer* pTimer = static_cast<Timer*>(pList->pNext);
+				unlink(pTimer);
+				pTimer->_state = Timer::TIMER_IDLE;
+				pTimer->release();
+			}
+		}
+	}
+}
+
+
+void TimerWheel::schedule(Timer* pTimer, const Poco::Timestamp& expires)
+{
+	poco_check_ptr (pTimer);
+
+	if (pTimer->_state == Timer::TIMER_SCHEDULED)
+	{
+		remove(pTimer);
+	}
+	else
+	{
+		pTimer->duplicate();
+		++_count;
+	}
+	pTimer->_state   = Timer::TIMER_SCHEDULED;
+	pTimer->_expires = expires;
+	if (expires > _origin)
+	{
+		Poco::UInt64 res = _resolution.totalMicroseconds();
+		pTimer->_tick = (static_cast<Poco::UInt64>(expires - _origin) + res - 1)/res;
+	}
+	else pTimer->_tick = 0;
+	add(pTimer);
+}
+
+
+void TimerWheel::schedule(Timer* pTimer, const Poco::Timespan& delay)
+{
+	Poco::Timestamp expires;
+	expires += delay.totalMicroseconds();
+	schedule(pTimer, expires);
+}
+
+
+void TimerWheel::cancel(Timer* pTimer)
+{
+	poco_check_ptr (pTimer);
+
+	if (pTimer->_state == Timer::TIMER_SCHEDULED)
+	{
+		remove(pTimer);
+		--_count;
+		pTimer->_state = Timer::TIMER_IDLE;
+		pTimer->release();
+	}
+	else if (pTimer->_state == Timer::TIMER_EXPIRED)
+	{
+		pTimer->_state = Timer::TIMER_IDLE;
+	}
+}
+
+
+std::size_t TimerWheel::advance(const Poco::Timestamp& now, TimerVec& expired)
+{
+	std::size_t n = 0;
+	Poco::UInt64 target = ticks(now);
+	while (_base <= target)
+	{
+		if (_count == 0)
+		{
+			_base = target + 1;
+			break;
+		}
+		int index = static_cast<int>(_base & SLOT_MASK);
+		if (index == 0)
+		{
+			for (int level = 1; level < LEVELS; ++level)
+			{
+				int slot = static_cast<int>((_base >> (SLOT_BITS*level)) & SLOT_MASK);
+				cascade(level, slot);
+				if (slot != 0) break;
+			}
+		}
+		else if (_occupied[0] == 0)
+		{
+			// nothing to expire before the next cascade
+			Poco::UInt64 next = (_base | SLOT_MASK) + 1;
+			if (next > target)
+			{
+				_base = target + 1;
+				break;
+			}
+			_base = next;
+			continue;
+		}
+		Poco::UInt64 bit = Poco::UInt64(1) << index;
+		if (_occupied[0] & bit)
+		{
+			Link due;
+			due.pPrev = due.pNext = &due;
+			moveAll(&_slots[0][index], &due);
+			_occupied[0] &= ~bit;
+			while (due.pNext != &due)
+			{
+				Timer* pTimer = static_cast<Timer*>(due.pNext);
+				unlink(pTimer);
+				if (pTimer->_tick > _base)
+				{
+					add(pTimer);
+				}
+				else
+				{
+					pTimer->_state = Timer::TIMER_EXPIRED;
+					--_count;
+					expired.push_back(Timer::Ptr(pTimer, false));
+					++n;
+				}
+			}
+		}
+		++_base;
+	}
+	return n;
+}
+
+
+bool TimerWheel::claim(Timer* pTimer)
+{
+	poco_check_ptr (pTimer);
+
+	if (pTimer->_state == Timer::TIMER_EXPIRED)
+	{
+		pTimer->_state = Timer::TIMER_IDLE;
+		return true;
+	}
+	else return false;
+}
+
+
+bool TimerWheel::nextTimeout(const Poco::Timestamp& now, Poco::Timespan& timeout) const
+{
+	if (_count == 0) return false;
+
+	Poco::UInt64 next = 0;
+	bool found = false;
+	if (_occupied[0])
+	{
+		int current = static_cast<int>(_base & SLOT_MASK);
+		next  = _base + lowestBit(rotate(_occupied[0], current));
+		found = true;
+	}
+	for (int level = 1; level < LEVELS; ++level)
+	{
+		if (_occupied[level])
+		{
+			int shift = SLOT_BITS*level;
+			Poco::UInt64 q = _base >> shift;
+			int current = static_cast<int>(q & SLOT_MASK);
+			Poco::UInt64 bits = rotate(_occupied[level], current);
+			// the current slot is only cascaded now if the lower levels wrap around
+			if (_base & ((Poco::UInt64(1) << shift) - 1)) bits &= ~Poco::UInt64(1);
+			int distance = bits ? lowestBit(bits) : SLOTS;
+			Poco::UInt64 tick = (q + distance) << shift;
+			if (!found || tick < next)
+			{
+				next  = tick;
+				found = true;
+			}
+		}
+	}
+	poco_assert_dbg (found);
+
+	Poco::Timestamp when(_origin);
+	when += static_cast<Poco::Timestamp::TimeDiff>(next*_resolution.totalMicroseconds());
+	Poco::Timestamp::TimeDiff diff = when - now;
+	timeout = diff > 0 ? diff : 0;
+	return true;
+}
+
+
+void TimerWheel::add(Timer* pTimer)
+{
+	Poco::UInt64 tick  = pTimer->_tick < _base ? _base : pTimer->_tick;
+	Poco::UInt64 delta = tick - _base;
+	int level = 0;
+	while (level < LEVELS - 1 && delta >= (Poco::UInt64(1) << (SLOT_BITS*(level + 1))))
+		++level;
+	if (delta >= (Poco::UInt64(1) << (SLOT_BITS*LEVELS)))
+	{
+		// beyond the range of the wheel; park the timer in the
+		// farthest slot. It will be re-added when cascaded.
+		tick = _base + (Poco::UInt64(1) << (SLOT_BITS*LEVELS)) - 1;
+	}
+	int slot = static_cast<int>((tick >> (SLOT_BITS*level)) & SLOT_MASK);
+	append(&_slots[level][slot], pTimer);
+	_occupied[level] |= Poco::UInt64(1) << slot;
+	pTimer->_level = level;
+	pTimer->_slot  = slot;
+}
+
+
+void TimerWheel::remove(Timer* pTimer)
+{
+	unlink(pTimer);
+	Link* pList = &_slots[pTimer->_level][pTimer->_slot];
+	if (pList->pNext == pList)
+	{
+		_occupied[pTimer->_level] &= ~(Poco::UInt64(1) << pTimer->_slot);
+	}
+}
+
+
+void TimerWheel::cascade(int level, int slot)
+{
+	Poco::UInt64 bit = Poco::UInt64(1) << slot;
+	if (_occupied[level] & bit)
+	{
+		Link pending;
+		pending.pPrev = pending.pNext = &pending;
+		moveAll(&_slots[level][slot], &pending);
+		_occupied[level] &= ~bit;
+		while (pending.pNext != &pending)
+		{
+			Timer* pTimer = static_cast<Timer*>(pending.pNext);
+			unlink(pTimer);
+			add(pTimer);
+		}
+	}
+}
+
+
+Poco::UInt64 TimerWheel::ticks(const Poco::Timestamp& time) const
+{
+	if (time > _origin)
+		return static_cast<Poco::UInt64>(time - _origin)/_resolution.totalMicroseconds();
+	else
+		return 0;
+}
+
+
+void TimerWheel::unlink(Link* pLink)
+{
+	pLink->pPrev->pNext = pLink->pNext;
+	pLink->pNext->pPrev = pLink->pPrev;
+	pLink->pPrev = pLink->pNext = 0;
+}
+
+
+void TimerWheel::append(Link* pList, Link* pLink)
+{
+	pLink->pPrev = pList->pPrev;
+	pLink->pNext = pList;
+	pList->pPrev->pNext = pLink;
+	pList->pPrev = pLink;
+}
+
+
+void TimerWheel::moveAll(Link* pFrom, Link* pTo)
+{
+	if (pFrom->pNext != pFrom)
+	{
+		pFrom->pNext->pPrev = pTo->pPrev;
+		pFrom->pPrev->pNext = pTo;
+		pTo->pPrev->pNext = pFrom->pNext;
+		pTo->pPrev = pFrom->pPrev;
+		pFrom->pPrev = pFrom->pNext = pFrom;
+	}
+}
+
+
+int TimerWheel::lowestBit(Poco::UInt64 bits)
+{
+	poco_assert_dbg (bits != 0);
+
+	int n = 0;
+	if ((bits & 0xFFFFFFFF) == 0) { bits >>= 32; n += 32; }
+	if ((bits & 0xFFFF) == 0)     { bits >>= 16; n += 16; }
+	if ((bits & 0xFF) == 0)       { bits >>= 8;  n += 8;  }
+	if ((bits & 0xF) == 0)        { bits >>= 4;  n += 4;  }
+	if ((bits & 0x3) == 0)        { bits >>= 2;  n += 2;  }
+	if ((bits & 0x1) == 0)        { n += 1; }
+	return n;
+}
+
+
+Poco::UInt64 TimerWheel::rotate(Poco::UInt64 bits, int n)
+{
+	return n == 0 ? bits : (bits >> n) | (bits << (64 - n));
+}
+
+
+} } // namespace Poco::Net
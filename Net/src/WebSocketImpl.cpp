@@ -115,6 +115,12 @@ int WebSocketImpl::sendBytes(const void* buffer, int length, int flags)
 }
 
 	
+Poco::Int64 WebSocketImpl::sendFile(const std::string& path, Poco::UInt64 offset, Poco::UInt64 count)
+{
+	return -1;
+}
+
+
 int WebSocketImpl::receiveBytes(void* buffer, int length, int)
 {
 	char header[MAX_HEADER_LENGTH];
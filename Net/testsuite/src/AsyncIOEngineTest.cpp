@@ -0,0 +1,468 @@
+//
+// AsyncIOEngineTest.cpp
+//
+// $Id: //poco/1.4/Net/testsuite/src/AsyncIOEngineTest.cpp#1 $
+//
+// Copyright (c) 2013, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+// 
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+
+
+
+#include "AsyncIOEngineTest.h"
+#include "CppUnit/TestCaller.h"
+#include "CppUnit/TestSuite.h"
+#include "Poco/Net/AsyncIOEngine.h"
+#include "Poco/Net/IOUringEngine.h"
+#include "Poco/Net/EPollEngine.h"
+#include "Poco/Net/ServerSocket.h"
+#include "Poco/Net/StreamSocket.h"
+#include "Poco/Net/SocketAddress.h"
+#include "Poco/Net/NetException.h"
+#include "Poco/Observer.h"
+#include "Poco/Runnable.h"
+#include "Poco/Thread.h"
+#include "Poco/Event.h"
+#include "Poco/Exception.h"
+#include <vector>
+
+
+using Poco::Net::AsyncIOEngine;
+using Poco::Net::IOUringEngine;
+using Poco::Net::EPollEngine;
+using Poco::Net::AsyncIOOperation;
+using Poco::Net::AsyncIONotification;
+using Poco::Net::ServerSocket;
+using Poco::Net::StreamSocket;
+using Poco::Net::SocketAddress;
+using Poco::Net::NetException;
+using Poco::Observer;
+using Poco::Thread;
+using Poco::Timespan;
+
+
+namespace
+{
+	std::vector<AsyncIOEngine::Ptr> engines()
+	{
+		std::vector<AsyncIOEngine::Ptr> result;
+		try
+		{
+			result.push_back(new IOUringEngine(8, 4096));
+		}
+		catch (Poco::NotImplementedException&)
+		{
+		}
+		try
+		{
+			result.push_back(new EPollEngine(8, 4096));
+		}
+		catch (Poco::NotImplementedException&)
+		{
+		}
+		return result;
+	}
+
+	struct Connection
+	{
+		Connection():
+			server(SocketAddress("127.0.0.1", 0)),
+			client(server.address())
+		{
+			peer = server.acceptConnection();
+			client.setReceiveTimeout(Timespan(5, 0));
+			peer.setReceiveTimeout(Timespan(5, 0));
+		}
+
+		ServerSocket server;
+		StreamSocket client;
+		StreamSocket peer;
+	};
+
+	class CompletionHandler
+	{
+	public:
+		CompletionHandler():
+			_count(0),
+			_result(-1),
+			_done(false)
+		{
+		}
+
+		void onCompletion(AsyncIONotification* pNf)
+		{
+			Poco::AutoPtr<AsyncIONotification> pNotification(pNf);
+			_result = pNf->operation()->result();
+			_data.assign(pNf->operation()->data(), _result > 0 ? _result : 0);
+			// the waiting thread must not be woken up before
+			// the observer has been notified
+			_done = pNf->operation()->done();
+			++_count;
+		}
+
+		int count() const
+		{
+			return _count;
+		}
+
+		int result() const
+		{
+			return _result;
+		}
+
+		const std::string& data() const
+		{
+			return _data;
+		}
+
+		bool done() const
+		{
+			return _done;
+		}
+
+	private:
+		int         _count;
+		int         _result;
+		std::string _data;
+		bool        _done;
+	};
+
+	class Reader: public Poco::Runnable
+	{
+	public:
+		Reader(StreamSocket& socket):
+			_socket(socket),
+			_received(0)
+		{
+		}
+
+		void run()
+		{
+			char buffer[65536];
+			int n;
+			while ((n = _socket.receiveBytes(buffer, sizeof(buffer))) > 0)
+			{
+				for (int i = 0; i < n; ++i)
+				{
+					if (buffer[i] != static_cast<char>((_received + i) % 251)) throw Poco::DataException("bad data");
+				}
+				_received += n;
+			}
+		}
+
+		int received() const
+		{
+			return _received;
+		}
+
+	private:
+		StreamSocket& _socket;
+		int           _received;
+	};
+}
+
+
+AsyncIOEngineTest::AsyncIOEngineTest(const std::string& name): CppUnit::TestCase(name)
+{
+}
+
+
+AsyncIOEngineTest::~AsyncIOEngineTest()
+{
+}
+
+
+void AsyncIOEngineTest::testCreate()
+{
+#if POCO_OS == POCO_OS_LINUX
+	AsyncIOEngine::Ptr pEngine = AsyncIOEngine::create();
+	assert (pEngine->name() == "io_uring" || pEngine->name() == "epoll");
+	assert (!pEngine->running());
+	Connection conn;
+	try
+	{
+		pEngine->receive(conn.client);
+		fail("engine not running - must throw");
+	}
+	catch (Poco::IllegalStateException&)
+	{
+	}
+	pEngine->start();
+	assert (pEngine->running());
+	pEngine->stop();
+	assert (!pEngine->running());
+#endif
+}
+
+
+void AsyncIOEngineTest::testAcceptReceiveSend()
+{
+	std::vector<AsyncIOEngine::Ptr> all = engines();
+	for (std::vector<AsyncIOEngine::Ptr>::iterator it = all.begin(); it != all.end(); ++it)
+	{
+		AsyncIOEngine::Ptr pEngine = *it;
+		pEngine->start();
+
+		ServerSocket server(SocketAddress("127.0.0.1", 0));
+		AsyncIOOperation::Ptr pAccept = pEngine->accept(server);
+		StreamSocket client(server.address());
+		assert (pAccept->tryWait(5000));
+		assert (pAccept->result() == 1);
+		StreamSocket conn = pAccept->acceptedSocket();
+		assert (conn.peerAddress() == client.address());
+
+		AsyncIOOperation::Ptr pReceive = pEngine->receive(conn);
+		client.sendBytes("hello", 5);
+		assert (pReceive->tryWait(5000));
+		assert (pReceive->error() == 0);
+		assert (pReceive->result() == 5);
+		assert (std::string(pReceive->data(), 5) == "hello");
+
+		AsyncIOOperation::Ptr pSend = pEngine->send(conn, "world", 5);
+		assert (pSend->tryWait(5000));
+		assert (pSend->result() == 5);
+		char buffer[16];
+		client.setReceiveTimeout(Timespan(5, 0));
+		assert (client.receiveBytes(buffer, sizeof(buffer)) == 5);
+		assert (std::string(buffer, 5) == "world");
+
+		client.shutdownSend();
+		pReceive = pEngine->receive(conn);
+		assert (pReceive->tryWait(5000));
+		assert (pReceive->result() == 0);
+
+		assert (pEngine->pending() == 0);
+		pEngine->stop();
+	}
+}
+
+
+void AsyncIOEngineTest::testLargeSend()
+{
+	std::vector<AsyncIOEngine::Ptr> all = engines();
+	for (std::vector<AsyncIOEngine::Ptr>::iterator it = all.begin(); it != all.end(); ++it)
+	{
+		AsyncIOEngine::Ptr pEngine = *it;
+		pEngine->start();
+		Connection conn;
+		std::vector<char> data(8*1024*1024);
+		for (std::size_t i = 0; i < data.size(); ++i) data[i] = static_cast<char>(i % 251);
+		
+		Reader reader(conn.client);
+		Thread thread;
+		thread.start(reader);
+		AsyncIOOperation::Ptr pSend = pEngine->send(conn.peer, &data[0], static_cast<int>(data.size()));
+		assert (pSend->tryWait(10000));
+		assert (pSend->result() == static_cast<int>(data.size()));
+		conn.peer.shutdownSend();
+		thread.join();
+		assert (reader.received() == static_cast<int>(data.size()));
+		pEngine->stop();
+	}
+}
+
+
+void AsyncIOEngineTest::testPoll()
+{
+	std::vector<AsyncIOEngine::Ptr> all = engines();
+	for (std::vector<AsyncIOEngine::Ptr>::iterator it = all.begin(); it != all.end(); ++it)
+	{
+		AsyncIOEngine::Ptr pEngine = *it;
+		pEngine->start();
+		Connection conn;
+
+		AsyncIOOperation::Ptr pPoll = pEngine->poll(conn.peer, Timespan(0, 100000));
+		assert (pPoll->tryWait(5000));
+		assert (pPoll->result() == 0);
+		assert (!pPoll->canceled());
+
+		pPoll = pEngine->poll(conn.peer, Timespan(5, 0));
+		conn.client.sendBytes("x", 1);
+		assert (pPoll->tryWait(5000));
+		assert (pPoll->result() == 1);
+		char c;
+		assert (conn.peer.receiveBytes(&c, 1) == 1);
+
+		pPoll = pEngine->poll(conn.peer, Timespan());
+		assert (!pPoll->tryWait(200));
+		conn.client.sendBytes("y", 1);
+		assert (pPoll->tryWait(5000));
+		assert (pPoll->result() == 1);
+
+		assert (pEngine->pending() == 0);
+		pEngine->stop();
+	}
+}
+
+
+void AsyncIOEngineTest::testObserver()
+{
+	std::vector<AsyncIOEngine::Ptr> all = engines();
+	for (std::vector<AsyncIOEngine::Ptr>::iterator it = all.begin(); it != all.end(); ++it)
+	{
+		AsyncIOEngine::Ptr pEngine = *it;
+		pEngine->start();
+		Connection conn;
+		CompletionHandler handler;
+		Observer<CompletionHandler, AsyncIONotification> observer(handler, &CompletionHandler::onCompletion);
+		AsyncIOOperation::Ptr pReceive = pEngine->receive(conn.peer, &observer);
+		conn.client.sendBytes("hello", 5);
+		assert (pReceive->tryWait(5000));
+		assert (handler.count() == 1);
+		assert (handler.result() == 5);
+		assert (handler.data() == "hello");
+		assert (!handler.done());
+		pEngine->stop();
+	}
+}
+
+
+void AsyncIOEngineTest::testObserverReleasesBuffer()
+{
+	std::vector<AsyncIOEngine::Ptr> all = engines();
+	for (std::vector<AsyncIOEngine::Ptr>::iterator it = all.begin(); it != all.end(); ++it)
+	{
+		AsyncIOEngine::Ptr pEngine = *it;
+		pEngine->start();
+		Connection conn;
+		CompletionHandler handler;
+		Observer<CompletionHandler, AsyncIONotification> observer(handler, &CompletionHandler::onCompletion);
+		// more receives than the pool has buffers
+		for (int i = 0; i < 20; ++i)
+		{
+			AsyncIOOperation::Ptr pReceive = pEngine->receive(conn.peer, &observer);
+			conn.client.sendBytes("hello", 5);
+			assert (pReceive->tryWait(5000));
+			assert (handler.data() == "hello");
+		}
+		pEngine->stop();
+		assert (handler.count() == 20);
+		assert (pEngine->availableBuffers() == 8);
+	}
+}
+
+
+void AsyncIOEngineTest::testCancel()
+{
+	std::vector<AsyncIOEngine::Ptr> all = engines();
+	for (std::vector<AsyncIOEngine::Ptr>::iterator it = all.begin(); it != all.end(); ++it)
+	{
+		AsyncIOEngine::Ptr pEngine = *it;
+		pEngine->start();
+		Connection conn;
+		AsyncIOOperation::Ptr pReceive = pEngine->receive(conn.peer);
+		assert (!pReceive->tryWait(100));
+		assert (pEngine->pending() == 1);
+		pEngine->cancel(pReceive);
+		assert (pReceive->tryWait(5000));
+		assert (pReceive->canceled());
+		assert (pReceive->result() == -1);
+		try
+		{
+			pReceive->throwOnError();
+			fail("canceled - must throw");
+		}
+		catch (NetException&)
+		{
+		}
+		assert (pEngine->pending() == 0);
+
+		// the socket is still usable
+		pReceive = pEngine->receive(conn.peer);
+		conn.client.sendBytes("abc", 3);
+		assert (pReceive->tryWait(5000));
+		assert (pReceive->result() == 3);
+		pEngine->stop();
+	}
+}
+
+
+void AsyncIOEngineTest::testClose()
+{
+	std::vector<AsyncIOEngine::Ptr> all = engines();
+	for (std::vector<AsyncIOEngine::Ptr>::iterator it = all.begin(); it != all.end(); ++it)
+	{
+		AsyncIOEngine::Ptr pEngine = *it;
+		pEngine->start();
+		Connection conn;
+		AsyncIOOperation::Ptr pClose = pEngine->close(conn.peer);
+		assert (!conn.peer.impl()->initialized());
+		assert (pClose->tryWait(5000));
+		assert (pClose->error() == 0);
+		char buffer[16];
+		assert (conn.client.receiveBytes(buffer, sizeof(buffer)) == 0);
+		pEngine->stop();
+	}
+}
+
+
+void AsyncIOEngineTest::testStop()
+{
+	std::vector<AsyncIOEngine::Ptr> all = engines();
+	for (std::vector<AsyncIOEngine::Ptr>::iterator it = all.begin(); it != all.end(); ++it)
+	{
+		AsyncIOEngine::Ptr pEngine = *it;
+		pEngine->start();
+		Connection conn;
+		AsyncIOOperation::Ptr pReceive = pEngine->receive(conn.peer);
+		AsyncIOOperation::Ptr pPoll = pEngine->poll(conn.client, Timespan(10, 0));
+		AsyncIOOperation::Ptr pAccept = pEngine->accept(conn.server);
+		assert (pEngine->pending() == 3);
+		pEngine->stop();
+		assert (pEngine->pending() == 0);
+		assert (pReceive->done() && pReceive->canceled());
+		assert (pPoll->done() && pPoll->canceled());
+		assert (pAccept->done() && pAccept->canceled());
+	}
+}
+
+
+void AsyncIOEngineTest::setUp()
+{
+}
+
+
+void AsyncIOEngineTest::tearDown()
+{
+}
+
+
+CppUnit::Test* AsyncIOEngineTest::suite()
+{
+	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("AsyncIOEngineTest");
+
+	CppUnit_addTest(pSuite, AsyncIOEngineTest, testCreate);
+	CppUnit_addTest(pSuite, AsyncIOEngineTest, testAcceptReceiveSend);
+	CppUnit_addTest(pSuite, AsyncIOEngineTest, testLargeSend);
+	CppUnit_addTest(pSuite, AsyncIOEngineTest, testPoll);
+	CppUnit_addTest(pSuite, AsyncIOEngineTest, testObserver);
+	CppUnit_addTest(pSuite, AsyncIOEngineTest, testObserverReleasesBuffer);
+	CppUnit_addTest(pSuite, AsyncIOEngineTest, testCancel);
+	CppUnit_addTest(pSuite, AsyncIOEngineTest, testClose);
+	CppUnit_addTest(pSuite, AsyncIOEngineTest, testStop);
+
+	return pSuite;
+}
@@ -33,6 +33,7 @@
 #include "FTPClientTestSuite.h"
 #include "FTPClientSessionTest.h"
 #include "FTPStreamFactoryTest.h"
+#include "FTPTransferManagerTest.h"
 
 
 CppUnit::Test* FTPClientTestSuite::suite()
@@ -41,6 +42,7 @@ CppUnit::Test* FTPClientTestSuite::suite()
 
 	pSuite->addTest(FTPClientSessionTest::suite());
 	pSuite->addTest(FTPStreamFactoryTest::suite());
+	pSuite->addTest(FTPTransferManagerTest::suite());
 
 	return pSuite;
 }
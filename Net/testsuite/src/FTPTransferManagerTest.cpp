@@ -0,0 +1,454 @@
+//
+// FTPTransferManagerTest.cpp
+//
+// $Id: //poco/1.4/Net/testsuite/src/FTPTransferManagerTest.cpp#1 $
+//
+// Copyright (c) 2013, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+// 
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+
+
+
+#include "FTPTransferManagerTest.h"
+#include "CppUnit/TestCaller.h"
+#include "CppUnit/TestSuite.h"
+#include "Poco/Net/FTPTransferManager.h"
+#include "Poco/Net/TCPServer.h"
+#include "Poco/Net/TCPServerConnection.h"
+#include "Poco/Net/TCPServerConnectionFactory.h"
+#include "Poco/Net/ServerSocket.h"
+#include "Poco/Net/StreamSocket.h"
+#include "Poco/Net/DialogSocket.h"
+#include "Poco/Net/SocketAddress.h"
+#include "Poco/Net/NetException.h"
+#include "Poco/TemporaryFile.h"
+#include "Poco/FileStream.h"
+#include "Poco/StreamCopier.h"
+#include "Poco/NumberParser.h"
+#include "Poco/NumberFormatter.h"
+#include "Poco/Mutex.h"
+#include "Poco/File.h"
+#include <sstream>
+
+
+using Poco::Net::FTPTransferManager;
+using Poco::Net::TCPServer;
+using Poco::Net::TCPServerConnection;
+using Poco::Net::TCPServerConnectionFactory;
+using Poco::Net::ServerSocket;
+using Poco::Net::StreamSocket;
+using Poco::Net::DialogSocket;
+using Poco::Net::SocketAddress;
+using Poco::Net::FTPException;
+using Poco::TemporaryFile;
+using Poco::FileInputStream;
+using Poco::FileOutputStream;
+using Poco::StreamCopier;
+using Poco::NumberParser;
+using Poco::NumberFormatter;
+using Poco::FastMutex;
+using Poco::File;
+
+
+namespace
+{
+	class FileServer: public TCPServerConnectionFactory
+		/// A minimal FTP server that serves a single file
+		/// and supports SIZE, REST and EPSV.
+	{
+	public:
+		FileServer(const std::string& path, const std::string& data):
+			_path(path),
+			_data(data),
+			_dataLimit(0),
+			_logins(0),
+			_restarts(0)
+		{
+		}
+
+		TCPServerConnection* createConnection(const StreamSocket& socket);
+
+		void setDataLimit(std::size_t limit)
+		{
+			FastMutex::ScopedLock lock(_mutex);
+			_dataLimit = limit;
+		}
+
+		std::size_t dataLimit()
+		{
+			FastMutex::ScopedLock lock(_mutex);
+			return _dataLimit;
+		}
+
+		void login()
+		{
+			FastMutex::ScopedLock lock(_mutex);
+			++_logins;
+		}
+
+		int logins()
+		{
+			FastMutex::ScopedLock lock(_mutex);
+			return _logins;
+		}
+
+		void restart()
+		{
+			FastMutex::ScopedLock lock(_mutex);
+			++_restarts;
+		}
+
+		int restarts()
+		{
+			FastMutex::ScopedLock lock(_mutex);
+			return _restarts;
+		}
+
+		void reset()
+		{
+			FastMutex::ScopedLock lock(_mutex);
+			_logins = 0;
+			_restarts = 0;
+		}
+
+		const std::string& path() const
+		{
+			return _path;
+		}
+
+		const std::string& data() const
+		{
+			return _data;
+		}
+
+	private:
+		std::string _path;
+		std::string _data;
+		std::size_t _dataLimit;
+		int         _logins;
+		int         _restarts;
+		FastMutex   _mutex;
+	};
+
+
+	class FileServerConnection: public TCPServerConnection
+	{
+	public:
+		FileServerConnection(const StreamSocket& socket, FileServer& server):
+			TCPServerConnection(socket),
+			_server(server)
+		{
+		}
+
+		void run()
+		{
+			DialogSocket ds(socket());
+			ds.setReceiveTimeout(Poco::Timespan(10, 0));
+			ds.sendMessage("220 ready");
+			ServerSocket dataSocket;
+			std::size_t offset = 0;
+			std::string line;
+			try
+			{
+				while (ds.receiveMessage(line))
+				{
+					std::string::size_type pos = 0;
+					while (pos < line.size() && (line[pos] < 'A' || line[pos] > 'Z')) ++pos;
+					line.erase(0, pos);
+					std::string command = line.substr(0, line.find(' '));
+					std::string arg = line.size() > command.size() ? line.substr(command.size() + 1) : std::string();
+					if (command == "USER")
+					{
+						ds.sendMessage("331 password required");
+					}
+					else if (command == "PASS")
+					{
+						_server.login();
+						ds.sendMessage("230 logged in");
+					}
+					else if (command == "TYPE")
+					{
+						ds.sendMessage("200 type set");
+					}
+					else if (command == "SIZE")
+					{
+						if (arg == _server.path())
+							ds.sendMessage("213", NumberFormatter::format(_server.data().size()));
+						else
+							ds.sendMessage("550 no such file");
+					}
+					else if (command == "REST")
+					{
+						_server.restart();
+						offset = NumberParser::parseUnsigned(arg);
+						ds.sendMessage("350 restarting");
+					}
+					else if (command == "EPSV")
+					{
+						dataSocket = ServerSocket(SocketAddress("127.0.0.1", 0));
+						std::string port = NumberFormatter::format(dataSocket.address().port());
+						ds.sendMessage("229 Entering Extended Passive Mode (|||" + port + "|)");
+					}
+					else if (command == "RETR")
+					{
+						if (arg != _server.path())
+						{
+							ds.sendMessage("550 no such file");
+							continue;
+						}
+						ds.sendMessage("150 sending");
+						bool complete = sendData(dataSocket, offset);
+						ds.sendMessage(complete ? "226 transfer complete" : "426 transfer aborted");
+						offset = 0;
+					}
+					else if (command == "QUIT")
+					{
+						ds.sendMessage("221 bye");
+						break;
+					}
+					else
+					{
+						ds.sendMessage("500 unknown command");
+					}
+				}
+			}
+			catch (Poco::Exception&)
+			{
+			}
+		}
+
+	private:
+		bool sendData(ServerSocket& dataSocket, std::size_t offset)
+		{
+			bool complete = false;
+			try
+			{
+				StreamSocket ss = dataSocket.acceptConnection();
+				const std::string& data = _server.data();
+				std::size_t end = data.size();
+				std::size_t limit = _server.dataLimit();
+				if (limit > 0 && offset + limit < end) end = offset + limit;
+				std::size_t pos = offset;
+				while (pos < end)
+				{
+					int n = static_cast<int>(std::min<std::size_t>(end - pos, 16384));
+					// the client closes the data connection once its segment is complete
+					pos += ss.sendBytes(data.data() + pos, n, MSG_NOSIGNAL);
+				}
+				complete = end == data.size();
+				ss.close();
+			}
+			catch (Poco::Exception&)
+			{
+			}
+			dataSocket.close();
+			return complete;
+		}
+
+		FileServer& _server;
+	};
+
+
+	TCPServerConnection* FileServer::createConnection(const StreamSocket& socket)
+	{
+		return new FileServerConnection(socket, *this);
+	}
+
+
+	std::string makeData(std::size_t size)
+	{
+		std::string data;
+		data.reserve(size);
+		Poco::UInt32 x = 12345;
+		for (std::size_t i = 0; i < size; ++i)
+		{
+			x = x*1103515245 + 12345;
+			data += static_cast<char>(x >> 16);
+		}
+		return data;
+	}
+
+
+	std::string readFile(const std::string& path)
+	{
+		FileInputStream istr(path);
+		std::ostringstream ostr;
+		StreamCopier::copyStream(istr, ostr);
+		return ostr.str();
+	}
+}
+
+
+FTPTransferManagerTest::FTPTransferManagerTest(const std::string& name): CppUnit::TestCase(name)
+{
+}
+
+
+FTPTransferManagerTest::~FTPTransferManagerTest()
+{
+}
+
+
+void FTPTransferManagerTest::testParallelDownload()
+{
+	std::string data = makeData(3*1024*1024 + 1234);
+	FileServer* pServer = new FileServer("/file.bin", data);
+	TCPServer server(pServer, ServerSocket(SocketAddress("127.0.0.1", 0)));
+	server.start();
+
+	TemporaryFile local;
+	FTPTransferManager ftm("127.0.0.1", server.port());
+	ftm.setConnections(4);
+	ftm.setMinimumSegmentSize(256*1024);
+	assert (ftm.getConnections() == 4);
+	assert (ftm.getMinimumSegmentSize() == 256*1024);
+	Poco::UInt64 n = ftm.download("/file.bin", local.path());
+	assert (n == data.size());
+	assert (readFile(local.path()) == data);
+	assert (pServer->logins() == 4);
+	assert (pServer->restarts() == 3);
+	assert (!File(FTPTransferManager::stateFileName(local.path())).exists());
+	server.stop();
+}
+
+
+void FTPTransferManagerTest::testSmallFile()
+{
+	std::string data = makeData(100000);
+	FileServer* pServer = new FileServer("/file.bin", data);
+	TCPServer server(pServer, ServerSocket(SocketAddress("127.0.0.1", 0)));
+	server.start();
+
+	TemporaryFile local;
+	FTPTransferManager ftm("127.0.0.1", server.port());
+	Poco::UInt64 n = ftm.download("/file.bin", local.path());
+	assert (n == data.size());
+	assert (readFile(local.path()) == data);
+	assert (pServer->logins() == 1);
+	assert (pServer->restarts() == 0);
+	server.stop();
+}
+
+
+void FTPTransferManagerTest::testResume()
+{
+	std::string data = makeData(2*1024*1024);
+	FileServer* pServer = new FileServer("/file.bin", data);
+	TCPServer server(pServer, ServerSocket(SocketAddress("127.0.0.1", 0)));
+	server.start();
+
+	TemporaryFile local;
+	TemporaryFile::registerForDeletion(FTPTransferManager::stateFileName(local.path()));
+	FTPTransferManager ftm("127.0.0.1", server.port());
+	ftm.setConnections(4);
+	ftm.setMinimumSegmentSize(256*1024);
+	pServer->setDataLimit(100000);
+	try
+	{
+		ftm.download("/file.bin", local.path());
+		fail("incomplete download - must throw");
+	}
+	catch (FTPException&)
+	{
+	}
+	assert (File(FTPTransferManager::stateFileName(local.path())).exists());
+	assert (File(local.path()).getSize() == data.size());
+
+	pServer->setDataLimit(0);
+	pServer->reset();
+	Poco::UInt64 n = ftm.download("/file.bin", local.path());
+	assert (n == data.size() - 4*100000);
+	assert (readFile(local.path()) == data);
+	assert (!File(FTPTransferManager::stateFileName(local.path())).exists());
+	server.stop();
+}
+
+
+void FTPTransferManagerTest::testResumeExistingFile()
+{
+	std::string data = makeData(1536*1024);
+	FileServer* pServer = new FileServer("/file.bin", data);
+	TCPServer server(pServer, ServerSocket(SocketAddress("127.0.0.1", 0)));
+	server.start();
+
+	TemporaryFile local;
+	{
+		FileOutputStream ostr(local.path());
+		ostr.write(data.data(), 1024*1024);
+	}
+	FTPTransferManager ftm("127.0.0.1", server.port());
+	Poco::UInt64 n = ftm.download("/file.bin", local.path());
+	assert (n == data.size() - 1024*1024);
+	assert (readFile(local.path()) == data);
+	assert (pServer->restarts() == 1);
+	server.stop();
+}
+
+
+void FTPTransferManagerTest::testFileNotFound()
+{
+	FileServer* pServer = new FileServer("/file.bin", makeData(1000));
+	TCPServer server(pServer, ServerSocket(SocketAddress("127.0.0.1", 0)));
+	server.start();
+
+	TemporaryFile local;
+	FTPTransferManager ftm("127.0.0.1", server.port());
+	try
+	{
+		ftm.download("/missing.bin", local.path());
+		fail("file does not exist - must throw");
+	}
+	catch (FTPException&)
+	{
+	}
+	assert (!local.exists());
+	assert (!File(FTPTransferManager::stateFileName(local.path())).exists());
+	server.stop();
+}
+
+
+void FTPTransferManagerTest::setUp()
+{
+}
+
+
+void FTPTransferManagerTest::tearDown()
+{
+}
+
+
+CppUnit::Test* FTPTransferManagerTest::suite()
+{
+	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("FTPTransferManagerTest");
+
+	CppUnit_addTest(pSuite, FTPTransferManagerTest, testParallelDownload);
+	CppUnit_addTest(pSuite, FTPTransferManagerTest, testSmallFile);
+	CppUnit_addTest(pSuite, FTPTransferManagerTest, testResume);
+	CppUnit_addTest(pSuite, FTPTransferManagerTest, testResumeExistingFile);
+	CppUnit_addTest(pSuite, FTPTransferManagerTest, testFileNotFound);
+
+	return pSuite;
+}
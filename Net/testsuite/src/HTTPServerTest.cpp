@@ -43,8 +43,17 @@
 #include "Poco/Net/HTTPResponse.h"
 #include "Poco/Net/HTTPServerResponse.h"
 #include "Poco/Net/ServerSocket.h"
+#include "Poco/Net/HTTPServerMetrics.h"
+#include "Poco/Net/HTTPMetricsRequestHandler.h"
+#include "Poco/Net/AsyncIOEngine.h"
 #include "Poco/StreamCopier.h"
+#include "Poco/Thread.h"
+#include "Poco/Stopwatch.h"
+#include "Poco/Arena.h"
+#include "Poco/ArenaAllocator.h"
+#include "Poco/NumberFormatter.h"
 #include <sstream>
+#include <vector>
 
 
 using Poco::Net::HTTPServer;
@@ -59,7 +68,13 @@ using Poco::Net::HTTPResponse;
 using Poco::Net::HTTPServerResponse;
 using Poco::Net::HTTPMessage;
 using Poco::Net::ServerSocket;
+using Poco::Net::HTTPServerMetrics;
+using Poco::Net::HTTPMetricsRequestHandler;
+using Poco::Net::AsyncIOEngine;
 using Poco::StreamCopier;
+using Poco::Arena;
+using Poco::ArenaAllocator;
+using Poco::NumberFormatter;
 
 
 namespace
@@ -126,6 +141,27 @@ namespace
 		}
 	};
 	
+	class ArenaRequestHandler: public HTTPRequestHandler
+	{
+	public:
+		void handleRequest(HTTPServerRequest& request, HTTPServerResponse& response)
+		{
+			Arena* pArena = request.arena();
+			if (pArena)
+			{
+				// The arena must be empty at the start of each request.
+				std::string allocated = NumberFormatter::format(pArena->allocated());
+				std::vector<char, ArenaAllocator<char> > body(allocated.begin(), allocated.end(), ArenaAllocator<char>(*pArena));
+				body.insert(body.end(), request.getURI().begin(), request.getURI().end());
+				response.sendBuffer(&body[0], body.size());
+			}
+			else
+			{
+				response.sendBuffer("none", 4);
+			}
+		}
+	};
+	
 	class RequestHandlerFactory: public HTTPRequestHandlerFactory
 	{
 	public:
@@ -141,6 +177,8 @@ namespace
 				return new AuthRequestHandler();
 			else if (request.getURI() == "/buffer")
 				return new BufferRequestHandler();
+			else if (request.getURI() == "/arena")
+				return new ArenaRequestHandler();
 			else
 				return 0;
 		}
@@ -547,6 +585,209 @@ void HTTPServerTest::testBuffer()
 }
 
 
+void HTTPServerTest::testMetrics()
+{
+	ServerSocket svs(0);
+	HTTPServerMetrics::Ptr pMetrics = new HTTPServerMetrics;
+	HTTPServerParams* pParams = new HTTPServerParams;
+	pParams->setKeepAlive(true);
+	pParams->setMetrics(pMetrics);
+	HTTPServer srv(new RequestHandlerFactory, svs, pParams);
+	srv.start();
+	
+	HTTPClientSession cs("localhost", svs.address().port());
+	cs.setKeepAlive(true);
+	std::string body(5000, 'x');
+	for (int i = 0; i < 3; ++i)
+	{
+		HTTPRequest request("POST", "/echoBody", HTTPMessage::HTTP_1_1);
+		request.setContentLength((int) body.length());
+		request.setContentType("text/plain");
+		cs.sendRequest(request) << body;
+		HTTPResponse response;
+		std::string rbody;
+		cs.receiveResponse(response) >> rbody;
+		assert (rbody == body);
+	}
+	HTTPRequest request("GET", "/notImpl", HTTPMessage::HTTP_1_1);
+	cs.sendRequest(request);
+	HTTPResponse response;
+	std::string rbody;
+	cs.receiveResponse(response) >> rbody;
+	assert (response.getStatus() == HTTPResponse::HTTP_NOT_IMPLEMENTED);
+	
+	HTTPServerMetrics::Snapshot snapshot;
+	for (int i = 0; i < 100; ++i)
+	{
+		pMetrics->snapshot(snapshot);
+		if (snapshot.requests == 4) break;
+		Poco::Thread::sleep(10);
+	}
+	assert (snapshot.requests == 4);
+	assert (snapshot.inFlight == 0);
+	assert (snapshot.statusCounts[HTTPResponse::HTTP_OK] == 3);
+	assert (snapshot.statusCounts[HTTPResponse::HTTP_NOT_IMPLEMENTED] == 1);
+	assert (snapshot.bytesIn.count() == 4);
+	assert (snapshot.bytesIn.max() > body.size());
+	assert (snapshot.bytesOut.max() > body.size());
+	
+	std::ostringstream ostr;
+	HTTPMetricsRequestHandler::write(snapshot, ostr);
+	std::string text = ostr.str();
+	assert (text.find("http_server_requests_total 4\n") != std::string::npos);
+	assert (text.find("http_server_responses_total{status=\"200\"} 3\n") != std::string::npos);
+	assert (text.find("http_server_responses_total{status=\"501\"} 1\n") != std::string::npos);
+	assert (text.find("http_server_handler_time_us_count 4\n") != std::string::npos);
+	
+	pMetrics->reset();
+	pMetrics->snapshot(snapshot);
+	assert (snapshot.requests == 0);
+	assert (snapshot.statusCounts.empty());
+}
+
+
+void HTTPServerTest::testMetricsHistogram()
+{
+	HTTPServerMetrics::Histogram h;
+	assert (h.count() == 0);
+	assert (h.percentile(50) == 0);
+	
+	for (int i = 0; i < HTTPServerMetrics::Histogram::SUB_BUCKETS; ++i)
+	{
+		assert (HTTPServerMetrics::Histogram::bucketIndex(i) == i);
+	}
+	for (int i = 0; i < HTTPServerMetrics::Histogram::BUCKET_COUNT; ++i)
+	{
+		Poco::UInt64 lower = HTTPServerMetrics::Histogram::lowerBound(i);
+		Poco::UInt64 upper = HTTPServerMetrics::Histogram::upperBound(i);
+		assert (lower <= upper);
+		assert (HTTPServerMetrics::Histogram::bucketIndex(lower) == i);
+		assert (HTTPServerMetrics::Histogram::bucketIndex(upper) == i);
+		if (i > 0) assert (HTTPServerMetrics::Histogram::upperBound(i - 1) + 1 == lower);
+	}
+	
+	for (Poco::UInt64 v = 1; v <= 1000; ++v)
+	{
+		h.record(v);
+	}
+	assert (h.count() == 1000);
+	assert (h.sum() == 500500);
+	assert (h.min() == 1);
+	assert (h.max() == 1000);
+	assert (h.mean() == 500.5);
+	
+	Poco::UInt64 p50 = h.percentile(50);
+	assert (p50 >= 500 && p50 <= 500 + 500/HTTPServerMetrics::Histogram::SUB_BUCKETS);
+	Poco::UInt64 p99 = h.percentile(99);
+	assert (p99 >= 990 && p99 <= 1000);
+	assert (h.percentile(100) == 1000);
+	
+	HTTPServerMetrics::Histogram h2;
+	h2.record(5000);
+	h.merge(h2);
+	assert (h.count() == 1001);
+	assert (h.max() == 5000);
+	assert (h.percentile(100) == 5000);
+	
+	h.reset();
+	assert (h.count() == 0);
+	assert (h.max() == 0);
+}
+
+
+void HTTPServerTest::testIdleConnectionEngine()
+{
+	AsyncIOEngine::Ptr pEngine = AsyncIOEngine::create();
+	pEngine->start();
+	ServerSocket svs(0);
+	HTTPServerParams* pParams = new HTTPServerParams;
+	pParams->setKeepAlive(true);
+	pParams->setKeepAliveTimeout(Poco::Timespan(10, 0));
+	pParams->setMaxThreads(1);
+	pParams->setIOEngine(pEngine);
+	HTTPServer srv(new RequestHandlerFactory, svs, pParams);
+	srv.start();
+
+	// With a single server thread, the second connection could not be
+	// served until the first one times out, unless idle connections 
+	// are handed over to the engine.
+	Poco::Stopwatch sw;
+	sw.start();
+	HTTPClientSession cs1("localhost", svs.address().port());
+	HTTPClientSession cs2("localhost", svs.address().port());
+	cs1.setKeepAlive(true);
+	cs2.setKeepAlive(true);
+	for (int i = 0; i < 3; ++i)
+	{
+		HTTPClientSession* sessions[] = {&cs1, &cs2};
+		for (int k = 0; k < 2; ++k)
+		{
+			std::string body(1000 + i*100 + k, 'x');
+			HTTPRequest request("POST", "/echoBody", HTTPMessage::HTTP_1_1);
+			request.setContentLength((int) body.length());
+			request.setContentType("text/plain");
+			sessions[k]->sendRequest(request) << body;
+			HTTPResponse response;
+			std::string rbody;
+			sessions[k]->receiveResponse(response) >> rbody;
+			assert (response.getKeepAlive());
+			assert (rbody == body);
+		}
+	}
+	sw.stop();
+	assert (sw.elapsedSeconds() < 5);
+	assert (srv.totalConnections() >= 6);
+
+	srv.stopAll();
+	pEngine->stop();
+	assert (pEngine->pending() == 0);
+}
+
+
+void HTTPServerTest::testArena()
+{
+	ServerSocket svs(0);
+	HTTPServerParams* pParams = new HTTPServerParams;
+	pParams->setKeepAlive(true);
+	HTTPServer srv(new RequestHandlerFactory, svs, pParams);
+	srv.start();
+	
+	HTTPClientSession cs("localhost", svs.address().port());
+	cs.setKeepAlive(true);
+	for (int i = 0; i < 3; ++i)
+	{
+		HTTPRequest request("GET", "/arena", HTTPMessage::HTTP_1_1);
+		cs.sendRequest(request);
+		HTTPResponse response;
+		std::string rbody;
+		cs.receiveResponse(response) >> rbody;
+		assert (response.getStatus() == HTTPResponse::HTTP_OK);
+		assert (rbody == "0/arena");
+	}
+	assert (srv.totalConnections() == 1);
+}
+
+
+void HTTPServerTest::testNoArena()
+{
+	ServerSocket svs(0);
+	HTTPServerParams* pParams = new HTTPServerParams;
+	pParams->setKeepAlive(false);
+	pParams->setArenaBlockSize(0);
+	HTTPServer srv(new RequestHandlerFactory, svs, pParams);
+	srv.start();
+	
+	HTTPClientSession cs("localhost", svs.address().port());
+	HTTPRequest request("GET", "/arena");
+	cs.sendRequest(request);
+	HTTPResponse response;
+	std::string rbody;
+	cs.receiveResponse(response) >> rbody;
+	assert (response.getStatus() == HTTPResponse::HTTP_OK);
+	assert (rbody == "none");
+}
+
+
 void HTTPServerTest::setUp()
 {
 }
@@ -575,6 +816,11 @@ CppUnit::Test* HTTPServerTest::suite()
 	CppUnit_addTest(pSuite, HTTPServerTest, testAuth);
 	CppUnit_addTest(pSuite, HTTPServerTest, testNotImpl);
 	CppUnit_addTest(pSuite, HTTPServerTest, testBuffer);
+	CppUnit_addTest(pSuite, HTTPServerTest, testMetrics);
+	CppUnit_addTest(pSuite, HTTPServerTest, testMetricsHistogram);
+	CppUnit_addTest(pSuite, HTTPServerTest, testIdleConnectionEngine);
+	CppUnit_addTest(pSuite, HTTPServerTest, testArena);
+	CppUnit_addTest(pSuite, HTTPServerTest, testNoArena);
 
 	return pSuite;
 }
@@ -60,6 +60,11 @@ public:
 	void testAuth();
 	void testNotImpl();
 	void testBuffer();
+	void testMetrics();
+	void testMetricsHistogram();
+	void testIdleConnectionEngine();
+	void testArena();
+	void testNoArena();
 
 	void setUp();
 	void tearDown();
@@ -32,6 +32,7 @@
 
 #include "ICMPClientTestSuite.h"
 #include "ICMPClientTest.h"
+#include "ICMPPingerTest.h"
 
 
 CppUnit::Test* ICMPClientTestSuite::suite()
@@ -39,6 +40,7 @@ CppUnit::Test* ICMPClientTestSuite::suite()
 	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("ICMPClientTestSuite");
 
 	pSuite->addTest(ICMPClientTest::suite());
+	pSuite->addTest(ICMPPingerTest::suite());
 
 	return pSuite;
 }
@@ -0,0 +1,234 @@
+//
+// ICMPPingerTest.cpp
+//
+// $Id: //poco/1.4/Net/testsuite/src/ICMPPingerTest.cpp#1 $
+//
+// Copyright (c) 2013, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+// 
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+
+
+
+#include "ICMPPingerTest.h"
+#include "CppUnit/TestCaller.h"
+#include "CppUnit/TestSuite.h"
+#include "Poco/Net/ICMPPinger.h"
+#include "Poco/Net/ICMPEventArgs.h"
+#include "Poco/Net/SocketAddress.h"
+#include "Poco/Delegate.h"
+#include "Poco/Stopwatch.h"
+#include "Poco/NumberFormatter.h"
+
+
+using Poco::Net::ICMPPinger;
+using Poco::Net::ICMPEventArgs;
+using Poco::Net::SocketAddress;
+using Poco::Net::IPAddress;
+using Poco::Delegate;
+using Poco::Stopwatch;
+using Poco::Timespan;
+using Poco::NumberFormatter;
+
+
+namespace
+{
+	std::vector<SocketAddress> loopbackAddresses(int count)
+	{
+		// all of 127.0.0.0/8 is routed to the loopback interface
+		std::vector<SocketAddress> result;
+		for (int i = 0; i < count; ++i)
+		{
+			std::string host("127.0.");
+			host += NumberFormatter::format(i / 250);
+			host += '.';
+			host += NumberFormatter::format(i % 250 + 1);
+			result.push_back(SocketAddress(host, 0));
+		}
+		return result;
+	}
+}
+
+
+ICMPPingerTest::ICMPPingerTest(const std::string& name): 
+	CppUnit::TestCase(name),
+	_pinger(IPAddress::IPv4),
+	_begin(0),
+	_replies(0),
+	_errors(0),
+	_end(0),
+	_endReceived(0)
+{
+}
+
+
+ICMPPingerTest::~ICMPPingerTest()
+{
+}
+
+
+void ICMPPingerTest::testPing()
+{
+	int n = _pinger.ping(SocketAddress("127.0.0.1", 0), 3);
+	assert (n == 3);
+	assert (_begin == 1);
+	assert (_replies == 3);
+	assert (_errors == 0);
+	assert (_end == 1);
+	assert (_endReceived == 3);
+}
+
+
+void ICMPPingerTest::testPingMany()
+{
+	std::vector<SocketAddress> addresses = loopbackAddresses(1000);
+	Stopwatch sw;
+	sw.start();
+	int n = _pinger.ping(addresses, 2);
+	sw.stop();
+	assert (n == 2000);
+	assert (_begin == 1000);
+	assert (_replies == 2000);
+	assert (_end == 1000);
+	assert (_endReceived == 2000);
+	// sequential pings would need 2000 round trips
+	assert (sw.elapsed() < 5000000);
+}
+
+
+void ICMPPingerTest::testTimeout()
+{
+	// warning: whether the documentation addresses (RFC 5737) reply, time out
+	// or cannot be reached at all depends on the network at the test site,
+	// so only the bookkeeping is checked for them
+	std::vector<SocketAddress> addresses;
+	addresses.push_back(SocketAddress("192.0.2.254", 0));
+	addresses.push_back(SocketAddress("127.0.0.1", 0));
+	addresses.push_back(SocketAddress("198.51.100.254", 0));
+	_pinger.setTimeout(Timespan(0, 300000));
+	Stopwatch sw;
+	sw.start();
+	int n = _pinger.ping(addresses, 2);
+	sw.stop();
+	assert (n == _replies);
+	assert (_replies >= 2);
+	assert (_replies + _errors == 6);
+	assert (_errors == 0 || !_lastError.empty());
+	assert (_end == 3);
+	assert (_endReceived == n);
+	// the timeouts of different hosts overlap
+	assert (sw.elapsed() < 1000000);
+}
+
+
+void ICMPPingerTest::testMaxInFlight()
+{
+	try
+	{
+		_pinger.setMaxInFlight(0);
+		fail("invalid value - must throw");
+	}
+	catch (Poco::InvalidArgumentException&)
+	{
+	}
+	_pinger.setMaxInFlight(16);
+	assert (_pinger.getMaxInFlight() == 16);
+	_pinger.setInterval(Timespan(0, 10000));
+	int n = _pinger.ping(loopbackAddresses(100), 3);
+	assert (n == 300);
+	assert (_end == 100);
+}
+
+
+void ICMPPingerTest::testIdentifier()
+{
+	ICMPPinger pinger1(IPAddress::IPv4);
+	ICMPPinger pinger2(IPAddress::IPv4);
+	assert (pinger1.identifier() != _pinger.identifier());
+	assert (pinger2.identifier() != pinger1.identifier());
+	assert (pinger2.identifier() != _pinger.identifier());
+}
+
+
+void ICMPPingerTest::setUp()
+{
+	_begin = _replies = _errors = _end = _endReceived = 0;
+	_lastError.clear();
+	_pinger.pingBegin += Delegate<ICMPPingerTest, ICMPEventArgs>(this, &ICMPPingerTest::onBegin);
+	_pinger.pingReply += Delegate<ICMPPingerTest, ICMPEventArgs>(this, &ICMPPingerTest::onReply);
+	_pinger.pingError += Delegate<ICMPPingerTest, ICMPEventArgs>(this, &ICMPPingerTest::onError);
+	_pinger.pingEnd   += Delegate<ICMPPingerTest, ICMPEventArgs>(this, &ICMPPingerTest::onEnd);
+}
+
+
+void ICMPPingerTest::tearDown()
+{
+	_pinger.pingBegin -= Delegate<ICMPPingerTest, ICMPEventArgs>(this, &ICMPPingerTest::onBegin);
+	_pinger.pingReply -= Delegate<ICMPPingerTest, ICMPEventArgs>(this, &ICMPPingerTest::onReply);
+	_pinger.pingError -= Delegate<ICMPPingerTest, ICMPEventArgs>(this, &ICMPPingerTest::onError);
+	_pinger.pingEnd   -= Delegate<ICMPPingerTest, ICMPEventArgs>(this, &ICMPPingerTest::onEnd);
+}
+
+
+void ICMPPingerTest::onBegin(const void* pSender, ICMPEventArgs& args)
+{
+	++_begin;
+}
+
+
+void ICMPPingerTest::onReply(const void* pSender, ICMPEventArgs& args)
+{
+	assert (args.replyTime() > 0);
+	++_replies;
+}
+
+
+void ICMPPingerTest::onError(const void* pSender, ICMPEventArgs& args)
+{
+	_lastError = args.error();
+	++_errors;
+}
+
+
+void ICMPPingerTest::onEnd(const void* pSender, ICMPEventArgs& args)
+{
+	assert (args.sent() == args.repetitions());
+	++_end;
+	_endReceived += args.received();
+}
+
+
+CppUnit::Test* ICMPPingerTest::suite()
+{
+	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("ICMPPingerTest");
+
+	CppUnit_addTest(pSuite, ICMPPingerTest, testPing);
+	CppUnit_addTest(pSuite, ICMPPingerTest, testPingMany);
+	CppUnit_addTest(pSuite, ICMPPingerTest, testTimeout);
+	CppUnit_addTest(pSuite, ICMPPingerTest, testMaxInFlight);
+	CppUnit_addTest(pSuite, ICMPPingerTest, testIdentifier);
+
+	return pSuite;
+}
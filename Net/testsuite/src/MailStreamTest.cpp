@@ -120,6 +120,30 @@ void MailStreamTest::testMailOutputStream()
 }
 
 
+void MailStreamTest::testMailOutputStreamBlocks()
+{
+	std::ostringstream ostr;
+	MailOutputStream mos(ostr);
+	mos.write(".first\r", 7);
+	mos.write("\n", 1);
+	mos.write(".", 1);
+	mos.write("second\r\n", 8);
+	mos.put('.');
+	mos.write(".third\r\nfourth.\r\n.", 18);
+	mos.write("\r\n", 2);
+	mos.close();
+	std::string s(ostr.str());
+	assert (s == 
+		"..first\r\n"
+		"..second\r\n"
+		"...third\r\n"
+		"fourth.\r\n"
+		"..\r\n"
+		".\r\n"
+	);
+}
+
+
 void MailStreamTest::setUp()
 {
 }
@@ -136,6 +160,7 @@ CppUnit::Test* MailStreamTest::suite()
 
 	CppUnit_addTest(pSuite, MailStreamTest, testMailInputStream);
 	CppUnit_addTest(pSuite, MailStreamTest, testMailOutputStream);
+	CppUnit_addTest(pSuite, MailStreamTest, testMailOutputStreamBlocks);
 
 	return pSuite;
 }
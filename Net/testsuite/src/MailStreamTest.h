@@ -48,6 +48,7 @@ public:
 
 	void testMailInputStream();
 	void testMailOutputStream();
+	void testMailOutputStreamBlocks();
 
 	void setUp();
 	void tearDown();
@@ -34,12 +34,17 @@
 #include "CppUnit/TestCaller.h"
 #include "CppUnit/TestSuite.h"
 #include "Poco/Net/NetworkInterface.h"
+#include "Poco/Net/NetworkInterfaceCache.h"
+#include "Poco/Net/NetException.h"
+#include "Poco/Delegate.h"
 #include "Poco/Net/IPAddress.h"
 #include <iostream>
 #include <iomanip>
 
 
 using Poco::Net::NetworkInterface;
+using Poco::Net::NetworkInterfaceCache;
+using Poco::Net::InterfaceNotFoundException;
 using Poco::Net::IPAddress;
 using Poco::NotFoundException;
 
@@ -207,6 +212,103 @@ void NetworkInterfaceTest::testMapUpOnly()
 }
 
 
+void NetworkInterfaceTest::testCache()
+{
+	NetworkInterfaceCache cache;
+	NetworkInterface::Map map = NetworkInterface::map(false, false);
+	assert (cache.map().size() == map.size());
+	for (NetworkInterface::Map::const_iterator it = map.begin(); it != map.end(); ++it)
+	{
+		NetworkInterface ifc = cache.forIndex(it->first);
+		assert (ifc.index() == it->second.index());
+		assert (ifc.name() == it->second.name());
+		
+		ifc = cache.forName(it->second.name());
+		assert (ifc.index() == it->second.index());
+
+		const NetworkInterface::AddressList& addresses = it->second.addressList();
+		for (NetworkInterface::AddressList::const_iterator itAddr = addresses.begin(); itAddr != addresses.end(); ++itAddr)
+		{
+			NetworkInterface ifcAddr;
+			assert (cache.find(itAddr->get<NetworkInterface::IP_ADDRESS>(), ifcAddr));
+			assert (ifcAddr.index() == it->second.index());
+		}
+	}
+
+	NetworkInterface ifc;
+	assert (!cache.find(NetworkInterface::NO_INDEX, ifc));
+	assert (!cache.find(IPAddress("192.0.2.123"), ifc));
+	try
+	{
+		cache.forName("no-such-interface");
+		fail("interface does not exist - must throw");
+	}
+	catch (InterfaceNotFoundException&)
+	{
+	}
+}
+
+
+namespace
+{
+	class ChangeCounter
+	{
+	public:
+		ChangeCounter(): changes(0)
+		{
+		}
+
+		void onChange(const void* pSender, const NetworkInterface& interfc)
+		{
+			++changes;
+		}
+
+		int changes;
+	};
+}
+
+
+void NetworkInterfaceTest::testCacheRefresh()
+{
+	NetworkInterfaceCache cache;
+	ChangeCounter counter;
+	cache.interfaceAdded += Poco::delegate(&counter, &ChangeCounter::onChange);
+	cache.interfaceRemoved += Poco::delegate(&counter, &ChangeCounter::onChange);
+	cache.interfaceChanged += Poco::delegate(&counter, &ChangeCounter::onChange);
+	
+	// nothing changes while the test runs, so
+	// a refresh must not report any changes
+	cache.refresh();
+	assert (counter.changes == 0);
+	
+	cache.setRefreshInterval(Poco::Timespan(0, 100000));
+	cache.start();
+	assert (cache.isRunning());
+	Poco::Thread::sleep(500);
+#if POCO_OS == POCO_OS_LINUX
+	assert (cache.usesNetlink());
+#endif
+	cache.stop();
+	assert (!cache.isRunning());
+	assert (counter.changes == 0);
+	assert (!cache.map().empty());
+
+	// a stopped cache can be restarted
+	cache.start();
+	assert (cache.isRunning());
+	cache.stop();
+	assert (!cache.isRunning());
+
+	cache.interfaceAdded -= Poco::delegate(&counter, &ChangeCounter::onChange);
+	cache.interfaceRemoved -= Poco::delegate(&counter, &ChangeCounter::onChange);
+	cache.interfaceChanged -= Poco::delegate(&counter, &ChangeCounter::onChange);
+
+	NetworkInterfaceCache& defaultCache = NetworkInterfaceCache::defaultCache();
+	assert (defaultCache.isRunning());
+	assert (&defaultCache == &NetworkInterfaceCache::defaultCache());
+}
+
+
 void NetworkInterfaceTest::setUp()
 {
 }
@@ -228,6 +330,8 @@ CppUnit::Test* NetworkInterfaceTest::suite()
 	CppUnit_addTest(pSuite, NetworkInterfaceTest, testForIndex);
 	CppUnit_addTest(pSuite, NetworkInterfaceTest, testMapIpOnly);
 	CppUnit_addTest(pSuite, NetworkInterfaceTest, testMapUpOnly);
+	CppUnit_addTest(pSuite, NetworkInterfaceTest, testCache);
+	CppUnit_addTest(pSuite, NetworkInterfaceTest, testCacheRefresh);
 
 	return pSuite;
 }
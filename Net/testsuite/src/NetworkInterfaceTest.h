@@ -53,6 +53,8 @@ public:
 	void testForIndex();
 	void testMapIpOnly();
 	void testMapUpOnly();
+	void testCache();
+	void testCacheRefresh();
 
 	void setUp();
 	void tearDown();
@@ -101,6 +101,45 @@ void QuotedPrintableTest::testDecode()
 }
 
 
+void QuotedPrintableTest::testEncodeBlocks()
+{
+	std::string data;
+	for (int i = 0; i < 20000; ++i)
+	{
+		switch (i % 13)
+		{
+		case 0:  data += "\r\n"; break;
+		case 5:  data += ' '; break;
+		case 7:  data += '='; break;
+		case 11: data += (char) (128 + i % 128); break;
+		default: data += (char) ('a' + i % 26);
+		}
+	}
+	std::ostringstream ostr1;
+	QuotedPrintableEncoder encoder1(ostr1);
+	for (std::string::const_iterator it = data.begin(); it != data.end(); ++it)
+	{
+		encoder1.put(*it);
+	}
+	encoder1.close();
+
+	std::ostringstream ostr2;
+	QuotedPrintableEncoder encoder2(ostr2);
+	std::string::size_type pos = 0;
+	std::string::size_type n = 1;
+	while (pos < data.size())
+	{
+		if (n > data.size() - pos) n = data.size() - pos;
+		encoder2.write(data.data() + pos, n);
+		pos += n;
+		n = (n*3 + 1) % 5003;
+	}
+	encoder2.close();
+	assert (ostr1.str() == ostr2.str());
+	assert (ostr2.str().find("=3D") != std::string::npos);
+}
+
+
 void QuotedPrintableTest::setUp()
 {
 }
@@ -117,6 +156,7 @@ CppUnit::Test* QuotedPrintableTest::suite()
 
 	CppUnit_addTest(pSuite, QuotedPrintableTest, testEncode);
 	CppUnit_addTest(pSuite, QuotedPrintableTest, testDecode);
+	CppUnit_addTest(pSuite, QuotedPrintableTest, testEncodeBlocks);
 
 	return pSuite;
 }
@@ -48,6 +48,7 @@ public:
 
 	void testEncode();
 	void testDecode();
+	void testEncodeBlocks();
 	
 	void setUp();
 	void tearDown();
@@ -32,6 +32,7 @@
 
 #include "ReactorTestSuite.h"
 #include "SocketReactorTest.h"
+#include "AsyncIOEngineTest.h"
 
 
 CppUnit::Test* ReactorTestSuite::suite()
@@ -39,6 +40,7 @@ CppUnit::Test* ReactorTestSuite::suite()
 	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("ReactorTestSuite");
 
 	pSuite->addTest(SocketReactorTest::suite());
+	pSuite->addTest(AsyncIOEngineTest::suite());
 
 	return pSuite;
 }
@@ -35,12 +35,20 @@
 #include "CppUnit/TestSuite.h"
 #include "DialogServer.h"
 #include "Poco/Net/SMTPClientSession.h"
+#include "Poco/Net/SMTPSessionFactory.h"
+#include "Poco/Net/SMTPChannel.h"
 #include "Poco/Net/MailMessage.h"
 #include "Poco/Net/MailRecipient.h"
 #include "Poco/Net/NetException.h"
+#include "Poco/Message.h"
+#include "Poco/AutoPtr.h"
+#include "Poco/NumberFormatter.h"
 
 
 using Poco::Net::SMTPClientSession;
+using Poco::Net::SMTPSessionFactory;
+using Poco::Net::SMTPSessionPool;
+using Poco::Net::SMTPChannel;
 using Poco::Net::MailMessage;
 using Poco::Net::MailRecipient;
 using Poco::Net::SMTPException;
@@ -327,6 +335,236 @@ void SMTPClientSessionTest::testSendFailed()
 }
 
 
+void SMTPClientSessionTest::testExtensions()
+{
+	DialogServer server;
+	server.addResponse("220 localhost SMTP ready");
+	server.addResponse("250-localhost Hello\r\n250-PIPELINING\r\n250-SIZE 10240000\r\n250 8BITMIME");
+	server.addResponse("221 Bye");
+	SMTPClientSession session("localhost", server.port());
+	assert (!session.isOpen());
+	session.login("localhost");
+	assert (session.isOpen());
+	assert (session.hasExtension("PIPELINING"));
+	assert (session.hasExtension("size"));
+	assert (session.hasExtension("8BITMIME"));
+	assert (!session.hasExtension("localhost"));
+	assert (!session.hasExtension("STARTTLS"));
+	session.close();
+	assert (!session.isOpen());
+}
+
+
+void SMTPClientSessionTest::testSendPipelined()
+{
+	DialogServer server;
+	server.addResponse("220 localhost SMTP ready");
+	server.addResponse("250-localhost Hello\r\n250 PIPELINING");
+	server.addResponse("250 OK");
+	server.addResponse("250 OK");
+	server.addResponse("250 OK");
+	server.addResponse("354 Send data");
+	server.addResponse("250 OK");
+	server.addResponse("221 Bye");
+	SMTPClientSession session("localhost", server.port());
+	session.login("localhost");
+	assert (session.getPipelining());
+	assert (session.hasExtension("PIPELINING"));
+
+	MailMessage message;
+	message.setSender("john.doe@no.where");
+	message.addRecipient(MailRecipient(MailRecipient::PRIMARY_RECIPIENT, "jane.doe@no.where", "Jane Doe"));
+	message.addRecipient(MailRecipient(MailRecipient::CC_RECIPIENT, "jack.doe@no.where", "Jack Doe"));
+	message.setSubject("Test Message");
+	message.setContent("Hello\r\nblah blah\r\n\r\nJohn\r\n");
+	server.clearCommands();
+	session.sendMessage(message);
+	assert (!session.inTransaction());
+	std::string cmd = server.popCommandWait();
+	assert (cmd == "MAIL FROM: <john.doe@no.where>");
+	cmd = server.popCommandWait();
+	assert (cmd == "RCPT TO: <jane.doe@no.where>");
+	cmd = server.popCommandWait();
+	assert (cmd == "RCPT TO: <jack.doe@no.where>");
+	cmd = server.popCommandWait();
+	assert (cmd == "DATA");
+	cmd = server.popCommandWait();
+	assert (cmd == "CC: Jack Doe <jack.doe@no.where>");
+
+	session.close();
+}
+
+
+void SMTPClientSessionTest::testRejectedRecipientReset()
+{
+	DialogServer server;
+	server.addResponse("220 localhost SMTP ready");
+	server.addResponse("250-localhost Hello\r\n250 PIPELINING");
+	server.addResponse("250 OK");
+	server.addResponse("550 No such user");
+	server.addResponse("554 No valid recipients");
+	server.addResponse("250 Reset");
+	server.addResponse("250 OK");
+	server.addResponse("250 OK");
+	server.addResponse("354 Send data");
+	server.addResponse("250 OK");
+	server.addResponse("221 Bye");
+	SMTPClientSession session("localhost", server.port());
+	session.login("localhost");
+
+	MailMessage message;
+	message.setSender("john.doe@no.where");
+	message.addRecipient(MailRecipient(MailRecipient::PRIMARY_RECIPIENT, "nobody@no.where"));
+	message.setSubject("Test Message");
+	message.setContent("Hello\r\n");
+	server.clearCommands();
+	try
+	{
+		session.sendMessage(message);
+		fail("recipient rejected - must throw");
+	}
+	catch (SMTPException& exc)
+	{
+		assert (exc.message().find("<nobody@no.where>") != std::string::npos);
+	}
+	assert (session.isOpen());
+	assert (session.inTransaction());
+	std::string cmd = server.popCommandWait();
+	assert (cmd == "MAIL FROM: <john.doe@no.where>");
+	cmd = server.popCommandWait();
+	assert (cmd == "RCPT TO: <nobody@no.where>");
+	cmd = server.popCommandWait();
+	assert (cmd == "DATA");
+
+	MailMessage message2;
+	message2.setSender("john.doe@no.where");
+	message2.addRecipient(MailRecipient(MailRecipient::PRIMARY_RECIPIENT, "jane.doe@no.where"));
+	message2.setSubject("Test Message");
+	message2.setContent("Hello\r\n");
+	session.sendMessage(message2);
+	assert (!session.inTransaction());
+	cmd = server.popCommandWait();
+	assert (cmd == "RSET");
+	cmd = server.popCommandWait();
+	assert (cmd == "MAIL FROM: <john.doe@no.where>");
+	cmd = server.popCommandWait();
+	assert (cmd == "RCPT TO: <jane.doe@no.where>");
+	cmd = server.popCommandWait();
+	assert (cmd == "DATA");
+
+	session.close();
+}
+
+
+void SMTPClientSessionTest::testSessionPool()
+{
+	DialogServer server;
+	server.addResponse("220 localhost SMTP ready");
+	server.addResponse("250 Hello localhost");
+	server.addResponse("250 OK");
+	server.addResponse("550 No such user");
+	server.addResponse("250 Reset");
+	server.addResponse("250 OK");
+	server.addResponse("250 OK");
+	server.addResponse("354 Send data");
+	server.addResponse("250 OK");
+	server.addResponse("221 Bye");
+
+	SMTPSessionFactory factory("localhost", server.port());
+	factory.setHostName("localhost");
+	SMTPSessionPool pool(factory, 1, 1);
+
+	MailMessage message;
+	message.setSender("john.doe@no.where");
+	message.addRecipient(MailRecipient(MailRecipient::PRIMARY_RECIPIENT, "nobody@no.where"));
+	message.setSubject("Test Message");
+	message.setContent("Hello\r\n");
+
+	SMTPClientSession* pSession = pool.borrowObject();
+	assert (pSession != 0);
+	assert (pool.borrowObject() == 0);
+	try
+	{
+		pSession->sendMessage(message);
+		fail("recipient rejected - must throw");
+	}
+	catch (SMTPException&)
+	{
+	}
+	pool.returnObject(pSession);
+	assert (pool.available() == 1);
+	assert (pool.size() == 1);
+
+	SMTPClientSession* pSession2 = pool.borrowObject();
+	assert (pSession2 == pSession);
+	assert (!pSession2->inTransaction());
+	message.setRecipients(MailMessage::Recipients());
+	message.addRecipient(MailRecipient(MailRecipient::PRIMARY_RECIPIENT, "jane.doe@no.where"));
+	pSession2->sendMessage(message);
+	pool.returnObject(pSession2);
+
+	std::string cmd = server.popCommandWait();
+	assert (cmd == "EHLO localhost");
+	cmd = server.popCommandWait();
+	assert (cmd == "MAIL FROM: <john.doe@no.where>");
+	cmd = server.popCommandWait();
+	assert (cmd == "RCPT TO: <nobody@no.where>");
+	cmd = server.popCommandWait();
+	assert (cmd == "RSET");
+	cmd = server.popCommandWait();
+	assert (cmd == "MAIL FROM: <john.doe@no.where>");
+	cmd = server.popCommandWait();
+	assert (cmd == "RCPT TO: <jane.doe@no.where>");
+	cmd = server.popCommandWait();
+	assert (cmd == "DATA");
+}
+
+
+void SMTPClientSessionTest::testChannelBatch()
+{
+	DialogServer server;
+	server.addResponse("220 localhost SMTP ready");
+	server.addResponse("250-localhost Hello\r\n250 PIPELINING");
+	for (int i = 0; i < 3; ++i)
+	{
+		server.addResponse("250 OK");
+		server.addResponse("250 OK");
+		server.addResponse("354 Send data");
+		server.addResponse("250 OK");
+	}
+	server.addResponse("221 Bye");
+
+	Poco::AutoPtr<SMTPChannel> pChannel = new SMTPChannel;
+	pChannel->setProperty("mailhost", "localhost:" + Poco::NumberFormatter::format(server.port()));
+	pChannel->setProperty("sender", "logger@no.where");
+	pChannel->setProperty("recipient", "admin@no.where");
+	pChannel->setProperty("batchSize", "3");
+	pChannel->setProperty("flushInterval", "0");
+	pChannel->setProperty("throw", "true");
+	assert (pChannel->getProperty("batchSize") == "3");
+	assert (pChannel->getProperty("flushInterval") == "0");
+	pChannel->open();
+	for (int i = 0; i < 3; ++i)
+	{
+		Poco::Message msg("source", "message " + Poco::NumberFormatter::format(i), Poco::Message::PRIO_ERROR);
+		pChannel->log(msg);
+	}
+
+	int ehlo = 0;
+	int mail = 0;
+	std::string cmd;
+	while (cmd != "QUIT")
+	{
+		cmd = server.popCommandWait();
+		if (cmd.compare(0, 4, "EHLO") == 0) ++ehlo;
+		else if (cmd.compare(0, 10, "MAIL FROM:") == 0) ++mail;
+	}
+	assert (ehlo == 1);
+	assert (mail == 3);
+	pChannel->close();
+}
+
+
 void SMTPClientSessionTest::setUp()
 {
 }
@@ -348,6 +586,11 @@ CppUnit::Test* SMTPClientSessionTest::suite()
 	CppUnit_addTest(pSuite, SMTPClientSessionTest, testSendMultiRecipient);
 	CppUnit_addTest(pSuite, SMTPClientSessionTest, testMultiSeparateRecipient);
 	CppUnit_addTest(pSuite, SMTPClientSessionTest, testSendFailed);
+	CppUnit_addTest(pSuite, SMTPClientSessionTest, testExtensions);
+	CppUnit_addTest(pSuite, SMTPClientSessionTest, testSendPipelined);
+	CppUnit_addTest(pSuite, SMTPClientSessionTest, testRejectedRecipientReset);
+	CppUnit_addTest(pSuite, SMTPClientSessionTest, testSessionPool);
+	CppUnit_addTest(pSuite, SMTPClientSessionTest, testChannelBatch);
 
 	return pSuite;
 }
@@ -53,6 +53,11 @@ public:
 	void testSendMultiRecipient();
 	void testMultiSeparateRecipient();
 	void testSendFailed();
+	void testExtensions();
+	void testSendPipelined();
+	void testRejectedRecipientReset();
+	void testSessionPool();
+	void testChannelBatch();
 	
 	void setUp();
 	void tearDown();
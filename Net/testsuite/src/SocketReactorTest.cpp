@@ -40,8 +40,11 @@
 #include "Poco/Net/StreamSocket.h"
 #include "Poco/Net/ServerSocket.h"
 #include "Poco/Net/SocketAddress.h"
+#include "Poco/Net/TimerWheel.h"
+#include "Poco/Net/AsyncConnect.h"
 #include "Poco/Observer.h"
 #include "Poco/Exception.h"
+#include "Poco/Stopwatch.h"
 #include <sstream>
 
 
@@ -56,8 +59,14 @@ using Poco::Net::ReadableNotification;
 using Poco::Net::WritableNotification;
 using Poco::Net::TimeoutNotification;
 using Poco::Net::ShutdownNotification;
+using Poco::Net::TimerNotification;
+using Poco::Net::TimerWheel;
+using Poco::Net::AsyncConnect;
+using Poco::Net::ConnectNotification;
 using Poco::Observer;
 using Poco::IllegalStateException;
+using Poco::Timestamp;
+using Poco::Timespan;
 
 
 namespace
@@ -267,6 +276,15 @@ namespace
 			reactor.addEventHandler(socket(), Observer<FailConnector, TimeoutNotification>(*this, &FailConnector::onTimeout));
 			reactor.addEventHandler(socket(), Observer<FailConnector, ShutdownNotification>(*this, &FailConnector::onShutdown));
 		}
+
+		FailConnector(SocketAddress& address, SocketReactor& reactor, const Timespan& timeout):
+			SocketConnector<ClientServiceHandler>(address, reactor, timeout),
+			_failed(false),
+			_shutdown(false)
+		{
+			reactor.addEventHandler(socket(), Observer<FailConnector, TimeoutNotification>(*this, &FailConnector::onTimeout));
+			reactor.addEventHandler(socket(), Observer<FailConnector, ShutdownNotification>(*this, &FailConnector::onShutdown));
+		}
 		
 		void onShutdown(ShutdownNotification* pNf)
 		{
@@ -301,6 +319,111 @@ namespace
 		bool _failed;
 		bool _shutdown;
 	};
+	
+	class ConnectHandler
+	{
+	public:
+		ConnectHandler(SocketReactor& reactor, int expected = 1):
+			_reactor(reactor),
+			_expected(expected),
+			_connected(0),
+			_failed(0),
+			_result(ConnectNotification::CONNECT_CANCELLED),
+			_error(0)
+		{
+		}
+		
+		void onConnect(ConnectNotification* pNf)
+		{
+			pNf->release();
+			_result  = pNf->result();
+			_address = pNf->address();
+			_error   = pNf->error();
+			if (pNf->connected())
+			{
+				StreamSocket socket(pNf->socket());
+				poco_assert (socket.peerAddress() == pNf->address());
+				++_connected;
+			}
+			else ++_failed;
+			if (_connected + _failed == _expected) _reactor.stop();
+		}
+		
+		int connected() const
+		{
+			return _connected;
+		}
+		
+		int failed() const
+		{
+			return _failed;
+		}
+		
+		ConnectNotification::Result result() const
+		{
+			return _result;
+		}
+		
+		const SocketAddress& address() const
+		{
+			return _address;
+		}
+		
+		int error() const
+		{
+			return _error;
+		}
+		
+	private:
+		SocketReactor& _reactor;
+		int            _expected;
+		int            _connected;
+		int            _failed;
+		ConnectNotification::Result _result;
+		SocketAddress  _address;
+		int            _error;
+	};
+
+	class TimerHandler
+	{
+	public:
+		TimerHandler(SocketReactor& reactor):
+			_reactor(reactor),
+			_count(0),
+			_cancelledFired(false)
+		{
+		}
+		
+		void onTimer(TimerNotification* pNf)
+		{
+			if (++_count < 3)
+				_reactor.rescheduleTimer(pNf->timer(), Timespan(0, 20000));
+			else
+				_reactor.stop();
+			pNf->release();
+		}
+		
+		void onCancelledTimer(TimerNotification* pNf)
+		{
+			pNf->release();
+			_cancelledFired = true;
+		}
+		
+		int count() const
+		{
+			return _count;
+		}
+		
+		bool cancelledFired() const
+		{
+			return _cancelledFired;
+		}
+		
+	private:
+		SocketReactor& _reactor;
+		int            _count;
+		bool           _cancelledFired;
+	};
 }
 
 
@@ -359,6 +482,185 @@ void SocketReactorTest::testSocketConnectorTimeout()
 }
 
 
+void SocketReactorTest::testSocketConnectorDeadline()
+{
+	SocketReactor reactor;
+	reactor.setTimeout(Poco::Timespan(3, 0));
+	SocketAddress sa("192.168.168.192", 12345);
+	FailConnector connector(sa, reactor, Timespan(0, 200000));
+	Poco::Stopwatch sw;
+	sw.start();
+	reactor.run();
+	sw.stop();
+	assert (connector.failed());
+	assert (sw.elapsed() < 2000000);
+}
+
+
+void SocketReactorTest::testAsyncConnect()
+{
+	SocketAddress ssa("127.0.0.1", 0);
+	ServerSocket ss(ssa);
+	SocketReactor reactor;
+	ConnectHandler handler(reactor, 10);
+	for (int i = 0; i < 10; ++i)
+	{
+		AsyncConnect::Ptr pConnect = new AsyncConnect(reactor, ss.address(), Timespan(5, 0), Observer<ConnectHandler, ConnectNotification>(handler, &ConnectHandler::onConnect));
+		pConnect->start();
+	}
+	reactor.run();
+	assert (handler.connected() == 10);
+	assert (handler.result() == ConnectNotification::CONNECT_OK);
+	assert (handler.address() == ss.address());
+	assert (handler.error() == 0);
+}
+
+
+void SocketReactorTest::testAsyncConnectFallback()
+{
+	SocketAddress ssa("127.0.0.1", 0);
+	ServerSocket ss(ssa);
+	ServerSocket closed(ssa);
+	SocketAddress refused(closed.address());
+	closed.close();
+
+	// the first address is either unreachable or silently dropped, the second 
+	// refuses the connection, the third one succeeds
+	AsyncConnect::Addresses addresses;
+	addresses.push_back(SocketAddress("192.168.168.192", 12345));
+	addresses.push_back(refused);
+	addresses.push_back(ss.address());
+	
+	SocketReactor reactor;
+	ConnectHandler handler(reactor);
+	AsyncConnect::Ptr pConnect = new AsyncConnect(reactor, addresses, Timespan(5, 0), Observer<ConnectHandler, ConnectNotification>(handler, &ConnectHandler::onConnect));
+	pConnect->setAttemptDelay(Timespan(0, 50000));
+	pConnect->start();
+	Poco::Stopwatch sw;
+	sw.start();
+	reactor.run();
+	sw.stop();
+	assert (pConnect->done());
+	assert (handler.connected() == 1);
+	assert (handler.address() == ss.address());
+	assert (sw.elapsed() < 2000000);
+}
+
+
+void SocketReactorTest::testAsyncConnectFail()
+{
+	SocketAddress ssa("127.0.0.1", 0);
+	ServerSocket closed(ssa);
+	SocketAddress refused(closed.address());
+	closed.close();
+
+	SocketReactor reactor;
+	ConnectHandler handler(reactor, 2);
+	AsyncConnect::Ptr pConnect = new AsyncConnect(reactor, refused, Timespan(5, 0), Observer<ConnectHandler, ConnectNotification>(handler, &ConnectHandler::onConnect));
+	pConnect->start();
+	
+	AsyncConnect::Ptr pTimeout = new AsyncConnect(reactor, SocketAddress("192.168.168.192", 12345), Timespan(0, 200000), Observer<ConnectHandler, ConnectNotification>(handler, &ConnectHandler::onConnect));
+	pTimeout->start();
+	reactor.run();
+	assert (handler.connected() == 0);
+	assert (handler.failed() == 2);
+	assert (pConnect->done());
+	assert (pTimeout->done());
+	
+	AsyncConnect::Ptr pCancelled = new AsyncConnect(reactor, SocketAddress("192.168.168.192", 12345), Timespan(5, 0), Observer<ConnectHandler, ConnectNotification>(handler, &ConnectHandler::onConnect));
+	pCancelled->start();
+	pCancelled->cancel();
+	assert (handler.failed() == 3);
+	assert (handler.result() == ConnectNotification::CONNECT_CANCELLED);
+}
+
+
+void SocketReactorTest::testTimerWheel()
+{
+	TimerWheel wheel;
+	Timestamp start;
+	const int N = 1000;
+	std::vector<TimerWheel::Timer::Ptr> timers;
+	for (int i = 0; i < N; ++i)
+	{
+		TimerWheel::Timer::Ptr pTimer = new TimerWheel::Timer;
+		Timestamp::TimeDiff delay = (i*7919) % 3600000;
+		if (i % 100 == 0) delay = Timestamp::TimeDiff(20)*24*3600*1000; // beyond the wheel's range
+		Timestamp expires(start);
+		expires += delay*1000;
+		wheel.schedule(pTimer, expires);
+		timers.push_back(pTimer);
+	}
+	assert (wheel.size() == N);
+	
+	wheel.cancel(timers[1]);
+	assert (!timers[1]->isScheduled());
+	assert (wheel.size() == N - 1);
+	
+	Timestamp now(start);
+	Timespan timeout;
+	TimerWheel::TimerVec expired;
+	int fired = 0;
+	int iterations = 0;
+	while (wheel.nextTimeout(now, timeout) && iterations < 10*N)
+	{
+		now += timeout.totalMicroseconds();
+		expired.clear();
+		wheel.advance(now, expired);
+		for (TimerWheel::TimerVec::iterator it = expired.begin(); it != expired.end(); ++it)
+		{
+			assert (wheel.claim(*it));
+			assert (!(*it)->isScheduled());
+			assert ((*it)->expires() <= now);
+			assert (now - (*it)->expires() <= wheel.resolution().totalMicroseconds());
+			++fired;
+		}
+		++iterations;
+	}
+	assert (fired == N - 1);
+	assert (wheel.empty());
+	
+	TimerWheel::Timer::Ptr pTimer = new TimerWheel::Timer;
+	wheel.schedule(pTimer, now);
+	wheel.schedule(pTimer, Timestamp(now + 5000));
+	assert (wheel.size() == 1);
+	expired.clear();
+	assert (wheel.advance(now + 1000, expired) == 0);
+	assert (wheel.advance(now + 6000, expired) == 1);
+	wheel.cancel(pTimer);
+	assert (!wheel.claim(pTimer));
+	
+	wheel.schedule(pTimer, Timestamp(now + 7000));
+	expired.clear();
+	assert (wheel.advance(now + 8000, expired) == 1);
+	wheel.schedule(pTimer, Timestamp(now + 20000));
+	assert (!wheel.claim(pTimer));
+	assert (pTimer->isScheduled());
+	assert (wheel.size() == 1);
+}
+
+
+void SocketReactorTest::testReactorTimers()
+{
+	SocketAddress ssa;
+	ServerSocket ss(ssa);
+	SocketReactor reactor;
+	SocketAcceptor<EchoServiceHandler> acceptor(ss, reactor);
+	TimerHandler handler(reactor);
+	reactor.scheduleTimer(Timespan(0, 20000), Observer<TimerHandler, TimerNotification>(handler, &TimerHandler::onTimer));
+	TimerWheel::Timer::Ptr pTimer = reactor.scheduleTimer(ss, Timespan(0, 10000), Observer<TimerHandler, TimerNotification>(handler, &TimerHandler::onCancelledTimer));
+	reactor.cancelTimer(pTimer);
+	Poco::Stopwatch sw;
+	sw.start();
+	reactor.run();
+	sw.stop();
+	assert (handler.count() == 3);
+	assert (!handler.cancelledFired());
+	assert (sw.elapsed() >= 60000);
+	assert (sw.elapsed() < 2000000);
+}
+
+
 void SocketReactorTest::setUp()
 {
 	ClientServiceHandler::setCloseOnTimeout(false);
@@ -377,6 +679,12 @@ CppUnit::Test* SocketReactorTest::suite()
 	CppUnit_addTest(pSuite, SocketReactorTest, testSocketReactor);
 	CppUnit_addTest(pSuite, SocketReactorTest, testSocketConnectorFail);
 	CppUnit_addTest(pSuite, SocketReactorTest, testSocketConnectorTimeout);
+	CppUnit_addTest(pSuite, SocketReactorTest, testSocketConnectorDeadline);
+	CppUnit_addTest(pSuite, SocketReactorTest, testAsyncConnect);
+	CppUnit_addTest(pSuite, SocketReactorTest, testAsyncConnectFallback);
+	CppUnit_addTest(pSuite, SocketReactorTest, testAsyncConnectFail);
+	CppUnit_addTest(pSuite, SocketReactorTest, testTimerWheel);
+	CppUnit_addTest(pSuite, SocketReactorTest, testReactorTimers);
 
 	return pSuite;
 }
@@ -49,6 +49,12 @@ public:
 	void testSocketReactor();
 	void testSocketConnectorFail();
 	void testSocketConnectorTimeout();
+	void testSocketConnectorDeadline();
+	void testAsyncConnect();
+	void testAsyncConnectFallback();
+	void testAsyncConnectFail();
+	void testTimerWheel();
+	void testReactorTimers();
 
 	void setUp();
 	void tearDown();
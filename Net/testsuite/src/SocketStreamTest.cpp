@@ -116,6 +116,53 @@ void SocketStreamTest::testEOF()
 }
 
 
+void SocketStreamTest::testLargeEcho()
+{
+	EchoServer echoServer;
+	StreamSocket ss;
+	ss.connect(SocketAddress("localhost", echoServer.port()));
+	SocketStream str(ss, 4096);
+	std::string data;
+	for (int i = 0; i < 100000; ++i) data += char('a' + i % 26);
+	str << "abc";
+	str.write(data.data(), (std::streamsize) data.size());
+	str << "xyz";
+	assert (str.good());
+	str.flush();
+	assert (str.good());
+	ss.shutdownSend();
+
+	std::string buffer(data.size(), '\0');
+	str.read(&buffer[0], 3);
+	assert (str.gcount() == 3);
+	assert (buffer.substr(0, 3) == "abc");
+	str.read(&buffer[0], (std::streamsize) buffer.size());
+	assert (str.good());
+	assert (str.gcount() == (std::streamsize) data.size());
+	assert (buffer == data);
+	str.read(&buffer[0], 3);
+	assert (str.gcount() == 3);
+	assert (buffer.substr(0, 3) == "xyz");
+	assert (str.get() == -1);
+	assert (str.eof());
+
+	ss.close();
+}
+
+
+void SocketStreamTest::testBufferSize()
+{
+	EchoServer echoServer;
+	StreamSocket ss;
+	ss.connect(SocketAddress("localhost", echoServer.port()));
+	SocketStream str1(ss);
+	assert (str1.rdbuf()->bufferSize() == Poco::Net::SocketStreamBuf::DEFAULT_BUFFER_SIZE);
+	SocketStream str2(ss, 65536);
+	assert (str2.rdbuf()->bufferSize() == 65536);
+	ss.close();
+}
+
+
 void SocketStreamTest::setUp()
 {
 }
@@ -132,6 +179,8 @@ CppUnit::Test* SocketStreamTest::suite()
 
 	CppUnit_addTest(pSuite, SocketStreamTest, testStreamEcho);
 	CppUnit_addTest(pSuite, SocketStreamTest, testEOF);
+	CppUnit_addTest(pSuite, SocketStreamTest, testLargeEcho);
+	CppUnit_addTest(pSuite, SocketStreamTest, testBufferSize);
 
 	return pSuite;
 }
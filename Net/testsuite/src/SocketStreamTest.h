@@ -48,6 +48,8 @@ public:
 
 	void testStreamEcho();
 	void testEOF();
+	void testLargeEcho();
+	void testBufferSize();
 
 	void setUp();
 	void tearDown();
@@ -36,6 +36,10 @@
 #include "Poco/Net/RemoteSyslogChannel.h"
 #include "Poco/Net/RemoteSyslogListener.h"
 #include "Poco/Net/DNS.h"
+#include "Poco/Net/ServerSocket.h"
+#include "Poco/Net/StreamSocket.h"
+#include "Poco/Net/SocketAddress.h"
+#include "Poco/NumberParser.h"
 #include "Poco/Thread.h"
 #include "Poco/Message.h"
 #include "Poco/AutoPtr.h"
@@ -194,6 +198,106 @@ void SyslogTest::testOldBSD()
 }
 
 
+void SyslogTest::testAsync()
+{
+	Poco::AutoPtr<RemoteSyslogChannel> channel = new RemoteSyslogChannel();
+	channel->setProperty("loghost", "localhost:51400");
+	channel->setProperty("async", "true");
+	channel->setProperty("queueSize", "16");
+	assert (channel->getProperty("async") == "true");
+	assert (channel->getProperty("queueSize") == "16");
+	Poco::AutoPtr<RemoteSyslogListener> listener = new RemoteSyslogListener(51400);
+	listener->open();
+	CachingChannel cl;
+	listener->addChannel(&cl);
+	channel->open();
+	for (int i = 0; i < 10; ++i)
+	{
+		Poco::Message msg("asource", "amessage", Poco::Message::PRIO_CRITICAL);
+		channel->log(msg);
+	}
+	Poco::Thread::sleep(1000);
+	listener->close();
+	channel->close();
+	assert (channel->sent() + channel->dropped() == 10);
+	assert (cl.getCurrentSize() == channel->sent());
+	std::vector<Poco::Message> msgs;
+	cl.getMessages(msgs, 0, 10);
+	assert (!msgs.empty());
+	assert (msgs[0].getSource() == "asource");
+	assert (msgs[0].getText() == "amessage");
+	assert (msgs[0].getPriority() == Poco::Message::PRIO_CRITICAL);
+}
+
+
+void SyslogTest::testAsyncOverflow()
+{
+	// nobody accepts connections on the TCP port, so the background
+	// thread cannot drain the ring and log() must drop instead of blocking
+	ServerSocket ss(SocketAddress("127.0.0.1", 0));
+	SocketAddress addr(ss.address());
+	ss.close();
+	Poco::AutoPtr<RemoteSyslogChannel> channel = new RemoteSyslogChannel();
+	channel->setProperty("loghost", addr.toString());
+	channel->setProperty("transport", "tcp");
+	channel->setProperty("async", "true");
+	channel->setProperty("queueSize", "4");
+	channel->open();
+	for (int i = 0; i < 100; ++i)
+	{
+		Poco::Message msg("asource", "amessage", Poco::Message::PRIO_CRITICAL);
+		channel->log(msg);
+	}
+	channel->close();
+	assert (channel->sent() == 0);
+	assert (channel->dropped() == 100);
+}
+
+
+void SyslogTest::testTCP()
+{
+	ServerSocket ss(SocketAddress("127.0.0.1", 0));
+	Poco::AutoPtr<RemoteSyslogChannel> channel = new RemoteSyslogChannel();
+	channel->setProperty("loghost", ss.address().toString());
+	channel->setProperty("transport", "tcp");
+	assert (channel->getProperty("transport") == "tcp");
+	channel->open();
+	Poco::Message msg1("asource", "message one", Poco::Message::PRIO_CRITICAL);
+	channel->log(msg1);
+	Poco::Message msg2("asource", "message two", Poco::Message::PRIO_ERROR);
+	channel->log(msg2);
+	
+	StreamSocket sock = ss.acceptConnection();
+	sock.setReceiveTimeout(Poco::Timespan(5, 0));
+	std::string data;
+	char buffer[1024];
+	std::vector<std::string> frames;
+	while (frames.size() < 2)
+	{
+		std::string::size_type sp = data.find(' ');
+		if (sp != std::string::npos)
+		{
+			std::size_t len = Poco::NumberParser::parseUnsigned(data.substr(0, sp));
+			if (data.size() >= sp + 1 + len)
+			{
+				frames.push_back(data.substr(sp + 1, len));
+				data.erase(0, sp + 1 + len);
+				continue;
+			}
+		}
+		int n = sock.receiveBytes(buffer, sizeof(buffer));
+		assert (n > 0);
+		data.append(buffer, n);
+	}
+	channel->close();
+	assert (frames[0].compare(0, 7, "<10>1 2") == 0);
+	assert (frames[0].find("asource message one") != std::string::npos);
+	assert (frames[1].compare(0, 7, "<11>1 2") == 0);
+	assert (frames[1].find("asource message two") != std::string::npos);
+	assert (data.empty());
+}
+
+
 void SyslogTest::setUp()
 {
 }
@@ -210,6 +314,9 @@ CppUnit::Test* SyslogTest::suite()
 
 	CppUnit_addTest(pSuite, SyslogTest, testListener);
 	CppUnit_addTest(pSuite, SyslogTest, testOldBSD);
+	CppUnit_addTest(pSuite, SyslogTest, testAsync);
+	CppUnit_addTest(pSuite, SyslogTest, testAsyncOverflow);
+	CppUnit_addTest(pSuite, SyslogTest, testTCP);
 
 	return pSuite;
 }
@@ -48,6 +48,9 @@ public:
 
 	void testListener();
 	void testOldBSD();
+	void testAsync();
+	void testAsyncOverflow();
+	void testTCP();
 
 	void setUp();
 	void tearDown();
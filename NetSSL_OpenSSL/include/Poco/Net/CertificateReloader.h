@@ -0,0 +1,185 @@
+//
+// CertificateReloader.h
+//
+// $Id: //poco/1.4/NetSSL_OpenSSL/include/Poco/Net/CertificateReloader.h#1 $
+//
+// Library: NetSSL_OpenSSL
+// Package: SSLCore
+// Module:  CertificateReloader
+//
+// Definition of the CertificateReloader class.
+//
+// Copyright (c) 2013, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+// 
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+
+
+
+#ifndef NetSSL_CertificateReloader_INCLUDED
+#define NetSSL_CertificateReloader_INCLUDED
+
+
+#include "Poco/Net/NetSSL.h"
+#include "Poco/Net/Context.h"
+#include "Poco/Net/SecureServerSocket.h"
+#include "Poco/DirectoryWatcher.h"
+#include "Poco/BasicEvent.h"
+#include "Poco/AtomicCounter.h"
+#include "Poco/Mutex.h"
+#include <vector>
+#include <set>
+
+
+namespace Poco {
+namespace Net {
+
+
+class NetSSL_API CertificateReloader
+	/// CertificateReloader puts a renewed certificate and private
+	/// key into service on a running server, without dropping
+	/// established connections.
+	///
+	/// The CertificateReloader watches the certificate and private
+	/// key files using DirectoryWatcher. When one of the files changes,
+	/// a new server Context is created and installed in the
+	/// SecureServerSocket with SecureServerSocket::setContext().
+	/// New connections use the new certificate, key and chain, while
+	/// existing connections continue with the previous Context.
+	///
+	/// The new Context is created on the DirectoryWatcher's thread,
+	/// so loading and checking the files never delays accepting
+	/// connections. If the new Context cannot be created, e.g.,
+	/// because the files are incomplete or the private key does not
+	/// match the certificate, the previous Context stays in use and
+	/// reloadFailed is fired. Files should therefore be replaced
+	/// atomically (by renaming a new file over the old one), or
+	/// the key should be written before the certificate.
+	///
+	/// A HandshakePool, SessionCache or SessionTicketKeyManager set for
+	/// the current Context is carried over to the new Context, unless the
+	/// new Context already has one, so that clients can resume sessions 
+	/// across a reload. If the new Context does not enable session caching,
+	/// the session ID context, cache size and session timeout of the
+	/// current Context are carried over as well. So is kernel TLS offload,
+	/// if it has been enabled for the current Context.
+{
+public:
+	class NetSSL_API ContextFactory
+		/// Creates the Contexts installed by a CertificateReloader.
+	{
+	public:
+		virtual ~ContextFactory();
+
+		virtual Context::Ptr createContext() = 0;
+			/// Creates and returns a new server Context,
+			/// loading the current certificate and key files.
+			/// Throws an exception if the Context cannot be created.
+	};
+
+	Poco::BasicEvent<const Context::Ptr> contextReloaded;
+		/// Fired after a new Context has been installed.
+
+	Poco::BasicEvent<const Poco::Exception> reloadFailed;
+		/// Fired if a new Context could not be created.
+
+	CertificateReloader(
+		const SecureServerSocket& socket,
+		const std::string& privateKeyFile,
+		const std::string& certificateFile,
+		const std::string& caLocation,
+		Context::VerificationMode verificationMode = Context::VERIFY_RELAXED,
+		int verificationDepth = 9,
+		bool loadDefaultCAs = false,
+		const std::string& cipherList = "ALL:!ADH:!LOW:!EXP:!MD5:@STRENGTH");
+		/// Creates the CertificateReloader for the given socket.
+		///
+		/// New Contexts are created with the given parameters,
+		/// which have the same meaning as for the Context constructor.
+		/// The private key file, the certificate file and, if it is
+		/// a file, the CA location are watched for changes.
+
+	CertificateReloader(const SecureServerSocket& socket, ContextFactory* pFactory, const std::vector<std::string>& files);
+		/// Creates the CertificateReloader for the given socket,
+		/// using the given ContextFactory to create new Contexts.
+		/// The CertificateReloader takes ownership of the factory.
+		///
+		/// The given files are watched for changes.
+
+	~CertificateReloader();
+		/// Stops watching the files and destroys the CertificateReloader.
+
+	void reload();
+		/// Creates a new Context and installs it in the socket.
+		///
+		/// Throws an exception and leaves the current Context
+		/// in place if the new Context cannot be created.
+
+	int reloads() const;
+		/// Returns the number of Contexts installed so far.
+
+	int failures() const;
+		/// Returns the number of failed reload attempts.
+
+protected:
+	void onFileChanged(const void* pSender, const Poco::DirectoryWatcher::DirectoryEvent& event);
+
+private:
+	CertificateReloader();
+	CertificateReloader(const CertificateReloader&);
+	CertificateReloader& operator = (const CertificateReloader&);
+
+	void watch(const std::vector<std::string>& files);
+	void unwatch();
+
+	SecureServerSocket _socket;
+	ContextFactory* _pFactory;
+	std::set<std::string> _files;
+	std::vector<Poco::DirectoryWatcher*> _watchers;
+	Poco::AtomicCounter _reloads;
+	Poco::AtomicCounter _failures;
+	Poco::FastMutex _mutex;
+};
+
+
+//
+// inlines
+//
+inline int CertificateReloader::reloads() const
+{
+	return _reloads.value();
+}
+
+
+inline int CertificateReloader::failures() const
+{
+	return _failures.value();
+}
+
+
+} } // namespace Poco::Net
+
+
+#endif // NetSSL_CertificateReloader_INCLUDED
@@ -0,0 +1,193 @@
+//
+// ClientSessionCache.h
+//
+// $Id: //poco/1.4/NetSSL_OpenSSL/include/Poco/Net/ClientSessionCache.h#1 $
+//
+// Library: NetSSL_OpenSSL
+// Package: SSLCore
+// Module:  ClientSessionCache
+//
+// Definition of the ClientSessionCache class.
+//
+// Copyright (c) 2013, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+// 
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+
+
+
+#ifndef NetSSL_ClientSessionCache_INCLUDED
+#define NetSSL_ClientSessionCache_INCLUDED
+
+
+#include "Poco/Net/NetSSL.h"
+#include "Poco/Net/Session.h"
+#include "Poco/RefCountedObject.h"
+#include "Poco/AutoPtr.h"
+#include "Poco/AtomicCounter.h"
+#include "Poco/Mutex.h"
+#include <map>
+#include <list>
+
+
+namespace Poco {
+namespace Net {
+
+
+class NetSSL_API ClientSessionCache: public Poco::RefCountedObject
+	/// ClientSessionCache keeps the most recently negotiated
+	/// SSL session for each peer (host name and port) a client
+	/// Context has connected to.
+	///
+	/// If session caching is enabled for a client Context,
+	/// every SecureStreamSocket connecting to a known peer
+	/// automatically attempts to resume the cached session,
+	/// unless a session has been explicitly set with useSession().
+	/// After the handshake, the negotiated session replaces
+	/// the cached one.
+	///
+	/// The cache is bounded; if it is full, the least recently
+	/// used session is discarded.
+{
+public:
+	typedef Poco::AutoPtr<ClientSessionCache> Ptr;
+
+	enum
+	{
+		DEFAULT_MAX_SIZE = 1024
+	};
+
+	explicit ClientSessionCache(std::size_t maxSize = DEFAULT_MAX_SIZE);
+		/// Creates the ClientSessionCache.
+
+	Session::Ptr find(const std::string& peer);
+		/// Returns the cached session for the given peer,
+		/// or a null pointer if no session (or only an
+		/// expired one) is cached for the peer.
+
+	void update(const std::string& peer, Session::Ptr pSession, bool resumed);
+		/// Stores the session negotiated with the given peer and
+		/// counts the handshake as full or resumed.
+
+	void remove(const std::string& peer);
+		/// Removes the session for the given peer, e.g. because
+		/// resuming it failed.
+
+	void clear();
+		/// Removes all sessions.
+
+	void setMaxSize(std::size_t maxSize);
+		/// Sets the maximum number of cached sessions.
+		/// A value of 0 means unlimited.
+
+	std::size_t getMaxSize() const;
+		/// Returns the maximum number of cached sessions.
+
+	std::size_t size() const;
+		/// Returns the number of cached sessions.
+
+	int hits() const;
+		/// Returns the number of connections for which
+		/// a cached session was found.
+
+	int misses() const;
+		/// Returns the number of connections for which
+		/// no cached session was found.
+
+	int fullHandshakes() const;
+		/// Returns the number of completed handshakes
+		/// that negotiated a new session.
+
+	int resumedHandshakes() const;
+		/// Returns the number of completed handshakes
+		/// that resumed a session.
+
+	void resetStatistics();
+		/// Resets all counters.
+
+	static std::string peerName(const std::string& host, Poco::UInt16 port);
+		/// Returns the cache key for the given host and port.
+
+protected:
+	~ClientSessionCache();
+
+private:
+	ClientSessionCache(const ClientSessionCache&);
+	ClientSessionCache& operator = (const ClientSessionCache&);
+
+	typedef std::list<std::string> LRUList;
+
+	struct Entry
+	{
+		Session::Ptr pSession;
+		LRUList::iterator lruIt;
+	};
+
+	typedef std::map<std::string, Entry> SessionMap;
+
+	void removeImpl(SessionMap::iterator it);
+
+	std::size_t _maxSize;
+	SessionMap _sessions;
+	LRUList _lru;
+	mutable Poco::FastMutex _mutex;
+	Poco::AtomicCounter _hits;
+	Poco::AtomicCounter _misses;
+	Poco::AtomicCounter _fullHandshakes;
+	Poco::AtomicCounter _resumedHandshakes;
+};
+
+
+//
+// inlines
+//
+inline int ClientSessionCache::hits() const
+{
+	return _hits.value();
+}
+
+
+inline int ClientSessionCache::misses() const
+{
+	return _misses.value();
+}
+
+
+inline int ClientSessionCache::fullHandshakes() const
+{
+	return _fullHandshakes.value();
+}
+
+
+inline int ClientSessionCache::resumedHandshakes() const
+{
+	return _resumedHandshakes.value();
+}
+
+
+} } // namespace Poco::Net
+
+
+#endif // NetSSL_ClientSessionCache_INCLUDED
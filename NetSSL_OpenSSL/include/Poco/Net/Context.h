@@ -42,6 +42,10 @@
 
 #include "Poco/Net/NetSSL.h"
 #include "Poco/Net/SocketDefs.h"
+#include "Poco/Net/SessionCache.h"
+#include "Poco/Net/ClientSessionCache.h"
+#include "Poco/Net/SessionTicketKeyManager.h"
+#include "Poco/Net/HandshakePool.h"
 #include "Poco/Crypto/X509Certificate.h"
 #include "Poco/Crypto/RSAKey.h"
 #include "Poco/RefCountedObject.h"
@@ -210,6 +214,11 @@ public:
 		///
 		/// The default is disabled session caching.
 		///
+		/// On the client side, enabling session caching makes
+		/// every SecureStreamSocket using this Context attempt to
+		/// resume the last session negotiated with the same peer
+		/// (see getClientSessionCache()).
+		///
 		/// To enable session caching on the server side, use the
 		/// two-argument version of this method to specify
 		/// a session ID context.
@@ -233,6 +242,11 @@ public:
 		
 	bool sessionCacheEnabled() const;
 		/// Returns true iff the session cache is enabled.
+
+	const std::string& getSessionIdContext() const;
+		/// Returns the session ID context set with
+		/// enableSessionCache(flag, sessionIdContext),
+		/// or an empty string if none has been set.
 		
 	void setSessionCacheSize(std::size_t size);
 		/// Sets the maximum size of the server session cache, in number of
@@ -242,12 +256,13 @@ public:
 		///
 		/// Specifying a size of 0 will set an unlimited cache size.
 		///
-		/// This method may only be called on SERVER_USE Context objets.
+		/// On a CLIENT_USE Context, sets the maximum size of the
+		/// client session cache, which by default holds
+		/// ClientSessionCache::DEFAULT_MAX_SIZE sessions.
 		
 	std::size_t getSessionCacheSize() const;
-		/// Returns the current maximum size of the server session cache.
-		///
-		/// This method may only be called on SERVER_USE Context objets.
+		/// Returns the current maximum size of the server
+		/// or client session cache.
 		
 	void setSessionTimeout(long seconds);
 		/// Sets the timeout (in seconds) of cached sessions on the server.
@@ -282,14 +297,130 @@ public:
 		///
 		/// The feature can be disabled by calling this method.
 
+	void setSessionCache(SessionCache::Ptr pCache);
+		/// Sets an external session cache for the server, which
+		/// replaces OpenSSL's internal session cache.
+		///
+		/// Using an external cache (e.g., a SharedMemorySessionCache)
+		/// allows several Context objects, possibly in different
+		/// processes, to resume each other's sessions.
+		///
+		/// Session caching is enabled by this method. A session
+		/// ID context must be set with enableSessionCache(true, sessionIdContext),
+		/// which may be called before or after this method.
+		/// Passing a null pointer removes the external cache and
+		/// re-enables the internal cache.
+		///
+		/// This method may only be called on SERVER_USE Context objects.
+
+	SessionCache::Ptr getSessionCache() const;
+		/// Returns the external session cache, or a null pointer
+		/// if no external session cache has been set.
+
+	void setSessionTicketKeyManager(SessionTicketKeyManager::Ptr pManager);
+		/// Sets the SessionTicketKeyManager that provides the keys
+		/// for encrypting and decrypting session tickets, and enables
+		/// stateless session resumption.
+		///
+		/// Servers sharing the same keys can resume each other's
+		/// sessions without sharing a session cache.
+		/// Passing a null pointer restores OpenSSL's default behavior
+		/// of using random per-Context keys.
+		///
+		/// This method may only be called on SERVER_USE Context objects.
+		/// Throws a NotImplementedException if the OpenSSL library
+		/// does not support session tickets.
+
+	SessionTicketKeyManager::Ptr getSessionTicketKeyManager() const;
+		/// Returns the SessionTicketKeyManager, or a null pointer
+		/// if none has been set.
+
+	ClientSessionCache::Ptr getClientSessionCache() const;
+		/// Returns the cache holding the sessions negotiated by
+		/// clients using this Context, which also provides statistics
+		/// about resumed handshakes.
+		///
+		/// Returns a null pointer for SERVER_USE Context objects.
+
+	void setHandshakePool(HandshakePool::Ptr pPool);
+		/// Sets the HandshakePool that performs the handshakes
+		/// of connections accepted by a SecureServerSocket using
+		/// this Context.
+		///
+		/// With a HandshakePool, SecureServerSocket::acceptConnection()
+		/// only returns connections whose handshake has already completed,
+		/// so that the threads serving connections are not tied up with
+		/// private key operations. See HandshakePool for more information.
+		/// Passing a null pointer restores the default behavior of
+		/// performing the handshake on first use of the accepted connection.
+		///
+		/// The HandshakePool must be set before the SecureServerSocket
+		/// is used to accept connections.
+		///
+		/// This method may only be called on SERVER_USE Context objects.
+
+	HandshakePool::Ptr getHandshakePool() const;
+		/// Returns the HandshakePool, or a null pointer
+		/// if none has been set.
+
+	void enableKernelTLS(bool flag = true);
+		/// Enables or disables kernel TLS (kTLS) offload for sockets
+		/// created with this Context.
+		///
+		/// With kernel TLS, once the handshake has completed, the
+		/// negotiated keys are handed to the operating system kernel,
+		/// which then encrypts all data sent over the socket. This
+		/// avoids copying data through OpenSSL and makes zero-copy
+		/// transmission of files over TLS possible (see
+		/// StreamSocket::sendFile() and HTTPServerResponse::sendFile()).
+		/// Decryption of received data is still done by OpenSSL.
+		///
+		/// Kernel TLS is only used if the operating system (Linux 4.13
+		/// or newer, with the tls module loaded), the OpenSSL version
+		/// and the negotiated protocol and cipher (TLS 1.2 with AES-GCM
+		/// if the keys are installed by this library) support it.
+		/// Otherwise, the connection silently continues without kernel TLS.
+		/// SecureStreamSocket::kernelTLSActive() tells whether a
+		/// connection uses kernel TLS.
+		///
+		/// Connections using kernel TLS must not be renegotiated.
+
+	bool kernelTLSEnabled() const;
+		/// Returns true iff kernel TLS offload has been enabled.
+
 private:
 	void createSSLContext();
 		/// Create a SSL_CTX object according to Context configuration.
 
+	static Context* fromSSLContext(SSL_CTX* pSSLContext);
+		/// Returns the Context object owning the given SSL_CTX.
+
+	static int onNewSession(SSL* pSSL, SSL_SESSION* pSession);
+		/// Adds a new session to the external session cache.
+
+#if OPENSSL_VERSION_NUMBER >= 0x10100000L
+	static SSL_SESSION* onGetSession(SSL* pSSL, const unsigned char* id, int length, int* pCopy);
+#else
+	static SSL_SESSION* onGetSession(SSL* pSSL, unsigned char* id, int length, int* pCopy);
+#endif
+		/// Looks up a session in the external session cache.
+
+	static void onRemoveSession(SSL_CTX* pSSLContext, SSL_SESSION* pSession);
+		/// Removes a session from the external session cache.
+
+	static int onTicketKey(SSL* pSSL, unsigned char* name, unsigned char* iv, EVP_CIPHER_CTX* pCipherContext, HMAC_CTX* pHMACContext, int enc);
+		/// Sets up encryption and authentication of a session ticket.
+
 	Usage _usage;
 	VerificationMode _mode;
 	SSL_CTX* _pSSLContext;
 	bool _extendedCertificateVerification;
+	SessionCache::Ptr _pSessionCache;
+	SessionTicketKeyManager::Ptr _pTicketKeyManager;
+	ClientSessionCache::Ptr _pClientSessionCache;
+	HandshakePool::Ptr _pHandshakePool;
+	bool _kernelTLS;
+	std::string _sessionIdContext;
 };
 
 
@@ -326,6 +457,42 @@ inline bool Context::extendedCertificateVerificationEnabled() const
 }
 
 
+inline const std::string& Context::getSessionIdContext() const
+{
+	return _sessionIdContext;
+}
+
+
+inline SessionCache::Ptr Context::getSessionCache() const
+{
+	return _pSessionCache;
+}
+
+
+inline SessionTicketKeyManager::Ptr Context::getSessionTicketKeyManager() const
+{
+	return _pTicketKeyManager;
+}
+
+
+inline ClientSessionCache::Ptr Context::getClientSessionCache() const
+{
+	return _pClientSessionCache;
+}
+
+
+inline HandshakePool::Ptr Context::getHandshakePool() const
+{
+	return _pHandshakePool;
+}
+
+
+inline bool Context::kernelTLSEnabled() const
+{
+	return _kernelTLS;
+}
+
+
 } } // namespace Poco::Net
 
 
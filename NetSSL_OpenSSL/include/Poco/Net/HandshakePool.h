@@ -0,0 +1,249 @@
+//
+// HandshakePool.h
+//
+// $Id: //poco/1.4/NetSSL_OpenSSL/include/Poco/Net/HandshakePool.h#1 $
+//
+// Library: NetSSL_OpenSSL
+// Package: SSLCore
+// Module:  HandshakePool
+//
+// Definition of the HandshakePool class.
+//
+// Copyright (c) 2013, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+// 
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+
+
+
+#ifndef NetSSL_HandshakePool_INCLUDED
+#define NetSSL_HandshakePool_INCLUDED
+
+
+#include "Poco/Net/NetSSL.h"
+#include "Poco/Net/StreamSocket.h"
+#include "Poco/RefCountedObject.h"
+#include "Poco/AutoPtr.h"
+#include "Poco/AtomicCounter.h"
+#include "Poco/NotificationQueue.h"
+#include "Poco/ThreadPool.h"
+#include "Poco/Runnable.h"
+#include "Poco/Timespan.h"
+#include "Poco/Mutex.h"
+
+
+namespace Poco {
+namespace Net {
+
+
+class NetSSL_API HandshakePool: public Poco::RefCountedObject, private Poco::Runnable
+	/// HandshakePool performs the server side of SSL/TLS handshakes,
+	/// including the expensive private key operations, on a dedicated,
+	/// bounded set of threads.
+	///
+	/// Normally, the handshake of a connection accepted by a TCPServer
+	/// is performed by the TCPServerDispatcher thread that serves the
+	/// connection, as part of the first read or write. When many clients
+	/// connect at the same time, all dispatcher threads can end up busy
+	/// with handshakes, and requests on established connections starve.
+	///
+	/// If a HandshakePool is set for a server Context (see
+	/// Context::setHandshakePool()), a SecureServerSocket using that
+	/// Context hands every accepted connection to the pool, and returns
+	/// it from acceptConnection() only after the handshake has completed.
+	/// The dispatcher threads thus only ever see established connections.
+	/// Connections that arrive while the pool queue is full are closed
+	/// immediately, as are connections whose handshake fails or does not
+	/// complete within the handshake timeout.
+	///
+	/// The HandshakePool is intended for thread-per-connection servers
+	/// (TCPServer, HTTPServer). Reactor-based servers should use
+	/// SecureSocketReactorHandler instead.
+	///
+	/// The pool keeps statistics about its queue and the time spent
+	/// waiting for and performing handshakes.
+{
+public:
+	typedef Poco::AutoPtr<HandshakePool> Ptr;
+
+	class NetSSL_API Target: public Poco::RefCountedObject
+		/// Receives the connections whose handshake has completed.
+	{
+	public:
+		typedef Poco::AutoPtr<Target> Ptr;
+
+		virtual void handshakeCompleted(const StreamSocket& socket) = 0;
+			/// Called by a pool thread for every connection whose
+			/// handshake has completed successfully.
+
+	protected:
+		virtual ~Target();
+	};
+
+	HandshakePool(int threads = 2, int maxQueued = 64, const Poco::Timespan& timeout = Poco::Timespan(10, 0));
+		/// Creates the HandshakePool with the given number of
+		/// threads, the maximum number of connections waiting for
+		/// a thread, and the timeout for a single handshake.
+		///
+		/// The timeout limits the total duration of a handshake,
+		/// not the time between two packets of the client.
+
+	bool enqueue(const StreamSocket& socket, Target::Ptr pTarget);
+		/// Queues the given accepted socket, which must be a
+		/// SecureStreamSocket whose handshake has not been performed,
+		/// for the handshake. pTarget receives the socket when the
+		/// handshake has completed.
+		///
+		/// Returns false if the queue is full or the pool has been stopped.
+
+	void stop();
+		/// Stops the pool. Queued connections are closed.
+		/// Handshakes in progress are completed, or time out,
+		/// before stop() returns.
+
+	int threads() const;
+		/// Returns the number of threads.
+
+	int maxQueued() const;
+		/// Returns the maximum number of queued connections.
+
+	const Poco::Timespan& timeout() const;
+		/// Returns the handshake timeout.
+
+	int queued() const;
+		/// Returns the number of connections currently waiting for a thread.
+
+	int active() const;
+		/// Returns the number of handshakes currently in progress.
+
+	int completed() const;
+		/// Returns the number of successfully completed handshakes.
+
+	int failed() const;
+		/// Returns the number of failed or timed out handshakes.
+
+	int rejected() const;
+		/// Returns the number of connections rejected because
+		/// the queue was full.
+
+	Poco::Timespan averageQueueTime() const;
+		/// Returns the average time a connection had to wait for a thread.
+
+	Poco::Timespan averageHandshakeTime() const;
+		/// Returns the average duration of a handshake
+		/// (successful or not).
+
+	Poco::Timespan maxHandshakeTime() const;
+		/// Returns the longest duration of a handshake.
+
+	void resetStatistics();
+		/// Resets the completed, failed and rejected counters,
+		/// and the timing statistics.
+
+protected:
+	~HandshakePool();
+
+	void run();
+
+	bool handshake(StreamSocket& socket);
+		/// Performs the handshake for the given socket.
+
+private:
+	HandshakePool(const HandshakePool&);
+	HandshakePool& operator = (const HandshakePool&);
+
+	int                     _threads;
+	int                     _maxQueued;
+	Poco::Timespan          _timeout;
+	Poco::NotificationQueue _queue;
+	Poco::ThreadPool        _threadPool;
+	bool                    _stopped;
+	Poco::AtomicCounter     _active;
+	Poco::AtomicCounter     _completed;
+	Poco::AtomicCounter     _failed;
+	Poco::AtomicCounter     _rejected;
+	mutable Poco::FastMutex _mutex;
+	Poco::Int64             _handshakes;
+	Poco::Int64             _totalQueueTime;
+	Poco::Int64             _totalHandshakeTime;
+	Poco::Int64             _maxHandshakeTime;
+};
+
+
+//
+// inlines
+//
+inline int HandshakePool::threads() const
+{
+	return _threads;
+}
+
+
+inline int HandshakePool::maxQueued() const
+{
+	return _maxQueued;
+}
+
+
+inline const Poco::Timespan& HandshakePool::timeout() const
+{
+	return _timeout;
+}
+
+
+inline int HandshakePool::queued() const
+{
+	return _queue.size();
+}
+
+
+inline int HandshakePool::active() const
+{
+	return _active.value();
+}
+
+
+inline int HandshakePool::completed() const
+{
+	return _completed.value();
+}
+
+
+inline int HandshakePool::failed() const
+{
+	return _failed.value();
+}
+
+
+inline int HandshakePool::rejected() const
+{
+	return _rejected.value();
+}
+
+
+} } // namespace Poco::Net
+
+
+#endif // NetSSL_HandshakePool_INCLUDED
@@ -108,7 +108,7 @@ class NetSSL_API SSLManager
 	///            </invalidCertificateHandler>
 	///            <cacheSessions>true|false</cacheSessions>
 	///            <sessionIdContext>someString</sessionIdContext> <!-- server only -->
-	///            <sessionCacheSize>0..n</sessionCacheSize>       <!-- server only -->
+	///            <sessionCacheSize>0..n</sessionCacheSize>
 	///            <sessionTimeout>0..n</sessionTimeout>           <!-- server only -->
 	///            <extendedVerification>true|false</extendedVerification>
 	///            <requireTLSv1>true|false</requireTLSv1>
@@ -149,6 +149,8 @@ class NetSSL_API SSLManager
 	///      sessions. The default size (according to OpenSSL documentation) is 1024*20, which may be too 
 	///      large for many applications, especially on embedded platforms with limited memory.
 	///      Specifying a size of 0 will set an unlimited cache size.
+	///      For a client, sets the maximum number of peers for which the last session is
+	///      kept for automatic resumption (default 1024).
 	///    - sessionTimeout (integer):  Sets the timeout (in seconds) of cached sessions on the server.
 	///    - extendedVerification (boolean): Enable or disable the automatic post-connection
 	///      extended certificate verification.
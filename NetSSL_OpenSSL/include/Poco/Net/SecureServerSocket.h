@@ -149,6 +149,24 @@ public:
 
 	Context::Ptr context() const;
 		/// Returns the SSL context used by this socket.
+
+	void setContext(Context::Ptr pContext);
+		/// Replaces the SSL context used by this socket, e.g.
+		/// to put a renewed certificate into service without
+		/// restarting the server. pContext must be a server context.
+		///
+		/// Connections accepted after this call use the new
+		/// context. Connections accepted earlier, including any
+		/// in progress, keep using the previous context.
+		///
+		/// Can be called from any thread while a TCPServer or
+		/// HTTPServer accepts connections on this socket. Note that
+		/// sessions cached by the previous context are not carried
+		/// over unless both contexts share an external SessionCache
+		/// or SessionTicketKeyManager. The same applies to a
+		/// HandshakePool.
+		///
+		/// See also CertificateReloader.
 };
 
 
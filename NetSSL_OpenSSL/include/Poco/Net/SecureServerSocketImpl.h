@@ -69,6 +69,19 @@ public:
 		/// with the client.
 		///
 		/// The client socket's address is returned in clientAddr.
+		///
+		/// If a HandshakePool has been set for the Context, accepted
+		/// connections are passed to the pool, and only connections
+		/// whose handshake has completed are returned.
+	
+	bool poll(const Poco::Timespan& timeout, int mode);
+		/// Determines the status of the socket, using a 
+		/// call to select().
+		///
+		/// If a HandshakePool has been set for the Context and
+		/// mode is SELECT_READ, returns true iff a connection whose
+		/// handshake has completed is ready to be returned by
+		/// acceptConnection().
 	
 	void connect(const SocketAddress& address);
 		/// Not supported by this kind of socket.
@@ -140,6 +153,10 @@ public:
 	Context::Ptr context() const;
 		/// Returns the SSL context used by this socket.
 
+	void setContext(Context::Ptr pContext);
+		/// Replaces the SSL context used for connections
+		/// accepted from now on.
+
 protected:
 	~SecureServerSocketImpl();
 		/// Destroys the SecureServerSocketImpl.
@@ -148,8 +165,20 @@ private:
 	SecureServerSocketImpl(const SecureServerSocketImpl&);
 	SecureServerSocketImpl& operator = (const SecureServerSocketImpl&);
 
+	class ReadyQueue;
+
+	void acceptPending(HandshakePool::Ptr pPool);
+		/// Accepts all pending connections and passes them
+		/// to the HandshakePool.
+
+	void waitForActivity(const Poco::Timespan& timeout);
+		/// Waits until a connection is pending on the listening
+		/// socket, a handshake has been completed, or the
+		/// timeout expires.
+
 private:
 	SecureSocketImpl _impl;
+	Poco::AutoPtr<ReadyQueue> _pReadyQueue;
 };
 
 
@@ -162,6 +191,12 @@ inline Context::Ptr SecureServerSocketImpl::context() const
 }
 
 
+inline void SecureServerSocketImpl::setContext(Context::Ptr pContext)
+{
+	_impl.setContext(pContext);
+}
+
+
 } } // namespace Poco::Net
 
 
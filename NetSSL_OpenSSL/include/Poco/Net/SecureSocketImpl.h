@@ -45,6 +45,7 @@
 #include "Poco/Net/Context.h"
 #include "Poco/Net/X509Certificate.h"
 #include "Poco/Net/Session.h"
+#include "Poco/Mutex.h"
 #include <openssl/bio.h>
 #include <openssl/ssl.h>
 
@@ -139,6 +140,13 @@ public:
 		///
 		/// Returns the number of bytes sent, which may be
 		/// less than the number of bytes specified.
+
+	Poco::Int64 sendFile(const std::string& path, Poco::UInt64 offset, Poco::UInt64 count);
+		/// Sends a part of the given file without copying it to
+		/// user space, if kernel TLS is active for the connection.
+		///
+		/// Returns the number of bytes sent, or -1 if kernel TLS
+		/// is not active, in which case nothing has been sent.
 	
 	int receiveBytes(void* buffer, int length, int flags = 0);
 		/// Receives data from the socket and stores it
@@ -156,6 +164,18 @@ public:
 		/// If the SSL connection was the result of an accept(),
 		/// the server-side handshake is completed, otherwise
 		/// a client-side handshake is performed. 
+		///
+		/// Returns 1 if the handshake is complete (in which case
+		/// the peer certificate has also been verified), or
+		/// SecureStreamSocket::ERR_SSL_WANT_READ or ERR_SSL_WANT_WRITE
+		/// if a non-blocking socket must become readable or
+		/// writable before the handshake can proceed.
+
+	void setBlocking(bool flag);
+		/// Sets the blocking mode of the underlying socket.
+
+	bool getBlocking() const;
+		/// Returns the blocking mode of the underlying socket.
 		
 	poco_socket_t sockfd();
 		/// Returns the underlying socket descriptor.
@@ -166,6 +186,13 @@ public:
 	Context::Ptr context() const;
 		/// Returns the SSL context used for this socket.
 
+	void setContext(Context::Ptr pContext);
+		/// Replaces the SSL context used for connections
+		/// accepted from now on.
+		///
+		/// Must only be called for a listening (server) socket.
+		/// Can be called while another thread accepts connections.
+
 	void verifyPeerCertificate();
 		/// Performs post-connect (or post-accept) peer certificate validation,
 		/// using the peer host name set with setPeerHostName(), or the peer's
@@ -190,8 +217,9 @@ public:
 		
 	void useSession(Session::Ptr pSession);
 		/// Sets the SSL session to use for the next
-		/// connection. Setting a previously saved Session
-		/// object is necessary to enable session caching.
+		/// connection. If session caching is enabled for the
+		/// Context, and no session has been set, the session last
+		/// negotiated with the same peer is used automatically.
 		///
 		/// To remove the currently set session, a null pointer
 		/// can be given.
@@ -201,6 +229,10 @@ public:
 	bool sessionWasReused();
 		/// Returns true iff a reused session was negotiated during
 		/// the handshake.
+
+	bool kernelTLSActive() const;
+		/// Returns true iff encryption of sent data has been
+		/// offloaded to the kernel (see Context::enableKernelTLS()).
 		
 protected:
 	void acceptSSL();
@@ -229,6 +261,26 @@ protected:
 		/// Note that simply closing a socket is not sufficient
 		/// to be able to re-use it again.
 
+	void setSessionPeer(const SocketAddress& address);
+		/// Sets the key under which the session negotiated with
+		/// the given peer is kept in the Context's client session cache.
+
+	void updateSessionCache();
+		/// Stores the session negotiated by a successful client-side
+		/// handshake in the Context's client session cache, if
+		/// session caching is enabled.
+
+	void startKernelTLS();
+		/// Hands the negotiated keys for sending to the kernel,
+		/// if kernel TLS has been enabled for the Context and is
+		/// supported for the connection.
+
+	int sendKernelTLS(const void* buffer, int length);
+		/// Sends data over a socket using kernel TLS.
+
+	void shutdownKernelTLS();
+		/// Sends a close_notify alert over a socket using kernel TLS.
+
 private:	
 	SecureSocketImpl(const SecureSocketImpl&);
 	SecureSocketImpl& operator = (const SecureSocketImpl&);
@@ -239,6 +291,9 @@ private:
 	bool _needHandshake;
 	std::string _peerHostName;
 	Session::Ptr _pSession;
+	std::string _sessionPeer;
+	bool _kernelTLS;
+	mutable Poco::FastMutex _contextMutex;
 	
 	friend class SecureStreamSocketImpl;
 };
@@ -253,9 +308,9 @@ inline poco_socket_t SecureSocketImpl::sockfd()
 }
 
 
-inline Context::Ptr SecureSocketImpl::context() const
+inline bool SecureSocketImpl::kernelTLSActive() const
 {
-	return _pContext;
+	return _kernelTLS;
 }
 
 
@@ -0,0 +1,253 @@
+//
+// SecureSocketReactorHandler.h
+//
+// $Id: //poco/1.4/NetSSL_OpenSSL/include/Poco/Net/SecureSocketReactorHandler.h#1 $
+//
+// Library: NetSSL_OpenSSL
+// Package: SSLSockets
+// Module:  SecureSocketReactorHandler
+//
+// Definition of the SecureSocketReactorHandler class.
+//
+// Copyright (c) 2013, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+// 
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+
+
+
+#ifndef NetSSL_SecureSocketReactorHandler_INCLUDED
+#define NetSSL_SecureSocketReactorHandler_INCLUDED
+
+
+#include "Poco/Net/NetSSL.h"
+#include "Poco/Net/SecureStreamSocket.h"
+#include "Poco/Net/SocketReactor.h"
+#include "Poco/Net/SocketNotification.h"
+#include "Poco/Buffer.h"
+#include "Poco/Timespan.h"
+#include "Poco/Exception.h"
+#include <string>
+
+
+namespace Poco {
+namespace Net {
+
+
+class NetSSL_API SecureSocketReactorHandler
+	/// SecureSocketReactorHandler is the base class for event handlers
+	/// that serve a SecureStreamSocket from a SocketReactor, without
+	/// blocking the reactor thread during the SSL/TLS handshake or
+	/// during I/O.
+	///
+	/// The handler puts the socket into non-blocking mode and drives
+	/// the handshake, reading and writing as a state machine. Whenever
+	/// the SSL layer reports that it needs the socket to become readable
+	/// (ERR_SSL_WANT_READ) or writable (ERR_SSL_WANT_WRITE) to make
+	/// progress, the handler registers for the corresponding reactor
+	/// notification, and resumes the interrupted operation when it arrives.
+	/// This includes the case where a read must wait for the socket
+	/// to become writable, or vice versa (e.g., during a renegotiation).
+	/// Reading continues until the SSL layer runs out of buffered data,
+	/// so that no decrypted data is left behind unnoticed by the reactor.
+	///
+	/// Subclasses implement onData(), and optionally onHandshake(),
+	/// onClose() and onError(). Data is sent with send(), which buffers
+	/// everything that cannot be written immediately.
+	///
+	/// SecureSocketReactorHandler follows the conventions for service
+	/// handlers used with SocketAcceptor: it is constructed with a
+	/// StreamSocket and a SocketReactor, must be created with new and
+	/// deletes itself when the connection has been closed.
+	/// A SocketAcceptor with a SecureServerSocket can therefore be used
+	/// to implement a reactor-based SSL/TLS server.
+	/// For a client, create a SecureStreamSocket, call connectNB() and
+	/// pass the socket to the handler.
+	///
+	/// All methods must be called from the reactor thread (usually,
+	/// from within one of the virtual event handling methods).
+{
+public:
+	SecureSocketReactorHandler(const StreamSocket& socket, SocketReactor& reactor);
+		/// Creates the SecureSocketReactorHandler for the given
+		/// socket, which must be a SecureStreamSocket, and
+		/// registers it with the reactor.
+		///
+		/// Throws an InvalidArgumentException if the socket is not
+		/// a SecureStreamSocket.
+
+	virtual ~SecureSocketReactorHandler();
+		/// Unregisters the handler from the reactor.
+
+	void send(const void* buffer, int length);
+		/// Sends the given data, or buffers it until the socket
+		/// becomes writable. Data sent before the handshake has
+		/// been completed is sent afterwards.
+
+	void close();
+		/// Closes the connection after all buffered data has been
+		/// sent. Afterwards, onClose() is called and the handler
+		/// deletes itself.
+
+	void setHandshakeTimeout(const Poco::Timespan& timeout);
+		/// Sets the maximum time the handshake may take, counted
+		/// from now. If the handshake has not been completed when
+		/// the timeout expires, onError() is called with a
+		/// TimeoutException and the connection is closed.
+		///
+		/// By default, there is no handshake timeout.
+
+	bool handshakeComplete() const;
+		/// Returns true iff the SSL/TLS handshake has been completed.
+
+	std::size_t pendingOutput() const;
+		/// Returns the number of bytes buffered by send() that have
+		/// not been sent yet.
+
+	SecureStreamSocket& socket();
+		/// Returns the socket.
+
+	SocketReactor& reactor();
+		/// Returns the reactor.
+
+protected:
+	virtual void onHandshake();
+		/// Called when the handshake has been completed and the
+		/// peer certificate has been verified.
+		///
+		/// The default implementation does nothing.
+
+	virtual void onData(const char* data, int length) = 0;
+		/// Called for every chunk of data received from the peer.
+
+	virtual void onClose();
+		/// Called when the connection has been closed, either by
+		/// the peer, by close(), as the result of an error, or
+		/// because the reactor is shutting down. The handler is
+		/// deleted afterwards.
+		///
+		/// The default implementation does nothing.
+
+	virtual void onError(const Poco::Exception& exc);
+		/// Called if the handshake fails (including certificate
+		/// verification), or an I/O error occurs. The connection
+		/// is closed afterwards.
+		///
+		/// The default implementation does nothing.
+
+private:
+	enum
+	{
+		BUFFER_SIZE = 16384 // maximum SSL/TLS record size
+	};
+
+	enum State
+	{
+		STATE_HANDSHAKE,
+		STATE_ESTABLISHED,
+		STATE_CLOSING,
+		STATE_CLOSED
+	};
+
+	enum Want
+	{
+		WANT_NONE,
+		WANT_READ,
+		WANT_WRITE
+	};
+
+	SecureSocketReactorHandler();
+	SecureSocketReactorHandler(const SecureSocketReactorHandler&);
+	SecureSocketReactorHandler& operator = (const SecureSocketReactorHandler&);
+
+	void onReadable(ReadableNotification* pNf);
+	void onWritable(WritableNotification* pNf);
+	void onSocketError(ErrorNotification* pNf);
+	void onShutdown(ShutdownNotification* pNf);
+	void onHandshakeTimeout(TimerNotification* pNf);
+
+	void process();
+		/// Advances the state machine as far as possible without
+		/// blocking, then updates the reactor registrations, or
+		/// deletes the handler if the connection has been closed.
+
+	void step();
+	bool handshake();
+	bool receive();
+	void flush();
+	void updateRegistration();
+	void cancelHandshakeTimer();
+	void finish();
+
+	static Want want(int rc);
+
+	SecureStreamSocket     _socket;
+	SocketReactor&         _reactor;
+	State                  _state;
+	Want                   _handshakeWants;
+	Want                   _readWants;
+	Want                   _writeWants;
+	bool                   _handshakeComplete;
+	bool                   _readableRegistered;
+	bool                   _writableRegistered;
+	bool                   _processing;
+	Poco::Buffer<char>     _buffer;
+	std::string            _output;
+	std::string::size_type _outputOffset;
+	TimerWheel::Timer::Ptr _pHandshakeTimer;
+};
+
+
+//
+// inlines
+//
+inline bool SecureSocketReactorHandler::handshakeComplete() const
+{
+	return _handshakeComplete;
+}
+
+
+inline std::size_t SecureSocketReactorHandler::pendingOutput() const
+{
+	return _output.size() - _outputOffset;
+}
+
+
+inline SecureStreamSocket& SecureSocketReactorHandler::socket()
+{
+	return _socket;
+}
+
+
+inline SocketReactor& SecureSocketReactorHandler::reactor()
+{
+	return _reactor;
+}
+
+
+} } // namespace Poco::Net
+
+
+#endif // NetSSL_SecureSocketReactorHandler_INCLUDED
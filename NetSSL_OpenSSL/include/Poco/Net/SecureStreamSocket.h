@@ -59,18 +59,23 @@ class NetSSL_API SecureStreamSocket: public StreamSocket
 	/// negative value when using a nonblocking socket, which means 
 	/// a SSL handshake is currently in progress and more data
 	/// needs to be read or written for the handshake to continue.
-	/// If sendBytes() or receiveBytes() return ERR_SSL_WANT_WRITE,
-	/// sendBytes() must be called as soon as possible (usually, after
-	/// select() indicates that data can be written). Likewise, if
-	/// ERR_SSL_WANT_READ is returned, receiveBytes() must be called
+	/// If an operation returns ERR_SSL_WANT_WRITE, it must be repeated
+	/// as soon as the socket becomes writable (as indicated by select()),
+	/// even if the operation is receiveBytes(). Likewise, if
+	/// ERR_SSL_WANT_READ is returned, the operation must be repeated
 	/// as soon as data is available for reading (indicated by select()).
+	/// Since the SSL layer buffers received data, receiveBytes() should
+	/// be called until it returns ERR_SSL_WANT_READ before waiting
+	/// for the socket to become readable again.
 	///
 	/// The SSL handshake is delayed until the first sendBytes() or 
-	/// receiveBytes() operation is performed on the socket. No automatic
-	/// post connection check (checking the peer certificate for a valid
-	/// hostname) is performed when using nonblocking I/O. To manually
-	/// perform peer certificate validation, call verifyPeerCertificate()
-	/// after the SSL handshake has been completed.
+	/// receiveBytes() operation is performed on the socket, or until
+	/// completeHandshake() is called. The automatic post connection check
+	/// (checking the peer certificate for a valid hostname) is performed
+	/// when the handshake has been completed.
+	///
+	/// SecureSocketReactorHandler implements all of the above for
+	/// sockets served by a SocketReactor.
 {
 public:
 	enum
@@ -276,6 +281,12 @@ public:
 	bool sessionWasReused();
 		/// Returns true iff a reused session was negotiated during
 		/// the handshake.
+
+	bool kernelTLSActive() const;
+		/// Returns true iff encryption of sent data has been
+		/// offloaded to the kernel, which allows sendFile() to
+		/// transmit files without copying them to user space.
+		/// See Context::enableKernelTLS() for more information.
 		
 	void abort();
 		/// Aborts the SSL connection by closing the underlying
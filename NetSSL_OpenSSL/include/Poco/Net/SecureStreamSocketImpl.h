@@ -102,6 +102,13 @@ public:
 		///
 		/// Returns the number of bytes sent, which may be
 		/// less than the number of bytes specified.
+
+	Poco::Int64 sendFile(const std::string& path, Poco::UInt64 offset, Poco::UInt64 count);
+		/// Sends a part of the given file without copying it to
+		/// user space, if kernel TLS is active for the connection.
+		///
+		/// Returns the number of bytes sent, or -1 if kernel TLS
+		/// is not active, in which case nothing has been sent.
 	
 	int receiveBytes(void* buffer, int length, int flags = 0);
 		/// Receives data from the socket and stores it
@@ -132,6 +139,17 @@ public:
 		/// can be read from the currently buffered SSL record,
 		/// before a new record is read from the underlying socket.
 
+	void setBlocking(bool flag);
+		/// Sets the socket in blocking mode if flag is true,
+		/// disables blocking mode if flag is false.
+		///
+		/// The SSL layer returns SecureStreamSocket::ERR_SSL_WANT_READ
+		/// or ERR_SSL_WANT_WRITE from sendBytes(), receiveBytes() and
+		/// completeHandshake() for a non-blocking socket.
+
+	bool getBlocking() const;
+		/// Returns the blocking mode of the socket.
+
 	void shutdownReceive();
 		/// Shuts down the receiving part of the socket connection.
 		///
@@ -217,6 +235,10 @@ public:
 	bool sessionWasReused();
 		/// Returns true iff a reused session was negotiated during
 		/// the handshake.
+
+	bool kernelTLSActive() const;
+		/// Returns true iff encryption of sent data has been
+		/// offloaded to the kernel (see Context::enableKernelTLS()).
 		
 protected:
 	void acceptSSL();
@@ -285,6 +307,12 @@ inline bool SecureStreamSocketImpl::sessionWasReused()
 }
 
 
+inline bool SecureStreamSocketImpl::kernelTLSActive() const
+{
+	return _impl.kernelTLSActive();
+}
+
+
 inline int SecureStreamSocketImpl::lastError()
 {
 	return SocketImpl::lastError();
@@ -0,0 +1,157 @@
+//
+// SessionCache.h
+//
+// $Id: //poco/1.4/NetSSL_OpenSSL/include/Poco/Net/SessionCache.h#1 $
+//
+// Library: NetSSL_OpenSSL
+// Package: SSLCore
+// Module:  SessionCache
+//
+// Definition of the SessionCache class.
+//
+// Copyright (c) 2013, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+// 
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+
+
+
+#ifndef NetSSL_SessionCache_INCLUDED
+#define NetSSL_SessionCache_INCLUDED
+
+
+#include "Poco/Net/NetSSL.h"
+#include "Poco/RefCountedObject.h"
+#include "Poco/AutoPtr.h"
+#include "Poco/AtomicCounter.h"
+#include "Poco/Timestamp.h"
+
+
+namespace Poco {
+namespace Net {
+
+
+class NetSSL_API SessionCache: public Poco::RefCountedObject
+	/// This is the base class for external server-side
+	/// SSL/TLS session caches.
+	///
+	/// OpenSSL's built-in session cache is private to a single
+	/// SSL_CTX, and thus to a single process. An external session
+	/// cache, installed with Context::setSessionCache(), can be
+	/// shared by several Context objects, processes or even hosts,
+	/// so that a client can resume its session with any of the
+	/// servers sharing the cache.
+	///
+	/// Sessions are passed to and from the cache in serialized
+	/// (DER) form, keyed by the session ID.
+	///
+	/// Subclasses implement addImpl(), getImpl() and removeImpl().
+	/// These must be thread-safe, as they are called from
+	/// all threads performing handshakes.
+{
+public:
+	typedef Poco::AutoPtr<SessionCache> Ptr;
+
+	void add(const std::string& id, const std::string& session, const Poco::Timestamp& expires);
+		/// Adds the serialized session with the given ID to the cache,
+		/// replacing an existing session with the same ID.
+		/// The session must not be returned by get() after
+		/// the given expiration time.
+
+	bool get(const std::string& id, std::string& session);
+		/// Looks up the session with the given ID.
+		///
+		/// Returns true and stores the serialized session in session
+		/// if the session has been found, or false otherwise.
+
+	void remove(const std::string& id);
+		/// Removes the session with the given ID from the cache.
+
+	int hits() const;
+		/// Returns the number of successful lookups.
+
+	int misses() const;
+		/// Returns the number of failed lookups.
+
+	int stores() const;
+		/// Returns the number of sessions stored in the cache.
+
+	void resetStatistics();
+		/// Resets the hit, miss and store counters.
+
+protected:
+	SessionCache();
+		/// Creates the SessionCache.
+
+	virtual ~SessionCache();
+		/// Destroys the SessionCache.
+
+	virtual bool addImpl(const std::string& id, const std::string& session, const Poco::Timestamp& expires) = 0;
+		/// Stores the session. Returns false if the
+		/// session could not be stored, e.g. because it
+		/// is too large.
+
+	virtual bool getImpl(const std::string& id, std::string& session) = 0;
+		/// Looks up the session. Expired sessions must not
+		/// be returned.
+
+	virtual void removeImpl(const std::string& id) = 0;
+		/// Removes the session.
+
+private:
+	SessionCache(const SessionCache&);
+	SessionCache& operator = (const SessionCache&);
+
+	Poco::AtomicCounter _hits;
+	Poco::AtomicCounter _misses;
+	Poco::AtomicCounter _stores;
+};
+
+
+//
+// inlines
+//
+inline int SessionCache::hits() const
+{
+	return _hits.value();
+}
+
+
+inline int SessionCache::misses() const
+{
+	return _misses.value();
+}
+
+
+inline int SessionCache::stores() const
+{
+	return _stores.value();
+}
+
+
+} } // namespace Poco::Net
+
+
+#endif // NetSSL_SessionCache_INCLUDED
@@ -0,0 +1,220 @@
+//
+// SessionTicketKeyManager.h
+//
+// $Id: //poco/1.4/NetSSL_OpenSSL/include/Poco/Net/SessionTicketKeyManager.h#1 $
+//
+// Library: NetSSL_OpenSSL
+// Package: SSLCore
+// Module:  SessionTicketKeyManager
+//
+// Definition of the SessionTicketKeyManager class.
+//
+// Copyright (c) 2013, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+// 
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+
+
+
+#ifndef NetSSL_SessionTicketKeyManager_INCLUDED
+#define NetSSL_SessionTicketKeyManager_INCLUDED
+
+
+#include "Poco/Net/NetSSL.h"
+#include "Poco/RefCountedObject.h"
+#include "Poco/AutoPtr.h"
+#include "Poco/AtomicCounter.h"
+#include "Poco/Mutex.h"
+#include "Poco/Timespan.h"
+#include "Poco/Timestamp.h"
+#include <vector>
+
+
+namespace Poco {
+namespace Net {
+
+
+class NetSSL_API SessionTicketKeyManager: public Poco::RefCountedObject
+	/// SessionTicketKeyManager provides and rotates the keys
+	/// used by a server to encrypt and authenticate RFC 5077
+	/// session tickets (stateless session resumption).
+	///
+	/// Time is divided into periods of rotationInterval() length.
+	/// Each period has its own key, which is used to encrypt
+	/// all tickets issued during that period. Tickets encrypted
+	/// with the keys of the previous keyCount() - 1 periods are
+	/// still accepted, but are replaced by a new ticket; older
+	/// tickets fall back to a full handshake.
+	///
+	/// The keys are derived from a secret using HMAC-SHA256.
+	/// All servers constructed with the same secret and rotation
+	/// interval (and reasonably synchronized clocks) therefore
+	/// use the same keys at the same time, without further
+	/// coordination, and can resume each other's sessions.
+	/// The secret must be kept as confidential as a private key,
+	/// and should itself be replaced from time to time.
+	///
+	/// Install a SessionTicketKeyManager with
+	/// Context::setSessionTicketKeyManager().
+{
+public:
+	typedef Poco::AutoPtr<SessionTicketKeyManager> Ptr;
+
+	enum
+	{
+		NAME_SIZE   = 16,
+		KEY_SIZE    = 16,
+		SECRET_SIZE = 32
+	};
+
+	struct Key
+	{
+		unsigned char name[NAME_SIZE];
+		unsigned char hmacKey[KEY_SIZE];
+		unsigned char aesKey[KEY_SIZE];
+	};
+
+	explicit SessionTicketKeyManager(const Poco::Timespan& rotationInterval = Poco::Timespan(3600, 0), int keyCount = 2);
+		/// Creates a SessionTicketKeyManager using a random secret.
+		///
+		/// The keys are only known to this object, which
+		/// can, however, be shared by several Context objects.
+
+	SessionTicketKeyManager(const std::string& secret, const Poco::Timespan& rotationInterval = Poco::Timespan(3600, 0), int keyCount = 2);
+		/// Creates a SessionTicketKeyManager deriving its keys
+		/// from the given secret, which should contain at least
+		/// SECRET_SIZE random bytes.
+
+	const Poco::Timespan& rotationInterval() const;
+		/// Returns the time after which a new key is used.
+
+	int keyCount() const;
+		/// Returns the number of keys accepted for decryption,
+		/// including the current key.
+
+	void encryptionKey(Key& key);
+		/// Returns the key for encrypting a new ticket.
+
+	bool decryptionKey(const unsigned char* name, Key& key, bool& renew);
+		/// Looks up the key with the given name (NAME_SIZE bytes).
+		///
+		/// Returns false if no such key exists (anymore).
+		/// Otherwise, stores the key in key and sets renew
+		/// to true if the ticket was not encrypted with
+		/// the current key.
+
+	int ticketsIssued() const;
+		/// Returns the number of tickets issued.
+
+	int ticketsAccepted() const;
+		/// Returns the number of presented tickets encrypted with
+		/// the current key.
+
+	int ticketsRenewed() const;
+		/// Returns the number of presented tickets encrypted with
+		/// a previous key.
+
+	int ticketsRejected() const;
+		/// Returns the number of presented tickets encrypted with
+		/// an unknown or expired key.
+
+	void resetStatistics();
+		/// Resets all counters.
+
+protected:
+	~SessionTicketKeyManager();
+
+	Poco::Int64 period(const Poco::Timestamp& time) const;
+		/// Returns the number of the rotation period
+		/// containing the given time.
+
+	void update();
+		/// Makes sure that the keys for the current period
+		/// and the previous ones are available.
+		/// Must be called with the mutex locked.
+
+	Key deriveKey(Poco::Int64 period) const;
+		/// Derives the key for the given period from the secret.
+
+private:
+	SessionTicketKeyManager(const SessionTicketKeyManager&);
+	SessionTicketKeyManager& operator = (const SessionTicketKeyManager&);
+
+	std::string         _secret;
+	Poco::Timespan      _rotationInterval;
+	int                 _keyCount;
+	Poco::Int64         _period;
+	std::vector<Key>    _keys;
+	Poco::FastMutex     _mutex;
+	Poco::AtomicCounter _issued;
+	Poco::AtomicCounter _accepted;
+	Poco::AtomicCounter _renewed;
+	Poco::AtomicCounter _rejected;
+};
+
+
+//
+// inlines
+//
+inline const Poco::Timespan& SessionTicketKeyManager::rotationInterval() const
+{
+	return _rotationInterval;
+}
+
+
+inline int SessionTicketKeyManager::keyCount() const
+{
+	return _keyCount;
+}
+
+
+inline int SessionTicketKeyManager::ticketsIssued() const
+{
+	return _issued.value();
+}
+
+
+inline int SessionTicketKeyManager::ticketsAccepted() const
+{
+	return _accepted.value();
+}
+
+
+inline int SessionTicketKeyManager::ticketsRenewed() const
+{
+	return _renewed.value();
+}
+
+
+inline int SessionTicketKeyManager::ticketsRejected() const
+{
+	return _rejected.value();
+}
+
+
+} } // namespace Poco::Net
+
+
+#endif // NetSSL_SessionTicketKeyManager_INCLUDED
@@ -0,0 +1,157 @@
+//
+// SharedMemorySessionCache.h
+//
+// $Id: //poco/1.4/NetSSL_OpenSSL/include/Poco/Net/SharedMemorySessionCache.h#1 $
+//
+// Library: NetSSL_OpenSSL
+// Package: SSLCore
+// Module:  SharedMemorySessionCache
+//
+// Definition of the SharedMemorySessionCache class.
+//
+// Copyright (c) 2013, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+// 
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+
+
+
+#ifndef NetSSL_SharedMemorySessionCache_INCLUDED
+#define NetSSL_SharedMemorySessionCache_INCLUDED
+
+
+#include "Poco/Net/NetSSL.h"
+#include "Poco/Net/SessionCache.h"
+#include "Poco/SharedMemory.h"
+#include "Poco/NamedMutex.h"
+
+
+namespace Poco {
+namespace Net {
+
+
+class NetSSL_API SharedMemorySessionCache: public SessionCache
+	/// A SessionCache that stores sessions in a named
+	/// shared memory segment, so that it can be shared by
+	/// all processes on the same host.
+	///
+	/// The cache consists of a fixed number of fixed-size
+	/// slots. A session is stored in one of the PROBE_COUNT
+	/// slots following the slot given by the hash of its ID.
+	/// If all of these are occupied by unexpired sessions, the
+	/// session expiring first is evicted. Sessions larger than
+	/// the slot size (e.g., sessions carrying large client
+	/// certificate chains) are not cached.
+	///
+	/// Access to the shared memory is serialized with a
+	/// Poco::NamedMutex.
+	///
+	/// One process (typically the one starting the others)
+	/// creates the cache, passing true for owner. The other
+	/// processes attach to it, passing false for owner and
+	/// the same slot count and size.
+{
+public:
+	enum
+	{
+		DEFAULT_SLOT_COUNT = 8192,
+		DEFAULT_SLOT_SIZE  = 2048,
+		MAX_ID_LENGTH      = 32,
+		PROBE_COUNT        = 8
+	};
+
+	SharedMemorySessionCache(const std::string& name, std::size_t slotCount = DEFAULT_SLOT_COUNT, std::size_t slotSize = DEFAULT_SLOT_SIZE, bool owner = true);
+		/// Creates or attaches to the shared memory session
+		/// cache with the given name.
+		///
+		/// If owner is true, the shared memory segment is created
+		/// (or re-initialized, if it already exists) and removed
+		/// again when the SharedMemorySessionCache is destroyed.
+		///
+		/// If owner is false, the shared memory segment must
+		/// have been created by another process, using the
+		/// same slot count and size.
+
+	const std::string& name() const;
+		/// Returns the name of the shared memory segment.
+
+	std::size_t slotCount() const;
+		/// Returns the number of slots.
+
+	std::size_t slotSize() const;
+		/// Returns the maximum size of a serialized session.
+
+	void clear();
+		/// Removes all sessions from the cache.
+
+protected:
+	~SharedMemorySessionCache();
+
+	bool addImpl(const std::string& id, const std::string& session, const Poco::Timestamp& expires);
+	bool getImpl(const std::string& id, std::string& session);
+	void removeImpl(const std::string& id);
+
+private:
+	struct Header;
+	struct Slot;
+
+	static std::size_t stride(std::size_t slotSize);
+	Slot* slot(std::size_t index) const;
+	std::size_t hash(const std::string& id) const;
+	Slot* find(const std::string& id) const;
+
+	std::string        _name;
+	std::size_t        _slotCount;
+	std::size_t        _slotSize;
+	Poco::NamedMutex   _mutex;
+	Poco::SharedMemory _memory;
+};
+
+
+//
+// inlines
+//
+inline const std::string& SharedMemorySessionCache::name() const
+{
+	return _name;
+}
+
+
+inline std::size_t SharedMemorySessionCache::slotCount() const
+{
+	return _slotCount;
+}
+
+
+inline std::size_t SharedMemorySessionCache::slotSize() const
+{
+	return _slotSize;
+}
+
+
+} } // namespace Poco::Net
+
+
+#endif // NetSSL_SharedMemorySessionCache_INCLUDED
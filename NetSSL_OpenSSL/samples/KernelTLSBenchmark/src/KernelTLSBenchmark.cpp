@@ -0,0 +1,236 @@
+//
+// KernelTLSBenchmark.cpp
+//
+// $Id: //poco/1.4/NetSSL_OpenSSL/samples/KernelTLSBenchmark/src/KernelTLSBenchmark.cpp#1 $
+//
+// This sample measures the throughput of HTTPS file downloads over a
+// loopback connection, with and without kernel TLS offload.
+//
+// Copyright (c) 2013, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+// 
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+
+#include "Poco/Net/HTTPServer.h"
+#include "Poco/Net/HTTPServerParams.h"
+#include "Poco/Net/HTTPRequestHandler.h"
+#include "Poco/Net/HTTPRequestHandlerFactory.h"
+#include "Poco/Net/HTTPServerRequest.h"
+#include "Poco/Net/HTTPServerRequestImpl.h"
+#include "Poco/Net/HTTPServerResponse.h"
+#include "Poco/Net/HTTPSClientSession.h"
+#include "Poco/Net/HTTPRequest.h"
+#include "Poco/Net/HTTPResponse.h"
+#include "Poco/Net/SecureServerSocket.h"
+#include "Poco/Net/SecureStreamSocket.h"
+#include "Poco/Net/PrivateKeyPassphraseHandler.h"
+#include "Poco/Net/Context.h"
+#include "Poco/TemporaryFile.h"
+#include "Poco/FileStream.h"
+#include "Poco/Stopwatch.h"
+#include "Poco/Buffer.h"
+#include "Poco/AtomicCounter.h"
+#include "Poco/NumberParser.h"
+#include "Poco/Exception.h"
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <cstring>
+
+
+using Poco::Net::HTTPServer;
+using Poco::Net::HTTPServerParams;
+using Poco::Net::HTTPRequestHandler;
+using Poco::Net::HTTPRequestHandlerFactory;
+using Poco::Net::HTTPServerRequest;
+using Poco::Net::HTTPServerRequestImpl;
+using Poco::Net::HTTPServerResponse;
+using Poco::Net::HTTPSClientSession;
+using Poco::Net::HTTPRequest;
+using Poco::Net::HTTPResponse;
+using Poco::Net::HTTPMessage;
+using Poco::Net::SecureServerSocket;
+using Poco::Net::SecureStreamSocket;
+using Poco::Net::SocketAddress;
+using Poco::Net::PrivateKeyPassphraseHandler;
+using Poco::Net::Context;
+using Poco::TemporaryFile;
+using Poco::FileOutputStream;
+using Poco::Stopwatch;
+using Poco::Buffer;
+using Poco::AtomicCounter;
+using Poco::NumberParser;
+using Poco::Exception;
+
+
+class PassphraseHandler: public PrivateKeyPassphraseHandler
+	/// Supplies the passphrase given on the command line.
+{
+public:
+	PassphraseHandler(const std::string& passphrase):
+		PrivateKeyPassphraseHandler(true),
+		_passphrase(passphrase)
+	{
+	}
+	
+	void onPrivateKeyRequested(const void* pSender, std::string& privateKey)
+	{
+		privateKey = _passphrase;
+	}
+	
+private:
+	std::string _passphrase;
+};
+
+
+class FileRequestHandler: public HTTPRequestHandler
+	/// Sends the file and records whether kernel TLS was used.
+{
+public:
+	FileRequestHandler(const std::string& path, AtomicCounter& kernelTLSResponses):
+		_path(path),
+		_kernelTLSResponses(kernelTLSResponses)
+	{
+	}
+	
+	void handleRequest(HTTPServerRequest& request, HTTPServerResponse& response)
+	{
+		response.sendFile(_path, "application/octet-stream");
+		SecureStreamSocket socket(static_cast<HTTPServerRequestImpl&>(request).socket());
+		if (socket.kernelTLSActive()) ++_kernelTLSResponses;
+	}
+	
+private:
+	std::string _path;
+	AtomicCounter& _kernelTLSResponses;
+};
+
+
+class FileRequestHandlerFactory: public HTTPRequestHandlerFactory
+{
+public:
+	FileRequestHandlerFactory(const std::string& path, AtomicCounter& kernelTLSResponses):
+		_path(path),
+		_kernelTLSResponses(kernelTLSResponses)
+	{
+	}
+
+	HTTPRequestHandler* createRequestHandler(const HTTPServerRequest& request)
+	{
+		return new FileRequestHandler(_path, _kernelTLSResponses);
+	}
+	
+private:
+	std::string _path;
+	AtomicCounter& _kernelTLSResponses;
+};
+
+
+double measure(const std::string& keyFile, bool kernelTLS, const std::string& path, Poco::UInt64 size, int rounds, bool& offloaded)
+{
+	Context::Ptr pServerContext = new Context(Context::SERVER_USE, keyFile, keyFile, "", Context::VERIFY_NONE, 9, false, "AES128-GCM-SHA256:ALL:!ADH:!LOW:!EXP:!MD5:@STRENGTH");
+	pServerContext->enableKernelTLS(kernelTLS);
+	Context::Ptr pClientContext = new Context(Context::CLIENT_USE, "", Context::VERIFY_NONE);
+
+	AtomicCounter kernelTLSResponses;
+	SecureServerSocket svs(SocketAddress("127.0.0.1", 0), 64, pServerContext);
+	HTTPServer server(new FileRequestHandlerFactory(path, kernelTLSResponses), svs, new HTTPServerParams);
+	server.start();
+
+	HTTPSClientSession session("127.0.0.1", svs.address().port(), pClientContext);
+	session.setKeepAlive(true);
+	Buffer<char> buffer(65536);
+	Stopwatch sw;
+	sw.start();
+	for (int i = 0; i < rounds; ++i)
+	{
+		HTTPRequest request(HTTPRequest::HTTP_GET, "/", HTTPMessage::HTTP_1_1);
+		session.sendRequest(request);
+		HTTPResponse response;
+		std::istream& istr = session.receiveResponse(response);
+		Poco::UInt64 received = 0;
+		while (istr.read(buffer.begin(), static_cast<std::streamsize>(buffer.size())) || istr.gcount() > 0)
+		{
+			received += istr.gcount();
+		}
+		if (received != size) throw Poco::IOException("incomplete response");
+	}
+	sw.stop();
+	server.stop();
+	offloaded = kernelTLSResponses.value() == rounds;
+	return double(size*rounds)/(1024*1024)/(double(sw.elapsed())/Stopwatch::resolution());
+}
+
+
+int main(int argc, char** argv)
+{
+	if (argc < 2)
+	{
+		std::cout << "usage: KernelTLSBenchmark <pem-file> [<passphrase> [<megabytes>]]" << std::endl
+		          << "  <pem-file> must contain the server certificate and private key." << std::endl;
+		return 1;
+	}
+	std::string keyFile(argv[1]);
+	std::string passphrase(argc > 2 ? argv[2] : "");
+	Poco::UInt64 size = 64;
+	if (argc > 3 && !NumberParser::tryParseUnsigned64(argv[3], size))
+	{
+		std::cout << "invalid size: " << argv[3] << std::endl;
+		return 1;
+	}
+	size *= 1024*1024;
+	const int rounds = 8;
+
+	try
+	{
+		PassphraseHandler passphraseHandler(passphrase);
+		
+		TemporaryFile file;
+		{
+			FileOutputStream ostr(file.path());
+			Buffer<char> chunk(65536);
+			std::memset(chunk.begin(), 'x', chunk.size());
+			for (Poco::UInt64 written = 0; written < size; written += chunk.size())
+			{
+				ostr.write(chunk.begin(), static_cast<std::streamsize>(std::min<Poco::UInt64>(chunk.size(), size - written)));
+			}
+		}
+
+		std::cout << "Download throughput in MB/s, " << rounds << " x " << (size >> 20) << " MB" << std::endl << std::endl;
+		bool offloaded;
+		double userspace = measure(keyFile, false, file.path(), size, rounds, offloaded);
+		std::cout << std::setw(12) << "OpenSSL" << std::fixed << std::setprecision(1) << std::setw(12) << userspace << std::endl;
+		double kernel = measure(keyFile, true, file.path(), size, rounds, offloaded);
+		std::cout << std::setw(12) << "kTLS" << std::fixed << std::setprecision(1) << std::setw(12) << kernel;
+		if (!offloaded) std::cout << "  (not available, fell back to OpenSSL)";
+		std::cout << std::endl;
+	}
+	catch (Exception& exc)
+	{
+		std::cerr << exc.displayText() << std::endl;
+		return 1;
+	}
+	return 0;
+}
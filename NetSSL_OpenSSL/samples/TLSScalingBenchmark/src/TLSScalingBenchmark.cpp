@@ -0,0 +1,380 @@
+//
+// TLSScalingBenchmark.cpp
+//
+// $Id: //poco/1.4/NetSSL_OpenSSL/samples/TLSScalingBenchmark/src/TLSScalingBenchmark.cpp#1 $
+//
+// This sample measures how TLS handshakes and bulk encryption scale
+// with the number of threads.
+//
+// Handshakes and key generation draw from OpenSSL's random number
+// generator, which OpenSSL 1.0.x serializes under an exclusive lock
+// regardless of the locking callbacks, so the results do not show
+// any change in RNG contention.
+//
+// Copyright (c) 2013, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+// 
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+
+
+#include "Poco/Net/TCPServer.h"
+#include "Poco/Net/TCPServerParams.h"
+#include "Poco/Net/TCPServerConnection.h"
+#include "Poco/Net/TCPServerConnectionFactory.h"
+#include "Poco/Net/SecureServerSocket.h"
+#include "Poco/Net/SecureStreamSocket.h"
+#include "Poco/Net/PrivateKeyPassphraseHandler.h"
+#include "Poco/Net/Context.h"
+#include "Poco/Net/NetSSL.h"
+#include "Poco/Crypto/CipherFactory.h"
+#include "Poco/Crypto/Cipher.h"
+#include "Poco/Crypto/CipherKey.h"
+#include "Poco/Crypto/CryptoTransform.h"
+#include "Poco/Runnable.h"
+#include "Poco/Thread.h"
+#include "Poco/ThreadPool.h"
+#include "Poco/Event.h"
+#include "Poco/Stopwatch.h"
+#include "Poco/Buffer.h"
+#include "Poco/NumberParser.h"
+#include "Poco/Exception.h"
+#include <vector>
+#include <iostream>
+#include <iomanip>
+#include <cstring>
+
+
+using Poco::Net::TCPServer;
+using Poco::Net::TCPServerParams;
+using Poco::Net::TCPServerConnection;
+using Poco::Net::TCPServerConnectionFactoryImpl;
+using Poco::Net::SecureServerSocket;
+using Poco::Net::SecureStreamSocket;
+using Poco::Net::StreamSocket;
+using Poco::Net::SocketAddress;
+using Poco::Net::PrivateKeyPassphraseHandler;
+using Poco::Net::Context;
+using Poco::Crypto::CipherFactory;
+using Poco::Crypto::Cipher;
+using Poco::Crypto::CipherKey;
+using Poco::Crypto::CryptoTransform;
+using Poco::Runnable;
+using Poco::Thread;
+using Poco::ThreadPool;
+using Poco::Event;
+using Poco::Stopwatch;
+using Poco::Timespan;
+using Poco::Buffer;
+using Poco::NumberParser;
+using Poco::Exception;
+
+
+class SSLInitializer
+	/// Keeps OpenSSL initialized for the lifetime of the program,
+	/// so that it is not torn down and set up again whenever the
+	/// last Crypto or NetSSL object goes away.
+{
+public:
+	SSLInitializer()
+	{
+		Poco::Net::initializeSSL();
+	}
+	
+	~SSLInitializer()
+	{
+		Poco::Net::uninitializeSSL();
+	}
+};
+
+
+class PassphraseHandler: public PrivateKeyPassphraseHandler
+	/// Supplies the passphrase given on the command line.
+{
+public:
+	PassphraseHandler(const std::string& passphrase):
+		PrivateKeyPassphraseHandler(true),
+		_passphrase(passphrase)
+	{
+	}
+	
+	void onPrivateKeyRequested(const void* pSender, std::string& privateKey)
+	{
+		privateKey = _passphrase;
+	}
+	
+private:
+	std::string _passphrase;
+};
+
+
+class HandshakeConnection: public TCPServerConnection
+	/// Completes the handshake and waits for the client to close
+	/// the connection.
+{
+public:
+	HandshakeConnection(const StreamSocket& socket):
+		TCPServerConnection(socket)
+	{
+	}
+	
+	void run()
+	{
+		try
+		{
+			char buffer[256];
+			while (socket().receiveBytes(buffer, sizeof(buffer)) > 0)
+			{
+			}
+		}
+		catch (Exception&)
+		{
+		}
+	}
+};
+
+
+class Worker: public Runnable
+	/// Base class for the benchmark threads. Repeats
+	/// iteration() until the given time has passed.
+{
+public:
+	Worker(Event& start, const Timespan& duration):
+		_start(start),
+		_duration(duration),
+		_count(0)
+	{
+	}
+	
+	void run()
+	{
+		_start.wait();
+		Stopwatch sw;
+		sw.start();
+		try
+		{
+			while (sw.elapsed() < _duration.totalMicroseconds())
+			{
+				_count += iteration();
+			}
+		}
+		catch (Exception& exc)
+		{
+			std::cerr << exc.displayText() << std::endl;
+		}
+	}
+	
+	Poco::UInt64 count() const
+	{
+		return _count;
+	}
+	
+protected:
+	virtual int iteration() = 0;
+	
+private:
+	Event& _start;
+	Timespan _duration;
+	Poco::UInt64 _count;
+};
+
+
+class HandshakeWorker: public Worker
+	/// Performs full client handshakes against the server.
+{
+public:
+	HandshakeWorker(Event& start, const Timespan& duration, const SocketAddress& address, Context::Ptr pContext):
+		Worker(start, duration),
+		_address(address),
+		_pContext(pContext)
+	{
+	}
+	
+protected:
+	int iteration()
+	{
+		SecureStreamSocket socket(_address, _pContext);
+		socket.completeHandshake();
+		socket.close();
+		return 1;
+	}
+	
+private:
+	SocketAddress _address;
+	Context::Ptr _pContext;
+};
+
+
+class EncryptWorker: public Worker
+	/// Encrypts a block of data with a fresh AES-256 key
+	/// and IV each time, which exercises both the cipher
+	/// and the random number generator.
+{
+public:
+	enum
+	{
+		BLOCK_SIZE = 16384
+	};
+	
+	EncryptWorker(Event& start, const Timespan& duration):
+		Worker(start, duration),
+		_input(BLOCK_SIZE),
+		_output(BLOCK_SIZE + 64)
+	{
+		std::memset(_input.begin(), 'x', _input.size());
+	}
+	
+protected:
+	int iteration()
+	{
+		Cipher::Ptr pCipher = CipherFactory::defaultFactory().createCipher(CipherKey("aes-256-cbc"));
+		CryptoTransform* pEncryptor = pCipher->createEncryptor();
+		std::streamsize n = pEncryptor->transform(_input.begin(), BLOCK_SIZE, _output.begin(), static_cast<std::streamsize>(_output.size()));
+		n += pEncryptor->finalize(_output.begin() + n, static_cast<std::streamsize>(_output.size()) - n);
+		delete pEncryptor;
+		return BLOCK_SIZE;
+	}
+	
+private:
+	Buffer<unsigned char> _input;
+	Buffer<unsigned char> _output;
+};
+
+
+double runWorkers(const std::vector<Worker*>& workers, Event& start, const Timespan& duration)
+	/// Runs all workers concurrently and returns the sum of their
+	/// counts per second.
+{
+	std::vector<Thread*> threads;
+	for (std::vector<Worker*>::const_iterator it = workers.begin(); it != workers.end(); ++it)
+	{
+		threads.push_back(new Thread);
+		threads.back()->start(**it);
+	}
+	start.set();
+	Poco::UInt64 total = 0;
+	for (std::size_t i = 0; i < threads.size(); ++i)
+	{
+		threads[i]->join();
+		delete threads[i];
+		total += workers[i]->count();
+		delete workers[i];
+	}
+	return double(total)/(double(duration.totalMicroseconds())/Timespan::SECONDS);
+}
+
+
+double measureHandshakes(const std::string& keyFile, int nThreads, const Timespan& duration)
+	/// Returns the number of handshakes per second completed by
+	/// nThreads clients against a server using nThreads threads.
+{
+	Context::Ptr pServerContext = new Context(Context::SERVER_USE, keyFile, keyFile, "", Context::VERIFY_NONE, 9, false, "ALL:!ADH:!LOW:!EXP:!MD5:@STRENGTH");
+	Context::Ptr pClientContext = new Context(Context::CLIENT_USE, "", Context::VERIFY_NONE);
+
+	SecureServerSocket svs(SocketAddress("127.0.0.1", 0), 256, pServerContext);
+	ThreadPool pool(nThreads, nThreads + 1);
+	TCPServerParams* pParams = new TCPServerParams;
+	pParams->setMaxThreads(nThreads);
+	pParams->setMaxQueued(256);
+	TCPServer server(new TCPServerConnectionFactoryImpl<HandshakeConnection>(), pool, svs, pParams);
+	server.start();
+
+	Event start(false);
+	std::vector<Worker*> workers;
+	for (int i = 0; i < nThreads; ++i)
+	{
+		workers.push_back(new HandshakeWorker(start, duration, svs.address(), pClientContext));
+	}
+	double rate = runWorkers(workers, start, duration);
+	server.stop();
+	return rate;
+}
+
+
+double measureEncryption(int nThreads, const Timespan& duration)
+	/// Returns the number of megabytes per second encrypted
+	/// by nThreads threads.
+{
+	Event start(false);
+	std::vector<Worker*> workers;
+	for (int i = 0; i < nThreads; ++i)
+	{
+		workers.push_back(new EncryptWorker(start, duration));
+	}
+	return runWorkers(workers, start, duration)/(1024*1024);
+}
+
+
+int main(int argc, char** argv)
+{
+	if (argc < 2)
+	{
+		std::cout << "usage: TLSScalingBenchmark <pem-file> [<passphrase> [<max-threads>]]" << std::endl
+		          << "  <pem-file> must contain the server certificate and private key." << std::endl;
+		return 1;
+	}
+	std::string keyFile(argv[1]);
+	std::string passphrase(argc > 2 ? argv[2] : "");
+	int maxThreads = 8;
+	if (argc > 3 && (!NumberParser::tryParse(argv[3], maxThreads) || maxThreads < 1))
+	{
+		std::cout << "invalid thread count: " << argv[3] << std::endl;
+		return 1;
+	}
+	const Timespan duration(2, 0);
+
+	SSLInitializer sslInitializer;
+	try
+	{
+		PassphraseHandler passphraseHandler(passphrase);
+
+		std::cout << std::setw(8) << "threads"
+		          << std::setw(16) << "handshakes/s" << std::setw(10) << "scale"
+		          << std::setw(16) << "encrypt MB/s" << std::setw(10) << "scale" << std::endl;
+		double handshakes1 = 0;
+		double encryption1 = 0;
+		for (int nThreads = 1; nThreads <= maxThreads; nThreads *= 2)
+		{
+			double handshakes = measureHandshakes(keyFile, nThreads, duration);
+			double encryption = measureEncryption(nThreads, duration);
+			if (nThreads == 1)
+			{
+				handshakes1 = handshakes;
+				encryption1 = encryption;
+			}
+			std::cout << std::setw(8) << nThreads << std::fixed
+			          << std::setprecision(1) << std::setw(16) << handshakes
+			          << std::setprecision(2) << std::setw(10) << (handshakes1 > 0 ? handshakes/handshakes1 : 0)
+			          << std::setprecision(1) << std::setw(16) << encryption
+			          << std::setprecision(2) << std::setw(10) << (encryption1 > 0 ? encryption/encryption1 : 0)
+			          << std::endl;
+		}
+	}
+	catch (Exception& exc)
+	{
+		std::cerr << exc.displayText() << std::endl;
+		return 1;
+	}
+	return 0;
+}
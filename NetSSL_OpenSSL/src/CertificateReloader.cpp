@@ -0,0 +1,255 @@
+//
+// CertificateReloader.cpp
+//
+// $Id: //poco/1.4/NetSSL_OpenSSL/src/CertificateReloader.cpp#1 $
+//
+// Library: NetSSL_OpenSSL
+// Package: SSLCore
+// Module:  CertificateReloader
+//
+// Copyright (c) 2013, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+// 
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+
+
+
+#include "Poco/Net/CertificateReloader.h"
+#include "Poco/Delegate.h"
+#include "Poco/Path.h"
+#include "Poco/File.h"
+
+
+namespace Poco {
+namespace Net {
+
+
+namespace
+{
+	class FileContextFactory: public CertificateReloader::ContextFactory
+	{
+	public:
+		FileContextFactory(
+			Context::Usage usage,
+			const std::string& privateKeyFile,
+			const std::string& certificateFile,
+			const std::string& caLocation,
+			Context::VerificationMode verificationMode,
+			int verificationDepth,
+			bool loadDefaultCAs,
+			const std::string& cipherList):
+			_usage(usage),
+			_privateKeyFile(privateKeyFile),
+			_certificateFile(certificateFile),
+			_caLocation(caLocation),
+			_verificationMode(verificationMode),
+			_verificationDepth(verificationDepth),
+			_loadDefaultCAs(loadDefaultCAs),
+			_cipherList(cipherList)
+		{
+		}
+
+		Context::Ptr createContext()
+		{
+			return new Context(_usage, _privateKeyFile, _certificateFile, _caLocation, _verificationMode, _verificationDepth, _loadDefaultCAs, _cipherList);
+		}
+
+	private:
+		Context::Usage _usage;
+		std::string _privateKeyFile;
+		std::string _certificateFile;
+		std::string _caLocation;
+		Context::VerificationMode _verificationMode;
+		int _verificationDepth;
+		bool _loadDefaultCAs;
+		std::string _cipherList;
+	};
+	
+	std::string absolutePath(const std::string& path)
+	{
+		return Poco::Path(path).absolute().toString();
+	}
+}
+
+
+CertificateReloader::ContextFactory::~ContextFactory()
+{
+}
+
+
+CertificateReloader::CertificateReloader(
+	const SecureServerSocket& socket,
+	const std::string& privateKeyFile,
+	const std::string& certificateFile,
+	const std::string& caLocation,
+	Context::VerificationMode verificationMode,
+	int verificationDepth,
+	bool loadDefaultCAs,
+	const std::string& cipherList):
+	_socket(socket),
+	_pFactory(new FileContextFactory(socket.context()->usage(), privateKeyFile, certificateFile, caLocation, verificationMode, verificationDepth, loadDefaultCAs, cipherList))
+{
+	std::vector<std::string> files;
+	if (!privateKeyFile.empty()) files.push_back(privateKeyFile);
+	if (!certificateFile.empty()) files.push_back(certificateFile);
+	if (!caLocation.empty() && Poco::File(caLocation).isFile()) files.push_back(caLocation);
+	try
+	{
+		watch(files);
+	}
+	catch (...)
+	{
+		unwatch();
+		delete _pFactory;
+		throw;
+	}
+}
+
+
+CertificateReloader::CertificateReloader(const SecureServerSocket& socket, ContextFactory* pFactory, const std::vector<std::string>& files):
+	_socket(socket),
+	_pFactory(pFactory)
+{
+	poco_check_ptr (pFactory);
+
+	try
+	{
+		watch(files);
+	}
+	catch (...)
+	{
+		unwatch();
+		delete _pFactory;
+		throw;
+	}
+}
+
+
+CertificateReloader::~CertificateReloader()
+{
+	unwatch();
+	delete _pFactory;
+}
+
+
+void CertificateReloader::reload()
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	Context::Ptr pContext;
+	try
+	{
+		pContext = _pFactory->createContext();
+		poco_check_ptr (pContext);
+		if (!pContext->isForServerUse())
+			throw Poco::InvalidArgumentException("CertificateReloader requires a server Context");
+	}
+	catch (...)
+	{
+		++_failures;
+		throw;
+	}
+
+	Context::Ptr pOldContext = _socket.context();
+	if (pOldContext->sessionCacheEnabled() && !pContext->sessionCacheEnabled())
+	{
+		pContext->enableSessionCache(true, pOldContext->getSessionIdContext());
+		pContext->setSessionCacheSize(pOldContext->getSessionCacheSize());
+		pContext->setSessionTimeout(pOldContext->getSessionTimeout());
+	}
+	if (!pContext->getSessionCache() && pOldContext->getSessionCache())
+	{
+		pContext->setSessionCache(pOldContext->getSessionCache());
+	}
+	if (!pContext->getHandshakePool() && pOldContext->getHandshakePool())
+	{
+		pContext->setHandshakePool(pOldContext->getHandshakePool());
+	}
+	if (!pContext->getSessionTicketKeyManager() && pOldContext->getSessionTicketKeyManager())
+	{
+		pContext->setSessionTicketKeyManager(pOldContext->getSessionTicketKeyManager());
+	}
+	if (pOldContext->kernelTLSEnabled())
+	{
+		pContext->enableKernelTLS(true);
+	}
+	_socket.setContext(pContext);
+	++_reloads;
+	contextReloaded(this, pContext);
+}
+
+
+void CertificateReloader::onFileChanged(const void* pSender, const Poco::DirectoryWatcher::DirectoryEvent& event)
+{
+	if (_files.find(absolutePath(event.item.path())) == _files.end()) return;
+
+	try
+	{
+		reload();
+	}
+	catch (Poco::Exception& exc)
+	{
+		reloadFailed(this, exc);
+	}
+}
+
+
+void CertificateReloader::watch(const std::vector<std::string>& files)
+{
+	std::set<std::string> directories;
+	for (std::vector<std::string>::const_iterator it = files.begin(); it != files.end(); ++it)
+	{
+		Poco::Path path(*it);
+		path.makeAbsolute();
+		_files.insert(path.toString());
+		directories.insert(path.parent().toString());
+	}
+	for (std::set<std::string>::const_iterator it = directories.begin(); it != directories.end(); ++it)
+	{
+		Poco::DirectoryWatcher* pWatcher = new Poco::DirectoryWatcher(*it, 
+			Poco::DirectoryWatcher::DW_ITEM_ADDED | Poco::DirectoryWatcher::DW_ITEM_MODIFIED | Poco::DirectoryWatcher::DW_ITEM_MOVED_TO);
+		_watchers.push_back(pWatcher);
+		pWatcher->itemAdded += Poco::delegate(this, &CertificateReloader::onFileChanged);
+		pWatcher->itemModified += Poco::delegate(this, &CertificateReloader::onFileChanged);
+		pWatcher->itemMovedTo += Poco::delegate(this, &CertificateReloader::onFileChanged);
+	}
+}
+
+
+
+void CertificateReloader::unwatch()
+{
+	for (std::vector<Poco::DirectoryWatcher*>::iterator it = _watchers.begin(); it != _watchers.end(); ++it)
+	{
+		(*it)->itemAdded -= Poco::delegate(this, &CertificateReloader::onFileChanged);
+		(*it)->itemModified -= Poco::delegate(this, &CertificateReloader::onFileChanged);
+		(*it)->itemMovedTo -= Poco::delegate(this, &CertificateReloader::onFileChanged);
+		delete *it;
+	}
+	_watchers.clear();
+}
+
+
+} } // namespace Poco::Net
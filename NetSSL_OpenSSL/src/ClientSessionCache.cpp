@@ -0,0 +1,182 @@
+//
+// ClientSessionCache.cpp
+//
+// $Id: //poco/1.4/NetSSL_OpenSSL/src/ClientSessionCache.cpp#1 $
+//
+// Library: NetSSL_OpenSSL
+// Package: SSLCore
+// Module:  ClientSessionCache
+//
+// Copyright (c) 2013, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+// 
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+
+
+
+#include "Poco/Net/ClientSessionCache.h"
+#include "Poco/NumberFormatter.h"
+#include "Poco/Timestamp.h"
+
+
+namespace Poco {
+namespace Net {
+
+
+ClientSessionCache::ClientSessionCache(std::size_t maxSize):
+	_maxSize(maxSize)
+{
+}
+
+
+ClientSessionCache::~ClientSessionCache()
+{
+}
+
+
+Session::Ptr ClientSessionCache::find(const std::string& peer)
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	SessionMap::iterator it = _sessions.find(peer);
+	if (it != _sessions.end())
+	{
+		SSL_SESSION* pSSLSession = it->second.pSession->sslSession();
+		Poco::Timestamp::TimeVal expires = Poco::Timestamp::fromEpochTime(SSL_SESSION_get_time(pSSLSession) + SSL_SESSION_get_timeout(pSSLSession)).epochMicroseconds();
+		if (expires > Poco::Timestamp().epochMicroseconds())
+		{
+			_lru.splice(_lru.begin(), _lru, it->second.lruIt);
+			++_hits;
+			return it->second.pSession;
+		}
+		removeImpl(it);
+	}
+	++_misses;
+	return 0;
+}
+
+
+void ClientSessionCache::update(const std::string& peer, Session::Ptr pSession, bool resumed)
+{
+	if (resumed)
+		++_resumedHandshakes;
+	else
+		++_fullHandshakes;
+	if (!pSession) return;
+
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	SessionMap::iterator it = _sessions.find(peer);
+	if (it != _sessions.end())
+	{
+		it->second.pSession = pSession;
+		_lru.splice(_lru.begin(), _lru, it->second.lruIt);
+	}
+	else
+	{
+		if (_maxSize > 0 && _sessions.size() >= _maxSize)
+		{
+			removeImpl(_sessions.find(_lru.back()));
+		}
+		_lru.push_front(peer);
+		Entry& entry = _sessions[peer];
+		entry.pSession = pSession;
+		entry.lruIt = _lru.begin();
+	}
+}
+
+
+void ClientSessionCache::remove(const std::string& peer)
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	SessionMap::iterator it = _sessions.find(peer);
+	if (it != _sessions.end()) removeImpl(it);
+}
+
+
+void ClientSessionCache::clear()
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	_sessions.clear();
+	_lru.clear();
+}
+
+
+void ClientSessionCache::setMaxSize(std::size_t maxSize)
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	_maxSize = maxSize;
+	while (_maxSize > 0 && _sessions.size() > _maxSize)
+	{
+		removeImpl(_sessions.find(_lru.back()));
+	}
+}
+
+
+std::size_t ClientSessionCache::getMaxSize() const
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	return _maxSize;
+}
+
+
+std::size_t ClientSessionCache::size() const
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	return _sessions.size();
+}
+
+
+void ClientSessionCache::resetStatistics()
+{
+	_hits              = 0;
+	_misses            = 0;
+	_fullHandshakes    = 0;
+	_resumedHandshakes = 0;
+}
+
+
+std::string ClientSessionCache::peerName(const std::string& host, Poco::UInt16 port)
+{
+	std::string result(host);
+	result += ':';
+	Poco::NumberFormatter::append(result, port);
+	return result;
+}
+
+
+void ClientSessionCache::removeImpl(SessionMap::iterator it)
+{
+	_lru.erase(it->second.lruIt);
+	_sessions.erase(it);
+}
+
+
+} } // namespace Poco::Net
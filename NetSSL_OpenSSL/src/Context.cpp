@@ -42,16 +42,41 @@
 #include "Poco/File.h"
 #include "Poco/Path.h"
 #include "Poco/Timestamp.h"
+#include "Poco/Buffer.h"
+#include "Poco/Mutex.h"
 #include <openssl/bio.h>
 #include <openssl/err.h>
 #include <openssl/ssl.h>
 #include <openssl/x509v3.h>
+#include <openssl/rand.h>
+#include <openssl/hmac.h>
+#include <cstring>
 
 
 namespace Poco {
 namespace Net {
 
 
+namespace
+{
+	int contextIndex()
+		/// Returns the SSL_CTX ex_data index used to
+		/// store the pointer to the owning Context.
+	{
+		static Poco::FastMutex mutex;
+		static int index = -1;
+
+		Poco::FastMutex::ScopedLock lock(mutex);
+		if (index < 0)
+		{
+			index = SSL_CTX_get_ex_new_index(0, 0, 0, 0, 0);
+			if (index < 0) throw SSLException("Cannot allocate SSL_CTX ex_data index");
+		}
+		return index;
+	}
+}
+
+
 Context::Context(
 	Usage usage,
 	const std::string& privateKeyFile, 
@@ -64,7 +89,8 @@ Context::Context(
 	_usage(usage),
 	_mode(verificationMode),
 	_pSSLContext(0),
-	_extendedCertificateVerification(true)
+	_extendedCertificateVerification(true),
+	_kernelTLS(false)
 {
 	Poco::Crypto::OpenSSLInitializer::initialize();
 	
@@ -128,6 +154,7 @@ Context::Context(
 	SSL_CTX_set_verify_depth(_pSSLContext, verificationDepth);
 	SSL_CTX_set_mode(_pSSLContext, SSL_MODE_AUTO_RETRY);
 	SSL_CTX_set_session_cache_mode(_pSSLContext, SSL_SESS_CACHE_OFF);
+	if (!isForServerUse()) _pClientSessionCache = new ClientSessionCache;
 }
 
 
@@ -141,7 +168,8 @@ Context::Context(
 	_usage(usage),
 	_mode(verificationMode),
 	_pSSLContext(0),
-	_extendedCertificateVerification(true)
+	_extendedCertificateVerification(true),
+	_kernelTLS(false)
 {
 	Poco::Crypto::OpenSSLInitializer::initialize();
 	
@@ -183,6 +211,7 @@ Context::Context(
 	SSL_CTX_set_verify_depth(_pSSLContext, verificationDepth);
 	SSL_CTX_set_mode(_pSSLContext, SSL_MODE_AUTO_RETRY);
 	SSL_CTX_set_session_cache_mode(_pSSLContext, SSL_SESS_CACHE_OFF);
+	if (!isForServerUse()) _pClientSessionCache = new ClientSessionCache;
 }
 
 
@@ -231,7 +260,9 @@ void Context::enableSessionCache(bool flag)
 {
 	if (flag)
 	{
-		SSL_CTX_set_session_cache_mode(_pSSLContext, isForServerUse() ? SSL_SESS_CACHE_SERVER : SSL_SESS_CACHE_CLIENT);
+		long mode = isForServerUse() ? SSL_SESS_CACHE_SERVER : SSL_SESS_CACHE_CLIENT;
+		if (_pSessionCache) mode |= SSL_SESS_CACHE_NO_INTERNAL;
+		SSL_CTX_set_session_cache_mode(_pSSLContext, mode);
 	}
 	else
 	{
@@ -246,7 +277,9 @@ void Context::enableSessionCache(bool flag, const std::string& sessionIdContext)
 
 	if (flag)
 	{
-		SSL_CTX_set_session_cache_mode(_pSSLContext, SSL_SESS_CACHE_SERVER);
+		long mode = SSL_SESS_CACHE_SERVER;
+		if (_pSessionCache) mode |= SSL_SESS_CACHE_NO_INTERNAL;
+		SSL_CTX_set_session_cache_mode(_pSSLContext, mode);
 	}
 	else
 	{
@@ -257,6 +290,7 @@ void Context::enableSessionCache(bool flag, const std::string& sessionIdContext)
 	if (length > SSL_MAX_SSL_SESSION_ID_LENGTH) length = SSL_MAX_SSL_SESSION_ID_LENGTH;
 	int rc = SSL_CTX_set_session_id_context(_pSSLContext, reinterpret_cast<const unsigned char*>(sessionIdContext.data()), length);
 	if (rc != 1) throw SSLContextException("cannot set session ID context");
+	_sessionIdContext.assign(sessionIdContext, 0, length);
 }
 
 
@@ -268,17 +302,19 @@ bool Context::sessionCacheEnabled() const
 
 void Context::setSessionCacheSize(std::size_t size)
 {
-	poco_assert (isForServerUse());
-	
-	SSL_CTX_sess_set_cache_size(_pSSLContext, static_cast<long>(size));
+	if (isForServerUse())
+		SSL_CTX_sess_set_cache_size(_pSSLContext, static_cast<long>(size));
+	else
+		_pClientSessionCache->setMaxSize(size);
 }
 
 	
 std::size_t Context::getSessionCacheSize() const
 {
-	poco_assert (isForServerUse());
-	
-	return static_cast<std::size_t>(SSL_CTX_sess_get_cache_size(_pSSLContext));
+	if (isForServerUse())
+		return static_cast<std::size_t>(SSL_CTX_sess_get_cache_size(_pSSLContext));
+	else
+		return _pClientSessionCache->getMaxSize();
 }
 
 
@@ -321,6 +357,182 @@ void Context::disableStatelessSessionResumption()
 }
 
 
+void Context::setSessionCache(SessionCache::Ptr pCache)
+{
+	poco_assert (isForServerUse());
+
+	_pSessionCache = pCache;
+	if (_pSessionCache)
+	{
+		SSL_CTX_sess_set_new_cb(_pSSLContext, &Context::onNewSession);
+		SSL_CTX_sess_set_get_cb(_pSSLContext, &Context::onGetSession);
+		SSL_CTX_sess_set_remove_cb(_pSSLContext, &Context::onRemoveSession);
+		SSL_CTX_set_session_cache_mode(_pSSLContext, SSL_SESS_CACHE_SERVER | SSL_SESS_CACHE_NO_INTERNAL);
+	}
+	else
+	{
+		SSL_CTX_sess_set_new_cb(_pSSLContext, 0);
+		SSL_CTX_sess_set_get_cb(_pSSLContext, 0);
+		SSL_CTX_sess_set_remove_cb(_pSSLContext, 0);
+		if (sessionCacheEnabled())
+			SSL_CTX_set_session_cache_mode(_pSSLContext, SSL_SESS_CACHE_SERVER);
+	}
+}
+
+
+void Context::setSessionTicketKeyManager(SessionTicketKeyManager::Ptr pManager)
+{
+	poco_assert (isForServerUse());
+
+#if defined(SSL_CTX_set_tlsext_ticket_key_cb) && defined(SSL_OP_NO_TICKET)
+	_pTicketKeyManager = pManager;
+	if (_pTicketKeyManager)
+	{
+		SSL_CTX_set_tlsext_ticket_key_cb(_pSSLContext, &Context::onTicketKey);
+		SSL_CTX_clear_options(_pSSLContext, SSL_OP_NO_TICKET);
+	}
+	else
+	{
+		SSL_CTX_set_tlsext_ticket_key_cb(_pSSLContext, 0);
+	}
+#else
+	throw Poco::NotImplementedException("Session tickets are not supported by this OpenSSL version");
+#endif
+}
+
+
+void Context::setHandshakePool(HandshakePool::Ptr pPool)
+{
+	poco_assert (isForServerUse());
+
+	_pHandshakePool = pPool;
+}
+
+
+void Context::enableKernelTLS(bool flag)
+{
+	_kernelTLS = flag;
+#if defined(SSL_OP_ENABLE_KTLS)
+	if (flag)
+		SSL_CTX_set_options(_pSSLContext, SSL_OP_ENABLE_KTLS);
+	else
+		SSL_CTX_clear_options(_pSSLContext, SSL_OP_ENABLE_KTLS);
+#endif
+}
+
+
+Context* Context::fromSSLContext(SSL_CTX* pSSLContext)
+{
+	return reinterpret_cast<Context*>(SSL_CTX_get_ex_data(pSSLContext, contextIndex()));
+}
+
+
+int Context::onNewSession(SSL* pSSL, SSL_SESSION* pSession)
+{
+	try
+	{
+		Context* pContext = fromSSLContext(SSL_get_SSL_CTX(pSSL));
+		if (pContext && pContext->_pSessionCache)
+		{
+			unsigned idLength = 0;
+			const unsigned char* id = SSL_SESSION_get_id(pSession, &idLength);
+			int length = i2d_SSL_SESSION(pSession, 0);
+			if (length > 0)
+			{
+				Poco::Buffer<unsigned char> buffer(length);
+				unsigned char* p = buffer.begin();
+				i2d_SSL_SESSION(pSession, &p);
+				Poco::Timestamp expires = Poco::Timestamp::fromEpochTime(SSL_SESSION_get_time(pSession) + SSL_SESSION_get_timeout(pSession));
+				pContext->_pSessionCache->add(
+					std::string(reinterpret_cast<const char*>(id), idLength),
+					std::string(reinterpret_cast<const char*>(buffer.begin()), length),
+					expires);
+			}
+		}
+	}
+	catch (...)
+	{
+	}
+	// we have not kept a reference to the session
+	return 0;
+}
+
+
+#if OPENSSL_VERSION_NUMBER >= 0x10100000L
+SSL_SESSION* Context::onGetSession(SSL* pSSL, const unsigned char* id, int length, int* pCopy)
+#else
+SSL_SESSION* Context::onGetSession(SSL* pSSL, unsigned char* id, int length, int* pCopy)
+#endif
+{
+	*pCopy = 0;
+	try
+	{
+		Context* pContext = fromSSLContext(SSL_get_SSL_CTX(pSSL));
+		std::string session;
+		if (pContext && pContext->_pSessionCache && pContext->_pSessionCache->get(std::string(reinterpret_cast<const char*>(id), length), session))
+		{
+			const unsigned char* p = reinterpret_cast<const unsigned char*>(session.data());
+			return d2i_SSL_SESSION(0, &p, static_cast<long>(session.size()));
+		}
+	}
+	catch (...)
+	{
+	}
+	return 0;
+}
+
+
+void Context::onRemoveSession(SSL_CTX* pSSLContext, SSL_SESSION* pSession)
+{
+	try
+	{
+		Context* pContext = fromSSLContext(pSSLContext);
+		if (pContext && pContext->_pSessionCache)
+		{
+			unsigned idLength = 0;
+			const unsigned char* id = SSL_SESSION_get_id(pSession, &idLength);
+			pContext->_pSessionCache->remove(std::string(reinterpret_cast<const char*>(id), idLength));
+		}
+	}
+	catch (...)
+	{
+	}
+}
+
+
+int Context::onTicketKey(SSL* pSSL, unsigned char* name, unsigned char* iv, EVP_CIPHER_CTX* pCipherContext, HMAC_CTX* pHMACContext, int enc)
+{
+	try
+	{
+		Context* pContext = fromSSLContext(SSL_get_SSL_CTX(pSSL));
+		if (!pContext || !pContext->_pTicketKeyManager) return -1;
+
+		SessionTicketKeyManager::Key key;
+		int rc = 1;
+		if (enc)
+		{
+			pContext->_pTicketKeyManager->encryptionKey(key);
+			std::memcpy(name, key.name, SessionTicketKeyManager::NAME_SIZE);
+			if (RAND_bytes(iv, EVP_CIPHER_iv_length(EVP_aes_128_cbc())) != 1) return -1;
+			if (!EVP_EncryptInit_ex(pCipherContext, EVP_aes_128_cbc(), 0, key.aesKey, iv)) return -1;
+		}
+		else
+		{
+			bool renew = false;
+			if (!pContext->_pTicketKeyManager->decryptionKey(name, key, renew)) return 0;
+			if (!EVP_DecryptInit_ex(pCipherContext, EVP_aes_128_cbc(), 0, key.aesKey, iv)) return -1;
+			if (renew) rc = 2;
+		}
+		if (!HMAC_Init_ex(pHMACContext, key.hmacKey, SessionTicketKeyManager::KEY_SIZE, EVP_sha256(), 0)) return -1;
+		return rc;
+	}
+	catch (...)
+	{
+		return -1;
+	}
+}
+
+
 void Context::createSSLContext()
 {
 	if (SSLManager::isFIPSEnabled())
@@ -353,9 +565,13 @@ void Context::createSSLContext()
 		throw SSLException("Cannot create SSL_CTX object", ERR_error_string(err, 0));
 	}
 
+	SSL_CTX_set_ex_data(_pSSLContext, contextIndex(), this);
 	SSL_CTX_set_default_passwd_cb(_pSSLContext, &SSLManager::privateKeyPassphraseCallback);
 	Utility::clearErrorStack();
 	SSL_CTX_set_options(_pSSLContext, SSL_OP_ALL);
+	// a non-blocking sendBytes() may be retried from a different
+	// buffer; blocking sockets never see WANT_READ from renegotiations
+	SSL_CTX_set_mode(_pSSLContext, SSL_MODE_ACCEPT_MOVING_WRITE_BUFFER | SSL_MODE_AUTO_RETRY);
 }
 
 
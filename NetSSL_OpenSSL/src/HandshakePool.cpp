@@ -0,0 +1,284 @@
+//
+// HandshakePool.cpp
+//
+// $Id: //poco/1.4/NetSSL_OpenSSL/src/HandshakePool.cpp#1 $
+//
+// Library: NetSSL_OpenSSL
+// Package: SSLCore
+// Module:  HandshakePool
+//
+// Copyright (c) 2013, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+// 
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+
+
+
+#include "Poco/Net/HandshakePool.h"
+#include "Poco/Net/SecureStreamSocket.h"
+#include "Poco/Notification.h"
+#include "Poco/Timestamp.h"
+
+
+namespace Poco {
+namespace Net {
+
+
+namespace
+{
+	class HandshakeNotification: public Poco::Notification
+	{
+	public:
+		HandshakeNotification(const StreamSocket& socket, HandshakePool::Target::Ptr pTarget):
+			_socket(socket),
+			_pTarget(pTarget)
+		{
+		}
+
+		~HandshakeNotification()
+		{
+		}
+
+		StreamSocket& socket()
+		{
+			return _socket;
+		}
+
+		HandshakePool::Target::Ptr target() const
+		{
+			return _pTarget;
+		}
+
+		const Poco::Timestamp& queued() const
+		{
+			return _queued;
+		}
+
+	private:
+		StreamSocket _socket;
+		HandshakePool::Target::Ptr _pTarget;
+		Poco::Timestamp _queued;
+	};
+
+
+	class StopNotification: public Poco::Notification
+		/// Tells a worker thread to exit.
+	{
+	};
+}
+
+
+HandshakePool::Target::~Target()
+{
+}
+
+
+HandshakePool::HandshakePool(int threads, int maxQueued, const Poco::Timespan& timeout):
+	_threads(threads),
+	_maxQueued(maxQueued),
+	_timeout(timeout),
+	_threadPool("HandshakePool", threads, threads),
+	_stopped(false),
+	_handshakes(0),
+	_totalQueueTime(0),
+	_totalHandshakeTime(0),
+	_maxHandshakeTime(0)
+{
+	poco_assert (threads > 0 && maxQueued > 0);
+
+	for (int i = 0; i < threads; ++i)
+	{
+		_threadPool.start(*this);
+	}
+}
+
+
+HandshakePool::~HandshakePool()
+{
+	try
+	{
+		stop();
+	}
+	catch (...)
+	{
+	}
+}
+
+
+bool HandshakePool::enqueue(const StreamSocket& socket, Target::Ptr pTarget)
+{
+	poco_check_ptr (pTarget);
+
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+		if (!_stopped && _queue.size() < _maxQueued)
+		{
+			_queue.enqueueNotification(new HandshakeNotification(socket, pTarget));
+			return true;
+		}
+	}
+	++_rejected;
+	StreamSocket ss(socket);
+	ss.close();
+	return false;
+}
+
+
+void HandshakePool::stop()
+{
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+		if (_stopped) return;
+		_stopped = true;
+	}
+	// Workers that are busy with a handshake are not waiting on the
+	// queue and would miss a wakeUpAll(), so every worker gets its own
+	// stop notification, ahead of any queued handshakes.
+	for (int i = 0; i < _threads; ++i)
+	{
+		_queue.enqueueUrgentNotification(new StopNotification);
+	}
+	_threadPool.joinAll();
+
+	Poco::AutoPtr<Poco::Notification> pNf = _queue.dequeueNotification();
+	while (pNf)
+	{
+		HandshakeNotification* pHandshakeNf = dynamic_cast<HandshakeNotification*>(pNf.get());
+		if (pHandshakeNf) pHandshakeNf->socket().close();
+		pNf = _queue.dequeueNotification();
+	}
+}
+
+
+Poco::Timespan HandshakePool::averageQueueTime() const
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	return _handshakes > 0 ? Poco::Timespan(_totalQueueTime/_handshakes) : Poco::Timespan();
+}
+
+
+Poco::Timespan HandshakePool::averageHandshakeTime() const
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	return _handshakes > 0 ? Poco::Timespan(_totalHandshakeTime/_handshakes) : Poco::Timespan();
+}
+
+
+Poco::Timespan HandshakePool::maxHandshakeTime() const
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	return Poco::Timespan(_maxHandshakeTime);
+}
+
+
+void HandshakePool::resetStatistics()
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	_completed = 0;
+	_failed = 0;
+	_rejected = 0;
+	_handshakes = 0;
+	_totalQueueTime = 0;
+	_totalHandshakeTime = 0;
+	_maxHandshakeTime = 0;
+}
+
+
+void HandshakePool::run()
+{
+	for (;;)
+	{
+		Poco::AutoPtr<Poco::Notification> pNf = _queue.waitDequeueNotification();
+		HandshakeNotification* pHandshakeNf = dynamic_cast<HandshakeNotification*>(pNf.get());
+		if (!pHandshakeNf) break;
+
+		++_active;
+		Poco::Timestamp started;
+		bool ok = handshake(pHandshakeNf->socket());
+		Poco::Timestamp::TimeDiff handshakeTime = started.elapsed();
+		--_active;
+		{
+			Poco::FastMutex::ScopedLock lock(_mutex);
+			++_handshakes;
+			_totalQueueTime += started - pHandshakeNf->queued();
+			_totalHandshakeTime += handshakeTime;
+			if (handshakeTime > _maxHandshakeTime) _maxHandshakeTime = handshakeTime;
+		}
+		if (ok)
+		{
+			++_completed;
+			try
+			{
+				pHandshakeNf->target()->handshakeCompleted(pHandshakeNf->socket());
+			}
+			catch (...)
+			{
+				pHandshakeNf->socket().close();
+			}
+		}
+		else
+		{
+			++_failed;
+			pHandshakeNf->socket().close();
+		}
+	}
+}
+
+
+bool HandshakePool::handshake(StreamSocket& socket)
+{
+	try
+	{
+		SecureStreamSocket secureSocket(socket);
+		bool blocking = secureSocket.getBlocking();
+		secureSocket.setBlocking(false);
+		// The timeout applies to the handshake as a whole, so that a 
+		// client sending its handshake data in small pieces cannot
+		// hold a pool thread any longer than one sending nothing.
+		Poco::Timestamp deadline;
+		deadline += _timeout.totalMicroseconds();
+		int rc;
+		while ((rc = secureSocket.completeHandshake()) < 0)
+		{
+			Poco::Timestamp::TimeDiff remaining = deadline - Poco::Timestamp();
+			if (remaining <= 0) return false;
+			int mode = rc == SecureStreamSocket::ERR_SSL_WANT_WRITE ? Socket::SELECT_WRITE : Socket::SELECT_READ;
+			secureSocket.poll(Poco::Timespan(remaining), mode);
+		}
+		secureSocket.setBlocking(blocking);
+		return rc == 1;
+	}
+	catch (Poco::Exception&)
+	{
+		return false;
+	}
+}
+
+
+} } // namespace Poco::Net
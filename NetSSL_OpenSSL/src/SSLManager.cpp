@@ -295,6 +295,11 @@ void SSLManager::initDefaultContext(bool server)
 	else
 	{
 		_ptrDefaultClientContext->enableSessionCache(cacheSessions);
+		if (config.hasProperty(prefix + CFG_SESSION_CACHE_SIZE))
+		{
+			int cacheSize = config.getInt(prefix + CFG_SESSION_CACHE_SIZE);
+			_ptrDefaultClientContext->setSessionCacheSize(cacheSize);
+		}
 	}
 	bool extendedVerification = config.getBool(prefix + CFG_EXTENDED_VERIFICATION, false);
 	if (server)
@@ -140,4 +140,10 @@ Context::Ptr SecureServerSocket::context() const
 }
 
 
+void SecureServerSocket::setContext(Context::Ptr pContext)
+{
+	static_cast<SecureServerSocketImpl*>(impl())->setContext(pContext);
+}
+
+
 } } // namespace Poco::Net
@@ -35,14 +35,117 @@
 
 
 #include "Poco/Net/SecureServerSocketImpl.h"
+#include "Poco/Net/StreamSocket.h"
+#include "Poco/Net/DatagramSocket.h"
+#include "Poco/Net/NetException.h"
+#include "Poco/Timestamp.h"
+#include <deque>
+#include <string.h> // FD_SET needs memset on some platforms, so we can't use <cstring>
+#if defined(POCO_HAVE_FD_POLL)
+#include <poll.h>
+#endif
 
 
 namespace Poco {
 namespace Net {
 
 
+class SecureServerSocketImpl::ReadyQueue: public HandshakePool::Target
+	/// Holds the connections whose handshake has been completed
+	/// by the HandshakePool until they are accepted.
+	///
+	/// A datagram sent to a loopback socket signals a completed
+	/// handshake, so that poll() can wait for completed handshakes 
+	/// and new connections at the same time.
+{
+public:
+	ReadyQueue():
+		_signaled(false)
+	{
+		_wakeup.bind(SocketAddress("127.0.0.1", 0));
+		_wakeup.connect(_wakeup.address());
+		_wakeup.setBlocking(false);
+	}
+
+	void handshakeCompleted(const StreamSocket& socket)
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+
+		_sockets.push_back(socket);
+		if (!_signaled)
+		{
+			char c = 0;
+			_wakeup.sendBytes(&c, 1);
+			_signaled = true;
+		}
+	}
+
+	poco_socket_t wakeupfd() const
+	{
+		return _wakeup.impl()->sockfd();
+	}
+
+	void acknowledge()
+		/// Consumes the signal after the wakeup socket 
+		/// has become readable.
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+
+		char c;
+		try
+		{
+			_wakeup.receiveBytes(&c, 1);
+		}
+		catch (Poco::Exception&)
+		{
+		}
+		_signaled = false;
+	}
+
+	bool dequeue(StreamSocket& socket)
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+
+		if (_sockets.empty()) return false;
+		socket = _sockets.front();
+		_sockets.pop_front();
+		return true;
+	}
+
+	bool empty() const
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+
+		return _sockets.empty();
+	}
+
+	void clear()
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+
+		for (std::deque<StreamSocket>::iterator it = _sockets.begin(); it != _sockets.end(); ++it)
+		{
+			it->close();
+		}
+		_sockets.clear();
+	}
+
+protected:
+	~ReadyQueue()
+	{
+	}
+
+private:
+	std::deque<StreamSocket> _sockets;
+	DatagramSocket _wakeup;
+	bool _signaled;
+	mutable Poco::FastMutex _mutex;
+};
+
+
 SecureServerSocketImpl::SecureServerSocketImpl(Context::Ptr pContext):
-	_impl(new ServerSocketImpl, pContext)
+	_impl(new ServerSocketImpl, pContext),
+	_pReadyQueue(new ReadyQueue)
 {
 }
 
@@ -55,7 +158,103 @@ SecureServerSocketImpl::~SecureServerSocketImpl()
 
 SocketImpl* SecureServerSocketImpl::acceptConnection(SocketAddress& clientAddr)
 {
-	return _impl.acceptConnection(clientAddr);
+	HandshakePool::Ptr pPool = _impl.context()->getHandshakePool();
+	if (!pPool) return _impl.acceptConnection(clientAddr);
+
+	StreamSocket socket;
+	while (!_pReadyQueue->dequeue(socket))
+	{
+		poll(Poco::Timespan(1, 0), SELECT_READ);
+	}
+	try
+	{
+		clientAddr = socket.peerAddress();
+	}
+	catch (Poco::Exception&)
+	{
+		clientAddr = SocketAddress();
+	}
+	SocketImpl* pImpl = socket.impl();
+	pImpl->duplicate();
+	return pImpl;
+}
+
+
+bool SecureServerSocketImpl::poll(const Poco::Timespan& timeout, int mode)
+{
+	HandshakePool::Ptr pPool = _impl.context()->getHandshakePool();
+	if (!pPool || mode != SELECT_READ) return ServerSocketImpl::poll(timeout, mode);
+
+	Poco::Timestamp start;
+	for (;;)
+	{
+		acceptPending(pPool);
+		if (!_pReadyQueue->empty()) return true;
+		Poco::Timespan remaining = timeout - Poco::Timespan(start.elapsed());
+		if (remaining <= 0) return false;
+		waitForActivity(remaining);
+	}
+}
+
+
+void SecureServerSocketImpl::waitForActivity(const Poco::Timespan& timeout)
+{
+	poco_socket_t fd = sockfd();
+	if (fd == POCO_INVALID_SOCKET) throw InvalidSocketException();
+	poco_socket_t wakeupfd = _pReadyQueue->wakeupfd();
+
+	Poco::Timespan remainingTime(timeout);
+	bool signaled = false;
+	int errorCode;
+	int rc;
+	do
+	{
+#if defined(POCO_HAVE_FD_POLL)
+		pollfd pollBuf[2];
+		memset(pollBuf, 0, sizeof(pollBuf));
+		pollBuf[0].fd = fd;
+		pollBuf[0].events = POLLIN;
+		pollBuf[1].fd = wakeupfd;
+		pollBuf[1].events = POLLIN;
+		Poco::Timestamp start;
+		rc = ::poll(pollBuf, 2, remainingTime.totalMilliseconds());
+		if (rc > 0) signaled = (pollBuf[1].revents & POLLIN) != 0;
+#else
+		fd_set fdRead;
+		FD_ZERO(&fdRead);
+		FD_SET(fd, &fdRead);
+		FD_SET(wakeupfd, &fdRead);
+		struct timeval tv;
+		tv.tv_sec  = (long) remainingTime.totalSeconds();
+		tv.tv_usec = (long) remainingTime.useconds();
+		Poco::Timestamp start;
+		rc = ::select(int(fd > wakeupfd ? fd : wakeupfd) + 1, &fdRead, 0, 0, &tv);
+		if (rc > 0) signaled = FD_ISSET(wakeupfd, &fdRead) != 0;
+#endif
+		if (rc < 0 && (errorCode = lastError()) == POCO_EINTR)
+		{
+			Poco::Timestamp end;
+			Poco::Timespan waited = end - start;
+			if (waited < remainingTime)
+				remainingTime -= waited;
+			else
+				remainingTime = 0;
+		}
+	}
+	while (rc < 0 && errorCode == POCO_EINTR);
+	if (rc < 0) error(errorCode);
+	if (signaled) _pReadyQueue->acknowledge();
+}
+
+
+void SecureServerSocketImpl::acceptPending(HandshakePool::Ptr pPool)
+{
+	while (ServerSocketImpl::poll(Poco::Timespan(), SELECT_READ))
+	{
+		SocketAddress clientAddr;
+		StreamSocket socket(_impl.acceptConnection(clientAddr));
+		pPool->enqueue(socket, _pReadyQueue);
+	}
 }
 
 
@@ -95,6 +294,7 @@ void SecureServerSocketImpl::close()
 {
 	reset();
 	_impl.close();
+	_pReadyQueue->clear();
 }
 	
 
@@ -52,6 +52,28 @@
 #include <openssl/err.h>
 
 
+#if defined(SSL_OP_ENABLE_KTLS)
+	// OpenSSL installs the keys in the kernel itself.
+	#define POCO_NETSSL_KTLS_OPENSSL
+	#include <fcntl.h>
+	#include <unistd.h>
+#elif POCO_OS == POCO_OS_LINUX && OPENSSL_VERSION_NUMBER < 0x10100000L && !defined(POCO_NETSSL_NO_KTLS)
+	// The keys for sending are derived and installed by SecureSocketImpl.
+	#define POCO_NETSSL_KTLS_MANUAL
+	#include <openssl/hmac.h>
+	#include <netinet/tcp.h>
+	#include <linux/tls.h>
+	#include <sys/socket.h>
+	#include <cstring>
+	#ifndef SOL_TLS
+		#define SOL_TLS 282
+	#endif
+	#ifndef TCP_ULP
+		#define TCP_ULP 31
+	#endif
+#endif
+
+
 using Poco::IOException;
 using Poco::TimeoutException;
 using Poco::InvalidArgumentException;
@@ -59,6 +81,111 @@ using Poco::NumberFormatter;
 using Poco::Timespan;
 
 
+#if defined(POCO_NETSSL_KTLS_MANUAL)
+
+
+namespace
+{
+	void tlsPRF(const EVP_MD* md, const unsigned char* secret, int secretLength, const std::string& labelAndSeed, unsigned char* out, int length)
+		/// The TLS 1.2 pseudorandom function P_hash (RFC 5246, section 5).
+	{
+		unsigned char a[EVP_MAX_MD_SIZE];
+		unsigned int aLength = 0;
+		HMAC(md, secret, secretLength, reinterpret_cast<const unsigned char*>(labelAndSeed.data()), labelAndSeed.size(), a, &aLength);
+		int pos = 0;
+		while (pos < length)
+		{
+			std::string input(reinterpret_cast<const char*>(a), aLength);
+			input.append(labelAndSeed);
+			unsigned char block[EVP_MAX_MD_SIZE];
+			unsigned int blockLength = 0;
+			HMAC(md, secret, secretLength, reinterpret_cast<const unsigned char*>(input.data()), input.size(), block, &blockLength);
+			int n = length - pos < static_cast<int>(blockLength) ? length - pos : static_cast<int>(blockLength);
+			std::memcpy(out + pos, block, n);
+			pos += n;
+			unsigned char next[EVP_MAX_MD_SIZE];
+			HMAC(md, secret, secretLength, a, aLength, next, &aLength);
+			std::memcpy(a, next, aLength);
+		}
+	}
+
+	template <class CryptoInfo>
+	bool installKernelTLS(int fd, CryptoInfo& info, unsigned short cipherType, const unsigned char* key, const unsigned char* salt, const unsigned char* sequence)
+	{
+		std::memset(&info, 0, sizeof(info));
+		info.info.version = TLS_1_2_VERSION;
+		info.info.cipher_type = cipherType;
+		std::memcpy(info.key, key, sizeof(info.key));
+		std::memcpy(info.salt, salt, sizeof(info.salt));
+		std::memcpy(info.iv, sequence, sizeof(info.iv));
+		std::memcpy(info.rec_seq, sequence, sizeof(info.rec_seq));
+		return setsockopt(fd, SOL_TCP, TCP_ULP, "tls", sizeof("tls")) == 0
+			&& setsockopt(fd, SOL_TLS, TLS_TX, &info, sizeof(info)) == 0;
+	}
+	
+	bool startKernelTLS(SSL* pSSL, int fd, bool server)
+		/// Derives the keys for sending from the master secret and
+		/// installs them in the kernel. Only TLS 1.2 with AES-GCM
+		/// is supported, which does not require a MAC key.
+	{
+		if (SSL_version(pSSL) != TLS1_2_VERSION) return false;
+		if (!pSSL->s3 || pSSL->s3->wbuf.left != 0 || !pSSL->enc_write_ctx) return false;
+#if !defined(OPENSSL_NO_COMP)
+		if (SSL_get_current_compression(pSSL)) return false;
+#endif
+		SSL_SESSION* pSession = SSL_get_session(pSSL);
+		if (!pSession) return false;
+
+		int keyLength;
+		int cipherNID = EVP_CIPHER_nid(EVP_CIPHER_CTX_cipher(pSSL->enc_write_ctx));
+		if (cipherNID == NID_aes_128_gcm)
+			keyLength = TLS_CIPHER_AES_GCM_128_KEY_SIZE;
+#if defined(TLS_CIPHER_AES_GCM_256)
+		else if (cipherNID == NID_aes_256_gcm)
+			keyLength = TLS_CIPHER_AES_GCM_256_KEY_SIZE;
+#endif
+		else
+			return false;
+		const SSL_CIPHER* pCipher = SSL_get_current_cipher(pSSL);
+		std::string cipherName(pCipher ? SSL_CIPHER_get_name(pCipher) : "");
+		const EVP_MD* md = cipherName.find("SHA384") != std::string::npos ? EVP_sha384() : EVP_sha256();
+
+		// key_block = client_write_key, server_write_key, client_write_IV, server_write_IV
+		const int saltLength = 4;
+		std::string labelAndSeed("key expansion");
+		labelAndSeed.append(reinterpret_cast<const char*>(pSSL->s3->server_random), SSL3_RANDOM_SIZE);
+		labelAndSeed.append(reinterpret_cast<const char*>(pSSL->s3->client_random), SSL3_RANDOM_SIZE);
+		unsigned char keyBlock[2*32 + 2*saltLength];
+		tlsPRF(md, pSession->master_key, pSession->master_key_length, labelAndSeed, keyBlock, 2*keyLength + 2*saltLength);
+		const unsigned char* key = keyBlock + (server ? keyLength : 0);
+		const unsigned char* salt = keyBlock + 2*keyLength + (server ? saltLength : 0);
+
+		bool ok;
+		if (keyLength == TLS_CIPHER_AES_GCM_128_KEY_SIZE)
+		{
+			tls12_crypto_info_aes_gcm_128 info;
+			ok = installKernelTLS(fd, info, TLS_CIPHER_AES_GCM_128, key, salt, pSSL->s3->write_sequence);
+			OPENSSL_cleanse(&info, sizeof(info));
+		}
+#if defined(TLS_CIPHER_AES_GCM_256)
+		else
+		{
+			tls12_crypto_info_aes_gcm_256 info;
+			ok = installKernelTLS(fd, info, TLS_CIPHER_AES_GCM_256, key, salt, pSSL->s3->write_sequence);
+			OPENSSL_cleanse(&info, sizeof(info));
+		}
+#else
+		else ok = false;
+#endif
+		OPENSSL_cleanse(keyBlock, sizeof(keyBlock));
+		return ok;
+	}
+}
+
+
+#endif // POCO_NETSSL_KTLS_MANUAL
+
+
 // workaround for C++-incompatible macro
 #define POCO_BIO_set_nbio_accept(b,n) BIO_ctrl(b,BIO_C_SET_ACCEPT,1,(void*)((n)?"a":NULL))
 
@@ -71,7 +198,8 @@ SecureSocketImpl::SecureSocketImpl(Poco::AutoPtr<SocketImpl> pSocketImpl, Contex
 	_pSSL(0),
 	_pSocket(pSocketImpl),
 	_pContext(pContext),
-	_needHandshake(false)
+	_needHandshake(false),
+	_kernelTLS(false)
 {
 	poco_check_ptr (_pSocket);
 	poco_check_ptr (_pContext);
@@ -95,7 +223,7 @@ SocketImpl* SecureSocketImpl::acceptConnection(SocketAddress& clientAddr)
 	poco_assert (!_pSSL);
 
 	StreamSocket ss = _pSocket->acceptConnection(clientAddr);
-	Poco::AutoPtr<SecureStreamSocketImpl> pSecureStreamSocketImpl = new SecureStreamSocketImpl(static_cast<StreamSocketImpl*>(ss.impl()), _pContext);
+	Poco::AutoPtr<SecureStreamSocketImpl> pSecureStreamSocketImpl = new SecureStreamSocketImpl(static_cast<StreamSocketImpl*>(ss.impl()), context());
 	pSecureStreamSocketImpl->acceptSSL();
 	pSecureStreamSocketImpl->duplicate();
 	return pSecureStreamSocketImpl;
@@ -129,6 +257,7 @@ void SecureSocketImpl::connect(const SocketAddress& address, bool performHandsha
 	poco_assert (!_pSSL);
 
 	_pSocket->connect(address);
+	setSessionPeer(address);
 	connectSSL(performHandshake);
 }
 
@@ -144,6 +273,7 @@ void SecureSocketImpl::connect(const SocketAddress& address, const Poco::Timespa
 	Poco::Timespan sendTimeout = _pSocket->getSendTimeout();
 	_pSocket->setReceiveTimeout(timeout);
 	_pSocket->setSendTimeout(timeout);
+	setSessionPeer(address);
 	connectSSL(performHandshake);
 	_pSocket->setReceiveTimeout(receiveTimeout);
 	_pSocket->setSendTimeout(sendTimeout);
@@ -156,6 +286,7 @@ void SecureSocketImpl::connectNB(const SocketAddress& address)
 	
 	poco_assert (!_pSSL);
 	_pSocket->connectNB(address);
+	setSessionPeer(address);
 	connectSSL(false);
 }
 
@@ -184,9 +315,24 @@ void SecureSocketImpl::connectSSL(bool performHandshake)
 	}
 #endif
 
-	if (_pSession)
+	ClientSessionCache::Ptr pCache;
+	if (_pContext->sessionCacheEnabled())
 	{
-		SSL_set_session(_pSSL, _pSession->sslSession());
+		pCache = _pContext->getClientSessionCache();
+		if (pCache && _sessionPeer.empty())
+		{
+			// attached to an already connected socket
+			setSessionPeer(_pSocket->peerAddress());
+		}
+	}
+	Session::Ptr pSession = _pSession;
+	if (!pSession && pCache)
+	{
+		pSession = pCache->find(_sessionPeer);
+	}
+	if (pSession)
+	{
+		SSL_set_session(_pSSL, pSession->sslSession());
 	}
 	
 	try
@@ -196,6 +342,8 @@ void SecureSocketImpl::connectSSL(bool performHandshake)
 			int ret = SSL_connect(_pSSL);
 			handleError(ret);
 			verifyPeerCertificate();
+			updateSessionCache();
+			startKernelTLS();
 		}
 		else
 		{
@@ -207,6 +355,10 @@ void SecureSocketImpl::connectSSL(bool performHandshake)
 	{
 		SSL_free(_pSSL);
 		_pSSL = 0;
+		if (pCache && pSession && pSession != _pSession)
+		{
+			pCache->remove(_sessionPeer);
+		}
 		throw;
 	}
 }
@@ -244,8 +396,17 @@ void SecureSocketImpl::shutdown()
 			// most web browsers, so we just set the shutdown
 			// flag by calling SSL_shutdown() once and be
 			// done with it.
-			int rc = SSL_shutdown(_pSSL);
-			if (rc < 0) handleError(rc);
+#if defined(POCO_NETSSL_KTLS_MANUAL)
+			if (_kernelTLS)
+			{
+				shutdownKernelTLS();
+			}
+			else
+#endif
+			{
+				int rc = SSL_shutdown(_pSSL);
+				if (rc < 0) handleError(rc);
+			}
 			if (_pSocket->getBlocking()) _pSocket->shutdown();
 		}
 	}
@@ -268,13 +429,14 @@ int SecureSocketImpl::sendBytes(const void* buffer, int length, int flags)
 	if (_needHandshake)
 	{
 		rc = completeHandshake();
-		if (rc == 1)
-			verifyPeerCertificate();
-		else if (rc == 0)
+		if (rc == 0)
 			throw SSLConnectionUnexpectedlyClosedException();
-		else
+		else if (rc != 1)
 			return rc;
 	}
+#if defined(POCO_NETSSL_KTLS_MANUAL)
+	if (_kernelTLS) return sendKernelTLS(buffer, length);
+#endif
 	do
 	{
 		rc = SSL_write(_pSSL, buffer, length);
@@ -289,6 +451,58 @@ int SecureSocketImpl::sendBytes(const void* buffer, int length, int flags)
 }
 
 
+Poco::Int64 SecureSocketImpl::sendFile(const std::string& path, Poco::UInt64 offset, Poco::UInt64 count)
+{
+	poco_assert (_pSocket->initialized());
+	poco_check_ptr (_pSSL);
+
+	if (_needHandshake)
+	{
+		int rc = completeHandshake();
+		if (rc == 0)
+			throw SSLConnectionUnexpectedlyClosedException();
+		else if (rc != 1)
+			return -1;
+	}
+	if (!_kernelTLS) return -1;
+
+#if defined(POCO_NETSSL_KTLS_OPENSSL)
+	int fd = ::open(path.c_str(), O_RDONLY);
+	if (fd < 0) throw Poco::OpenFileException(path);
+	Poco::Int64 sent = 0;
+	while (static_cast<Poco::UInt64>(sent) < count)
+	{
+		ossl_ssize_t n = SSL_sendfile(_pSSL, fd, static_cast<off_t>(offset + sent), static_cast<std::size_t>(count - sent), 0);
+		if (n <= 0)
+		{
+			int rc;
+			try
+			{
+				rc = handleError(static_cast<int>(n));
+			}
+			catch (...)
+			{
+				::close(fd);
+				throw;
+			}
+			if (rc == 0 && sent == 0)
+			{
+				::close(fd);
+				throw SSLConnectionUnexpectedlyClosedException();
+			}
+			break;
+		}
+		sent += n;
+	}
+	::close(fd);
+	return sent;
+#else
+	// the kernel encrypts everything sent over the socket
+	return _pSocket->sendFile(path, offset, count);
+#endif
+}
+
+
 int SecureSocketImpl::receiveBytes(void* buffer, int length, int flags)
 {
 	poco_assert (_pSocket->initialized());
@@ -298,10 +512,7 @@ int SecureSocketImpl::receiveBytes(void* buffer, int length, int flags)
 	if (_needHandshake)
 	{
 		rc = completeHandshake();
-		if (rc == 1)
-			verifyPeerCertificate();
-		else
-			return rc;
+		if (rc != 1) return rc;
 	}
 	do
 	{
@@ -329,6 +540,8 @@ int SecureSocketImpl::completeHandshake()
 	poco_assert (_pSocket->initialized());
 	poco_check_ptr (_pSSL);
 
+	if (!_needHandshake) return 1;
+
 	int rc;
 	do
 	{
@@ -340,10 +553,32 @@ int SecureSocketImpl::completeHandshake()
 		return handleError(rc);
 	}
 	_needHandshake = false;
+	verifyPeerCertificate();
+	if (!_pContext->isForServerUse()) updateSessionCache();
+	startKernelTLS();
 	return rc;
 }
 
 
+Context::Ptr SecureSocketImpl::context() const
+{
+	Poco::FastMutex::ScopedLock lock(_contextMutex);
+
+	return _pContext;
+}
+
+
+void SecureSocketImpl::setContext(Context::Ptr pContext)
+{
+	poco_check_ptr (pContext);
+	poco_assert (!_pSSL && pContext->isForServerUse());
+
+	Poco::FastMutex::ScopedLock lock(_contextMutex);
+
+	_pContext = pContext;
+}
+
+
 void SecureSocketImpl::verifyPeerCertificate()
 {
 	if (_peerHostName.empty())
@@ -446,6 +681,18 @@ int SecureSocketImpl::handleError(int rc)
 }
 
 
+void SecureSocketImpl::setBlocking(bool flag)
+{
+	_pSocket->setBlocking(flag);
+}
+
+
+bool SecureSocketImpl::getBlocking() const
+{
+	return _pSocket->getBlocking();
+}
+
+
 void SecureSocketImpl::setPeerHostName(const std::string& peerHostName)
 {
 	_peerHostName = peerHostName;
@@ -460,6 +707,83 @@ void SecureSocketImpl::reset()
 		SSL_free(_pSSL);
 		_pSSL = 0;
 	}
+	_kernelTLS = false;
+}
+
+
+void SecureSocketImpl::setSessionPeer(const SocketAddress& address)
+{
+	_sessionPeer = ClientSessionCache::peerName(_peerHostName.empty() ? address.host().toString() : _peerHostName, address.port());
+}
+
+
+void SecureSocketImpl::updateSessionCache()
+{
+	if (_pContext->sessionCacheEnabled())
+	{
+		ClientSessionCache::Ptr pCache = _pContext->getClientSessionCache();
+		if (pCache && !_sessionPeer.empty())
+		{
+			pCache->update(_sessionPeer, currentSession(), sessionWasReused());
+		}
+	}
+}
+
+
+void SecureSocketImpl::startKernelTLS()
+{
+	_kernelTLS = false;
+	if (!_pContext->kernelTLSEnabled()) return;
+
+#if defined(POCO_NETSSL_KTLS_OPENSSL)
+	_kernelTLS = BIO_get_ktls_send(SSL_get_wbio(_pSSL)) != 0;
+#elif defined(POCO_NETSSL_KTLS_MANUAL)
+	_kernelTLS = ::startKernelTLS(_pSSL, static_cast<int>(_pSocket->sockfd()), _pContext->isForServerUse());
+#endif
+}
+
+
+int SecureSocketImpl::sendKernelTLS(const void* buffer, int length)
+{
+	if (_pSocket->getBlocking()) return _pSocket->sendBytes(buffer, length);
+
+	int rc = ::send(_pSocket->sockfd(), reinterpret_cast<const char*>(buffer), length, 0);
+	if (rc < 0)
+	{
+		int err = _pSocket->lastError();
+		if (err == POCO_EAGAIN || err == POCO_EINTR)
+			return SecureStreamSocket::ERR_SSL_WANT_WRITE;
+		else
+			SecureStreamSocketImpl::error(err);
+	}
+	return rc;
+}
+
+
+void SecureSocketImpl::shutdownKernelTLS()
+{
+#if defined(POCO_NETSSL_KTLS_MANUAL)
+	// warning level close_notify alert, sent as a record of type alert (21)
+	unsigned char alert[2] = { 1, 0 };
+	char control[CMSG_SPACE(sizeof(unsigned char))];
+	struct iovec iov;
+	iov.iov_base = alert;
+	iov.iov_len = sizeof(alert);
+	struct msghdr msg;
+	std::memset(&msg, 0, sizeof(msg));
+	msg.msg_iov = &iov;
+	msg.msg_iovlen = 1;
+	msg.msg_control = control;
+	msg.msg_controllen = sizeof(control);
+	struct cmsghdr* pHeader = CMSG_FIRSTHDR(&msg);
+	pHeader->cmsg_level = SOL_TLS;
+	pHeader->cmsg_type = TLS_SET_RECORD_TYPE;
+	pHeader->cmsg_len = CMSG_LEN(sizeof(unsigned char));
+	*CMSG_DATA(pHeader) = 21;
+	msg.msg_controllen = pHeader->cmsg_len;
+	::sendmsg(_pSocket->sockfd(), &msg, 0);
+#endif
+	SSL_set_shutdown(_pSSL, SSL_get_shutdown(_pSSL) | SSL_SENT_SHUTDOWN);
 }
 
 
@@ -0,0 +1,393 @@
+//
+// SecureSocketReactorHandler.cpp
+//
+// $Id: //poco/1.4/NetSSL_OpenSSL/src/SecureSocketReactorHandler.cpp#1 $
+//
+// Library: NetSSL_OpenSSL
+// Package: SSLSockets
+// Module:  SecureSocketReactorHandler
+//
+// Copyright (c) 2013, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+// 
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+
+
+
+#include "Poco/Net/SecureSocketReactorHandler.h"
+#include "Poco/Net/SSLException.h"
+#include "Poco/Observer.h"
+
+
+namespace Poco {
+namespace Net {
+
+
+SecureSocketReactorHandler::SecureSocketReactorHandler(const StreamSocket& socket, SocketReactor& reactor):
+	_socket(socket),
+	_reactor(reactor),
+	_state(STATE_HANDSHAKE),
+	_handshakeWants(WANT_NONE),
+	_readWants(WANT_NONE),
+	_writeWants(WANT_NONE),
+	_handshakeComplete(false),
+	_readableRegistered(false),
+	_writableRegistered(false),
+	_processing(false),
+	_buffer(BUFFER_SIZE),
+	_outputOffset(0)
+{
+	_socket.setBlocking(false);
+	_reactor.addEventHandler(_socket, Poco::Observer<SecureSocketReactorHandler, ErrorNotification>(*this, &SecureSocketReactorHandler::onSocketError));
+	_reactor.addEventHandler(_socket, Poco::Observer<SecureSocketReactorHandler, ShutdownNotification>(*this, &SecureSocketReactorHandler::onShutdown));
+	// the first notification starts the handshake
+	updateRegistration();
+}
+
+
+SecureSocketReactorHandler::~SecureSocketReactorHandler()
+{
+	try
+	{
+		cancelHandshakeTimer();
+		if (_readableRegistered)
+			_reactor.removeEventHandler(_socket, Poco::Observer<SecureSocketReactorHandler, ReadableNotification>(*this, &SecureSocketReactorHandler::onReadable));
+		if (_writableRegistered)
+			_reactor.removeEventHandler(_socket, Poco::Observer<SecureSocketReactorHandler, WritableNotification>(*this, &SecureSocketReactorHandler::onWritable));
+		_reactor.removeEventHandler(_socket, Poco::Observer<SecureSocketReactorHandler, ErrorNotification>(*this, &SecureSocketReactorHandler::onSocketError));
+		_reactor.removeEventHandler(_socket, Poco::Observer<SecureSocketReactorHandler, ShutdownNotification>(*this, &SecureSocketReactorHandler::onShutdown));
+	}
+	catch (...)
+	{
+	}
+}
+
+
+void SecureSocketReactorHandler::send(const void* buffer, int length)
+{
+	poco_assert (length >= 0);
+
+	if (_state == STATE_CLOSING || _state == STATE_CLOSED)
+		throw Poco::InvalidAccessException("Connection is closing");
+
+	if (_outputOffset > 0 && _outputOffset == _output.size())
+	{
+		_output.clear();
+		_outputOffset = 0;
+	}
+	_output.append(reinterpret_cast<const char*>(buffer), length);
+	if (!_processing) process();
+}
+
+
+void SecureSocketReactorHandler::close()
+{
+	if (_state == STATE_CLOSING || _state == STATE_CLOSED) return;
+
+	_state = STATE_CLOSING;
+	if (!_processing) process();
+}
+
+
+void SecureSocketReactorHandler::setHandshakeTimeout(const Poco::Timespan& timeout)
+{
+	if (_handshakeComplete) return;
+
+	if (_pHandshakeTimer)
+		_reactor.rescheduleTimer(_pHandshakeTimer, timeout);
+	else
+		_pHandshakeTimer = _reactor.scheduleTimer(_socket, timeout, Poco::Observer<SecureSocketReactorHandler, TimerNotification>(*this, &SecureSocketReactorHandler::onHandshakeTimeout));
+}
+
+
+void SecureSocketReactorHandler::onHandshake()
+{
+}
+
+
+void SecureSocketReactorHandler::onClose()
+{
+}
+
+
+void SecureSocketReactorHandler::onError(const Poco::Exception& exc)
+{
+}
+
+
+void SecureSocketReactorHandler::onReadable(ReadableNotification* pNf)
+{
+	pNf->release();
+	process();
+}
+
+
+void SecureSocketReactorHandler::onWritable(WritableNotification* pNf)
+{
+	pNf->release();
+	process();
+}
+
+
+void SecureSocketReactorHandler::onSocketError(ErrorNotification* pNf)
+{
+	pNf->release();
+	// the next I/O operation reports the error
+	process();
+}
+
+
+void SecureSocketReactorHandler::onShutdown(ShutdownNotification* pNf)
+{
+	pNf->release();
+	_state = STATE_CLOSED;
+	finish();
+}
+
+
+void SecureSocketReactorHandler::onHandshakeTimeout(TimerNotification* pNf)
+{
+	pNf->release();
+	_pHandshakeTimer = 0;
+	if (!_handshakeComplete && _state != STATE_CLOSED)
+	{
+		onError(Poco::TimeoutException("SSL handshake timed out"));
+		_state = STATE_CLOSED;
+		finish();
+	}
+}
+
+
+void SecureSocketReactorHandler::process()
+{
+	_processing = true;
+	try
+	{
+		step();
+	}
+	catch (Poco::Exception& exc)
+	{
+		_state = STATE_CLOSED;
+		onError(exc);
+	}
+	_processing = false;
+	if (_state == STATE_CLOSED)
+		finish();
+	else
+		updateRegistration();
+}
+
+
+void SecureSocketReactorHandler::step()
+{
+	if (!_handshakeComplete)
+	{
+		if (!handshake()) return;
+	}
+	if (_state == STATE_ESTABLISHED)
+	{
+		if (!receive())
+		{
+			_state = STATE_CLOSED;
+			return;
+		}
+	}
+	flush();
+	if (_state == STATE_CLOSING && pendingOutput() == 0)
+	{
+		try
+		{
+			_socket.shutdown();
+		}
+		catch (Poco::Exception&)
+		{
+		}
+		_state = STATE_CLOSED;
+	}
+}
+
+
+bool SecureSocketReactorHandler::handshake()
+{
+	int rc = _socket.completeHandshake();
+	if (rc == 1)
+	{
+		_handshakeWants = WANT_NONE;
+		_handshakeComplete = true;
+		cancelHandshakeTimer();
+		if (_state == STATE_HANDSHAKE) _state = STATE_ESTABLISHED;
+		onHandshake();
+		return _state != STATE_CLOSED;
+	}
+	else if (rc == 0)
+	{
+		throw SSLConnectionUnexpectedlyClosedException();
+	}
+	_handshakeWants = want(rc);
+	return false;
+}
+
+
+bool SecureSocketReactorHandler::receive()
+{
+	// read until the SSL layer needs more data from the socket,
+	// as data already buffered by the SSL layer does not make
+	// the socket readable again
+	while (_state == STATE_ESTABLISHED)
+	{
+		int n;
+		try
+		{
+			n = _socket.receiveBytes(_buffer.begin(), static_cast<int>(_buffer.size()));
+		}
+		catch (SSLConnectionUnexpectedlyClosedException&)
+		{
+			// peer closed the connection without sending close_notify
+			return false;
+		}
+		if (n > 0)
+		{
+			_readWants = WANT_NONE;
+			onData(_buffer.begin(), n);
+		}
+		else if (n == 0)
+		{
+			return false;
+		}
+		else
+		{
+			_readWants = want(n);
+			break;
+		}
+	}
+	return true;
+}
+
+
+void SecureSocketReactorHandler::flush()
+{
+	while (pendingOutput() > 0)
+	{
+		int n = _socket.sendBytes(_output.data() + _outputOffset, static_cast<int>(pendingOutput()));
+		if (n > 0)
+		{
+			_writeWants = WANT_NONE;
+			_outputOffset += n;
+		}
+		else
+		{
+			_writeWants = want(n);
+			return;
+		}
+	}
+	_writeWants = WANT_NONE;
+	_output.clear();
+	_outputOffset = 0;
+}
+
+
+void SecureSocketReactorHandler::updateRegistration()
+{
+	bool readable;
+	bool writable;
+	if (!_handshakeComplete)
+	{
+		// before the first attempt, wait for whatever comes first
+		readable = _handshakeWants != WANT_WRITE;
+		writable = _handshakeWants != WANT_READ;
+	}
+	else if (_state == STATE_ESTABLISHED)
+	{
+		// always listen for incoming data (or the peer closing the connection)
+		readable = true;
+		writable = _readWants == WANT_WRITE || (pendingOutput() > 0 && _writeWants != WANT_READ);
+	}
+	else
+	{
+		// closing: only the remaining output matters
+		readable = _writeWants == WANT_READ;
+		writable = _writeWants != WANT_READ;
+	}
+
+	if (readable != _readableRegistered)
+	{
+		Poco::Observer<SecureSocketReactorHandler, ReadableNotification> observer(*this, &SecureSocketReactorHandler::onReadable);
+		if (readable)
+			_reactor.addEventHandler(_socket, observer);
+		else
+			_reactor.removeEventHandler(_socket, observer);
+		_readableRegistered = readable;
+	}
+	if (writable != _writableRegistered)
+	{
+		Poco::Observer<SecureSocketReactorHandler, WritableNotification> observer(*this, &SecureSocketReactorHandler::onWritable);
+		if (writable)
+			_reactor.addEventHandler(_socket, observer);
+		else
+			_reactor.removeEventHandler(_socket, observer);
+		_writableRegistered = writable;
+	}
+}
+
+
+void SecureSocketReactorHandler::cancelHandshakeTimer()
+{
+	if (_pHandshakeTimer)
+	{
+		_reactor.cancelTimer(_pHandshakeTimer);
+		_pHandshakeTimer = 0;
+	}
+}
+
+
+void SecureSocketReactorHandler::finish()
+{
+	try
+	{
+		_socket.close();
+	}
+	catch (Poco::Exception&)
+	{
+	}
+	onClose();
+	delete this;
+}
+
+
+SecureSocketReactorHandler::Want SecureSocketReactorHandler::want(int rc)
+{
+	switch (rc)
+	{
+	case SecureStreamSocket::ERR_SSL_WANT_READ:
+		return WANT_READ;
+	case SecureStreamSocket::ERR_SSL_WANT_WRITE:
+		return WANT_WRITE;
+	default:
+		return WANT_NONE;
+	}
+}
+
+
+} } // namespace Poco::Net
@@ -282,6 +282,12 @@ bool SecureStreamSocket::sessionWasReused()
 }
 
 
+bool SecureStreamSocket::kernelTLSActive() const
+{
+	return static_cast<SecureStreamSocketImpl*>(impl())->kernelTLSActive();
+}
+
+
 void SecureStreamSocket::abort()
 {
 	static_cast<SecureStreamSocketImpl*>(impl())->abort();
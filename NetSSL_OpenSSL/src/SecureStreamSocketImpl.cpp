@@ -155,6 +155,24 @@ int SecureStreamSocketImpl::sendBytes(const void* buffer, int length, int flags)
 }
 
 
+void SecureStreamSocketImpl::setBlocking(bool flag)
+{
+	_impl.setBlocking(flag);
+}
+
+
+bool SecureStreamSocketImpl::getBlocking() const
+{
+	return _impl.getBlocking();
+}
+
+
+Poco::Int64 SecureStreamSocketImpl::sendFile(const std::string& path, Poco::UInt64 offset, Poco::UInt64 count)
+{
+	return _impl.sendFile(path, offset, count);
+}
+
+
 int SecureStreamSocketImpl::receiveBytes(void* buffer, int length, int flags)
 {
 	return _impl.receiveBytes(buffer, length, flags);
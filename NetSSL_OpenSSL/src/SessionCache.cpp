@@ -0,0 +1,91 @@
+//
+// SessionCache.cpp
+//
+// $Id: //poco/1.4/NetSSL_OpenSSL/src/SessionCache.cpp#1 $
+//
+// Library: NetSSL_OpenSSL
+// Package: SSLCore
+// Module:  SessionCache
+//
+// Copyright (c) 2013, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+// 
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+
+
+
+#include "Poco/Net/SessionCache.h"
+
+
+namespace Poco {
+namespace Net {
+
+
+SessionCache::SessionCache()
+{
+}
+
+
+SessionCache::~SessionCache()
+{
+}
+
+
+void SessionCache::add(const std::string& id, const std::string& session, const Poco::Timestamp& expires)
+{
+	if (addImpl(id, session, expires)) ++_stores;
+}
+
+
+bool SessionCache::get(const std::string& id, std::string& session)
+{
+	if (getImpl(id, session))
+	{
+		++_hits;
+		return true;
+	}
+	else
+	{
+		++_misses;
+		return false;
+	}
+}
+
+
+void SessionCache::remove(const std::string& id)
+{
+	removeImpl(id);
+}
+
+
+void SessionCache::resetStatistics()
+{
+	_hits   = 0;
+	_misses = 0;
+	_stores = 0;
+}
+
+
+} } // namespace Poco::Net
@@ -0,0 +1,194 @@
+//
+// SessionTicketKeyManager.cpp
+//
+// $Id: //poco/1.4/NetSSL_OpenSSL/src/SessionTicketKeyManager.cpp#1 $
+//
+// Library: NetSSL_OpenSSL
+// Package: SSLCore
+// Module:  SessionTicketKeyManager
+//
+// Copyright (c) 2013, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+// 
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+
+
+
+#include "Poco/Net/SessionTicketKeyManager.h"
+#include "Poco/Net/SSLException.h"
+#include "Poco/Net/Utility.h"
+#include "Poco/Crypto/OpenSSLInitializer.h"
+#include "Poco/Exception.h"
+#include <openssl/hmac.h>
+#include <openssl/evp.h>
+#include <openssl/rand.h>
+#include <cstring>
+
+
+namespace Poco {
+namespace Net {
+
+
+SessionTicketKeyManager::SessionTicketKeyManager(const Poco::Timespan& rotationInterval, int keyCount):
+	_rotationInterval(rotationInterval),
+	_keyCount(keyCount),
+	_period(0)
+{
+	poco_assert (rotationInterval.totalMicroseconds() > 0 && keyCount > 0);
+
+	Poco::Crypto::OpenSSLInitializer::initialize();
+	unsigned char secret[SECRET_SIZE];
+	if (RAND_bytes(secret, sizeof(secret)) != 1)
+	{
+		Poco::Crypto::OpenSSLInitializer::uninitialize();
+		throw SSLException("Cannot generate session ticket secret", Utility::getLastError());
+	}
+	_secret.assign(reinterpret_cast<char*>(secret), sizeof(secret));
+	std::memset(secret, 0, sizeof(secret));
+}
+
+
+SessionTicketKeyManager::SessionTicketKeyManager(const std::string& secret, const Poco::Timespan& rotationInterval, int keyCount):
+	_secret(secret),
+	_rotationInterval(rotationInterval),
+	_keyCount(keyCount),
+	_period(0)
+{
+	poco_assert (rotationInterval.totalMicroseconds() > 0 && keyCount > 0);
+	if (secret.empty()) throw Poco::InvalidArgumentException("Session ticket secret must not be empty");
+
+	Poco::Crypto::OpenSSLInitializer::initialize();
+}
+
+
+SessionTicketKeyManager::~SessionTicketKeyManager()
+{
+	for (std::vector<Key>::iterator it = _keys.begin(); it != _keys.end(); ++it)
+	{
+		std::memset(&*it, 0, sizeof(Key));
+	}
+	Poco::Crypto::OpenSSLInitializer::uninitialize();
+}
+
+
+void SessionTicketKeyManager::encryptionKey(Key& key)
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	update();
+	key = _keys.front();
+	++_issued;
+}
+
+
+bool SessionTicketKeyManager::decryptionKey(const unsigned char* name, Key& key, bool& renew)
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	update();
+	for (std::size_t i = 0; i < _keys.size(); ++i)
+	{
+		if (std::memcmp(_keys[i].name, name, NAME_SIZE) == 0)
+		{
+			key = _keys[i];
+			renew = i > 0;
+			if (renew)
+				++_renewed;
+			else
+				++_accepted;
+			return true;
+		}
+	}
+	++_rejected;
+	return false;
+}
+
+
+void SessionTicketKeyManager::resetStatistics()
+{
+	_issued   = 0;
+	_accepted = 0;
+	_renewed  = 0;
+	_rejected = 0;
+}
+
+
+Poco::Int64 SessionTicketKeyManager::period(const Poco::Timestamp& time) const
+{
+	return time.epochMicroseconds()/_rotationInterval.totalMicroseconds();
+}
+
+
+void SessionTicketKeyManager::update()
+{
+	Poco::Int64 current = period(Poco::Timestamp());
+	if (!_keys.empty() && current == _period) return;
+
+	// _keys[0] is the current key, _keys[i] the key of period current - i
+	std::vector<Key> keys;
+	keys.reserve(_keyCount);
+	for (int i = 0; i < _keyCount; ++i)
+	{
+		Poco::Int64 p = current - i;
+		Poco::Int64 age = _period - p;
+		if (!_keys.empty() && age >= 0 && age < static_cast<Poco::Int64>(_keys.size()))
+			keys.push_back(_keys[static_cast<std::size_t>(age)]);
+		else
+			keys.push_back(deriveKey(p));
+	}
+	_keys.swap(keys);
+	_period = current;
+}
+
+
+SessionTicketKeyManager::Key SessionTicketKeyManager::deriveKey(Poco::Int64 period) const
+{
+	unsigned char label[16];
+	std::memcpy(label, "ticket key", 10);
+	for (int i = 0; i < 6; ++i)
+	{
+		label[10 + i] = static_cast<unsigned char>((period >> (8*(5 - i))) & 0xFF);
+	}
+
+	unsigned char digest[EVP_MAX_MD_SIZE];
+	unsigned int length = 0;
+	Key key;
+	if (!HMAC(EVP_sha256(), _secret.data(), static_cast<int>(_secret.size()), label, sizeof(label), digest, &length))
+		throw SSLException("Cannot derive session ticket key", Utility::getLastError());
+	std::memcpy(key.hmacKey, digest, KEY_SIZE);
+	std::memcpy(key.aesKey, digest + KEY_SIZE, KEY_SIZE);
+
+	// the key name is derived separately, so that it
+	// reveals nothing about the keys themselves
+	label[0] = 'T';
+	if (!HMAC(EVP_sha256(), _secret.data(), static_cast<int>(_secret.size()), label, sizeof(label), digest, &length))
+		throw SSLException("Cannot derive session ticket key", Utility::getLastError());
+	std::memcpy(key.name, digest, NAME_SIZE);
+	std::memset(digest, 0, sizeof(digest));
+	return key;
+}
+
+
+} } // namespace Poco::Net
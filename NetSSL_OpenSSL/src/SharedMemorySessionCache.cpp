@@ -0,0 +1,225 @@
+//
+// SharedMemorySessionCache.cpp
+//
+// $Id: //poco/1.4/NetSSL_OpenSSL/src/SharedMemorySessionCache.cpp#1 $
+//
+// Library: NetSSL_OpenSSL
+// Package: SSLCore
+// Module:  SharedMemorySessionCache
+//
+// Copyright (c) 2013, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+// 
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+
+
+
+#include "Poco/Net/SharedMemorySessionCache.h"
+#include "Poco/Exception.h"
+#include <cstring>
+#include <cstddef>
+
+
+namespace Poco {
+namespace Net {
+
+
+struct SharedMemorySessionCache::Header
+{
+	Poco::UInt32 magic;
+	Poco::UInt32 slotCount;
+	Poco::UInt32 slotSize;
+	Poco::UInt32 reserved;
+};
+
+
+struct SharedMemorySessionCache::Slot
+{
+	Poco::Int64  expires;
+	Poco::UInt16 idLength;
+	Poco::UInt16 reserved;
+	Poco::UInt32 sessionLength;
+	char         id[MAX_ID_LENGTH];
+	char         session[1];
+};
+
+
+namespace
+{
+	const Poco::UInt32 CACHE_MAGIC = 0x504F5353; // "POSS"
+}
+
+
+SharedMemorySessionCache::SharedMemorySessionCache(const std::string& name, std::size_t slotCount, std::size_t slotSize, bool owner):
+	_name(name),
+	_slotCount(slotCount),
+	_slotSize(slotSize),
+	_mutex(name + ".sessions")
+{
+	poco_assert (slotCount > 0 && slotSize > 0);
+
+	std::size_t size = sizeof(Header) + slotCount*stride(slotSize);
+	Poco::NamedMutex::ScopedLock lock(_mutex);
+	Poco::SharedMemory memory(name, size, Poco::SharedMemory::AM_WRITE, 0, owner);
+	_memory.swap(memory);
+	Header* pHeader = reinterpret_cast<Header*>(_memory.begin());
+	if (owner)
+	{
+		std::memset(_memory.begin(), 0, size);
+		pHeader->magic     = CACHE_MAGIC;
+		pHeader->slotCount = static_cast<Poco::UInt32>(slotCount);
+		pHeader->slotSize  = static_cast<Poco::UInt32>(slotSize);
+	}
+	else if (pHeader->magic != CACHE_MAGIC || pHeader->slotCount != slotCount || pHeader->slotSize != slotSize)
+	{
+		throw Poco::InvalidArgumentException("Shared memory session cache not initialized or configured differently", name);
+	}
+}
+
+
+SharedMemorySessionCache::~SharedMemorySessionCache()
+{
+}
+
+
+void SharedMemorySessionCache::clear()
+{
+	Poco::NamedMutex::ScopedLock lock(_mutex);
+
+	for (std::size_t i = 0; i < _slotCount; ++i)
+	{
+		Slot* pSlot = slot(i);
+		pSlot->expires  = 0;
+		pSlot->idLength = 0;
+	}
+}
+
+
+bool SharedMemorySessionCache::addImpl(const std::string& id, const std::string& session, const Poco::Timestamp& expires)
+{
+	if (id.empty() || id.size() > MAX_ID_LENGTH || session.size() > _slotSize) return false;
+
+	Poco::Timestamp::TimeVal now = Poco::Timestamp().epochMicroseconds();
+	Poco::NamedMutex::ScopedLock lock(_mutex);
+
+	Slot* pSlot = find(id);
+	if (!pSlot)
+	{
+		// take the first free or expired slot, or else
+		// evict the session that expires first
+		std::size_t start = hash(id);
+		for (std::size_t i = 0; i < PROBE_COUNT; ++i)
+		{
+			Slot* pCandidate = slot((start + i) % _slotCount);
+			if (pCandidate->idLength == 0 || pCandidate->expires <= now)
+			{
+				pSlot = pCandidate;
+				break;
+			}
+			if (!pSlot || pCandidate->expires < pSlot->expires)
+				pSlot = pCandidate;
+		}
+	}
+	pSlot->expires       = expires.epochMicroseconds();
+	pSlot->idLength      = static_cast<Poco::UInt16>(id.size());
+	pSlot->sessionLength = static_cast<Poco::UInt32>(session.size());
+	std::memcpy(pSlot->id, id.data(), id.size());
+	std::memcpy(pSlot->session, session.data(), session.size());
+	return true;
+}
+
+
+bool SharedMemorySessionCache::getImpl(const std::string& id, std::string& session)
+{
+	if (id.empty() || id.size() > MAX_ID_LENGTH) return false;
+
+	Poco::Timestamp::TimeVal now = Poco::Timestamp().epochMicroseconds();
+	Poco::NamedMutex::ScopedLock lock(_mutex);
+
+	Slot* pSlot = find(id);
+	if (pSlot && pSlot->expires > now)
+	{
+		session.assign(pSlot->session, pSlot->sessionLength);
+		return true;
+	}
+	return false;
+}
+
+
+void SharedMemorySessionCache::removeImpl(const std::string& id)
+{
+	if (id.empty() || id.size() > MAX_ID_LENGTH) return;
+
+	Poco::NamedMutex::ScopedLock lock(_mutex);
+
+	Slot* pSlot = find(id);
+	if (pSlot)
+	{
+		pSlot->expires  = 0;
+		pSlot->idLength = 0;
+	}
+}
+
+
+std::size_t SharedMemorySessionCache::stride(std::size_t slotSize)
+{
+	std::size_t size = offsetof(Slot, session) + slotSize;
+	return (size + 7) & ~std::size_t(7);
+}
+
+
+SharedMemorySessionCache::Slot* SharedMemorySessionCache::slot(std::size_t index) const
+{
+	return reinterpret_cast<Slot*>(_memory.begin() + sizeof(Header) + index*stride(_slotSize));
+}
+
+
+std::size_t SharedMemorySessionCache::hash(const std::string& id) const
+{
+	// FNV-1a
+	Poco::UInt32 h = 2166136261U;
+	for (std::string::const_iterator it = id.begin(); it != id.end(); ++it)
+	{
+		h ^= static_cast<unsigned char>(*it);
+		h *= 16777619U;
+	}
+	return h % _slotCount;
+}
+
+
+SharedMemorySessionCache::Slot* SharedMemorySessionCache::find(const std::string& id) const
+{
+	std::size_t start = hash(id);
+	for (std::size_t i = 0; i < PROBE_COUNT; ++i)
+	{
+		Slot* pSlot = slot((start + i) % _slotCount);
+		if (pSlot->idLength == id.size() && std::memcmp(pSlot->id, id.data(), id.size()) == 0)
+			return pSlot;
+	}
+	return 0;
+}
+
+
+} } // namespace Poco::Net
@@ -43,7 +43,12 @@
 #include "Poco/Net/HTTPResponse.h"
 #include "Poco/Net/HTTPServerResponse.h"
 #include "Poco/Net/SecureServerSocket.h"
+#include "Poco/Net/Context.h"
+#include "Poco/Util/Application.h"
+#include "Poco/Util/AbstractConfiguration.h"
 #include "Poco/StreamCopier.h"
+#include "Poco/TemporaryFile.h"
+#include "Poco/FileStream.h"
 #include <sstream>
 
 
@@ -58,6 +63,8 @@ using Poco::Net::HTTPResponse;
 using Poco::Net::HTTPServerResponse;
 using Poco::Net::HTTPMessage;
 using Poco::Net::SecureServerSocket;
+using Poco::Net::Context;
+using Poco::Util::Application;
 using Poco::StreamCopier;
 
 
@@ -115,6 +122,19 @@ namespace
 		}
 	};
 	
+	class SendFileRequestHandler: public HTTPRequestHandler
+	{
+	public:
+		void handleRequest(HTTPServerRequest& request, HTTPServerResponse& response)
+		{
+			response.sendFile(path, "application/octet-stream");
+		}
+		
+		static std::string path;
+	};
+	
+	std::string SendFileRequestHandler::path;
+
 	class RequestHandlerFactory: public HTTPRequestHandlerFactory
 	{
 	public:
@@ -128,6 +148,8 @@ namespace
 				return new RedirectRequestHandler();
 			else if (request.getURI() == "/auth")
 				return new AuthRequestHandler();
+			else if (request.getURI() == "/file")
+				return new SendFileRequestHandler();
 			else
 				return 0;
 		}
@@ -344,6 +366,61 @@ void HTTPSServerTest::testNotImpl()
 }
 
 
+void HTTPSServerTest::testSendFile()
+{
+	Poco::TemporaryFile file;
+	std::string content;
+	for (int i = 0; i < 1024*1024; ++i) content += static_cast<char>('a' + i % 26);
+	{
+		Poco::FileOutputStream ostr(file.path());
+		ostr << content;
+	}
+	SendFileRequestHandler::path = file.path();
+
+	Context::Ptr pServerContext = new Context(
+		Context::SERVER_USE, 
+		Application::instance().config().getString("openSSL.server.privateKeyFile"),
+		Application::instance().config().getString("openSSL.server.privateKeyFile"),
+		Application::instance().config().getString("openSSL.server.caConfig"),
+		Context::VERIFY_NONE);
+	pServerContext->enableKernelTLS();
+	assert (pServerContext->kernelTLSEnabled());
+	
+	SecureServerSocket svs(0, 64, pServerContext);
+	HTTPServerParams* pParams = new HTTPServerParams;
+	pParams->setKeepAlive(true);
+	HTTPServer srv(new RequestHandlerFactory, svs, pParams);
+	srv.start();
+	
+	// the file is sent with sendfile() if kernel TLS is available,
+	// and through OpenSSL otherwise
+	HTTPSClientSession cs("localhost", svs.address().port());
+	cs.setKeepAlive(true);
+	for (int i = 0; i < 2; ++i)
+	{
+		HTTPRequest request("GET", "/file", HTTPMessage::HTTP_1_1);
+		cs.sendRequest(request);
+		HTTPResponse response;
+		std::istream& rs = cs.receiveResponse(response);
+		std::ostringstream ostr;
+		StreamCopier::copyStream(rs, ostr);
+		assert (response.getStatus() == HTTPResponse::HTTP_OK);
+		assert (response.getContentLength() == content.size());
+		assert (response.getContentType() == "application/octet-stream");
+		assert (ostr.str() == content);
+	}
+
+	HTTPRequest request("HEAD", "/file", HTTPMessage::HTTP_1_1);
+	cs.sendRequest(request);
+	HTTPResponse response;
+	std::istream& rs = cs.receiveResponse(response);
+	std::ostringstream ostr;
+	StreamCopier::copyStream(rs, ostr);
+	assert (response.getContentLength() == content.size());
+	assert (ostr.str().empty());
+}
+
+
 void HTTPSServerTest::setUp()
 {
 }
@@ -366,6 +443,7 @@ CppUnit::Test* HTTPSServerTest::suite()
 	CppUnit_addTest(pSuite, HTTPSServerTest, testRedirect);
 	CppUnit_addTest(pSuite, HTTPSServerTest, testAuth);
 	CppUnit_addTest(pSuite, HTTPSServerTest, testNotImpl);
+	CppUnit_addTest(pSuite, HTTPSServerTest, testSendFile);
 
 	return pSuite;
 }
@@ -54,6 +54,7 @@ public:
 	void testRedirect();
 	void testAuth();
 	void testNotImpl();
+	void testSendFile();
 
 	void setUp();
 	void tearDown();
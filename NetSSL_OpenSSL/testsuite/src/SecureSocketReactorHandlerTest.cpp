@@ -0,0 +1,368 @@
+//
+// SecureSocketReactorHandlerTest.cpp
+//
+// $Id: //poco/1.4/NetSSL_OpenSSL/testsuite/src/SecureSocketReactorHandlerTest.cpp#1 $
+//
+// Copyright (c) 2013, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+// 
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+
+
+
+#include "SecureSocketReactorHandlerTest.h"
+#include "CppUnit/TestCaller.h"
+#include "CppUnit/TestSuite.h"
+#include "Poco/Net/SecureSocketReactorHandler.h"
+#include "Poco/Net/SecureServerSocket.h"
+#include "Poco/Net/SecureStreamSocket.h"
+#include "Poco/Net/SocketReactor.h"
+#include "Poco/Net/SocketAcceptor.h"
+#include "Poco/Net/StreamSocket.h"
+#include "Poco/Net/SocketAddress.h"
+#include "Poco/Net/Context.h"
+#include "Poco/Net/SSLManager.h"
+#include "Poco/Util/Application.h"
+#include "Poco/Util/AbstractConfiguration.h"
+#include "Poco/AtomicCounter.h"
+#include "Poco/Stopwatch.h"
+#include "Poco/Thread.h"
+#include "Poco/Event.h"
+
+
+using Poco::Net::SecureSocketReactorHandler;
+using Poco::Net::SecureServerSocket;
+using Poco::Net::SecureStreamSocket;
+using Poco::Net::SocketReactor;
+using Poco::Net::SocketAcceptor;
+using Poco::Net::StreamSocket;
+using Poco::Net::SocketAddress;
+using Poco::Net::Context;
+using Poco::Net::SSLManager;
+using Poco::Util::Application;
+using Poco::AtomicCounter;
+using Poco::Stopwatch;
+using Poco::Thread;
+using Poco::Event;
+
+
+namespace
+{
+	class EchoHandler: public SecureSocketReactorHandler
+	{
+	public:
+		EchoHandler(const StreamSocket& socket, SocketReactor& reactor):
+			SecureSocketReactorHandler(socket, reactor)
+		{
+		}
+		
+		static AtomicCounter handshakes;
+		static AtomicCounter errors;
+		static AtomicCounter closed;
+		static AtomicCounter timeouts;
+
+		static void reset()
+		{
+			handshakes = 0;
+			errors = 0;
+			closed = 0;
+			timeouts = 0;
+		}
+
+	protected:
+		void onHandshake()
+		{
+			++handshakes;
+		}
+		
+		void onData(const char* data, int length)
+		{
+			send(data, length);
+		}
+		
+		void onClose()
+		{
+			++closed;
+		}
+		
+		void onError(const Poco::Exception& exc)
+		{
+			++errors;
+			if (dynamic_cast<const Poco::TimeoutException*>(&exc)) ++timeouts;
+		}
+	};
+	
+	AtomicCounter EchoHandler::handshakes;
+	AtomicCounter EchoHandler::errors;
+	AtomicCounter EchoHandler::closed;
+	AtomicCounter EchoHandler::timeouts;
+
+
+	class TimeoutEchoHandler: public EchoHandler
+	{
+	public:
+		TimeoutEchoHandler(const StreamSocket& socket, SocketReactor& reactor):
+			EchoHandler(socket, reactor)
+		{
+			setHandshakeTimeout(Poco::Timespan(0, 300000));
+		}
+	};
+
+
+	class ClientHandler: public SecureSocketReactorHandler
+	{
+	public:
+		ClientHandler(const StreamSocket& socket, SocketReactor& reactor, const std::string& data, std::string& received, Event& done):
+			SecureSocketReactorHandler(socket, reactor),
+			_data(data),
+			_received(received),
+			_done(done)
+		{
+		}
+
+	protected:
+		void onHandshake()
+		{
+			send(_data.data(), (int) _data.size());
+		}
+
+		void onData(const char* data, int length)
+		{
+			_received.append(data, length);
+			if (_received.size() == _data.size()) close();
+		}
+		
+		void onClose()
+		{
+			_done.set();
+		}
+
+	private:
+		std::string _data;
+		std::string& _received;
+		Event& _done;
+	};
+	
+	
+	Context::Ptr createServerContext()
+	{
+		return new Context(
+			Context::SERVER_USE, 
+			Application::instance().config().getString("openSSL.server.privateKeyFile"),
+			Application::instance().config().getString("openSSL.server.privateKeyFile"),
+			Application::instance().config().getString("openSSL.server.caConfig"),
+			Context::VERIFY_NONE,
+			9,
+			true,
+			"ALL:!ADH:!LOW:!EXP:!MD5:@STRENGTH");	
+	}
+
+
+	Context::Ptr createClientContext()
+	{
+		return new Context(
+			Context::CLIENT_USE, 
+			Application::instance().config().getString("openSSL.client.privateKeyFile"),
+			Application::instance().config().getString("openSSL.client.privateKeyFile"),
+			Application::instance().config().getString("openSSL.client.caConfig"),
+			Context::VERIFY_RELAXED,
+			9,
+			true,
+			"ALL:!ADH:!LOW:!EXP:!MD5:@STRENGTH");
+	}
+}
+
+
+SecureSocketReactorHandlerTest::SecureSocketReactorHandlerTest(const std::string& name): CppUnit::TestCase(name)
+{
+}
+
+
+SecureSocketReactorHandlerTest::~SecureSocketReactorHandlerTest()
+{
+}
+
+
+void SecureSocketReactorHandlerTest::testServer()
+{
+	SecureServerSocket svs(0, 64, createServerContext());
+	SocketReactor reactor;
+	SocketAcceptor<EchoHandler> acceptor(svs, reactor);
+	Thread thread;
+	thread.start(reactor);
+
+	Context::Ptr pClientContext = createClientContext();
+	SocketAddress sa("127.0.0.1", svs.address().port());
+	SecureStreamSocket ss1(sa, pClientContext);
+	SecureStreamSocket ss2(sa, pClientContext);
+	std::string data("hello, world");
+	ss1.sendBytes(data.data(), (int) data.size());
+	ss2.sendBytes(data.data(), (int) data.size());
+	char buffer[256];
+	int n = ss1.receiveBytes(buffer, sizeof(buffer));
+	assert (std::string(buffer, n) == data);
+	n = ss2.receiveBytes(buffer, sizeof(buffer));
+	assert (std::string(buffer, n) == data);
+	ss1.close();
+	ss2.close();
+	Thread::sleep(200);
+	assert (EchoHandler::handshakes == 2);
+	assert (EchoHandler::closed == 2);
+	assert (EchoHandler::errors == 0);
+
+	reactor.stop();
+	thread.join();
+}
+
+
+void SecureSocketReactorHandlerTest::testClient()
+{
+	SecureServerSocket svs(0, 64, createServerContext());
+	SocketReactor reactor;
+	SocketAcceptor<EchoHandler> acceptor(svs, reactor);
+
+	// a large amount of data, so that both sides have
+	// to wait for the socket to become writable
+	std::string data;
+	for (int i = 0; data.size() < 1024*1024; ++i)
+	{
+		data += "0123456789abcdefghijklmnopqrstuvwxyz";
+		data += char('A' + i % 26);
+	}
+	std::string received;
+	Event done;
+	SecureStreamSocket ss(createClientContext());
+	ss.connectNB(SocketAddress("127.0.0.1", svs.address().port()));
+	new ClientHandler(ss, reactor, data, received, done);
+
+	Thread thread;
+	thread.start(reactor);
+	done.wait(10000);
+	reactor.stop();
+	thread.join();
+	assert (received == data);
+	assert (EchoHandler::handshakes == 1);
+	assert (EchoHandler::errors == 0);
+}
+
+
+void SecureSocketReactorHandlerTest::testSlowHandshake()
+{
+	SecureServerSocket svs(0, 64, createServerContext());
+	SocketReactor reactor;
+	SocketAcceptor<EchoHandler> acceptor(svs, reactor);
+	Thread thread;
+	thread.start(reactor);
+
+	// a client that connects, but never starts the handshake,
+	// must not hold up other connections
+	SocketAddress sa("127.0.0.1", svs.address().port());
+	StreamSocket slow(sa);
+	Thread::sleep(100);
+
+	Stopwatch sw;
+	sw.start();
+	SecureStreamSocket ss(sa, createClientContext());
+	std::string data("hello, world");
+	ss.sendBytes(data.data(), (int) data.size());
+	char buffer[256];
+	int n = ss.receiveBytes(buffer, sizeof(buffer));
+	assert (std::string(buffer, n) == data);
+	sw.stop();
+	assert (sw.elapsedSeconds() < 5);
+	ss.close();
+	Thread::sleep(200);
+	assert (EchoHandler::handshakes == 1);
+	assert (EchoHandler::closed == 1);
+
+	slow.close();
+	Thread::sleep(200);
+	assert (EchoHandler::closed == 2);
+
+	reactor.stop();
+	thread.join();
+}
+
+
+void SecureSocketReactorHandlerTest::testHandshakeTimeout()
+{
+	SecureServerSocket svs(0, 64, createServerContext());
+	SocketReactor reactor;
+	SocketAcceptor<TimeoutEchoHandler> acceptor(svs, reactor);
+	Thread thread;
+	thread.start(reactor);
+
+	SocketAddress sa("127.0.0.1", svs.address().port());
+	StreamSocket slow(sa);
+	slow.setReceiveTimeout(Poco::Timespan(5, 0));
+	char buffer[256];
+	int n = slow.receiveBytes(buffer, sizeof(buffer));
+	assert (n == 0);
+	assert (EchoHandler::timeouts == 1);
+	assert (EchoHandler::closed == 1);
+
+	// a proper client is not affected
+	SecureStreamSocket ss(sa, createClientContext());
+	std::string data("hello, world");
+	ss.sendBytes(data.data(), (int) data.size());
+	n = ss.receiveBytes(buffer, sizeof(buffer));
+	assert (std::string(buffer, n) == data);
+	Thread::sleep(500);
+	ss.sendBytes(data.data(), (int) data.size());
+	n = ss.receiveBytes(buffer, sizeof(buffer));
+	assert (std::string(buffer, n) == data);
+	ss.close();
+	assert (EchoHandler::timeouts == 1);
+
+	reactor.stop();
+	thread.join();
+}
+
+
+void SecureSocketReactorHandlerTest::setUp()
+{
+	// ensure OpenSSL machinery is fully setup
+	Context::Ptr pDefaultServerContext = SSLManager::instance().defaultServerContext();
+	Context::Ptr pDefaultClientContext = SSLManager::instance().defaultClientContext();
+	EchoHandler::reset();
+}
+
+
+void SecureSocketReactorHandlerTest::tearDown()
+{
+}
+
+
+CppUnit::Test* SecureSocketReactorHandlerTest::suite()
+{
+	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("SecureSocketReactorHandlerTest");
+
+	CppUnit_addTest(pSuite, SecureSocketReactorHandlerTest, testServer);
+	CppUnit_addTest(pSuite, SecureSocketReactorHandlerTest, testClient);
+	CppUnit_addTest(pSuite, SecureSocketReactorHandlerTest, testSlowHandshake);
+	CppUnit_addTest(pSuite, SecureSocketReactorHandlerTest, testHandshakeTimeout);
+
+	return pSuite;
+}
@@ -42,9 +42,19 @@
 #include "Poco/Net/Context.h"
 #include "Poco/Net/Session.h"
 #include "Poco/Net/SSLManager.h"
+#include "Poco/Net/SharedMemorySessionCache.h"
+#include "Poco/Net/SessionTicketKeyManager.h"
+#include "Poco/Net/HandshakePool.h"
+#include "Poco/Net/CertificateReloader.h"
 #include "Poco/Util/Application.h"
 #include "Poco/Util/AbstractConfiguration.h"
 #include "Poco/Thread.h"
+#include "Poco/RunnableAdapter.h"
+#include "Poco/Timestamp.h"
+#include "Poco/TemporaryFile.h"
+#include "Poco/FileStream.h"
+#include "Poco/File.h"
+#include "Poco/Path.h"
 #include <iostream>
 
 
@@ -60,7 +70,14 @@ using Poco::Net::SocketAddress;
 using Poco::Net::Context;
 using Poco::Net::Session;
 using Poco::Net::SSLManager;
+using Poco::Net::SessionCache;
+using Poco::Net::SharedMemorySessionCache;
+using Poco::Net::SessionTicketKeyManager;
+using Poco::Net::ClientSessionCache;
+using Poco::Net::HandshakePool;
+using Poco::Net::CertificateReloader;
 using Poco::Thread;
+using Poco::Timespan;
 using Poco::Util::Application;
 
 
@@ -403,6 +420,644 @@ void TCPServerTest::testReuseSession()
 }
 
 
+void TCPServerTest::testSharedSessionCache()
+{
+	Context::Ptr pDefaultServerContext = SSLManager::instance().defaultServerContext();
+	Context::Ptr pDefaultClientContext = SSLManager::instance().defaultClientContext();
+
+	// two servers, as if running in different processes, sharing the same cache
+	SessionCache::Ptr pCache1 = new SharedMemorySessionCache("PocoNetSSLTestSessionCache", 64, 2048, true);
+	SessionCache::Ptr pCache2 = new SharedMemorySessionCache("PocoNetSSLTestSessionCache", 64, 2048, false);
+
+	Context::Ptr pServerContext1 = new Context(
+		Context::SERVER_USE, 
+		Application::instance().config().getString("openSSL.server.privateKeyFile"),
+		Application::instance().config().getString("openSSL.server.privateKeyFile"),
+		Application::instance().config().getString("openSSL.server.caConfig"),
+		Context::VERIFY_NONE,
+		9,
+		true,
+		"ALL:!ADH:!LOW:!EXP:!MD5:@STRENGTH");
+	pServerContext1->enableSessionCache(true, "TestSuite");
+	pServerContext1->disableStatelessSessionResumption();
+	pServerContext1->setSessionCache(pCache1);
+	assert (pServerContext1->sessionCacheEnabled());
+	assert (pServerContext1->getSessionCache() == pCache1);
+
+	Context::Ptr pServerContext2 = new Context(
+		Context::SERVER_USE, 
+		Application::instance().config().getString("openSSL.server.privateKeyFile"),
+		Application::instance().config().getString("openSSL.server.privateKeyFile"),
+		Application::instance().config().getString("openSSL.server.caConfig"),
+		Context::VERIFY_NONE,
+		9,
+		true,
+		"ALL:!ADH:!LOW:!EXP:!MD5:@STRENGTH");
+	pServerContext2->setSessionCache(pCache2);
+	pServerContext2->enableSessionCache(true, "TestSuite");
+	pServerContext2->disableStatelessSessionResumption();
+
+	SecureServerSocket svs1(0, 64, pServerContext1);
+	TCPServer srv1(new TCPServerConnectionFactoryImpl<EchoConnection>(), svs1);
+	srv1.start();
+	SecureServerSocket svs2(0, 64, pServerContext2);
+	TCPServer srv2(new TCPServerConnectionFactoryImpl<EchoConnection>(), svs2);
+	srv2.start();
+
+	Context::Ptr pClientContext = new Context(
+		Context::CLIENT_USE, 
+		Application::instance().config().getString("openSSL.client.privateKeyFile"),
+		Application::instance().config().getString("openSSL.client.privateKeyFile"),
+		Application::instance().config().getString("openSSL.client.caConfig"),
+		Context::VERIFY_RELAXED,
+		9,
+		true,
+		"ALL:!ADH:!LOW:!EXP:!MD5:@STRENGTH");
+	pClientContext->enableSessionCache(true);
+
+	SocketAddress sa1("localhost", svs1.address().port());
+	SocketAddress sa2("localhost", svs2.address().port());
+	SecureStreamSocket ss1(sa1, pClientContext);
+	assert (!ss1.sessionWasReused());
+	std::string data("hello, world");
+	ss1.sendBytes(data.data(), (int) data.size());
+	char buffer[256];
+	int n = ss1.receiveBytes(buffer, sizeof(buffer));
+	assert (n > 0);
+	assert (std::string(buffer, n) == data);
+	assert (pCache1->stores() == 1);
+
+	Session::Ptr pSession = ss1.currentSession();
+	ss1.close();
+
+	ss1.useSession(pSession);
+	ss1.connect(sa2);
+	assert (ss1.sessionWasReused());
+	ss1.sendBytes(data.data(), (int) data.size());
+	n = ss1.receiveBytes(buffer, sizeof(buffer));
+	assert (n > 0);
+	assert (std::string(buffer, n) == data);
+	ss1.close();
+	assert (pCache2->hits() == 1);
+	assert (pCache2->misses() == 0);
+
+	static_cast<SharedMemorySessionCache*>(pCache1.get())->clear();
+
+	ss1.useSession(pSession);
+	ss1.connect(sa1);
+	assert (!ss1.sessionWasReused());
+	ss1.sendBytes(data.data(), (int) data.size());
+	n = ss1.receiveBytes(buffer, sizeof(buffer));
+	assert (n > 0);
+	assert (std::string(buffer, n) == data);
+	ss1.close();
+	assert (pCache1->misses() == 1);
+	assert (pCache1->stores() == 2);
+	
+	Thread::sleep(300);
+	srv1.stop();
+	srv2.stop();
+}
+
+
+void TCPServerTest::testSessionTickets()
+{
+	Context::Ptr pDefaultServerContext = SSLManager::instance().defaultServerContext();
+	Context::Ptr pDefaultClientContext = SSLManager::instance().defaultClientContext();
+
+	const std::string secret("0123456789abcdef0123456789abcdef");
+	SessionTicketKeyManager::Ptr pManager1 = new SessionTicketKeyManager(secret);
+	SessionTicketKeyManager::Ptr pManager2 = new SessionTicketKeyManager(secret);
+	SessionTicketKeyManager::Ptr pManager3 = new SessionTicketKeyManager;
+
+	Context::Ptr pServerContexts[3];
+	SessionTicketKeyManager::Ptr pManagers[3] = { pManager1, pManager2, pManager3 };
+	for (int i = 0; i < 3; ++i)
+	{
+		pServerContexts[i] = new Context(
+			Context::SERVER_USE, 
+			Application::instance().config().getString("openSSL.server.privateKeyFile"),
+			Application::instance().config().getString("openSSL.server.privateKeyFile"),
+			Application::instance().config().getString("openSSL.server.caConfig"),
+			Context::VERIFY_NONE,
+			9,
+			true,
+			"ALL:!ADH:!LOW:!EXP:!MD5:@STRENGTH");
+		pServerContexts[i]->enableSessionCache(false, "TestSuite");
+		pServerContexts[i]->setSessionTicketKeyManager(pManagers[i]);
+	}
+
+	SecureServerSocket svs1(0, 64, pServerContexts[0]);
+	TCPServer srv1(new TCPServerConnectionFactoryImpl<EchoConnection>(), svs1);
+	srv1.start();
+	SecureServerSocket svs2(0, 64, pServerContexts[1]);
+	TCPServer srv2(new TCPServerConnectionFactoryImpl<EchoConnection>(), svs2);
+	srv2.start();
+	SecureServerSocket svs3(0, 64, pServerContexts[2]);
+	TCPServer srv3(new TCPServerConnectionFactoryImpl<EchoConnection>(), svs3);
+	srv3.start();
+
+	Context::Ptr pClientContext = new Context(
+		Context::CLIENT_USE, 
+		Application::instance().config().getString("openSSL.client.privateKeyFile"),
+		Application::instance().config().getString("openSSL.client.privateKeyFile"),
+		Application::instance().config().getString("openSSL.client.caConfig"),
+		Context::VERIFY_RELAXED,
+		9,
+		true,
+		"ALL:!ADH:!LOW:!EXP:!MD5:@STRENGTH");
+	pClientContext->enableSessionCache(true);
+
+	SocketAddress sa1("localhost", svs1.address().port());
+	SocketAddress sa2("localhost", svs2.address().port());
+	SocketAddress sa3("localhost", svs3.address().port());
+	SecureStreamSocket ss1(sa1, pClientContext);
+	assert (!ss1.sessionWasReused());
+	std::string data("hello, world");
+	ss1.sendBytes(data.data(), (int) data.size());
+	char buffer[256];
+	int n = ss1.receiveBytes(buffer, sizeof(buffer));
+	assert (n > 0);
+	assert (std::string(buffer, n) == data);
+	assert (pManager1->ticketsIssued() == 1);
+
+	Session::Ptr pSession = ss1.currentSession();
+	ss1.close();
+
+	// same secret: the ticket issued by the first server is accepted
+	ss1.useSession(pSession);
+	ss1.connect(sa2);
+	assert (ss1.sessionWasReused());
+	ss1.sendBytes(data.data(), (int) data.size());
+	n = ss1.receiveBytes(buffer, sizeof(buffer));
+	assert (n > 0);
+	assert (std::string(buffer, n) == data);
+	ss1.close();
+	assert (pManager2->ticketsAccepted() == 1);
+
+	// different secret: full handshake
+	ss1.useSession(pSession);
+	ss1.connect(sa3);
+	assert (!ss1.sessionWasReused());
+	ss1.sendBytes(data.data(), (int) data.size());
+	n = ss1.receiveBytes(buffer, sizeof(buffer));
+	assert (n > 0);
+	assert (std::string(buffer, n) == data);
+	ss1.close();
+	assert (pManager3->ticketsRejected() == 1);
+	assert (pManager3->ticketsIssued() == 1);
+
+	Thread::sleep(300);
+	srv1.stop();
+	srv2.stop();
+	srv3.stop();
+}
+
+
+void TCPServerTest::testClientSessionCache()
+{
+	Context::Ptr pDefaultServerContext = SSLManager::instance().defaultServerContext();
+	Context::Ptr pDefaultClientContext = SSLManager::instance().defaultClientContext();
+
+	Context::Ptr pServerContext = new Context(
+		Context::SERVER_USE, 
+		Application::instance().config().getString("openSSL.server.privateKeyFile"),
+		Application::instance().config().getString("openSSL.server.privateKeyFile"),
+		Application::instance().config().getString("openSSL.server.caConfig"),
+		Context::VERIFY_NONE,
+		9,
+		true,
+		"ALL:!ADH:!LOW:!EXP:!MD5:@STRENGTH");
+	pServerContext->enableSessionCache(true, "TestSuite");
+	pServerContext->setSessionTimeout(2);
+	pServerContext->disableStatelessSessionResumption();
+
+	SecureServerSocket svs(0, 64, pServerContext);
+	TCPServer srv(new TCPServerConnectionFactoryImpl<EchoConnection>(), svs);
+	srv.start();
+
+	Context::Ptr pClientContext = new Context(
+		Context::CLIENT_USE, 
+		Application::instance().config().getString("openSSL.client.privateKeyFile"),
+		Application::instance().config().getString("openSSL.client.privateKeyFile"),
+		Application::instance().config().getString("openSSL.client.caConfig"),
+		Context::VERIFY_RELAXED,
+		9,
+		true,
+		"ALL:!ADH:!LOW:!EXP:!MD5:@STRENGTH");
+	pClientContext->enableSessionCache(true);
+	pClientContext->setSessionCacheSize(10);
+	ClientSessionCache::Ptr pCache = pClientContext->getClientSessionCache();
+	assert (!pCache.isNull());
+	assert (pCache->getMaxSize() == 10);
+	assert (pCache->size() == 0);
+
+	// every new socket to the same peer resumes the session
+	SocketAddress sa("127.0.0.1", svs.address().port());
+	std::string data("hello, world");
+	char buffer[256];
+	for (int i = 0; i < 3; ++i)
+	{
+		SecureStreamSocket ss(sa, pClientContext);
+		assert (ss.sessionWasReused() == (i > 0));
+		ss.sendBytes(data.data(), (int) data.size());
+		int n = ss.receiveBytes(buffer, sizeof(buffer));
+		assert (n > 0);
+		assert (std::string(buffer, n) == data);
+		ss.close();
+	}
+	assert (pCache->size() == 1);
+	assert (pCache->misses() == 1);
+	assert (pCache->hits() == 2);
+	assert (pCache->fullHandshakes() == 1);
+	assert (pCache->resumedHandshakes() == 2);
+
+	// the session has expired on the server: full handshake, cache updated
+	Thread::sleep(4000);
+	pCache->resetStatistics();
+	{
+		SecureStreamSocket ss(sa, pClientContext);
+		assert (!ss.sessionWasReused());
+		ss.sendBytes(data.data(), (int) data.size());
+		int n = ss.receiveBytes(buffer, sizeof(buffer));
+		assert (std::string(buffer, n) == data);
+		ss.close();
+	}
+	{
+		SecureStreamSocket ss(sa, pClientContext);
+		assert (ss.sessionWasReused());
+		ss.sendBytes(data.data(), (int) data.size());
+		int n = ss.receiveBytes(buffer, sizeof(buffer));
+		assert (std::string(buffer, n) == data);
+		ss.close();
+	}
+	assert (pCache->hits() == 2);
+	assert (pCache->fullHandshakes() == 1);
+	assert (pCache->resumedHandshakes() == 1);
+
+	// a different peer does not get the session
+	{
+		SecureStreamSocket ss(sa, "localhost", pClientContext);
+		assert (!ss.sessionWasReused());
+		assert (pCache->size() == 2);
+		ss.sendBytes(data.data(), (int) data.size());
+		int n = ss.receiveBytes(buffer, sizeof(buffer));
+		assert (std::string(buffer, n) == data);
+		ss.close();
+	}
+
+	// a session whose peer certificate fails verification is not stored
+	try
+	{
+		SecureStreamSocket ss(sa, "wronghost.appinf.com", pClientContext);
+		fail("certificate does not match host name - must throw");
+	}
+	catch (Poco::Exception&)
+	{
+	}
+	assert (pCache->size() == 2);
+
+	pClientContext->enableSessionCache(false);
+	{
+		SecureStreamSocket ss(sa, pClientContext);
+		assert (!ss.sessionWasReused());
+		ss.sendBytes(data.data(), (int) data.size());
+		int n = ss.receiveBytes(buffer, sizeof(buffer));
+		assert (std::string(buffer, n) == data);
+		ss.close();
+	}
+
+	Thread::sleep(300);
+	srv.stop();
+}
+
+
+void TCPServerTest::testHandshakePool()
+{
+	HandshakePool::Ptr pPool = new HandshakePool(1, 1, Timespan(1, 0));
+	assert (pPool->threads() == 1);
+	assert (pPool->maxQueued() == 1);
+
+	Context::Ptr pServerContext = new Context(
+		Context::SERVER_USE, 
+		Application::instance().config().getString("openSSL.server.privateKeyFile"),
+		Application::instance().config().getString("openSSL.server.privateKeyFile"),
+		Application::instance().config().getString("openSSL.server.caConfig"),
+		Context::VERIFY_NONE,
+		9,
+		true,
+		"ALL:!ADH:!LOW:!EXP:!MD5:@STRENGTH");
+	pServerContext->setHandshakePool(pPool);
+	assert (pServerContext->getHandshakePool() == pPool);
+
+	SecureServerSocket svs(0, 64, pServerContext);
+	TCPServer srv(new TCPServerConnectionFactoryImpl<EchoConnection>(), svs);
+	srv.start();
+
+	SocketAddress sa("localhost", svs.address().port());
+	std::string data("hello, world");
+	char buffer[256];
+	SecureStreamSocket ss1(sa);
+	ss1.sendBytes(data.data(), (int) data.size());
+	int n = ss1.receiveBytes(buffer, sizeof(buffer));
+	assert (n > 0);
+	assert (std::string(buffer, n) == data);
+	assert (pPool->completed() == 1);
+	assert (srv.totalConnections() == 1);
+
+	// plain TCP clients never send a ClientHello and stall the pool
+	StreamSocket stalled1(sa);
+	Thread::sleep(300);
+	assert (pPool->active() == 1);
+	StreamSocket stalled2(sa);
+	Thread::sleep(300);
+	assert (pPool->queued() == 1);
+	StreamSocket stalled3(sa);
+	Thread::sleep(300);
+	assert (pPool->rejected() == 1);
+	n = stalled3.receiveBytes(buffer, sizeof(buffer));
+	assert (n == 0);
+
+	Thread::sleep(2000);
+	assert (pPool->active() == 0);
+	assert (pPool->queued() == 0);
+	assert (pPool->failed() == 2);
+	assert (pPool->maxHandshakeTime() >= Timespan(0, 900000));
+
+	// established connections are served while the pool is busy
+	ss1.sendBytes(data.data(), (int) data.size());
+	n = ss1.receiveBytes(buffer, sizeof(buffer));
+	assert (n > 0);
+	assert (std::string(buffer, n) == data);
+
+	SecureStreamSocket ss2(sa);
+	ss2.sendBytes(data.data(), (int) data.size());
+	n = ss2.receiveBytes(buffer, sizeof(buffer));
+	assert (n > 0);
+	assert (std::string(buffer, n) == data);
+	assert (pPool->completed() == 2);
+	assert (srv.totalConnections() == 2);
+
+	pPool->resetStatistics();
+	assert (pPool->completed() == 0);
+	assert (pPool->failed() == 0);
+	assert (pPool->rejected() == 0);
+	assert (pPool->averageHandshakeTime() == 0);
+
+	ss1.close();
+	ss2.close();
+	Thread::sleep(300);
+	srv.stop();
+	pPool->stop();
+}
+
+
+void TCPServerTest::testHandshakePoolDeadline()
+{
+	HandshakePool::Ptr pPool = new HandshakePool(1, 1, Timespan(1, 0));
+
+	Context::Ptr pServerContext = new Context(
+		Context::SERVER_USE, 
+		Application::instance().config().getString("openSSL.server.privateKeyFile"),
+		Application::instance().config().getString("openSSL.server.privateKeyFile"),
+		Application::instance().config().getString("openSSL.server.caConfig"),
+		Context::VERIFY_NONE,
+		9,
+		true,
+		"ALL:!ADH:!LOW:!EXP:!MD5:@STRENGTH");
+	pServerContext->setHandshakePool(pPool);
+
+	SecureServerSocket svs(0, 64, pServerContext);
+	TCPServer srv(new TCPServerConnectionFactoryImpl<EchoConnection>(), svs);
+	srv.start();
+
+	// a client trickling a ClientHello one byte at a time must not
+	// keep the handshake alive beyond the timeout
+	SocketAddress sa("localhost", svs.address().port());
+	StreamSocket trickler(sa);
+	trickler.sendBytes("\x16\x03\x01\x00\xff\x01\x00\x00\xfb\x03\x01", 11);
+	Poco::Timestamp start;
+	while (pPool->failed() == 0 && start.elapsed() < 3000000)
+	{
+		Thread::sleep(200);
+		try
+		{
+			trickler.sendBytes("\x01", 1);
+		}
+		catch (Poco::Exception&)
+		{
+		}
+	}
+	assert (pPool->failed() == 1);
+	assert (start.elapsed() < 2000000);
+	assert (pPool->maxHandshakeTime() < Timespan(1, 500000));
+
+	std::string data("hello, world");
+	char buffer[256];
+	SecureStreamSocket ss(sa);
+	ss.sendBytes(data.data(), (int) data.size());
+	int n = ss.receiveBytes(buffer, sizeof(buffer));
+	assert (n > 0);
+	assert (std::string(buffer, n) == data);
+	assert (pPool->completed() == 1);
+
+	ss.close();
+	Thread::sleep(300);
+	srv.stop();
+	pPool->stop();
+}
+
+
+void TCPServerTest::testHandshakePoolStop()
+{
+	HandshakePool::Ptr pPool = new HandshakePool(1, 4, Timespan(1, 0));
+
+	Context::Ptr pServerContext = new Context(
+		Context::SERVER_USE, 
+		Application::instance().config().getString("openSSL.server.privateKeyFile"),
+		Application::instance().config().getString("openSSL.server.privateKeyFile"),
+		Application::instance().config().getString("openSSL.server.caConfig"),
+		Context::VERIFY_NONE,
+		9,
+		true,
+		"ALL:!ADH:!LOW:!EXP:!MD5:@STRENGTH");
+	pServerContext->setHandshakePool(pPool);
+
+	SecureServerSocket svs(0, 64, pServerContext);
+	TCPServer srv(new TCPServerConnectionFactoryImpl<EchoConnection>(), svs);
+	srv.start();
+
+	// one stalled client occupies the worker, the other one is queued
+	SocketAddress sa("localhost", svs.address().port());
+	StreamSocket stalled1(sa);
+	Thread::sleep(300);
+	StreamSocket stalled2(sa);
+	Thread::sleep(300);
+	assert (pPool->active() == 1);
+	assert (pPool->queued() == 1);
+
+	Poco::RunnableAdapter<HandshakePool> stopper(*pPool, &HandshakePool::stop);
+	Thread thread;
+	Poco::Timestamp start;
+	thread.start(stopper);
+	assert (thread.tryJoin(4000));
+	assert (start.elapsed() < 2000000);
+	assert (pPool->active() == 0);
+	assert (pPool->queued() == 0);
+	assert (pPool->failed() == 1);
+
+	char buffer[16];
+	assert (stalled2.receiveBytes(buffer, sizeof(buffer)) == 0);
+
+	srv.stop();
+}
+
+
+void TCPServerTest::testCertificateReload()
+{
+	Poco::TemporaryFile tempDir;
+	tempDir.createDirectories();
+	Poco::Path dir(tempDir.path());
+	dir.makeDirectory();
+	std::string keyFile = Poco::Path(dir, "server.pem").toString();
+	std::string tempFile = Poco::Path(dir, "server.tmp").toString();
+	Poco::File(Application::instance().config().getString("openSSL.server.privateKeyFile")).copyTo(keyFile);
+	std::string caConfig = Application::instance().config().getString("openSSL.server.caConfig");
+
+	Context::Ptr pServerContext = new Context(Context::SERVER_USE, keyFile, keyFile, caConfig, Context::VERIFY_NONE);
+	pServerContext->enableKernelTLS();
+	SecureServerSocket svs(0, 64, pServerContext);
+	TCPServer srv(new TCPServerConnectionFactoryImpl<EchoConnection>(), svs);
+	srv.start();
+
+	CertificateReloader reloader(svs, keyFile, keyFile, caConfig, Context::VERIFY_NONE);
+	
+	SocketAddress sa("localhost", svs.address().port());
+	std::string data("hello, world");
+	char buffer[256];
+	SecureStreamSocket ss1(sa);
+	ss1.sendBytes(data.data(), (int) data.size());
+	int n = ss1.receiveBytes(buffer, sizeof(buffer));
+	assert (n > 0);
+	assert (std::string(buffer, n) == data);
+
+	reloader.reload();
+	assert (reloader.reloads() == 1);
+	Context::Ptr pReloadedContext = svs.context();
+	assert (pReloadedContext != pServerContext);
+	assert (pReloadedContext->kernelTLSEnabled());
+
+	// the established connection is not affected
+	ss1.sendBytes(data.data(), (int) data.size());
+	n = ss1.receiveBytes(buffer, sizeof(buffer));
+	assert (n > 0);
+	assert (std::string(buffer, n) == data);
+
+	SecureStreamSocket ss2(sa);
+	ss2.sendBytes(data.data(), (int) data.size());
+	n = ss2.receiveBytes(buffer, sizeof(buffer));
+	assert (n > 0);
+	assert (std::string(buffer, n) == data);
+	ss2.close();
+
+	// a broken file is rejected and the current context stays in use
+	{
+		Poco::FileOutputStream ostr(tempFile);
+		ostr << "not a certificate" << std::endl;
+	}
+	Poco::File(tempFile).renameTo(keyFile);
+	for (int i = 0; i < 50 && reloader.failures() == 0; ++i) Thread::sleep(100);
+	assert (reloader.failures() == 1);
+	assert (reloader.reloads() == 1);
+	assert (svs.context() == pReloadedContext);
+
+	SecureStreamSocket ss3(sa);
+	ss3.sendBytes(data.data(), (int) data.size());
+	n = ss3.receiveBytes(buffer, sizeof(buffer));
+	assert (n > 0);
+	assert (std::string(buffer, n) == data);
+	ss3.close();
+
+	Poco::File(Application::instance().config().getString("openSSL.server.privateKeyFile")).copyTo(tempFile);
+	Poco::File(tempFile).renameTo(keyFile);
+	for (int i = 0; i < 50 && reloader.reloads() == 1; ++i) Thread::sleep(100);
+	assert (reloader.reloads() == 2);
+	assert (svs.context() != pReloadedContext);
+	assert (svs.context()->kernelTLSEnabled());
+
+	SecureStreamSocket ss4(sa);
+	ss4.sendBytes(data.data(), (int) data.size());
+	n = ss4.receiveBytes(buffer, sizeof(buffer));
+	assert (n > 0);
+	assert (std::string(buffer, n) == data);
+	ss4.close();
+	ss1.close();
+	
+	Thread::sleep(300);
+	srv.stop();
+}
+
+
+void TCPServerTest::testCertificateReloadSessionCache()
+{
+	Poco::TemporaryFile tempDir;
+	tempDir.createDirectories();
+	Poco::Path dir(tempDir.path());
+	dir.makeDirectory();
+	std::string keyFile = Poco::Path(dir, "server.pem").toString();
+	Poco::File(Application::instance().config().getString("openSSL.server.privateKeyFile")).copyTo(keyFile);
+	std::string caConfig = Application::instance().config().getString("openSSL.server.caConfig");
+
+	SessionCache::Ptr pCache = new SharedMemorySessionCache("PocoNetSSLTestReloadCache", 64, 2048, true);
+	Context::Ptr pServerContext = new Context(Context::SERVER_USE, keyFile, keyFile, caConfig, Context::VERIFY_NONE);
+	pServerContext->enableSessionCache(true, "TestSuite");
+	pServerContext->disableStatelessSessionResumption();
+	pServerContext->setSessionCache(pCache);
+	pServerContext->setSessionTimeout(600);
+	SecureServerSocket svs(0, 64, pServerContext);
+	TCPServer srv(new TCPServerConnectionFactoryImpl<EchoConnection>(), svs);
+	srv.start();
+
+	CertificateReloader reloader(svs, keyFile, keyFile, caConfig, Context::VERIFY_NONE);
+
+	Context::Ptr pClientContext = new Context(Context::CLIENT_USE, "", Context::VERIFY_NONE);
+	SocketAddress sa("localhost", svs.address().port());
+	std::string data("hello, world");
+	char buffer[256];
+	SecureStreamSocket ss(sa, pClientContext);
+	assert (!ss.sessionWasReused());
+	ss.sendBytes(data.data(), (int) data.size());
+	int n = ss.receiveBytes(buffer, sizeof(buffer));
+	assert (n > 0);
+	assert (std::string(buffer, n) == data);
+	assert (pCache->stores() == 1);
+	Session::Ptr pSession = ss.currentSession();
+	ss.close();
+
+	reloader.reload();
+	Context::Ptr pReloadedContext = svs.context();
+	assert (pReloadedContext != pServerContext);
+	assert (pReloadedContext->sessionCacheEnabled());
+	assert (pReloadedContext->getSessionCache() == pCache);
+	assert (pReloadedContext->getSessionIdContext() == "TestSuite");
+	assert (pReloadedContext->getSessionTimeout() == 600);
+
+	ss.useSession(pSession);
+	ss.connect(sa);
+	assert (ss.sessionWasReused());
+	ss.sendBytes(data.data(), (int) data.size());
+	n = ss.receiveBytes(buffer, sizeof(buffer));
+	assert (n > 0);
+	assert (std::string(buffer, n) == data);
+	ss.close();
+	assert (pCache->hits() == 1);
+
+	static_cast<SharedMemorySessionCache*>(pCache.get())->clear();
+	Thread::sleep(300);
+	srv.stop();
+}
+
+
 void TCPServerTest::setUp()
 {
 }
@@ -422,6 +1077,14 @@ CppUnit::Test* TCPServerTest::suite()
 	CppUnit_addTest(pSuite, TCPServerTest, testMultiConnections);
 	CppUnit_addTest(pSuite, TCPServerTest, testReuseSocket);
 	CppUnit_addTest(pSuite, TCPServerTest, testReuseSession);
+	CppUnit_addTest(pSuite, TCPServerTest, testSharedSessionCache);
+	CppUnit_addTest(pSuite, TCPServerTest, testSessionTickets);
+	CppUnit_addTest(pSuite, TCPServerTest, testClientSessionCache);
+	CppUnit_addTest(pSuite, TCPServerTest, testHandshakePool);
+	CppUnit_addTest(pSuite, TCPServerTest, testHandshakePoolDeadline);
+	CppUnit_addTest(pSuite, TCPServerTest, testHandshakePoolStop);
+	CppUnit_addTest(pSuite, TCPServerTest, testCertificateReload);
+	CppUnit_addTest(pSuite, TCPServerTest, testCertificateReloadSessionCache);
 
 	return pSuite;
 }
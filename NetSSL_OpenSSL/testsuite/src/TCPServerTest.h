@@ -51,6 +51,14 @@ public:
 	void testMultiConnections();
 	void testReuseSocket();
 	void testReuseSession();
+	void testSharedSessionCache();
+	void testSessionTickets();
+	void testClientSessionCache();
+	void testHandshakePool();
+	void testHandshakePoolDeadline();
+	void testHandshakePoolStop();
+	void testCertificateReload();
+	void testCertificateReloadSessionCache();
 
 	void setUp();
 	void tearDown();
@@ -32,6 +32,7 @@
 
 #include "TCPServerTestSuite.h"
 #include "TCPServerTest.h"
+#include "SecureSocketReactorHandlerTest.h"
 
 
 CppUnit::Test* TCPServerTestSuite::suite()
@@ -39,6 +40,7 @@ CppUnit::Test* TCPServerTestSuite::suite()
 	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("TCPServerTestSuite");
 
 	pSuite->addTest(TCPServerTest::suite());
+	pSuite->addTest(SecureSocketReactorHandlerTest::suite());
 
 	return pSuite;
 }